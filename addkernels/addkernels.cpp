@@ -31,6 +31,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 void Bin2Hex(std::istream& source,
              std::ostream& target,
@@ -99,6 +100,9 @@ void PrintHelp()
     std::cout << "           -l[ine-size] <number>: bytes in one line. Default: 16." << std::endl;
     std::cout << "           -b[uffer] <number>: read buffer size. Default: 512." << std::endl;
     std::cout << "           -g[uard] <string>: guard name. Default: no guard" << std::endl;
+    std::cout << "           -table <string>: name of a sorted {name, data, size} table of all "
+                 "sources. Default: no table"
+              << std::endl;
 }
 
 [[gnu::noreturn]] void WrongUsage(const std::string& error)
@@ -116,10 +120,11 @@ void PrintHelp()
     WrongUsage(ss.str());
 }
 
-void Process(const std::string& sourcePath,
-             std::ostream& target,
-             size_t bufferSize,
-             size_t lineSize)
+// Returns the name of the emitted variable.
+std::string Process(const std::string& sourcePath,
+                    std::ostream& target,
+                    size_t bufferSize,
+                    size_t lineSize)
 {
     std::string fileName(sourcePath);
     std::string extension, root;
@@ -175,6 +180,25 @@ void Process(const std::string& sourcePath,
 
     std::transform(variable.begin(), variable.end(), variable.begin(), ::toupper);
     Bin2Hex(*source, target, variable, true, bufferSize, lineSize);
+    return variable;
+}
+
+// Sorted so that sources can be found by binary search, see miopen/kernel_table.hpp.
+void WriteTable(std::vector<std::string> variables, std::ostream& target, const std::string& table)
+{
+    std::sort(variables.begin(), variables.end());
+    auto duplicate = std::adjacent_find(variables.begin(), variables.end());
+    if(duplicate != variables.end())
+    {
+        std::cerr << "Duplicate kernel name: " << *duplicate << std::endl;
+        std::exit(1);
+    }
+
+    target << "constexpr miopen::KernelTableEntry " << table << "[] = {" << std::endl;
+    for(const auto& variable : variables)
+        target << "    {\"" << variable << "\", " << variable << ", " << variable << "_SIZE},"
+               << std::endl;
+    target << "};" << std::endl;
 }
 
 int main(int argsn, char** args)
@@ -186,6 +210,7 @@ int main(int argsn, char** args)
     }
 
     std::string guard;
+    std::string table;
     size_t bufferSize = 512;
     size_t lineSize   = 16;
 
@@ -206,12 +231,18 @@ int main(int argsn, char** args)
                 *target << "#define " << guard << std::endl;
                 *target << "#include <stddef.h>" << std::endl;
             }
+            if(table.length() > 0)
+                *target << "#include <miopen/kernel_table.hpp>" << std::endl;
 
+            std::vector<std::string> variables;
             while(++i < argsn)
             {
-                Process(args[i], *target, bufferSize, lineSize);
+                variables.push_back(Process(args[i], *target, bufferSize, lineSize));
             }
 
+            if(table.length() > 0)
+                WriteTable(variables, *target, table);
+
             if(guard.length() > 0)
             {
                 *target << "#endif" << std::endl;
@@ -230,6 +261,8 @@ int main(int argsn, char** args)
             bufferSize = std::stol(args[++i]);
         else if(arg == "g" || arg == "guard")
             guard = args[++i];
+        else if(arg == "table")
+            table = args[++i];
         else
             UnknownArgument(arg);
     }
@@ -40,6 +40,7 @@
 #include <miopen/handle.hpp>
 #include <miopen/tensor.hpp>
 #include <numeric>
+#include <sstream>
 #include <vector>
 #include "random.hpp"
 
@@ -106,6 +107,8 @@ class BatchNormDriver : public Driver
     int VerifyBackward();
     int VerifyForward();
 
+    miopen::vcache_key GetVerificationCacheKey() const;
+
     ~BatchNormDriver()
     {
         miopenDestroyTensorDescriptor(outputTensor);
@@ -268,6 +271,7 @@ int BatchNormDriver<Tgpu, Tref, Tmix>::AddCmdLineArgs()
     inflags.AddInputFlag("beta", 'B', "0.", "Beta (Default=0.)", "float");
     inflags.AddInputFlag("iter", 'i', "1", "Number of Iterations (Default=1)", "int");
     inflags.AddInputFlag("verify", 'V', "1", "Verify Each Layer (Default=1)", "int");
+    AddVerificationCacheFlag(inflags);
     inflags.AddInputFlag("time", 't', "0", "Time Each Layer (Default=0)", "int");
     inflags.AddInputFlag("printconv", 'P', "1", "Print Convolution Dimensions (Default=1)", "int");
     inflags.AddInputFlag("mode",
@@ -1134,7 +1138,22 @@ int BatchNormDriver<Tgpu, Tref, Tmix>::VerifyForward()
 
     bool anError = false;
 
-    RunForwardCPU();
+    // Training updates the running statistics in place, so the key is taken before the run.
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey();
+    if(!(cache.load<Tref>("fwd_out", key, out_host) &&
+         cache.load<Tref>("fwd_run_mean", key, runningMean_host) &&
+         cache.load<Tref>("fwd_run_var", key, runningVariance_host) &&
+         cache.load<Tref>("fwd_save_mean", key, saveMean_host) &&
+         cache.load<Tref>("fwd_save_ivar", key, saveInvVariance_host)))
+    {
+        RunForwardCPU();
+        cache.save<Tref>("fwd_out", key, out_host);
+        cache.save<Tref>("fwd_run_mean", key, runningMean_host);
+        cache.save<Tref>("fwd_run_var", key, runningVariance_host);
+        cache.save<Tref>("fwd_save_mean", key, saveMean_host);
+        cache.save<Tref>("fwd_save_ivar", key, saveInvVariance_host);
+    }
 
     if(forw == 1)
     {
@@ -1401,7 +1420,17 @@ int BatchNormDriver<Tgpu, Tref, Tmix>::VerifyBackward()
     const Tref maxrms = static_cast<Tref>(((sizeof(Tgpu) == 4) ? RMSTOL_FP32 : RMSTOL_FP16) * 1000);
     bool anError      = false;
 
-    RunBackwardCPU();
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey();
+    if(!(cache.load<Tref>("bwd_dx", key, dxout_host) &&
+         cache.load<Tref>("bwd_dscale", key, dscale_host) &&
+         cache.load<Tref>("bwd_dbias", key, dbias_host)))
+    {
+        RunBackwardCPU();
+        cache.save<Tref>("bwd_dx", key, dxout_host);
+        cache.save<Tref>("bwd_dscale", key, dscale_host);
+        cache.save<Tref>("bwd_dbias", key, dbias_host);
+    }
 
     dxout_dev->FromGPU(GetStream(), dxout.data());
     dscale_dev->FromGPU(GetStream(), dscale.data());
@@ -1504,4 +1533,31 @@ int BatchNormDriver<Tgpu, Tref, Tmix>::VerifyBackward()
     return miopenStatusSuccess;
 }
 
+template <typename Tgpu, typename Tref, typename Tmix>
+miopen::vcache_key BatchNormDriver<Tgpu, Tref, Tmix>::GetVerificationCacheKey() const
+{
+    std::ostringstream ss;
+    ss << "bnorm_fp" << sizeof(Tgpu) * 8;
+    for(auto&& flag : {"forw",
+                       "back",
+                       "batchsize",
+                       "in_channels",
+                       "in_h",
+                       "in_w",
+                       "in_d",
+                       "mode",
+                       "save",
+                       "run",
+                       "iter"})
+        ss << "_" << inflags.GetValueStr(flag);
+
+    // The statistics are inputs of inference and of the backward pass.
+    miopen::vcache_hash inputs;
+    inputs.add(in).add(dyin).add(scale_host).add(bias_host);
+    inputs.add(runningMean_host).add(runningVariance_host);
+    inputs.add(saveMean_host).add(saveInvVariance_host);
+
+    return {ss.str(), RAN_SEED(), inputs.value};
+}
+
 #endif // GUARD_MIOPEN_BN_DRIVER_HPP
@@ -33,11 +33,13 @@ using half_float::half;
 typedef half float16;
 
 #include "InputFlags.hpp"
+#include "../test/verification_cache.hpp"
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cfloat>
 #include <memory>
+#include <miopen/env.hpp>
 #include <miopen/miopen.h>
 #include <numeric>
 #include <vector>
@@ -57,6 +59,8 @@ typedef half float16;
 
 #endif
 
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_DRIVER_VCACHE_COMPRESS)
+
 #define UNPACK_VEC4(v) (v[0]), (v[1]), (v[2]), (v[3])
 
 struct GPUMem
@@ -128,6 +132,23 @@ void PadBufferSize(size_t& sz, int datatype_sz)
     }
 }
 
+void AddVerificationCacheFlag(InputFlags& inflags)
+{
+    inflags.AddInputFlag("verification_cache",
+                         'C',
+                         "",
+                         "Use specified directory to cache verification data. Off by default.",
+                         "string");
+}
+
+// Host reference results are cached in the directory given by the verification_cache flag.
+// Setting MIOPEN_DRIVER_VCACHE_COMPRESS compresses the entries written by this run.
+miopen::verification_cache GetVerificationCache(InputFlags& inflags)
+{
+    return {inflags.GetValueStr("verification_cache"),
+            miopen::IsEnabled(MIOPEN_DRIVER_VCACHE_COMPRESS{})};
+}
+
 [[gnu::noreturn]] void Usage()
 {
     printf("Usage: ./driver *base_arg* *other_args*\n");
@@ -235,23 +235,20 @@ int GemmDriver<T>::AllocateBuffersAndCopy()
 #endif
     chost = c;
 
+#if GEMM_DRIVER_DEBUG
     for(int i = 0; i < a_sz; i++)
     {
-#if GEMM_DRIVER_DEBUG
         a[i] = static_cast<double>(i);
-#else
-        a[i]          = static_cast<double>(rand()) * (1.0 / RAND_MAX);
-#endif
     }
 
     for(int i = 0; i < b_sz; i++)
     {
-#if GEMM_DRIVER_DEBUG
         b[i] = static_cast<double>(i);
+    }
 #else
-        b[i]          = static_cast<double>((rand()) * (1.0 / RAND_MAX) - 0.5) * 0.001;
+    RAN_FILL(a, 0.0, 1.0, RAN_STREAM_IN);
+    RAN_FILL(b, -0.0005, 0.0005, RAN_STREAM_WEI);
 #endif
-    }
 #if MIOPEN_BACKEND_OPENCL
     cl_int status;
 #elif MIOPEN_BACKEND_HIP
@@ -39,6 +39,7 @@
 #include <miopen/miopen.h>
 #include <miopen/tensor.hpp>
 #include <numeric>
+#include <sstream>
 #include <vector>
 #include "random.hpp"
 
@@ -77,6 +78,8 @@ class LRNDriver : public Driver
 
     int VerifyBackward();
     int VerifyForward();
+
+    miopen::vcache_key GetVerificationCacheKey(bool backward) const;
     ~LRNDriver()
     {
 
@@ -164,6 +167,7 @@ int LRNDriver<Tgpu, Tref>::AddCmdLineArgs()
     inflags.AddInputFlag("lrnK", 'K', "1.0", "lrnK (Default=1.0)", "double");
     inflags.AddInputFlag("iter", 'i', "10", "Number of Iterations (Default=10)", "int");
     inflags.AddInputFlag("verify", 'V', "1", "Verify Each Layer (Default=1)", "int");
+    AddVerificationCacheFlag(inflags);
     inflags.AddInputFlag("time", 't', "0", "Time Each Layer (Default=0)", "int");
     inflags.AddInputFlag(
         "wall", 'w', "0", "Wall-clock Time Each Layer, Requires time == 1 (Default=0)", "int");
@@ -254,16 +258,10 @@ int LRNDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
     dout    = std::vector<Tgpu>(out_sz, static_cast<Tgpu>(0));
     dinhost = std::vector<Tref>(in_sz, static_cast<Tref>(0));
 
-    for(int i = 0; i < in_sz; i++)
-    {
-        in[i] = RAN_GEN<Tgpu>(static_cast<Tgpu>(0.0), static_cast<Tgpu>(1.0));
-    }
+    RAN_FILL(in, 0.0, 1.0, RAN_STREAM_IN);
 
-    Tgpu Data_scale = static_cast<Tgpu>(0.001);
-    for(int i = 0; i < out_sz; i++)
-    {
-        dout[i] = Data_scale * RAN_GEN<Tgpu>(static_cast<Tgpu>(-0.5), static_cast<Tgpu>(0.5));
-    }
+    const double Data_scale = 0.001;
+    RAN_FILL(dout, -0.5 * Data_scale, 0.5 * Data_scale, RAN_STREAM_DOUT);
 
 #if MIOPEN_BACKEND_OPENCL
     cl_int status;
@@ -435,33 +433,41 @@ int LRNDriver<Tgpu, Tref>::VerifyForward()
     int pre_pad = (v_lrnN - 1) / 2;
     int pad     = v_lrnN - pre_pad - 1;
 
-    mloLRNForwardRunHost<Tgpu, Tref>(do_backward,
-                                     v_mode,
-                                     pad,
-                                     v_lrnN,
-                                     alphaoverarea,
-                                     v_lrnAlpha,
-                                     v_lrnBeta,
-                                     v_lrnK,
-                                     nIn,        // batch_sz,
-                                     cOut,       // n_outputs,
-                                     cIn,        // n_inputs,
-                                     hIn,        // bot_height,
-                                     wIn,        // bot_width,
-                                     hInStride,  // bot_stride,
-                                     cInStride,  // bot_channel_stride,
-                                     nInStride,  // bot_batch_stride,
-                                     hOut,       // top_height,
-                                     wOut,       // top_width,
-                                     hOutStride, // top_v_stride,
-                                     cOutStride, // top_v_channel_stride,
-                                     nOutStride, // top_v_batch_stride,
-                                     hOutStride, // scale_v_stride,
-                                     cOutStride, // scale_v_channel_stride,
-                                     nOutStride, // scale_v_batch_stride,
-                                     in.data(),
-                                     scalehost.data(),
-                                     outhost.data());
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey(false);
+    if(!(cache.load<Tref>("fwd_out", key, outhost) &&
+         cache.load<Tref>("fwd_scale", key, scalehost)))
+    {
+        mloLRNForwardRunHost<Tgpu, Tref>(do_backward,
+                                         v_mode,
+                                         pad,
+                                         v_lrnN,
+                                         alphaoverarea,
+                                         v_lrnAlpha,
+                                         v_lrnBeta,
+                                         v_lrnK,
+                                         nIn,        // batch_sz,
+                                         cOut,       // n_outputs,
+                                         cIn,        // n_inputs,
+                                         hIn,        // bot_height,
+                                         wIn,        // bot_width,
+                                         hInStride,  // bot_stride,
+                                         cInStride,  // bot_channel_stride,
+                                         nInStride,  // bot_batch_stride,
+                                         hOut,       // top_height,
+                                         wOut,       // top_width,
+                                         hOutStride, // top_v_stride,
+                                         cOutStride, // top_v_channel_stride,
+                                         nOutStride, // top_v_batch_stride,
+                                         hOutStride, // scale_v_stride,
+                                         cOutStride, // scale_v_channel_stride,
+                                         nOutStride, // scale_v_batch_stride,
+                                         in.data(),
+                                         scalehost.data(),
+                                         outhost.data());
+        cache.save<Tref>("fwd_out", key, outhost);
+        cache.save<Tref>("fwd_scale", key, scalehost);
+    }
 
     auto error           = miopen::rms_range(outhost, out);
     const Tref tolerance = 1.5e-4; // 1e-6;
@@ -523,40 +529,46 @@ int LRNDriver<Tgpu, Tref>::VerifyBackward()
     int pre_pad = (v_lrnN - 1) / 2;
     int pad     = v_lrnN - pre_pad - 1;
 
-    mloLRNBackwardRunHost<Tgpu, Tref>(static_cast<int>(v_mode),
-                                      pad,
-                                      v_lrnN,
-                                      alphaoverarea,
-                                      v_lrnAlpha,
-                                      v_lrnBeta,
-                                      v_lrnK,
-                                      nIn,         // batch_sz,
-                                      cOut,        // n_outputs,
-                                      cIn,         // n_inputs,
-                                      hIn,         // bot_height,
-                                      wIn,         // bot_width,
-                                      hInStride,   // bot_stride,
-                                      cInStride,   // bot_channel_stride,
-                                      nInStride,   // bot_batch_stride,
-                                      hdInStride,  // bot_df_v_stride,
-                                      cdInStride,  // bot_df_v_channel_stride,
-                                      ndInStride,  // bot_df_v_batch_stride,
-                                      hOut,        // top_height,
-                                      wOut,        // top_width,
-                                      hOutStride,  // top_stride,
-                                      cOutStride,  // top_channel_stride,
-                                      nOutStride,  // top_batch_stride,
-                                      hdOutStride, // top_df_stride,
-                                      cdOutStride, // top_df_channel_stride,
-                                      ndOutStride, // top_df_batch_stride,
-                                      hdOutStride, // scale_stride,
-                                      cdOutStride, // scale_channel_stride,
-                                      ndOutStride, // scale_batch_stride,
-                                      out.data(),
-                                      dout.data(),
-                                      scale.data(),
-                                      in.data(),
-                                      dinhost.data());
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey(true);
+    if(!cache.load<Tref>("bwd_din", key, dinhost))
+    {
+        mloLRNBackwardRunHost<Tgpu, Tref>(static_cast<int>(v_mode),
+                                          pad,
+                                          v_lrnN,
+                                          alphaoverarea,
+                                          v_lrnAlpha,
+                                          v_lrnBeta,
+                                          v_lrnK,
+                                          nIn,         // batch_sz,
+                                          cOut,        // n_outputs,
+                                          cIn,         // n_inputs,
+                                          hIn,         // bot_height,
+                                          wIn,         // bot_width,
+                                          hInStride,   // bot_stride,
+                                          cInStride,   // bot_channel_stride,
+                                          nInStride,   // bot_batch_stride,
+                                          hdInStride,  // bot_df_v_stride,
+                                          cdInStride,  // bot_df_v_channel_stride,
+                                          ndInStride,  // bot_df_v_batch_stride,
+                                          hOut,        // top_height,
+                                          wOut,        // top_width,
+                                          hOutStride,  // top_stride,
+                                          cOutStride,  // top_channel_stride,
+                                          nOutStride,  // top_batch_stride,
+                                          hdOutStride, // top_df_stride,
+                                          cdOutStride, // top_df_channel_stride,
+                                          ndOutStride, // top_df_batch_stride,
+                                          hdOutStride, // scale_stride,
+                                          cdOutStride, // scale_channel_stride,
+                                          ndOutStride, // scale_batch_stride,
+                                          out.data(),
+                                          dout.data(),
+                                          scale.data(),
+                                          in.data(),
+                                          dinhost.data());
+        cache.save<Tref>("bwd_din", key, dinhost);
+    }
 
     auto error           = miopen::rms_range(dinhost, din);
     const Tref tolerance = 6.0e-5;
@@ -572,4 +584,30 @@ int LRNDriver<Tgpu, Tref>::VerifyBackward()
     return 0;
 }
 
+template <typename Tgpu, typename Tref>
+miopen::vcache_key LRNDriver<Tgpu, Tref>::GetVerificationCacheKey(bool backward) const
+{
+    std::ostringstream ss;
+    ss << "lrn_fp" << sizeof(Tgpu) * 8 << (backward ? "_bwd" : "_fwd");
+    for(auto&& flag : {"forw",
+                       "batchsize",
+                       "in_channels",
+                       "in_h",
+                       "in_w",
+                       "lrnN",
+                       "alpha",
+                       "beta",
+                       "lrnK",
+                       "mode"})
+        ss << "_" << inflags.GetValueStr(flag);
+
+    // The backward reference starts from the output and scale computed on the GPU.
+    miopen::vcache_hash inputs;
+    inputs.add(in);
+    if(backward)
+        inputs.add(dout).add(out).add(scale);
+
+    return {ss.str(), RAN_SEED(), inputs.value};
+}
+
 #endif // GUARD_MIOPEN_CONV_DRIVER_HPP
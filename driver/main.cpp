@@ -51,8 +51,8 @@ int main(int argc, char* argv[])
     Driver* drv;
     if(base_arg == "conv")
     {
-        // Maintain compatibility with legacy verification cache files (computed in doubles, stored
-        // as floats).
+        // Reference results are computed in doubles and stored in the verification cache as
+        // floats, which is accurate enough for an fp32 comparison at half the size.
         drv = new ConvDriver<float, double, float>();
     }
     else if(base_arg == "convfp16")
@@ -27,8 +27,12 @@
 #ifndef MLO_NORMHOST_H_
 #define MLO_NORMHOST_H_
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <vector>
+
+#include "../test/ford.hpp"
 
 ////////////////////////////////////////////////////////////
 //
@@ -39,6 +43,58 @@
 #define MLO_LRN_ACROSS_CHANNELS 1
 #endif
 
+// Sums of f(h, w) over the windows [j - pad, j - pad + local_area) x
+// [i - pad, i - pad + local_area) of a height x width plane, clipped to the
+// plane. The rows are summed first, so every point costs 2 * local_area
+// additions instead of local_area^2.
+template <typename _Tcheck, typename F>
+std::vector<_Tcheck> mloLRNWindowSums(int height, int width, int pad, int local_area, F f)
+{
+    std::vector<_Tcheck> rows(size_t(height) * width);
+    for(int h = 0; h < height; ++h)
+    {
+        for(int i = 0; i < width; ++i)
+        {
+            const int wstart = std::max(i - pad, 0);
+            const int wend   = std::min(i - pad + local_area, width);
+            _Tcheck sum      = static_cast<_Tcheck>(0);
+            for(int w = wstart; w < wend; ++w)
+                sum += f(h, w);
+            rows[size_t(h) * width + i] = sum;
+        }
+    }
+
+    std::vector<_Tcheck> sums(size_t(height) * width, static_cast<_Tcheck>(0));
+    for(int j = 0; j < height; ++j)
+    {
+        const int hstart = std::max(j - pad, 0);
+        const int hend   = std::min(j - pad + local_area, height);
+        _Tcheck* out     = sums.data() + size_t(j) * width;
+        for(int h = hstart; h < hend; ++h)
+        {
+            const _Tcheck* row = rows.data() + size_t(h) * width;
+            for(int i = 0; i < width; ++i)
+                out[i] += row[i];
+        }
+    }
+    return sums;
+}
+
+// Number of points of the window at (j, i), counting the padding but not the
+// points beyond it.
+inline int mloLRNAdjAreaSize(int j, int i, int pad, int local_area, int height, int width)
+{
+    const int hstart = j - pad;
+    const int wstart = i - pad;
+    const int hend   = std::min(hstart + local_area, height + pad);
+    const int wend   = std::min(wstart + local_area, width + pad);
+    return (hend - hstart) * (wend - wstart);
+}
+
+// Across channels, every (batch, row) pair is a task. The sum of squares
+// slides along the channels and is kept for a whole row of pixels at a time.
+// Within a channel, every (batch, channel) plane is a task, with separable
+// window sums.
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
           typename _Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloLRNForwardRunHost(bool do_scale,
@@ -73,190 +129,97 @@ int mloLRNForwardRunHost(bool do_scale,
     int ret = 0;
     if(norm_region == MLO_LRN_ACROSS_CHANNELS)
     {
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int j = 0; j < top_height; j++)
+        par_for(size_t(n_batchs) * top_height, 1, [&](size_t task) {
+            const int b = static_cast<int>(task / top_height);
+            const int j = static_cast<int>(task % top_height);
+
+            const _Tgpu* bot = bot_ptr + size_t(b) * bot_batch_stride + size_t(j) * bot_stride;
+            _Tcheck* scale_v =
+                scale_v_ptr + size_t(b) * scale_v_batch_stride + size_t(j) * scale_v_stride;
+            _Tcheck* top_v = top_v_ptr + size_t(b) * top_v_batch_stride + size_t(j) * top_v_stride;
+
+            std::vector<_Tcheck> accum_scale(top_width, static_cast<_Tcheck>(0));
+
+            // head enters the window, head - local_area leaves it, and channel head - pad is
+            // complete
+            for(int head = 0; head < n_inputs + pad; ++head)
             {
-                for(int i = 0; i < top_width; i++)
+                if(head < n_inputs)
                 {
-                    // c-emulator
-                    _Tcheck accum_scale = _Tcheck{0};
-                    int head            = 0;
-                    _Tcheck bot_val;
-                    while(head < pad)
-                    {
-                        bot_val = (head < n_inputs)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    head * bot_channel_stride + j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale += bot_val * bot_val;
-                        ++head;
-                    }
-                    // until we reach size, nothing needs to be subtracted
-                    while(head < local_area && head - pad >= 0 && head < n_inputs)
-                    {
-                        bot_val = (head < n_inputs)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    head * bot_channel_stride + j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale += bot_val * bot_val;
-                        _Tcheck scale = K + accum_scale * alphaoverarea;
-                        if((head - pad) >= 0 && do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride +
-                                        (head - pad) * scale_v_channel_stride + j * scale_v_stride +
-                                        i] = scale;
-                        }
-                        bot_val =
-                            ((head - pad) >= 0)
-                                ? static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                               (head - pad) * bot_channel_stride +
-                                                               j * bot_stride + i])
-                                : static_cast<_Tcheck>(0);
-                        _Tcheck s     = pow(scale, -beta);
-                        _Tcheck c_val = bot_val * s;
-                        if((head - pad) >= 0)
-                        {
-                            top_v_ptr[b * top_v_batch_stride + (head - pad) * top_v_channel_stride +
-                                      j * top_v_stride + i] = c_val;
-                        }
-                        ++head;
-                    }
-                    // both add and subtract
-                    while(head < n_inputs)
+                    const _Tgpu* in = bot + size_t(head) * bot_channel_stride;
+                    for(int i = 0; i < top_width; i++)
                     {
-                        bot_val = static_cast<_Tcheck>(
-                            bot_ptr[b * bot_batch_stride + head * bot_channel_stride +
-                                    j * bot_stride + i]);
-                        accum_scale += bot_val * bot_val;
-                        bot_val = ((head - local_area) >= 0)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    (head - local_area) * bot_channel_stride +
-                                                    j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale -= bot_val * bot_val;
-                        _Tcheck scale = K + accum_scale * alphaoverarea;
-                        if((head - pad) >= 0 && do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride +
-                                        (head - pad) * scale_v_channel_stride + j * scale_v_stride +
-                                        i] = scale;
-                        }
-                        _Tcheck s = pow(scale, -beta);
-                        bot_val =
-                            ((head - pad) >= 0)
-                                ? static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                               (head - pad) * bot_channel_stride +
-                                                               j * bot_stride + i])
-                                : static_cast<_Tcheck>(0);
-                        _Tcheck c_val = bot_val * s;
-                        if((head - pad) >= 0)
-                        {
-                            top_v_ptr[b * top_v_batch_stride + (head - pad) * top_v_channel_stride +
-                                      j * top_v_stride + i] = c_val;
-                        }
-                        ++head;
+                        const _Tcheck bot_val = static_cast<_Tcheck>(in[i]);
+                        accum_scale[i] += bot_val * bot_val;
                     }
-                    // subtract only
-                    while(head < n_inputs + pad)
+                }
+                const int tail = head - local_area;
+                if(tail >= 0 && tail < n_inputs)
+                {
+                    const _Tgpu* out = bot + size_t(tail) * bot_channel_stride;
+                    for(int i = 0; i < top_width; i++)
                     {
-                        bot_val = ((head - local_area) >= 0 && (head - local_area) < n_inputs)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    (head - local_area) * bot_channel_stride +
-                                                    j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale -= bot_val * bot_val;
-                        _Tcheck scale = K + accum_scale * alphaoverarea;
-                        if((head - pad) >= 0 && (head - pad) < n_outputs && do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride +
-                                        (head - pad) * scale_v_channel_stride + j * scale_v_stride +
-                                        i] = scale;
-                        }
-                        bot_val =
-                            ((head - pad) >= 0 && (head - pad) < n_inputs)
-                                ? static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                               (head - pad) * bot_channel_stride +
-                                                               j * bot_stride + i])
-                                : static_cast<_Tcheck>(0);
-                        _Tcheck s     = pow(scale, -beta);
-                        _Tcheck c_val = bot_val * s;
-                        if((head - pad) >= 0 && (head - pad) < n_outputs)
-                        {
-                            top_v_ptr[b * top_v_batch_stride + (head - pad) * top_v_channel_stride +
-                                      j * top_v_stride + i] = c_val;
-                        }
-                        ++head;
+                        const _Tcheck bot_val = static_cast<_Tcheck>(out[i]);
+                        accum_scale[i] -= bot_val * bot_val;
                     }
+                }
+                const int c = head - pad;
+                if(c < 0 || c >= n_outputs)
+                    continue;
 
-                } // for (int i = 0; i < top_width; i++)
-            }     // for (int j = 0; j < top_height; j++)
-        }         // for (int b = 0; b < batch; b++)
+                const _Tgpu* in = bot + size_t(c) * bot_channel_stride;
+                for(int i = 0; i < top_width; i++)
+                {
+                    _Tcheck scale = K + accum_scale[i] * alphaoverarea;
+                    if(do_scale)
+                        scale_v[size_t(c) * scale_v_channel_stride + i] = scale;
+                    top_v[size_t(c) * top_v_channel_stride + i] =
+                        static_cast<_Tcheck>(in[i]) * pow(scale, -beta);
+                }
+            }
+        });
     }
     else
     {
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int o = 0; o < n_outputs; o++)
+        par_for(size_t(n_batchs) * n_outputs, 1, [&](size_t task) {
+            const int b = static_cast<int>(task / n_outputs);
+            const int o = static_cast<int>(task % n_outputs);
+
+            const _Tgpu* bot =
+                bot_ptr + size_t(b) * bot_batch_stride + size_t(o) * bot_channel_stride;
+            _Tcheck* scale_v =
+                scale_v_ptr + size_t(b) * scale_v_batch_stride + size_t(o) * scale_v_channel_stride;
+            _Tcheck* top_v =
+                top_v_ptr + size_t(b) * top_v_batch_stride + size_t(o) * top_v_channel_stride;
+
+            const auto accum = mloLRNWindowSums<_Tcheck>(
+                bot_height, bot_width, pad, local_area, [&](int h, int w) {
+                    const _Tcheck bot_val = static_cast<_Tcheck>(bot[size_t(h) * bot_stride + w]);
+                    return bot_val * bot_val;
+                });
+
+            for(int j = 0; j < top_height; j++)
             {
-                for(int j = 0; j < top_height; j++)
+                for(int i = 0; i < top_width; i++)
                 {
-                    for(int i = 0; i < top_width; i++)
-                    {
-                        // c-emulator
-                        _Tcheck scale     = static_cast<_Tcheck>(0);
-                        int hstart        = j - pad;
-                        int wstart        = i - pad;
-                        int hend          = std::min(hstart + local_area, bot_height + pad);
-                        int wend          = std::min(wstart + local_area, bot_width + pad);
-                        int adj_area_size = (hend - hstart) * (wend - wstart);
-                        hstart            = std::max(hstart, 0);
-                        wstart            = std::max(wstart, 0);
-                        hend              = std::min(hend, bot_height);
-                        wend              = std::min(wend, bot_width);
-                        _Tcheck accum     = static_cast<_Tcheck>(0);
-                        for(int h = hstart; h < hend; ++h)
-                        {
-                            for(int w = wstart; w < wend; ++w)
-                            {
-
-                                _Tcheck bot_val = static_cast<_Tcheck>(
-                                    bot_ptr[b * bot_batch_stride + o * bot_channel_stride +
-                                            h * bot_stride + w]);
-                                accum += bot_val * bot_val;
-                            }
-                        }
-
-                        alphaoverarea = alpha / adj_area_size;
-                        scale         = K + accum * alphaoverarea;
-                        if(do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride + o * scale_v_channel_stride +
-                                        j * scale_v_stride + i] = scale;
-                        }
-
-                        _Tcheck s       = pow(scale, -beta);
-                        _Tcheck bot_val = static_cast<_Tcheck>(
-                            bot_ptr[b * bot_batch_stride + o * bot_channel_stride + j * bot_stride +
-                                    i]);
-                        _Tcheck c_val = bot_val * s;
-
-                        top_v_ptr[b * top_v_batch_stride + o * top_v_channel_stride +
-                                  j * top_v_stride + i] = c_val;
-
-                    } // for (int i = 0; i < top_width; i++)
-                }     // for (int j = 0; j < top_height; j++)
-            }         // for (int o = 0; o < outputs; o++)
-        }             // for (int b = 0; b < batch; b++)
-    }                 // (norm_region == ACROSS_CHANNELS)
+                    const int adj_area_size =
+                        mloLRNAdjAreaSize(j, i, pad, local_area, bot_height, bot_width);
+                    _Tcheck scale = K + accum[size_t(j) * bot_width + i] * (alpha / adj_area_size);
+                    if(do_scale)
+                        scale_v[size_t(j) * scale_v_stride + i] = scale;
+
+                    top_v[size_t(j) * top_v_stride + i] =
+                        static_cast<_Tcheck>(bot[size_t(j) * bot_stride + i]) * pow(scale, -beta);
+                }
+            }
+        });
+    } // (norm_region == ACROSS_CHANNELS)
 
     return (ret);
 }
 
+// Parallel in the same way as mloLRNForwardRunHost; across channels the sum of
+// top_df * top / scale slides along the channels.
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
           typename _Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloLRNBackwardRunHost(int norm_region,
@@ -304,252 +267,99 @@ int mloLRNBackwardRunHost(int norm_region,
         _Tcheck ratio_dta_bwd =
             static_cast<_Tcheck>(2.) * alpha * beta / static_cast<_Tcheck>(local_area);
 
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int j = 0; j < bot_height; j++)
-            {
-                for(int i = 0; i < bot_width; i++)
-                {
-
-                    // c-emulator
-                    int head            = 0;
-                    _Tcheck accum_ratio = static_cast<_Tcheck>(0);
-
-                    // accumulate values
-                    while(head < pad)
-                    {
-                        if(head < n_inputs)
-                        {
-                            _Tcheck adder =
-                                (static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride +
-                                                                 head * top_df_channel_stride +
-                                                                 j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride + head * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride + head * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio += adder;
-                        }
-
-                        ++head;
-                    }
+        par_for(size_t(n_batchs) * bot_height, 1, [&](size_t task) {
+            const int b = static_cast<int>(task / bot_height);
+            const int j = static_cast<int>(task % bot_height);
 
-                    // until we reach size, nothing needs to be subtracted
-                    while(head < local_area)
-                    {
+            const _Tgpu* top = top_ptr + size_t(b) * top_batch_stride + size_t(j) * top_stride;
+            const _Tgpu* top_df =
+                top_df_ptr + size_t(b) * top_df_batch_stride + size_t(j) * top_df_stride;
+            const _Tgpu* scale =
+                scale_ptr + size_t(b) * scale_batch_stride + size_t(j) * scale_stride;
+            const _Tgpu* bot = bot_ptr + size_t(b) * bot_batch_stride + size_t(j) * bot_stride;
+            _Tcheck* bot_df_v =
+                bot_df_v_ptr + size_t(b) * bot_df_v_batch_stride + size_t(j) * bot_df_v_stride;
 
-                        if(head < n_inputs)
-                        {
-                            _Tcheck adder =
-                                (static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride +
-                                                                 head * top_df_channel_stride +
-                                                                 j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride + head * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride + head * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio += adder;
-                        }
-
-                        if(head - pad >= 0 && head - pad < n_inputs)
-                        {
-                            bot_df_v_ptr[b * bot_df_v_batch_stride +
-                                         (head - pad) * bot_df_v_channel_stride +
-                                         j * bot_df_v_stride + i] =
-                                static_cast<_Tcheck>(
-                                    top_df_ptr[b * top_df_batch_stride +
-                                               (head - pad) * top_df_channel_stride +
-                                               j * top_df_stride + i]) *
-                                    pow(static_cast<_Tcheck>(
-                                            scale_ptr[b * scale_batch_stride +
-                                                      (head - pad) * scale_channel_stride +
-                                                      j * scale_stride + i]),
-                                        negative_beta) -
-                                ratio_dta_bwd *
-                                    static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                                 (head - pad) * bot_channel_stride +
-                                                                 j * bot_stride + i]) *
-                                    accum_ratio;
-                        }
-                        ++head;
-                    }
+            auto ratio = [&](int c, int i) {
+                return static_cast<_Tcheck>(top_df[size_t(c) * top_df_channel_stride + i]) *
+                       static_cast<_Tcheck>(top[size_t(c) * top_channel_stride + i]) /
+                       static_cast<_Tcheck>(scale[size_t(c) * scale_channel_stride + i]);
+            };
 
-                    // both add and subtract
-                    while(head < n_inputs)
-                    {
+            std::vector<_Tcheck> accum_ratio(bot_width, static_cast<_Tcheck>(0));
 
-                        _Tcheck adder =
-                            static_cast<_Tcheck>(
-                                top_df_ptr[b * top_df_batch_stride + head * top_df_channel_stride +
-                                           j * top_df_stride + i]) *
-                            static_cast<_Tcheck>(
-                                top_ptr[b * top_batch_stride + head * top_channel_stride +
-                                        j * top_stride + i]) /
-                            static_cast<_Tcheck>(
-                                scale_ptr[b * scale_batch_stride + head * scale_channel_stride +
-                                          j * scale_stride + i]);
-
-                        accum_ratio += adder;
-
-                        if(head - local_area >= 0)
-                        {
-                            _Tcheck subs =
-                                (static_cast<_Tcheck>(
-                                     top_df_ptr[b * top_df_batch_stride +
-                                                (head - local_area) * top_df_channel_stride +
-                                                j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride +
-                                             (head - local_area) * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride +
-                                              (head - local_area) * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio -= subs;
-                        }
-                        if(head - pad >= 0)
-                        {
-                            bot_df_v_ptr[b * bot_df_v_batch_stride +
-                                         (head - pad) * bot_df_v_channel_stride +
-                                         j * bot_df_v_stride + i] =
-                                static_cast<_Tcheck>(
-                                    top_df_ptr[b * top_df_batch_stride +
-                                               (head - pad) * top_df_channel_stride +
-                                               j * top_df_stride + i]) *
-                                    pow(static_cast<_Tcheck>(
-                                            scale_ptr[b * scale_batch_stride +
-                                                      (head - pad) * scale_channel_stride +
-                                                      j * scale_stride + i]),
-                                        negative_beta) -
-                                ratio_dta_bwd *
-                                    static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                                 (head - pad) * bot_channel_stride +
-                                                                 j * bot_stride + i]) *
-                                    accum_ratio;
-                        }
-
-                        ++head;
-                    }
-                    // subtract only
-                    while(head < n_inputs + pad)
-                    {
-                        if(head - local_area >= 0 && head - local_area < n_inputs)
-                        {
-                            _Tcheck subs =
-                                (static_cast<_Tcheck>(
-                                     top_df_ptr[b * top_df_batch_stride +
-                                                (head - local_area) * top_df_channel_stride +
-                                                j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride +
-                                             (head - local_area) * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride +
-                                              (head - local_area) * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio -= subs;
-                        }
-                        if(head - pad >= 0 && head - pad < n_inputs)
-                        {
-                            bot_df_v_ptr[b * bot_df_v_batch_stride +
-                                         (head - pad) * bot_df_v_channel_stride +
-                                         j * bot_df_v_stride + i] =
-                                static_cast<_Tcheck>(
-                                    top_df_ptr[b * top_df_batch_stride +
-                                               (head - pad) * top_df_channel_stride +
-                                               j * top_df_stride + i]) *
-                                    pow(static_cast<_Tcheck>(
-                                            scale_ptr[b * scale_batch_stride +
-                                                      (head - pad) * scale_channel_stride +
-                                                      j * scale_stride + i]),
-                                        negative_beta) -
-                                ratio_dta_bwd *
-                                    static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                                 (head - pad) * bot_channel_stride +
-                                                                 j * bot_stride + i]) *
-                                    accum_ratio;
-                        }
-
-                        ++head;
-                    }
+            for(int head = 0; head < n_inputs + pad; ++head)
+            {
+                if(head < n_inputs)
+                {
+                    for(int i = 0; i < bot_width; i++)
+                        accum_ratio[i] += ratio(head, i);
+                }
+                const int tail = head - local_area;
+                if(tail >= 0 && tail < n_inputs)
+                {
+                    for(int i = 0; i < bot_width; i++)
+                        accum_ratio[i] -= ratio(tail, i);
+                }
+                const int c = head - pad;
+                if(c < 0 || c >= n_inputs)
+                    continue;
 
-                } // for (int i = 0; i < bot_width; i++)
-            }     // for (int j = 0; j < bot_height; j++)
-        }         // for (int b = 0; b < n_batchs; b++)
-    }             // if (norm_region == MLO_LRN_ACROSS_CHANNELS)
+                for(int i = 0; i < bot_width; i++)
+                {
+                    bot_df_v[size_t(c) * bot_df_v_channel_stride + i] =
+                        static_cast<_Tcheck>(top_df[size_t(c) * top_df_channel_stride + i]) *
+                            pow(static_cast<_Tcheck>(scale[size_t(c) * scale_channel_stride + i]),
+                                negative_beta) -
+                        ratio_dta_bwd *
+                            static_cast<_Tcheck>(bot[size_t(c) * bot_channel_stride + i]) *
+                            accum_ratio[i];
+                }
+            }
+        });
+    } // if (norm_region == MLO_LRN_ACROSS_CHANNELS)
     else
     {
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int o = 0; o < n_inputs; o++)
+        par_for(size_t(n_batchs) * n_inputs, 1, [&](size_t task) {
+            const int b = static_cast<int>(task / n_inputs);
+            const int o = static_cast<int>(task % n_inputs);
+
+            const _Tgpu* top =
+                top_ptr + size_t(b) * top_batch_stride + size_t(o) * top_channel_stride;
+            const _Tgpu* top_df =
+                top_df_ptr + size_t(b) * top_df_batch_stride + size_t(o) * top_df_channel_stride;
+            const _Tgpu* scale =
+                scale_ptr + size_t(b) * scale_batch_stride + size_t(o) * scale_channel_stride;
+            const _Tgpu* bot =
+                bot_ptr + size_t(b) * bot_batch_stride + size_t(o) * bot_channel_stride;
+            _Tcheck* bot_df_v = bot_df_v_ptr + size_t(b) * bot_df_v_batch_stride +
+                                size_t(o) * bot_df_v_channel_stride;
+
+            const auto accum_ratio = mloLRNWindowSums<_Tcheck>(
+                top_height, top_width, pad, local_area, [&](int h, int w) {
+                    return static_cast<_Tcheck>(top_df[size_t(h) * top_df_stride + w]) *
+                           static_cast<_Tcheck>(top[size_t(h) * top_stride + w]) /
+                           static_cast<_Tcheck>(scale[size_t(h) * scale_stride + w]);
+                });
+
+            for(int j = 0; j < bot_height; j++)
             {
-                for(int j = 0; j < bot_height; j++)
+                for(int i = 0; i < bot_width; i++)
                 {
-
-                    for(int i = 0; i < bot_width; i++)
-                    {
-                        _Tcheck accum_ratio = static_cast<_Tcheck>(0);
-
-                        int hstart        = j - pad;
-                        int wstart        = i - pad;
-                        int hend          = std::min(hstart + local_area, top_height + pad);
-                        int wend          = std::min(wstart + local_area, top_width + pad);
-                        int adj_area_size = (hend - hstart) * (wend - wstart);
-                        hstart            = std::max(hstart, 0);
-                        wstart            = std::max(wstart, 0);
-                        hend              = std::min(hend, top_height);
-                        wend              = std::min(wend, top_width);
-                        for(int h = hstart; h < hend; ++h)
-                        {
-                            for(int w = wstart; w < wend; ++w)
-                            {
-                                _Tcheck adder =
-                                    static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride +
-                                                                    o * top_df_channel_stride +
-                                                                    h * top_df_stride + w]) *
-                                    static_cast<_Tcheck>(
-                                        top_ptr[b * top_batch_stride + o * top_channel_stride +
-                                                h * top_stride + w]) /
-                                    static_cast<_Tcheck>(
-                                        scale_ptr[b * scale_batch_stride +
-                                                  o * scale_channel_stride + h * scale_stride + w]);
-
-                                accum_ratio += adder;
-                            }
-                        }
-
-                        _Tcheck ratio_dta_bwd = static_cast<_Tcheck>(2.) * alpha * beta /
-                                                static_cast<_Tcheck>(adj_area_size);
-
-                        bot_df_v_ptr[b * bot_df_v_batch_stride + o * bot_df_v_channel_stride +
-                                     j * bot_df_v_stride + i] =
-                            static_cast<_Tcheck>(
-                                top_df_ptr[b * top_df_batch_stride + o * top_df_channel_stride +
-                                           j * top_df_stride + i]) *
-                                pow(static_cast<_Tcheck>(
-                                        scale_ptr[b * scale_batch_stride +
-                                                  o * scale_channel_stride + j * scale_stride + i]),
-                                    negative_beta) -
-                            ratio_dta_bwd *
-                                static_cast<_Tcheck>(
-                                    bot_ptr[b * bot_batch_stride + o * bot_channel_stride +
-                                            j * bot_stride + i]) *
-                                accum_ratio;
-                    }
+                    const int adj_area_size =
+                        mloLRNAdjAreaSize(j, i, pad, local_area, top_height, top_width);
+                    _Tcheck ratio_dta_bwd = static_cast<_Tcheck>(2.) * alpha * beta /
+                                            static_cast<_Tcheck>(adj_area_size);
+
+                    bot_df_v[size_t(j) * bot_df_v_stride + i] =
+                        static_cast<_Tcheck>(top_df[size_t(j) * top_df_stride + i]) *
+                            pow(static_cast<_Tcheck>(scale[size_t(j) * scale_stride + i]),
+                                negative_beta) -
+                        ratio_dta_bwd * static_cast<_Tcheck>(bot[size_t(j) * bot_stride + i]) *
+                            accum_ratio[size_t(j) * top_width + i];
                 }
             }
-        }
-
+        });
     } // if (norm_region == MLO_LRN_ACROSS_CHANNELS)
 
     return (ret);
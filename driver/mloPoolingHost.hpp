@@ -35,7 +35,10 @@
 #include <cmath>
 #include <cstring>
 #include <iomanip>
+#include <limits>
+#include <vector>
 
+#include "../test/ford.hpp"
 #include "calcerr.hpp"
 
 #if 0
@@ -74,6 +77,105 @@ double CalcErr( _T c_val, _T g_val)
 #define MLO_POOLING_OP_STC 2
 #endif
 
+// Computes the pooled output into top_ptr. For max pooling mask_ptr receives
+// the bottom index of each maximum, and mask_index_ptr (if not null) its
+// position within the window as the GPU mask stores it. Top points without
+// bottom points get the largest index of either type. Every (batch, channel)
+// plane is processed as a separate task.
+template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
+          typename _Tcheck /* the data type used in CPU checkings (usually double) */>
+int mloPoolingForwardRunHost(int pooling_method,
+                             int pad1,
+                             int stride1,
+                             int kernel_size1,
+                             int pad0,
+                             int stride0,
+                             int kernel_size0,
+                             int n_batchs,
+                             int n_outputs,
+                             int bot_height,
+                             int bot_width,
+                             int bot_stride,
+                             int bot_channel_stride,
+                             int bot_batch_stride,
+                             int top_height,
+                             int top_width,
+                             int top_stride,
+                             int top_channel_stride,
+                             int top_batch_stride,
+                             const _Tgpu* bot_ptr,
+                             _Tcheck* top_ptr,
+                             size_t* mask_ptr,
+                             uint8_t* mask_index_ptr)
+{
+    if(pooling_method != MLO_POOLING_OP_MAX && pooling_method != MLO_POOLING_OP_AVE)
+        return -1;
+
+    const _Tcheck MAX_VAL(3.402823466e+38);
+
+    par_for(static_cast<size_t>(n_batchs) * n_outputs, 1, [&](size_t plane) {
+        const int b          = static_cast<int>(plane / n_outputs);
+        const int o          = static_cast<int>(plane % n_outputs);
+        const size_t bot_off = size_t(b) * bot_batch_stride + size_t(o) * bot_channel_stride;
+        const size_t top_off = size_t(b) * top_batch_stride + size_t(o) * top_channel_stride;
+
+        for(int j = 0; j < top_height; j++)
+        {
+            int hstart = j * stride1 - pad1;
+            int hend   = std::min(hstart + kernel_size1, bot_height);
+            hstart     = std::max(hstart, 0);
+
+            for(int i = 0; i < top_width; i++)
+            {
+                int wstart = i * stride0 - pad0;
+                int wend   = std::min(wstart + kernel_size0, bot_width);
+                wstart     = std::max(wstart, 0);
+
+                const size_t top_index = top_off + size_t(j) * top_stride + i;
+
+                if(pooling_method == MLO_POOLING_OP_MAX)
+                {
+                    _Tcheck res          = -MAX_VAL;
+                    size_t res_index     = std::numeric_limits<size_t>::max();
+                    size_t res_index_gpu = std::numeric_limits<uint8_t>::max();
+                    for(int h = hstart; h < hend; ++h)
+                    {
+                        const _Tgpu* row = bot_ptr + bot_off + size_t(h) * bot_stride;
+                        for(int w = wstart; w < wend; ++w)
+                        {
+                            if(static_cast<_Tcheck>(row[w]) > res)
+                            {
+                                res           = static_cast<_Tcheck>(row[w]);
+                                res_index     = bot_off + size_t(h) * bot_stride + w;
+                                res_index_gpu = ((h - j * stride1 + pad1) * kernel_size0) +
+                                                (w - i * stride0 + pad0);
+                            }
+                        }
+                    }
+                    top_ptr[top_index]  = res;
+                    mask_ptr[top_index] = res_index;
+                    if(mask_index_ptr != nullptr)
+                        mask_index_ptr[top_index] = static_cast<uint8_t>(res_index_gpu);
+                }
+                else
+                {
+                    _Tcheck res = static_cast<_Tcheck>(0);
+                    for(int h = hstart; h < hend; ++h)
+                    {
+                        const _Tgpu* row = bot_ptr + bot_off + size_t(h) * bot_stride;
+                        for(int w = wstart; w < wend; ++w)
+                            res += static_cast<_Tcheck>(row[w]);
+                    }
+                    const int pool_size = (hend - hstart) * (wend - wstart);
+                    top_ptr[top_index]  = res / (pool_size == 0 ? 1 : pool_size);
+                }
+            }
+        }
+    });
+
+    return 0;
+}
+
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
           typename _Tcheck /* the data type used in CPU checkings (usually double) */>
 bool mloPoolingForwardRunHostAndVerify(int pooling_method,
@@ -102,15 +204,45 @@ bool mloPoolingForwardRunHostAndVerify(int pooling_method,
                                        uint8_t* mask_gpu,
                                        _Tcheck allowedEps)
 {
+    const size_t top_sz = size_t(n_batchs) * top_batch_stride;
+    std::vector<_Tcheck> top_host(top_sz);
+    std::vector<uint8_t> mask_index(top_sz);
+
+    if(mloPoolingForwardRunHost<_Tgpu, _Tcheck>(pooling_method,
+                                                pad1,
+                                                stride1,
+                                                kernel_size1,
+                                                pad0,
+                                                stride0,
+                                                kernel_size0,
+                                                n_batchs,
+                                                n_outputs,
+                                                bot_height,
+                                                bot_width,
+                                                bot_stride,
+                                                bot_channel_stride,
+                                                bot_batch_stride,
+                                                top_height,
+                                                top_width,
+                                                top_stride,
+                                                top_channel_stride,
+                                                top_batch_stride,
+                                                bot_ptr,
+                                                top_host.data(),
+                                                mask_ptr,
+                                                mask_index.data()) != 0)
+    {
+        std::cout << "ERROR: unknown operator : layer: pooling." << std::endl;
+        return false;
+    }
 
     bool match = true;
     _Tcheck MAX_VAL(3.402823466e+38);
     _Tgpu G_MAX_VAL = (sizeof(_Tgpu) == 4 || sizeof(_Tgpu) == 8)
                           ? static_cast<_Tgpu>(3.402823466e+38)
                           : static_cast<_Tgpu>(65504);
-    // c-emulator
-    _Tcheck res = static_cast<_Tcheck>(0);
 
+    // Reports the first mismatch only, in the order of the serial loops
     for(int b = 0; b < n_batchs && match; b++)
     {
         for(int o = 0; o < n_outputs && match; o++)
@@ -119,94 +251,26 @@ bool mloPoolingForwardRunHostAndVerify(int pooling_method,
             {
                 for(int i = 0; i < top_width && match; i++)
                 {
-                    // c-emulator
-                    if(pooling_method == MLO_POOLING_OP_MAX)
-                    {
-                        res = -MAX_VAL;
-                    }
-                    else if(pooling_method == MLO_POOLING_OP_AVE)
-                    {
-                        res = static_cast<_Tcheck>(0);
-                    }
-
-                    int hstart = j * stride1 - pad1;
-                    int wstart = i * stride0 - pad0;
-                    int hend   = std::min(hstart + kernel_size1, bot_height);
-                    int wend   = std::min(wstart + kernel_size0, bot_width);
-                    hstart     = std::max(hstart, 0);
-                    wstart     = std::max(wstart, 0);
-
-                    int pool_size        = (hend - hstart) * (wend - wstart);
-                    pool_size            = (pool_size == 0) ? 1 : pool_size;
-                    size_t res_index     = 0;
-                    size_t res_index_gpu = 0;
-                    bool found           = false;
-                    for(int h = hstart; h < hend; ++h)
-                    {
-                        for(int w = wstart; w < wend; ++w)
-                        {
-                            if(pooling_method == MLO_POOLING_OP_MAX)
-                            {
-                                size_t bot_index = b * bot_batch_stride + o * bot_channel_stride +
-                                                   h * bot_stride + w;
-                                if(static_cast<_Tcheck>(bot_ptr[bot_index]) > res)
-                                {
-                                    res           = static_cast<_Tcheck>(bot_ptr[bot_index]);
-                                    res_index     = bot_index;
-                                    res_index_gpu = ((h - j * stride1 + pad1) * kernel_size0) +
-                                                    (w - i * stride0 + pad0);
-                                    found = true;
-                                }
-                            }
-                            else if(pooling_method == MLO_POOLING_OP_AVE)
-                            {
+                    const size_t top_index = size_t(b) * top_batch_stride +
+                                             size_t(o) * top_channel_stride +
+                                             size_t(j) * top_stride + i;
 
-                                res += static_cast<_Tcheck>(
-                                    bot_ptr[b * bot_batch_stride + o * bot_channel_stride +
-                                            h * bot_stride + w]);
-                            }
-                            else
-                            {
-                                std::cout << "ERROR: unknown operator : layer: pooling."
-                                          << std::endl;
-                                match = false;
-                                continue;
-                            }
-                        }
-                    }
-                    // special index value is used to mark top points which has no associated bottom
-                    // points
-                    if(!found)
-                    {
-                        res_index     = std::numeric_limits<size_t>::max();
-                        res_index_gpu = std::numeric_limits<uint8_t>::max();
-                    }
-                    if(pooling_method == MLO_POOLING_OP_MAX)
+                    if(pooling_method == MLO_POOLING_OP_MAX && do_backward)
                     {
                         // the case with the odd input, the even kernel size and 2*pad == kernel
                         // size
-                        mask_ptr[b * top_batch_stride + o * top_channel_stride + j * top_stride +
-                                 i] = res_index;
-                        if(do_backward)
+                        uint8_t mg = mask_gpu[top_index];
+                        if(mg != mask_index[top_index])
                         {
-                            uint8_t mg = mask_gpu[b * top_batch_stride + o * top_channel_stride +
-                                                  j * top_stride + i];
-                            if(mg != res_index_gpu)
-                            {
-                                std::cout << "Mask mismatch, gpu " << mg << " cpu " << res_index_gpu
-                                          << "(" << res_index << ")" << std::endl;
-                                match = false;
-                            }
+                            std::cout << "Mask mismatch, gpu " << int(mg) << " cpu "
+                                      << int(mask_index[top_index]) << "(" << mask_ptr[top_index]
+                                      << ")" << std::endl;
+                            match = false;
                         }
                     }
-                    if(pooling_method == MLO_POOLING_OP_AVE)
-                    {
-                        res /= pool_size;
-                    }
-                    _Tcheck c_val = res;
 
-                    _Tgpu gg_val = (top_ptr[b * top_batch_stride + o * top_channel_stride +
-                                            j * top_stride + i]);
+                    _Tcheck c_val = top_host[top_index];
+                    _Tgpu gg_val  = top_ptr[top_index];
 
                     gg_val = (_Tgpu(gg_val) == _Tgpu(-G_MAX_VAL)) ? _Tgpu(0) : _Tgpu(gg_val);
 
@@ -232,6 +296,11 @@ bool mloPoolingForwardRunHostAndVerify(int pooling_method,
     return (match);
 }
 
+// Computes the gradient of every (batch, channel) plane as a separate task.
+// Max pooling scatters into bot_df_v_ptr, which must be zeroed, through the
+// mask of the forward pass. Average pooling gathers from the windows that
+// cover each bottom point; the top gradients are divided by their window size
+// once per plane.
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
           typename _Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloPoolingBackwardRunHost(
@@ -261,81 +330,81 @@ int mloPoolingBackwardRunHost(
     int top_width,
     int top_height)
 {
+    if(pooling_method != MLO_POOLING_OP_MAX && pooling_method != MLO_POOLING_OP_AVE)
+    {
+        std::cout << "ERROR: unknown operator : layer: pooling back-propagation." << std::endl;
+        return 0;
+    }
 
-    int ret = 0;
+    par_for(static_cast<size_t>(n_batchs) * n_outputs, 1, [&](size_t plane) {
+        const int b = static_cast<int>(plane / n_outputs);
+        const int o = static_cast<int>(plane % n_outputs);
+        const size_t bot_df_v_off =
+            size_t(b) * bot_df_v_batch_stride + size_t(o) * bot_df_v_channel_stride;
+        const size_t top_df_off =
+            size_t(b) * top_df_batch_stride + size_t(o) * top_df_channel_stride;
 
-    for(int b = 0; b < n_batchs; b++)
-    {
-        for(int o = 0; o < n_outputs; o++)
+        if(pooling_method == MLO_POOLING_OP_MAX)
         {
-            int bot_df_v_off = b * bot_df_v_batch_stride + o * bot_df_v_channel_stride;
-            int top_df_off   = b * top_df_batch_stride + o * top_df_channel_stride;
-
-            if(pooling_method == MLO_POOLING_OP_MAX)
+            // mask indices stay within the plane of their top point
+            for(int j = 0; j < top_height; j++)
             {
-                for(int j = 0; j < top_height; j++)
+                for(int i = 0; i < top_width; i++)
                 {
-                    for(int i = 0; i < top_width; i++)
-                    {
-                        size_t top_idx = top_df_off + j * top_df_stride + i;
-                        size_t bot_idx = mask_ptr[top_idx];
-                        // skip top points that don't have associated bottom points
-                        if(bot_idx == std::numeric_limits<size_t>::max())
-                            continue;
-                        bot_df_v_ptr[bot_idx] += static_cast<_Tcheck>(top_df_ptr[top_idx]);
-                    }
+                    size_t top_idx = top_df_off + size_t(j) * top_df_stride + i;
+                    size_t bot_idx = mask_ptr[top_idx];
+                    // skip top points that don't have associated bottom points
+                    if(bot_idx == std::numeric_limits<size_t>::max())
+                        continue;
+                    bot_df_v_ptr[bot_idx] += static_cast<_Tcheck>(top_df_ptr[top_idx]);
                 }
             }
-            else if(pooling_method == MLO_POOLING_OP_AVE)
+            return;
+        }
+
+        std::vector<_Tcheck> grad(size_t(top_height) * top_width);
+        for(int ph = 0; ph < top_height; ++ph)
+        {
+            int hstart = ph * stride1 - pad1;
+            int hend   = std::min(hstart + kernel_size1, bot_height);
+            hstart     = std::max(hstart, 0);
+            for(int pw = 0; pw < top_width; ++pw)
             {
+                int wstart = pw * stride0 - pad0;
+                int wend   = std::min(wstart + kernel_size0, bot_width);
+                wstart     = std::max(wstart, 0);
+
+                int pool_size = ((hend - hstart) * (wend - wstart) == 0)
+                                    ? 1
+                                    : (hend - hstart) * (wend - wstart);
+                grad[ph * top_width + pw] =
+                    static_cast<_Tcheck>(top_df_ptr[top_df_off + size_t(ph) * top_df_stride + pw]) /
+                    static_cast<_Tcheck>(pool_size);
+            }
+        }
 
-                for(int j = 0; j < bot_height; j++)
+        for(int j = 0; j < bot_height; j++)
+        {
+            int h       = j + pad1;
+            int phstart = (h < kernel_size1) ? 0 : (h - kernel_size1) / stride1 + 1;
+            int phend   = std::min(h / stride1 + 1, top_height);
+            for(int i = 0; i < bot_width; i++)
+            {
+                int w            = i + pad0;
+                int pwstart      = (w < kernel_size0) ? 0 : (w - kernel_size0) / stride0 + 1;
+                int pwend        = std::min(w / stride0 + 1, top_width);
+                _Tcheck gradient = static_cast<_Tcheck>(0);
+                for(int ph = phstart; ph < phend; ++ph)
                 {
-                    for(int i = 0; i < bot_width; i++)
-                    {
-                        // c-emulator
-                        bot_df_v_ptr[bot_df_v_off + j * bot_df_v_stride + i] =
-                            static_cast<_Tcheck>(0);
-                        int h       = j + pad1;
-                        int w       = i + pad0;
-                        int phstart = (h < kernel_size1) ? 0 : (h - kernel_size1) / stride1 + 1;
-                        int phend   = std::min(h / stride1 + 1, top_height);
-                        int pwstart = (w < kernel_size0) ? 0 : (w - kernel_size0) / stride0 + 1;
-                        int pwend   = std::min(w / stride0 + 1, top_width);
-                        _Tcheck gradient = static_cast<_Tcheck>(0);
-                        for(int ph = phstart; ph < phend; ++ph)
-                        {
-                            for(int pw = pwstart; pw < pwend; ++pw)
-                            {
-                                // figure out the pooling size
-                                int hstart = ph * stride1 - pad1;
-                                int wstart = pw * stride0 - pad0;
-                                int hend   = std::min(hstart + kernel_size1, bot_height);
-                                int wend   = std::min(wstart + kernel_size0, bot_width);
-                                hstart     = std::max(hstart, 0);
-                                wstart     = std::max(wstart, 0);
-
-                                int pool_size = ((hend - hstart) * (wend - wstart) == 0)
-                                                    ? 1
-                                                    : (hend - hstart) * (wend - wstart);
-                                gradient += static_cast<_Tcheck>(
-                                                top_df_ptr[top_df_off + ph * top_df_stride + pw]) /
-                                            static_cast<_Tcheck>(pool_size);
-                            }
-                        }
-                        bot_df_v_ptr[bot_df_v_off + j * bot_df_v_stride + i] = gradient;
-                    }
+                    for(int pw = pwstart; pw < pwend; ++pw)
+                        gradient += grad[ph * top_width + pw];
                 }
-            }
-            else
-            {
-                std::cout << "ERROR: unknown operator : layer: pooling back-propagation."
-                          << std::endl;
-                continue;
+                bot_df_v_ptr[bot_df_v_off + size_t(j) * bot_df_v_stride + i] = gradient;
             }
         }
-    }
-    return (ret);
+    });
+
+    return 0;
 }
 
 #ifdef __clang__
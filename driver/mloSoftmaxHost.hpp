@@ -25,44 +25,68 @@ POSSIBILITY OF SUCH DAMAGE.
 #ifndef MLO_SOFTMAXHOST_H_
 #define MLO_SOFTMAXHOST_H_
 
+#include <algorithm>
+#include <cmath>
+
+#include "../test/ford.hpp"
+
 ////////////////////////////////////////////////////////////
 //
 ///////////////////////////////////////////////////////////
 
+// The softmax runs along the channels for each (image, pixel) pair. Tasks
+// cover a tile of pixels of one image, and every channel pass walks the tile
+// contiguously, so the inner loops vectorize. The channels are visited in the
+// same order as a pixel-at-a-time loop, so the results do not change.
+constexpr int mloSoftmaxTileSize = 256;
+
 template <typename Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloSoftmaxForwardRunHost(int n, int c, int h, int w, Tcheck* channel_max, Tcheck* outhost)
 {
 
     int ret = 0;
 
-    for(int i = 0; i < n; i++)
-    {
-        for(int s = 0; s < h * w; s++)
+    const int hw    = h * w;
+    const int tiles = (hw + mloSoftmaxTileSize - 1) / mloSoftmaxTileSize;
+
+    par_for(size_t(n) * tiles, 1, [&](size_t task) {
+        const int i     = static_cast<int>(task / tiles);
+        const int begin = static_cast<int>(task % tiles) * mloSoftmaxTileSize;
+        const int end   = std::min(begin + mloSoftmaxTileSize, hw);
+
+        Tcheck* cmax = channel_max + size_t(i) * hw;
+        Tcheck* out  = outhost + size_t(i) * c * hw;
+
+        for(int j = 0; j < c; j++)
         {
-            for(int j = 0; j < c; j++)
-            {
-                channel_max[i * h * w + s] =
-                    std::max(outhost[(i * c + j) * h * w + s], channel_max[i * h * w + s]);
-            }
-
-            for(int j = 0; j < c; j++)
-            {
-                outhost[(i * c + j) * h * w + s] -= channel_max[i * h * w + s];
-                outhost[(i * c + j) * h * w + s] = exp(outhost[(i * c + j) * h * w + s]);
-            }
-
-            channel_max[i * h * w + s] = 0.0;
-            for(int j = 0; j < c; j++)
-            {
-                channel_max[i * h * w + s] += outhost[(i * c + j) * h * w + s];
-            }
-
-            for(int j = 0; j < c; j++)
-            {
-                outhost[(i * c + j) * h * w + s] /= channel_max[i * h * w + s];
-            }
+            const Tcheck* x = out + size_t(j) * hw;
+            for(int s = begin; s < end; s++)
+                cmax[s] = std::max(x[s], cmax[s]);
         }
-    }
+
+        for(int j = 0; j < c; j++)
+        {
+            Tcheck* x = out + size_t(j) * hw;
+            for(int s = begin; s < end; s++)
+                x[s] = exp(x[s] - cmax[s]);
+        }
+
+        for(int s = begin; s < end; s++)
+            cmax[s] = 0.0;
+        for(int j = 0; j < c; j++)
+        {
+            const Tcheck* x = out + size_t(j) * hw;
+            for(int s = begin; s < end; s++)
+                cmax[s] += x[s];
+        }
+
+        for(int j = 0; j < c; j++)
+        {
+            Tcheck* x = out + size_t(j) * hw;
+            for(int s = begin; s < end; s++)
+                x[s] /= cmax[s];
+        }
+    });
 
     return ret;
 }
@@ -75,25 +99,31 @@ int mloSoftmaxBackwardRunHost(
 
     int ret = 0;
 
-    for(int i = 0; i < n; i++)
-    {
-        for(int s = 0; s < h * w; s++)
+    const int hw    = h * w;
+    const int tiles = (hw + mloSoftmaxTileSize - 1) / mloSoftmaxTileSize;
+
+    par_for(size_t(n) * tiles, 1, [&](size_t task) {
+        const int i     = static_cast<int>(task / tiles);
+        const int begin = static_cast<int>(task % tiles) * mloSoftmaxTileSize;
+        const int end   = std::min(begin + mloSoftmaxTileSize, hw);
+
+        Tcheck* cdot  = channel_dot + size_t(i) * hw;
+        const Tgpu* y = out + size_t(i) * c * hw;
+        Tcheck* dx    = dinhost + size_t(i) * c * hw;
+
+        for(int j = 0; j < c; j++)
+        {
+            for(int s = begin; s < end; s++)
+                cdot[s] += static_cast<Tcheck>(y[size_t(j) * hw + s]) * dx[size_t(j) * hw + s];
+        }
+
+        for(int j = 0; j < c; j++)
         {
-            for(int j = 0; j < c; j++)
-            {
-                channel_dot[i * h * w + s] += static_cast<Tcheck>(out[(i * c + j) * h * w + s]) *
-                                              dinhost[(i * c + j) * h * w + s];
-            }
-
-            for(int j = 0; j < c; j++)
-            {
-                dinhost[(i * c + j) * h * w + s] -= channel_dot[i * h * w + s];
-                dinhost[(i * c + j) * h * w + s] =
-                    static_cast<Tcheck>(out[(i * c + j) * h * w + s]) *
-                    dinhost[(i * c + j) * h * w + s];
-            }
+            for(int s = begin; s < end; s++)
+                dx[size_t(j) * hw + s] =
+                    static_cast<Tcheck>(y[size_t(j) * hw + s]) * (dx[size_t(j) * hw + s] - cdot[s]);
         }
-    }
+    });
 
     return ret;
 }
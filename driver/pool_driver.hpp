@@ -39,6 +39,7 @@
 #include <miopen/tensor.hpp>
 #include <miopen/pooling.hpp>
 #include <numeric>
+#include <sstream>
 #include <vector>
 #include "random.hpp"
 
@@ -79,6 +80,8 @@ class PoolDriver : public Driver
 
     int VerifyBackward();
     int VerifyForward();
+
+    miopen::vcache_key GetVerificationCacheKey() const;
     ~PoolDriver()
     {
 
@@ -164,6 +167,7 @@ int PoolDriver<Tgpu, Tref>::AddCmdLineArgs()
     inflags.AddInputFlag("pad_val", 'r', "0", "Padding Value (Default=0)", "int");
     inflags.AddInputFlag("iter", 'i', "10", "Number of Iterations (Default=10)", "int");
     inflags.AddInputFlag("verify", 'V', "1", "Verify Each Layer (Default=1)", "int");
+    AddVerificationCacheFlag(inflags);
     inflags.AddInputFlag("time", 't', "0", "Time Each Layer (Default=0)", "int");
     inflags.AddInputFlag(
         "wall", 'w', "0", "Wall-clock Time Each Layer, Requires time == 1 (Default=0)", "int");
@@ -284,16 +288,10 @@ int PoolDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
     dout    = std::vector<Tgpu>(out_sz, static_cast<Tgpu>(0));
     dinhost = std::vector<Tref>(in_sz, static_cast<Tref>(0));
 
-    for(int i = 0; i < in_sz; i++)
-    {
-        in[i] = RAN_GEN<Tgpu>(static_cast<Tgpu>(0.0), static_cast<Tgpu>(1.0));
-    }
+    RAN_FILL(in, 0.0, 1.0, RAN_STREAM_IN);
 
-    Tgpu Data_scale = static_cast<Tgpu>(0.001);
-    for(int i = 0; i < out_sz; i++)
-    {
-        dout[i] = Data_scale * RAN_GEN<Tgpu>(static_cast<Tgpu>(-0.5), static_cast<Tgpu>(0.5));
-    }
+    const double Data_scale = 0.001;
+    RAN_FILL(dout, -0.5 * Data_scale, 0.5 * Data_scale, RAN_STREAM_DOUT);
 
 #if MIOPEN_BACKEND_OPENCL
     cl_int status;
@@ -566,29 +564,35 @@ int PoolDriver<Tgpu, Tref>::VerifyBackward()
     }
     int pooling_method = (mode == miopenPoolingMax) ? MLO_POOLING_OP_MAX : MLO_POOLING_OP_AVE;
 
-    mloPoolingBackwardRunHost<Tgpu, Tref>(pooling_method,
-                                          windowHeight,
-                                          pad_h,
-                                          u,
-                                          windowWidth,
-                                          pad_w,
-                                          v,
-                                          // host output
-                                          dinhost.data(),
-                                          dout.data(),
-                                          maskhost.data(),
-                                          ndInStride,
-                                          cdInStride,
-                                          hdInStride,
-                                          wIn,
-                                          hIn,
-                                          cOut,
-                                          nOut,
-                                          ndOutStride,
-                                          cdOutStride,
-                                          hdOutStride,
-                                          wOut,
-                                          hOut);
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey();
+    if(!cache.load<Tref>("bwd_din", key, dinhost))
+    {
+        mloPoolingBackwardRunHost<Tgpu, Tref>(pooling_method,
+                                              windowHeight,
+                                              pad_h,
+                                              u,
+                                              windowWidth,
+                                              pad_w,
+                                              v,
+                                              // host output
+                                              dinhost.data(),
+                                              dout.data(),
+                                              maskhost.data(),
+                                              ndInStride,
+                                              cdInStride,
+                                              hdInStride,
+                                              wIn,
+                                              hIn,
+                                              cOut,
+                                              nOut,
+                                              ndOutStride,
+                                              cdOutStride,
+                                              hdOutStride,
+                                              wOut,
+                                              hOut);
+        cache.save<Tref>("bwd_din", key, dinhost);
+    }
 
     bool match            = true;
     const Tref allowedEps = (1 << 2);
@@ -618,4 +622,31 @@ int PoolDriver<Tgpu, Tref>::VerifyBackward()
 
     return 0;
 }
+
+template <typename Tgpu, typename Tref>
+miopen::vcache_key PoolDriver<Tgpu, Tref>::GetVerificationCacheKey() const
+{
+    std::ostringstream ss;
+    ss << "pool_fp" << sizeof(Tgpu) * 8;
+    for(auto&& flag : {"batchsize",
+                       "in_channels",
+                       "in_h",
+                       "in_w",
+                       "win_h",
+                       "win_w",
+                       "pool_stride_0",
+                       "pool_stride_1",
+                       "pad_h",
+                       "pad_w",
+                       "mode",
+                       "pad_mode"})
+        ss << "_" << inflags.GetValueStr(flag);
+
+    // The backward reference routes the gradient through the mask of the host forward pass.
+    miopen::vcache_hash inputs;
+    inputs.add(in).add(dout).add(maskhost);
+
+    return {ss.str(), RAN_SEED(), inputs.value};
+}
+
 #endif // GUARD_MIOPEN_POOL_DRIVER_HPP
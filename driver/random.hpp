@@ -1,11 +1,50 @@
 #ifndef GUARD_RANDOM_GEN_
 #define GUARD_RANDOM_GEN_
 
+#include <miopen/env.hpp>
+#include <miopen/philox.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// The streams of the driver buffers. All buffers of a run share one seed and
+// differ by stream, so equally sized buffers get different contents.
+enum RanStream : std::uint64_t
+{
+    RAN_STREAM_SCALAR = 0, // the sequence of RAN_GEN
+    RAN_STREAM_IN,
+    RAN_STREAM_DOUT,
+    RAN_STREAM_WEI,
+    RAN_STREAM_HX,
+    RAN_STREAM_CX,
+    RAN_STREAM_DHY,
+    RAN_STREAM_DCY,
+};
+
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_DRIVER_SEED)
+
+// Seed of every driver input, MIOPEN_DRIVER_SEED or 0 if unset. It is part of the
+// verification cache key.
+inline std::uint64_t RAN_SEED()
+{
+    return static_cast<std::uint64_t>(miopen::Value(MIOPEN_DRIVER_SEED{}));
+}
+
+inline std::uint64_t& RAN_COUNTER()
+{
+    static std::uint64_t counter = 0;
+    return counter;
+}
+
+// Restarts the sequence of RAN_GEN. Unless the sequence is restarted between
+// runs, validation against results cached in files is impossible.
+inline void RAN_RESET() { RAN_COUNTER() = 0; }
+
 template <typename T>
 static T FRAND(void)
 {
-    double d = static_cast<double>(rand() / (static_cast<double>(RAND_MAX)));
-    return static_cast<T>(d);
+    const miopen::random_stream rs{RAN_SEED(), RAN_STREAM_SCALAR};
+    return static_cast<T>(rs.uniform(RAN_COUNTER()++));
 }
 
 template <typename T>
@@ -15,4 +54,13 @@ static T RAN_GEN(T A, T B)
     return r;
 }
 
+// Fills v with values uniform in [A, B). Element i depends only on stream and
+// i, so the buffer is generated in parallel and is the same for any number of
+// threads.
+template <typename T>
+static void RAN_FILL(std::vector<T>& v, double A, double B, RanStream stream)
+{
+    miopen::fill_uniform(v.data(), v.size(), A, B, miopen::random_stream{RAN_SEED(), stream});
+}
+
 #endif // GUARD_RANDOM_GEN_
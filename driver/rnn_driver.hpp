@@ -154,11 +154,7 @@ class RNNDriver : public Driver
     int adjustedSeqLen;
     std::vector<int> batchseq;
 
-    //    std::string GetVerificationCacheFileName() const;
-    //    bool TryReadVerificationCache(const std::string& file_name,
-    //                                  miopenTensorDescriptor_t& tensorDesc,
-    //                                  T* data) const;
-    //    void TrySaveVerificationCache(const std::string& file_name, std::vector<T>& data) const;
+    miopen::vcache_key GetVerificationCacheKey() const;
 };
 
 static inline bool CheckGuard(const int& in_h,
@@ -234,14 +230,7 @@ int RNNDriver<T>::AddCmdLineArgs()
     inflags.AddInputFlag("in_h", 'W', "32", "Input Length (Default=32)", "int");
     inflags.AddInputFlag("iter", 'i', "1", "Number of Iterations (Default=1)", "int");
     inflags.AddInputFlag("verify", 'V', "1", "Verify Each Layer (Default=1)", "int");
-    /*
-    // DL: This is disabled below, so I'm turninig it off here
-    inflags.AddInputFlag("verification_cache",
-                         'C',
-                         "",
-                         "Use specified directory to cache verification data. Off by default.",
-                         "string");
-    */
+    AddVerificationCacheFlag(inflags);
     inflags.AddInputFlag("time", 't', "0", "Time Each Layer (Default=0)", "int");
     inflags.AddInputFlag(
         "wall", 'w', "0", "Wall-clock Time Each Layer, Requires time == 1 (Default=0)", "int");
@@ -573,8 +562,6 @@ int RNNDriver<T>::AllocateBuffersAndCopy()
         std::string inFileName  = inflags.GetValueStr("in_data");
         std::string weiFileName = inflags.GetValueStr("weights");*/
 
-    // Unless seed is persistent between runs validation using cache stored in file is impossible.
-    srand(0);
     double scale = 0.01;
 
     /*    bool dataRead = false;
@@ -588,42 +575,22 @@ int RNNDriver<T>::AllocateBuffersAndCopy()
         }
     */
 
-    for(int i = 0; i < in_sz; i++)
-    {
-        in[i] = static_cast<T>((static_cast<double>(scale * rand()) * (1.0 / RAND_MAX)));
-    }
-
-    for(int i = 0; i < hy_sz; i++)
-    {
-        hx[i] = static_cast<T>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
-    }
+    RAN_FILL(in, 0.0, scale, RAN_STREAM_IN);
+    RAN_FILL(hx, 0.0, scale, RAN_STREAM_HX);
 
     if((inflags.GetValueStr("mode")) == "lstm")
     {
-        for(int i = 0; i < hy_sz; i++)
-        {
-            cx[i] = static_cast<T>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
-        }
+        RAN_FILL(cx, 0.0, scale, RAN_STREAM_CX);
     }
 
     if(inflags.GetValueInt("forw") != 1)
     {
-        for(int i = 0; i < out_sz; i++)
-        {
-            dout[i] = static_cast<T>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
-        }
-
-        for(int i = 0; i < hy_sz; i++)
-        {
-            dhy[i] = static_cast<T>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
-        }
+        RAN_FILL(dout, 0.0, scale, RAN_STREAM_DOUT);
+        RAN_FILL(dhy, 0.0, scale, RAN_STREAM_DHY);
 
         if((inflags.GetValueStr("mode")) == "lstm")
         {
-            for(int i = 0; i < hy_sz; i++)
-            {
-                dcy[i] = static_cast<T>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
-            }
+            RAN_FILL(dcy, 0.0, scale, RAN_STREAM_DCY);
         }
     }
 
@@ -637,10 +604,7 @@ int RNNDriver<T>::AllocateBuffersAndCopy()
         }
     */
 
-    for(int i = 0; i < wei_sz; i++)
-    {
-        wei[i] = static_cast<T>((scale * static_cast<double>((rand()) * (1.0 / RAND_MAX) - 0.5)));
-    }
+    RAN_FILL(wei, -0.5 * scale, 0.5 * scale, RAN_STREAM_WEI);
 
     if(inflags.GetValueInt("dump_output"))
     {
@@ -922,7 +886,6 @@ int RNNDriver<T>::RunForwardCPU()
         dumpBufferToFile("dump_fwd_out_cpu.bin", outhost.data(), outhost.size());
     }
 
-    //    TrySaveVerificationCache("fwd_out", outhost);
     return miopenStatusSuccess;
 }
 
@@ -1169,7 +1132,6 @@ int RNNDriver<T>::RunBackwardWeightsCPU()
         dumpBufferToFile("dump_bwd_dwei_cpu.bin", dwei_host.data(), dwei_host.size());
     }
 
-    //    TrySaveVerificationCache("bwd_wei", dwei_host);
     return miopenStatusSuccess;
 }
 
@@ -1290,76 +1252,30 @@ int RNNDriver<T>::RunBackwardDataCPU()
         dumpBufferToFile("dump_bwd_din_cpu.bin", din_host.data(), din_host.size());
     }
 
-    //    TrySaveVerificationCache("bwd_dat", din_host);
     return miopenStatusSuccess;
 }
 
-/*
 template <typename T>
-std::string RNNDriver<T>::GetVerificationCacheFileName() const
+miopen::vcache_key RNNDriver<T>::GetVerificationCacheKey() const
 {
     std::ostringstream ss;
-
-    miopenRNNMode_t mode;
-    int seqLength, layer, bidir;
-    miopenGetRNNDescriptor(
-        rnnDesc, &mode, &seqLength, &layer, &bidir);
-
-    const auto inputDesc = GetTensorLengths(const_cast<miopenTensorDescriptor_t&>(inputTensor));
-    const auto weiDesc   = GetTensorLengths(const_cast<miopenTensorDescriptor_t&>(weightTensor));
-    const auto outDesc   = GetTensorLengths(const_cast<miopenTensorDescriptor_t&>(outputTensor));
-
-    ss << inputDesc[1]        //_n_inputs
-       << "x" << inputDesc[2] //_in_height
-       << "x" << inputDesc[3] //_in_width
-       << "x" << weiDesc[2]   //_kernel_size1
-       << "x" << weiDesc[3]   //_kernel_size0
-       << "x" << weiDesc[0]   //_n_outputs
-       << "x" << outDesc[2]   //_out_height
-       << "x" << outDesc[3]   //_out_width
-       << "x" << inputDesc[0] //_batch_sz
-       << "_" << weiDesc[1] << "x" << pad_h << "x" << pad_w << "x" << u << "x" << v << "x" << sx
-       << "x" << sy << "x" << inflags.GetValueInt("pad_val");
-
-    return ss.str();
-}
-
-template <typename T>
-bool RNNDriver<T>::TryReadVerificationCache(const std::string& file_name,
-                                             miopenTensorDescriptor_t& tensorDesc,
-                                             T* data) const
-{
-    const auto verification_cache_path = inflags.GetValueStr("verification_cache");
-
-    if(!verification_cache_path.empty())
-    {
-        const auto file_path =
-            verification_cache_path + "/" + file_name + "_" + GetVerificationCacheFileName();
-        if(std::ifstream(file_path).good())
-        {
-            if(readBufferFromFile(data, GetTensorSize(tensorDesc), file_path.c_str()))
-            {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-template <typename T>
-void RNNDriver<T>::TrySaveVerificationCache(const std::string& file_name,
-                                             std::vector<T>& data) const
-{
-    const auto verification_cache_path = inflags.GetValueStr("verification_cache");
-    if(!verification_cache_path.empty())
-    {
-        const auto file_path =
-            verification_cache_path + "/" + file_name + "_" + GetVerificationCacheFileName();
-        dumpBufferToFile(file_path.c_str(), data.data(), data.size());
-    }
+    ss << "rnn_fp" << sizeof(T) * 8;
+    for(auto&& flag : {"mode",
+                       "num_layer",
+                       "seq_len",
+                       "bidirection",
+                       "batchsize",
+                       "hid_h",
+                       "in_h",
+                       "bias",
+                       "inputmode"})
+        ss << "_" << inflags.GetValueStr(flag);
+
+    miopen::vcache_hash inputs;
+    inputs.add(in).add(wei).add(hx).add(cx).add(dout).add(dhy).add(dcy);
+
+    return {ss.str(), RAN_SEED(), inputs.value};
 }
-*/
 
 template <typename T>
 int RNNDriver<T>::VerifyForward()
@@ -1388,9 +1304,19 @@ int RNNDriver<T>::VerifyForward()
         return miopenStatusBadParm;
     }
 
-    //   if(!TryReadVerificationCache("fwd_out", outputTensor, outhost.data()))
+    // The backward references start from the reserve space of the forward pass, so it is cached
+    // along with the outputs.
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey();
+    if(!(cache.load<T>("fwd_out", key, outhost) && cache.load<T>("fwd_hy", key, hy_host) &&
+         cache.load<T>("fwd_cy", key, cy_host) &&
+         cache.load<T>("fwd_rsv", key, reservespace_host)))
     {
         RunForwardCPU();
+        cache.save<T>("fwd_out", key, outhost);
+        cache.save<T>("fwd_hy", key, hy_host);
+        cache.save<T>("fwd_cy", key, cy_host);
+        cache.save<T>("fwd_rsv", key, reservespace_host);
     }
 
     auto error = miopen::rms_range(outhost, out);
@@ -1467,9 +1393,17 @@ int RNNDriver<T>::VerifyBackward()
 
     const double tolerance = 1e-6;
 
-    //   if(!TryReadVerificationCache("bwd_dat", inputTensor, din_host.data()))
+    const auto cache = GetVerificationCache(inflags);
+    const auto key   = GetVerificationCacheKey();
+    if(!(cache.load<T>("bwd_dat", key, din_host) && cache.load<T>("bwd_dhx", key, dhx_host) &&
+         cache.load<T>("bwd_dcx", key, dcx_host) &&
+         cache.load<T>("bwd_wsp", key, workspace_host)))
     {
         RunBackwardDataCPU();
+        cache.save<T>("bwd_dat", key, din_host);
+        cache.save<T>("bwd_dhx", key, dhx_host);
+        cache.save<T>("bwd_dcx", key, dcx_host);
+        cache.save<T>("bwd_wsp", key, workspace_host);
     }
 
     auto error_data = miopen::rms_range(din_host, din);
@@ -1510,9 +1444,10 @@ int RNNDriver<T>::VerifyBackward()
         }
     }
 
-    //    if(!TryReadVerificationCache("bwd_wei", weightTensor, dwei_host.data()))
+    if(!cache.load<T>("bwd_wei", key, dwei_host))
     {
         RunBackwardWeightsCPU();
+        cache.save<T>("bwd_wei", key, dwei_host);
     }
 
     auto error_weights = miopen::rms_range(dwei_host, dwei);
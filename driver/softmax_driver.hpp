@@ -190,16 +190,10 @@ int SoftmaxDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
     dout    = std::vector<Tgpu>(out_sz, static_cast<Tgpu>(0));
     dinhost = std::vector<Tref>(in_sz, static_cast<Tref>(0));
 
-    for(int i = 0; i < in_sz; i++)
-    {
-        in[i] = RAN_GEN<Tgpu>(static_cast<Tgpu>(0.0), static_cast<Tgpu>(1.0));
-    }
+    RAN_FILL(in, 0.0, 1.0, RAN_STREAM_IN);
 
-    Tgpu Data_scale = static_cast<Tgpu>(0.001);
-    for(int i = 0; i < out_sz; i++)
-    {
-        dout[i] = Data_scale * RAN_GEN<Tgpu>(static_cast<Tgpu>(-0.5), static_cast<Tgpu>(0.5));
-    }
+    const double Data_scale = 0.001;
+    RAN_FILL(dout, -0.5 * Data_scale, 0.5 * Data_scale, RAN_STREAM_DOUT);
 
 #if MIOPEN_BACKEND_OPENCL
     cl_int status;
@@ -32,6 +32,7 @@
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <miopen/config.h>
 #include <miopen/export.h>
@@ -76,6 +77,8 @@ extern "C" {
 typedef cl_command_queue miopenAcceleratorQueue_t;
 #elif MIOPEN_BACKEND_HIP
 typedef hipStream_t miopenAcceleratorQueue_t;
+#elif MIOPEN_BACKEND_CPU
+typedef void* miopenAcceleratorQueue_t;
 #endif
 
 /*! @ingroup handle
@@ -851,6 +854,56 @@ MIOPEN_EXPORT miopenStatus_t miopenConvolutionForward(miopenHandle_t handle,
                                                       void* workSpace,
                                                       size_t workSpaceSize);
 
+/*! @brief Transform the weights of a forward convolution once, ahead of its calls
+ *
+ * Algorithms that transform the weights on every call, such as FFT, read the transformed weights
+ * this function stores in the handle instead, for as long as they are cached for w. The cache is
+ * keyed by the address of w, the algorithm and the convolution problem, and records version.
+ * Calling this function again with the same version does nothing, and with a new version
+ * transforms the weights again. MIOpen does not watch w: after updating the weights, call this
+ * function with a new version or release them with miopenConvolutionForwardReleaseWeights(),
+ * and always release them before freeing w.
+ *
+ * On GPUs only the FFT filters of miopenConvolution mode are transformed ahead of time, as the
+ * Winograd kernels transform their filters themselves. The CPU backend transforms the filters
+ * of miopenConvolutionFwdAlgoWinograd.
+ *
+ * @param handle         MIOpen handle (input)
+ * @param xDesc          Tensor descriptor for data input tensor x (input)
+ * @param wDesc          Tensor descriptor for weight tensor w (input)
+ * @param w              Weights tensor w (input)
+ * @param convDesc       Convolution layer descriptor (input)
+ * @param yDesc          Tensor descriptor for output data tensor y (input)
+ * @param algo           Algorithm the weights are transformed for (input)
+ * @param version        Caller's version of the weights in w (input)
+ * @param workSpace      Pointer to the workspace miopenConvolutionForward() is given (input)
+ * @param workSpaceSize  Size in bytes of the workspace (input)
+ * @return               miopenStatus_t
+ */
+MIOPEN_EXPORT miopenStatus_t
+miopenConvolutionForwardPrepareWeights(miopenHandle_t handle,
+                                       const miopenTensorDescriptor_t xDesc,
+                                       const miopenTensorDescriptor_t wDesc,
+                                       const void* w,
+                                       const miopenConvolutionDescriptor_t convDesc,
+                                       const miopenTensorDescriptor_t yDesc,
+                                       miopenConvFwdAlgorithm_t algo,
+                                       uint64_t version,
+                                       void* workSpace,
+                                       size_t workSpaceSize);
+
+/*! @brief Release the transformed weights the handle keeps for a weight tensor
+ *
+ * Drops what miopenConvolutionForwardPrepareWeights() stored for w, for every algorithm and
+ * problem. Releasing weights that have nothing stored is not an error.
+ *
+ * @param handle         MIOpen handle (input)
+ * @param w              Weights tensor w (input)
+ * @return               miopenStatus_t
+ */
+MIOPEN_EXPORT miopenStatus_t miopenConvolutionForwardReleaseWeights(miopenHandle_t handle,
+                                                                    const void* w);
+
 /*! @brief Calculate element-wise scale and shift of a tensor via a bias tensor
  *
  *  This function applies an element-wise bias to a data tensor from an input bias tensor.
@@ -2234,6 +2287,14 @@ typedef enum {
     miopenRNNwithBias = 1, /*!< Biases will be applied to GEMM operations */
 } miopenRNNBiasMode_t;
 
+/*! @enum miopenRNNWeightLayout_t
+ * Layout of the weight matrices in the RNN parameter buffer
+*/
+typedef enum {
+    miopenRNNWeightsCanonical = 0, /*!< Row major matrices at miopenGetRNNLayerParamOffset() */
+    miopenRNNWeightsPacked    = 1, /*!< Every layer's matrices pre-transposed for the GEMMs */
+} miopenRNNWeightLayout_t;
+
 /*! @enum miopenRNNGEMMalgoMode_t
  * Recurrent Neural Network add on bias
 */
@@ -2888,6 +2949,72 @@ MIOPEN_EXPORT miopenStatus_t miopenSetRNNLayerBias(miopenHandle_t handle,
                                                    miopenTensorDescriptor_t biasDesc,
                                                    const void* layerBias);
 
+/*! @brief Sets the weight layout an RNN descriptor works with
+ *
+ * With miopenRNNWeightsPacked, the weights given to the forward and backward data calls and
+ * the weight gradients of the backward weights call are in the packed layout that
+ * miopenRNNPackWeights() produces. In this layout the input and hidden weight matrices of a
+ * layer are stored transposed and back to back, so the forward GEMMs read them as they are.
+ * The biases stay where they are in the canonical layout. miopenGetRNNLayerParam(),
+ * miopenSetRNNLayerParam() and miopenGetRNNLayerParamOffset() follow the layout, the latter
+ * returning a strided parameter descriptor for packed weights. miopenSetRNNDescriptor() resets
+ * the layout to miopenRNNWeightsCanonical.
+ *
+ * @param rnnDesc         RNN layer descriptor type (input)
+ * @param layout          Weight layout (input)
+ * @return                miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t miopenSetRNNWeightLayout(miopenRNNDescriptor_t rnnDesc,
+                                                      miopenRNNWeightLayout_t layout);
+
+/*! @brief Gets the weight layout of an RNN descriptor
+ *
+ * @param rnnDesc         RNN layer descriptor type (input)
+ * @param layout          Weight layout (output)
+ * @return                miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t miopenGetRNNWeightLayout(miopenRNNDescriptor_t rnnDesc,
+                                                      miopenRNNWeightLayout_t* layout);
+
+/*! @brief Converts RNN weights from the canonical layout to the packed one
+ *
+ * Repacks a whole parameter buffer once, for use with an RNN descriptor set to
+ * miopenRNNWeightsPacked. The conversion is not in place.
+ *
+ * @param handle          MIOpen handle (input)
+ * @param rnnDesc         RNN layer descriptor type (input)
+ * @param xDesc           A tensor descriptor to input (input)
+ * @param wDesc           A tensor descriptor to the parameter tensor (input)
+ * @param w               Pointer to the parameters in the canonical layout (input)
+ * @param packedW         Pointer to the parameters in the packed layout (output)
+ * @return                miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t miopenRNNPackWeights(miopenHandle_t handle,
+                                                  miopenRNNDescriptor_t rnnDesc,
+                                                  miopenTensorDescriptor_t xDesc,
+                                                  miopenTensorDescriptor_t wDesc,
+                                                  const void* w,
+                                                  void* packedW);
+
+/*! @brief Converts RNN weights from the packed layout back to the canonical one
+ *
+ * The inverse of miopenRNNPackWeights(). The conversion is not in place.
+ *
+ * @param handle          MIOpen handle (input)
+ * @param rnnDesc         RNN layer descriptor type (input)
+ * @param xDesc           A tensor descriptor to input (input)
+ * @param wDesc           A tensor descriptor to the parameter tensor (input)
+ * @param packedW         Pointer to the parameters in the packed layout (input)
+ * @param w               Pointer to the parameters in the canonical layout (output)
+ * @return                miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t miopenRNNUnpackWeights(miopenHandle_t handle,
+                                                    miopenRNNDescriptor_t rnnDesc,
+                                                    miopenTensorDescriptor_t xDesc,
+                                                    miopenTensorDescriptor_t wDesc,
+                                                    const void* packedW,
+                                                    void* w);
+
 /*! @brief Execute forward training for recurrent layer
  *
  * Interface for executing the forward training pass on a RNN.
@@ -3194,6 +3321,89 @@ MIOPEN_EXPORT miopenStatus_t miopenRNNForwardInference(miopenHandle_t handle,
                                                        void* workSpace,
                                                        size_t workSpaceNumBytes);
 
+/*! @brief Query the workspace of an RNN forward inference over an unsorted, padded batch
+ *
+ * This function calculates the workspace miopenRNNForwardInferenceUnsorted needs for a batch
+ * of sequences with the given lengths.
+ *
+ * @param handle          MIOpen handle (input)
+ * @param rnnDesc         RNN layer descriptor type (input)
+ * @param sequenceLen     Number of time steps of the padded batch (input)
+ * @param xDesc           An array of tensor descriptors, one per time step. The first
+ * dimension of each descriptor is the batch size, which is the same for all time steps. The
+ * second dimension is the input vector length. (input)
+ * @param seqLengths      Length of each sequence of the batch, between 1 and sequenceLen, in
+ * any order (input)
+ * @param numBytes        Number of bytes required for RNN layer execution (output)
+ * @return                miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t
+miopenGetRNNUnsortedWorkspaceSize(miopenHandle_t handle,
+                                  const miopenRNNDescriptor_t rnnDesc,
+                                  const int sequenceLen,
+                                  const miopenTensorDescriptor_t* xDesc,
+                                  const int* seqLengths,
+                                  size_t* numBytes);
+
+/*! @brief Execute forward inference for an RNN layer over an unsorted, padded batch
+ *
+ * Like miopenRNNForwardInference, but every time step holds the whole batch and the sequences
+ * may come in any order. Sample b of time step t is row t * batchSize + b of x and y, and is
+ * only part of the sequence while t < seqLengths[b]. MIOpen sorts the sequences by decreasing
+ * length, packs them, runs the RNN layer and restores the caller's order. Rows of y past the
+ * end of a sequence are zero, and hy and cy hold the state after the last step of each
+ * sequence, in the caller's order.
+ *
+ * @param handle                MIOpen handle (input)
+ * @param rnnDesc               RNN layer descriptor type (input)
+ * @param sequenceLen           Number of time steps of the padded batch (input)
+ * @param xDesc                 An array of tensor descriptors, one per time step, all with the
+ * batch size as first dimension and the input vector length as second dimension. (input)
+ * @param seqLengths            Length of each sequence of the batch, between 1 and
+ * sequenceLen, in any order (input)
+ * @param x                     Pointer to input tensor (input)
+ * @param hxDesc                A hidden tensor descriptor as in miopenRNNForwardInference
+ * (input)
+ * @param hx                    Pointer to the hidden layer input tensor, may be NULL (input)
+ * @param cxDesc                A cell tensor descriptor as in miopenRNNForwardInference (input)
+ * @param cx                    Pointer to the cell layer input tensor, may be NULL (input)
+ * @param wDesc                 A weights tensor descriptor (input)
+ * @param w                     Pointer to input weights tensor (input)
+ * @param yDesc                 An array of fully packed tensor descriptors, one per time step,
+ * all with the batch size as first dimension (input)
+ * @param y                     Pointer to output tensor (output)
+ * @param hyDesc                A hidden tensor descriptor as in miopenRNNForwardInference
+ * (input)
+ * @param hy                    Pointer to the hidden layer output tensor, may be NULL (output)
+ * @param cyDesc                A cell tensor descriptor as in miopenRNNForwardInference (input)
+ * @param cy                    Pointer to the cell layer output tensor, may be NULL (output)
+ * @param workSpace             Pointer to memory allocated for forward inference (input)
+ * @param workSpaceNumBytes     Number of allocated bytes in memory for the workspace, at least
+ * what miopenGetRNNUnsortedWorkspaceSize returns (input)
+ * @return                      miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t
+miopenRNNForwardInferenceUnsorted(miopenHandle_t handle,
+                                  miopenRNNDescriptor_t rnnDesc,
+                                  const int sequenceLen,
+                                  const miopenTensorDescriptor_t* xDesc,
+                                  const int* seqLengths,
+                                  const void* x,
+                                  const miopenTensorDescriptor_t hxDesc,
+                                  const void* hx,
+                                  const miopenTensorDescriptor_t cxDesc,
+                                  const void* cx,
+                                  const miopenTensorDescriptor_t wDesc,
+                                  const void* w,
+                                  const miopenTensorDescriptor_t* yDesc,
+                                  void* y,
+                                  const miopenTensorDescriptor_t hyDesc,
+                                  void* hy,
+                                  const miopenTensorDescriptor_t cyDesc,
+                                  void* cy,
+                                  void* workSpace,
+                                  size_t workSpaceNumBytes);
+
 /** @} */
 // CLOSEOUT RNN DOXYGEN GROUP
 
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/allocator_pool.hpp>
+
+#include <algorithm>
+
+namespace miopen {
+
+namespace {
+
+void* PoolAllocate(void* context, std::size_t n)
+{
+    return static_cast<AllocatorPool*>(context)->Allocate(n);
+}
+
+void PoolDeallocate(void* context, void* mem)
+{
+    static_cast<AllocatorPool*>(context)->Deallocate(mem);
+}
+
+} // namespace
+
+AllocatorPool::AllocatorPool(const Allocator& base_, std::size_t max_cached_bytes) : base(base_)
+{
+    assert(base.allocator != nullptr);
+    assert(base.deallocator != nullptr);
+    stats.max_cached = max_cached_bytes;
+}
+
+AllocatorPool::~AllocatorPool() { TrimTo(0); }
+
+std::size_t AllocatorPool::SizeClass(std::size_t n)
+{
+    const std::size_t min_class = 256;
+    if(n <= min_class)
+        return min_class;
+    std::size_t log2 = 0;
+    while((n >> (log2 + 1)) != 0)
+        ++log2;
+    const std::size_t step = std::size_t{1} << (log2 - 2);
+    return (n + step - 1) & ~(step - 1);
+}
+
+void* AllocatorPool::Allocate(std::size_t n)
+{
+    if(n == 0)
+        return base.allocator(base.context, 0);
+
+    const auto size_class = SizeClass(n);
+    std::lock_guard<std::mutex> guard(mutex);
+
+    auto it = free_lists.find(size_class);
+    if(it != free_lists.end() && !it->second.empty())
+    {
+        auto mem = it->second.back();
+        it->second.pop_back();
+        in_use[mem] = size_class;
+        stats.hits++;
+        stats.bytes_cached -= size_class;
+        stats.bytes_in_use += size_class;
+        return mem;
+    }
+
+    stats.misses++;
+    void* mem = nullptr;
+    try
+    {
+        mem = base.allocator(base.context, size_class);
+    }
+    catch(...)
+    {
+        if(stats.bytes_cached == 0)
+            throw;
+    }
+    if(mem == nullptr && stats.bytes_cached != 0)
+    {
+        // Out of memory may be caused by the cache itself.
+        TrimTo(0);
+        mem = base.allocator(base.context, size_class);
+    }
+    if(mem == nullptr)
+        return nullptr;
+
+    in_use[mem] = size_class;
+    stats.bytes_in_use += size_class;
+    stats.peak_bytes = std::max(stats.peak_bytes, stats.bytes_in_use + stats.bytes_cached);
+    return mem;
+}
+
+void AllocatorPool::Deallocate(void* mem)
+{
+    if(mem == nullptr)
+        return;
+    std::lock_guard<std::mutex> guard(mutex);
+
+    auto it = in_use.find(mem);
+    if(it == in_use.end())
+    {
+        // Zero-sized requests bypass the pool.
+        base.deallocator(base.context, mem);
+        return;
+    }
+    const auto size_class = it->second;
+    in_use.erase(it);
+    stats.bytes_in_use -= size_class;
+
+    if(stats.bytes_cached + size_class <= stats.max_cached)
+    {
+        free_lists[size_class].push_back(mem);
+        stats.bytes_cached += size_class;
+    }
+    else
+    {
+        base.deallocator(base.context, mem);
+        stats.releases++;
+    }
+}
+
+void AllocatorPool::TrimTo(std::size_t bytes)
+{
+    // Largest buffers go first, they are the most likely to be in the way.
+    for(auto it = free_lists.rbegin(); it != free_lists.rend() && stats.bytes_cached > bytes; ++it)
+    {
+        auto& buffers = it->second;
+        while(!buffers.empty() && stats.bytes_cached > bytes)
+        {
+            base.deallocator(base.context, buffers.back());
+            buffers.pop_back();
+            stats.bytes_cached -= it->first;
+            stats.releases++;
+        }
+    }
+}
+
+void AllocatorPool::Trim()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    TrimTo(0);
+}
+
+void AllocatorPool::SetMaxCached(std::size_t max_cached_bytes)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    stats.max_cached = max_cached_bytes;
+    TrimTo(max_cached_bytes);
+}
+
+AllocatorPoolStats AllocatorPool::GetStats() const
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return stats;
+}
+
+Allocator AllocatorPool::GetAllocator()
+{
+    return Allocator{&PoolAllocate, &PoolDeallocate, this, shared_from_this()};
+}
+
+} // namespace miopen
@@ -65,7 +65,7 @@ void DeriveBNTensorDescriptor(TensorDescriptor& derivedBnDesc,
 TensorDescriptor BuildReshaped4DTensorDescriptor(const miopen::TensorDescriptor& tDesc)
 {
     auto dataType = tDesc.GetType();
-    std::vector<size_t> dims(tDesc.GetLengths());
+    std::vector<size_t> dims(tDesc.GetLengths().begin(), tDesc.GetLengths().end());
 
     // NxCxDxHxW -> NxCx(D*H)xW
     dims[2] *= dims[3];
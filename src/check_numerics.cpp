@@ -1,4 +1,5 @@
 #include <miopen/check_numerics.hpp>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/logger.hpp>
 #include <miopen/env.hpp>
 
@@ -8,33 +9,23 @@ MIOPEN_DECLARE_ENV_VAR(MIOPEN_CHECK_NUMERICS)
 
 int CheckNumericsEnabled(int bitMask) { return (miopen::Value(MIOPEN_CHECK_NUMERICS{})) & bitMask; }
 
-// Must keep this structure synchronized with one in MIOpenCheckNumerics
-struct CheckNumericsResult
-{
-    float sum    = 0.0f;
-    float absSum = 0.0f;
-    float min    = 0.0f;
-    float max    = 0.0f;
-
-    int hasZero = 0;
-    int hasNan  = 0;
-    int hasInf  = 0;
-};
-
 bool checkNumericsImpl(
     Handle& handle, int mode, const TensorDescriptor& dDesc, ConstData_t data, bool isInput)
 {
     int numElements = dDesc.GetElementSize();
 
+    const int computeStats = (mode & CheckNumerics::ComputeStats);
+
+    CheckNumericsResult abnormal_h;
+
+#if MIOPEN_BACKEND_CPU
+    cpu::CheckNumerics(handle, data, numElements, computeStats != 0, abnormal_h);
+#else
     // TODO - some constants we should get from the device:
     const int blockSize             = 256;
     const int numBlocks             = handle.GetMaxComputeUnits() * 6;
     const size_t numGlobalWorkItems = blockSize * numBlocks;
 
-    const int computeStats = (mode & CheckNumerics::ComputeStats);
-
-    CheckNumericsResult abnormal_h;
-
     auto abnormal_d =
         handle.Create(sizeof(CheckNumericsResult)); // TODO - someday avoid slow malloc/free here
     handle.WriteTo(&abnormal_h, abnormal_d, sizeof(CheckNumericsResult));
@@ -47,6 +38,7 @@ bool checkNumericsImpl(
         data, numElements, abnormal_d.get(), computeStats);
 
     handle.ReadTo(&abnormal_h, abnormal_d, sizeof(CheckNumericsResult));
+#endif
 
     bool isAbnormal = (abnormal_h.hasNan != 0) || (abnormal_h.hasInf != 0);
 
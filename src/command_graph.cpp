@@ -0,0 +1,110 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/command_graph.hpp>
+#include <miopen/errors.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace miopen {
+
+void CommandGraph::Replay(const std::vector<const void*>& buffers)
+{
+    if(buffers.size() < num_slots)
+        MIOPEN_THROW(miopenStatusBadParm,
+                     "Command graph needs " + std::to_string(num_slots) + " buffers, got " +
+                         std::to_string(buffers.size()));
+    for(auto slot : used_slots)
+    {
+        if(buffers[slot] == nullptr)
+            MIOPEN_THROW(miopenStatusBadParm,
+                         "No buffer for command graph slot " + std::to_string(slot));
+    }
+
+    for(auto& node : nodes)
+    {
+        for(auto&& buffer_arg : node.buffer_args)
+        {
+            const void* buffer = buffers[buffer_arg.second];
+            std::memcpy(node.args[buffer_arg.first].buffer.data(), &buffer, sizeof(buffer));
+        }
+        node.launch(node.args);
+    }
+}
+
+void CommandGraphRecorder::BindBuffer(std::size_t slot, const void* buffer)
+{
+    if(buffer == nullptr)
+        MIOPEN_THROW(miopenStatusBadParm, "Cannot bind a null buffer to a command graph slot");
+    auto it = slots.find(buffer);
+    if(it != slots.end() && it->second != slot)
+        MIOPEN_THROW(miopenStatusBadParm,
+                     "Buffer is already bound to command graph slot " + std::to_string(it->second));
+    slots[buffer]   = slot;
+    graph.num_slots = std::max(graph.num_slots, slot + 1);
+}
+
+void CommandGraphRecorder::Record(std::string name,
+                                  std::vector<std::size_t> local_dims,
+                                  std::vector<std::size_t> global_dims,
+                                  std::vector<OpKernelArg> args,
+                                  CommandLaunch launch)
+{
+    CommandGraphNode node{std::move(name),
+                          std::move(local_dims),
+                          std::move(global_dims),
+                          std::move(args),
+                          {},
+                          std::move(launch)};
+    for(std::size_t i = 0; i < node.args.size(); i++)
+    {
+        const auto& arg = node.args[i];
+        if(!arg.is_ptr || arg.size() != sizeof(const void*))
+            continue;
+        const void* ptr = nullptr;
+        std::memcpy(&ptr, arg.buffer.data(), sizeof(ptr));
+        auto it = slots.find(ptr);
+        if(it == slots.end())
+            continue;
+        node.buffer_args.emplace_back(i, it->second);
+        graph.used_slots.push_back(it->second);
+    }
+    graph.nodes.push_back(std::move(node));
+}
+
+CommandGraph CommandGraphRecorder::Finish()
+{
+    auto& used = graph.used_slots;
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+
+    CommandGraph result = std::move(graph);
+    graph               = CommandGraph{};
+    slots.clear();
+    return result;
+}
+
+} // namespace miopen
@@ -0,0 +1,371 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/conv_cost_model.hpp>
+#include <miopen/convolution_fft.hpp>
+#include <miopen/db_path.hpp>
+#include <miopen/env.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/logger.hpp>
+#include <miopen/perf_field.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_FIND_PRUNE_FACTOR)
+
+namespace miopen {
+
+double ConvCostDevice::PeakFlops(bool half) const
+{
+    return compute_units * 64 * 2 * clock_mhz * 1e3 * (half ? 2 : 1);
+}
+
+ConvCostDevice ConvCostDevice::Query(Handle& handle)
+{
+    static const std::map<std::string, double> bandwidths = {
+        {"gfx803", 512}, {"gfx900", 484}, {"gfx906", 1024},
+    };
+
+    ConvCostDevice device;
+    device.compute_units = handle.GetMaxComputeUnits();
+    const auto clock     = handle.GetMaxClockFrequency();
+    if(clock != 0)
+        device.clock_mhz = clock;
+    const auto bandwidth = bandwidths.find(handle.GetDeviceName());
+    if(bandwidth != bandwidths.end())
+        device.bandwidth = bandwidth->second;
+    return device;
+}
+
+bool GetConvAlgoClass(const std::string& algorithm, ConvAlgoClass& algo)
+{
+    static const std::pair<const char*, ConvAlgoClass> suffixes[] = {
+        {"GEMM", ConvAlgoClass::gemm},
+        {"Direct", ConvAlgoClass::direct},
+        {"Winograd", ConvAlgoClass::winograd},
+        {"FFT", ConvAlgoClass::fft},
+    };
+    for(const auto& suffix : suffixes)
+    {
+        const std::string s = std::string("Algo") + suffix.first;
+        if(algorithm.size() >= s.size() &&
+           algorithm.compare(algorithm.size() - s.size(), s.size(), s) == 0)
+        {
+            algo = suffix.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+ConvCost GetConvCost(const ProblemDescription& problem, ConvAlgoClass algo)
+{
+    const double elem   = problem.float_size / 8;
+    const double n      = problem.batch_sz;
+    const double c      = problem.n_inputs;
+    const double k      = problem.n_outputs;
+    const double groups = std::max(problem.group_counts, 1);
+    const double filter = double(problem.kernel_size0) * problem.kernel_size1;
+    const double in     = double(problem.in_height) * problem.in_width;
+    const double out    = double(problem.out_height) * problem.out_width;
+    // A transposed convolution runs the filter over its input
+    const double steps = problem.mode.IsTranspose() ? in : out;
+
+    const double macs    = n * c * k / groups * filter * steps;
+    const double tensors = elem * (n * c * in + n * k * out + c * k / groups * filter);
+
+    ConvCost cost;
+    switch(algo)
+    {
+    case ConvAlgoClass::gemm:
+    {
+        const bool unit = problem.kernel_size0 == 1 && problem.kernel_size1 == 1 &&
+                          problem.pad0 == 0 && problem.pad1 == 0 &&
+                          problem.kernel_stride0 == 1 && problem.kernel_stride1 == 1;
+        cost.flops = 2 * macs;
+        // im2col (col2im) writes and the GEMM reads a column matrix per image
+        cost.bytes   = tensors + (unit ? 0 : 2 * elem * n * c * filter * steps);
+        cost.kernels = unit ? 1 : 2;
+        break;
+    }
+    case ConvAlgoClass::direct:
+        cost.flops   = 2 * macs;
+        cost.bytes   = tensors;
+        cost.kernels = problem.direction.IsBackwardWrW() ? 2 : 1;
+        break;
+    case ConvAlgoClass::winograd:
+        // F(2x2, 3x3) does 16 multiplies for every 36 of a direct 2x2 output tile
+        cost.flops = 2 * macs / 2.25;
+        cost.bytes = tensors;
+        break;
+    case ConvAlgoClass::fft:
+    {
+        // Half spectrum of a tile, transforms of the images, the filters and the products
+        const double tile       = FFTConvParams::TileSize(problem.in_height, problem.in_width);
+        const double length     = 2 * tile;
+        const double transforms = n * c + c * k + n * k;
+        cost.flops =
+            transforms * 2.5 * length * std::log2(length) + 8 * tile * n * c * k / groups;
+        // Every spectrum is written and read back, once more around the transposes
+        cost.bytes   = tensors + 4 * 2 * elem * tile * transforms;
+        cost.kernels = FFTConvParams::NumKernels;
+        break;
+    }
+    }
+    return cost;
+}
+
+double ConvCostModel::Roofline(const ProblemDescription& problem, ConvAlgoClass algo) const
+{
+    const auto cost = GetConvCost(problem, algo);
+    return std::max(cost.flops / device.PeakFlops(problem.float_size == 16),
+                    cost.bytes / device.PeakBytes());
+}
+
+double ConvCostModel::Estimate(const ProblemDescription& problem,
+                               const std::string& algorithm) const
+{
+    ConvAlgoClass algo;
+    if(!GetConvAlgoClass(algorithm, algo))
+        return -1;
+    const auto cost = GetConvCost(problem, algo);
+    return Roofline(problem, algo) / Efficiency(algo) + cost.kernels * device.launch_time;
+}
+
+std::size_t ConvCostModel::Calibrate(const std::vector<ConvCostSample>& samples)
+{
+    std::array<double, 4> log_sum{};
+    std::array<std::size_t, 4> count{};
+    for(const auto& sample : samples)
+    {
+        ConvAlgoClass algo;
+        if(!GetConvAlgoClass(sample.algorithm, algo))
+            continue;
+        const double roofline = Roofline(sample.problem, algo);
+        const double busy =
+            sample.time - GetConvCost(sample.problem, algo).kernels * device.launch_time;
+        if(!(roofline > 0) || !(busy > 0))
+            continue;
+        log_sum[Index(algo)] += std::log(roofline / busy);
+        count[Index(algo)]++;
+    }
+
+    std::size_t used = 0;
+    for(std::size_t i = 0; i < efficiency.size(); i++)
+    {
+        if(count[i] == 0)
+            continue;
+        efficiency[i] = std::exp(log_sum[i] / count[i]);
+        used += count[i];
+    }
+    return used;
+}
+
+std::size_t ConvCostModel::CalibrateFromFindDb(std::istream& find_db)
+{
+    std::vector<ConvCostSample> samples;
+    std::string line;
+    while(std::getline(find_db, line))
+    {
+        const auto key_size = line.find('=');
+        ProblemDescription problem;
+        if(key_size == std::string::npos ||
+           !ParseConvProblemKey(line.substr(0, key_size), problem))
+            continue;
+
+        std::istringstream contents(line.substr(key_size + 1));
+        std::string id_and_values;
+        while(std::getline(contents, id_and_values, ';'))
+        {
+            const auto id_size = id_and_values.find(':');
+            FindDbData data;
+            if(id_size == std::string::npos || !data.Deserialize(id_and_values.substr(id_size + 1)))
+                continue;
+            samples.push_back({problem, id_and_values.substr(0, id_size), data.time});
+        }
+    }
+    return Calibrate(samples);
+}
+
+namespace {
+
+// Reads "<a><sep><b>" into a and b
+bool ReadPair(std::istream& in, int& a, char sep, int& b)
+{
+    char c = 0;
+    return static_cast<bool>(in >> a >> c >> b) && c == sep;
+}
+
+bool Expect(std::istream& in, char sep)
+{
+    char c = 0;
+    return static_cast<bool>(in.get(c)) && c == sep;
+}
+
+} // namespace
+
+bool ParseConvProblemKey(const std::string& key, ProblemDescription& problem)
+{
+    const auto optional_start = key.find('_');
+    std::istringstream in(key.substr(0, optional_start));
+    ProblemDescription p;
+    int unused = 0;
+
+    // The layout of ProblemDescription::Serialize
+    const bool ok =
+        in >> p.n_inputs && Expect(in, '-') && in >> p.in_height && Expect(in, '-') &&
+        in >> p.in_width && Expect(in, '-') && ReadPair(in, p.kernel_size1, 'x', p.kernel_size0) &&
+        Expect(in, '-') && in >> p.n_outputs && Expect(in, '-') && in >> p.out_height &&
+        Expect(in, '-') && in >> p.out_width && Expect(in, '-') && in >> p.batch_sz &&
+        Expect(in, '-') && ReadPair(in, p.pad1, 'x', p.pad0) && Expect(in, '-') &&
+        ReadPair(in, p.kernel_stride1, 'x', p.kernel_stride0) && Expect(in, '-') &&
+        ReadPair(in, p.kernel_dilation1, 'x', unused) && Expect(in, '-') && in >> p.bias &&
+        Expect(in, '-') && std::getline(in, p.in_layout, '-') &&
+        std::getline(in, p.in_data_type, '-');
+    std::string direction;
+    if(!ok || !(in >> direction) || (p.in_data_type != "FP32" && p.in_data_type != "FP16"))
+        return false;
+
+    // Serialize writes the vertical dilation twice
+    p.kernel_dilation0 = p.kernel_dilation1;
+    p.float_size       = p.in_data_type == "FP32" ? 32 : 16;
+    p.out_layout       = p.in_layout;
+    p.out_data_type    = p.in_data_type;
+    if(direction == "F")
+        p.direction.Set(1);
+    else if(direction == "B")
+        p.direction.Set(0);
+    else if(direction == "W")
+        p.direction.SetBackwardWrW();
+    else
+        return false;
+
+    p.group_counts = 1;
+    if(optional_start != std::string::npos)
+    {
+        std::string optional = key.substr(optional_start + 1);
+        if(optional.compare(0, 2, "mT") == 0)
+        {
+            p.mode.val = miopenTranspose;
+            optional   = optional.substr(2);
+        }
+        if(!optional.empty())
+        {
+            std::istringstream groups(optional);
+            if(!Expect(groups, 'g') || !(groups >> p.group_counts) || groups.get() != EOF)
+                return false;
+            // Group and depthwise convolutions serialize alike
+            if(!p.mode.IsTranspose())
+                p.mode.val = miopenGroupConv;
+        }
+    }
+
+    problem = p;
+    return true;
+}
+
+const ConvCostModel& GetConvCostModel(Handle& handle)
+{
+    static std::mutex mutex;
+    static std::map<std::string, ConvCostModel> models;
+
+    const auto find_db_path = GetFindDbPath() + "/" + handle.GetDbPathFilename() + ".cd.fdb.txt";
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = models.find(find_db_path);
+    if(it != models.end())
+        return it->second;
+
+    ConvCostModel model(ConvCostDevice::Query(handle));
+    std::ifstream find_db(find_db_path);
+    if(find_db)
+    {
+        const auto samples = model.CalibrateFromFindDb(find_db);
+        MIOPEN_LOG_I2("Cost model calibrated on " << samples << " times from " << find_db_path);
+    }
+    return models.emplace(find_db_path, model).first->second;
+}
+
+std::vector<std::string>
+RunConvFindCandidates(const ConvCostModel& model,
+                      const ProblemDescription& problem,
+                      double factor,
+                      std::vector<ConvFindCandidate> candidates,
+                      const std::function<bool(const std::string&)>& found)
+{
+    std::vector<std::string> skipped;
+    if(factor <= 0)
+    {
+        for(const auto& candidate : candidates)
+            candidate.find();
+        return skipped;
+    }
+
+    // Candidates of no known family go last and are never skipped
+    std::vector<std::pair<double, ConvFindCandidate>> order;
+    for(auto& candidate : candidates)
+    {
+        const double estimate = model.Estimate(problem, candidate.algorithm);
+        order.emplace_back(estimate < 0 ? std::numeric_limits<double>::max() : estimate,
+                           std::move(candidate));
+    }
+    std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    double best = -1;
+    for(const auto& entry : order)
+    {
+        const auto& candidate = entry.second;
+        if(best >= 0 && entry.first != std::numeric_limits<double>::max() &&
+           entry.first > factor * best)
+        {
+            MIOPEN_LOG_I2(candidate.algorithm << " skipped, predicted " << entry.first
+                                              << " ms against "
+                                              << best
+                                              << " ms");
+            skipped.push_back(candidate.algorithm);
+            continue;
+        }
+        candidate.find();
+        if(best < 0 && found(candidate.algorithm))
+            best = entry.first;
+    }
+    return skipped;
+}
+
+double GetConvFindPruneFactor()
+{
+    const char* value = GetStringEnv(MIOPEN_FIND_PRUNE_FACTOR{});
+    return value == nullptr ? 0 : std::strtod(value, nullptr);
+}
+
+} // namespace miopen
@@ -315,6 +315,14 @@ size_t ConvolutionDescriptor::ForwardGetWorkSpaceSize(Handle& handle,
                                                       const TensorDescriptor& yDesc) const
 {
     MIOPEN_LOG_I2("");
+#if MIOPEN_BACKEND_CPU
+    (void)handle;
+    (void)wDesc;
+    (void)xDesc;
+    (void)yDesc;
+    // The host convolution of the CPU backend needs no workspace.
+    return 0;
+#else
     if(mode == miopenTranspose)
 #if MIOPEN_USE_GEMM
         return BackwardDataGetWorkSpaceSizeGEMM(handle, wDesc, xDesc);
@@ -371,6 +379,7 @@ size_t ConvolutionDescriptor::ForwardGetWorkSpaceSize(Handle& handle,
             return std::max(std::max(workspace_size_fft, workspace_size_gemm), direct_workspace);
         }
     }
+#endif
 }
 
 size_t ConvolutionDescriptor::BackwardDataGetWorkSpaceSize(Handle& handle,
@@ -379,6 +388,14 @@ size_t ConvolutionDescriptor::BackwardDataGetWorkSpaceSize(Handle& handle,
                                                            const TensorDescriptor& dxDesc) const
 {
     MIOPEN_LOG_I2("");
+#if MIOPEN_BACKEND_CPU
+    (void)handle;
+    (void)wDesc;
+    (void)dyDesc;
+    (void)dxDesc;
+    // The host convolution of the CPU backend needs no workspace.
+    return 0;
+#else
     if(mode == miopenTranspose)
 #if MIOPEN_USE_GEMM
         return ForwardGetWorkSpaceSizeGEMM(handle, wDesc, dxDesc);
@@ -429,6 +446,7 @@ size_t ConvolutionDescriptor::BackwardDataGetWorkSpaceSize(Handle& handle,
             return std::max(std::max(workspace_size_fft, workspace_size_gemm), direct_workspace);
         }
     }
+#endif
 }
 
 // weights_n = output_c
@@ -682,6 +700,14 @@ size_t ConvolutionDescriptor::ConvolutionBackwardWeightsGetWorkSpaceSize(
     const TensorDescriptor& dwDesc) const
 {
     MIOPEN_LOG_I2("");
+#if MIOPEN_BACKEND_CPU
+    (void)handle;
+    (void)dyDesc;
+    (void)xDesc;
+    (void)dwDesc;
+    // The host convolution of the CPU backend needs no workspace.
+    return 0;
+#else
     int groups = 1;
     if(mode == miopenDepthwise)
         groups = xDesc.GetLengths()[1];
@@ -708,6 +734,7 @@ size_t ConvolutionDescriptor::ConvolutionBackwardWeightsGetWorkSpaceSize(
     }
 
     return workspace_size;
+#endif
 }
 
 std::ostream& operator<<(std::ostream& stream, const ConvolutionDescriptor& c)
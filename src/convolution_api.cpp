@@ -260,6 +260,41 @@ extern "C" miopenStatus_t miopenConvolutionForward(miopenHandle_t handle,
     });
 }
 
+extern "C" miopenStatus_t
+miopenConvolutionForwardPrepareWeights(miopenHandle_t handle,
+                                       const miopenTensorDescriptor_t xDesc,
+                                       const miopenTensorDescriptor_t wDesc,
+                                       const void* w,
+                                       const miopenConvolutionDescriptor_t convDesc,
+                                       const miopenTensorDescriptor_t yDesc,
+                                       miopenConvFwdAlgorithm_t algo,
+                                       uint64_t version,
+                                       void* workSpace,
+                                       size_t workSpaceSize)
+{
+    MIOPEN_LOG_FUNCTION(xDesc, wDesc, w, convDesc, yDesc, algo, version, workSpace, workSpaceSize);
+    return miopen::try_([&] {
+        miopen::deref(convDesc).PrepareForwardWeights(miopen::deref(handle),
+                                                      miopen::deref(xDesc),
+                                                      miopen::deref(wDesc),
+                                                      DataCast(w),
+                                                      miopen::deref(yDesc),
+                                                      algo,
+                                                      version,
+                                                      DataCast(workSpace),
+                                                      workSpaceSize);
+    });
+}
+
+extern "C" miopenStatus_t miopenConvolutionForwardReleaseWeights(miopenHandle_t handle,
+                                                                 const void* w)
+{
+    MIOPEN_LOG_FUNCTION(w);
+    return miopen::try_([&] {
+        miopen::deref(handle).GetFilterTransformCache().Erase(DataCast(w));
+    });
+}
+
 extern "C" miopenStatus_t miopenConvolutionForwardBias(miopenHandle_t handle,
                                                        const void* alpha,
                                                        const miopenTensorDescriptor_t bDesc,
@@ -28,6 +28,9 @@
 #include <miopen/env.hpp>
 #include <miopen/errors.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace miopen {
 
 static size_t GetWorkSpaceSizeFFT(const TensorDescriptor& wDesc,
@@ -107,4 +110,133 @@ size_t ConvolutionDescriptor::BackwardGetWorkSpaceSizeFFT(const TensorDescriptor
     return GetWorkSpaceSizeFFT(wDesc, dxDesc, dyDesc, std::make_tuple(pad_h, pad_w, u, v), false);
 }
 
+static bool IsSmoothLength(int length)
+{
+    for(int factor : {2, 3, 5})
+        while(length % factor == 0)
+            length /= factor;
+    return length == 1;
+}
+
+// From the filter size on, until a length covers the padded image or exceeds 128
+static std::vector<int> GetFFTConvLengths(int filter, int padded)
+{
+    std::vector<int> lengths;
+    for(int length = filter; lengths.empty() || (length <= 128 && lengths.back() < padded);
+        length++)
+    {
+        if(IsSmoothLength(length))
+            lengths.push_back(length);
+    }
+    return lengths;
+}
+
+static double GetFFTFlops(int length_h, int length_w)
+{
+    const double size = double(length_h) * length_w;
+    return size > 1 ? 2.5 * size * std::log2(size) : 0;
+}
+
+bool PlanFFTConv(const FFTConvShape& shape,
+                 std::size_t workspace_limit,
+                 int length_h,
+                 int length_w,
+                 FFTConvPlan& plan)
+{
+    if(shape.n < 1 || shape.c < 1 || shape.h < 1 || shape.w < 1 || shape.k < 1 || shape.r < 1 ||
+       shape.s < 1 || shape.pad_h < 0 || shape.pad_w < 0 || shape.OutH() < 1 ||
+       shape.OutW() < 1)
+        return false;
+    if(length_h < shape.r || length_w < shape.s)
+        return false;
+
+    FFTConvPlan p;
+    p.shape    = shape;
+    p.length_h = length_h;
+    p.length_w = length_w;
+    p.tile_h   = length_h - shape.r + 1;
+    p.tile_w   = length_w - shape.s + 1;
+    p.tiles_h  = (shape.OutH() + p.tile_h - 1) / p.tile_h;
+    p.tiles_w  = (shape.OutW() + p.tile_w - 1) / p.tile_w;
+
+    // Spectra the workspace holds
+    const std::size_t spectrum_size = p.Spectrum() * 2 * sizeof(float);
+    const std::size_t spectra       = workspace_limit / spectrum_size;
+    const std::size_t tiles         = p.Tiles();
+    const std::size_t n             = shape.n;
+    const std::size_t c             = shape.c;
+    const std::size_t k             = shape.k;
+
+    // All channels and as many images as fit, else one image and as many channels as fit
+    if(spectra >= k * c + (c + k) * tiles)
+    {
+        p.image_batch   = static_cast<int>(std::min(n, (spectra - k * c) / ((c + k) * tiles)));
+        p.channel_batch = shape.c;
+    }
+    else if(spectra >= k * tiles + tiles + k)
+    {
+        p.image_batch   = 1;
+        p.channel_batch = static_cast<int>(std::min(c, (spectra - k * tiles) / (tiles + k)));
+    }
+    else
+        return false;
+
+    const std::size_t image_batch   = p.image_batch;
+    const std::size_t channel_batch = p.channel_batch;
+    p.input  = {0, image_batch * channel_batch * tiles * spectrum_size};
+    p.filter = {p.input.size, k * channel_batch * spectrum_size};
+    p.output = {p.filter.offset + p.filter.size, image_batch * k * tiles * spectrum_size};
+
+    const bool all_channels = p.channel_batch == shape.c;
+    if(all_channels)
+        p.steps.push_back({FFTConvKernel::forward_filter, 0, 0, 0, shape.c, false});
+    for(int image = 0; image < shape.n; image += p.image_batch)
+    {
+        const int images = std::min(p.image_batch, shape.n - image);
+        for(int channel = 0; channel < shape.c; channel += p.channel_batch)
+        {
+            const int channels = std::min(p.channel_batch, shape.c - channel);
+            if(!all_channels)
+                p.steps.push_back(
+                    {FFTConvKernel::forward_filter, 0, 0, channel, channels, false});
+            p.steps.push_back(
+                {FFTConvKernel::forward_input, image, images, channel, channels, false});
+            p.steps.push_back(
+                {FFTConvKernel::multiply, image, images, channel, channels, channel != 0});
+        }
+        p.steps.push_back({FFTConvKernel::inverse_output, image, images, 0, 0, false});
+    }
+
+    const double image_batches = (n + image_batch - 1) / image_batch;
+    const double transforms =
+        double(n) * c * tiles + double(k) * c * (all_channels ? 1 : image_batches) +
+        double(n) * k * tiles;
+    p.flops = transforms * GetFFTFlops(length_h, length_w) +
+              8.0 * double(n) * k * c * tiles * p.Spectrum();
+
+    plan = std::move(p);
+    return true;
+}
+
+bool PlanFFTConv(const FFTConvShape& shape, std::size_t workspace_limit, FFTConvPlan& plan)
+{
+    bool found = false;
+    for(int length_h : GetFFTConvLengths(shape.r, shape.h + 2 * shape.pad_h))
+    {
+        for(int length_w : GetFFTConvLengths(shape.s, shape.w + 2 * shape.pad_w))
+        {
+            FFTConvPlan candidate;
+            if(!PlanFFTConv(shape, workspace_limit, length_h, length_w, candidate))
+                continue;
+            if(!found || candidate.flops < plan.flops ||
+               (candidate.flops == plan.flops && candidate.steps.size() < plan.steps.size()))
+            {
+                plan  = std::move(candidate);
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
 } // namespace miopen
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/activ.hpp>
+#include <miopen/cpu_ops.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+// Calls visitor with the element function of the activation mode, so that the
+// mode is resolved once per call rather than once per element.
+template <class R, class V>
+void VisitForward(miopenActivationMode_t mode, R alpha, R beta, R gamma, V visitor)
+{
+    const R eps = std::numeric_limits<R>::epsilon();
+    switch(mode)
+    {
+    case miopenActivationPASTHRU: visitor([](R x) { return x; }); break;
+    case miopenActivationLOGISTIC: visitor([](R x) { return 1 / (1 + std::exp(-x)); }); break;
+    case miopenActivationTANH:
+        visitor([=](R x) { return beta * std::tanh(alpha * x); });
+        break;
+    case miopenActivationRELU: visitor([](R x) { return x > 0 ? x : R{0}; }); break;
+    case miopenActivationSOFTRELU:
+        visitor([](R x) { return x > 0 ? x + std::log1p(std::exp(-x)) : std::log1p(std::exp(x)); });
+        break;
+    case miopenActivationABS: visitor([](R x) { return std::abs(x); }); break;
+    case miopenActivationPOWER:
+        visitor([=](R x) {
+            const R v = alpha + beta * x;
+            return v <= eps ? R{0} : std::pow(v, gamma);
+        });
+        break;
+    case miopenActivationCLIPPEDRELU:
+        visitor([=](R x) { return std::min(alpha, std::max(R{0}, x)); });
+        break;
+    case miopenActivationLEAKYRELU: visitor([=](R x) { return x > 0 ? x : x * alpha; }); break;
+    case miopenActivationELU:
+        visitor([=](R x) { return x > 0 ? x : alpha * std::expm1(x); });
+        break;
+    default: MIOPEN_THROW(miopenStatusBadParm, "Unknown activation mode");
+    }
+}
+
+// Same as VisitForward for the derivative f(dy, x, y). The power derivative
+// ignores dy, as the device kernel does.
+template <class R, class V>
+void VisitBackward(miopenActivationMode_t mode, R alpha, R beta, R gamma, V visitor)
+{
+    const R eps = std::numeric_limits<R>::epsilon();
+    switch(mode)
+    {
+    case miopenActivationPASTHRU: visitor([](R dy, R, R) { return dy; }); break;
+    case miopenActivationLOGISTIC: visitor([](R dy, R, R y) { return dy * y * (1 - y); }); break;
+    case miopenActivationTANH:
+        visitor([=](R dy, R, R y) { return dy * alpha * (beta - y * y / beta); });
+        break;
+    case miopenActivationRELU: visitor([](R dy, R x, R) { return x > 0 ? dy : R{0}; }); break;
+    case miopenActivationSOFTRELU:
+        visitor([](R dy, R x, R) {
+            const R e = std::exp(std::min(x, R{50}));
+            return dy * e / (e + 1);
+        });
+        break;
+    case miopenActivationABS: visitor([](R dy, R x, R) { return x > 0 ? dy : -dy; }); break;
+    case miopenActivationPOWER:
+        visitor([=](R, R x, R y) {
+            const R v = alpha + beta * x;
+            return v <= eps ? R{0} : gamma * beta * y / v;
+        });
+        break;
+    case miopenActivationCLIPPEDRELU:
+        visitor([=](R dy, R x, R) { return x > 0 && x <= alpha ? dy : R{0}; });
+        break;
+    case miopenActivationLEAKYRELU:
+        visitor([=](R dy, R x, R) { return x > 0 ? dy : dy * alpha; });
+        break;
+    case miopenActivationELU:
+        visitor([=](R dy, R x, R y) { return x > 0 ? dy : dy * (y + alpha); });
+        break;
+    default: MIOPEN_THROW(miopenStatusBadParm, "Unknown activation mode");
+    }
+}
+
+} // namespace
+
+void ActivationForward(Handle& handle,
+                       const ActivationDescriptor& desc,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       const TensorDescriptor& yDesc,
+                       Data_t y,
+                       std::size_t xOffset,
+                       std::size_t yOffset)
+{
+    if(xDesc.GetLengths() != yDesc.GetLengths())
+        MIOPEN_THROW(miopenStatusBadParm, "Activation tensors must have the same lengths");
+
+    Run(handle, [&] {
+        visit_float(xDesc.GetType(), [&](auto as_float) {
+            using T     = typename decltype(as_float)::type;
+            const T* xp = as_float(x) + xOffset;
+            T* yp       = as_float(y) + yOffset;
+            VisitForward(desc.GetMode(),
+                         static_cast<float>(desc.GetAlpha()),
+                         static_cast<float>(desc.GetBeta()),
+                         static_cast<float>(desc.GetGamma()),
+                         [&](auto f) {
+                             ParallelForEach<2>(
+                                 xDesc.GetLengths(),
+                                 {{xDesc.GetStrides(), yDesc.GetStrides()}},
+                                 [&](const std::array<std::size_t, 2>& o) {
+                                     yp[o[1]] = static_cast<T>(f(static_cast<float>(xp[o[0]])));
+                                 });
+                         });
+        });
+    });
+}
+
+void ActivationBackward(Handle& handle,
+                        const ActivationDescriptor& desc,
+                        const TensorDescriptor& yDesc,
+                        ConstData_t y,
+                        const TensorDescriptor& dyDesc,
+                        ConstData_t dy,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& dxDesc,
+                        Data_t dx,
+                        std::size_t yOffset,
+                        std::size_t dyOffset,
+                        std::size_t xOffset,
+                        std::size_t dxOffset)
+{
+    if(xDesc.GetLengths() != yDesc.GetLengths() || dyDesc.GetLengths() != yDesc.GetLengths() ||
+       dxDesc.GetLengths() != xDesc.GetLengths())
+        MIOPEN_THROW(miopenStatusBadParm, "Activation tensors must have the same lengths");
+
+    Run(handle, [&] {
+        visit_float(xDesc.GetType(), [&](auto as_float) {
+            using T      = typename decltype(as_float)::type;
+            const T* yp  = as_float(y) + yOffset;
+            const T* dyp = as_float(dy) + dyOffset;
+            const T* xp  = as_float(x) + xOffset;
+            T* dxp       = as_float(dx) + dxOffset;
+            VisitBackward(
+                desc.GetMode(),
+                static_cast<float>(desc.GetAlpha()),
+                static_cast<float>(desc.GetBeta()),
+                static_cast<float>(desc.GetGamma()),
+                [&](auto f) {
+                    ParallelForEach<4>(
+                        xDesc.GetLengths(),
+                        {{yDesc.GetStrides(),
+                          dyDesc.GetStrides(),
+                          xDesc.GetStrides(),
+                          dxDesc.GetStrides()}},
+                        [&](const std::array<std::size_t, 4>& o) {
+                            dxp[o[3]] = static_cast<T>(f(static_cast<float>(dyp[o[1]]),
+                                                         static_cast<float>(xp[o[2]]),
+                                                         static_cast<float>(yp[o[0]])));
+                        });
+                });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,379 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+// Packed NC* layout: spatial mode keeps one statistic per channel over the
+// batch and all inner elements, per-activation mode one per (channel, inner
+// element) over the batch.
+struct bn_layout
+{
+    std::size_t n     = 0;
+    std::size_t c     = 0;
+    std::size_t inner = 1;
+    bool spatial      = true;
+
+    bn_layout(const TensorDescriptor& xDesc, miopenBatchNormMode_t mode)
+    {
+        const auto& lens = xDesc.GetLengths();
+        n                = lens[0];
+        c                = lens[1];
+        for(std::size_t d = 2; d < lens.size(); d++)
+            inner *= lens[d];
+        spatial = mode == miopenBNSpatial;
+    }
+
+    std::size_t stats() const { return spatial ? 1 : inner; }
+    std::size_t offset(std::size_t b, std::size_t ch) const { return (b * c + ch) * inner; }
+    double count() const { return static_cast<double>(spatial ? n * inner : n); }
+};
+
+// Mean and biased variance of channel ch, two passes in double precision.
+template <class T>
+void ChannelStats(const bn_layout& l,
+                  const T* x,
+                  std::size_t ch,
+                  std::vector<double>& mean,
+                  std::vector<double>& variance)
+{
+    mean.assign(l.stats(), 0.0);
+    variance.assign(l.stats(), 0.0);
+    for(std::size_t b = 0; b < l.n; b++)
+    {
+        const T* xr = x + l.offset(b, ch);
+        for(std::size_t i = 0; i < l.inner; i++)
+            mean[l.spatial ? 0 : i] += static_cast<double>(xr[i]);
+    }
+    for(auto& m : mean)
+        m /= l.count();
+    for(std::size_t b = 0; b < l.n; b++)
+    {
+        const T* xr = x + l.offset(b, ch);
+        for(std::size_t i = 0; i < l.inner; i++)
+        {
+            const std::size_t s = l.spatial ? 0 : i;
+            const double d      = static_cast<double>(xr[i]) - mean[s];
+            variance[s] += d * d;
+        }
+    }
+    for(auto& v : variance)
+        v /= l.count();
+}
+
+// y = scale * (x - mean) * inv_std + bias for channel ch.
+template <class T, class P>
+void Normalize(const bn_layout& l,
+               const T* x,
+               T* y,
+               const P* scale,
+               const P* bias,
+               std::size_t ch,
+               const std::vector<double>& mean,
+               const std::vector<double>& inv_std)
+{
+    for(std::size_t b = 0; b < l.n; b++)
+    {
+        const T* xr = x + l.offset(b, ch);
+        T* yr       = y + l.offset(b, ch);
+        for(std::size_t i = 0; i < l.inner; i++)
+        {
+            const std::size_t s = l.spatial ? 0 : i;
+            const std::size_t j = ch * l.stats() + s;
+            yr[i]               = static_cast<T>(static_cast<double>(scale[j]) *
+                                       (static_cast<double>(xr[i]) - mean[s]) * inv_std[s] +
+                                   static_cast<double>(bias[j]));
+        }
+    }
+}
+
+// Visits the data type of x and the type of the scale, bias and statistics.
+template <class F>
+void VisitTypes(const TensorDescriptor& xDesc, const TensorDescriptor& paramDesc, F f)
+{
+    visit_float(xDesc.GetType(), [&](auto as_data) {
+        visit_float(paramDesc.GetType(), [&](auto as_param) { f(as_data, as_param); });
+    });
+}
+
+} // namespace
+
+void BatchNormForwardTraining(Handle& handle,
+                              miopenBatchNormMode_t bn_mode,
+                              const TensorDescriptor& xDesc,
+                              ConstData_t x,
+                              const TensorDescriptor& /*yDesc*/,
+                              Data_t y,
+                              const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                              ConstData_t bnScale,
+                              ConstData_t bnBias,
+                              double expAvgFactor,
+                              Data_t resultRunningMean,
+                              Data_t resultRunningVariance,
+                              double epsilon,
+                              Data_t resultSaveMean,
+                              Data_t resultSaveInvVariance)
+{
+    const bn_layout l{xDesc, bn_mode};
+    Run(handle, [&] {
+        VisitTypes(xDesc, bnScaleBiasMeanVarDesc, [&](auto as_data, auto as_param) {
+            using P = typename decltype(as_param)::type;
+            ParallelFor(l.c, 1, [&](std::size_t ch) {
+                std::vector<double> mean;
+                std::vector<double> variance;
+                ChannelStats(l, as_data(x), ch, mean, variance);
+                std::vector<double> inv_std(variance.size());
+                for(std::size_t s = 0; s < variance.size(); s++)
+                    inv_std[s] = 1.0 / std::sqrt(variance[s] + epsilon);
+                Normalize(l,
+                          as_data(x),
+                          as_data(y),
+                          as_param(bnScale),
+                          as_param(bnBias),
+                          ch,
+                          mean,
+                          inv_std);
+
+                const double count    = l.count();
+                const double unbiased = count > 1 ? count / (count - 1) : 1.0;
+                for(std::size_t s = 0; s < l.stats(); s++)
+                {
+                    const std::size_t j = ch * l.stats() + s;
+                    if(resultRunningMean != nullptr && resultRunningVariance != nullptr)
+                    {
+                        P* rm = as_param(resultRunningMean);
+                        P* rv = as_param(resultRunningVariance);
+                        rm[j] = static_cast<P>((1 - expAvgFactor) * static_cast<double>(rm[j]) +
+                                               expAvgFactor * mean[s]);
+                        rv[j] = static_cast<P>((1 - expAvgFactor) * static_cast<double>(rv[j]) +
+                                               expAvgFactor * variance[s] * unbiased);
+                    }
+                    if(resultSaveMean != nullptr && resultSaveInvVariance != nullptr)
+                    {
+                        as_param(resultSaveMean)[j]        = static_cast<P>(mean[s]);
+                        as_param(resultSaveInvVariance)[j] = static_cast<P>(inv_std[s]);
+                    }
+                }
+            });
+        });
+    });
+}
+
+// Without estimates the statistics of the batch are used, as on the device.
+void BatchNormForwardInference(Handle& handle,
+                               miopenBatchNormMode_t bn_mode,
+                               const TensorDescriptor& xDesc,
+                               ConstData_t x,
+                               const TensorDescriptor& /*yDesc*/,
+                               Data_t y,
+                               const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                               ConstData_t bnScale,
+                               ConstData_t bnBias,
+                               ConstData_t estimatedMean,
+                               ConstData_t estimatedVariance,
+                               double epsilon)
+{
+    const bn_layout l{xDesc, bn_mode};
+    const bool estimated = estimatedMean != nullptr && estimatedVariance != nullptr;
+    Run(handle, [&] {
+        VisitTypes(xDesc, bnScaleBiasMeanVarDesc, [&](auto as_data, auto as_param) {
+            ParallelFor(l.c, 1, [&](std::size_t ch) {
+                std::vector<double> mean(l.stats());
+                std::vector<double> variance(l.stats());
+                if(estimated)
+                {
+                    const std::size_t first = ch * l.stats();
+                    for(std::size_t s = 0; s < l.stats(); s++)
+                    {
+                        mean[s]     = static_cast<double>(as_param(estimatedMean)[first + s]);
+                        variance[s] = static_cast<double>(as_param(estimatedVariance)[first + s]);
+                    }
+                }
+                else
+                {
+                    ChannelStats(l, as_data(x), ch, mean, variance);
+                }
+                for(auto& v : variance)
+                    v = 1.0 / std::sqrt(v + epsilon);
+                Normalize(l,
+                          as_data(x),
+                          as_data(y),
+                          as_param(bnScale),
+                          as_param(bnBias),
+                          ch,
+                          mean,
+                          variance);
+            });
+        });
+    });
+}
+
+void BatchNormForwardSaved(Handle& handle,
+                           miopenBatchNormMode_t bn_mode,
+                           const TensorDescriptor& xDesc,
+                           ConstData_t x,
+                           Data_t y,
+                           const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                           ConstData_t bnScale,
+                           ConstData_t bnBias,
+                           ConstData_t savedMean,
+                           ConstData_t savedInvVariance)
+{
+    const bn_layout l{xDesc, bn_mode};
+    Run(handle, [&] {
+        VisitTypes(xDesc, bnScaleBiasMeanVarDesc, [&](auto as_data, auto as_param) {
+            ParallelFor(l.c, 1, [&](std::size_t ch) {
+                std::vector<double> mean(l.stats());
+                std::vector<double> inv_std(l.stats());
+                const std::size_t first = ch * l.stats();
+                for(std::size_t s = 0; s < l.stats(); s++)
+                {
+                    mean[s]    = static_cast<double>(as_param(savedMean)[first + s]);
+                    inv_std[s] = static_cast<double>(as_param(savedInvVariance)[first + s]);
+                }
+                Normalize(l,
+                          as_data(x),
+                          as_data(y),
+                          as_param(bnScale),
+                          as_param(bnBias),
+                          ch,
+                          mean,
+                          inv_std);
+            });
+        });
+    });
+}
+
+// Without saved statistics they are recomputed from x and epsilon.
+void BatchNormBackward(Handle& handle,
+                       miopenBatchNormMode_t bn_mode,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       const TensorDescriptor& /*dyDesc*/,
+                       ConstData_t dy,
+                       const TensorDescriptor& /*dxDesc*/,
+                       Data_t dx,
+                       const TensorDescriptor& bnScaleBiasDiffDesc,
+                       ConstData_t bnScale,
+                       Data_t resultBnScaleDiff,
+                       Data_t resultBnBiasDiff,
+                       double epsilon,
+                       ConstData_t savedMean,
+                       ConstData_t savedInvVariance)
+{
+    const bn_layout l{xDesc, bn_mode};
+    const bool saved = savedMean != nullptr && savedInvVariance != nullptr;
+    Run(handle, [&] {
+        VisitTypes(xDesc, bnScaleBiasDiffDesc, [&](auto as_data, auto as_param) {
+            using T = typename decltype(as_data)::type;
+            using P = typename decltype(as_param)::type;
+            const T* xp  = as_data(x);
+            const T* dyp = as_data(dy);
+            T* dxp       = as_data(dx);
+            const P* sp  = as_param(bnScale);
+            ParallelFor(l.c, 1, [&](std::size_t ch) {
+                const std::size_t stats = l.stats();
+                std::vector<double> mean(stats);
+                std::vector<double> inv_std(stats);
+                if(saved)
+                {
+                    const std::size_t first = ch * stats;
+                    for(std::size_t s = 0; s < stats; s++)
+                    {
+                        mean[s]    = static_cast<double>(as_param(savedMean)[first + s]);
+                        inv_std[s] = static_cast<double>(as_param(savedInvVariance)[first + s]);
+                    }
+                }
+                else
+                {
+                    ChannelStats(l, xp, ch, mean, inv_std);
+                    for(auto& v : inv_std)
+                        v = 1.0 / std::sqrt(v + epsilon);
+                }
+
+                std::vector<double> sum_dy(stats, 0.0);
+                std::vector<double> sum_dy_xhat(stats, 0.0);
+                for(std::size_t b = 0; b < l.n; b++)
+                {
+                    const T* xr  = xp + l.offset(b, ch);
+                    const T* dyr = dyp + l.offset(b, ch);
+                    for(std::size_t i = 0; i < l.inner; i++)
+                    {
+                        const std::size_t s = l.spatial ? 0 : i;
+                        const double g      = static_cast<double>(dyr[i]);
+                        sum_dy[s] += g;
+                        sum_dy_xhat[s] += (static_cast<double>(xr[i]) - mean[s]) * inv_std[s] * g;
+                    }
+                }
+                for(std::size_t s = 0; s < stats; s++)
+                {
+                    as_param(resultBnBiasDiff)[ch * stats + s]  = static_cast<P>(sum_dy[s]);
+                    as_param(resultBnScaleDiff)[ch * stats + s] = static_cast<P>(sum_dy_xhat[s]);
+                }
+
+                const double count = l.count();
+                for(std::size_t b = 0; b < l.n; b++)
+                {
+                    const T* xr  = xp + l.offset(b, ch);
+                    const T* dyr = dyp + l.offset(b, ch);
+                    T* dxr       = dxp + l.offset(b, ch);
+                    for(std::size_t i = 0; i < l.inner; i++)
+                    {
+                        const std::size_t s = l.spatial ? 0 : i;
+                        const double gamma  = static_cast<double>(sp[ch * stats + s]);
+                        const double xhat   = (static_cast<double>(xr[i]) - mean[s]) * inv_std[s];
+                        double r            = 0;
+                        if(l.spatial)
+                        {
+                            r = gamma * inv_std[s] / count *
+                                (count * static_cast<double>(dyr[i]) - sum_dy[s] -
+                                 xhat * sum_dy_xhat[s]);
+                        }
+                        else
+                        {
+                            // Per-activation mode follows the device kernel, which
+                            // scales the gradient sums rather than dy itself.
+                            const double dxhat    = gamma * sum_dy[s];
+                            const double dxhathat = gamma * sum_dy_xhat[s];
+                            r = inv_std[s] / count * (count * dxhat - (xhat * dxhathat + dxhat));
+                        }
+                        dxr[i] = static_cast<T>(r);
+                    }
+                }
+            });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,277 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/conv_host.hpp>
+#include <miopen/convolution.hpp>
+#include <miopen/cpu_ops.hpp>
+#include <miopen/problem_description.hpp>
+#include <miopen/visit_float.hpp>
+#include <miopen/winograd_filter.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+struct conv_layout
+{
+    std::size_t ns, cs, hs, ws;
+
+    explicit conv_layout(const TensorDescriptor& desc)
+    {
+        std::tie(ns, cs, hs, ws) = tien<4>(desc.GetStrides());
+    }
+
+    std::size_t operator()(std::size_t b, std::size_t k) const { return b * ns + k * cs; }
+};
+
+// The direct convolutions run the host reference of conv_host.hpp, which
+// accumulates in double whatever the data type. x, w and y are the tensors in
+// the orientation of the API, so a transposed convolution passes its own
+// descriptors and the reference swaps the roles.
+conv_host_problem HostProblem(const ConvolutionDescriptor& conv,
+                              const TensorDescriptor& xDesc,
+                              const TensorDescriptor& wDesc,
+                              const TensorDescriptor& yDesc)
+{
+    const int groups =
+        conv.mode == miopenGroupConv || conv.mode == miopenDepthwise ? conv.group_count : 1;
+    return make_conv_host_problem(xDesc.GetLengths(),
+                                  wDesc.GetLengths(),
+                                  yDesc.GetLengths(),
+                                  conv.pad_h,
+                                  conv.pad_w,
+                                  conv.u,
+                                  conv.v,
+                                  conv.dilation_h,
+                                  conv.dilation_w,
+                                  groups,
+                                  conv.mode == miopenTranspose);
+}
+
+template <class T>
+std::vector<double> Pack(const TensorDescriptor& desc, const T* data)
+{
+    return conv_host_pack(data, desc.GetLengths(), desc.GetStrides());
+}
+
+template <class T>
+void Unpack(const std::vector<double>& src, const TensorDescriptor& desc, T* data)
+{
+    conv_host_unpack(src, data, desc.GetLengths(), desc.GetStrides());
+}
+
+} // namespace
+
+bool IsWinogradApplicable(const ConvolutionDescriptor& conv,
+                          const TensorDescriptor& xDesc,
+                          const TensorDescriptor& wDesc,
+                          const TensorDescriptor& yDesc)
+{
+    return conv.mode == miopenConvolution && conv.u == 1 && conv.v == 1 &&
+           conv.dilation_h == 1 && conv.dilation_w == 1 && xDesc.GetType() == miopenFloat &&
+           wDesc.GetType() == miopenFloat && yDesc.GetType() == miopenFloat &&
+           wDesc.GetLengths()[2] == 3 && wDesc.GetLengths()[3] == 3 && xDesc.IsPacked() &&
+           wDesc.IsPacked() && yDesc.IsPacked();
+}
+
+std::size_t GetWinogradFilterSize(const TensorDescriptor& wDesc, const TensorDescriptor& yDesc)
+{
+    std::size_t k, c, out_h, out_w;
+    std::tie(k, c, std::ignore, std::ignore)         = tien<4>(wDesc.GetLengths());
+    std::tie(std::ignore, std::ignore, out_h, out_w) = tien<4>(yDesc.GetLengths());
+    return miopen::GetWinogradFilterSize(GetWinogradTile(out_h, out_w), k, c) * sizeof(float);
+}
+
+void TransformWinogradFilters(Handle& handle,
+                              const TensorDescriptor& wDesc,
+                              ConstData_t w,
+                              const TensorDescriptor& yDesc,
+                              Data_t u)
+{
+    std::size_t k, c, out_h, out_w;
+    std::tie(k, c, std::ignore, std::ignore)         = tien<4>(wDesc.GetLengths());
+    std::tie(std::ignore, std::ignore, out_h, out_w) = tien<4>(yDesc.GetLengths());
+    Run(handle, [&] {
+        WinogradFilterTransform(GetWinogradTile(out_h, out_w),
+                                k,
+                                c,
+                                static_cast<const float*>(w),
+                                static_cast<float*>(u));
+    });
+}
+
+// Images run in parallel, from the filters transformed ahead for w if the cache has them
+static void ConvolutionForwardWinograd(Handle& handle,
+                                       const ConvolutionDescriptor& conv,
+                                       const TensorDescriptor& xDesc,
+                                       ConstData_t x,
+                                       const TensorDescriptor& wDesc,
+                                       ConstData_t w,
+                                       const TensorDescriptor& yDesc,
+                                       Data_t y)
+{
+    std::size_t n, c, h, wi, k, out_h, out_w;
+    std::tie(n, c, h, wi)                  = tien<4>(xDesc.GetLengths());
+    std::tie(std::ignore, k, out_h, out_w) = tien<4>(yDesc.GetLengths());
+    const int tile                         = GetWinogradTile(out_h, out_w);
+
+    const auto& cache                        = handle.GetFilterTransformCache();
+    const FilterTransformCache::Entry* entry = nullptr;
+    if(!cache.Empty())
+        entry = cache.Find(w,
+                           miopenConvolutionFwdAlgoWinograd,
+                           ProblemDescription(xDesc, wDesc, yDesc, conv, 1));
+
+    Run(handle, [&] {
+        std::vector<float> transformed;
+        const float* u = nullptr;
+        if(entry != nullptr)
+            u = static_cast<const float*>(entry->data.get());
+        else
+        {
+            transformed.resize(miopen::GetWinogradFilterSize(tile, k, c));
+            WinogradFilterTransform(tile, k, c, static_cast<const float*>(w), transformed.data());
+            u = transformed.data();
+        }
+        ParallelFor(n, 1, [&](std::size_t b) {
+            WinogradForward(tile,
+                            c,
+                            h,
+                            wi,
+                            k,
+                            conv.pad_h,
+                            conv.pad_w,
+                            static_cast<const float*>(x) + b * c * h * wi,
+                            u,
+                            static_cast<float*>(y) + b * k * out_h * out_w);
+        });
+    });
+}
+
+void ConvolutionForward(Handle& handle,
+                        const ConvolutionDescriptor& conv,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& wDesc,
+                        ConstData_t w,
+                        const TensorDescriptor& yDesc,
+                        Data_t y,
+                        miopenConvFwdAlgorithm_t algo)
+{
+    if(algo == miopenConvolutionFwdAlgoWinograd && IsWinogradApplicable(conv, xDesc, wDesc, yDesc))
+    {
+        ConvolutionForwardWinograd(handle, conv, xDesc, x, wDesc, w, yDesc, y);
+        return;
+    }
+
+    const auto problem    = HostProblem(conv, xDesc, wDesc, yDesc);
+    const bool transposed = conv.mode == miopenTranspose;
+    Run(handle, [&] {
+        visit_float(xDesc.GetType(), [&](auto as_float) {
+            Unpack(conv_host_forward(
+                       problem, transposed, Pack(xDesc, as_float(x)), Pack(wDesc, as_float(w))),
+                   yDesc,
+                   as_float(y));
+        });
+    });
+}
+
+void ConvolutionBackwardData(Handle& handle,
+                             const ConvolutionDescriptor& conv,
+                             const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& wDesc,
+                             ConstData_t w,
+                             const TensorDescriptor& dxDesc,
+                             Data_t dx)
+{
+    const auto problem    = HostProblem(conv, dxDesc, wDesc, dyDesc);
+    const bool transposed = conv.mode == miopenTranspose;
+    Run(handle, [&] {
+        visit_float(dyDesc.GetType(), [&](auto as_float) {
+            Unpack(conv_host_backward_data(
+                       problem, transposed, Pack(dyDesc, as_float(dy)), Pack(wDesc, as_float(w))),
+                   dxDesc,
+                   as_float(dx));
+        });
+    });
+}
+
+void ConvolutionBackwardWeights(Handle& handle,
+                                const ConvolutionDescriptor& conv,
+                                const TensorDescriptor& dyDesc,
+                                ConstData_t dy,
+                                const TensorDescriptor& xDesc,
+                                ConstData_t x,
+                                const TensorDescriptor& dwDesc,
+                                Data_t dw)
+{
+    const auto problem    = HostProblem(conv, xDesc, dwDesc, dyDesc);
+    const bool transposed = conv.mode == miopenTranspose;
+    Run(handle, [&] {
+        visit_float(dyDesc.GetType(), [&](auto as_float) {
+            Unpack(conv_host_backward_weights(
+                       problem, transposed, Pack(xDesc, as_float(x)), Pack(dyDesc, as_float(dy))),
+                   dwDesc,
+                   as_float(dw));
+        });
+    });
+}
+
+void ConvolutionBackwardBias(Handle& handle,
+                             const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& dbDesc,
+                             Data_t db)
+{
+    std::size_t n, k, h, w;
+    std::tie(n, k, h, w) = tien<4>(dyDesc.GetLengths());
+    const conv_layout dyl{dyDesc};
+    const std::size_t db_stride = dbDesc.GetStrides()[1];
+
+    Run(handle, [&] {
+        visit_float(dyDesc.GetType(), [&](auto as_float) {
+            using T = typename decltype(as_float)::type;
+            ParallelFor(k, 1, [&](std::size_t ko) {
+                double sum = 0;
+                for(std::size_t b = 0; b < n; b++)
+                {
+                    const T* p = as_float(dy) + dyl(b, ko);
+                    for(std::size_t i = 0; i < h; i++)
+                        for(std::size_t j = 0; j < w; j++)
+                            sum += static_cast<double>(p[i * dyl.hs + j * dyl.ws]);
+                }
+                as_float(db)[ko * db_stride] = static_cast<T>(sum);
+            });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,278 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/activ.hpp>
+#include <miopen/batch_norm.hpp>
+#include <miopen/cpu_ops.hpp>
+#include <miopen/fusion.hpp>
+
+#include <cstring>
+#include <half.hpp>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+const OpKernelArg&
+GetArg(const OperatorArgs& args, const FusionOpDescriptor& op, const std::string& k)
+{
+    const auto key = op.GetArgKey(k);
+    auto it        = args.args_map.find(key);
+    if(it == args.args_map.end())
+        MIOPEN_THROW(miopenStatusInternalError, "Argument Not Set: " + key);
+    return it->second;
+}
+
+Data_t GetPointer(const OperatorArgs& args, const FusionOpDescriptor& op, const std::string& k)
+{
+    Data_t p = nullptr;
+    std::memcpy(&p, GetArg(args, op, k).buffer.data(), sizeof(p));
+    return p;
+}
+
+// Scalars are stored the way the kernels take them: double, float or half.
+double GetScalar(const OperatorArgs& args, const FusionOpDescriptor& op, const std::string& k)
+{
+    const auto& buffer = GetArg(args, op, k).buffer;
+    switch(buffer.size())
+    {
+    case sizeof(double):
+    {
+        double v;
+        std::memcpy(&v, buffer.data(), sizeof(v));
+        return v;
+    }
+    case sizeof(float):
+    {
+        float v;
+        std::memcpy(&v, buffer.data(), sizeof(v));
+        return v;
+    }
+    case sizeof(half_float::half):
+    {
+        half_float::half v;
+        std::memcpy(&v, buffer.data(), sizeof(v));
+        return v;
+    }
+    default: MIOPEN_THROW(miopenStatusInternalError, "Unexpected size of argument " + k);
+    }
+}
+
+template <class Op>
+ActivationDescriptor GetActivation(const OperatorArgs& args, const Op& op)
+{
+    return {op.activMode,
+            GetScalar(args, op, "activAlpha"),
+            GetScalar(args, op, "activBeta"),
+            GetScalar(args, op, "activGamma")};
+}
+
+// The only backward plan is batch norm followed by an activation. The activation
+// gradient comes first, taken at the batch norm output recomputed from x and the
+// saved statistics, and output then carries it through the batch norm gradient.
+void ExecuteBackward(Handle& handle,
+                     const std::vector<std::shared_ptr<FusionOpDescriptor>>& ops,
+                     const TensorDescriptor& inputDesc,
+                     ConstData_t input,
+                     const TensorDescriptor& outputDesc,
+                     Data_t output,
+                     const OperatorArgs& args)
+{
+    if(ops.size() != 2 || ops[0]->kind() != miopenFusionOpBatchNormBwdTrain ||
+       ops[1]->kind() != miopenFusionOpActivBackward)
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "The CPU backend runs no backward fusion plan but batch norm + activation");
+
+    const auto& bn    = dynamic_cast<const BatchNormBwdTrainFusionOpDescriptor&>(*ops[0]);
+    const auto& activ = dynamic_cast<const ActivBwdFusionOpDescriptor&>(*ops[1]);
+    TensorDescriptor bnDesc;
+    DeriveBNTensorDescriptor(bnDesc, inputDesc, bn.mode);
+
+    const ConstData_t x                = GetPointer(args, bn, "x");
+    const ConstData_t bnScale          = GetPointer(args, bn, "bnScale");
+    const ConstData_t savedMean        = GetPointer(args, bn, "savedMean");
+    const ConstData_t savedInvVariance = GetPointer(args, bn, "savedInvVariance");
+    if(savedMean == nullptr || savedInvVariance == nullptr)
+        MIOPEN_THROW(miopenStatusBadParm, "The fused batch norm gradient needs saved statistics");
+
+    auto bn_y = handle.Create(inputDesc.GetElementSpace() * GetTypeSize(inputDesc.GetType()));
+    BatchNormForwardSaved(handle,
+                          bn.mode,
+                          inputDesc,
+                          x,
+                          bn_y.get(),
+                          bnDesc,
+                          bnScale,
+                          GetPointer(args, bn, "bnBias"),
+                          savedMean,
+                          savedInvVariance);
+    ActivationBackward(handle,
+                       GetActivation(args, activ),
+                       inputDesc,
+                       GetPointer(args, activ, "y"),
+                       inputDesc,
+                       input,
+                       inputDesc,
+                       bn_y.get(),
+                       outputDesc,
+                       output,
+                       0,
+                       0,
+                       0,
+                       0);
+    BatchNormBackward(handle,
+                      bn.mode,
+                      inputDesc,
+                      x,
+                      outputDesc,
+                      output,
+                      outputDesc,
+                      output,
+                      bnDesc,
+                      bnScale,
+                      GetPointer(args, bn, "resBnScaleDiff"),
+                      GetPointer(args, bn, "resBnBiasDiff"),
+                      0,
+                      savedMean,
+                      savedInvVariance);
+}
+
+} // namespace
+
+// Every op but the convolution, which only heads a plan, keeps the lengths of its
+// input, so each op after the first runs in place on output.
+void ExecuteFusionPlan(Handle& handle,
+                       const std::vector<std::shared_ptr<FusionOpDescriptor>>& ops,
+                       const TensorDescriptor& inputDesc,
+                       ConstData_t input,
+                       const TensorDescriptor& outputDesc,
+                       Data_t output,
+                       const OperatorArgs& args)
+{
+    if(ops.back()->kind() == miopenFusionOpActivBackward ||
+       ops.back()->kind() == miopenFusionOpBatchNormBwdTrain)
+    {
+        ExecuteBackward(handle, ops, inputDesc, input, outputDesc, output, args);
+        return;
+    }
+
+    ConstData_t x = input;
+    for(const auto& op : ops)
+    {
+        const auto& xDesc = op->input_desc;
+        switch(op->kind())
+        {
+        case miopenFusionOpConvForward:
+        {
+            const auto& conv = dynamic_cast<const ConvForwardOpDescriptor&>(*op);
+            ConvolutionForward(handle,
+                               conv.base_desc,
+                               xDesc,
+                               x,
+                               conv.filter_desc,
+                               GetPointer(args, conv, "weights"),
+                               outputDesc,
+                               output,
+                               miopenConvolutionFwdAlgoDirect);
+            break;
+        }
+        case miopenFusionOpBiasForward:
+        {
+            const auto& bias  = dynamic_cast<const BiasFusionOpDescriptor&>(*op);
+            const float alpha = 1;
+            const float beta  = 0;
+            OpTensor(handle,
+                     miopenTensorOpAdd,
+                     &alpha,
+                     xDesc,
+                     x,
+                     &alpha,
+                     bias.base_desc,
+                     GetPointer(args, bias, "bias"),
+                     &beta,
+                     outputDesc,
+                     output,
+                     0,
+                     0,
+                     0);
+            break;
+        }
+        case miopenFusionOpBatchNormInference:
+        {
+            const auto& bn = dynamic_cast<const BatchNormInferenceFusionOpDescriptor&>(*op);
+            BatchNormForwardInference(handle,
+                                      bn.mode,
+                                      xDesc,
+                                      x,
+                                      outputDesc,
+                                      output,
+                                      bn.base_desc,
+                                      GetPointer(args, bn, "bnScale"),
+                                      GetPointer(args, bn, "bnBias"),
+                                      GetPointer(args, bn, "estimatedMean"),
+                                      GetPointer(args, bn, "estimatedVariance"),
+                                      GetScalar(args, bn, "epsilon"));
+            break;
+        }
+        case miopenFusionOpBatchNormFwdTrain:
+        {
+            const auto& bn = dynamic_cast<const BatchNormFwdTrainFusionOpDescriptor&>(*op);
+            TensorDescriptor bnDesc;
+            DeriveBNTensorDescriptor(bnDesc, xDesc, bn.mode);
+            BatchNormForwardTraining(handle,
+                                     bn.mode,
+                                     xDesc,
+                                     x,
+                                     outputDesc,
+                                     output,
+                                     bnDesc,
+                                     GetPointer(args, bn, "bnScale"),
+                                     GetPointer(args, bn, "bnBias"),
+                                     GetScalar(args, bn, "expAvgFactor"),
+                                     GetPointer(args, bn, "runningMean"),
+                                     GetPointer(args, bn, "runningVariance"),
+                                     GetScalar(args, bn, "epsilon"),
+                                     GetPointer(args, bn, "savedMean"),
+                                     GetPointer(args, bn, "savedInvVariance"));
+            break;
+        }
+        case miopenFusionOpActivForward:
+        {
+            const auto& activ = dynamic_cast<const ActivFwdFusionOpDescriptor&>(*op);
+            ActivationForward(
+                handle, GetActivation(args, activ), xDesc, x, outputDesc, output, 0, 0);
+            break;
+        }
+        default:
+            MIOPEN_THROW(miopenStatusNotImplemented,
+                         "The CPU backend cannot run this op in a forward fusion plan");
+        }
+        x = output;
+    }
+}
+
+} // namespace cpu
+} // namespace miopen
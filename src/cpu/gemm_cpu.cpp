@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
+#include <miopen/gemm_host.hpp>
+#include <miopen/gemm_v2.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <utility>
+
+namespace miopen {
+namespace cpu {
+
+// A column-major GEMM is run as the row-major GEMM of the transposed result,
+// C^T = op(B)^T * op(A)^T, the same swap CallGemm makes for the device.
+void Gemm(Handle& handle,
+          const GemmDescriptor& gemm_desc,
+          ConstData_t A,
+          std::size_t a_offset,
+          ConstData_t B,
+          std::size_t b_offset,
+          Data_t C,
+          std::size_t c_offset)
+{
+    GemmDescriptor g = gemm_desc;
+    if(g.isColMajor)
+    {
+        std::swap(A, B);
+        std::swap(a_offset, b_offset);
+        std::swap(g.transA, g.transB);
+        std::swap(g.m, g.n);
+        std::swap(g.lda, g.ldb);
+    }
+
+    Run(handle, [&] {
+        visit_float(g.dataType, [&](auto as_float) {
+            host_gemm(g.transA,
+                      g.transB,
+                      g.m,
+                      g.n,
+                      g.k,
+                      g.alpha,
+                      as_float(A) + a_offset,
+                      g.lda,
+                      as_float(B) + b_offset,
+                      g.ldb,
+                      g.beta,
+                      as_float(C) + c_offset,
+                      g.ldc);
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,284 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/errors.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/kernel_cache.hpp>
+#include <miopen/thread_pool.hpp>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace miopen {
+
+void* default_allocator(void*, size_t sz)
+{
+    void* result = std::malloc(sz == 0 ? 1 : sz);
+    if(result == nullptr)
+        MIOPEN_THROW(miopenStatusAllocFailed,
+                     "Failed to allocate host buffer: " + std::to_string(sz));
+    return result;
+}
+
+void default_deallocator(void*, void* mem) { std::free(mem); }
+
+struct HandleImpl
+{
+    bool enable_profiling  = false;
+    void* stream           = nullptr;
+    float profiling_result = 0.0;
+    bool enable_timings    = IsKernelTimingsEnabledByEnv();
+    KernelTimings timings;
+    std::shared_ptr<CommandGraphRecorder> recorder;
+    Allocator allocator{};
+    std::shared_ptr<AllocatorPool> pool;
+    KernelCache cache;
+    // Last, so the transformed filters are freed before the rest of the handle
+    FilterTransformCache transforms;
+};
+
+Handle::Handle(miopenAcceleratorQueue_t stream) : impl(new HandleImpl())
+{
+    this->impl->stream = stream;
+    this->SetAllocator(nullptr, nullptr, nullptr);
+}
+
+Handle::Handle() : impl(new HandleImpl()) { this->SetAllocator(nullptr, nullptr, nullptr); }
+
+Handle::Handle(Handle&&) noexcept = default;
+
+Handle::~Handle()
+{
+    if(impl != nullptr && IsKernelTimingsEnabledByEnv() && !impl->timings.Empty())
+        std::cerr << impl->timings;
+}
+
+// The host has a single in-order queue, the stream is only kept to be handed back.
+void Handle::SetStream(miopenAcceleratorQueue_t streamID) const
+{
+    this->impl->stream = streamID;
+}
+
+miopenAcceleratorQueue_t Handle::GetStream() const { return impl->stream; }
+
+void Handle::SetAllocator(miopenAllocatorFunction allocator,
+                          miopenDeallocatorFunction deallocator,
+                          void* allocatorContext) const
+{
+    this->impl->allocator.allocator   = allocator == nullptr ? default_allocator : allocator;
+    this->impl->allocator.deallocator = deallocator == nullptr ? default_deallocator : deallocator;
+
+    this->impl->allocator.context = allocatorContext;
+
+    if(this->impl->pool != nullptr)
+    {
+        this->impl->pool = std::make_shared<AllocatorPool>(
+            this->impl->allocator, this->impl->pool->GetStats().max_cached);
+    }
+}
+
+void Handle::EnableMemoryPool(std::size_t max_cached_bytes)
+{
+    if(this->impl->pool != nullptr)
+        this->impl->pool->SetMaxCached(max_cached_bytes);
+    else
+        this->impl->pool = std::make_shared<AllocatorPool>(this->impl->allocator, max_cached_bytes);
+}
+
+// Buffers still in use keep the pool alive, it is released with the last of them.
+void Handle::DisableMemoryPool() { this->impl->pool = nullptr; }
+
+void Handle::TrimMemoryPool()
+{
+    if(this->impl->pool != nullptr)
+        this->impl->pool->Trim();
+}
+
+AllocatorPoolStats Handle::GetMemoryPoolStats() const
+{
+    if(this->impl->pool == nullptr)
+        return {};
+    return this->impl->pool->GetStats();
+}
+
+void Handle::EnableProfiling(bool enable) { this->impl->enable_profiling = enable; }
+
+float Handle::GetKernelTime() const { return this->impl->profiling_result; }
+
+void Handle::EnableKernelTimings(bool enable) { this->impl->enable_timings = enable; }
+bool Handle::IsKernelTimingsEnabled() const { return this->impl->enable_timings; }
+const KernelTimings& Handle::GetKernelTimings() const { return this->impl->timings; }
+void Handle::ResetKernelTimings() { this->impl->timings.Clear(); }
+
+FilterTransformCache& Handle::GetFilterTransformCache() { return this->impl->transforms; }
+
+void Handle::BeginCapture()
+{
+    if(this->impl->recorder != nullptr)
+        MIOPEN_THROW("Command capture is already in progress");
+    this->impl->recorder = std::make_shared<CommandGraphRecorder>();
+}
+
+void Handle::BindCaptureBuffer(std::size_t slot, ConstData_t buffer)
+{
+    if(this->impl->recorder == nullptr)
+        MIOPEN_THROW("No command capture in progress");
+    this->impl->recorder->BindBuffer(slot, buffer);
+}
+
+bool Handle::IsCapturing() const { return this->impl->recorder != nullptr; }
+
+CommandGraph Handle::EndCapture()
+{
+    if(this->impl->recorder == nullptr)
+        MIOPEN_THROW("No command capture in progress");
+    auto graph           = this->impl->recorder->Finish();
+    this->impl->recorder = nullptr;
+    return graph;
+}
+
+Allocator::ManageDataPtr Handle::Create(std::size_t sz)
+{
+    if(this->impl->pool != nullptr)
+        return this->impl->pool->GetAllocator()(sz);
+    return this->impl->allocator(sz);
+}
+Allocator::ManageDataPtr&
+Handle::WriteTo(const void* data, Allocator::ManageDataPtr& ddata, std::size_t sz)
+{
+    if(sz != 0)
+        std::memcpy(ddata.get(), data, sz);
+    return ddata;
+}
+void Handle::ReadTo(void* data, const Allocator::ManageDataPtr& ddata, std::size_t sz)
+{
+    if(sz != 0)
+        std::memcpy(data, ddata.get(), sz);
+}
+
+void Handle::Copy(ConstData_t src, Data_t dest, std::size_t size)
+{
+    if(this->IsCapturing())
+        MIOPEN_THROW(miopenStatusNotImplemented, "Buffer copies cannot be captured");
+    if(size != 0 && src != dest)
+        std::memmove(dest, src, size);
+}
+
+KernelInvoke Handle::AddKernel(const std::string& algorithm,
+                               const std::string& network_config,
+                               const std::string& program_name,
+                               const std::string& kernel_name,
+                               const std::vector<size_t>& vld,
+                               const std::vector<size_t>& vgd,
+                               const std::string& params,
+                               std::size_t cache_index)
+{
+
+    auto obj = this->impl->cache.AddKernel(
+        *this, algorithm, network_config, program_name, kernel_name, vld, vgd, params, cache_index);
+    return this->Run(obj, algorithm, network_config);
+}
+
+void Handle::ClearKernels(const std::string& algorithm, const std::string& network_config)
+{
+    this->impl->cache.ClearKernels(algorithm, network_config);
+}
+
+const std::vector<Kernel>& Handle::GetKernelsImpl(const std::string& algorithm,
+                                                  const std::string& network_config)
+{
+    return this->impl->cache.GetKernels(algorithm, network_config);
+}
+
+bool Handle::HasKernel(const std::string& algorithm, const std::string& network_config) const
+{
+    return this->impl->cache.HasKernels(algorithm, network_config);
+}
+
+KernelInvoke Handle::Run(Kernel k) { return this->Run(k, "", ""); }
+
+KernelInvoke Handle::Run(Kernel k, const std::string&, const std::string&) { return k.Invoke(); }
+
+Program Handle::LoadProgram(const std::string& program_name, std::string params, bool)
+{
+    return HostProgram{program_name, params};
+}
+
+// Host operations complete before they return.
+void Handle::Finish() const {}
+void Handle::Flush() const {}
+
+bool Handle::IsProfilingEnabled() const { return this->impl->enable_profiling; }
+
+void Handle::ResetKernelTime() { this->impl->profiling_result = 0.0; }
+void Handle::AccumKernelTime(float curr_time) { this->impl->profiling_result += curr_time; }
+
+// Reported as the LDS size of the GCN devices so that solvers asked about the
+// host keep their usual arithmetic.
+std::size_t Handle::GetLocalMemorySize() { return 64 * 1024; }
+
+std::size_t Handle::GetMaxComputeUnits() { return thread_pool::get().size(); }
+
+std::size_t Handle::GetMaxClockFrequency() { return 0; }
+
+std::size_t Handle::GetMaxMemoryAllocSize()
+{
+    if(m_MaxMemoryAllocSizeCached == 0)
+    {
+#ifndef _WIN32
+        const auto pages     = ::sysconf(_SC_PHYS_PAGES);
+        const auto page_size = ::sysconf(_SC_PAGE_SIZE);
+        if(pages > 0 && page_size > 0)
+            m_MaxMemoryAllocSizeCached =
+                std::floor(static_cast<double>(pages) * static_cast<double>(page_size) * 0.85);
+#endif
+        if(m_MaxMemoryAllocSizeCached == 0)
+            m_MaxMemoryAllocSizeCached = std::numeric_limits<std::size_t>::max() / 2;
+    }
+
+    return m_MaxMemoryAllocSizeCached;
+}
+
+std::string Handle::GetDeviceName() { return "cpu"; }
+
+shared<Data_t> Handle::CreateSubBuffer(Data_t data, std::size_t offset, std::size_t)
+{
+    auto cdata = reinterpret_cast<char*>(data);
+    return {cdata + offset, null_deleter{}};
+}
+
+shared<ConstData_t> Handle::CreateSubBuffer(ConstData_t data, std::size_t offset, std::size_t)
+{
+    auto cdata = reinterpret_cast<const char*>(data);
+    return {cdata + offset, null_deleter{}};
+}
+
+} // namespace miopen
@@ -0,0 +1,236 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
+#include <miopen/lrn.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+struct lrn_layout
+{
+    std::size_t n, c, h, w;
+    std::size_t ns, cs, hs, ws;
+
+    explicit lrn_layout(const TensorDescriptor& desc)
+    {
+        std::tie(n, c, h, w)     = tien<4>(desc.GetLengths());
+        std::tie(ns, cs, hs, ws) = tien<4>(desc.GetStrides());
+    }
+
+    std::size_t operator()(std::size_t b, std::size_t k, std::size_t i, std::size_t j) const
+    {
+        return b * ns + k * cs + i * hs + j * ws;
+    }
+};
+
+// Calls f(b, k) for every plane of the layout, or f(b, i, j) for every pixel.
+template <class F>
+void ForEachPlane(const lrn_layout& l, F f)
+{
+    ParallelFor(l.n * l.c, 1, [&](std::size_t p) { f(p / l.c, p % l.c); });
+}
+
+template <class F>
+void ForEachPixel(const lrn_layout& l, F f)
+{
+    ParallelFor(l.n * l.h * l.w, 64, [&](std::size_t p) {
+        f(p / (l.h * l.w), p / l.w % l.h, p % l.w);
+    });
+}
+
+} // namespace
+
+// The scale K + alpha / area * sum(x^2) is kept in the workspace, laid out
+// like y, when the backward pass is requested.
+void LRNForward(Handle& handle,
+                const LRNDescriptor& desc,
+                const TensorDescriptor& xDesc,
+                ConstData_t x,
+                const TensorDescriptor& yDesc,
+                Data_t y,
+                bool do_backward,
+                Data_t workSpace)
+{
+    const lrn_layout xl{xDesc};
+    const lrn_layout yl{yDesc};
+    const int size       = desc.GetN();
+    const int pad        = (size - 1) / 2;
+    const auto alpha     = static_cast<float>(desc.GetAlpha());
+    const auto beta      = static_cast<float>(desc.GetBeta());
+    const auto K         = static_cast<float>(desc.GetK());
+    const bool cross     = desc.GetMode() == miopenLRNCrossChannel;
+    const float overarea = cross ? alpha / size : alpha / (size * size);
+
+    Run(handle, [&] {
+        visit_float(xDesc.GetType(), [&](auto as_float) {
+            using T     = typename decltype(as_float)::type;
+            const T* xp = as_float(x);
+            T* yp       = as_float(y);
+            T* sp       = do_backward ? as_float(workSpace) : nullptr;
+            auto store  = [&](std::size_t xo, std::size_t yo, float scale) {
+                yp[yo] = static_cast<T>(static_cast<float>(xp[xo]) * std::pow(scale, -beta));
+                if(sp != nullptr)
+                    sp[yo] = static_cast<T>(scale);
+            };
+            if(cross)
+            {
+                ForEachPixel(xl, [&](std::size_t b, std::size_t i, std::size_t j) {
+                    const int channels = xl.c;
+                    for(int k = 0; k < channels; k++)
+                    {
+                        float sum = 0;
+                        for(int q = std::max(k - pad, 0); q <= std::min(k + pad, channels - 1);
+                            q++)
+                        {
+                            const auto v = static_cast<float>(xp[xl(b, q, i, j)]);
+                            sum += v * v;
+                        }
+                        store(xl(b, k, i, j), yl(b, k, i, j), K + overarea * sum);
+                    }
+                });
+                return;
+            }
+            ForEachPlane(xl, [&](std::size_t b, std::size_t k) {
+                const int height = xl.h;
+                const int width  = xl.w;
+                for(int i = 0; i < height; i++)
+                {
+                    for(int j = 0; j < width; j++)
+                    {
+                        float sum = 0;
+                        for(int r = std::max(i - pad, 0); r <= std::min(i + pad, height - 1); r++)
+                        {
+                            for(int q = std::max(j - pad, 0); q <= std::min(j + pad, width - 1);
+                                q++)
+                            {
+                                const auto v = static_cast<float>(xp[xl(b, k, r, q)]);
+                                sum += v * v;
+                            }
+                        }
+                        store(xl(b, k, i, j), yl(b, k, i, j), K + overarea * sum);
+                    }
+                }
+            });
+        });
+    });
+}
+
+void LRNBackward(Handle& handle,
+                 const LRNDescriptor& desc,
+                 const TensorDescriptor& yDesc,
+                 ConstData_t y,
+                 const TensorDescriptor& dyDesc,
+                 ConstData_t dy,
+                 const TensorDescriptor& xDesc,
+                 ConstData_t x,
+                 const TensorDescriptor& dxDesc,
+                 Data_t dx,
+                 ConstData_t workSpace)
+{
+    if(workSpace == nullptr)
+        MIOPEN_THROW(miopenStatusBadParm, "LRN backward needs the forward workspace");
+
+    const lrn_layout yl{yDesc};
+    const lrn_layout dyl{dyDesc};
+    const lrn_layout xl{xDesc};
+    const lrn_layout dxl{dxDesc};
+    const int size   = desc.GetN();
+    const int pad    = (size - 1) / 2;
+    const auto alpha = static_cast<float>(desc.GetAlpha());
+    const auto beta  = static_cast<float>(desc.GetBeta());
+    const bool cross = desc.GetMode() == miopenLRNCrossChannel;
+
+    Run(handle, [&] {
+        visit_float(xDesc.GetType(), [&](auto as_float) {
+            using T      = typename decltype(as_float)::type;
+            const T* yp  = as_float(y);
+            const T* dyp = as_float(dy);
+            const T* xp  = as_float(x);
+            const T* sp  = as_float(workSpace);
+            T* dxp       = as_float(dx);
+            // y * dy / scale of one element; the scale shares the layout of y
+            auto ratio = [&](std::size_t b, std::size_t k, std::size_t i, std::size_t j) {
+                const auto yo = yl(b, k, i, j);
+                return static_cast<float>(yp[yo]) * static_cast<float>(dyp[dyl(b, k, i, j)]) /
+                       static_cast<float>(sp[yo]);
+            };
+            auto store = [&](std::size_t b, std::size_t k, std::size_t i, std::size_t j,
+                             float factor, float sum) {
+                const auto scale = static_cast<float>(sp[yl(b, k, i, j)]);
+                dxp[dxl(b, k, i, j)] =
+                    static_cast<T>(static_cast<float>(dyp[dyl(b, k, i, j)]) *
+                                       std::pow(scale, -beta) -
+                                   factor * static_cast<float>(xp[xl(b, k, i, j)]) * sum);
+            };
+            if(cross)
+            {
+                const float factor = 2 * alpha * beta / size;
+                ForEachPixel(yl, [&](std::size_t b, std::size_t i, std::size_t j) {
+                    const int channels = yl.c;
+                    for(int k = 0; k < channels; k++)
+                    {
+                        float sum = 0;
+                        for(int q = std::max(k - pad, 0); q <= std::min(k + pad, channels - 1);
+                            q++)
+                            sum += ratio(b, q, i, j);
+                        store(b, k, i, j, factor, sum);
+                    }
+                });
+                return;
+            }
+            ForEachPlane(yl, [&](std::size_t b, std::size_t k) {
+                const int height = yl.h;
+                const int width  = yl.w;
+                for(int i = 0; i < height; i++)
+                {
+                    for(int j = 0; j < width; j++)
+                    {
+                        const int r0 = std::max(i - pad, 0);
+                        const int r1 = std::min(i + pad, height - 1);
+                        const int q0 = std::max(j - pad, 0);
+                        const int q1 = std::min(j + pad, width - 1);
+                        float sum    = 0;
+                        for(int r = r0; r <= r1; r++)
+                            for(int q = q0; q <= q1; q++)
+                                sum += ratio(b, k, r, q);
+                        const int area = (r1 - r0 + 1) * (q1 - q0 + 1);
+                        store(b, k, i, j, 2 * alpha * beta / area, sum);
+                    }
+                }
+            });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
+#include <miopen/pooling.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+struct pooling_geometry
+{
+    std::size_t n, c, in_h, in_w, out_h, out_w;
+    int win_h, win_w, pad_h, pad_w, stride_h, stride_w;
+
+    pooling_geometry(const PoolingDescriptor& desc,
+                     const TensorDescriptor& inDesc,
+                     const TensorDescriptor& outDesc)
+    {
+        std::tie(n, c, in_h, in_w)                       = tien<4>(inDesc.GetLengths());
+        std::tie(std::ignore, std::ignore, out_h, out_w) = tien<4>(outDesc.GetLengths());
+        std::tie(win_h, win_w)                           = tien<2>(desc.GetLengths());
+        std::tie(pad_h, pad_w)                           = tien<2>(desc.GetPads());
+        std::tie(stride_h, stride_w)                     = tien<2>(desc.GetStrides());
+    }
+
+    // First row and column of the window of an output, before clipping.
+    int row(std::size_t oh) const { return static_cast<int>(oh) * stride_h - pad_h; }
+    int col(std::size_t ow) const { return static_cast<int>(ow) * stride_w - pad_w; }
+
+    // The window clipped to the input, as [h0, h1) x [w0, w1).
+    void clip(std::size_t oh, std::size_t ow, int& h0, int& h1, int& w0, int& w1) const
+    {
+        h0 = row(oh);
+        w0 = col(ow);
+        h1 = std::min(h0 + win_h, static_cast<int>(in_h));
+        w1 = std::min(w0 + win_w, static_cast<int>(in_w));
+        h0 = std::max(h0, 0);
+        w0 = std::max(w0, 0);
+    }
+};
+
+} // namespace
+
+// Max pooling records, for every output, the position of the maximum inside
+// its unclipped window (row * window width + column) in the workspace, laid
+// out like the output.
+void PoolingForward(Handle& handle,
+                    const PoolingDescriptor& desc,
+                    const TensorDescriptor& xDesc,
+                    ConstData_t x,
+                    const TensorDescriptor& yDesc,
+                    Data_t y,
+                    bool do_backward,
+                    Data_t workSpace)
+{
+    const pooling_geometry g{desc, xDesc, yDesc};
+    const bool is_max = desc.GetMode() == miopenPoolingMax;
+    if(is_max && do_backward && g.win_h * g.win_w > std::numeric_limits<uint8_t>::max() + 1)
+        MIOPEN_THROW("Pooling window too large to do backwards");
+
+    std::size_t xns, xcs, xhs, xws;
+    std::size_t yns, ycs, yhs, yws;
+    std::tie(xns, xcs, xhs, xws) = tien<4>(xDesc.GetStrides());
+    std::tie(yns, ycs, yhs, yws) = tien<4>(yDesc.GetStrides());
+    auto* mask = static_cast<uint8_t*>(workSpace);
+
+    Run(handle, [&] {
+        visit_float(xDesc.GetType(), [&](auto as_float) {
+            using T = typename decltype(as_float)::type;
+            ParallelFor(g.n * g.c, 1, [&](std::size_t plane) {
+                const std::size_t b  = plane / g.c;
+                const std::size_t k  = plane % g.c;
+                const T* xp          = as_float(x) + b * xns + k * xcs;
+                const std::size_t yo = b * yns + k * ycs;
+                T* yp                = as_float(y) + yo;
+                for(std::size_t oh = 0; oh < g.out_h; oh++)
+                {
+                    for(std::size_t ow = 0; ow < g.out_w; ow++)
+                    {
+                        int h0, h1, w0, w1;
+                        g.clip(oh, ow, h0, h1, w0, w1);
+                        float acc = is_max ? std::numeric_limits<float>::lowest() : 0.0f;
+                        int arg   = 0;
+                        for(int ih = h0; ih < h1; ih++)
+                        {
+                            for(int iw = w0; iw < w1; iw++)
+                            {
+                                const auto v = static_cast<float>(xp[ih * xhs + iw * xws]);
+                                if(!is_max)
+                                {
+                                    acc += v;
+                                }
+                                else if(v > acc)
+                                {
+                                    acc = v;
+                                    arg = (ih - g.row(oh)) * g.win_w + (iw - g.col(ow));
+                                }
+                            }
+                        }
+                        if(!is_max)
+                            acc /= std::max((h1 - h0) * (w1 - w0), 1);
+                        yp[oh * yhs + ow * yws] = static_cast<T>(acc);
+                        if(is_max && do_backward && mask != nullptr)
+                            mask[yo + oh * yhs + ow * yws] = static_cast<uint8_t>(arg);
+                    }
+                }
+            });
+        });
+    });
+}
+
+void PoolingBackward(Handle& handle,
+                     const PoolingDescriptor& desc,
+                     const TensorDescriptor& dyDesc,
+                     ConstData_t dy,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx,
+                     ConstData_t workSpace)
+{
+    const pooling_geometry g{desc, dxDesc, dyDesc};
+    const bool is_max = desc.GetMode() == miopenPoolingMax;
+    if(is_max && workSpace == nullptr)
+        MIOPEN_THROW(miopenStatusBadParm, "Max pooling backward needs the forward workspace");
+
+    std::size_t dxns, dxcs, dxhs, dxws;
+    std::size_t dyns, dycs, dyhs, dyws;
+    std::tie(dxns, dxcs, dxhs, dxws) = tien<4>(dxDesc.GetStrides());
+    std::tie(dyns, dycs, dyhs, dyws) = tien<4>(dyDesc.GetStrides());
+    const auto* mask = static_cast<const uint8_t*>(workSpace);
+
+    Run(handle, [&] {
+        visit_float(dxDesc.GetType(), [&](auto as_float) {
+            using T = typename decltype(as_float)::type;
+            ParallelFor(g.n * g.c, 1, [&](std::size_t plane) {
+                const std::size_t b  = plane / g.c;
+                const std::size_t k  = plane % g.c;
+                const std::size_t yo = b * dyns + k * dycs;
+                const T* dyp         = as_float(dy) + yo;
+                T* dxp               = as_float(dx) + b * dxns + k * dxcs;
+                std::vector<float> acc(g.in_h * g.in_w, 0.0f);
+                for(std::size_t oh = 0; oh < g.out_h; oh++)
+                {
+                    for(std::size_t ow = 0; ow < g.out_w; ow++)
+                    {
+                        const auto d = static_cast<float>(dyp[oh * dyhs + ow * dyws]);
+                        if(is_max)
+                        {
+                            const int arg = mask[yo + oh * dyhs + ow * dyws];
+                            const int ih  = g.row(oh) + arg / g.win_w;
+                            const int iw  = g.col(ow) + arg % g.win_w;
+                            if(ih >= 0 && iw >= 0 && ih < static_cast<int>(g.in_h) &&
+                               iw < static_cast<int>(g.in_w))
+                                acc[ih * g.in_w + iw] += d;
+                            continue;
+                        }
+                        int h0, h1, w0, w1;
+                        g.clip(oh, ow, h0, h1, w0, w1);
+                        const float share = d / std::max((h1 - h0) * (w1 - w0), 1);
+                        for(int ih = h0; ih < h1; ih++)
+                            for(int iw = w0; iw < w1; iw++)
+                                acc[ih * g.in_w + iw] += share;
+                    }
+                }
+                for(std::size_t ih = 0; ih < g.in_h; ih++)
+                    for(std::size_t iw = 0; iw < g.in_w; iw++)
+                        dxp[ih * dxhs + iw * dxws] = static_cast<T>(acc[ih * g.in_w + iw]);
+            });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
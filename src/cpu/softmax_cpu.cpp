@@ -0,0 +1,99 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace miopen {
+namespace cpu {
+
+// Softmax runs across the channels of every (n, h, w) position, in place.
+void SoftmaxForward(Handle& handle, const TensorDescriptor& yDesc, Data_t y)
+{
+    std::size_t n, c, h, w;
+    std::size_t ns, cs, hs, ws;
+    std::tie(n, c, h, w)     = tien<4>(yDesc.GetLengths());
+    std::tie(ns, cs, hs, ws) = tien<4>(yDesc.GetStrides());
+
+    Run(handle, [&] {
+        visit_float(yDesc.GetType(), [&](auto as_float) {
+            using T = typename decltype(as_float)::type;
+            T* yp   = as_float(y);
+            ParallelFor(n * h * w, 16, [&](std::size_t i) {
+                T* p = yp + (i / (h * w)) * ns + (i / w % h) * hs + (i % w) * ws;
+                float m = std::numeric_limits<float>::lowest();
+                for(std::size_t k = 0; k < c; k++)
+                    m = std::max(m, static_cast<float>(p[k * cs]));
+                float sum = 0;
+                for(std::size_t k = 0; k < c; k++)
+                    sum += std::exp(static_cast<float>(p[k * cs]) - m);
+                for(std::size_t k = 0; k < c; k++)
+                    p[k * cs] = static_cast<T>(std::exp(static_cast<float>(p[k * cs]) - m) / sum);
+            });
+        });
+    });
+}
+
+// dx holds dy on entry and is overwritten with y * (dy - sum(y * dy)).
+void SoftmaxBackward(Handle& handle,
+                     const TensorDescriptor& yDesc,
+                     ConstData_t y,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx)
+{
+    std::size_t n, c, h, w;
+    std::size_t yns, ycs, yhs, yws;
+    std::size_t dns, dcs, dhs, dws;
+    std::tie(n, c, h, w)         = tien<4>(yDesc.GetLengths());
+    std::tie(yns, ycs, yhs, yws) = tien<4>(yDesc.GetStrides());
+    std::tie(dns, dcs, dhs, dws) = tien<4>(dxDesc.GetStrides());
+
+    Run(handle, [&] {
+        visit_float(yDesc.GetType(), [&](auto as_float) {
+            using T      = typename decltype(as_float)::type;
+            const T* ybp = as_float(y);
+            T* dxbp      = as_float(dx);
+            ParallelFor(n * h * w, 16, [&](std::size_t i) {
+                const std::size_t b = i / (h * w);
+                const std::size_t r = i / w % h;
+                const std::size_t q = i % w;
+                const T* yp         = ybp + b * yns + r * yhs + q * yws;
+                T* dxp              = dxbp + b * dns + r * dhs + q * dws;
+                float sum           = 0;
+                for(std::size_t k = 0; k < c; k++)
+                    sum += static_cast<float>(yp[k * ycs]) * static_cast<float>(dxp[k * dcs]);
+                for(std::size_t k = 0; k < c; k++)
+                    dxp[k * dcs] = static_cast<T>(static_cast<float>(yp[k * ycs]) *
+                                                  (static_cast<float>(dxp[k * dcs]) - sum));
+            });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,328 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/check_numerics.hpp>
+#include <miopen/cpu_ops.hpp>
+#include <miopen/visit_float.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace miopen {
+namespace cpu {
+
+namespace {
+
+template <class F>
+void VisitOp(miopenTensorOp_t op, F f)
+{
+    switch(op)
+    {
+    case miopenTensorOpAdd: f([](float a, float b) { return a + b; }); break;
+    case miopenTensorOpMul: f([](float a, float b) { return a * b; }); break;
+    case miopenTensorOpMin: f([](float a, float b) { return std::min(a, b); }); break;
+    case miopenTensorOpMax: f([](float a, float b) { return std::max(a, b); }); break;
+    default: MIOPEN_THROW(miopenStatusBadParm, "Unknown tensor operation");
+    }
+}
+
+} // namespace
+
+// B is broadcast over C along every dimension where its length is 1.
+void OpTensor(Handle& handle,
+              miopenTensorOp_t tensorOp,
+              const void* alpha0,
+              const TensorDescriptor& aTensorDesc,
+              ConstData_t ATensor,
+              const void* alpha1,
+              const TensorDescriptor& bTensorDesc,
+              ConstData_t BTensor,
+              const void* beta,
+              const TensorDescriptor& cTensorDesc,
+              Data_t CTensor,
+              std::size_t Aoffset,
+              std::size_t Boffset,
+              std::size_t Coffset)
+{
+    const auto& clens = cTensorDesc.GetLengths();
+    const auto& blens = bTensorDesc.GetLengths();
+    TensorDims bstrides = bTensorDesc.GetStrides();
+    for(std::size_t i = 0; i < blens.size(); i++)
+        if(blens[i] == 1)
+            bstrides[i] = 0;
+    const std::array<TensorDims, 3> strides{
+        {aTensorDesc.GetStrides(), bstrides, cTensorDesc.GetStrides()}};
+
+    const float a0 = *static_cast<const float*>(alpha0);
+    const float a1 = *static_cast<const float*>(alpha1);
+    const float b0 = *static_cast<const float*>(beta);
+
+    Run(handle, [&] {
+        visit_float(cTensorDesc.GetType(), [&](auto as_float) {
+            using T    = typename decltype(as_float)::type;
+            const T* a = as_float(ATensor) + Aoffset;
+            const T* b = as_float(BTensor) + Boffset;
+            T* c       = as_float(CTensor) + Coffset;
+            VisitOp(tensorOp, [&](auto op) {
+                ParallelForEach<3>(clens, strides, [&](const std::array<std::size_t, 3>& i) {
+                    const float r = op(a0 * static_cast<float>(a[i[0]]),
+                                       a1 * static_cast<float>(b[i[1]]));
+                    c[i[2]] =
+                        static_cast<T>(b0 == 0 ? r : r + b0 * static_cast<float>(c[i[2]]));
+                });
+            });
+        });
+    });
+}
+
+// Alpha has the type of the tensor, as for the device kernels.
+void SetTensor(
+    Handle& handle, const TensorDescriptor& yDesc, Data_t y, const void* alpha, int offset)
+{
+    const std::array<TensorDims, 1> strides{{yDesc.GetStrides()}};
+    Run(handle, [&] {
+        visit_float(yDesc.GetType(), [&](auto as_float) {
+            using T     = typename decltype(as_float)::type;
+            const T val = *as_float(alpha);
+            T* p        = as_float(y) + offset;
+            ParallelForEach<1>(yDesc.GetLengths(),
+                               strides,
+                               [&](const std::array<std::size_t, 1>& i) { p[i[0]] = val; });
+        });
+    });
+}
+
+void ScaleTensor(
+    Handle& handle, const TensorDescriptor& yDesc, Data_t y, const void* alpha, int offset)
+{
+    const std::array<TensorDims, 1> strides{{yDesc.GetStrides()}};
+    Run(handle, [&] {
+        visit_float(yDesc.GetType(), [&](auto as_float) {
+            using T     = typename decltype(as_float)::type;
+            const T val = *as_float(alpha);
+            T* p        = as_float(y) + offset;
+            ParallelForEach<1>(yDesc.GetLengths(),
+                               strides,
+                               [&](const std::array<std::size_t, 1>& i) { p[i[0]] *= val; });
+        });
+    });
+}
+
+void CopyTensor(Handle& handle,
+                const TensorDescriptor& srcDesc,
+                ConstData_t src,
+                const TensorDescriptor& dstDesc,
+                Data_t dst,
+                std::size_t srcOffset,
+                std::size_t dstOffset)
+{
+    const std::array<TensorDims, 2> strides{{srcDesc.GetStrides(), dstDesc.GetStrides()}};
+    Run(handle, [&] {
+        visit_float(srcDesc.GetType(), [&](auto as_float) {
+            using T    = typename decltype(as_float)::type;
+            const T* s = as_float(src) + srcOffset;
+            T* d       = as_float(dst) + dstOffset;
+            ParallelForEach<2>(srcDesc.GetLengths(),
+                               strides,
+                               [&](const std::array<std::size_t, 2>& i) { d[i[1]] = s[i[0]]; });
+        });
+    });
+}
+
+void CopyRows(Handle& handle,
+              ConstData_t src,
+              Data_t dst,
+              ConstData_t rows,
+              const int n_rows,
+              const int width,
+              const int slices,
+              const int slice_rows,
+              const bool scatter,
+              miopenDataType_t type)
+{
+    const auto* index = static_cast<const int*>(rows);
+    Run(handle, [&] {
+        visit_float(type, [&](auto as_float) {
+            using T    = typename decltype(as_float)::type;
+            const T* s = as_float(src);
+            T* d       = as_float(dst);
+            ParallelFor(std::size_t(slices) * n_rows, 64, [&](std::size_t i) {
+                const std::size_t slice  = i / n_rows;
+                const std::size_t packed = (slice * slice_rows + i % n_rows) * width;
+                const std::size_t padded = (slice * slice_rows + index[i % n_rows]) * width;
+                if(scatter)
+                    std::copy_n(s + packed, width, d + padded);
+                else
+                    std::copy_n(s + padded, width, d + packed);
+            });
+        });
+    });
+}
+
+void TransposeNCHW2CNHW(Handle& handle,
+                        const int n,
+                        const int c,
+                        const int h_in,
+                        const int w_in,
+                        const int h_out,
+                        const int w_out,
+                        ConstData_t in,
+                        Data_t out,
+                        const int in_offset,
+                        const int out_offset,
+                        const int h_stride,
+                        const int w_stride,
+                        miopenDataType_t type)
+{
+    Run(handle, [&] {
+        visit_float(type, [&](auto as_float) {
+            using T    = typename decltype(as_float)::type;
+            const T* s = as_float(in) + in_offset;
+            T* d       = as_float(out) + out_offset;
+            ParallelFor(std::size_t(n) * c, 1, [&](std::size_t i) {
+                const std::size_t ni = i / c;
+                const std::size_t ci = i % c;
+                const T* src         = s + (ni * c + ci) * h_in * w_in;
+                T* dst               = d + (ci * n + ni) * h_out * w_out;
+                for(int h = 0; h < h_out; h++)
+                    for(int w = 0; w < w_out; w++)
+                        dst[h * w_out + w] = src[h * h_stride * w_in + w * w_stride];
+            });
+        });
+    });
+}
+
+void TransposeCNHW2NCHW(Handle& handle,
+                        const int n,
+                        const int c,
+                        const int h_out,
+                        const int w_out,
+                        const int h_in,
+                        const int w_in,
+                        ConstData_t in,
+                        Data_t out,
+                        const int in_offset,
+                        const int out_offset,
+                        const int h_stride,
+                        const int w_stride,
+                        miopenDataType_t type)
+{
+    Run(handle, [&] {
+        visit_float(type, [&](auto as_float) {
+            using T    = typename decltype(as_float)::type;
+            const T* s = as_float(in) + in_offset;
+            T* d       = as_float(out) + out_offset;
+            ParallelFor(std::size_t(n) * c, 1, [&](std::size_t i) {
+                const std::size_t ni = i / c;
+                const std::size_t ci = i % c;
+                const T* src         = s + (ci * n + ni) * h_out * w_out;
+                T* dst               = d + (ni * c + ci) * h_in * w_in;
+                for(int h = 0; h < h_out; h++)
+                    for(int w = 0; w < w_out; w++)
+                        dst[h * h_stride * w_in + w * w_stride] = src[h * w_out + w];
+            });
+        });
+    });
+}
+
+// Blocks are scanned in parallel and their partial results merged in order.
+void CheckNumerics(Handle& handle,
+                   ConstData_t data,
+                   const std::size_t n,
+                   const bool stats,
+                   CheckNumericsResult& result)
+{
+    const std::size_t block  = 4096;
+    const std::size_t blocks = (n + block - 1) / block;
+    const auto* p            = static_cast<const float*>(data);
+    Run(handle, [&] {
+        std::vector<CheckNumericsResult> partial(blocks);
+        ParallelFor(blocks, 1, [&](std::size_t b) {
+            CheckNumericsResult& r = partial[b];
+            r.min                  = std::numeric_limits<float>::infinity();
+            r.max                  = -std::numeric_limits<float>::infinity();
+            for(std::size_t i = b * block; i < std::min(n, (b + 1) * block); i++)
+            {
+                const float v = p[i];
+                r.hasZero |= int(v == 0.0f);
+                r.hasNan |= int(std::isnan(v));
+                r.hasInf |= int(std::isinf(v));
+                r.sum += v;
+                r.absSum += std::fabs(v);
+                r.min = std::min(r.min, v);
+                r.max = std::max(r.max, v);
+            }
+        });
+        for(std::size_t b = 0; b < blocks; b++)
+        {
+            const CheckNumericsResult& r = partial[b];
+            result.hasZero |= r.hasZero;
+            result.hasNan |= r.hasNan;
+            result.hasInf |= r.hasInf;
+            if(!stats)
+                continue;
+            result.sum += r.sum;
+            result.absSum += r.absSum;
+            result.min = b == 0 ? r.min : std::min(result.min, r.min);
+            result.max = b == 0 ? r.max : std::max(result.max, r.max);
+        }
+    });
+}
+
+// Values are scaled by alpha and saturated at the largest value of the
+// destination type, as the cast kernel does.
+void CastTensor(Handle& handle,
+                const void* alpha,
+                const TensorDescriptor& srcDesc,
+                ConstData_t src,
+                const TensorDescriptor& dstDesc,
+                Data_t dst,
+                std::size_t srcOffset,
+                std::size_t dstOffset)
+{
+    const std::array<TensorDims, 2> strides{{srcDesc.GetStrides(), dstDesc.GetStrides()}};
+    const float scale = *static_cast<const float*>(alpha);
+    Run(handle, [&] {
+        visit_float(srcDesc.GetType(), [&](auto src_float) {
+            visit_float(dstDesc.GetType(), [&](auto dst_float) {
+                using T            = typename decltype(dst_float)::type;
+                const auto* s      = src_float(src) + srcOffset;
+                T* d               = dst_float(dst) + dstOffset;
+                const auto max_val = static_cast<float>(std::numeric_limits<T>::max());
+                ParallelForEach<2>(
+                    srcDesc.GetLengths(), strides, [&](const std::array<std::size_t, 2>& i) {
+                        const float v = scale * static_cast<float>(s[i[0]]);
+                        d[i[1]] =
+                            v >= max_val ? std::numeric_limits<T>::max() : static_cast<T>(v);
+                    });
+            });
+        });
+    });
+}
+
+} // namespace cpu
+} // namespace miopen
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/filter_transform_cache.hpp>
+#include <miopen/problem_description.hpp>
+
+#include <sstream>
+
+namespace miopen {
+
+FilterTransformCache::Key FilterTransformCache::MakeKey(ConstData_t buffer,
+                                                        miopenConvFwdAlgorithm_t algorithm,
+                                                        const ProblemDescription& problem)
+{
+    std::ostringstream ss;
+    problem.Serialize(ss);
+    return Key{buffer, algorithm, ss.str()};
+}
+
+const FilterTransformCache::Entry* FilterTransformCache::Find(
+    ConstData_t buffer, miopenConvFwdAlgorithm_t algorithm, const ProblemDescription& problem) const
+{
+    const auto it = entries.find(MakeKey(buffer, algorithm, problem));
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+const FilterTransformCache::Entry& FilterTransformCache::Insert(ConstData_t buffer,
+                                                                miopenConvFwdAlgorithm_t algorithm,
+                                                                const ProblemDescription& problem,
+                                                                std::uint64_t version,
+                                                                Allocator::ManageDataPtr data,
+                                                                std::size_t size)
+{
+    auto& entry = entries[MakeKey(buffer, algorithm, problem)];
+    entry       = Entry{version, size, std::move(data)};
+    return entry;
+}
+
+std::size_t FilterTransformCache::Erase(ConstData_t buffer)
+{
+    const void* key = buffer;
+    std::size_t n   = 0;
+    for(auto it = entries.begin(); it != entries.end();)
+    {
+        if(std::get<0>(it->first) == key)
+        {
+            it = entries.erase(it);
+            n++;
+        }
+        else
+            ++it;
+    }
+    return n;
+}
+
+std::size_t FilterTransformCache::Bytes() const
+{
+    std::size_t bytes = 0;
+    for(const auto& entry : entries)
+        bytes += entry.second.size;
+    return bytes;
+}
+
+} // namespace miopen
@@ -24,6 +24,7 @@
  *
  *******************************************************************************/
 #include <cassert>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/fusion.hpp>
 #include <miopen/fusion_plan.hpp>
 #include <miopen/logger.hpp>
@@ -949,6 +950,11 @@ miopenStatus_t FusionPlanDescriptor::Compile(Handle& handle)
     else
         kernel_source_type = OpenclText;
 
+#if MIOPEN_BACKEND_CPU
+    // The CPU backend runs the ops one after another in Execute and builds no kernel
+    (void)status;
+    return miopenStatusSuccess;
+#else
     auto&& kernels = handle.GetKernels(algorithm_name, network_config);
     if(!kernels.empty())
     {
@@ -993,6 +999,7 @@ miopenStatus_t FusionPlanDescriptor::Compile(Handle& handle)
     }
     arg_list = CalcArgOrder(handle);
     return status;
+#endif
 }
 
 std::vector<Exec_arg_t> FusionPlanDescriptor::CalcArgOrder(Handle& handle)
@@ -1183,6 +1190,10 @@ miopenStatus_t FusionPlanDescriptor::Execute(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "The input descriptors dont match.");
     }
 
+#if MIOPEN_BACKEND_CPU
+    cpu::ExecuteFusionPlan(handle, op_map, inputDesc, input, outputDesc, output, op_args);
+    return miopenStatusSuccess;
+#else
     auto ops_head = op_map[0];
 
     auto&& kernels = handle.GetKernels(algorithm_name, network_config);
@@ -1229,6 +1240,7 @@ miopenStatus_t FusionPlanDescriptor::Execute(Handle& handle,
     }
     kernel(args);
     return miopenStatusSuccess;
+#endif
 }
 
 } // namespace miopen
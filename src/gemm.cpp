@@ -389,9 +389,9 @@ void RunGemmGeometryRNN(Handle& handle,
                         int lda,
                         int ldb,
                         int ldc,
-                        int a_offset,
-                        int b_offset,
-                        int c_offset,
+                        std::size_t a_offset,
+                        std::size_t b_offset,
+                        std::size_t c_offset,
                         bool isDataColMajor,
                         std::string& network_config,
                         float timeout)
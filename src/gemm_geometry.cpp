@@ -23,8 +23,13 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <miopen/errors.hpp>
 #include <miopen/float_equal.hpp>
 #include <miopen/gemm_geometry.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/miopengemm.hpp>
+
+#include <algorithm>
 
 #if MIOPEN_USE_MIOPENGEMM
 namespace miopen {
@@ -139,12 +144,21 @@ void GemmGeometry::RunGemm(Handle& handle,
                            ConstData_t a,
                            ConstData_t b,
                            Data_t c,
-                           int a_offset,
-                           int b_offset,
-                           int c_offset)
+                           std::size_t a_offset_,
+                           std::size_t b_offset_,
+                           std::size_t c_offset_)
 {
     std::string network_config = tgg.get_networkconfig_string();
 
+    // the kernels of this path are always built with 32-bit offsets, see tempfix
+    if(MiopengemmNeedsWideOffsets(std::max({a_offset_, b_offset_, c_offset_})))
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "GemmGeometry offsets exceed 32 bits, use the CallGemm interface");
+
+    const auto a_offset = static_cast<unsigned>(a_offset_);
+    const auto b_offset = static_cast<unsigned>(b_offset_);
+    const auto c_offset = static_cast<unsigned>(c_offset_);
+
     if(beta_kern_req)
     {
         handle.GetKernel(algorithm_name + "_beta", network_config)(c, c_offset, beta);
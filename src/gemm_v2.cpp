@@ -27,6 +27,8 @@
 #include <miopen/logger.hpp>
 #include <miopen/env.hpp>
 
+#include <algorithm>
+
 #if MIOPEN_USE_ROCBLAS
 #include <half.hpp>
 #include <rocblas.h>
@@ -134,11 +136,11 @@ static GemmBackend_t enforce_gemm_backend(miopenDataType_t data_type,
 miopenStatus_t CallGemm(Handle& handle,
                         GemmDescriptor gemm_desc,
                         ConstData_t A,
-                        int a_offset,
+                        std::size_t a_offset,
                         ConstData_t B,
-                        int b_offset,
+                        std::size_t b_offset,
                         Data_t C,
-                        int c_offset,
+                        std::size_t c_offset,
                         std::string* kcache_key,
                         bool enqueue_dummy_kernel,
                         GemmBackend_t gemm_backend)
@@ -167,6 +169,9 @@ miopenStatus_t CallGemm(Handle& handle,
 #if MIOPEN_USE_ROCBLAS
         MIOPEN_LOG_FUNCTION("rocBLAS");
 
+        if(handle.IsCapturing())
+            MIOPEN_THROW(miopenStatusNotImplemented, "rocBLAS calls cannot be captured");
+
         HipEventPtr start = nullptr;
         HipEventPtr stop  = nullptr;
         if(handle.IsProfilingEnabled())
@@ -304,8 +309,11 @@ miopenStatus_t CallGemm(Handle& handle,
                    std::to_string(gemm_desc.n) + "_" + std::to_string(gemm_desc.k);
         };
 
+        const bool wide_offsets =
+            MiopengemmNeedsWideOffsets(std::max({a_offset, b_offset, c_offset}));
+
         const std::string algorithm_name = "MIOpenGEMM";
-        const std::string network_config = gemm_desc_to_string();
+        const std::string network_config = gemm_desc_to_string() + (wide_offsets ? "_wide" : "");
 
         if(kcache_key != nullptr)
             *kcache_key = network_config;
@@ -328,7 +336,7 @@ miopenStatus_t CallGemm(Handle& handle,
                                      'f');
 
             AddMiopengemmSolution(
-                handle, algorithm_name, network_config, mgg, A, B, C, 0.003, false);
+                handle, algorithm_name, network_config, mgg, A, B, C, 0.003, false, wide_offsets);
 
             auto&& new_kernels = handle.GetKernels(algorithm_name, network_config);
 
@@ -341,7 +349,8 @@ miopenStatus_t CallGemm(Handle& handle,
                                   b_offset,
                                   gemm_desc.beta,
                                   C,
-                                  c_offset);
+                                  c_offset,
+                                  wide_offsets);
         }
         else
         {
@@ -354,7 +363,8 @@ miopenStatus_t CallGemm(Handle& handle,
                                   b_offset,
                                   gemm_desc.beta,
                                   C,
-                                  c_offset);
+                                  c_offset,
+                                  wide_offsets);
         }
 
         return miopenStatusSuccess;
@@ -370,11 +380,11 @@ miopenStatus_t CallGemm(Handle& handle,
 miopenStatus_t CallGemmStridedBatched(Handle& handle,
                                       GemmDescriptor gemm_desc,
                                       ConstData_t A,
-                                      int a_offset,
+                                      std::size_t a_offset,
                                       ConstData_t B,
-                                      int b_offset,
+                                      std::size_t b_offset,
                                       Data_t C,
-                                      int c_offset,
+                                      std::size_t c_offset,
                                       std::string* kcache_key,
                                       bool enqueue_dummy_kernel,
                                       GemmBackend_t gemm_backend)
@@ -404,6 +414,9 @@ miopenStatus_t CallGemmStridedBatched(Handle& handle,
 #if MIOPEN_USE_ROCBLAS
         MIOPEN_LOG_FUNCTION("rocBLAS");
 
+        if(handle.IsCapturing())
+            MIOPEN_THROW(miopenStatusNotImplemented, "rocBLAS calls cannot be captured");
+
         HipEventPtr start = nullptr;
         HipEventPtr stop  = nullptr;
         if(handle.IsProfilingEnabled())
@@ -534,6 +547,7 @@ miopenStatus_t CallGemmStridedBatched(Handle& handle,
 
     case GemmBackend_t::miopengemm: {
 #if MIOPEN_USE_MIOPENGEMM
+        // MIOpenGEMM has no batched GEMM, so the batch is issued one GEMM per batch entry
         return CallGemmStridedBatchedSequential(handle,
                                                 gemm_desc,
                                                 A,
@@ -557,11 +571,11 @@ miopenStatus_t CallGemmStridedBatched(Handle& handle,
 miopenStatus_t CallGemmStridedBatchedSequential(Handle& handle,
                                                 GemmDescriptor gemm_desc,
                                                 ConstData_t A,
-                                                int a_offset,
+                                                std::size_t a_offset,
                                                 ConstData_t B,
-                                                int b_offset,
+                                                std::size_t b_offset,
                                                 Data_t C,
-                                                int c_offset,
+                                                std::size_t c_offset,
                                                 std::string* kcache_key,
                                                 bool enqueue_dummy_kernel,
                                                 GemmBackend_t gemm_backend)
@@ -591,6 +605,9 @@ miopenStatus_t CallGemmStridedBatchedSequential(Handle& handle,
 #if MIOPEN_USE_ROCBLAS
         MIOPEN_LOG_FUNCTION("rocBLAS");
 
+        if(handle.IsCapturing())
+            MIOPEN_THROW(miopenStatusNotImplemented, "rocBLAS calls cannot be captured");
+
         HipEventPtr start = nullptr;
         HipEventPtr stop  = nullptr;
         if(handle.IsProfilingEnabled())
@@ -734,8 +751,14 @@ miopenStatus_t CallGemmStridedBatchedSequential(Handle& handle,
                    std::to_string(gemm_desc.n) + "_" + std::to_string(gemm_desc.k);
         };
 
+        const std::size_t last_batch = std::max(gemm_desc.batch_count - 1, 0);
+        const bool wide_offsets      = MiopengemmNeedsWideOffsets(
+            std::max({a_offset + last_batch * gemm_desc.strideA,
+                      b_offset + last_batch * gemm_desc.strideB,
+                      c_offset + last_batch * gemm_desc.strideC}));
+
         const std::string algorithm_name = "MIOpenGEMM";
-        const std::string network_config = gemm_desc_to_string();
+        const std::string network_config = gemm_desc_to_string() + (wide_offsets ? "_wide" : "");
 
         if(kcache_key != nullptr)
             *kcache_key = network_config;
@@ -758,7 +781,7 @@ miopenStatus_t CallGemmStridedBatchedSequential(Handle& handle,
                                      'f');
 
             AddMiopengemmSolution(
-                handle, algorithm_name, network_config, mgg, A, B, C, 0.003, false);
+                handle, algorithm_name, network_config, mgg, A, B, C, 0.003, false, wide_offsets);
 
             auto&& new_kernels = handle.GetKernels(algorithm_name, network_config);
 
@@ -775,7 +798,8 @@ miopenStatus_t CallGemmStridedBatchedSequential(Handle& handle,
                                       b_offset + i * gemm_desc.strideB,
                                       gemm_desc.beta,
                                       C,
-                                      c_offset + i * gemm_desc.strideC);
+                                      c_offset + i * gemm_desc.strideC,
+                                      wide_offsets);
 
                 if(handle.IsProfilingEnabled())
                 {
@@ -801,7 +825,8 @@ miopenStatus_t CallGemmStridedBatchedSequential(Handle& handle,
                                       b_offset + i * gemm_desc.strideB,
                                       gemm_desc.beta,
                                       C,
-                                      c_offset + i * gemm_desc.strideC);
+                                      c_offset + i * gemm_desc.strideC,
+                                      wide_offsets);
 
                 if(handle.IsProfilingEnabled())
                 {
@@ -39,6 +39,7 @@
 
 #include <cassert>
 #include <chrono>
+#include <iostream>
 #include <thread>
 
 namespace miopen {
@@ -136,16 +137,26 @@ struct HandleImpl
 
     static StreamPtr reference_stream(hipStream_t s) { return StreamPtr{s, null_deleter{}}; }
 
-    void elapsed_time(hipEvent_t start, hipEvent_t stop)
+    void elapsed_time(hipEvent_t start, hipEvent_t stop, const KernelTimingKey& key)
     {
-        if(enable_profiling)
-            hipEventElapsedTime(&this->profiling_result, start, stop);
+        if(enable_profiling || enable_timings)
+        {
+            float time = 0.0;
+            hipEventElapsedTime(&time, start, stop);
+            if(enable_profiling)
+                this->profiling_result = time;
+            if(enable_timings)
+                this->timings.Record(key, time);
+        }
     }
 
-    std::function<void(hipEvent_t, hipEvent_t)> elapsed_time_handler()
+    std::function<void(hipEvent_t, hipEvent_t)> elapsed_time_handler(KernelTimingKey key)
     {
-        return std::bind(
-            &HandleImpl::elapsed_time, this, std::placeholders::_1, std::placeholders::_2);
+        return std::bind(&HandleImpl::elapsed_time,
+                         this,
+                         std::placeholders::_1,
+                         std::placeholders::_2,
+                         std::move(key));
     }
 
     void set_ctx()
@@ -160,10 +171,16 @@ struct HandleImpl
     bool enable_profiling  = false;
     StreamPtr stream       = nullptr;
     float profiling_result = 0.0;
+    bool enable_timings    = IsKernelTimingsEnabledByEnv();
+    KernelTimings timings;
+    std::shared_ptr<CommandGraphRecorder> recorder;
     int device             = -1;
     Allocator allocator{};
+    std::shared_ptr<AllocatorPool> pool;
     KernelCache cache;
     hipCtx_t ctx;
+    // Last, so the transformed filters are freed before the rest of the handle
+    FilterTransformCache transforms;
 };
 
 Handle::Handle(miopenAcceleratorQueue_t stream) : impl(new HandleImpl())
@@ -201,7 +218,11 @@ Handle::Handle() : impl(new HandleImpl())
 #endif
 }
 
-Handle::~Handle() {}
+Handle::~Handle()
+{
+    if(impl != nullptr && IsKernelTimingsEnabledByEnv() && !impl->timings.Empty())
+        std::cerr << impl->timings;
+}
 
 void Handle::SetStream(miopenAcceleratorQueue_t streamID) const
 {
@@ -218,16 +239,80 @@ void Handle::SetAllocator(miopenAllocatorFunction allocator,
     this->impl->allocator.deallocator = deallocator == nullptr ? default_deallocator : deallocator;
 
     this->impl->allocator.context = allocatorContext;
+
+    if(this->impl->pool != nullptr)
+    {
+        this->impl->pool = std::make_shared<AllocatorPool>(
+            this->impl->allocator, this->impl->pool->GetStats().max_cached);
+    }
+}
+
+void Handle::EnableMemoryPool(std::size_t max_cached_bytes)
+{
+    if(this->impl->pool != nullptr)
+        this->impl->pool->SetMaxCached(max_cached_bytes);
+    else
+        this->impl->pool = std::make_shared<AllocatorPool>(this->impl->allocator, max_cached_bytes);
+}
+
+// Buffers still in use keep the pool alive, it is released with the last of them.
+void Handle::DisableMemoryPool() { this->impl->pool = nullptr; }
+
+void Handle::TrimMemoryPool()
+{
+    if(this->impl->pool != nullptr)
+        this->impl->pool->Trim();
+}
+
+AllocatorPoolStats Handle::GetMemoryPoolStats() const
+{
+    if(this->impl->pool == nullptr)
+        return {};
+    return this->impl->pool->GetStats();
 }
 
 void Handle::EnableProfiling(bool enable) { this->impl->enable_profiling = enable; }
 
 float Handle::GetKernelTime() const { return this->impl->profiling_result; }
 
+void Handle::EnableKernelTimings(bool enable) { this->impl->enable_timings = enable; }
+bool Handle::IsKernelTimingsEnabled() const { return this->impl->enable_timings; }
+const KernelTimings& Handle::GetKernelTimings() const { return this->impl->timings; }
+void Handle::ResetKernelTimings() { this->impl->timings.Clear(); }
+
+FilterTransformCache& Handle::GetFilterTransformCache() { return this->impl->transforms; }
+
+void Handle::BeginCapture()
+{
+    if(this->impl->recorder != nullptr)
+        MIOPEN_THROW("Command capture is already in progress");
+    this->impl->recorder = std::make_shared<CommandGraphRecorder>();
+}
+
+void Handle::BindCaptureBuffer(std::size_t slot, ConstData_t buffer)
+{
+    if(this->impl->recorder == nullptr)
+        MIOPEN_THROW("No command capture in progress");
+    this->impl->recorder->BindBuffer(slot, buffer);
+}
+
+bool Handle::IsCapturing() const { return this->impl->recorder != nullptr; }
+
+CommandGraph Handle::EndCapture()
+{
+    if(this->impl->recorder == nullptr)
+        MIOPEN_THROW("No command capture in progress");
+    auto graph           = this->impl->recorder->Finish();
+    this->impl->recorder = nullptr;
+    return graph;
+}
+
 Allocator::ManageDataPtr Handle::Create(std::size_t sz)
 {
     MIOPEN_HANDLE_LOCK
     this->Finish();
+    if(this->impl->pool != nullptr)
+        return this->impl->pool->GetAllocator()(sz);
     return this->impl->allocator(sz);
 }
 Allocator::ManageDataPtr&
@@ -252,6 +337,8 @@ void Handle::ReadTo(void* data, const Allocator::ManageDataPtr& ddata, std::size
 void Handle::Copy(ConstData_t src, Data_t dest, std::size_t size)
 {
     MIOPEN_HANDLE_LOCK
+    if(this->IsCapturing())
+        MIOPEN_THROW(miopenStatusNotImplemented, "Buffer copies cannot be captured");
     this->impl->set_ctx();
     auto status = hipMemcpy(dest, src, size, hipMemcpyDeviceToDevice);
     if(status != hipSuccess)
@@ -270,7 +357,7 @@ KernelInvoke Handle::AddKernel(const std::string& algorithm,
 
     auto obj = this->impl->cache.AddKernel(
         *this, algorithm, network_config, program_name, kernel_name, vld, vgd, params, cache_index);
-    return this->Run(obj);
+    return this->Run(obj, algorithm, network_config);
 }
 
 void Handle::ClearKernels(const std::string& algorithm, const std::string& network_config)
@@ -289,13 +376,28 @@ bool Handle::HasKernel(const std::string& algorithm, const std::string& network_
     return this->impl->cache.HasKernels(algorithm, network_config);
 }
 
-KernelInvoke Handle::Run(Kernel k)
+KernelInvoke Handle::Run(Kernel k) { return this->Run(k, "", ""); }
+
+KernelInvoke
+Handle::Run(Kernel k, const std::string& algorithm, const std::string& network_config)
 {
     this->impl->set_ctx();
-    if(this->impl->enable_profiling || MIOPEN_GPU_SYNC)
-        return k.Invoke(this->GetStream(), this->impl->elapsed_time_handler());
+    if(this->impl->enable_profiling || this->impl->enable_timings || MIOPEN_GPU_SYNC)
+    {
+        KernelTimingKey key;
+        if(this->impl->enable_timings)
+            key = KernelTimingKey{algorithm, network_config, k.GetName()};
+        auto invoke =
+            k.Invoke(this->GetStream(), this->impl->elapsed_time_handler(std::move(key)));
+        invoke.recorder = this->impl->recorder;
+        return invoke;
+    }
     else
-        return k.Invoke(this->GetStream());
+    {
+        auto invoke     = k.Invoke(this->GetStream());
+        invoke.recorder = this->impl->recorder;
+        return invoke;
+    }
 }
 
 Program Handle::LoadProgram(const std::string& program_name, std::string params, bool is_kernel_str)
@@ -375,6 +477,17 @@ std::size_t Handle::GetMaxComputeUnits()
     return result;
 }
 
+std::size_t Handle::GetMaxClockFrequency()
+{
+    int result;
+    auto status = hipDeviceGetAttribute(&result, hipDeviceAttributeClockRate, this->impl->device);
+    if(status != hipSuccess)
+        MIOPEN_THROW_HIP_STATUS(status);
+
+    // kHz
+    return result / 1000;
+}
+
 // No HIP API that could return maximum memory allocation size
 // for a single object.
 std::size_t Handle::GetMaxMemoryAllocSize()
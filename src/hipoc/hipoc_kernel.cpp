@@ -96,6 +96,17 @@ void HIPOCKernelInvoke::run(void* args, std::size_t size) const
     }
 }
 
+void HIPOCKernelInvoke::Record(std::vector<OpKernelArg> args) const
+{
+    auto launcher     = *this;
+    launcher.recorder = nullptr;
+    recorder->Record(name,
+                     {ldims.begin(), ldims.end()},
+                     {gdims.begin(), gdims.end()},
+                     std::move(args),
+                     [launcher](std::vector<OpKernelArg>& replay_args) { launcher(replay_args); });
+}
+
 HIPOCKernelInvoke HIPOCKernel::Invoke(hipStream_t stream,
                                       std::function<void(hipEvent_t, hipEvent_t)> callback)
 {
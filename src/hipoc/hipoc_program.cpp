@@ -47,15 +47,17 @@ hipModulePtr CreateModule(const std::string& program_name, std::string params, b
     auto hsaco_file = dir.path / (filename + ".o");
     auto obj_file   = dir.path / (filename + ".obj");
 
-    std::string src = is_kernel_str ? program_name : GetKernelSrc(program_name);
+    boost::string_ref src =
+        is_kernel_str ? boost::string_ref{program_name} : GetKernelSrcView(program_name);
     if(!is_kernel_str && miopen::EndsWith(program_name, ".so"))
     {
         WriteFile(src, hsaco_file);
     }
     else if(!is_kernel_str && miopen::EndsWith(program_name, ".s"))
     {
-        AmdgcnAssemble(src, params);
-        WriteFile(src, hsaco_file);
+        auto binary = src.to_string();
+        AmdgcnAssemble(binary, params);
+        WriteFile(binary, hsaco_file);
     }
     else
     {
@@ -114,15 +116,17 @@ struct HIPOCProgramImpl
         dir.emplace(filename);
         hsaco_file = dir->path / (filename + ".o");
 
-        std::string src = is_kernel_str ? program_name : GetKernelSrc(program_name);
+        boost::string_ref src =
+            is_kernel_str ? boost::string_ref{program_name} : GetKernelSrcView(program_name);
         if(!is_kernel_str && miopen::EndsWith(program_name, ".so"))
         {
             WriteFile(src, hsaco_file);
         }
         else if(!is_kernel_str && miopen::EndsWith(program_name, ".s"))
         {
-            AmdgcnAssemble(src, params);
-            WriteFile(src, hsaco_file);
+            auto binary = src.to_string();
+            AmdgcnAssemble(binary, params);
+            WriteFile(binary, hsaco_file);
         }
         else
         {
@@ -54,7 +54,7 @@ struct ActivationDescriptor : miopenActivationDescriptor
                            const TensorDescriptor& yDesc,
                            Data_t y,
                            size_t xOffset = 0,
-                           size_t yOffset = 0);
+                           size_t yOffset = 0) const;
 
     miopenStatus_t Backward(Handle& handle,
                             const void* alpha,
@@ -70,7 +70,7 @@ struct ActivationDescriptor : miopenActivationDescriptor
                             size_t yOffset  = 0,
                             size_t dyOffset = 0,
                             size_t xOffset  = 0,
-                            size_t dxOffset = 0);
+                            size_t dxOffset = 0) const;
 
     friend std::ostream& operator<<(std::ostream& stream, const ActivationDescriptor& x);
 
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_ALLOCATOR_POOL_HPP_
+#define GUARD_MIOPEN_ALLOCATOR_POOL_HPP_
+
+#include <miopen/allocator.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace miopen {
+
+struct AllocatorPoolStats
+{
+    std::size_t hits         = 0; // Requests served from the cache.
+    std::size_t misses       = 0; // Requests forwarded to the underlying allocator.
+    std::size_t releases     = 0; // Buffers returned to the underlying allocator.
+    std::size_t bytes_in_use = 0; // Size-class bytes handed out and not yet freed.
+    std::size_t bytes_cached = 0; // Bytes held in the free lists.
+    std::size_t peak_bytes   = 0; // High-water mark of bytes_in_use + bytes_cached.
+    std::size_t max_cached   = 0; // Limit on bytes_cached.
+};
+
+/// Size-class caching pool over a miopenAllocatorFunction/miopenDeallocatorFunction pair.
+///
+/// Requests are rounded up to a size class (four classes per power of two, so at most 25% is
+/// wasted) and freed buffers are kept in per-class free lists instead of being returned to the
+/// underlying allocator, as long as the cached total stays under max_cached_bytes. If the
+/// underlying allocator fails, the cache is trimmed and the request retried once.
+///
+/// Reusing a buffer is only safe once the device is done with its previous owner; Handle::Create
+/// finishes the queue before allocating, which guarantees that.
+class AllocatorPool : public std::enable_shared_from_this<AllocatorPool>
+{
+    public:
+    AllocatorPool(const Allocator& base_, std::size_t max_cached_bytes);
+    AllocatorPool(const AllocatorPool&) = delete;
+    AllocatorPool& operator=(const AllocatorPool&) = delete;
+    ~AllocatorPool();
+
+    void* Allocate(std::size_t n);
+    void Deallocate(void* mem);
+
+    /// Returns all cached buffers to the underlying allocator.
+    void Trim();
+    void SetMaxCached(std::size_t max_cached_bytes);
+    AllocatorPoolStats GetStats() const;
+
+    /// Allocator which routes through this pool and keeps it alive while buffers are in use.
+    Allocator GetAllocator();
+
+    static std::size_t SizeClass(std::size_t n);
+
+    private:
+    void TrimTo(std::size_t bytes);
+
+    Allocator base;
+    mutable std::mutex mutex;
+    AllocatorPoolStats stats;
+    std::map<std::size_t, std::vector<void*>> free_lists;
+    std::unordered_map<void*, std::size_t> in_use;
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_ALLOCATOR_POOL_HPP_
@@ -14,6 +14,20 @@ struct CheckNumerics
     static const int Abort        = 0x08; // abort on abnormal result (to drop into debugger)
     static const int ComputeStats = 0x10; // Print mean/absmean/min/max (slow)
 };
+
+// Must keep this structure synchronized with one in MIOpenCheckNumerics
+struct CheckNumericsResult
+{
+    float sum    = 0.0f;
+    float absSum = 0.0f;
+    float min    = 0.0f;
+    float max    = 0.0f;
+
+    int hasZero = 0;
+    int hasNan  = 0;
+    int hasInf  = 0;
+};
+
 int CheckNumericsEnabled(int bitMask = -1);
 
 bool checkNumericsInput(Handle& handle, const TensorDescriptor& dDesc, ConstData_t data);
@@ -26,6 +26,7 @@
 #ifndef MIOPEN_GUARD_OCL_HELPER_HPP_
 #define MIOPEN_GUARD_OCL_HELPER_HPP_
 
+#include <boost/utility/string_ref.hpp>
 #include <iostream>
 #include <miopen/manage_ptr.hpp>
 #include <miopen/miopen.h>
@@ -37,7 +38,7 @@ using ClProgramPtr = MIOPEN_MANAGE_PTR(cl_program, clReleaseProgram);
 using ClKernelPtr  = MIOPEN_MANAGE_PTR(cl_kernel, clReleaseKernel);
 using ClAqPtr      = MIOPEN_MANAGE_PTR(miopenAcceleratorQueue_t, clReleaseCommandQueue);
 
-ClProgramPtr LoadBinaryProgram(cl_context ctx, cl_device_id device, const std::string& source);
+ClProgramPtr LoadBinaryProgram(cl_context ctx, cl_device_id device, boost::string_ref source);
 
 ClProgramPtr LoadProgram(cl_context ctx,
                          cl_device_id device,
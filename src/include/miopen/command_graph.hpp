@@ -0,0 +1,102 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_COMMAND_GRAPH_HPP_
+#define GUARD_MIOPEN_COMMAND_GRAPH_HPP_
+
+#include <miopen/op_kernel_args.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace miopen {
+
+/// Launches one recorded kernel with its marshalled arguments.
+using CommandLaunch = std::function<void(std::vector<OpKernelArg>&)>;
+
+struct CommandGraphNode
+{
+    std::string name;
+    std::vector<std::size_t> local_dims;
+    std::vector<std::size_t> global_dims;
+    std::vector<OpKernelArg> args;
+    /// (argument index, buffer slot) for every argument that is patched on replay.
+    std::vector<std::pair<std::size_t, std::size_t>> buffer_args;
+    CommandLaunch launch;
+};
+
+/// A recorded sequence of kernel launches which can be replayed with different buffers.
+///
+/// Replay relaunches every node in recording order. The only work done per node is writing
+/// the new buffer pointers into the already marshalled arguments; descriptors, network configs
+/// and the kernel cache are not looked at again.
+class CommandGraph
+{
+    public:
+    /// buffers[slot] replaces the buffer that was bound to slot while recording.
+    void Replay(const std::vector<const void*>& buffers);
+
+    const std::vector<CommandGraphNode>& GetNodes() const { return nodes; }
+    std::size_t GetNumBufferSlots() const { return num_slots; }
+    bool Empty() const { return nodes.empty(); }
+
+    private:
+    friend class CommandGraphRecorder;
+
+    std::vector<CommandGraphNode> nodes;
+    std::vector<std::size_t> used_slots;
+    std::size_t num_slots = 0;
+};
+
+/// Builds a CommandGraph from kernel launches reported by the backend.
+///
+/// A pointer argument is recorded as a buffer slot when its value equals a buffer bound with
+/// BindBuffer; any other argument, including pointers to unbound buffers, is replayed as it
+/// was recorded.
+class CommandGraphRecorder
+{
+    public:
+    void BindBuffer(std::size_t slot, const void* buffer);
+
+    void Record(std::string name,
+                std::vector<std::size_t> local_dims,
+                std::vector<std::size_t> global_dims,
+                std::vector<OpKernelArg> args,
+                CommandLaunch launch);
+
+    CommandGraph Finish();
+
+    private:
+    std::unordered_map<const void*, std::size_t> slots;
+    CommandGraph graph;
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_COMMAND_GRAPH_HPP_
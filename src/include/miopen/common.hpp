@@ -26,6 +26,7 @@
 #ifndef GUARD_MIOPEN_COMMON_HPP_
 #define GUARD_MIOPEN_COMMON_HPP_
 
+#include <cstdlib>
 #include <miopen/manage_ptr.hpp>
 #include <miopen/miopen.h>
 
@@ -59,5 +60,15 @@ using ManageDataPtr = MIOPEN_MANAGE_PTR(void, hipFree);
 inline Data_t DataCast(void* p) { return p; }
 
 inline ConstData_t DataCast(const void* p) { return p; }
-#endif // OpenCL vs hip
+
+#elif MIOPEN_BACKEND_CPU
+
+using Data_t        = void*;
+using ConstData_t   = const void*;
+using ManageDataPtr = MIOPEN_MANAGE_PTR(void, std::free);
+
+inline Data_t DataCast(void* p) { return p; }
+
+inline ConstData_t DataCast(const void* p) { return p; }
+#endif // OpenCL vs hip vs cpu
 #endif // GUARD_MIOPEN_COMMON_HPP_
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_CONV_COST_MODEL_HPP_
+#define GUARD_MIOPEN_CONV_COST_MODEL_HPP_
+
+#include <miopen/problem_description.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace miopen {
+
+struct Handle;
+
+/// Device parameters of the convolution cost model.
+struct ConvCostDevice
+{
+    std::size_t compute_units = 64;
+    double clock_mhz          = 1500;  // engine clock
+    double bandwidth          = 512;   // DRAM bandwidth, GB/s
+    double launch_time        = 0.005; // ms per kernel launch
+
+    /// FLOP per ms: 64 lanes per compute unit retire one FMA each clock, twice as many for
+    /// packed FP16.
+    double PeakFlops(bool half) const;
+    /// Bytes per ms
+    double PeakBytes() const { return bandwidth * 1e6; }
+
+    /// Compute units and clock of the handle's device. OpenCL and HIP do not report the memory
+    /// bandwidth, it is looked up by device name.
+    static ConvCostDevice Query(Handle& handle);
+};
+
+/// The algorithm families Find times against each other.
+enum class ConvAlgoClass
+{
+    gemm,
+    direct,
+    winograd,
+    fft,
+};
+
+/// The family of a find-db algorithm name such as "miopenConvolutionFwdAlgoGEMM". Returns
+/// false for a name of no known family.
+bool GetConvAlgoClass(const std::string& algorithm, ConvAlgoClass& algo);
+
+/// Work of one convolution algorithm over a whole problem.
+struct ConvCost
+{
+    double flops = 0;
+    double bytes = 0; // DRAM traffic, workspace included
+    int kernels  = 1;
+};
+
+ConvCost GetConvCost(const ProblemDescription& problem, ConvAlgoClass algo);
+
+/// A time Find measured: the problem, the algorithm name and its time in ms.
+struct ConvCostSample
+{
+    ProblemDescription problem;
+    std::string algorithm;
+    float time;
+};
+
+/// Roofline estimate of convolution algorithm times. An algorithm takes the longer of its
+/// compute and memory time, divided by the efficiency of its family, plus its launches. The
+/// efficiencies start from rough defaults and are fitted to times measured by Find.
+class ConvCostModel
+{
+    public:
+    ConvCostModel() = default;
+    explicit ConvCostModel(const ConvCostDevice& device_) : device(device_) {}
+
+    /// Time at full efficiency and without launches, ms
+    double Roofline(const ProblemDescription& problem, ConvAlgoClass algo) const;
+    /// Predicted time in ms, negative for an algorithm of no known family
+    double Estimate(const ProblemDescription& problem, const std::string& algorithm) const;
+
+    double Efficiency(ConvAlgoClass algo) const { return efficiency[Index(algo)]; }
+
+    /// Sets the efficiency of every family with samples to the geometric mean of its
+    /// roofline to measured time ratios. Returns the number of samples used.
+    std::size_t Calibrate(const std::vector<ConvCostSample>& samples);
+    /// Calibrate over the records of a find-db text file
+    std::size_t CalibrateFromFindDb(std::istream& find_db);
+
+    private:
+    static std::size_t Index(ConvAlgoClass algo) { return static_cast<std::size_t>(algo); }
+
+    ConvCostDevice device;
+    std::array<double, 4> efficiency{{0.6, 0.4, 0.6, 0.3}};
+};
+
+/// Reads a find-db key written by ProblemDescription::Serialize. Returns false if key is not
+/// one.
+bool ParseConvProblemKey(const std::string& key, ProblemDescription& problem);
+
+/// The model of the handle's device, calibrated once from the user find-db.
+const ConvCostModel& GetConvCostModel(Handle& handle);
+
+/// One algorithm of a Find: its find-db name and the search that times it.
+struct ConvFindCandidate
+{
+    std::string algorithm;
+    std::function<void()> find;
+};
+
+/// Runs the candidates of a Find, predicted fastest first. Once a candidate found a solution,
+/// the candidates predicted more than factor times slower than it are skipped and never
+/// compiled. With a factor <= 0 every candidate runs, in the given order. Returns the
+/// algorithms skipped.
+std::vector<std::string>
+RunConvFindCandidates(const ConvCostModel& model,
+                      const ProblemDescription& problem,
+                      double factor,
+                      std::vector<ConvFindCandidate> candidates,
+                      const std::function<bool(const std::string&)>& found);
+
+/// The factor of RunConvFindCandidates from MIOPEN_FIND_PRUNE_FACTOR, 0 if it is not set.
+double GetConvFindPruneFactor();
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_CONV_COST_MODEL_HPP_
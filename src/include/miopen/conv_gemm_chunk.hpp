@@ -0,0 +1,87 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_CONV_GEMM_CHUNK_HPP
+#define GUARD_MIOPEN_CONV_GEMM_CHUNK_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+namespace miopen {
+
+// Splits the images of a forward Im2Col + GEMM convolution into chunks. All images of
+// a chunk are im2col'ed side by side into the workspace, and the chunk is finished by
+// a single strided-batched GEMM: y[i] = w * col[i], i is the image within the chunk.
+struct ConvGemmChunkPlan
+{
+    int in_n;
+    int chunk_n;          // images per chunk, only the last chunk may be shorter
+    std::size_t in_size;  // elements of one input image
+    std::size_t col_size; // elements of one im2col'ed image
+    std::size_t out_size; // elements of one output image
+
+    int Count() const { return (in_n + chunk_n - 1) / chunk_n; }
+    int Images(int chunk) const { return std::min(chunk_n, in_n - chunk * chunk_n); }
+    std::size_t InOffset(int chunk) const { return in_size * chunk * chunk_n; }
+    std::size_t OutOffset(int chunk) const { return out_size * chunk * chunk_n; }
+
+    // Strides of the strided-batched GEMM; the weights are shared by all images
+    long long int StrideA() const { return 0; }
+    long long int StrideB() const { return col_size; }
+    long long int StrideC() const { return out_size; }
+
+    std::size_t WorkSpaceSize(std::size_t type_size) const
+    {
+        return col_size * chunk_n * type_size;
+    }
+};
+
+// Puts as many images in a chunk as fit into workspace_size bytes, but at least one.
+inline ConvGemmChunkPlan PlanConvGemmChunks(int in_n,
+                                            int in_c,
+                                            int in_h,
+                                            int in_w,
+                                            int wei_n,
+                                            int wei_h,
+                                            int wei_w,
+                                            int out_h,
+                                            int out_w,
+                                            std::size_t type_size,
+                                            std::size_t workspace_size)
+{
+    ConvGemmChunkPlan plan;
+    plan.in_n     = in_n;
+    plan.in_size  = std::size_t(in_c) * in_h * in_w;
+    plan.col_size = std::size_t(in_c) * wei_h * wei_w * out_h * out_w;
+    plan.out_size = std::size_t(wei_n) * out_h * out_w;
+
+    std::size_t chunk_n = workspace_size / std::max<std::size_t>(plan.col_size * type_size, 1);
+    plan.chunk_n = static_cast<int>(std::max<std::size_t>(std::min<std::size_t>(chunk_n, in_n), 1));
+    return plan;
+}
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_CONV_GEMM_CHUNK_HPP
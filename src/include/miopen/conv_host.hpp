@@ -0,0 +1,400 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_CONV_HOST_HPP
+#define GUARD_MIOPEN_CONV_HOST_HPP
+
+#include <miopen/errors.hpp>
+#include <miopen/gemm_host.hpp>
+#include <miopen/half_convert.hpp>
+#include <miopen/thread_pool.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace miopen {
+
+// Host reference convolution shared by the CPU backend, the tests and the
+// driver. Every direction is lowered to im2col plus host_gemm_acc on packed NCHW
+// doubles and split into independent tasks for par_for. Each output element is
+// accumulated in the same order as the naive nested loops, so forward and
+// weight gradients are bit-identical to them in double, and backward data is
+// bit-identical whenever the products are exactly representable.
+
+// A grouped, strided, dilated 2-d convolution in its forward orientation:
+// in[n][c][h][w] * wei[k][c / groups][y][x] -> out[n][k][out_h][out_w].
+struct conv_host_problem
+{
+    std::size_t n = 1;
+    std::size_t c = 1;
+    std::size_t h = 1;
+    std::size_t w = 1;
+    std::size_t k = 1;
+    std::size_t y = 1;
+    std::size_t x = 1;
+    std::size_t out_h = 1;
+    std::size_t out_w = 1;
+    int pad_h      = 0;
+    int pad_w      = 0;
+    int stride_h   = 1;
+    int stride_w   = 1;
+    int dilation_h = 1;
+    int dilation_w = 1;
+    std::size_t groups = 1;
+
+    std::size_t group_c() const { return c / groups; }
+    std::size_t group_k() const { return k / groups; }
+    // Rows of the im2col matrix of one group, ordered as (c, y, x)
+    std::size_t col_rows() const { return group_c() * y * x; }
+    std::size_t in_pixels() const { return h * w; }
+    std::size_t out_pixels() const { return out_h * out_w; }
+    std::size_t in_size() const { return n * c * in_pixels(); }
+    std::size_t wei_size() const { return k * col_rows(); }
+    std::size_t out_size() const { return n * k * out_pixels(); }
+};
+
+// Builds the forward-orientation problem from the tensor lengths the API sees.
+// A transposed convolution is the backward-data pass of the convolution that
+// runs from its output y back to its input x.
+template <class Lens, class WeiLens>
+conv_host_problem make_conv_host_problem(const Lens& x_lens,
+                                         const WeiLens& w_lens,
+                                         const Lens& y_lens,
+                                         int pad_h,
+                                         int pad_w,
+                                         int stride_h,
+                                         int stride_w,
+                                         int dilation_h,
+                                         int dilation_w,
+                                         int groups,
+                                         bool transposed)
+{
+    const auto& in  = transposed ? y_lens : x_lens;
+    const auto& out = transposed ? x_lens : y_lens;
+
+    conv_host_problem p;
+    p.n          = in[0];
+    p.c          = in[1];
+    p.h          = in[2];
+    p.w          = in[3];
+    p.k          = w_lens[0];
+    p.y          = w_lens[2];
+    p.x          = w_lens[3];
+    p.out_h      = out[2];
+    p.out_w      = out[3];
+    p.pad_h      = pad_h;
+    p.pad_w      = pad_w;
+    p.stride_h   = stride_h;
+    p.stride_w   = stride_w;
+    p.dilation_h = dilation_h;
+    p.dilation_w = dilation_w;
+    p.groups     = std::max(groups, 1);
+
+    if(p.c != std::size_t(w_lens[1]) * p.groups || p.k % p.groups != 0 ||
+       std::size_t(out[0]) != p.n || std::size_t(out[1]) != p.k)
+        MIOPEN_THROW(miopenStatusBadParm,
+                     "conv_host: tensor lengths do not describe a convolution");
+    return p;
+}
+
+// Copies a strided 4-d tensor into a packed buffer of doubles.
+template <class T, class Lens, class Strides>
+std::vector<double> conv_host_pack(const T* data, const Lens& lens, const Strides& strides)
+{
+    const std::size_t c  = lens[1];
+    const std::size_t hw = std::size_t(lens[2]) * lens[3];
+    std::vector<double> result(lens[0] * c * hw);
+    par_for(std::size_t(lens[0]) * c, 1, [&](std::size_t nc) {
+        const T* src = data + (nc / c) * strides[0] + (nc % c) * strides[1];
+        double* dst  = result.data() + nc * hw;
+        for(std::size_t i = 0; i < std::size_t(lens[2]); i++)
+        {
+            const T* row = src + i * strides[2];
+            // Contiguous rows are widened in bulk
+            if(strides[3] == 1)
+                convert_buffer(row, dst, lens[3]);
+            else
+                for(std::size_t j = 0; j < std::size_t(lens[3]); j++)
+                    dst[j] = static_cast<double>(row[j * strides[3]]);
+            dst += lens[3];
+        }
+    });
+    return result;
+}
+
+// Stores a packed buffer of doubles into a strided 4-d tensor.
+template <class T, class Lens, class Strides>
+void conv_host_unpack(const std::vector<double>& src,
+                      T* data,
+                      const Lens& lens,
+                      const Strides& strides)
+{
+    const std::size_t c  = lens[1];
+    const std::size_t hw = std::size_t(lens[2]) * lens[3];
+    assert(src.size() == lens[0] * c * hw);
+    par_for(std::size_t(lens[0]) * c, 1, [&](std::size_t nc) {
+        T* dst           = data + (nc / c) * strides[0] + (nc % c) * strides[1];
+        const double* in = src.data() + nc * hw;
+        for(std::size_t i = 0; i < std::size_t(lens[2]); i++)
+            for(std::size_t j = 0; j < std::size_t(lens[3]); j++)
+                dst[i * strides[2] + j * strides[3]] = static_cast<T>(*in++);
+    });
+}
+
+// Largest number of output pixels handled by one im2col tile.
+static constexpr std::size_t conv_host_max_tile = 256;
+
+// Picks a block size for splitting len so that outer * blocks gives every
+// thread a few tasks to balance over.
+inline std::size_t
+conv_host_block(std::size_t outer, std::size_t len, std::size_t min_block, std::size_t max_block)
+{
+    const std::size_t tasks  = 4 * std::max(std::thread::hardware_concurrency(), 1u);
+    const std::size_t blocks = (tasks + outer - 1) / outer;
+    const std::size_t block  = (len + blocks - 1) / blocks;
+    return std::max<std::size_t>(std::min({block, max_block, len}), std::min(min_block, len));
+}
+
+// Calls f(r, j, index) for im2col rows r in [r0, r1) and output pixels
+// p0 + j, j in [0, np). index is the offset of the tapped input element within
+// one group's channels, or -1 when the tap falls into the padding.
+template <class F>
+void conv_host_for_each_tap(const conv_host_problem& p,
+                            std::size_t r0,
+                            std::size_t r1,
+                            std::size_t p0,
+                            std::size_t np,
+                            F f)
+{
+    const std::ptrdiff_t h = p.h;
+    const std::ptrdiff_t w = p.w;
+    for(std::size_t r = r0; r < r1; r++)
+    {
+        const std::size_t ch       = r / (p.y * p.x);
+        const std::ptrdiff_t off_h = std::ptrdiff_t((r / p.x) % p.y) * p.dilation_h - p.pad_h;
+        const std::ptrdiff_t off_w = std::ptrdiff_t(r % p.x) * p.dilation_w - p.pad_w;
+        const std::ptrdiff_t base  = ch * p.in_pixels();
+
+        std::size_t oh = p0 / p.out_w;
+        std::size_t ow = p0 % p.out_w;
+        for(std::size_t j = 0; j < np; j++)
+        {
+            const std::ptrdiff_t ih = std::ptrdiff_t(oh) * p.stride_h + off_h;
+            const std::ptrdiff_t iw = std::ptrdiff_t(ow) * p.stride_w + off_w;
+            f(r, j, (ih >= 0 && ih < h && iw >= 0 && iw < w) ? base + ih * w + iw : -1);
+            if(++ow == p.out_w)
+            {
+                ow = 0;
+                oh++;
+            }
+        }
+    }
+}
+
+// out = conv(in, wei) + bias[k]; bias may be empty.
+inline std::vector<double> conv_host_fwd(const conv_host_problem& p,
+                                         const std::vector<double>& in,
+                                         const std::vector<double>& wei,
+                                         const std::vector<double>& bias = {})
+{
+    assert(in.size() == p.in_size() && wei.size() == p.wei_size());
+    assert(bias.empty() || bias.size() == p.k);
+
+    std::vector<double> out(p.out_size());
+    const std::size_t pixels = p.out_pixels();
+    const std::size_t rows   = p.col_rows();
+    const std::size_t kg     = p.group_k();
+    const std::size_t images = p.n * p.groups;
+    const std::size_t tile   = conv_host_block(images, pixels, 32, conv_host_max_tile);
+    const std::size_t tiles  = (pixels + tile - 1) / tile;
+
+    par_for(images * tiles, 1, [&](std::size_t task) {
+        const std::size_t ng = task / tiles;
+        const std::size_t g  = ng % p.groups;
+        const std::size_t p0 = (task % tiles) * tile;
+        const std::size_t np = std::min(tile, pixels - p0);
+
+        const double* img = in.data() + (ng * p.group_c()) * p.in_pixels();
+        std::vector<double> col(rows * np);
+        conv_host_for_each_tap(
+            p, 0, rows, p0, np, [&](std::size_t r, std::size_t j, std::ptrdiff_t i) {
+                col[r * np + j] = i < 0 ? 0.0 : img[i];
+            });
+
+        double* dst = out.data() + ng * kg * pixels + p0;
+        if(!bias.empty())
+        {
+            for(std::size_t i = 0; i < kg; i++)
+                std::fill(dst + i * pixels, dst + i * pixels + np, bias[g * kg + i]);
+        }
+        host_gemm_acc(kg, np, rows, wei.data() + g * kg * rows, rows, col.data(), np, dst, pixels);
+    });
+    return out;
+}
+
+// din = conv^T(dout, wei): the gradient of conv_host_fwd with respect to in.
+inline std::vector<double> conv_host_bwd_data(const conv_host_problem& p,
+                                              const std::vector<double>& dout,
+                                              const std::vector<double>& wei)
+{
+    assert(dout.size() == p.out_size() && wei.size() == p.wei_size());
+
+    std::vector<double> din(p.in_size());
+    const std::size_t pixels = p.out_pixels();
+    const std::size_t rows   = p.col_rows();
+    const std::size_t kg     = p.group_k();
+    const std::size_t cg     = p.group_c();
+    const std::size_t taps   = p.y * p.x;
+
+    // Transpose each group's weights to rows x kg so the GEMM is A * B
+    std::vector<double> wei_t(wei.size());
+    for(std::size_t g = 0; g < p.groups; g++)
+        for(std::size_t i = 0; i < kg; i++)
+            for(std::size_t r = 0; r < rows; r++)
+                wei_t[(g * rows + r) * kg + i] = wei[(g * kg + i) * rows + r];
+
+    // col2im scatters into overlapping input windows, so tasks own whole
+    // input channels rather than output pixels.
+    const std::size_t images  = p.n * p.groups;
+    const std::size_t cblock  = conv_host_block(images, cg, 1, cg);
+    const std::size_t cblocks = (cg + cblock - 1) / cblock;
+
+    par_for(images * cblocks, 1, [&](std::size_t task) {
+        const std::size_t ng = task / cblocks;
+        const std::size_t g  = ng % p.groups;
+        const std::size_t c0 = (task % cblocks) * cblock;
+        const std::size_t r0 = c0 * taps;
+        const std::size_t nr = std::min(cblock, cg - c0) * taps;
+
+        double* img      = din.data() + (ng * cg) * p.in_pixels();
+        const double* dy = dout.data() + ng * kg * pixels;
+        const double* wt = wei_t.data() + (g * rows + r0) * kg;
+        std::vector<double> col(nr * std::min(conv_host_max_tile, pixels));
+        for(std::size_t p0 = 0; p0 < pixels; p0 += conv_host_max_tile)
+        {
+            const std::size_t np = std::min(conv_host_max_tile, pixels - p0);
+            std::fill(col.begin(), col.begin() + nr * np, 0.0);
+            host_gemm_acc(nr, np, kg, wt, kg, dy + p0, pixels, col.data(), np);
+            conv_host_for_each_tap(
+                p, r0, r0 + nr, p0, np, [&](std::size_t r, std::size_t j, std::ptrdiff_t i) {
+                    if(i >= 0)
+                        img[i] += col[(r - r0) * np + j];
+                });
+        }
+    });
+    return din;
+}
+
+// dwei = sum over the batch of dout * im2col(in)^T: the gradient of
+// conv_host_fwd with respect to wei.
+inline std::vector<double> conv_host_bwd_weights(const conv_host_problem& p,
+                                                 const std::vector<double>& in,
+                                                 const std::vector<double>& dout)
+{
+    assert(in.size() == p.in_size() && dout.size() == p.out_size());
+
+    std::vector<double> dwei(p.wei_size());
+    const std::size_t pixels = p.out_pixels();
+    const std::size_t rows   = p.col_rows();
+    const std::size_t kg     = p.group_k();
+
+    // Tasks own disjoint blocks of dwei and walk the batch and pixels in
+    // order, which keeps the reduction deterministic.
+    const std::size_t kblock  = std::min<std::size_t>(kg, 64);
+    const std::size_t kblocks = (kg + kblock - 1) / kblock;
+    const std::size_t rblock  = conv_host_block(p.groups * kblocks, rows, 16, rows);
+    const std::size_t rblocks = (rows + rblock - 1) / rblock;
+    const std::size_t tile    = std::min(conv_host_max_tile, pixels);
+
+    par_for(p.groups * kblocks * rblocks, 1, [&](std::size_t task) {
+        const std::size_t g  = task / (kblocks * rblocks);
+        const std::size_t k0 = (task / rblocks % kblocks) * kblock;
+        const std::size_t nk = std::min(kblock, kg - k0);
+        const std::size_t r0 = (task % rblocks) * rblock;
+        const std::size_t nr = std::min(rblock, rows - r0);
+
+        double* dw = dwei.data() + (g * kg + k0) * rows + r0;
+        std::vector<double> col_t(tile * nr);
+        for(std::size_t b = 0; b < p.n; b++)
+        {
+            const double* img = in.data() + (b * p.groups + g) * p.group_c() * p.in_pixels();
+            const double* dy  = dout.data() + ((b * p.groups + g) * kg + k0) * pixels;
+            for(std::size_t p0 = 0; p0 < pixels; p0 += tile)
+            {
+                const std::size_t np = std::min(tile, pixels - p0);
+                conv_host_for_each_tap(
+                    p, r0, r0 + nr, p0, np, [&](std::size_t r, std::size_t j, std::ptrdiff_t i) {
+                        col_t[j * nr + (r - r0)] = i < 0 ? 0.0 : img[i];
+                    });
+                host_gemm_acc(nk, nr, np, dy + p0, pixels, col_t.data(), nr, dw, rows);
+            }
+        }
+    });
+    return dwei;
+}
+
+// Entry points in terms of the tensors the API sees. Forward and backward data
+// trade places for a transposed convolution, and its weight gradient takes
+// the two activations the other way round.
+inline std::vector<double> conv_host_forward(const conv_host_problem& p,
+                                             bool transposed,
+                                             const std::vector<double>& x,
+                                             const std::vector<double>& w,
+                                             const std::vector<double>& bias = {})
+{
+    if(!transposed)
+        return conv_host_fwd(p, x, w, bias);
+
+    auto y = conv_host_bwd_data(p, x, w);
+    if(!bias.empty())
+    {
+        assert(bias.size() == p.c);
+        for(std::size_t i = 0; i < y.size(); i++)
+            y[i] += bias[i / p.in_pixels() % p.c];
+    }
+    return y;
+}
+
+inline std::vector<double> conv_host_backward_data(const conv_host_problem& p,
+                                                   bool transposed,
+                                                   const std::vector<double>& dy,
+                                                   const std::vector<double>& w)
+{
+    return transposed ? conv_host_fwd(p, dy, w) : conv_host_bwd_data(p, dy, w);
+}
+
+inline std::vector<double> conv_host_backward_weights(const conv_host_problem& p,
+                                                      bool transposed,
+                                                      const std::vector<double>& x,
+                                                      const std::vector<double>& dy)
+{
+    return transposed ? conv_host_bwd_weights(p, dy, x) : conv_host_bwd_weights(p, x, dy);
+}
+
+} // namespace miopen
+
+#endif
@@ -26,6 +26,7 @@
 #ifndef GUARD_MIOPEN_CONVOLUTION_HPP_
 #define GUARD_MIOPEN_CONVOLUTION_HPP_
 
+#include <cstdint>
 #include <functional>
 #include <miopen/common.hpp>
 #include <miopen/conv_algo_name.hpp>
@@ -174,6 +175,21 @@ struct ConvolutionDescriptor : miopenConvolutionDescriptor
                               size_t workSpaceSize,
                               bool timed = false) const;
 
+    // Bytes of the forward filter spectra of TransformFwdFFTFilters
+    size_t ForwardGetFFTFilterSize(const TensorDescriptor& xDesc,
+                                   const TensorDescriptor& yDesc) const;
+
+    // Runs the forward FFT filter kernels on w and copies the spectra they leave in workSpace, of
+    // at least ForwardGetWorkSpaceSizeFFT bytes, to spectra. ExecuteFwdFFTKernel reads them
+    // instead when they are cached for w.
+    void TransformFwdFFTFilters(Handle& handle,
+                                const TensorDescriptor& xDesc,
+                                const TensorDescriptor& wDesc,
+                                ConstData_t w,
+                                const TensorDescriptor& yDesc,
+                                Data_t workSpace,
+                                Data_t spectra) const;
+
     int FindBwdFFTKernel(Handle& handle,
                          const TensorDescriptor& dyDesc,
                          const TensorDescriptor& wDesc,
@@ -215,6 +231,19 @@ struct ConvolutionDescriptor : miopenConvolutionDescriptor
                             Data_t workSpace,
                             size_t workSpaceSize) const;
 
+    // Transforms w for forward convolutions with algo into the filter transform cache of handle,
+    // unless it holds this version already. Those convolutions then skip their filter transform.
+    // workSpace is the one the convolutions get.
+    void PrepareForwardWeights(Handle& handle,
+                               const TensorDescriptor& xDesc,
+                               const TensorDescriptor& wDesc,
+                               ConstData_t w,
+                               const TensorDescriptor& yDesc,
+                               miopenConvFwdAlgorithm_t algo,
+                               std::uint64_t version,
+                               Data_t workSpace,
+                               size_t workSpaceSize) const;
+
     size_t BackwardDataGetWorkSpaceSizeGEMM(Handle& handle,
                                             const TensorDescriptor& wDesc,
                                             const TensorDescriptor& dyDesc) const;
@@ -26,6 +26,9 @@
 #ifndef GUARD_MIOPEN_CONVOLUTION_FFT_HPP_
 #define GUARD_MIOPEN_CONVOLUTION_FFT_HPP_
 
+#include <cstddef>
+#include <vector>
+
 namespace miopen {
 
 struct FFTConvParams
@@ -57,6 +60,91 @@ struct FFTConvParams
     static const int NumKernels       = 7;
 };
 
+// A stride 1, undilated forward convolution of n images of c x h x w by k filters of c x r x s
+struct FFTConvShape
+{
+    int n;
+    int c;
+    int h;
+    int w;
+    int k;
+    int r;
+    int s;
+    int pad_h;
+    int pad_w;
+
+    int OutH() const { return h + 2 * pad_h - r + 1; }
+    int OutW() const { return w + 2 * pad_w - s + 1; }
+};
+
+enum class FFTConvKernel
+{
+    forward_input,  // transform the tiles of images x channels
+    forward_filter, // transform the filters of channels
+    multiply,       // output spectra (+)= input spectra * conj(filter spectra), over channels
+    inverse_output, // transform the output spectra of images back, keeping the valid outputs
+};
+
+struct FFTConvStep
+{
+    FFTConvKernel kernel;
+    int image_begin;
+    int images;
+    int channel_begin;
+    int channels;
+    bool accumulate; // multiply adds to the output spectra of earlier channels
+};
+
+// Byte range of the workspace
+struct FFTConvBuffer
+{
+    std::size_t offset;
+    std::size_t size;
+};
+
+// Overlap-save FFT convolution. The padded input is cut into tiles of length_h x length_w
+// starting every tile_h x tile_w, tile = length - filter + 1. The circular correlation of a tile
+// with the filter is exact on its first tile_h x tile_w outputs, which are kept. Spectra are
+// the length_h x (length_w / 2 + 1) complex floats of a real transform, row major, and the
+// workspace holds
+//   input:  [image of the batch][channel of the batch][tile][spectrum]
+//   filter: [k][channel of the batch][spectrum]
+//   output: [image of the batch][k][tile][spectrum]
+// The steps run in order. With every channel in one batch the filters are transformed once,
+// otherwise again for every image batch.
+struct FFTConvPlan
+{
+    FFTConvShape shape;
+    int length_h;
+    int length_w;
+    int tile_h;
+    int tile_w;
+    int tiles_h;
+    int tiles_w;
+    int image_batch;
+    int channel_batch;
+    FFTConvBuffer input;
+    FFTConvBuffer filter;
+    FFTConvBuffer output;
+    std::vector<FFTConvStep> steps;
+    double flops; // transforms and products
+
+    std::size_t Tiles() const { return std::size_t(tiles_h) * tiles_w; }
+    std::size_t Spectrum() const { return std::size_t(length_h) * (length_w / 2 + 1); }
+    std::size_t Workspace() const { return output.offset + output.size; }
+};
+
+// Plans with the transform length of the fewest flops whose batches fit in workspace_limit
+// bytes, the largest batches for it. Lengths have no prime factors but 2, 3 and 5 and are at
+// most 128, unless the filter is larger. Returns false if nothing fits.
+bool PlanFFTConv(const FFTConvShape& shape, std::size_t workspace_limit, FFTConvPlan& plan);
+// Plans with the given transform length, false if it is shorter than the filter or no batch fits
+bool PlanFFTConv(const FFTConvShape& shape,
+                 std::size_t workspace_limit,
+                 int length_h,
+                 int length_w,
+                 FFTConvPlan& plan);
+
 } // namespace miopen
 
 #endif // GUARD_MIOPEN_CONVOLUTION_FFT_HPP_
@@ -0,0 +1,406 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_CPU_OPS_HPP
+#define GUARD_MIOPEN_CPU_OPS_HPP
+
+#include <miopen/common.hpp>
+#include <miopen/errors.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/tensor.hpp>
+#include <miopen/thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace miopen {
+
+struct ActivationDescriptor;
+struct CheckNumericsResult;
+struct ConvolutionDescriptor;
+struct FusionOpDescriptor;
+struct GemmDescriptor;
+struct LRNDescriptor;
+struct OperatorArgs;
+struct PoolingDescriptor;
+
+// Host implementations of the operations of the CPU backend. Each entry point
+// is called after the descriptors have been validated by the common code, and
+// takes element offsets the way the device kernels do.
+namespace cpu {
+
+// Runs the host operation f for handle, timing it when profiling is enabled.
+template <class F>
+void Run(Handle& handle, F f)
+{
+    if(handle.IsCapturing())
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "Operations of the CPU backend cannot be captured");
+    if(!handle.IsProfilingEnabled())
+    {
+        f();
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<float, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    handle.ResetKernelTime();
+    handle.AccumKernelTime(elapsed.count());
+}
+
+// Calls f(i) for i in [0, n) on the shared thread pool.
+template <class F>
+void ParallelFor(std::size_t n, std::size_t grain, F f)
+{
+    thread_pool::get().parallel_for(n, grain, f);
+}
+
+// Calls f(offsets) for every element of a tensor with the given lengths, where
+// offsets holds the position of the element in each of the N layouts. Rows of
+// the innermost dimension are distributed over the pool.
+template <std::size_t N, class F>
+void ParallelForEach(const TensorDims& lens, const std::array<TensorDims, N>& strides, F f)
+{
+    if(lens.empty())
+        return;
+    const std::size_t dims  = lens.size();
+    const std::size_t inner = lens.back();
+    std::size_t rows        = 1;
+    for(std::size_t d = 0; d + 1 < dims; d++)
+        rows *= lens[d];
+    const std::size_t grain = std::max<std::size_t>(1, 4096 / std::max<std::size_t>(inner, 1));
+    ParallelFor(rows, grain, [&](std::size_t row) {
+        std::array<std::size_t, N> offsets{};
+        std::size_t r = row;
+        for(std::size_t d = dims - 1; d-- > 0;)
+        {
+            const std::size_t i = r % lens[d];
+            r /= lens[d];
+            for(std::size_t k = 0; k < N; k++)
+                offsets[k] += i * strides[k][d];
+        }
+        for(std::size_t i = 0; i < inner; i++)
+        {
+            f(offsets);
+            for(std::size_t k = 0; k < N; k++)
+                offsets[k] += strides[k][dims - 1];
+        }
+    });
+}
+
+void ActivationForward(Handle& handle,
+                       const ActivationDescriptor& desc,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       const TensorDescriptor& yDesc,
+                       Data_t y,
+                       std::size_t xOffset,
+                       std::size_t yOffset);
+
+void ActivationBackward(Handle& handle,
+                        const ActivationDescriptor& desc,
+                        const TensorDescriptor& yDesc,
+                        ConstData_t y,
+                        const TensorDescriptor& dyDesc,
+                        ConstData_t dy,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& dxDesc,
+                        Data_t dx,
+                        std::size_t yOffset,
+                        std::size_t dyOffset,
+                        std::size_t xOffset,
+                        std::size_t dxOffset);
+
+void SoftmaxForward(Handle& handle, const TensorDescriptor& yDesc, Data_t y);
+
+void SoftmaxBackward(Handle& handle,
+                     const TensorDescriptor& yDesc,
+                     ConstData_t y,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx);
+
+void PoolingForward(Handle& handle,
+                    const PoolingDescriptor& desc,
+                    const TensorDescriptor& xDesc,
+                    ConstData_t x,
+                    const TensorDescriptor& yDesc,
+                    Data_t y,
+                    bool do_backward,
+                    Data_t workSpace);
+
+void PoolingBackward(Handle& handle,
+                     const PoolingDescriptor& desc,
+                     const TensorDescriptor& dyDesc,
+                     ConstData_t dy,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx,
+                     ConstData_t workSpace);
+
+void LRNForward(Handle& handle,
+                const LRNDescriptor& desc,
+                const TensorDescriptor& xDesc,
+                ConstData_t x,
+                const TensorDescriptor& yDesc,
+                Data_t y,
+                bool do_backward,
+                Data_t workSpace);
+
+void LRNBackward(Handle& handle,
+                 const LRNDescriptor& desc,
+                 const TensorDescriptor& yDesc,
+                 ConstData_t y,
+                 const TensorDescriptor& dyDesc,
+                 ConstData_t dy,
+                 const TensorDescriptor& xDesc,
+                 ConstData_t x,
+                 const TensorDescriptor& dxDesc,
+                 Data_t dx,
+                 ConstData_t workSpace);
+
+void BatchNormForwardTraining(Handle& handle,
+                              miopenBatchNormMode_t bn_mode,
+                              const TensorDescriptor& xDesc,
+                              ConstData_t x,
+                              const TensorDescriptor& yDesc,
+                              Data_t y,
+                              const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                              ConstData_t bnScale,
+                              ConstData_t bnBias,
+                              double expAvgFactor,
+                              Data_t resultRunningMean,
+                              Data_t resultRunningVariance,
+                              double epsilon,
+                              Data_t resultSaveMean,
+                              Data_t resultSaveInvVariance);
+
+void BatchNormForwardInference(Handle& handle,
+                               miopenBatchNormMode_t bn_mode,
+                               const TensorDescriptor& xDesc,
+                               ConstData_t x,
+                               const TensorDescriptor& yDesc,
+                               Data_t y,
+                               const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                               ConstData_t bnScale,
+                               ConstData_t bnBias,
+                               ConstData_t estimatedMean,
+                               ConstData_t estimatedVariance,
+                               double epsilon);
+
+// y = scale * (x - savedMean) * savedInvVariance + bias, the output of a training pass
+// recomputed from the statistics it saved.
+void BatchNormForwardSaved(Handle& handle,
+                           miopenBatchNormMode_t bn_mode,
+                           const TensorDescriptor& xDesc,
+                           ConstData_t x,
+                           Data_t y,
+                           const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                           ConstData_t bnScale,
+                           ConstData_t bnBias,
+                           ConstData_t savedMean,
+                           ConstData_t savedInvVariance);
+
+void BatchNormBackward(Handle& handle,
+                       miopenBatchNormMode_t bn_mode,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       const TensorDescriptor& dyDesc,
+                       ConstData_t dy,
+                       const TensorDescriptor& dxDesc,
+                       Data_t dx,
+                       const TensorDescriptor& bnScaleBiasDiffDesc,
+                       ConstData_t bnScale,
+                       Data_t resultBnScaleDiff,
+                       Data_t resultBnBiasDiff,
+                       double epsilon,
+                       ConstData_t savedMean,
+                       ConstData_t savedInvVariance);
+
+// Runs Winograd F(4x4, 3x3), or F(2x2, 3x3) for outputs under 4 wide, with algo
+// miopenConvolutionFwdAlgoWinograd where it applies, else a direct convolution.
+void ConvolutionForward(Handle& handle,
+                        const ConvolutionDescriptor& conv,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& wDesc,
+                        ConstData_t w,
+                        const TensorDescriptor& yDesc,
+                        Data_t y,
+                        miopenConvFwdAlgorithm_t algo);
+
+// Packed, undilated float 3x3 convolutions of stride 1
+bool IsWinogradApplicable(const ConvolutionDescriptor& conv,
+                          const TensorDescriptor& xDesc,
+                          const TensorDescriptor& wDesc,
+                          const TensorDescriptor& yDesc);
+// Bytes of the Winograd filters ConvolutionForward reads
+std::size_t GetWinogradFilterSize(const TensorDescriptor& wDesc, const TensorDescriptor& yDesc);
+void TransformWinogradFilters(Handle& handle,
+                              const TensorDescriptor& wDesc,
+                              ConstData_t w,
+                              const TensorDescriptor& yDesc,
+                              Data_t u);
+
+void ConvolutionBackwardData(Handle& handle,
+                             const ConvolutionDescriptor& conv,
+                             const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& wDesc,
+                             ConstData_t w,
+                             const TensorDescriptor& dxDesc,
+                             Data_t dx);
+
+void ConvolutionBackwardWeights(Handle& handle,
+                                const ConvolutionDescriptor& conv,
+                                const TensorDescriptor& dyDesc,
+                                ConstData_t dy,
+                                const TensorDescriptor& xDesc,
+                                ConstData_t x,
+                                const TensorDescriptor& dwDesc,
+                                Data_t dw);
+
+void ConvolutionBackwardBias(Handle& handle,
+                             const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& dbDesc,
+                             Data_t db);
+
+void OpTensor(Handle& handle,
+              miopenTensorOp_t tensorOp,
+              const void* alpha0,
+              const TensorDescriptor& aTensorDesc,
+              ConstData_t ATensor,
+              const void* alpha1,
+              const TensorDescriptor& bTensorDesc,
+              ConstData_t BTensor,
+              const void* beta,
+              const TensorDescriptor& cTensorDesc,
+              Data_t CTensor,
+              std::size_t Aoffset,
+              std::size_t Boffset,
+              std::size_t Coffset);
+
+void SetTensor(
+    Handle& handle, const TensorDescriptor& yDesc, Data_t y, const void* alpha, int offset);
+
+void ScaleTensor(
+    Handle& handle, const TensorDescriptor& yDesc, Data_t y, const void* alpha, int offset);
+
+void CopyTensor(Handle& handle,
+                const TensorDescriptor& srcDesc,
+                ConstData_t src,
+                const TensorDescriptor& dstDesc,
+                Data_t dst,
+                std::size_t srcOffset,
+                std::size_t dstOffset);
+
+void CastTensor(Handle& handle,
+                const void* alpha,
+                const TensorDescriptor& srcDesc,
+                ConstData_t src,
+                const TensorDescriptor& dstDesc,
+                Data_t dst,
+                std::size_t srcOffset,
+                std::size_t dstOffset);
+
+void CopyRows(Handle& handle,
+              ConstData_t src,
+              Data_t dst,
+              ConstData_t rows,
+              int n_rows,
+              int width,
+              int slices,
+              int slice_rows,
+              bool scatter,
+              miopenDataType_t type);
+
+// The layout changes of the 1x1 GEMM convolutions. Only every h_stride-th row
+// and w_stride-th column of the NCHW tensor takes part, and the rest of the
+// destination is left untouched.
+void TransposeNCHW2CNHW(Handle& handle,
+                        int n,
+                        int c,
+                        int h_in,
+                        int w_in,
+                        int h_out,
+                        int w_out,
+                        ConstData_t in,
+                        Data_t out,
+                        int in_offset,
+                        int out_offset,
+                        int h_stride,
+                        int w_stride,
+                        miopenDataType_t type);
+
+void TransposeCNHW2NCHW(Handle& handle,
+                        int n,
+                        int c,
+                        int h_out,
+                        int w_out,
+                        int h_in,
+                        int w_in,
+                        ConstData_t in,
+                        Data_t out,
+                        int in_offset,
+                        int out_offset,
+                        int h_stride,
+                        int w_stride,
+                        miopenDataType_t type);
+
+// Scans n floats for zeros, NaNs and infinities, and fills in their sum,
+// absolute sum, minimum and maximum when stats is set.
+void CheckNumerics(
+    Handle& handle, ConstData_t data, std::size_t n, bool stats, CheckNumericsResult& result);
+
+// C = alpha * op(A) * op(B) + beta * C for one GEMM of gemm_desc, accumulated in
+// double. Offsets are in elements; batch_count and the batch strides are ignored.
+void Gemm(Handle& handle,
+          const GemmDescriptor& gemm_desc,
+          ConstData_t A,
+          std::size_t a_offset,
+          ConstData_t B,
+          std::size_t b_offset,
+          Data_t C,
+          std::size_t c_offset);
+
+// Runs the ops of a fusion plan one after another on the entry points above, reading
+// their arguments from args. output holds the intermediate results.
+void ExecuteFusionPlan(Handle& handle,
+                       const std::vector<std::shared_ptr<FusionOpDescriptor>>& ops,
+                       const TensorDescriptor& inputDesc,
+                       ConstData_t input,
+                       const TensorDescriptor& outputDesc,
+                       Data_t output,
+                       const OperatorArgs& args);
+
+} // namespace cpu
+} // namespace miopen
+
+#endif
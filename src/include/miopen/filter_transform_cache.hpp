@@ -0,0 +1,93 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_FILTER_TRANSFORM_CACHE_HPP_
+#define GUARD_MIOPEN_FILTER_TRANSFORM_CACHE_HPP_
+
+#include <miopen/allocator.hpp>
+#include <miopen/common.hpp>
+#include <miopen/miopen.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace miopen {
+
+struct ProblemDescription;
+
+/// Filters an algorithm transforms on every call, transformed once ahead of time. An entry
+/// belongs to a weight buffer, an algorithm and the forward problem it was transformed for, and
+/// records the version token of the weights it was transformed from. The cache trusts the
+/// caller: weights that change without a new version, or a buffer freed and reused, leave a
+/// stale entry behind until the buffer's entries are erased.
+class FilterTransformCache
+{
+    public:
+    struct Entry
+    {
+        std::uint64_t version;
+        std::size_t size; // bytes
+        Allocator::ManageDataPtr data;
+    };
+
+    /// The entry of buffer, algorithm and problem, nullptr if there is none
+    const Entry* Find(ConstData_t buffer,
+                      miopenConvFwdAlgorithm_t algorithm,
+                      const ProblemDescription& problem) const;
+
+    /// Stores data as the entry of buffer, algorithm and problem, replacing any older one
+    const Entry& Insert(ConstData_t buffer,
+                        miopenConvFwdAlgorithm_t algorithm,
+                        const ProblemDescription& problem,
+                        std::uint64_t version,
+                        Allocator::ManageDataPtr data,
+                        std::size_t size);
+
+    /// Drops every entry of buffer and returns how many there were
+    std::size_t Erase(ConstData_t buffer);
+    void Clear() { entries.clear(); }
+
+    /// Callers check this before building the problem of a lookup, so that the common case of
+    /// no prepared weights costs nothing
+    bool Empty() const { return entries.empty(); }
+    std::size_t Size() const { return entries.size(); }
+    std::size_t Bytes() const;
+
+    private:
+    using Key = std::tuple<const void*, miopenConvFwdAlgorithm_t, std::string>;
+
+    static Key MakeKey(ConstData_t buffer,
+                       miopenConvFwdAlgorithm_t algorithm,
+                       const ProblemDescription& problem);
+
+    std::map<Key, Entry> entries;
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_FILTER_TRANSFORM_CACHE_HPP_
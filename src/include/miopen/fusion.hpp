@@ -229,7 +229,7 @@ struct BatchNormFwdTrainFusionOpDescriptor : FusionOpDescriptor
     std::vector<size_t> GetLocalWGSz(Handle& handle, std::string algorithm_name) override;
     std::vector<size_t> GetGlobalWGSz(Handle& handle, std::string algorithm_name) override;
     void calcBNParams(Handle& handle,
-                      std::vector<size_t> in_lens,
+                      const TensorDims& in_lens,
                       int& variant,
                       size_t& in_cstride,
                       size_t& in_nstride,
@@ -270,7 +270,7 @@ struct BatchNormBwdTrainFusionOpDescriptor : FusionOpDescriptor
     std::vector<size_t> GetLocalWGSz(Handle& handle, std::string algorithm_name) override;
     std::vector<size_t> GetGlobalWGSz(Handle& handle, std::string algorithm_name) override;
     void calcBNParams(Handle& handle,
-                      std::vector<size_t> in_lens,
+                      const TensorDims& in_lens,
                       int& variant,
                       size_t& in_cstride,
                       size_t& in_nstride,
@@ -77,9 +77,9 @@ struct GemmGeometry
                  ConstData_t a,
                  ConstData_t b,
                  Data_t c,
-                 int a_offset,
-                 int b_offset,
-                 int c_offset);
+                 std::size_t a_offset,
+                 std::size_t b_offset,
+                 std::size_t c_offset);
 };
 
 } // namespace miopen
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_GEMM_HOST_HPP
+#define GUARD_MIOPEN_GEMM_HOST_HPP
+
+#include <miopen/thread_pool.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace miopen {
+
+// Block sizes for host_gemm_acc. A kc x nc panel of B (256KiB of doubles) is
+// reused by every row of A, so it is sized to stay resident in L2; each
+// micro-kernel call keeps an mr x nr tile of C in registers.
+static constexpr std::size_t host_gemm_kc = 128;
+static constexpr std::size_t host_gemm_nc = 256;
+static constexpr std::size_t host_gemm_mr = 4;
+static constexpr std::size_t host_gemm_nr = 8;
+
+// c (mb x nb, at most mr x nr) += a * b over kb steps, where a holds mr values
+// and b holds nr values per step. The tile starts from the current contents of
+// c and adds the products in increasing k order, so the result is
+// bit-identical to a naive dot product continued from c.
+inline void host_gemm_micro(std::size_t kb,
+                            const double* a,
+                            const double* b,
+                            double* c,
+                            std::size_t ldc,
+                            std::size_t mb,
+                            std::size_t nb)
+{
+    double acc[host_gemm_mr][host_gemm_nr];
+    for(std::size_t i = 0; i < host_gemm_mr; i++)
+        for(std::size_t j = 0; j < host_gemm_nr; j++)
+            acc[i][j] = (i < mb && j < nb) ? c[i * ldc + j] : 0.0;
+
+    for(std::size_t p = 0; p < kb; p++)
+    {
+        const double* ap = a + p * host_gemm_mr;
+        const double* bp = b + p * host_gemm_nr;
+        for(std::size_t i = 0; i < host_gemm_mr; i++)
+            for(std::size_t j = 0; j < host_gemm_nr; j++)
+                acc[i][j] += ap[i] * bp[j];
+    }
+
+    for(std::size_t i = 0; i < mb; i++)
+        for(std::size_t j = 0; j < nb; j++)
+            c[i * ldc + j] = acc[i][j];
+}
+
+// C += A * B for row-major A (m x k), B (k x n) and C (m x n) with leading
+// dimensions lda, ldb and ldc. Runs on the calling thread.
+inline void host_gemm_acc(std::size_t m,
+                          std::size_t n,
+                          std::size_t k,
+                          const double* a,
+                          std::size_t lda,
+                          const double* b,
+                          std::size_t ldb,
+                          double* c,
+                          std::size_t ldc)
+{
+    const std::size_t mr = host_gemm_mr;
+    const std::size_t nr = host_gemm_nr;
+    std::vector<double> bpack(host_gemm_kc * host_gemm_nc);
+    std::vector<double> apack(host_gemm_kc * mr);
+    for(std::size_t jj = 0; jj < n; jj += host_gemm_nc)
+    {
+        const std::size_t nb     = std::min(host_gemm_nc, n - jj);
+        const std::size_t strips = (nb + nr - 1) / nr;
+        for(std::size_t pp = 0; pp < k; pp += host_gemm_kc)
+        {
+            const std::size_t kb = std::min(host_gemm_kc, k - pp);
+
+            // B panel as nr wide strips, each laid out step by step
+            for(std::size_t s = 0; s < strips; s++)
+            {
+                double* dst = bpack.data() + s * kb * nr;
+                for(std::size_t p = 0; p < kb; p++)
+                {
+                    const double* src = b + (pp + p) * ldb + jj + s * nr;
+                    for(std::size_t j = 0; j < nr; j++)
+                        dst[p * nr + j] = s * nr + j < nb ? src[j] : 0.0;
+                }
+            }
+
+            for(std::size_t i = 0; i < m; i += mr)
+            {
+                const std::size_t mb = std::min(mr, m - i);
+                for(std::size_t p = 0; p < kb; p++)
+                    for(std::size_t r = 0; r < mr; r++)
+                        apack[p * mr + r] = r < mb ? a[(i + r) * lda + pp + p] : 0.0;
+
+                for(std::size_t s = 0; s < strips; s++)
+                {
+                    host_gemm_micro(kb,
+                                    apack.data(),
+                                    bpack.data() + s * kb * nr,
+                                    c + i * ldc + jj + s * nr,
+                                    ldc,
+                                    mb,
+                                    std::min(nr, nb - s * nr));
+                }
+            }
+        }
+    }
+}
+
+// Copies op(X) into a packed row-major rows x cols buffer of doubles, where
+// op transposes X if trans is set.
+template <class T>
+std::vector<double>
+host_gemm_pack(bool trans, std::size_t rows, std::size_t cols, const T* x, std::size_t ldx)
+{
+    std::vector<double> result(rows * cols);
+    if(!trans)
+    {
+        par_for(rows, 1, [&](std::size_t i) {
+            for(std::size_t j = 0; j < cols; j++)
+                result[i * cols + j] = static_cast<double>(x[i * ldx + j]);
+        });
+        return result;
+    }
+    // Transpose in square blocks so both sides stay within a few cache lines
+    const std::size_t bs = 32;
+    par_for((rows + bs - 1) / bs, 1, [&](std::size_t ib) {
+        const std::size_t i0 = ib * bs;
+        const std::size_t i1 = std::min(rows, i0 + bs);
+        for(std::size_t j0 = 0; j0 < cols; j0 += bs)
+        {
+            const std::size_t j1 = std::min(cols, j0 + bs);
+            for(std::size_t j = j0; j < j1; j++)
+                for(std::size_t i = i0; i < i1; i++)
+                    result[i * cols + j] = static_cast<double>(x[j * ldx + i]);
+        }
+    });
+    return result;
+}
+
+// Tile of C owned by one task of host_gemm
+static constexpr std::size_t host_gemm_mt = 32;
+static constexpr std::size_t host_gemm_nt = 512;
+
+// C = alpha * op(A) * op(B) + beta * C with row-major, strided operands. op(A)
+// is m x k and op(B) is k x n. Products are accumulated in double whatever the
+// element types, and C is not read when beta is zero. Tiles of C are spread
+// over par_for.
+template <class TA, class TB, class TC>
+void host_gemm(bool trans_a,
+               bool trans_b,
+               std::size_t m,
+               std::size_t n,
+               std::size_t k,
+               double alpha,
+               const TA* a,
+               std::size_t lda,
+               const TB* b,
+               std::size_t ldb,
+               double beta,
+               TC* c,
+               std::size_t ldc)
+{
+    if(m == 0 || n == 0)
+        return;
+    const auto pa = host_gemm_pack(trans_a, m, k, a, lda);
+    const auto pb = host_gemm_pack(trans_b, k, n, b, ldb);
+
+    const std::size_t mtiles = (m + host_gemm_mt - 1) / host_gemm_mt;
+    const std::size_t ntiles = (n + host_gemm_nt - 1) / host_gemm_nt;
+    par_for(mtiles * ntiles, 1, [&](std::size_t tile) {
+        const std::size_t i0 = (tile / ntiles) * host_gemm_mt;
+        const std::size_t j0 = (tile % ntiles) * host_gemm_nt;
+        const std::size_t mb = std::min(host_gemm_mt, m - i0);
+        const std::size_t nb = std::min(host_gemm_nt, n - j0);
+
+        std::vector<double> acc(mb * nb);
+        host_gemm_acc(mb, nb, k, pa.data() + i0 * k, k, pb.data() + j0, n, acc.data(), nb);
+        for(std::size_t i = 0; i < mb; i++)
+        {
+            TC* row           = c + (i0 + i) * ldc + j0;
+            const double* src = acc.data() + i * nb;
+            for(std::size_t j = 0; j < nb; j++)
+            {
+                const double x = alpha * src[j];
+                row[j] = static_cast<TC>(beta == 0 ? x : x + beta * static_cast<double>(row[j]));
+            }
+        }
+    });
+}
+
+} // namespace miopen
+
+#endif
@@ -68,11 +68,11 @@ struct GemmDescriptor
 miopenStatus_t CallGemm(Handle& handle,
                         GemmDescriptor gemm_desc,
                         ConstData_t A,
-                        int a_offset,
+                        std::size_t a_offset,
                         ConstData_t B,
-                        int b_offset,
+                        std::size_t b_offset,
                         Data_t C,
-                        int c_offset,
+                        std::size_t c_offset,
                         std::string* kcache_key,
                         bool enqueue_dummy_kernel,
                         GemmBackend_t gemm_backend = GemmBackend_t::rocblas);
@@ -80,11 +80,11 @@ miopenStatus_t CallGemm(Handle& handle,
 miopenStatus_t CallGemmStridedBatched(Handle& handle,
                                       GemmDescriptor gemm_desc,
                                       ConstData_t A,
-                                      int a_offset,
+                                      std::size_t a_offset,
                                       ConstData_t B,
-                                      int b_offset,
+                                      std::size_t b_offset,
                                       Data_t C,
-                                      int c_offset,
+                                      std::size_t c_offset,
                                       std::string* kcache_key,
                                       bool enqueue_dummy_kernel,
                                       GemmBackend_t gemm_backend = GemmBackend_t::rocblas);
@@ -93,11 +93,11 @@ miopenStatus_t
 CallGemmStridedBatchedSequential(Handle& handle,
                                  GemmDescriptor gemm_desc,
                                  ConstData_t A,
-                                 int a_offset,
+                                 std::size_t a_offset,
                                  ConstData_t B,
-                                 int b_offset,
+                                 std::size_t b_offset,
                                  Data_t C,
-                                 int c_offset,
+                                 std::size_t c_offset,
                                  std::string* kcache_key,
                                  bool enqueue_dummy_kernel,
                                  GemmBackend_t gemm_backend = GemmBackend_t::rocblas);
@@ -37,6 +37,7 @@
 
 #include <miopen/logger.hpp>
 #include <miopen/handle.hpp>
+#include <miopen/philox.hpp>
 
 namespace miopen {
 namespace solver {
@@ -228,18 +229,15 @@ class HeartBeat
     }
 };
 
-inline void InitRandomly(std::vector<float>& vec, const double offset, const double factor)
+// Fills vec with (u + offset) * factor, u uniform in [0, 1). Buffers of one
+// search differ by stream, and their contents do not depend on the thread count.
+inline void InitRandomly(std::vector<float>& vec,
+                         const std::uint64_t stream,
+                         const double offset = 0.0,
+                         const double factor = 1.0)
 {
-    float* p = vec.data();
-    for(int i = 0; i < vec.size(); ++i)
-        *p++ = static_cast<float>((rand() * (1.0 / RAND_MAX) + offset) * factor);
-}
-
-inline void InitRandomly(std::vector<float>& vec)
-{
-    float* p = vec.data();
-    for(int i = 0; i < vec.size(); ++i)
-        *p++ = static_cast<float>(rand() * (1.0 / RAND_MAX));
+    fill_uniform(
+        vec.data(), vec.size(), offset * factor, (1.0 + offset) * factor, random_stream{0, stream});
 }
 
 inline size_t divide_round_plus_inf(const size_t x, const unsigned y)
@@ -314,13 +312,13 @@ auto GenericSearch(const Solver s,
     std::vector<float> bot(bot_size);
     std::vector<float> wei(wei_size);
     std::vector<float> bias(bias_size);
-    InitRandomly(bot);
+    InitRandomly(bot, 0);
     if(!(context.direction.IsBackwardData() || context.direction.IsForward()))
-        InitRandomly(top);
+        InitRandomly(top, 1);
     if(!context.direction.IsBackwardWrW())
-        InitRandomly(wei, -0.5, 0.001);
+        InitRandomly(wei, 2, -0.5, 0.001);
     if(context.bias)
-        InitRandomly(bias);
+        InitRandomly(bias, 3);
 
     miopen::Handle profile_h;
     auto bot_ocl_buf  = profile_h.Write(bot);
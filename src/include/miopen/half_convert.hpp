@@ -0,0 +1,271 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_HALF_CONVERT_HPP
+#define GUARD_MIOPEN_HALF_CONVERT_HPP
+
+#include <miopen/thread_pool.hpp>
+
+#include <half.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MIOPEN_HALF_CONVERT_F16C 1
+#include <immintrin.h>
+#else
+#define MIOPEN_HALF_CONVERT_F16C 0
+#endif
+
+namespace miopen {
+
+// Conversions between IEEE binary16 and binary32 that round to nearest even,
+// as the F16C instructions do. NaNs keep their sign and the upper payload bits
+// and come out quiet.
+inline std::uint16_t float_to_half_bits(float x)
+{
+    std::uint32_t f;
+    std::memcpy(&f, &x, sizeof(f));
+    const std::uint32_t sign = (f >> 16) & 0x8000u;
+    const std::uint32_t a    = f & 0x7fffffffu;
+
+    std::uint32_t h;
+    if(a > 0x7f800000u)
+    {
+        h = 0x7e00u | ((a >> 13) & 0x3ffu);
+    }
+    // 65520 is halfway between the largest half and the next power of two
+    else if(a >= 0x477ff000u)
+    {
+        h = 0x7c00u;
+    }
+    // Below 2^-25 everything rounds to zero, 2^-25 itself is a tie to zero
+    else if(a <= 0x33000000u)
+    {
+        h = 0;
+    }
+    else if(a < 0x38800000u)
+    {
+        // Denormal halves count multiples of 2^-24
+        const std::uint32_t m     = (a & 0x7fffffu) | 0x800000u;
+        const std::uint32_t shift = 126 - (a >> 23);
+        const std::uint32_t r     = m & ((1u << shift) - 1);
+        const std::uint32_t tie   = 1u << (shift - 1);
+        h                         = m >> shift;
+        h += (r > tie || (r == tie && (h & 1) != 0)) ? 1 : 0;
+    }
+    else
+    {
+        // A carry out of the mantissa correctly bumps the exponent
+        const std::uint32_t r = a & 0x1fffu;
+        h                     = (a >> 13) - (std::uint32_t{127 - 15} << 10);
+        h += (r > 0x1000u || (r == 0x1000u && (h & 1) != 0)) ? 1 : 0;
+    }
+    return static_cast<std::uint16_t>(sign | h);
+}
+
+inline float half_bits_to_float(std::uint16_t h)
+{
+    const std::uint32_t sign = std::uint32_t{h & 0x8000u} << 16;
+    const std::uint32_t e    = (h >> 10) & 0x1fu;
+    const std::uint32_t m    = h & 0x3ffu;
+    std::uint32_t f;
+    if(e == 0x1f)
+        f = sign | 0x7f800000u | (m << 13) | (m != 0 ? 0x400000u : 0);
+    else if(e != 0)
+        f = sign | ((e + 127 - 15) << 23) | (m << 13);
+    else
+    {
+        // Denormals are exact multiples of 2^-24
+        const float x = static_cast<float>(m) * 5.9604644775390625e-8f;
+        std::memcpy(&f, &x, sizeof(f));
+        f |= sign;
+    }
+    float x;
+    std::memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+namespace half_convert_detail {
+
+inline void half_to_float_scalar(const std::uint16_t* in, float* out, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; i++)
+        out[i] = half_bits_to_float(in[i]);
+}
+
+inline void float_to_half_scalar(const float* in, std::uint16_t* out, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; i++)
+        out[i] = float_to_half_bits(in[i]);
+}
+
+#if MIOPEN_HALF_CONVERT_F16C
+// Compiled for F16C regardless of the target flags and only called when the
+// CPU reports the extension.
+__attribute__((target("avx,f16c"))) inline void
+half_to_float_f16c(const std::uint16_t* in, float* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for(; i + 8 <= n; i += 8)
+    {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+    half_to_float_scalar(in + i, out + i, n - i);
+}
+
+__attribute__((target("avx,f16c"))) inline void
+float_to_half_f16c(const float* in, std::uint16_t* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for(; i + 8 <= n; i += 8)
+    {
+        const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+    }
+    float_to_half_scalar(in + i, out + i, n - i);
+}
+
+inline bool has_f16c()
+{
+    static const bool result = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return result;
+}
+#endif
+
+// Elements converted by one task of the thread pool
+static constexpr std::size_t block_size = 1 << 16;
+
+template <class T, class U, class Fast, class Scalar>
+void convert(const T* in, U* out, std::size_t n, bool fast, Fast f, Scalar s)
+{
+    const std::size_t blocks = (n + block_size - 1) / block_size;
+    if(blocks <= 1)
+    {
+        if(fast)
+            f(in, out, n);
+        else
+            s(in, out, n);
+        return;
+    }
+    thread_pool::get().parallel_for(blocks, 1, [&](std::size_t b) {
+        const std::size_t first = b * block_size;
+        const std::size_t count = std::min(block_size, n - first);
+        if(fast)
+            f(in + first, out + first, count);
+        else
+            s(in + first, out + first, count);
+    });
+}
+
+} // namespace half_convert_detail
+
+inline void half_to_float(const std::uint16_t* in, float* out, std::size_t n)
+{
+#if MIOPEN_HALF_CONVERT_F16C
+    half_convert_detail::convert(in,
+                                 out,
+                                 n,
+                                 half_convert_detail::has_f16c(),
+                                 &half_convert_detail::half_to_float_f16c,
+                                 &half_convert_detail::half_to_float_scalar);
+#else
+    half_convert_detail::convert(in,
+                                 out,
+                                 n,
+                                 false,
+                                 &half_convert_detail::half_to_float_scalar,
+                                 &half_convert_detail::half_to_float_scalar);
+#endif
+}
+
+inline void float_to_half(const float* in, std::uint16_t* out, std::size_t n)
+{
+#if MIOPEN_HALF_CONVERT_F16C
+    half_convert_detail::convert(in,
+                                 out,
+                                 n,
+                                 half_convert_detail::has_f16c(),
+                                 &half_convert_detail::float_to_half_f16c,
+                                 &half_convert_detail::float_to_half_scalar);
+#else
+    half_convert_detail::convert(in,
+                                 out,
+                                 n,
+                                 false,
+                                 &half_convert_detail::float_to_half_scalar,
+                                 &half_convert_detail::float_to_half_scalar);
+#endif
+}
+
+static_assert(sizeof(half_float::half) == sizeof(std::uint16_t), "half is not 16 bits wide");
+
+inline void half_to_float(const half_float::half* in, float* out, std::size_t n)
+{
+    half_to_float(reinterpret_cast<const std::uint16_t*>(in), out, n);
+}
+
+inline void float_to_half(const float* in, half_float::half* out, std::size_t n)
+{
+    float_to_half(in, reinterpret_cast<std::uint16_t*>(out), n);
+}
+
+// Converts n values from one buffer to another, in bulk where the types allow
+template <class T, class U>
+void convert_buffer(const T* in, U* out, std::size_t n)
+{
+    std::transform(in, in + n, out, [](T x) { return static_cast<U>(x); });
+}
+
+inline void convert_buffer(const half_float::half* in, float* out, std::size_t n)
+{
+    half_to_float(in, out, n);
+}
+
+inline void convert_buffer(const float* in, half_float::half* out, std::size_t n)
+{
+    float_to_half(in, out, n);
+}
+
+// Widening through float is exact, narrowing from double is left to the
+// generic version to avoid rounding twice.
+inline void convert_buffer(const half_float::half* in, double* out, std::size_t n)
+{
+    float buffer[256];
+    for(std::size_t i = 0; i < n; i += 256)
+    {
+        const std::size_t count = std::min<std::size_t>(256, n - i);
+        half_to_float(in + i, buffer, count);
+        std::copy(buffer, buffer + count, out + i);
+    }
+}
+
+} // namespace miopen
+
+#endif
@@ -32,9 +32,13 @@
 #include <miopen/config.h>
 #include <miopen/common.hpp>
 #include <miopen/kernel.hpp>
+#include <miopen/kernel_timings.hpp>
 #include <miopen/miopen.h>
 #include <miopen/object.hpp>
 #include <miopen/allocator.hpp>
+#include <miopen/allocator_pool.hpp>
+#include <miopen/command_graph.hpp>
+#include <miopen/filter_transform_cache.hpp>
 #include <miopen/simple_hash.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <vector>
@@ -72,6 +76,14 @@ struct Handle : miopenHandle
                       miopenDeallocatorFunction deallocator,
                       void* allocatorContext) const;
 
+    // Optional size-class caching pool layered over the allocator, so buffers that are
+    // repeatedly created and freed (e.g. find-time scratch, RNN workspaces) are reused.
+    // At most max_cached_bytes are held in the cache; buffers in use are not limited.
+    void EnableMemoryPool(std::size_t max_cached_bytes);
+    void DisableMemoryPool();
+    void TrimMemoryPool();
+    AllocatorPoolStats GetMemoryPoolStats() const;
+
     void EnableProfiling(bool enable = true);
 
     void ResetKernelTime();
@@ -80,6 +92,28 @@ struct Handle : miopenHandle
     float GetKernelTime() const;
     bool IsProfilingEnabled() const;
 
+    // Per (algorithm, network_config, kernel_name) timing histograms. Enabled by
+    // default when MIOPEN_ENABLE_KERNEL_TIMINGS is set, in which case they are also
+    // dumped to std::cerr when the handle is destroyed.
+    void EnableKernelTimings(bool enable = true);
+    bool IsKernelTimingsEnabled() const;
+    const KernelTimings& GetKernelTimings() const;
+    void ResetKernelTimings();
+
+    // Filters transformed ahead of the forward convolutions that read them
+    FilterTransformCache& GetFilterTransformCache();
+
+    // Command capture. Between BeginCapture and EndCapture every kernel launched through this
+    // handle still runs, and is also recorded into the returned graph. Pointer arguments equal
+    // to a buffer bound with BindCaptureBuffer are replaced by that slot's buffer on replay.
+    // The graph launches on this handle's queue, so it must not outlive the handle.
+    // The CPU backend launches no kernels and does not support capture: every operation issued
+    // while capturing throws miopenStatusNotImplemented.
+    void BeginCapture();
+    void BindCaptureBuffer(std::size_t slot, ConstData_t buffer);
+    bool IsCapturing() const;
+    CommandGraph EndCapture();
+
     KernelInvoke AddKernel(const std::string& algorithm,
                            const std::string& network_config,
                            const std::string& program_name,
@@ -96,7 +130,9 @@ struct Handle : miopenHandle
     auto GetKernels(const std::string& algorithm, const std::string& network_config)
     {
         return this->GetKernelsImpl(algorithm, network_config) |
-               boost::adaptors::transformed([this](Kernel k) { return this->Run(k); });
+               boost::adaptors::transformed([this, algorithm, network_config](Kernel k) {
+                   return this->Run(k, algorithm, network_config);
+               });
     }
     KernelInvoke GetKernel(const std::string& algorithm, const std::string& network_config)
     {
@@ -106,10 +142,11 @@ struct Handle : miopenHandle
             MIOPEN_THROW("looking for default kernel (does not exist): " + algorithm + ", " +
                          network_config);
         }
-        return this->Run(ks.front());
+        return this->Run(ks.front(), algorithm, network_config);
     }
 
     KernelInvoke Run(Kernel k);
+    KernelInvoke Run(Kernel k, const std::string& algorithm, const std::string& network_config);
     const std::vector<Kernel>& GetKernelsImpl(const std::string& algorithm,
                                               const std::string& network_config);
 
@@ -120,6 +157,8 @@ struct Handle : miopenHandle
 
     std::size_t GetLocalMemorySize();
     std::size_t GetMaxComputeUnits();
+    // Engine clock in MHz, 0 if unknown
+    std::size_t GetMaxClockFrequency();
 
     std::size_t m_MaxMemoryAllocSizeCached = 0;
     std::size_t GetMaxMemoryAllocSize();
@@ -133,7 +172,7 @@ struct Handle : miopenHandle
     WriteTo(const void* data, Allocator::ManageDataPtr& ddata, std::size_t sz);
     void ReadTo(void* data, const Allocator::ManageDataPtr& ddata, std::size_t sz);
     shared<Data_t> CreateSubBuffer(Data_t data, std::size_t offset, std::size_t size);
-#if MIOPEN_BACKEND_HIP
+#if MIOPEN_BACKEND_HIP || MIOPEN_BACKEND_CPU
     shared<ConstData_t> CreateSubBuffer(ConstData_t data, std::size_t offset, std::size_t size);
 #endif
 
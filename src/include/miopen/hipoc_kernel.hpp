@@ -28,6 +28,7 @@
 
 #include <array>
 #include <cassert>
+#include <miopen/command_graph.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/hipoc_program.hpp>
 #include <miopen/stringutils.hpp>
@@ -124,6 +125,8 @@ struct HIPOCKernelInvoke
     std::array<size_t, 3> gdims = {};
     std::string name;
     std::function<void(hipEvent_t, hipEvent_t)> callback;
+    // When set, launches are also appended to the handle's command graph.
+    std::shared_ptr<CommandGraphRecorder> recorder = nullptr;
 
     // Workaround for aggregate types in c++11
     HIPOCKernelInvoke() {}
@@ -138,6 +141,8 @@ struct HIPOCKernelInvoke
     }
     void operator()(std::vector<OpKernelArg>& any_args) const
     {
+        if(recorder != nullptr)
+            Record(any_args);
         char hip_args[256] = {0};
         auto sz_left       = any_args[0].size();
 
@@ -157,14 +162,23 @@ struct HIPOCKernelInvoke
         run(hip_args, sz_left);
     }
 
+    // Packs xs on the stack. Only a capture marshals them, for the graph to keep.
     template <class... Ts>
     void operator()(Ts... xs) const
     {
+        if(recorder != nullptr)
+        {
+            // Same layout as KernelArgs, including the zeroed hidden arguments.
+            std::vector<OpKernelArg> any_args{xs...};
+            any_args.insert(any_args.end(), 6, OpKernelArg(uint64_t{0}));
+            Record(std::move(any_args));
+        }
         KernelArgs<Ts...> args{xs...};
         run(&args, sizeof(args));
     }
 
     void run(void* args, std::size_t size) const;
+    void Record(std::vector<OpKernelArg> args) const;
 
     const std::string& GetName() const { return name; }
 };
@@ -202,6 +216,8 @@ struct HIPOCKernel
 
     HIPOCKernelInvoke Invoke(hipStream_t stream,
                              std::function<void(hipEvent_t, hipEvent_t)> callback = nullptr);
+
+    const std::string& GetName() const { return name; }
 };
 
 } // namespace miopen
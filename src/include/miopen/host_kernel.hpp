@@ -0,0 +1,87 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_HOST_KERNEL_HPP
+#define GUARD_MIOPEN_HOST_KERNEL_HPP
+
+#include <miopen/errors.hpp>
+#include <miopen/op_kernel_args.hpp>
+#include <string>
+#include <vector>
+
+namespace miopen {
+
+// The CPU backend has no device compiler, so a program only remembers what it
+// was built from. Operations the backend supports are computed on the host
+// before any kernel is requested; the remaining paths fail when they launch.
+struct HostProgram
+{
+    std::string name;
+    std::string params;
+};
+
+struct HostKernelInvoke
+{
+    std::string name;
+
+    void operator()(std::vector<OpKernelArg>&) const { Fail(); }
+
+    template <class... Ts>
+    void operator()(Ts...) const
+    {
+        Fail();
+    }
+
+    [[noreturn]] void Fail() const
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "Kernel " + name + " cannot be launched by the CPU backend");
+    }
+
+    const std::string& GetName() const { return name; }
+};
+
+struct HostKernel
+{
+    HostProgram program;
+    std::string name;
+
+    HostKernel() {}
+    HostKernel(HostProgram p,
+               const std::string& kernel_name,
+               const std::vector<size_t>& /*local_dims*/,
+               const std::vector<size_t>& /*global_dims*/)
+        : program(std::move(p)), name(kernel_name)
+    {
+    }
+
+    HostKernelInvoke Invoke() const { return HostKernelInvoke{name}; }
+
+    const std::string& GetName() const { return name; }
+};
+
+} // namespace miopen
+
+#endif
@@ -28,10 +28,13 @@
 
 #include <string>
 
+#include <boost/utility/string_ref.hpp>
 #include <miopen/config.h>
 
 namespace miopen {
 std::string GetKernelSrc(std::string name);
+// Points into the embedded kernel data, so nothing is copied.
+boost::string_ref GetKernelSrcView(const std::string& name);
 } // namespace miopen
 
 #if MIOPEN_BACKEND_OPENCL
@@ -53,6 +56,16 @@ using Kernel       = HIPOCKernel;
 using KernelInvoke = HIPOCKernelInvoke;
 using Program      = HIPOCProgram;
 
+} // namespace miopen
+
+#elif MIOPEN_BACKEND_CPU
+#include <miopen/host_kernel.hpp>
+
+namespace miopen {
+using Kernel       = HostKernel;
+using KernelInvoke = HostKernelInvoke;
+using Program      = HostProgram;
+
 } // namespace miopen
 #endif
 
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_KERNEL_TABLE_HPP_
+#define GUARD_MIOPEN_KERNEL_TABLE_HPP_
+
+#include <boost/utility/string_ref.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+
+namespace miopen {
+
+/// One embedded kernel file, as emitted by addkernels. Names are upper case base names
+/// ("MIOpenSoftmax.cl" is "MIOPENSOFTMAX") and the table is sorted by name.
+struct KernelTableEntry
+{
+    const char* name;
+    const unsigned char* data;
+    std::size_t size;
+
+    boost::string_ref GetSource() const
+    {
+        return {reinterpret_cast<const char*>(data), size};
+    }
+};
+
+constexpr bool KernelNameLess(const char* x, const char* y)
+{
+    while(*x != '\0' && *x == *y)
+    {
+        x++;
+        y++;
+    }
+    return static_cast<unsigned char>(*x) < static_cast<unsigned char>(*y);
+}
+
+template <std::size_t N>
+constexpr bool IsKernelTableSorted(const KernelTableEntry (&table)[N])
+{
+    for(std::size_t i = 1; i < N; i++)
+    {
+        if(!KernelNameLess(table[i - 1].name, table[i].name))
+            return false;
+    }
+    return true;
+}
+
+/// Strips the directory and the extension: "path/MIOpenSoftmax.cl" -> "MIOpenSoftmax".
+inline boost::string_ref KernelBaseName(boost::string_ref path)
+{
+    auto slash = path.find_last_of("/\\");
+    if(slash != boost::string_ref::npos)
+        path.remove_prefix(slash + 1);
+    auto ext = path.rfind('.');
+    if(ext != boost::string_ref::npos)
+        path = path.substr(0, ext);
+    return path;
+}
+
+/// Compares an upper case table name with a base name of any case, without copying either.
+inline int CompareKernelName(const char* table_name, boost::string_ref name)
+{
+    for(auto c : name)
+    {
+        auto x = static_cast<unsigned char>(*table_name);
+        auto y = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(c)));
+        if(x != y)
+            return x < y ? -1 : 1;
+        table_name++;
+    }
+    return *table_name == '\0' ? 0 : 1;
+}
+
+/// Binary search for a kernel file name (with or without directory and extension).
+/// Returns nullptr when there is no such kernel.
+inline const KernelTableEntry*
+FindKernel(const KernelTableEntry* first, const KernelTableEntry* last, boost::string_ref path)
+{
+    auto name = KernelBaseName(path);
+    auto it   = std::lower_bound(
+        first, last, name, [](const KernelTableEntry& e, boost::string_ref n) {
+            return CompareKernelName(e.name, n) < 0;
+        });
+    if(it == last || CompareKernelName(it->name, name) != 0)
+        return nullptr;
+    return it;
+}
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_KERNEL_TABLE_HPP_
@@ -0,0 +1,125 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_KERNEL_TIMINGS_HPP_
+#define GUARD_MIOPEN_KERNEL_TIMINGS_HPP_
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace miopen {
+
+struct KernelTimingKey
+{
+    std::string algorithm;
+    std::string network_config;
+    std::string kernel_name;
+
+    friend bool operator<(const KernelTimingKey& x, const KernelTimingKey& y)
+    {
+        return std::tie(x.algorithm, x.network_config, x.kernel_name) <
+               std::tie(y.algorithm, y.network_config, y.kernel_name);
+    }
+    friend bool operator==(const KernelTimingKey& x, const KernelTimingKey& y)
+    {
+        return std::tie(x.algorithm, x.network_config, x.kernel_name) ==
+               std::tie(y.algorithm, y.network_config, y.kernel_name);
+    }
+};
+
+struct KernelTimingStats
+{
+    std::size_t count = 0;
+    float min         = 0.0f;
+    float p50         = 0.0f;
+    float p99         = 0.0f;
+    float max         = 0.0f;
+    double total      = 0.0;
+};
+
+/// Log-linear histogram of kernel times in milliseconds. Every power of two is
+/// split into sub_buckets linear bins, so quantiles are exact to within
+/// 1/sub_buckets of the reported value while the memory stays bounded by the
+/// number of distinct bins actually hit.
+class KernelTimingHistogram
+{
+    public:
+    static constexpr int sub_buckets = 32;
+
+    void Add(float time);
+
+    std::size_t Count() const { return count; }
+    float Min() const { return min; }
+    float Max() const { return max; }
+    double Total() const { return total; }
+
+    /// Nearest-rank quantile, q in [0, 1]. Returns 0 for an empty histogram.
+    float Quantile(double q) const;
+
+    KernelTimingStats GetStats() const;
+
+    private:
+    static int BucketOf(float time);
+    static float BucketValue(int bucket);
+
+    std::map<int, std::size_t> buckets;
+    std::size_t count = 0;
+    float min         = 0.0f;
+    float max         = 0.0f;
+    double total      = 0.0;
+};
+
+/// Per (algorithm, network_config, kernel_name) timing histograms collected by
+/// Handle when kernel timings are enabled.
+class KernelTimings
+{
+    public:
+    void Record(const KernelTimingKey& key, float time);
+    void Clear() { histograms.clear(); }
+    bool Empty() const { return histograms.empty(); }
+
+    /// Returns empty stats if nothing was recorded for the key.
+    KernelTimingStats Get(const KernelTimingKey& key) const;
+
+    /// All recorded kernels, the most expensive (by total time) first.
+    std::vector<std::pair<KernelTimingKey, KernelTimingStats>> GetAll() const;
+
+    void Dump(std::ostream& os) const;
+    friend std::ostream& operator<<(std::ostream& os, const KernelTimings& t);
+
+    private:
+    std::map<KernelTimingKey, KernelTimingHistogram> histograms;
+};
+
+bool IsKernelTimingsEnabledByEnv();
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_KERNEL_TIMINGS_HPP_
@@ -31,8 +31,18 @@
 #if MIOPEN_USE_MIOPENGEMM
 #include <miopengemm/miogemm.hpp>
 
+#include <cstddef>
+#include <limits>
+
 namespace miopen {
 
+// MIOpenGEMM kernels are built with 32-bit offsets; the wide variant takes 64-bit ones
+// and is only needed when an offset does not fit.
+inline bool MiopengemmNeedsWideOffsets(std::size_t max_offset)
+{
+    return max_offset > std::numeric_limits<unsigned>::max();
+}
+
 void AddMiopengemmSolution(Handle& handle,
                            const std::string& algorithm_name,
                            const std::string& network_config,
@@ -41,18 +51,20 @@ void AddMiopengemmSolution(Handle& handle,
                            ConstData_t B,
                            Data_t C,
                            float time,
-                           bool enforce_determinism);
+                           bool enforce_determinism,
+                           bool wide_offsets);
 
 void RunMiopengemmSolution(Handle& handle,
                            const decltype(handle.GetKernels("_", "_"))& kernels,
                            float alpha,
                            ConstData_t A,
-                           int a_offset,
+                           std::size_t a_offset,
                            ConstData_t B,
-                           int b_offset,
+                           std::size_t b_offset,
                            float beta,
                            Data_t C,
-                           int c_offset);
+                           std::size_t c_offset,
+                           bool wide_offsets);
 
 } // namespace miopen
 #endif // MIOPEN_USE_MIOPENGEMM
@@ -452,7 +452,7 @@ struct mlo_construct_direct2D
                      int depth,
                      int height,
                      int width,
-                     int batch_stride,
+                     size_t batch_stride,
                      int channel_stride,
                      int stride,
                      int w_stride)
@@ -479,7 +479,7 @@ struct mlo_construct_direct2D
                      int depth,
                      int height,
                      int width,
-                     int batch_stride,
+                     size_t batch_stride,
                      int channel_stride,
                      int stride,
                      int w_stride)
@@ -504,7 +504,7 @@ struct mlo_construct_direct2D
                        int depth,
                        int height,
                        int width,
-                       int batch_stride,
+                       size_t batch_stride,
                        int channel_stride,
                        int stride,
                        int w_stride)
@@ -520,10 +520,10 @@ struct mlo_construct_direct2D
                                      stride,
                                      w_stride);
 
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
 
         _out_df_width          = width;
         _out_df_height         = height;
@@ -545,7 +545,7 @@ struct mlo_construct_direct2D
                        int depth,
                        int height,
                        int width,
-                       int batch_stride,
+                       size_t batch_stride,
                        int channel_stride,
                        int stride,
                        int w_stride)
@@ -561,10 +561,10 @@ struct mlo_construct_direct2D
                                      stride,
                                      w_stride);
 
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
 
         _in_df_width          = width;
         _in_df_height         = height;
@@ -613,17 +613,6 @@ struct mlo_construct_direct2D
         return _search_params.mloBuildConf_Key(conf_key);
     }
 
-    // MD: Where is this being used?
-    void getNewInputDescr(std::string& layout,
-                          std::string& data_type,
-                          int& batch,
-                          int& depth,
-                          int& height,
-                          int& width,
-                          int& batch_stride,
-                          int& channel_stride,
-                          int& stride,
-                          int& w_stride);
     // TEMP
     int mloConstructSP2D();
 
@@ -663,19 +652,19 @@ struct mlo_construct_direct2D
     miopen::ConvolutionContext _search_params;
 
     /// \todo <begin> Move these into respective Contexts (norm, pooling, neuron...) --atamazov
-    int _in_df_width          = 0;
-    int _in_df_height         = 0;
-    int _in_df_batch_stride   = 0;
-    int _in_df_channel_stride = 0;
-    int _in_df_stride         = 0;
+    int _in_df_width           = 0;
+    int _in_df_height          = 0;
+    size_t _in_df_batch_stride = 0;
+    int _in_df_channel_stride  = 0;
+    int _in_df_stride          = 0;
     std::string _in_df_layout;
     std::string _in_df_data_type;
 
-    int _out_df_width          = 0;
-    int _out_df_height         = 0;
-    int _out_df_batch_stride   = 0;
-    int _out_df_channel_stride = 0;
-    int _out_df_stride         = 0;
+    int _out_df_width           = 0;
+    int _out_df_height          = 0;
+    size_t _out_df_batch_stride = 0;
+    int _out_df_channel_stride  = 0;
+    int _out_df_stride          = 0;
     std::string _out_df_layout;
     std::string _out_df_data_type;
 
@@ -39,6 +39,7 @@
 #include <vector>
 
 #include <miopen/clhelper.hpp>
+#include <miopen/command_graph.hpp>
 #include <miopen/each_args.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/op_kernel_args.hpp>
@@ -91,13 +92,17 @@ struct OCLKernelInvoke
     std::array<size_t, 3> global_work_dim    = {};
     std::array<size_t, 3> local_work_dim     = {};
     std::function<void(cl_event&)> callback;
+    // When set, launches are also appended to the handle's command graph.
+    std::shared_ptr<CommandGraphRecorder> recorder = nullptr;
 
-    void operator()(std::vector<OpKernelArg> args) const
+    void operator()(const std::vector<OpKernelArg>& args) const
     {
+        if(recorder != nullptr)
+            Record(args);
         for(size_t idx = 0; idx < args.size(); idx++)
         {
-            auto arg      = args[idx];
-            cl_int status = clSetKernelArg(
+            const auto& arg = args[idx];
+            cl_int status   = clSetKernelArg(
                 kernel.get(), idx, arg.size(), reinterpret_cast<const void*>(&arg.buffer[0]));
             if(status != CL_SUCCESS)
             {
@@ -109,9 +114,12 @@ struct OCLKernelInvoke
         run();
     }
 
+    // Sets the arguments straight from xs. Only a capture marshals them, for the graph to keep.
     template <class... Ts>
     void operator()(const Ts&... xs) const
     {
+        if(recorder != nullptr)
+            Record({xs...});
         each_args_i(
             std::bind(
                 OCLSetKernelArg{}, kernel.get(), std::placeholders::_1, std::placeholders::_2),
@@ -120,6 +128,7 @@ struct OCLKernelInvoke
     }
 
     void run() const;
+    void Record(std::vector<OpKernelArg> args) const;
     std::string GetName() const;
 };
 
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_PHILOX_HPP
+#define GUARD_MIOPEN_PHILOX_HPP
+
+#include <miopen/thread_pool.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace miopen {
+
+// The Philox4x32-10 counter-based generator of Salmon et al., "Parallel Random
+// Numbers: As Easy as 1, 2, 3". Every output block is a pure function of a
+// 128-bit counter and a 64-bit key.
+struct philox4x32
+{
+    using block = std::array<std::uint32_t, 4>;
+    using key   = std::array<std::uint32_t, 2>;
+
+    static block generate(block ctr, key k)
+    {
+        for(int round = 0; round < 10; round++)
+        {
+            if(round > 0)
+            {
+                k[0] += 0x9E3779B9u;
+                k[1] += 0xBB67AE85u;
+            }
+            const std::uint64_t p0 = std::uint64_t{0xD2511F53u} * ctr[0];
+            const std::uint64_t p1 = std::uint64_t{0xCD9E8D57u} * ctr[2];
+
+            ctr = {{static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k[0],
+                    static_cast<std::uint32_t>(p1),
+                    static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k[1],
+                    static_cast<std::uint32_t>(p0)}};
+        }
+        return ctr;
+    }
+};
+
+// The random numbers of the elements of one buffer. Element i draws from the
+// counter (i, stream) under the key seed, so its value does not depend on the
+// order in which elements are generated or on the number of threads.
+struct random_stream
+{
+    std::uint64_t seed   = 0;
+    std::uint64_t stream = 0;
+
+    philox4x32::block bits(std::uint64_t i) const
+    {
+        return philox4x32::generate({{static_cast<std::uint32_t>(i),
+                                      static_cast<std::uint32_t>(i >> 32),
+                                      static_cast<std::uint32_t>(stream),
+                                      static_cast<std::uint32_t>(stream >> 32)}},
+                                    {{static_cast<std::uint32_t>(seed),
+                                      static_cast<std::uint32_t>(seed >> 32)}});
+    }
+
+    // Uniform in [0, 1) with 53 random bits.
+    double uniform(std::uint64_t i) const
+    {
+        const auto b = bits(i);
+        return ((b[0] >> 5) * 67108864.0 + (b[1] >> 6)) * (1.0 / 9007199254740992.0);
+    }
+
+    double uniform(std::uint64_t i, double lo, double hi) const
+    {
+        return lo + (hi - lo) * uniform(i);
+    }
+
+    // Standard normal, by the Box-Muller transform of the two other words.
+    double normal(std::uint64_t i) const
+    {
+        const auto b        = bits(i);
+        const double u1     = (b[2] + 0.5) * (1.0 / 4294967296.0);
+        const double u2     = b[3] * (1.0 / 4294967296.0);
+        const double two_pi = 6.283185307179586;
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(two_pi * u2);
+    }
+};
+
+// Sets data[i] to f(i) for i in [0, n) on the shared thread pool.
+template <class T, class F>
+void parallel_generate(T* data, std::size_t n, F f)
+{
+    thread_pool::get().parallel_for(
+        n, 4096, [&](std::size_t i) { data[i] = static_cast<T>(f(i)); });
+}
+
+template <class T>
+void fill_uniform(T* data, std::size_t n, double lo, double hi, random_stream rs)
+{
+    parallel_generate(data, n, [&](std::size_t i) { return rs.uniform(i, lo, hi); });
+}
+
+template <class T>
+void fill_normal(T* data, std::size_t n, double mean, double stddev, random_stream rs)
+{
+    parallel_generate(data, n, [&](std::size_t i) { return mean + stddev * rs.normal(i); });
+}
+
+} // namespace miopen
+
+#endif
@@ -42,7 +42,8 @@ template <class TTo, class TFunc>
 size_t SetDescFromMLDesc(TTo& to, const TensorDescriptor& tensor, const TFunc method)
 {
     int n, c, h, w;
-    int ns, cs, hs, ws;
+    int cs, hs, ws;
+    std::size_t ns;
 
     std::tie(n, c, h, w)     = miopen::tien<4>(tensor.GetLengths(), 1);
     std::tie(ns, cs, hs, ws) = miopen::tien<4>(tensor.GetStrides(), 0);
@@ -78,19 +79,19 @@ struct ProblemDescription
     std::string weights_layout;
     std::string out_data_type;
     std::string out_layout;
-    int float_size         = 32;
-    size_t bot_sz          = 0;
-    size_t top_sz          = 0;
-    size_t weights_sz      = 0;
-    size_t bias_sz         = 0;
-    int deconvolution      = 0;
-    int in_stride          = 0;
-    int out_stride         = 0;
-    int in_channel_stride  = 0;
-    int in_batch_stride    = 0;
-    int out_channel_stride = 0;
-    int out_batch_stride   = 0;
-    int group_counts       = 0;
+    int float_size          = 32;
+    size_t bot_sz           = 0;
+    size_t top_sz           = 0;
+    size_t weights_sz       = 0;
+    size_t bias_sz          = 0;
+    int deconvolution       = 0;
+    int in_stride           = 0;
+    int out_stride          = 0;
+    int in_channel_stride   = 0;
+    size_t in_batch_stride  = 0;
+    int out_channel_stride  = 0;
+    size_t out_batch_stride = 0;
+    int group_counts        = 0;
     struct Mode
     {
         miopenConvolutionMode_t val = miopenConvolution;
@@ -189,17 +190,17 @@ struct ProblemDescription
                      int depth,
                      int height,
                      int width,
-                     int batch_stride,
+                     size_t batch_stride,
                      int channel_stride,
                      int stride,
                      int w_stride)
     {
-        batch_sz     = batch;
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        float_size   = (data_type == "FP32" ? 32 : 16);
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        batch_sz        = batch;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        float_size      = (data_type == "FP32" ? 32 : 16);
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
 
         out_width          = width;
         out_height         = height;
@@ -223,17 +224,17 @@ struct ProblemDescription
                      int depth,
                      int height,
                      int width,
-                     int batch_stride,
+                     size_t batch_stride,
                      int channel_stride,
                      int stride,
                      int w_stride)
     {
-        batch_sz     = batch;
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        float_size   = (data_type == "FP32" ? 32 : 16);
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        batch_sz        = batch;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        float_size      = (data_type == "FP32" ? 32 : 16);
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
 
         in_width          = width;
         in_height         = height;
@@ -256,7 +257,7 @@ struct ProblemDescription
                        int depth,
                        int /*height*/,
                        int /*width*/,
-                       int /*batch_stride*/,
+                       size_t /*batch_stride*/,
                        int /*channel_stride*/,
                        int /*stride*/,
                        int /*w_stride*/)
@@ -276,7 +277,7 @@ struct ProblemDescription
                        int depth,
                        int /*height*/,
                        int /*width*/,
-                       int /*batch_stride*/,
+                       size_t /*batch_stride*/,
                        int /*channel_stride*/,
                        int /*stride*/,
                        int /*w_stride*/)
@@ -303,18 +304,18 @@ struct ProblemDescription
                          int depth,
                          int height,
                          int width,
-                         int batch_stride,
+                         size_t batch_stride,
                          int channel_stride,
                          int stride,
                          int w_stride)
     {
-        kernel_size0 = width;
-        kernel_size1 = height;
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        float_size   = (data_type == "FP32" ? 32 : 16);
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        kernel_size0    = width;
+        kernel_size1    = height;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        float_size      = (data_type == "FP32" ? 32 : 16);
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
         weights_sz = size;
     }
 
@@ -327,17 +328,17 @@ struct ProblemDescription
                         int depth,
                         int height,
                         int width,
-                        int batch_stride,
+                        size_t batch_stride,
                         int channel_stride,
                         int stride,
                         int w_stride)
     {
-        batch_sz     = batch;
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        float_size   = (data_type == "FP32" ? 32 : 16);
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        batch_sz        = batch;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        float_size      = (data_type == "FP32" ? 32 : 16);
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
         if(direction.IsForward())
         {
 
@@ -377,17 +378,17 @@ struct ProblemDescription
                        int depth,
                        int height,
                        int width,
-                       int batch_stride,
+                       size_t batch_stride,
                        int channel_stride,
                        int stride,
                        int w_stride)
     {
-        batch_sz     = batch;
-        int data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
-        float_size   = (data_type == "FP32" ? 32 : 16);
-        size_t size  = (layout == "NCHW")
-                          ? batch * depth * height * width * data_len
-                          : batch * batch_stride * channel_stride * stride * w_stride * data_len;
+        batch_sz        = batch;
+        size_t data_len = (data_type == "FP16") ? 2 : (data_type == "FP32") ? 4 : 8;
+        float_size      = (data_type == "FP32" ? 32 : 16);
+        size_t size     = (layout == "NCHW")
+                          ? data_len * batch * depth * height * width
+                          : data_len * batch * batch_stride * channel_stride * stride * w_stride;
         if(direction.IsForward())
         {
 
@@ -34,6 +34,9 @@
 #include <miopen/perf_field.hpp>
 #include <miopen/tensor_ops.hpp>
 #include <miopen/mlo_internal.hpp>
+#include <miopen/rnn_packing.hpp>
+#include <miopen/rnn_plan.hpp>
+#include <miopen/rnn_weights.hpp>
 #include <functional>
 #include <numeric>
 #include <map>
@@ -85,6 +88,36 @@ struct RNNDescriptor : miopenRNNDescriptor
     miopenRNNBiasMode_t biasMode;
     miopenDataType_t dataType;
     std::size_t typeSize;
+    miopenRNNWeightLayout_t weightLayout = miopenRNNWeightsCanonical;
+
+    // Operation lists of the RNN calls, built once per shape and shared by copies
+    std::shared_ptr<RNNPlanCache> plans = std::make_shared<RNNPlanCache>();
+
+    RNNPlanShape PlanShape(RNNPlanShape::Pass pass,
+                           miopenDataType_t dtype,
+                           std::vector<int> batches,
+                           int in_h,
+                           int hy_d,
+                           int hy_n,
+                           int hy_h,
+                           int out_h) const;
+
+    // The weight matrices of the parameter buffer for inputs like xDesc
+    RNNWeightLayout WeightLayout(const TensorDescriptor& xDesc) const;
+
+    // Converts a whole parameter buffer between the canonical and the packed weight layout
+    void PackWeights(Handle& handle,
+                     const TensorDescriptor& xDesc,
+                     const TensorDescriptor& wDesc,
+                     ConstData_t src,
+                     Data_t dst,
+                     bool pack) const;
+
+    // Descriptor of a parameter matrix in packed weights, strided over the transposed block.
+    // poffset is its canonical offset on entry and its packed offset on return.
+    TensorDescriptor PackedParamDescriptor(const TensorDescriptor& xDesc,
+                                           const std::vector<int>& pDims,
+                                           size_t& poffset) const;
 
     size_t biasOffsetCalculation(const TensorDescriptor& xDesc, int layer, int biasID);
 
@@ -208,6 +241,36 @@ struct RNNDescriptor : miopenRNNDescriptor
                              Data_t workSpace,
                              size_t workSpaceSize) const;
 
+    // Workspace of RNNForwardInferenceUnsorted: the workspace of the packed batch followed by
+    // the packed copies of x, y and the hidden states
+    size_t GetUnsortedWorkspaceSize(Handle& handle,
+                                    int seqLen,
+                                    c_array_view<const miopenTensorDescriptor_t> xDesc,
+                                    const std::vector<int>& lengths) const;
+
+    // RNNForwardInference over a padded batch in any order, every time step holds the whole
+    // batch and sample b is lengths[b] steps long. y is zero past the end of each sequence,
+    // hy and cy hold the state after its last step.
+    void RNNForwardInferenceUnsorted(Handle& handle,
+                                     int seqLen,
+                                     c_array_view<const miopenTensorDescriptor_t> xDesc,
+                                     const std::vector<int>& lengths,
+                                     ConstData_t x,
+                                     const TensorDescriptor& hxDesc,
+                                     ConstData_t hx,
+                                     const TensorDescriptor& cxDesc,
+                                     ConstData_t cx,
+                                     const TensorDescriptor& wDesc,
+                                     ConstData_t w,
+                                     c_array_view<const miopenTensorDescriptor_t> yDesc,
+                                     Data_t y,
+                                     const TensorDescriptor& hyDesc,
+                                     Data_t hy,
+                                     const TensorDescriptor& cyDesc,
+                                     Data_t cy,
+                                     Data_t workSpace,
+                                     size_t workSpaceSize) const;
+
     void RNNBackwardData(Handle& handle,
                          int seqLen,
                          c_array_view<const miopenTensorDescriptor_t> yDesc,
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_RNN_OFFSETS_HPP
+#define GUARD_MIOPEN_RNN_OFFSETS_HPP
+
+#include <cstddef>
+
+namespace miopen {
+
+// Element offsets into the weight, workspace and hidden state buffers of the GEMM based RNN
+// layers, computed in 64 bits. The workspace holds one block of batch_n rows per layer, a row
+// is hy_stride wide. The weights of a layer are its input rows followed by its hidden rows,
+// each row wei_stride wide, and the biases of all layers follow the weights.
+struct RNNOffsets
+{
+    std::size_t in_h;       // input vector size, 0 in skip input mode
+    std::size_t hy_h;       // hidden size
+    std::size_t bi;         // 2 if bidirectional, 1 otherwise
+    std::size_t n_layers;   // layers per direction
+    std::size_t batch_n;    // sum of the batch sizes of all time steps
+    std::size_t hy_n;       // batch size of the first time step
+    std::size_t hy_stride;  // workspace row
+    std::size_t wei_stride; // weight row
+
+    RNNOffsets(std::size_t in_h_,
+               std::size_t hy_h_,
+               std::size_t bi_,
+               std::size_t n_layers_,
+               std::size_t batch_n_,
+               std::size_t hy_n_,
+               std::size_t hy_stride_,
+               std::size_t wei_stride_)
+        : in_h(in_h_),
+          hy_h(hy_h_),
+          bi(bi_),
+          n_layers(n_layers_),
+          batch_n(batch_n_),
+          hy_n(hy_n_),
+          hy_stride(hy_stride_),
+          wei_stride(wei_stride_)
+    {
+    }
+
+    // Row `batch` of the workspace block of layer li
+    std::size_t Hidden(std::size_t li, std::size_t batch = 0) const
+    {
+        return (li * batch_n + batch) * hy_stride;
+    }
+
+    // Hidden state of layer li in hx, cx, hy and cy
+    std::size_t HiddenState(std::size_t li) const { return li * hy_n * hy_h * bi; }
+
+    // Input weights of layer li, the first layer starts the buffer
+    std::size_t InputWeights(std::size_t li) const
+    {
+        return li == 0 ? 0 : (in_h + hy_h + (li - 1) * (bi * hy_h + hy_h)) * wei_stride;
+    }
+
+    // Hidden (recurrent) weights of layer li
+    std::size_t HiddenWeights(std::size_t li) const
+    {
+        return (in_h + li * (bi * hy_h + hy_h)) * wei_stride;
+    }
+
+    // Input bias of layer li, its hidden bias is the next weight row
+    std::size_t Bias(std::size_t li) const
+    {
+        return (in_h + hy_h + (bi * hy_h + hy_h) * (n_layers - 1) + 2 * li) * wei_stride;
+    }
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_RNN_OFFSETS_HPP
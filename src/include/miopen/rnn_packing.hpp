@@ -0,0 +1,125 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_RNN_PACKING_HPP
+#define GUARD_MIOPEN_RNN_PACKING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace miopen {
+
+// Maps a batch of variable-length sequences between the caller's padded layout and the packed
+// layout of the RNN calls. The padded layout is time major with the samples in caller order,
+// row t * batch + sample. The packed layout orders the samples by decreasing length, so every
+// time step holds a prefix of the batch: rows of step t start at the sum of the earlier batch
+// sizes. Hidden states keep one row per sample in each layer slice, permuted the same way.
+struct RNNSequencePacking
+{
+    // Contiguous rows that move together between the two layouts
+    struct Run
+    {
+        std::size_t packed;
+        std::size_t padded;
+        std::size_t rows;
+    };
+
+    std::vector<int> lengths;       // of each sample, in caller order
+    std::vector<int> order;         // sample held by each packed slot, longest first
+    std::vector<int> batches;       // packed batch size of each time step
+    std::vector<Run> sequence_runs; // rows of x and y
+    std::vector<Run> state_runs;    // rows of one layer slice of hx, cx, hy and cy
+
+    explicit RNNSequencePacking(std::vector<int> sequence_lengths);
+
+    int BatchSize() const { return static_cast<int>(lengths.size()); }
+    int SeqLen() const { return static_cast<int>(batches.size()); }
+    std::size_t PackedRows() const;
+
+    // True if the packed layout is a prefix of the padded one, so x and y need no copies
+    bool IsPacked() const { return sequence_runs.size() == 1 && sequence_runs[0].padded == 0; }
+
+    // True if the samples are already longest first, so hidden states need no permutation
+    bool IsSorted() const { return state_runs.size() == 1; }
+
+    // Padded row of every packed row of runs, the row index of the device copies
+    static std::vector<int> PaddedRows(const std::vector<Run>& runs);
+
+    // Host versions of the copies, rows are width elements. Unpack leaves the padding of y
+    // untouched.
+    template <class T>
+    void Pack(const T* padded, T* packed, std::size_t width) const
+    {
+        Copy(sequence_runs, width, [&](const Run& r, std::size_t n) {
+            std::copy_n(padded + r.padded * width, n, packed + r.packed * width);
+        });
+    }
+
+    template <class T>
+    void Unpack(const T* packed, T* padded, std::size_t width) const
+    {
+        Copy(sequence_runs, width, [&](const Run& r, std::size_t n) {
+            std::copy_n(packed + r.packed * width, n, padded + r.padded * width);
+        });
+    }
+
+    // States hold `slices` layer slices of BatchSize() rows
+    template <class T>
+    void PackStates(const T* states, T* packed, std::size_t slices, std::size_t width) const
+    {
+        CopyStates(slices, width, [&](const Run& r, std::size_t offset, std::size_t n) {
+            std::copy_n(states + offset + r.padded * width, n, packed + offset + r.packed * width);
+        });
+    }
+
+    template <class T>
+    void UnpackStates(const T* packed, T* states, std::size_t slices, std::size_t width) const
+    {
+        CopyStates(slices, width, [&](const Run& r, std::size_t offset, std::size_t n) {
+            std::copy_n(packed + offset + r.packed * width, n, states + offset + r.padded * width);
+        });
+    }
+
+    private:
+    template <class F>
+    static void Copy(const std::vector<Run>& runs, std::size_t width, F f)
+    {
+        for(const auto& r : runs)
+            f(r, r.rows * width);
+    }
+
+    template <class F>
+    void CopyStates(std::size_t slices, std::size_t width, F f) const
+    {
+        const std::size_t slice = lengths.size() * width;
+        for(std::size_t s = 0; s < slices; s++)
+            Copy(state_runs, width, [&](const Run& r, std::size_t n) { f(r, s * slice, n); });
+    }
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_RNN_PACKING_HPP
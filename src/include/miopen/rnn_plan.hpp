@@ -0,0 +1,238 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_RNN_PLAN_HPP
+#define GUARD_MIOPEN_RNN_PLAN_HPP
+
+#include <miopen/activ.hpp>
+#include <miopen/common.hpp>
+#include <miopen/gemm_v2.hpp>
+#include <miopen/miopen.h>
+#include <miopen/tensor.hpp>
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace miopen {
+
+struct Handle;
+struct RNNPlanShape;
+struct RNNSchedule;
+
+// The operations one RNN call issues, resolved once for a given shape. Every operation holds
+// its descriptors and element offsets; the buffers are named and only bound when the plan runs.
+struct RNNPlan
+{
+    enum Buffer
+    {
+        x,
+        hx,
+        cx,
+        w,
+        y,
+        hy,
+        cy,
+        dx,
+        dhx,
+        dcx,
+        dw,
+        dy,
+        dhy,
+        dcy,
+        workSpace,
+        reserveSpace,
+        buffer_count,
+    };
+
+    enum Kind
+    {
+        set,                 // c = beta
+        gemm,                // c = a * b (GemmDescriptor)
+        tensor_op,           // c = op(alpha0 * a, alpha1 * b) + beta * c
+        copy,                // c = a
+        activation_forward,  // c = activ(a)
+        activation_backward, // d = activ'(c) * b, a is the activation output
+    };
+
+    struct Operand
+    {
+        Buffer buffer      = buffer_count;
+        std::size_t offset = 0;
+        TensorDescriptor desc;
+    };
+
+    struct Op
+    {
+        Kind kind;
+        Operand a, b, c, d;
+        GemmDescriptor gemm_desc;
+        miopenTensorOp_t tensor_op;
+        ActivationDescriptor activ_desc;
+        float alpha0, alpha1, beta;
+    };
+
+    // The device buffers of one call. Outputs may also be read.
+    class Buffers
+    {
+        public:
+        void Input(Buffer b, ConstData_t p);
+        void Output(Buffer b, Data_t p);
+
+        ConstData_t Read(Buffer b) const;
+        Data_t Write(Buffer b) const;
+        // The buffers that are not null
+        std::bitset<buffer_count> Bound() const;
+
+        private:
+        std::array<ConstData_t, buffer_count> inputs{};
+        std::array<Data_t, buffer_count> outputs{};
+    };
+
+    std::vector<Op> ops;
+    // The operations spread over RNNQueueCount() queues, set by RNNPlanCache when that is more
+    // than one
+    std::shared_ptr<const RNNSchedule> schedule;
+
+    void Set(const TensorDescriptor& cDesc, Buffer c, float value);
+    void Gemm(const GemmDescriptor& gemm_desc,
+              Buffer a,
+              std::size_t a_offset,
+              Buffer b,
+              std::size_t b_offset,
+              Buffer c,
+              std::size_t c_offset);
+    void Tensor(miopenTensorOp_t tensor_op,
+                float alpha0,
+                const TensorDescriptor& aDesc,
+                Buffer a,
+                float alpha1,
+                const TensorDescriptor& bDesc,
+                Buffer b,
+                float beta,
+                const TensorDescriptor& cDesc,
+                Buffer c,
+                std::size_t a_offset,
+                std::size_t b_offset,
+                std::size_t c_offset);
+    void Copy(const TensorDescriptor& aDesc,
+              Buffer a,
+              const TensorDescriptor& cDesc,
+              Buffer c,
+              std::size_t a_offset,
+              std::size_t c_offset);
+    void ActivationForward(const ActivationDescriptor& activ_desc,
+                           float alpha,
+                           const TensorDescriptor& aDesc,
+                           Buffer a,
+                           float beta,
+                           const TensorDescriptor& cDesc,
+                           Buffer c,
+                           std::size_t a_offset,
+                           std::size_t c_offset);
+    void ActivationBackward(const ActivationDescriptor& activ_desc,
+                            float alpha,
+                            const TensorDescriptor& aDesc,
+                            Buffer a,
+                            const TensorDescriptor& bDesc,
+                            Buffer b,
+                            const TensorDescriptor& cDesc,
+                            Buffer c,
+                            float beta,
+                            const TensorDescriptor& dDesc,
+                            Buffer d,
+                            std::size_t a_offset,
+                            std::size_t b_offset,
+                            std::size_t c_offset,
+                            std::size_t d_offset);
+
+    // Issues every operation, over the queues of schedule if there is one, implemented by the
+    // backend. A profiled or capturing handle runs the operations in order on its own queue.
+    void Run(Handle& handle, const Buffers& buffers) const;
+
+    // Resolves the operations of shape.pass, the backend independent part of a plan.
+    static RNNPlan Build(const RNNPlanShape& shape);
+};
+
+// Everything that decides the operations of an RNN call: the descriptor settings, the batch
+// size of every time step, the tensor sizes and which of the optional buffers are given.
+struct RNNPlanShape
+{
+    enum Pass
+    {
+        forward_inference,
+        forward_training,
+        backward_data,
+        backward_weights,
+    };
+
+    Pass pass;
+    miopenRNNMode_t rnn_mode;
+    miopenRNNInputMode_t input_mode;
+    miopenRNNDirectionMode_t dir_mode;
+    miopenRNNBiasMode_t bias_mode;
+    int n_layers;
+    int hidden_tensors; // nHiddenTensorsPerLayer
+    int workspace_scale;
+    miopenRNNWeightLayout_t weight_layout;
+    miopenDataType_t data_type;
+    std::vector<int> batches; // one per time step
+    int in_h;
+    int hy_d;
+    int hy_n;
+    int hy_h;
+    int out_h;
+    std::size_t workspace_elements;
+    std::size_t reserve_elements;
+    std::size_t dw_elements;
+    std::bitset<RNNPlan::buffer_count> given;
+
+    int SeqLen() const { return static_cast<int>(batches.size()); }
+    bool Given(RNNPlan::Buffer b) const { return given.test(b); }
+};
+
+bool operator==(const RNNPlanShape& a, const RNNPlanShape& b);
+
+// The plans built for one RNNDescriptor, most recently used first.
+class RNNPlanCache
+{
+    public:
+    static constexpr std::size_t capacity = 16;
+
+    std::shared_ptr<const RNNPlan> Get(const RNNPlanShape& shape);
+    std::size_t Size() const;
+
+    private:
+    mutable std::mutex mutex;
+    std::vector<std::pair<RNNPlanShape, std::shared_ptr<const RNNPlan>>> plans;
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_RNN_PLAN_HPP
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_RNN_SCHEDULE_HPP
+#define GUARD_MIOPEN_RNN_SCHEDULE_HPP
+
+#include <miopen/rnn_plan.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace miopen {
+
+// Splits every operation of the plan that covers rows of several time steps of x, y, dx, dy or
+// a workspace block into one operation per time step. Layer l at step t then only waits for
+// the rows of (l - 1, t) and (l, t - 1) instead of the whole previous layer.
+RNNPlan SplitTimeSteps(const RNNPlan& plan, const RNNPlanShape& shape);
+
+// For every operation, the earlier operations it must wait for: those writing a region it
+// reads or writes, and those reading a region it writes.
+std::vector<std::vector<std::size_t>> RNNPlanDependencies(const RNNPlan& plan);
+
+// Receives the commands of a schedule, in an order that is valid to issue them in
+struct RNNScheduleExecutor
+{
+    virtual ~RNNScheduleExecutor() = default;
+    // Appends operation op to queue, a queue runs its operations in order
+    virtual void Enqueue(std::size_t queue, std::size_t op) = 0;
+    // Work enqueued later on queue waits until op, enqueued before on another queue, completed
+    virtual void Wait(std::size_t queue, std::size_t op) = 0;
+};
+
+// A wavefront schedule of an RNN plan over several queues. Ready operations are dispatched by
+// the length of the longest dependency chain they start, each to the queue where it can start
+// first, so independent layers, directions and time steps overlap.
+struct RNNSchedule
+{
+    struct Step
+    {
+        std::size_t op;
+        std::size_t queue;
+        std::vector<std::size_t> waits; // operations on other queues to wait for first
+    };
+
+    RNNPlan plan;
+    std::vector<std::vector<std::size_t>> dependencies;
+    std::size_t queue_count = 1;
+    std::vector<Step> steps; // issue order
+    double makespan = 0;     // estimated, in the units of Cost
+
+    // Relative cost of an operation: a launch overhead plus its arithmetic or element count
+    static double Cost(const RNNPlan::Op& op);
+
+    static RNNSchedule Build(const RNNPlan& plan, const RNNPlanShape& shape, std::size_t queues);
+
+    void Dispatch(RNNScheduleExecutor& executor) const;
+};
+
+// Queues the RNN calls spread their plans over: MIOPEN_RNN_QUEUES if set, else 4 on the CPU
+// backend, where every queue is a host thread, and 1 on OpenCL. HIP always runs on one queue.
+std::size_t RNNQueueCount();
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_RNN_SCHEDULE_HPP
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_RNN_WEIGHTS_HPP
+#define GUARD_MIOPEN_RNN_WEIGHTS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace miopen {
+
+// The weight matrices of an RNN parameter buffer. In the canonical layout every layer holds an
+// input block of bi * gates * hy_h rows, as wide as the layer input, followed by a hidden block
+// of rows hy_h wide; the biases of all layers follow the last layer. The packed layout stores
+// every block transposed in place. The input and hidden weights of a layer then form one
+// (input width + hy_h) x (bi * gates * hy_h) matrix, which the forward GEMMs read as it is.
+// Biases and block offsets are the same in both layouts.
+struct RNNWeightLayout
+{
+    // rows x columns, row major in the canonical layout and column major in the packed one
+    struct Block
+    {
+        std::size_t offset;
+        std::size_t rows;
+        std::size_t columns;
+    };
+
+    std::vector<Block> blocks;   // input and hidden block of every layer, by offset
+    std::size_t bias_offset = 0; // end of the last block
+    std::size_t size        = 0; // elements, biases included
+
+    // in_h is 0 in skip input mode, gates is nHiddenTensorsPerLayer
+    RNNWeightLayout(std::size_t in_h,
+                    std::size_t hy_h,
+                    std::size_t bi,
+                    std::size_t n_layers,
+                    std::size_t gates,
+                    bool bias);
+
+    // The block holding the element at a canonical offset, nullptr for the biases
+    const Block* Find(std::size_t offset) const;
+
+    // Offset in the packed layout of the canonical element at offset, which lies in block
+    static std::size_t Packed(const Block& block, std::size_t offset)
+    {
+        const std::size_t i = offset - block.offset;
+        return block.offset + (i % block.columns) * block.rows + i / block.columns;
+    }
+
+    template <class T>
+    void Pack(const T* canonical, T* packed) const
+    {
+        for(const auto& b : blocks)
+            for(std::size_t r = 0; r < b.rows; r++)
+                for(std::size_t c = 0; c < b.columns; c++)
+                    packed[b.offset + c * b.rows + r] = canonical[b.offset + r * b.columns + c];
+        std::copy(canonical + bias_offset, canonical + size, packed + bias_offset);
+    }
+
+    template <class T>
+    void Unpack(const T* packed, T* canonical) const
+    {
+        for(const auto& b : blocks)
+            for(std::size_t r = 0; r < b.rows; r++)
+                for(std::size_t c = 0; c < b.columns; c++)
+                    canonical[b.offset + r * b.columns + c] = packed[b.offset + c * b.rows + r];
+        std::copy(packed + bias_offset, packed + size, canonical + bias_offset);
+    }
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_RNN_WEIGHTS_HPP
@@ -29,6 +29,7 @@
 
 #include <ciso646>
 #include <miopen/config.h>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <string>
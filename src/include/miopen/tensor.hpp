@@ -34,6 +34,7 @@
 #include <miopen/each_args.hpp>
 #include <miopen/returns.hpp>
 #include <miopen/errors.hpp>
+#include <boost/container/small_vector.hpp>
 #include <vector>
 // TODO(paul): remove this include later
 #include <cstdio>
@@ -84,6 +85,20 @@ inline std::size_t GetTypeSize(miopenDataType_t d)
     MIOPEN_THROW("Unknown data type");
 }
 
+// Lengths and strides of up to this many dimensions are stored inside the descriptor.
+constexpr std::size_t tensor_inline_dims = 5;
+
+// Converts to std::vector only explicitly, so no call site copies the dims by accident.
+struct TensorDims : boost::container::small_vector<std::size_t, tensor_inline_dims>
+{
+    using base = boost::container::small_vector<std::size_t, tensor_inline_dims>;
+    using base::base;
+
+    TensorDims() = default;
+
+    explicit operator std::vector<std::size_t>() const { return {this->begin(), this->end()}; }
+};
+
 struct TensorDescriptor : miopenTensorDescriptor
 {
     TensorDescriptor();
@@ -103,19 +118,21 @@ struct TensorDescriptor : miopenTensorDescriptor
         : lens(plens.begin(), plens.end()), packed(true), type(t)
     {
         this->CalculateStrides();
+        this->CalculateCachedValues();
     }
 
     template <class Range1, class Range2, class = decltype(std::declval<Range1>().begin())>
     TensorDescriptor(miopenDataType_t t, const Range1& plens, const Range2& pstrides)
         : lens(plens.begin(), plens.end()), strides(pstrides.begin(), pstrides.end()), type(t)
     {
+        this->CalculateCachedValues();
         packed = (this->GetElementSize() == this->GetElementSpace());
     }
 
     void CalculateStrides();
 
-    const std::vector<std::size_t>& GetLengths() const;
-    const std::vector<std::size_t>& GetStrides() const;
+    const TensorDims& GetLengths() const;
+    const TensorDims& GetStrides() const;
     int GetSize() const;
 
     miopenDataType_t GetType() const;
@@ -126,6 +143,9 @@ struct TensorDescriptor : miopenTensorDescriptor
 
     std::size_t GetNumBytes() const;
 
+    // Hash of type, lengths and strides; equal descriptors have equal hashes.
+    std::size_t GetHash() const;
+
     std::size_t GetIndex(std::initializer_list<int> l) const;
 
     template <class... Ts>
@@ -146,12 +166,24 @@ struct TensorDescriptor : miopenTensorDescriptor
     friend std::ostream& operator<<(std::ostream& stream, const TensorDescriptor& t);
 
     private:
-    std::vector<std::size_t> lens;
-    std::vector<std::size_t> strides;
+    void CalculateCachedValues();
+
+    TensorDims lens;
+    TensorDims strides;
 
     bool packed;
 
     miopenDataType_t type = miopenFloat;
+
+    // Derived from the above, so the getters do not recompute them on every call.
+    std::size_t element_size  = 1;
+    std::size_t element_space = 1;
+    std::size_t hash          = 0;
+};
+
+struct TensorDescriptorHash
+{
+    std::size_t operator()(const TensorDescriptor& desc) const { return desc.GetHash(); }
 };
 
 } // namespace miopen
@@ -174,8 +174,8 @@ void CopyTensor(Handle& handle,
                 ConstData_t src,
                 const TensorDescriptor& dstDesc,
                 Data_t dst,
-                int srcOffset = 0,
-                int dstOffset = 0);
+                std::size_t srcOffset = 0,
+                std::size_t dstOffset = 0);
 
 void CastTensor(Handle& handle,
                 const void* alpha,
@@ -183,8 +183,8 @@ void CastTensor(Handle& handle,
                 ConstData_t src,
                 const TensorDescriptor& dstDesc,
                 Data_t dst,
-                int srcOffset = 0,
-                int dstOffset = 0);
+                std::size_t srcOffset = 0,
+                std::size_t dstOffset = 0);
 
 void TransformTensor(Handle& handle,
                      const void* alpha,
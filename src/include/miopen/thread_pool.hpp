@@ -0,0 +1,291 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_THREAD_POOL_HPP
+#define GUARD_MIOPEN_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#ifdef __MINGW32__
+#include <mingw.thread.h>
+#else
+#include <thread>
+#endif
+
+namespace miopen {
+
+// Process-wide pool that runs the index ranges of par_for and of the CPU
+// backend. Every thread owns a deque of ranges: it keeps halving the range it
+// is about to run, pushing the upper halves to the back of its deque, and pops
+// its own work from the back while idle threads steal the largest pieces from
+// the front. A thread waiting for a loop runs ranges as well, so nested loops
+// cannot starve the pool.
+class thread_pool
+{
+    public:
+    static thread_pool& get()
+    {
+        static thread_pool pool(std::thread::hardware_concurrency());
+        return pool;
+    }
+
+    explicit thread_pool(std::size_t threads) : queues(std::max<std::size_t>(threads, 1))
+    {
+        for(std::size_t i = 0; i + 1 < queues.size(); i++)
+            workers.emplace_back([this, i] { work(i); });
+    }
+
+    // Number of threads that take part in a loop, counting the caller
+    std::size_t size() const { return workers.size() + 1; }
+
+    // Calls f(i) for i in [0, n), splitting the range down to grain indices.
+    // The first exception thrown by f is rethrown once the loop has drained.
+    template <class F>
+    void parallel_for(std::size_t n, std::size_t grain, F f)
+    {
+        if(n == 0)
+            return;
+        loop l;
+        l.body = [&](std::size_t first, std::size_t last) {
+            for(std::size_t i = first; i < last; i++)
+                f(i);
+        };
+        l.grain     = std::max<std::size_t>(grain, 1);
+        l.remaining = n;
+        if(workers.empty() || n <= l.grain)
+        {
+            l.body(0, n);
+            return;
+        }
+        execute({&l, 0, n});
+        wait(l);
+        if(l.error)
+            std::rethrow_exception(l.error);
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for(auto& w : workers)
+            w.join();
+    }
+
+    private:
+    struct loop
+    {
+        std::function<void(std::size_t, std::size_t)> body;
+        std::size_t grain = 1;
+        std::atomic<std::size_t> remaining{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+    };
+
+    struct range
+    {
+        loop* l;
+        std::size_t first;
+        std::size_t last;
+    };
+
+    struct range_queue
+    {
+        std::mutex m;
+        std::deque<range> ranges;
+    };
+
+    // Queues are indexed by worker; threads outside the pool share the last one.
+    std::vector<range_queue> queues;
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable cv;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> sleeping{0};
+    bool stop = false;
+
+    struct worker_id
+    {
+        const thread_pool* pool = nullptr;
+        std::size_t index       = 0;
+    };
+
+    static worker_id& local_worker()
+    {
+        static thread_local worker_id id;
+        return id;
+    }
+
+    std::size_t own_queue() const
+    {
+        const auto& id = local_worker();
+        return id.pool == this ? id.index : workers.size();
+    }
+
+    void push(const range& r)
+    {
+        auto& q = queues[own_queue()];
+        {
+            std::lock_guard<std::mutex> lock(q.m);
+            q.ranges.push_back(r);
+        }
+        pending++;
+        if(sleeping > 0)
+        {
+            { std::lock_guard<std::mutex> lock(m); }
+            cv.notify_one();
+        }
+    }
+
+    bool try_pop(range& r)
+    {
+        if(pending == 0)
+            return false;
+        const std::size_t self = own_queue();
+        for(std::size_t i = 0; i < queues.size(); i++)
+        {
+            auto& q = queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.m);
+            if(q.ranges.empty())
+                continue;
+            // LIFO on our own deque for locality, FIFO when stealing to take
+            // the biggest pieces.
+            if(i == 0)
+            {
+                r = q.ranges.back();
+                q.ranges.pop_back();
+            }
+            else
+            {
+                r = q.ranges.front();
+                q.ranges.pop_front();
+            }
+            pending--;
+            return true;
+        }
+        return false;
+    }
+
+    void execute(range r)
+    {
+        while(r.last - r.first > r.l->grain)
+        {
+            const std::size_t mid = r.first + (r.last - r.first) / 2;
+            push({r.l, mid, r.last});
+            r.last = mid;
+        }
+        loop& l = *r.l;
+        if(!l.failed)
+        {
+            try
+            {
+                l.body(r.first, r.last);
+            }
+            catch(...)
+            {
+                if(!l.failed.exchange(true))
+                    l.error = std::current_exception();
+            }
+        }
+        // The loop may be gone as soon as remaining reaches zero
+        const std::size_t count = r.last - r.first;
+        if(l.remaining.fetch_sub(count) == count)
+        {
+            { std::lock_guard<std::mutex> lock(m); }
+            cv.notify_all();
+        }
+    }
+
+    void wait(const loop& l)
+    {
+        while(l.remaining > 0)
+        {
+            range r;
+            if(try_pop(r))
+            {
+                execute(r);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m);
+            sleeping++;
+            cv.wait(lock, [&] { return l.remaining == 0 || pending > 0; });
+            sleeping--;
+        }
+    }
+
+    void work(std::size_t index)
+    {
+        local_worker() = {this, index};
+        for(;;)
+        {
+            range r;
+            if(try_pop(r))
+            {
+                execute(r);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m);
+            sleeping++;
+            cv.wait(lock, [&] { return stop || pending > 0; });
+            sleeping--;
+            if(stop && pending == 0)
+                return;
+        }
+    }
+};
+
+// Runs f(i) for i in [0, n) on the shared thread_pool. Ranges are split no
+// finer than min_grain indices, and only as far as needed to give each
+// thread a few pieces to balance with.
+template <class F>
+void par_for(std::size_t n, std::size_t min_grain, F f)
+{
+    auto& pool = thread_pool::get();
+    pool.parallel_for(n, std::max(min_grain, n / (16 * pool.size())), f);
+}
+
+template <class F>
+void par_for(std::size_t n, F f)
+{
+    const int min_grain = 8;
+    par_for(n, min_grain, f);
+}
+
+} // namespace miopen
+
+#endif
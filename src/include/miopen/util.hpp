@@ -36,9 +36,9 @@
 namespace miopen {
 
 float Im2ColGPU(Handle& handle,
-                int data_size,
+                std::size_t data_size,
                 ConstData_t im,
-                int im_offset,
+                std::size_t im_offset,
                 int c,
                 int h,
                 int w,
@@ -55,6 +55,28 @@ float Im2ColGPU(Handle& handle,
                 Data_t col,
                 miopenDataType_t type);
 
+// Im2Col of n consecutive images; image i goes to col + i * (c * wei_h * wei_w * out_h * out_w)
+float Im2ColBatchedGPU(Handle& handle,
+                       std::size_t data_size,
+                       ConstData_t im,
+                       std::size_t im_offset,
+                       int n,
+                       int c,
+                       int h,
+                       int w,
+                       int wei_h,
+                       int wei_w,
+                       int out_h,
+                       int out_w,
+                       int pad_h,
+                       int pad_w,
+                       int stride_h,
+                       int stride_w,
+                       int dilation_h,
+                       int dilation_w,
+                       Data_t col,
+                       miopenDataType_t type);
+
 float Col2ImGPU(Handle& handle,
                 ConstData_t col,
                 int col_h,
@@ -71,7 +93,7 @@ float Col2ImGPU(Handle& handle,
                 int h,
                 int w,
                 Data_t im,
-                int im_offset,
+                std::size_t im_offset,
                 miopenDataType_t type);
 
 float transpose_NCHW2CNHW(Handle& handle,
@@ -104,6 +126,20 @@ float transpose_CNHW2NCHW(Handle& handle,
                           int w_stride,
                           miopenDataType_t type);
 
+// Gathers (scatter == false) or scatters rows of width elements between a packed and a padded
+// layout in one kernel. Packed row r of each of the slices is padded row rows[r] of the same
+// slice, rows is a device buffer of n_rows ints. Slices are slice_rows rows apart.
+float CopyRowsGPU(Handle& handle,
+                  ConstData_t src,
+                  Data_t dst,
+                  ConstData_t rows,
+                  int n_rows,
+                  int width,
+                  int slices,
+                  int slice_rows,
+                  bool scatter,
+                  miopenDataType_t type);
+
 } // namespace miopen
 
 #endif // _MIOPEN_UTIL_HPP_
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_WINOGRAD_FILTER_HPP
+#define GUARD_MIOPEN_WINOGRAD_FILTER_HPP
+
+#include <cstddef>
+
+namespace miopen {
+
+// Host reference of Winograd F(tile x tile, 3 x 3) for tile 2 or 4. An alpha x alpha input tile,
+// alpha = tile + 2, gives tile x tile outputs of a stride 1 correlation with a 3 x 3 filter:
+//   Y = A^T [(G g G^T) .* (B^T d B)] A
+// Matrices are row major.
+inline int GetWinogradAlpha(int tile) { return tile + 2; }
+
+// The tile used for an output of out_h x out_w
+inline int GetWinogradTile(std::size_t out_h, std::size_t out_w)
+{
+    return out_h >= 4 && out_w >= 4 ? 4 : 2;
+}
+
+// G g G^T of a 3 x 3 filter g
+void WinogradFilterTransform(int tile, const float* g, float* u);
+// B^T d B of an alpha x alpha input tile d
+void WinogradInputTransform(int tile, const float* d, float* v);
+// A^T m A of an alpha x alpha product m, tile x tile outputs
+void WinogradOutputTransform(int tile, const float* m, float* y);
+
+// Elements of the transformed filters of k x c filters
+inline std::size_t GetWinogradFilterSize(int tile, std::size_t k, std::size_t c)
+{
+    const std::size_t alpha = GetWinogradAlpha(tile);
+    return alpha * alpha * k * c;
+}
+
+// Filters w of [k][c][3][3] into u of [alpha * alpha][k][c], a k x c matrix for every element of
+// the transformed tile
+void WinogradFilterTransform(int tile, std::size_t k, std::size_t c, const float* w, float* u);
+
+// One image x of [c][h][w] convolved with transformed filters u into y of [k][out_h][out_w],
+// stride 1 and out = in + 2 * pad - 2
+void WinogradForward(int tile,
+                     std::size_t c,
+                     std::size_t h,
+                     std::size_t w,
+                     std::size_t k,
+                     int pad_h,
+                     int pad_w,
+                     const float* x,
+                     const float* u,
+                     float* y);
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_WINOGRAD_FILTER_HPP
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_WORKSPACE_PLANNER_HPP_
+#define GUARD_MIOPEN_WORKSPACE_PLANNER_HPP_
+
+#include <miopen/perf_field.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace miopen {
+
+/// Find results of one layer of a network and the steps of the network schedule during
+/// which the layer's workspace is in use, both ends inclusive. Layers whose steps do not
+/// overlap may share workspace memory.
+struct WorkspaceLayer
+{
+    std::vector<PerfField> perf;
+    int first_step;
+    int last_step;
+};
+
+/// Algorithm choice and shared-workspace layout for a list of layers.
+struct WorkspacePlan
+{
+    std::vector<PerfField> algorithms;
+    std::vector<std::size_t> offsets;
+    std::size_t workspace_size = 0;
+    float time                 = 0;
+};
+
+/// Find results that fit into workspace_limit, fastest first. Results that are both
+/// slower and need more workspace than another result are dropped.
+std::vector<PerfField> RankWithinWorkspace(std::vector<PerfField> perf,
+                                           std::size_t workspace_limit);
+
+/// Places the given per-layer workspaces into one buffer: layers that are live at the
+/// same time get disjoint ranges. Offsets are multiples of alignment.
+std::vector<std::size_t> AssignWorkspaceOffsets(const std::vector<WorkspaceLayer>& layers,
+                                                const std::vector<std::size_t>& sizes,
+                                                std::size_t alignment,
+                                                std::size_t& workspace_size);
+
+/// Chooses one algorithm per layer such that the shared workspace fits into budget,
+/// trying to minimise the total time. Layers that never overlap are solved exactly; for
+/// overlapping ones the workspace is reduced greedily where it costs the least time.
+/// Throws if even the smallest workspaces do not fit.
+WorkspacePlan PlanWorkspace(const std::vector<WorkspaceLayer>& layers,
+                            std::size_t budget,
+                            std::size_t alignment = 256);
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_WORKSPACE_PLANNER_HPP_
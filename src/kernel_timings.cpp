@@ -0,0 +1,178 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/kernel_timings.hpp>
+#include <miopen/env.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_ENABLE_KERNEL_TIMINGS)
+
+namespace miopen {
+
+namespace {
+
+constexpr int zero_bucket = std::numeric_limits<int>::min();
+
+int FloorDiv(int x, int y) { return x / y - ((x % y != 0) && ((x < 0) != (y < 0)) ? 1 : 0); }
+
+} // namespace
+
+int KernelTimingHistogram::BucketOf(float time)
+{
+    if(!(time > 0.0f))
+        return zero_bucket;
+    int e        = 0;
+    const auto m = std::frexp(time, &e); // time == m * 2^e, m in [0.5, 1)
+    const auto s = std::min(static_cast<int>((m - 0.5f) * 2 * sub_buckets), sub_buckets - 1);
+    return e * sub_buckets + s;
+}
+
+float KernelTimingHistogram::BucketValue(int bucket)
+{
+    if(bucket == zero_bucket)
+        return 0.0f;
+    const auto e     = FloorDiv(bucket, sub_buckets);
+    const auto s     = bucket - e * sub_buckets;
+    const auto lower = 0.5 + 0.5 * s / sub_buckets;
+    const auto upper = 0.5 + 0.5 * (s + 1) / sub_buckets;
+    return static_cast<float>(std::ldexp((lower + upper) / 2, e));
+}
+
+void KernelTimingHistogram::Add(float time)
+{
+    if(std::isnan(time))
+        return;
+    time = std::max(time, 0.0f);
+    if(count == 0)
+    {
+        min = time;
+        max = time;
+    }
+    else
+    {
+        min = std::min(min, time);
+        max = std::max(max, time);
+    }
+    ++count;
+    total += time;
+    ++buckets[BucketOf(time)];
+}
+
+float KernelTimingHistogram::Quantile(double q) const
+{
+    if(count == 0)
+        return 0.0f;
+    q = std::min(std::max(q, 0.0), 1.0);
+
+    const auto rank = std::max<std::size_t>(
+        1, static_cast<std::size_t>(std::ceil(q * static_cast<double>(count))));
+    std::size_t seen = 0;
+    for(auto&& b : buckets)
+    {
+        seen += b.second;
+        if(seen >= rank)
+            return std::min(std::max(BucketValue(b.first), min), max);
+    }
+    return max;
+}
+
+KernelTimingStats KernelTimingHistogram::GetStats() const
+{
+    KernelTimingStats stats;
+    stats.count = count;
+    stats.min   = min;
+    stats.p50   = Quantile(0.5);
+    stats.p99   = Quantile(0.99);
+    stats.max   = max;
+    stats.total = total;
+    return stats;
+}
+
+void KernelTimings::Record(const KernelTimingKey& key, float time) { histograms[key].Add(time); }
+
+KernelTimingStats KernelTimings::Get(const KernelTimingKey& key) const
+{
+    const auto it = histograms.find(key);
+    if(it == histograms.end())
+        return {};
+    return it->second.GetStats();
+}
+
+std::vector<std::pair<KernelTimingKey, KernelTimingStats>> KernelTimings::GetAll() const
+{
+    std::vector<std::pair<KernelTimingKey, KernelTimingStats>> result;
+    result.reserve(histograms.size());
+    for(auto&& h : histograms)
+        result.emplace_back(h.first, h.second.GetStats());
+    std::stable_sort(result.begin(), result.end(), [](auto&& x, auto&& y) {
+        return x.second.total > y.second.total;
+    });
+    return result;
+}
+
+void KernelTimings::Dump(std::ostream& os) const
+{
+    const auto all     = GetAll();
+    double grand_total = 0.0;
+    for(auto&& x : all)
+        grand_total += x.second.total;
+
+    const auto flags     = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(4);
+    os << "Kernel timings (ms), total " << grand_total << " ms over " << all.size()
+       << " kernel(s):" << std::endl;
+    os << std::setw(12) << "total" << std::setw(8) << "%" << std::setw(10) << "count"
+       << std::setw(12) << "min" << std::setw(12) << "p50" << std::setw(12) << "p99"
+       << std::setw(12) << "max"
+       << "  algorithm / network_config / kernel" << std::endl;
+    for(auto&& x : all)
+    {
+        const auto& s  = x.second;
+        const auto pct = grand_total > 0.0 ? 100.0 * s.total / grand_total : 0.0;
+        os << std::setw(12) << s.total << std::setw(8) << std::setprecision(2) << pct
+           << std::setprecision(4) << std::setw(10) << s.count << std::setw(12) << s.min
+           << std::setw(12) << s.p50 << std::setw(12) << s.p99 << std::setw(12) << s.max << "  "
+           << x.first.algorithm << " / " << x.first.network_config << " / "
+           << x.first.kernel_name << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+std::ostream& operator<<(std::ostream& os, const KernelTimings& t)
+{
+    t.Dump(os);
+    return os;
+}
+
+bool IsKernelTimingsEnabledByEnv() { return miopen::IsEnabled(MIOPEN_ENABLE_KERNEL_TIMINGS{}); }
+
+} // namespace miopen
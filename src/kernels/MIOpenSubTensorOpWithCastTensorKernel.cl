@@ -105,11 +105,11 @@
 
 __kernel void SubTensorOpWithCastTensor1d(const global _FLOAT_SRC* __restrict src,
                                           const float alpha,
-                                          const int srcOffset,
+                                          const long srcOffset,
                                           const int srcStride0,
                                           const int srcLen0,
                                           global _FLOAT_DST* __restrict dst,
-                                          const int dstOffset,
+                                          const long dstOffset,
                                           const int dstStride0)
 {
     uint itmp = get_global_id(0);
@@ -140,13 +140,13 @@ __kernel void SubTensorOpWithCastTensor1d(const global _FLOAT_SRC* __restrict sr
 
 __kernel void SubTensorOpWithCastTensor2d(const global _FLOAT_SRC* __restrict src,
                                           const float alpha,
-                                          const int srcOffset,
+                                          const long srcOffset,
                                           const int srcStride0,
                                           const int srcStride1,
                                           const int srcLen0,
                                           const int srcLen1,
                                           global _FLOAT_DST* __restrict dst,
-                                          const int dstOffset,
+                                          const long dstOffset,
                                           const int dstStride0,
                                           const int dstStride1)
 {
@@ -185,7 +185,7 @@ __kernel void SubTensorOpWithCastTensor2d(const global _FLOAT_SRC* __restrict sr
 
 __kernel void SubTensorOpWithCastTensor3d(const global _FLOAT_SRC* __restrict src,
                                           const float alpha,
-                                          const int srcOffset,
+                                          const long srcOffset,
                                           const int srcStride0,
                                           const int srcStride1,
                                           const int srcStride2,
@@ -193,7 +193,7 @@ __kernel void SubTensorOpWithCastTensor3d(const global _FLOAT_SRC* __restrict sr
                                           const int srcLen1,
                                           const int srcLen2,
                                           global _FLOAT_DST* __restrict dst,
-                                          const int dstOffset,
+                                          const long dstOffset,
                                           const int dstStride0,
                                           const int dstStride1,
                                           const int dstStride2)
@@ -240,7 +240,7 @@ __kernel void SubTensorOpWithCastTensor3d(const global _FLOAT_SRC* __restrict sr
 
 __kernel void SubTensorOpWithCastTensor4d(const global _FLOAT_SRC* __restrict src,
                                           const float alpha,
-                                          const int srcOffset,
+                                          const long srcOffset,
                                           const int srcStride0,
                                           const int srcStride1,
                                           const int srcStride2,
@@ -250,7 +250,7 @@ __kernel void SubTensorOpWithCastTensor4d(const global _FLOAT_SRC* __restrict sr
                                           const int srcLen2,
                                           const int srcLen3,
                                           global _FLOAT_DST* __restrict dst,
-                                          const int dstOffset,
+                                          const long dstOffset,
                                           const int dstStride0,
                                           const int dstStride1,
                                           const int dstStride2,
@@ -307,7 +307,7 @@ __kernel void SubTensorOpWithCastTensor4d(const global _FLOAT_SRC* __restrict sr
 
 __kernel void SubTensorOpWithCastTensor5d(const global _FLOAT_SRC* __restrict src,
                                           const float alpha,
-                                          const int srcOffset,
+                                          const long srcOffset,
                                           const int srcStride0,
                                           const int srcStride1,
                                           const int srcStride2,
@@ -319,7 +319,7 @@ __kernel void SubTensorOpWithCastTensor5d(const global _FLOAT_SRC* __restrict sr
                                           const int srcLen3,
                                           const int srcLen4,
                                           global _FLOAT_DST* __restrict dst,
-                                          const int dstOffset,
+                                          const long dstOffset,
                                           const int dstStride0,
                                           const int dstStride1,
                                           const int dstStride2,
@@ -106,11 +106,11 @@
 #define SUBTENSOR_OP_WITH_SUBTENSOR_COPY(dst, src) (dst = src)
 
 __kernel void SubTensorOpWithSubTensor1d(const global _FLOAT* __restrict src,
-                                         const int srcOffset,
+                                         const long srcOffset,
                                          const int srcStride0,
                                          const int srcLen0,
                                          global _FLOAT* __restrict dst,
-                                         const int dstOffset,
+                                         const long dstOffset,
                                          const int dstStride0)
 {
     uint itmp = get_global_id(0);
@@ -127,13 +127,13 @@ __kernel void SubTensorOpWithSubTensor1d(const global _FLOAT* __restrict src,
 }
 
 __kernel void SubTensorOpWithSubTensor2d(const global _FLOAT* __restrict src,
-                                         const int srcOffset,
+                                         const long srcOffset,
                                          const int srcStride0,
                                          const int srcStride1,
                                          const int srcLen0,
                                          const int srcLen1,
                                          global _FLOAT* __restrict dst,
-                                         const int dstOffset,
+                                         const long dstOffset,
                                          const int dstStride0,
                                          const int dstStride1)
 {
@@ -158,7 +158,7 @@ __kernel void SubTensorOpWithSubTensor2d(const global _FLOAT* __restrict src,
 }
 
 __kernel void SubTensorOpWithSubTensor3d(const global _FLOAT* __restrict src,
-                                         const int srcOffset,
+                                         const long srcOffset,
                                          const int srcStride0,
                                          const int srcStride1,
                                          const int srcStride2,
@@ -166,7 +166,7 @@ __kernel void SubTensorOpWithSubTensor3d(const global _FLOAT* __restrict src,
                                          const int srcLen1,
                                          const int srcLen2,
                                          global _FLOAT* __restrict dst,
-                                         const int dstOffset,
+                                         const long dstOffset,
                                          const int dstStride0,
                                          const int dstStride1,
                                          const int dstStride2)
@@ -199,7 +199,7 @@ __kernel void SubTensorOpWithSubTensor3d(const global _FLOAT* __restrict src,
 }
 
 __kernel void SubTensorOpWithSubTensor4d(const global _FLOAT* __restrict src,
-                                         const int srcOffset,
+                                         const long srcOffset,
                                          const int srcStride0,
                                          const int srcStride1,
                                          const int srcStride2,
@@ -209,7 +209,7 @@ __kernel void SubTensorOpWithSubTensor4d(const global _FLOAT* __restrict src,
                                          const int srcLen2,
                                          const int srcLen3,
                                          global _FLOAT* __restrict dst,
-                                         const int dstOffset,
+                                         const long dstOffset,
                                          const int dstStride0,
                                          const int dstStride1,
                                          const int dstStride2,
@@ -252,7 +252,7 @@ __kernel void SubTensorOpWithSubTensor4d(const global _FLOAT* __restrict src,
 }
 
 __kernel void SubTensorOpWithSubTensor5d(const global _FLOAT* __restrict src,
-                                         const int srcOffset,
+                                         const long srcOffset,
                                          const int srcStride0,
                                          const int srcStride1,
                                          const int srcStride2,
@@ -264,7 +264,7 @@ __kernel void SubTensorOpWithSubTensor5d(const global _FLOAT* __restrict src,
                                          const int srcLen3,
                                          const int srcLen4,
                                          global _FLOAT* __restrict dst,
-                                         const int dstOffset,
+                                         const long dstOffset,
                                          const int dstStride0,
                                          const int dstStride1,
                                          const int dstStride2,
@@ -87,9 +87,9 @@ typedef float data_t;
  * }
  */
 
-kernel void Im2Col(const int data_size_off,
+kernel void Im2Col(const long data_size_off,
                    global data_t* im,
-                   const int im_offset,
+                   const long im_offset,
                    const int h,
                    const int w,
                    const int wei_h,
@@ -107,14 +107,19 @@ kernel void Im2Col(const int data_size_off,
 #define THREADS_PER_CH (256 / NUM_CH_PER_WG)
 
 #if USE_IM_OFF_GUARD
-#define IM_OFF_GUARD(idx) (idx) < data_size_off ? im_off[(idx)] : 0
+#define IM_OFF_GUARD(idx) (idx) < im_size_off ? im_off[(idx)] : 0
 #else
 #define IM_OFF_GUARD(idx) im_off[idx]
 #endif
 
-    global data_t* im_off = im + im_offset;
-    int lid               = get_local_id(0);
-    int gid               = get_group_id(0);
+    // The images of a batch are im2col'ed into consecutive col buffers, one per group row
+    const int batch_id     = get_group_id(1);
+    const long im_size_off = data_size_off - (long)batch_id * NUM_CH_TOTAL * h * w;
+    global data_t* im_off  = im + im_offset + (ulong)batch_id * NUM_CH_TOTAL * h * w;
+    int lid                = get_local_id(0);
+    int gid                = get_group_id(0);
+
+    col += (ulong)batch_id * NUM_CH_TOTAL * wei_h * wei_w * out_h * out_w;
 
 #ifndef EXTREME_LARGE
 #if NUM_IM_BLKS == 1 && STRIDE_GT_1 == 0
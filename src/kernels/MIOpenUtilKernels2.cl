@@ -58,7 +58,7 @@ __kernel void Col2Im(global data_t* col,
                      const int height,
                      const int width,
                      global data_t* im,
-                     const int im_offset)
+                     const long im_offset)
 {
     global data_t* im_off = im + im_offset;
     int gid               = (int)get_global_id(0);
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef MIOPEN_USE_FP32
+#define MIOPEN_USE_FP32 0
+#endif
+
+#ifndef MIOPEN_USE_FP16
+#define MIOPEN_USE_FP16 0
+#endif
+
+#if MIOPEN_USE_FP16
+// Rows are only moved, so half values are copied as short
+typedef short data_t;
+#elif MIOPEN_USE_FP32
+typedef float data_t;
+#endif
+
+/* Moves rows of width elements between a packed and a padded layout, in one launch for any
+ * number of rows. Row r of every packed slice is row rows[r] of the same padded slice, and
+ * slices are slice_rows rows apart in both layouts. A gather (scatter == 0) reads the padded
+ * rows into the packed layout, a scatter writes the packed rows back to the padded layout.
+ */
+__kernel void CopyRows(const global data_t* src,
+                       global data_t* dst,
+                       const global int* rows,
+                       const int n_rows,
+                       const int width,
+                       const int slices,
+                       const int slice_rows,
+                       const int scatter)
+{
+    const size_t total = (size_t)slices * n_rows * width;
+    for(size_t gid = get_global_id(0); gid < total; gid += get_global_size(0))
+    {
+        const size_t col    = gid % width;
+        const size_t row    = (gid / width) % n_rows;
+        const size_t slice  = gid / width / n_rows;
+        const size_t packed = (slice * slice_rows + row) * width + col;
+        const size_t padded = (slice * slice_rows + rows[row]) * width + col;
+        if(scatter)
+            dst[padded] = src[packed];
+        else
+            dst[packed] = src[padded];
+    }
+}
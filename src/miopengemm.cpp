@@ -28,21 +28,23 @@
 #include <miopen/miopengemm.hpp>
 #include <miopen/float_equal.hpp>
 
+#include <cstdint>
+
 #define MIOPENGEMM_CPP_DEBUG 0
 
 #if MIOPEN_USE_MIOPENGEMM
 namespace miopen {
 
 // so that MIOpen works whether or not recent MIOpenGEMM changes pulled:
-// convert size_t and ulong kernel function parameters to unsigned.
+// convert size_t, ulong and unsigned kernel function parameters to offset_type.
 namespace tempfix_v2 {
-void set_offsets_to_uint(std::string& clstr)
+void set_offsets_to(std::string& clstr, const std::string& offset_type)
 {
 
     for(char x : {'a', 'b', 'c'})
     {
-        std::string replacement = "const unsigned " + std::string(1, x) + "_offset,";
-        for(auto inttype : {"size_t", "ulong"})
+        std::string replacement = "const " + offset_type + ' ' + std::string(1, x) + "_offset,";
+        for(auto inttype : {"size_t", "ulong", "unsigned"})
         {
             std::string cmpstr =
                 "const " + std::string(inttype) + ' ' + std::string(1, x) + "_offset,";
@@ -66,7 +68,8 @@ void AddMiopengemmSolution(Handle& handle,
                            ConstData_t B,
                            Data_t C,
                            float time,
-                           bool enforce_determinism)
+                           bool enforce_determinism,
+                           bool wide_offsets)
 {
 #if MIOPEN_BACKEND_OPENCL
     // jn : print search results to terminal
@@ -94,8 +97,11 @@ void AddMiopengemmSolution(Handle& handle,
     MIOpenGEMM::Solution soln = MIOpenGEMM::get_default(mgg);
 #endif
     // jn : the main kernel is at the back of the solution vector
+    // 32-bit offsets unless the caller needs to reach beyond 4G elements
+    const std::string offset_type = wide_offsets ? "ulong" : "unsigned";
+
     std::string kernel_clstring = soln.v_tgks.back().kernstr;
-    tempfix_v2::set_offsets_to_uint(kernel_clstring);
+    tempfix_v2::set_offsets_to(kernel_clstring, offset_type);
 
     std::string kernel_name = soln.v_tgks.back().fname;
     size_t local_work_size  = soln.v_tgks.back().local_work_size;
@@ -116,7 +122,7 @@ void AddMiopengemmSolution(Handle& handle,
     if(soln.v_tgks.size() == 2)
     {
         std::string beta_program_name = soln.v_tgks[0].kernstr;
-        tempfix_v2::set_offsets_to_uint(beta_program_name);
+        tempfix_v2::set_offsets_to(beta_program_name, offset_type);
 
         std::string beta_kernel_name = soln.v_tgks[0].fname;
         local_work_size              = soln.v_tgks[0].local_work_size;
@@ -158,16 +164,18 @@ void AddMiopengemmSolution(Handle& handle,
 #endif
 }
 
-void RunMiopengemmSolution(Handle& handle,
-                           const decltype(handle.GetKernels("_", "_"))& kernels,
-                           float alpha,
-                           ConstData_t A,
-                           int a_offset,
-                           ConstData_t B,
-                           int b_offset,
-                           float beta,
-                           Data_t C,
-                           int c_offset)
+// The offsets are passed as the type the kernels were built with, see AddMiopengemmSolution
+template <class Offset>
+static void RunMiopengemmKernels(Handle& handle,
+                                 const decltype(handle.GetKernels("_", "_"))& kernels,
+                                 float alpha,
+                                 ConstData_t A,
+                                 Offset a_offset,
+                                 ConstData_t B,
+                                 Offset b_offset,
+                                 float beta,
+                                 Data_t C,
+                                 Offset c_offset)
 {
     const std::size_t kernel_size = kernels.size();
 
@@ -217,5 +225,41 @@ void RunMiopengemmSolution(Handle& handle,
     }
 }
 
+void RunMiopengemmSolution(Handle& handle,
+                           const decltype(handle.GetKernels("_", "_"))& kernels,
+                           float alpha,
+                           ConstData_t A,
+                           std::size_t a_offset,
+                           ConstData_t B,
+                           std::size_t b_offset,
+                           float beta,
+                           Data_t C,
+                           std::size_t c_offset,
+                           bool wide_offsets)
+{
+    if(wide_offsets)
+        RunMiopengemmKernels(handle,
+                             kernels,
+                             alpha,
+                             A,
+                             static_cast<std::uint64_t>(a_offset),
+                             B,
+                             static_cast<std::uint64_t>(b_offset),
+                             beta,
+                             C,
+                             static_cast<std::uint64_t>(c_offset));
+    else
+        RunMiopengemmKernels(handle,
+                             kernels,
+                             alpha,
+                             A,
+                             static_cast<unsigned>(a_offset),
+                             B,
+                             static_cast<unsigned>(b_offset),
+                             beta,
+                             C,
+                             static_cast<unsigned>(c_offset));
+}
+
 } // namespace miopen
 #endif // MIOPEN_USE_MIOPENGEMM
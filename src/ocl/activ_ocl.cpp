@@ -24,6 +24,7 @@
  *
  *******************************************************************************/
 #include <miopen/activ.hpp>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/mlo_internal.hpp>
 #include <miopen/float_equal.hpp>
@@ -39,13 +40,17 @@ miopenStatus_t ActivationDescriptor::Forward(Handle& handle,
                                              const TensorDescriptor& yDesc,
                                              Data_t y,
                                              size_t xOffset,
-                                             size_t yOffset)
+                                             size_t yOffset) const
 {
     if(!float_equal(*(static_cast<const float*>(alpha)), 1.0) ||
        !float_equal(*(static_cast<const float*>(beta)), 0))
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::ActivationForward(handle, *this, xDesc, x, yDesc, y, xOffset, yOffset);
+    return miopenStatusSuccess;
+#else
     miopenStatus_t status = miopenStatusSuccess;
     mlo_construct_neuron construct_params(1); // forward
 
@@ -383,6 +388,7 @@ miopenStatus_t ActivationDescriptor::Forward(Handle& handle,
         }
     });
     return (status);
+#endif
 }
 
 miopenStatus_t ActivationDescriptor::Backward(Handle& handle,
@@ -399,13 +405,30 @@ miopenStatus_t ActivationDescriptor::Backward(Handle& handle,
                                               size_t yOffset,
                                               size_t dyOffset,
                                               size_t xOffset,
-                                              size_t dxOffset)
+                                              size_t dxOffset) const
 {
     if(!float_equal(*(static_cast<const float*>(alpha)), 1.0) ||
        !float_equal(*(static_cast<const float*>(beta)), 0))
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::ActivationBackward(handle,
+                            *this,
+                            yDesc,
+                            y,
+                            dyDesc,
+                            dy,
+                            xDesc,
+                            x,
+                            dxDesc,
+                            dx,
+                            yOffset,
+                            dyOffset,
+                            xOffset,
+                            dxOffset);
+    return miopenStatusSuccess;
+#else
     miopenStatus_t status = miopenStatusSuccess;
 
     mlo_construct_neuron construct_params(0); // backward
@@ -916,5 +939,6 @@ miopenStatus_t ActivationDescriptor::Backward(Handle& handle,
         }
     });
     return (status);
+#endif
 }
 } // namespace miopen
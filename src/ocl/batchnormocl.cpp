@@ -24,6 +24,7 @@
  *
  *******************************************************************************/
 #include <miopen/batch_norm.hpp>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/util.hpp>
 #include <miopen/float_equal.hpp>
 #include <miopen/check_numerics.hpp>
@@ -78,6 +79,24 @@ void BatchNormForwardTraining(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::BatchNormForwardTraining(handle,
+                                  bn_mode,
+                                  xDesc,
+                                  x,
+                                  yDesc,
+                                  y,
+                                  bnScaleBiasMeanVarDesc,
+                                  bnScale,
+                                  bnBias,
+                                  expAvgFactor,
+                                  resultRunningMean,
+                                  resultRunningVariance,
+                                  epsilon,
+                                  resultSaveMean,
+                                  resultSaveInvVariance);
+    return;
+#else
     if(miopen::CheckNumericsEnabled() != 0)
     {
         miopen::checkNumericsInput(handle, xDesc, x);
@@ -568,6 +587,7 @@ void BatchNormForwardTraining(Handle& handle,
         miopen::checkNumericsOutput(handle, bnScaleBiasMeanVarDesc, resultSaveMean);
         miopen::checkNumericsOutput(handle, bnScaleBiasMeanVarDesc, resultSaveInvVariance);
     }
+#endif
 }
 //================== END FWD TRAIN ===================
 
@@ -622,6 +642,21 @@ void BatchNormForwardInference(Handle& handle,
             MIOPEN_LOG_E("Only alpha=1 and beta=0 is supported");
             MIOPEN_THROW(miopenStatusBadParm);
         }
+#if MIOPEN_BACKEND_CPU
+        cpu::BatchNormForwardInference(handle,
+                                       bn_mode,
+                                       xDesc,
+                                       x,
+                                       yDesc,
+                                       y,
+                                       bnScaleBiasMeanVarDesc,
+                                       bnScale,
+                                       bnBias,
+                                       estimatedMean,
+                                       estimatedVariance,
+                                       epsilon);
+        return;
+#else
 
         bool bfpmixparm = false;
         bool bfp16parm  = false;
@@ -706,6 +741,7 @@ void BatchNormForwardInference(Handle& handle,
             handle.AddKernel(algo_name, network_config, program_name, kernel_name, vld, vgd, parms)(
                 x, y, estimatedMean, estimatedVariance, bnScale, bnBias, epsilon);
         }
+#endif
     }
     else // Need to recalculated everything, let's just call training kernel in that case
     {
@@ -798,7 +834,24 @@ void BatchNormBackward(Handle& handle,
         MIOPEN_LOG_E("Only alphaParamDiff=1 and betaParamDiff=0 is supported");
         MIOPEN_THROW(miopenStatusBadParm);
     }
-
+#if MIOPEN_BACKEND_CPU
+    cpu::BatchNormBackward(handle,
+                           bn_mode,
+                           xDesc,
+                           x,
+                           dyDesc,
+                           dy,
+                           dxDesc,
+                           dx,
+                           bnScaleBiasDiffDesc,
+                           bnScale,
+                           resultBnScaleDiff,
+                           resultBnBiasDiff,
+                           epsilon,
+                           savedMean,
+                           savedInvVariance);
+    return;
+#else
     std::vector<size_t> vld;
     std::vector<size_t> vgd;
 
@@ -1195,5 +1248,6 @@ void BatchNormBackward(Handle& handle,
         miopen::checkNumericsOutput(handle, bnScaleBiasDiffDesc, resultBnScaleDiff);
         miopen::checkNumericsOutput(handle, bnScaleBiasDiffDesc, resultBnBiasDiff);
     }
+#endif
 }
 } // namespace miopen
@@ -110,7 +110,7 @@ static void BuildProgram(cl_program program, cl_device_id device, const std::str
     }
 }
 
-ClProgramPtr LoadBinaryProgram(cl_context ctx, cl_device_id device, const std::string& source)
+ClProgramPtr LoadBinaryProgram(cl_context ctx, cl_device_id device, boost::string_ref source)
 {
     ClProgramPtr result{CreateProgramWithBinary(ctx, device, source.data(), source.size())};
     BuildProgram(result.get(), device);
@@ -124,18 +124,21 @@ ClProgramPtr LoadProgram(cl_context ctx,
                          bool is_kernel_str)
 {
     bool is_binary = false;
-    std::string source;
+    boost::string_ref source;
+    std::string binary;
     if(is_kernel_str)
     {
         source = program_name;
     }
     else
     {
-        source      = miopen::GetKernelSrc(program_name);
+        source      = miopen::GetKernelSrcView(program_name);
         auto is_asm = miopen::EndsWith(program_name, ".s");
         if(is_asm)
-        { // Overwrites source (asm text) by binary results of assembly:
-            ClAssemble(device, source, params);
+        { // Replaces source (asm text) by binary results of assembly:
+            binary = source.to_string();
+            ClAssemble(device, binary, params);
+            source    = binary;
             is_binary = true;
         }
         else
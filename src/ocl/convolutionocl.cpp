@@ -25,15 +25,19 @@
  *******************************************************************************/
 #include <miopen/config.h>
 #include <miopen/convolution.hpp>
+#include <miopen/conv_cost_model.hpp>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/db.hpp>
 #include <miopen/env.hpp>
 #include <miopen/util.hpp>
 #include <miopen/solver.hpp>
 #include <miopen/float_equal.hpp>
+#include <miopen/problem_description.hpp>
 #include <miopen/visit_float.hpp>
 #include <miopen/check_numerics.hpp>
 
 #if MIOPEN_USE_GEMM
+#include <miopen/conv_gemm_chunk.hpp>
 #include <miopen/gemm.hpp>
 #include <miopen/gemm_v2.hpp>
 #endif
@@ -44,6 +48,7 @@ MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_CONV_GEMM)
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_CONV_DIRECT)
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_ENABLE_FIND_DB)
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_CONV_PRECISE_ROCBLAS_TIMING)
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_CONV_GEMM_IM2COL_BATCHED)
 
 struct AutoEnableProfiling
 {
@@ -64,6 +69,38 @@ struct AutoEnableProfiling
     bool prev_state;
 };
 
+#if MIOPEN_USE_GEMM
+// Chunks of images that are im2col'ed together into the available workspace.
+// With MIOPEN_DEBUG_CONV_GEMM_IM2COL_BATCHED=0 every chunk holds a single image.
+static ConvGemmChunkPlan GetConvFwdGemmChunks(const TensorDescriptor& xDesc,
+                                              const TensorDescriptor& wDesc,
+                                              const TensorDescriptor& yDesc,
+                                              size_t workSpaceSize)
+{
+    int in_n, in_c, in_h, in_w;
+    std::tie(in_n, in_c, in_h, in_w) = tien<4>(xDesc.GetLengths());
+
+    int wei_n, wei_h, wei_w;
+    std::tie(wei_n, std::ignore, wei_h, wei_w) = tien<4>(wDesc.GetLengths());
+
+    int out_h, out_w;
+    std::tie(std::ignore, std::ignore, out_h, out_w) = tien<4>(yDesc.GetLengths());
+
+    return PlanConvGemmChunks(in_n,
+                              in_c,
+                              in_h,
+                              in_w,
+                              wei_n,
+                              wei_h,
+                              wei_w,
+                              out_h,
+                              out_w,
+                              GetTypeSize(xDesc.GetType()),
+                              IsDisabled(MIOPEN_DEBUG_CONV_GEMM_IM2COL_BATCHED{}) ? 0
+                                                                                  : workSpaceSize);
+}
+#endif
+
 static inline void AddKernels(Handle& handle,
                               const std::string& algorithm_name,
                               const std::string& network_config,
@@ -290,7 +327,9 @@ ConvolutionDescriptor::FindDataDirectSolutions(Handle& handle,
     }
 }
 
-static void DirConvFindCore(Handle& handle,
+#if !MIOPEN_BACKEND_CPU
+// Returns false if the cost model pruned algorithms, the record then lacks their times.
+static bool DirConvFindCore(Handle& handle,
                             const TensorDescriptor& xDesc,
                             ConstData_t x,
                             const TensorDescriptor& wDesc,
@@ -678,291 +717,333 @@ static void DirConvFindCore(Handle& handle,
     {
         std::tie(wei_n, std::ignore, wei_h, wei_w) = tien<4>(wDesc.GetLengths());
 
+        std::vector<ConvFindCandidate> candidates;
+
 #if MIOPEN_USE_GEMM
         if(!miopen::IsDisabled(MIOPEN_DEBUG_CONV_GEMM{}))
         {
-            // Use transpose path if input ht and width <= 14 for 1x1_stride=1 convolutions OR
-            // for 1x1_stride=2
-            if((wei_h == 1 && wei_w == 1 && conv.pad_h == 0 && conv.pad_w == 0) &&
-               ((in_h <= 14 && in_w <= 14 && conv.u == 1 && conv.v == 1) ||
-                (conv.u == 2 && conv.v == 2)))
-            {
-                size_t workspace_req = conv.ForwardGetWorkSpaceSizeGEMMTranspose(xDesc, yDesc);
-                if(workSpace != nullptr && workSpaceSize >= workspace_req)
+            auto gemm = [&] {
+                // Use transpose path if input ht and width <= 14 for 1x1_stride=1 convolutions OR
+                // for 1x1_stride=2
+                if((wei_h == 1 && wei_w == 1 && conv.pad_h == 0 && conv.pad_w == 0) &&
+                   ((in_h <= 14 && in_w <= 14 && conv.u == 1 && conv.v == 1) ||
+                    (conv.u == 2 && conv.v == 2)))
                 {
-                    MIOPEN_LOG_FUNCTION("convolution, 1x1, h14xw14 || u2xv2");
+                    size_t workspace_req = conv.ForwardGetWorkSpaceSizeGEMMTranspose(xDesc, yDesc);
+                    if(workSpace != nullptr && workSpaceSize >= workspace_req)
+                    {
+                        MIOPEN_LOG_FUNCTION("convolution, 1x1, h14xw14 || u2xv2");
+
+                        float time_gemm = 0;
+
+                        transpose_NCHW2CNHW(handle,
+                                            in_n,
+                                            in_c,
+                                            in_h,
+                                            in_w,
+                                            out_h,
+                                            out_w,
+                                            x,
+                                            workSpace,
+                                            0,
+                                            0,
+                                            conv.v,
+                                            conv.u,
+                                            xDesc.GetType());
+                        time_gemm = handle.GetKernelTime();
+
+                        size_t x_t_size = in_n * in_c * out_h * out_w;
 
-                    float time_gemm = 0;
+                        // y = CNHW2NCHW(w * NCHW2CNHW(x))
+                        GemmDescriptor gemm_desc =
+                            CreateGemmDescriptorConvCNHWFwd(wDesc, xDesc, yDesc);
 
-                    transpose_NCHW2CNHW(handle,
-                                        in_n,
-                                        in_c,
-                                        in_h,
-                                        in_w,
-                                        out_h,
-                                        out_w,
-                                        x,
-                                        workSpace,
-                                        0,
-                                        0,
-                                        conv.v,
-                                        conv.u,
-                                        xDesc.GetType());
-                    time_gemm = handle.GetKernelTime();
+                        std::string kcache_key;
+                        miopenStatus_t gemm_status = miopenStatusNotInitialized;
 
-                    size_t x_t_size = in_n * in_c * out_h * out_w;
+                        if(!IsDisabled(MIOPEN_CONV_PRECISE_ROCBLAS_TIMING{}))
+                        {
+                            // rocBLAS need a warm-up call for accurate timing
+                            CallGemm(handle,
+                                     gemm_desc,
+                                     w,
+                                     0,
+                                     workSpace,
+                                     0,
+                                     tmp_y.get(),
+                                     0,
+                                     nullptr,
+                                     false);
+
+                            // y = CNHW2NCHW(w * NCHW2CNHW(x))
+                            gemm_status = CallGemm(handle,
+                                                   gemm_desc,
+                                                   w,
+                                                   0,
+                                                   workSpace,
+                                                   0,
+                                                   tmp_y.get(),
+                                                   0,
+                                                   &kcache_key,
+                                                   true);
+                        }
+                        else
+                        {
+                            // y = CNHW2NCHW(w * NCHW2CNHW(x))
+                            gemm_status = CallGemm(handle,
+                                                   gemm_desc,
+                                                   w,
+                                                   0,
+                                                   workSpace,
+                                                   0,
+                                                   tmp_y.get(),
+                                                   0,
+                                                   &kcache_key,
+                                                   false);
+                        }
+
+                        time_gemm += handle.GetKernelTime();
+
+                        transpose_CNHW2NCHW(handle,
+                                            in_n,
+                                            wei_n,
+                                            out_h,
+                                            out_w,
+                                            out_h,
+                                            out_w,
+                                            workSpace,
+                                            tmp_y.get(),
+                                            x_t_size,
+                                            0,
+                                            1,
+                                            1,
+                                            xDesc.GetType());
+                        time_gemm += handle.GetKernelTime();
+
+                        if(gemm_status == miopenStatusSuccess)
+                            record.SetValues("miopenConvolutionFwdAlgoGEMM",
+                                             FindDbData{"gemm",
+                                                        time_gemm,
+                                                        workspace_req,
+                                                        kcache_key}); // Todo: gemm solver id?
+                    }
+                }
+                // 1x1_stride=1 with GEMM and zero workspace
+                else if(wei_h == 1 && wei_w == 1 && conv.pad_h == 0 && conv.pad_w == 0 &&
+                        (conv.u == 1 && conv.v == 1))
+                {
+                    MIOPEN_LOG_FUNCTION("convolution, 1x1");
 
-                    // y = CNHW2NCHW(w * NCHW2CNHW(x))
-                    GemmDescriptor gemm_desc = CreateGemmDescriptorConvCNHWFwd(wDesc, xDesc, yDesc);
+                    // y = w * x
+                    GemmDescriptor gemm_desc =
+                        CreateGemmStridedBatchedDescriptorConv1x1Fwd(wDesc, xDesc, yDesc);
 
                     std::string kcache_key;
                     miopenStatus_t gemm_status = miopenStatusNotInitialized;
 
                     if(!IsDisabled(MIOPEN_CONV_PRECISE_ROCBLAS_TIMING{}))
                     {
-                        // rocBLAS need a warm-up call for accurate timing
-                        CallGemm(
-                            handle, gemm_desc, w, 0, workSpace, 0, tmp_y.get(), 0, nullptr, false);
+                        // rocBLAS need extra warm-up call for accurate timing
+                        CallGemmStridedBatched(
+                            handle, gemm_desc, w, 0, x, 0, tmp_y.get(), 0, nullptr, false);
 
-                        // y = CNHW2NCHW(w * NCHW2CNHW(x))
-                        gemm_status = CallGemm(handle,
-                                               gemm_desc,
-                                               w,
-                                               0,
-                                               workSpace,
-                                               0,
-                                               tmp_y.get(),
-                                               0,
-                                               &kcache_key,
-                                               true);
+                        // y = w * x
+                        gemm_status = CallGemmStridedBatched(
+                            handle, gemm_desc, w, 0, x, 0, tmp_y.get(), 0, &kcache_key, true);
                     }
                     else
                     {
-                        // y = CNHW2NCHW(w * NCHW2CNHW(x))
-                        gemm_status = CallGemm(handle,
-                                               gemm_desc,
-                                               w,
-                                               0,
-                                               workSpace,
-                                               0,
-                                               tmp_y.get(),
-                                               0,
-                                               &kcache_key,
-                                               false);
+                        // y = w * x
+                        gemm_status = CallGemmStridedBatched(
+                            handle, gemm_desc, w, 0, x, 0, tmp_y.get(), 0, &kcache_key, false);
                     }
 
-                    time_gemm += handle.GetKernelTime();
-
-                    transpose_CNHW2NCHW(handle,
-                                        in_n,
-                                        wei_n,
-                                        out_h,
-                                        out_w,
-                                        out_h,
-                                        out_w,
-                                        workSpace,
-                                        tmp_y.get(),
-                                        x_t_size,
-                                        0,
-                                        1,
-                                        1,
-                                        xDesc.GetType());
-                    time_gemm += handle.GetKernelTime();
+                    float time_gemm = handle.GetKernelTime();
 
                     if(gemm_status == miopenStatusSuccess)
-                        record.SetValues("miopenConvolutionFwdAlgoGEMM",
-                                         FindDbData{"gemm",
-                                                    time_gemm,
-                                                    workspace_req,
-                                                    kcache_key}); // Todo: gemm solver id?
-                }
-            }
-            // 1x1_stride=1 with GEMM and zero workspace
-            else if(wei_h == 1 && wei_w == 1 && conv.pad_h == 0 && conv.pad_w == 0 &&
-                    (conv.u == 1 && conv.v == 1))
-            {
-                MIOPEN_LOG_FUNCTION("convolution, 1x1");
-
-                // y = w * x
-                GemmDescriptor gemm_desc =
-                    CreateGemmStridedBatchedDescriptorConv1x1Fwd(wDesc, xDesc, yDesc);
-
-                std::string kcache_key;
-                miopenStatus_t gemm_status = miopenStatusNotInitialized;
-
-                if(!IsDisabled(MIOPEN_CONV_PRECISE_ROCBLAS_TIMING{}))
-                {
-                    // rocBLAS need extra warm-up call for accurate timing
-                    CallGemmStridedBatched(
-                        handle, gemm_desc, w, 0, x, 0, tmp_y.get(), 0, nullptr, false);
-
-                    // y = w * x
-                    gemm_status = CallGemmStridedBatched(
-                        handle, gemm_desc, w, 0, x, 0, tmp_y.get(), 0, &kcache_key, true);
+                        record.SetValues(
+                            "miopenConvolutionFwdAlgoGEMM",
+                            FindDbData{"gemm", time_gemm, 0, kcache_key}); // Todo: gemm solver id?
                 }
-                else
+                // if not 1x1
+                else if(workSpace != nullptr &&
+                        workSpaceSize >= conv.ForwardGetWorkSpaceSizeGEMM(handle, wDesc, yDesc))
                 {
-                    // y = w * x
-                    gemm_status = CallGemmStridedBatched(
-                        handle, gemm_desc, w, 0, x, 0, tmp_y.get(), 0, &kcache_key, false);
-                }
-
-                float time_gemm = handle.GetKernelTime();
-
-                if(gemm_status == miopenStatusSuccess)
-                    record.SetValues(
-                        "miopenConvolutionFwdAlgoGEMM",
-                        FindDbData{"gemm", time_gemm, 0, kcache_key}); // Todo: gemm solver id?
-            }
-            // if not 1x1
-            else if(workSpace != nullptr &&
-                    workSpaceSize >= conv.ForwardGetWorkSpaceSizeGEMM(handle, wDesc, yDesc))
-            {
-                MIOPEN_LOG_FUNCTION("convolution, non 1x1");
+                    MIOPEN_LOG_FUNCTION("convolution, non 1x1");
+
+                    // y[i] = w * Im2Col(x[i]), timed on the first chunk of images. The record
+                    // holds the minimum workspace, so the chunks are planned for that size.
+                    const size_t gemm_ws = conv.ForwardGetWorkSpaceSizeGEMM(handle, wDesc, yDesc);
+                    const ConvGemmChunkPlan chunks =
+                        GetConvFwdGemmChunks(xDesc, wDesc, yDesc, gemm_ws);
+
+                    GemmDescriptor gemm_desc = CreateGemmDescriptorConvFwd(wDesc, xDesc, yDesc);
+                    gemm_desc.batch_count    = chunks.Images(0);
+                    gemm_desc.strideA        = chunks.StrideA();
+                    gemm_desc.strideB        = chunks.StrideB();
+                    gemm_desc.strideC        = chunks.StrideC();
+
+                    float time_im2col = 0;
+                    int in_offset     = 0;
+                    time_im2col       = Im2ColBatchedGPU(handle,
+                                                   xDesc.GetElementSize(),
+                                                   x,
+                                                   in_offset,
+                                                   gemm_desc.batch_count,
+                                                   in_c,
+                                                   in_h,
+                                                   in_w,
+                                                   wei_h,
+                                                   wei_w,
+                                                   out_h,
+                                                   out_w,
+                                                   conv.pad_h,
+                                                   conv.pad_w,
+                                                   conv.u,
+                                                   conv.v,
+                                                   conv.dilation_h,
+                                                   conv.dilation_w,
+                                                   workSpace,
+                                                   xDesc.GetType());
 
-                // y = w * Im2Col(x)
-                GemmDescriptor gemm_desc = CreateGemmDescriptorConvFwd(wDesc, xDesc, yDesc);
+                    std::string kcache_key;
+                    miopenStatus_t gemm_status = miopenStatusNotInitialized;
 
-                float time_im2col = 0;
-                int in_offset     = 0;
-                time_im2col       = Im2ColGPU(handle,
-                                        xDesc.GetElementSize(),
-                                        x,
-                                        in_offset,
-                                        in_c,
-                                        in_h,
-                                        in_w,
-                                        wei_h,
-                                        wei_w,
-                                        out_h,
-                                        out_w,
-                                        conv.pad_h,
-                                        conv.pad_w,
-                                        conv.u,
-                                        conv.v,
-                                        conv.dilation_h,
-                                        conv.dilation_w,
-                                        workSpace,
-                                        xDesc.GetType());
+                    if(!IsDisabled(MIOPEN_CONV_PRECISE_ROCBLAS_TIMING{}))
+                    {
+                        // rocBLAS need a warm-up call for accurate timing
+                        CallGemmStridedBatched(handle,
+                                               gemm_desc,
+                                               w,
+                                               0,
+                                               workSpace,
+                                               0,
+                                               tmp_y.get(),
+                                               0,
+                                               nullptr,
+                                               false,
+                                               GemmBackend_t::miopengemm);
 
-                std::string kcache_key;
-                miopenStatus_t gemm_status = miopenStatusNotInitialized;
+                        // y[i] = w * Im2Col(x[i])
+                        gemm_status = CallGemmStridedBatched(handle,
+                                                             gemm_desc,
+                                                             w,
+                                                             0,
+                                                             workSpace,
+                                                             0,
+                                                             tmp_y.get(),
+                                                             0,
+                                                             &kcache_key,
+                                                             true,
+                                                             GemmBackend_t::miopengemm);
+                    }
+                    else
+                    {
+                        // y[i] = w * Im2Col(x[i])
+                        gemm_status = CallGemmStridedBatched(handle,
+                                                             gemm_desc,
+                                                             w,
+                                                             0,
+                                                             workSpace,
+                                                             0,
+                                                             tmp_y.get(),
+                                                             0,
+                                                             &kcache_key,
+                                                             false,
+                                                             GemmBackend_t::miopengemm);
+                    }
 
-                if(!IsDisabled(MIOPEN_CONV_PRECISE_ROCBLAS_TIMING{}))
-                {
-                    // rocBLAS need a warm-up call for accurate timing
-                    CallGemm(handle,
-                             gemm_desc,
-                             w,
-                             0,
-                             workSpace,
-                             0,
-                             tmp_y.get(),
-                             0,
-                             nullptr,
-                             false,
-                             GemmBackend_t::miopengemm);
+                    // The last chunk may be shorter, it is counted as a full one
+                    float time_gemm = chunks.Count() * (time_im2col + handle.GetKernelTime());
 
-                    // y = w * Im2Col(x)
-                    gemm_status = CallGemm(handle,
-                                           gemm_desc,
-                                           w,
-                                           0,
-                                           workSpace,
-                                           0,
-                                           tmp_y.get(),
-                                           0,
-                                           &kcache_key,
-                                           true,
-                                           GemmBackend_t::miopengemm);
-                }
-                else
-                {
-                    // y = w * Im2Col(x)
-                    gemm_status = CallGemm(handle,
-                                           gemm_desc,
-                                           w,
-                                           0,
-                                           workSpace,
-                                           0,
-                                           tmp_y.get(),
-                                           0,
-                                           &kcache_key,
-                                           false,
-                                           GemmBackend_t::miopengemm);
+                    if(gemm_status == miopenStatusSuccess)
+                        record.SetValues(
+                            "miopenConvolutionFwdAlgoGEMM",
+                            FindDbData{
+                                "gemm", time_gemm, gemm_ws, kcache_key}); // Todo: gemm solver id?
                 }
-
-                float time_gemm = in_n * (time_im2col + handle.GetKernelTime());
-
-                if(gemm_status == miopenStatusSuccess)
-                    record.SetValues(
-                        "miopenConvolutionFwdAlgoGEMM",
-                        FindDbData{"gemm",
-                                   time_gemm,
-                                   conv.ForwardGetWorkSpaceSizeGEMM(handle, wDesc, yDesc),
-                                   kcache_key}); // Todo: gemm solver id?
-            }
+            };
+            candidates.push_back({"miopenConvolutionFwdAlgoGEMM", gemm});
         }
 #else
         (void)workSpace;     // Suppress warning
         (void)workSpaceSize; // Suppress warning
 #endif
+        std::string network_config;
         if(conv.dilation_h == 1 && conv.dilation_w == 1)
         {
-            // Winograd algo
-            WinogradKernelParams k_p;
-            KernelInvoke kernel_wino;
-            std::string network_config;
-            std::string solver_id;
-            if(conv.FindWinogradKernel(
-                   handle, xDesc, wDesc, yDesc, k_p, kernel_wino, solver_id, 1, &network_config) ==
-               0)
-            { // TODO: be more graceful
-                // Execute the winograd kernel
-                // Invocation of winograd does not depend on input bitness (FP32 or FP16)
-                float time_wino  = 0;
-                int flags        = 0;
-                int reserved     = 0;
-                int* return_addr = nullptr;
-                bool isRxS;
-                int N, C, H, W, K, n_groups, out_H, out_W, R, S, unused;
-                std::tie(N, C, H, W, K, n_groups, out_H, out_W, R, S, unused, unused, isRxS) = k_p;
-                // clang-format off
-                MIOPEN_LOG_I2(" N=" << N << " C=" << C << " H=" << H << " W=" << W << " K=" << K
-                    << " n_groups=" << n_groups << " flags=" << flags << " R=" << R << " S=" << S
-                    << " conv.pad_h=" << conv.pad_h << " conv.pad_w=" << conv.pad_w << " out_H=" << out_H << " out_W=" << out_W); // clang-format on
-                if(isRxS)
-                {
-                    kernel_wino(N,
-                                C,
-                                H,
-                                W,
-                                K,
-                                n_groups,
-                                flags,
-                                reserved,
-                                x,
-                                w,
-                                tmp_y.get(),
-                                return_addr,
-                                R,
-                                S,
-                                conv.pad_h,
-                                conv.pad_w,
-                                out_H,
-                                out_W);
-                }
-                else
-                {
-                    kernel_wino(
-                        N, C, H, W, K, n_groups, flags, reserved, x, w, tmp_y.get(), return_addr);
+            auto winograd = [&] {
+                // Winograd algo
+                WinogradKernelParams k_p;
+                KernelInvoke kernel_wino;
+                std::string solver_id;
+                if(conv.FindWinogradKernel(handle,
+                                           xDesc,
+                                           wDesc,
+                                           yDesc,
+                                           k_p,
+                                           kernel_wino,
+                                           solver_id,
+                                           1,
+                                           &network_config) == 0)
+                { // TODO: be more graceful
+                    // Execute the winograd kernel
+                    // Invocation of winograd does not depend on input bitness (FP32 or FP16)
+                    float time_wino  = 0;
+                    int flags        = 0;
+                    int reserved     = 0;
+                    int* return_addr = nullptr;
+                    bool isRxS;
+                    int N, C, H, W, K, n_groups, out_H, out_W, R, S, unused;
+                    std::tie(N, C, H, W, K, n_groups, out_H, out_W, R, S, unused, unused, isRxS) =
+                        k_p;
+                    // clang-format off
+                    MIOPEN_LOG_I2(" N=" << N << " C=" << C << " H=" << H << " W=" << W << " K=" << K
+                        << " n_groups=" << n_groups << " flags=" << flags << " R=" << R << " S=" << S
+                        << " conv.pad_h=" << conv.pad_h << " conv.pad_w=" << conv.pad_w << " out_H=" << out_H << " out_W=" << out_W); // clang-format on
+                    if(isRxS)
+                    {
+                        kernel_wino(N,
+                                    C,
+                                    H,
+                                    W,
+                                    K,
+                                    n_groups,
+                                    flags,
+                                    reserved,
+                                    x,
+                                    w,
+                                    tmp_y.get(),
+                                    return_addr,
+                                    R,
+                                    S,
+                                    conv.pad_h,
+                                    conv.pad_w,
+                                    out_H,
+                                    out_W);
+                    }
+                    else
+                    {
+                        kernel_wino(N,
+                                    C,
+                                    H,
+                                    W,
+                                    K,
+                                    n_groups,
+                                    flags,
+                                    reserved,
+                                    x,
+                                    w,
+                                    tmp_y.get(),
+                                    return_addr);
+                    }
+                    time_wino = handle.GetKernelTime();
+                    record.SetValues("miopenConvolutionFwdAlgoWinograd",
+                                     FindDbData{solver_id, time_wino, 0, network_config});
                 }
-                time_wino = handle.GetKernelTime();
-                record.SetValues("miopenConvolutionFwdAlgoWinograd",
-                                 FindDbData{solver_id, time_wino, 0, network_config});
-            }
+            };
 
-            { // Direct algo
+            auto direct = [&] {
                 ExtraKernelArgs eka;
                 const auto all = conv.FindDataDirectSolutions(
                     handle, xDesc, wDesc, yDesc, exhaustiveSearch, true, network_config, eka);
@@ -1011,37 +1092,62 @@ static void DirConvFindCore(Handle& handle,
                         algorithm_name,
                         FindDbData{selected.solver_id, best, selected.workspce_sz, network_config});
                 }
-            }
-
-            // FFT algo
-            std::vector<KernelInvoke> kernels_fft;
-            size_t workspace_fft = conv.ForwardGetWorkSpaceSizeFFT(wDesc, xDesc, yDesc);
-            if(conv.FindFwdFFTKernel(
-                   handle, xDesc, wDesc, yDesc, workspace_fft, kernels_fft, network_config) == 0)
-            {
-                (void)kernels_fft; // not used now, but needed as fft coverage widens
-                if(workSpace != nullptr && workSpaceSize >= workspace_fft)
+            };
+
+            auto fft = [&] {
+                // FFT algo
+                std::vector<KernelInvoke> kernels_fft;
+                size_t workspace_fft = conv.ForwardGetWorkSpaceSizeFFT(wDesc, xDesc, yDesc);
+                if(conv.FindFwdFFTKernel(handle,
+                                         xDesc,
+                                         wDesc,
+                                         yDesc,
+                                         workspace_fft,
+                                         kernels_fft,
+                                         network_config) == 0)
                 {
-                    float time_fft = conv.ExecuteFwdFFTKernel(handle,
-                                                              xDesc,
-                                                              x,
-                                                              wDesc,
-                                                              w,
-                                                              yDesc,
-                                                              tmp_y.get(),
-                                                              workSpace,
-                                                              workSpaceSize,
-                                                              true);
-                    record.SetValues("miopenConvolutionFwdAlgoFFT",
-                                     FindDbData{"fft",
-                                                time_fft,
-                                                workspace_fft,
-                                                network_config}); // Todo: fft solver id?
+                    (void)kernels_fft; // not used now, but needed as fft coverage widens
+                    if(workSpace != nullptr && workSpaceSize >= workspace_fft)
+                    {
+                        float time_fft = conv.ExecuteFwdFFTKernel(handle,
+                                                                  xDesc,
+                                                                  x,
+                                                                  wDesc,
+                                                                  w,
+                                                                  yDesc,
+                                                                  tmp_y.get(),
+                                                                  workSpace,
+                                                                  workspace_fft,
+                                                                  true);
+                        record.SetValues("miopenConvolutionFwdAlgoFFT",
+                                         FindDbData{"fft",
+                                                    time_fft,
+                                                    workspace_fft,
+                                                    network_config}); // Todo: fft solver id?
+                    }
                 }
-            }
+            };
+
+            candidates.push_back({"miopenConvolutionFwdAlgoWinograd", winograd});
+            candidates.push_back({"miopenConvolutionFwdAlgoDirect", direct});
+            candidates.push_back({"miopenConvolutionFwdAlgoFFT", fft});
         }
+
+        // Compiling the candidates is most of a first Find, the cost model skips the hopeless
+        const ProblemDescription problem(xDesc, wDesc, yDesc, conv, 1);
+        const auto skipped = RunConvFindCandidates(GetConvCostModel(handle),
+                                                   problem,
+                                                   GetConvFindPruneFactor(),
+                                                   std::move(candidates),
+                                                   [&](const std::string& algorithm) {
+                                                       FindDbData data;
+                                                       return record.GetValues(algorithm, data);
+                                                   });
+        return skipped.empty();
     }
+    return true;
 }
+#endif
 
 void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
                                                  const TensorDescriptor& xDesc,
@@ -1068,6 +1174,21 @@ void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "requestAlgoCount cannot be < 1");
 
     *returnedAlgoCount = 0;
+#if MIOPEN_BACKEND_CPU
+    (void)handle;
+    (void)xDesc;
+    (void)wDesc;
+    (void)yDesc;
+    (void)workSpace;
+    (void)workSpaceSize;
+    (void)exhaustiveSearch;
+    // The host convolution is the only algorithm of the CPU backend.
+    perfResults[0].fwd_algo = miopenConvolutionFwdAlgoDirect;
+    perfResults[0].time     = 0;
+    perfResults[0].memory   = 0;
+    *returnedAlgoCount      = 1;
+    return;
+#else
 
     ProblemDescription problem(xDesc, wDesc, yDesc, *this, 1);
 
@@ -1075,22 +1196,23 @@ void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
     (void)find_db_path;
     auto record =
         boost::optional<DbRecord>{boost::none}; // Db{find_db_path, false}.FindRecord(problem);
-    auto loaded = record.is_initialized();
+    auto loaded   = record.is_initialized();
+    auto complete = true;
 
     if(!loaded)
     {
-        record = DbRecord(problem);
-        DirConvFindCore(handle,
-                        xDesc,
-                        x,
-                        wDesc,
-                        w,
-                        yDesc,
-                        workSpace,
-                        workSpaceSize,
-                        *this,
-                        exhaustiveSearch,
-                        *record);
+        record   = DbRecord(problem);
+        complete = DirConvFindCore(handle,
+                                   xDesc,
+                                   x,
+                                   wDesc,
+                                   w,
+                                   yDesc,
+                                   workSpace,
+                                   workSpaceSize,
+                                   *this,
+                                   exhaustiveSearch,
+                                   *record);
     }
 
     std::vector<PerfField> perf_db;
@@ -1104,22 +1226,25 @@ void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
         if(loaded && (pair.second.kchache_key == FindDbData::GetUnusedKCacheKey() ||
                       !handle.HasKernel(pair.first, pair.second.kchache_key)))
         {
-            DirConvFindCore(handle,
-                            xDesc,
-                            x,
-                            wDesc,
-                            w,
-                            yDesc,
-                            workSpace,
-                            workSpaceSize,
-                            *this,
-                            exhaustiveSearch,
-                            *record);
+            complete = DirConvFindCore(handle,
+                                       xDesc,
+                                       x,
+                                       wDesc,
+                                       w,
+                                       yDesc,
+                                       workSpace,
+                                       workSpaceSize,
+                                       *this,
+                                       exhaustiveSearch,
+                                       *record);
             loaded = false;
         }
     }
 
-    if(IsEnabled(MIOPEN_DEBUG_ENABLE_FIND_DB{}) && !loaded)
+    // A pruned Find would hide the skipped algorithms from every later Find of the problem
+    if(!complete)
+        MIOPEN_LOG_I2("Pruned record is not stored to find-db");
+    else if(IsEnabled(MIOPEN_DEBUG_ENABLE_FIND_DB{}) && !loaded)
     {
         if(!Db{find_db_path, false}.StoreRecord(record.get()))
             MIOPEN_LOG_W("Failed to store record to find-db at <" << find_db_path << ">");
@@ -1142,6 +1267,7 @@ void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
         perfResults[i].time   = perf_db[i].time;
         perfResults[i].memory = perf_db[i].workspace;
     }
+#endif
 }
 
 void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
@@ -1182,6 +1308,11 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
     {
         MIOPEN_THROW(miopenStatusNotImplemented, "Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    (void)workSpace;
+    cpu::ConvolutionForward(handle, *this, xDesc, x, wDesc, w, yDesc, y, algo);
+    return;
+#else
 
     if(miopen::CheckNumericsEnabled() != 0)
     {
@@ -1436,55 +1567,63 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
                 assert(workSpace != nullptr &&
                        workSpaceSize >= ForwardGetWorkSpaceSizeGEMM(handle, wDesc, yDesc));
 
-                // y = w * Im2Col(x)
+                // y[i] = w * Im2Col(x[i]), for all images i of a chunk at once
+                const ConvGemmChunkPlan chunks =
+                    GetConvFwdGemmChunks(xDesc, wDesc, yDesc, workSpaceSize);
+
                 GemmDescriptor gemm_desc = CreateGemmDescriptorConvFwd(wDesc, xDesc, yDesc);
+                gemm_desc.strideA        = chunks.StrideA();
+                gemm_desc.strideB        = chunks.StrideB();
+                gemm_desc.strideC        = chunks.StrideC();
 
                 float time_0 = 0;
                 float t1     = 0;
-                for(int i = 0; i < in_n; i++)
+                for(int i = 0; i < chunks.Count(); i++)
                 {
-                    int out_offset = i * wei_n * out_h * out_w;
-                    int in_offset  = i * in_c * in_h * in_w;
-                    Im2ColGPU(handle,
-                              xDesc.GetElementSize(),
-                              x,
-                              in_offset,
-                              in_c,
-                              in_h,
-                              in_w,
-                              wei_h,
-                              wei_w,
-                              out_h,
-                              out_w,
-                              pad_h,
-                              pad_w,
-                              u,
-                              v,
-                              dilation_h,
-                              dilation_w,
-                              workSpace,
-                              xDesc.GetType());
+                    gemm_desc.batch_count = chunks.Images(i);
+                    size_t out_offset     = chunks.OutOffset(i);
+                    size_t in_offset      = chunks.InOffset(i);
+                    Im2ColBatchedGPU(handle,
+                                     xDesc.GetElementSize(),
+                                     x,
+                                     in_offset,
+                                     gemm_desc.batch_count,
+                                     in_c,
+                                     in_h,
+                                     in_w,
+                                     wei_h,
+                                     wei_w,
+                                     out_h,
+                                     out_w,
+                                     pad_h,
+                                     pad_w,
+                                     u,
+                                     v,
+                                     dilation_h,
+                                     dilation_w,
+                                     workSpace,
+                                     xDesc.GetType());
 
                     if(handle.IsProfilingEnabled())
                         t1 = handle.GetKernelTime();
 
-                    // y = w * Im2Col(x)
-                    CallGemm(handle,
-                             gemm_desc,
-                             w,
-                             0,
-                             workSpace,
-                             0,
-                             y,
-                             out_offset,
-                             nullptr,
-                             false,
-                             GemmBackend_t::miopengemm);
+                    // y[i] = w * Im2Col(x[i])
+                    CallGemmStridedBatched(handle,
+                                           gemm_desc,
+                                           w,
+                                           0,
+                                           workSpace,
+                                           0,
+                                           y,
+                                           out_offset,
+                                           nullptr,
+                                           false,
+                                           GemmBackend_t::miopengemm);
 
                     // Update times for both the kernels
                     if(handle.IsProfilingEnabled())
                     {
-                        if(i == in_n - 1)
+                        if(i == chunks.Count() - 1)
                             handle.AccumKernelTime(t1 + time_0);
                         else
                             handle.AccumKernelTime(t1);
@@ -1504,9 +1643,9 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
             if(workSpace != nullptr && workSpaceSize >= workspace_fft)
             {
                 bool timed  = handle.IsProfilingEnabled();
+                // The kernels were built for workspace_fft, the rest of workSpace is unused
                 float timev = ExecuteFwdFFTKernel(
-                    handle, xDesc, x, wDesc, w, yDesc, y, workSpace, workSpaceSize, timed);
-                // FIXME: Is workSpaceSize correct here? It seems that workspace_fft is.
+                    handle, xDesc, x, wDesc, w, yDesc, y, workSpace, workspace_fft, timed);
 
                 if(timed)
                 {
@@ -1552,12 +1691,12 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
         float t1     = 0;
         for(int i = 0; i < in_n; i++)
         {
-            int out_offset = i * wei_n * out_h * out_w;
+            size_t out_offset = size_t(i) * wei_n * out_h * out_w;
             if(wei_h != 1 || wei_w != 1 || v != 1 || u != 1 || pad_h != 0 || pad_w != 0)
             {
                 MIOPEN_LOG_FUNCTION("transppose, non 1x1");
 
-                int in_offset = i * in_c * in_h * in_w;
+                size_t in_offset = size_t(i) * in_c * in_h * in_w;
 
                 gg.RunGemm(handle, w, x, workSpace, 0, in_offset, 0);
 
@@ -1597,7 +1736,7 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
             {
                 MIOPEN_LOG_FUNCTION("transppose, 1x1");
 
-                int in_offset = i * in_c * in_h * in_w;
+                size_t in_offset = size_t(i) * in_c * in_h * in_w;
                 gg.RunGemm(handle, w, x, y, 0, in_offset, out_offset);
                 if(handle.IsProfilingEnabled())
                 {
@@ -1745,8 +1884,8 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
 
                 for(int i = 0; i < in_n; i++)
                 {
-                    size_t out_offset = i * wei_n * out_h * out_w;
-                    size_t in_offset  = i * in_c * in_h * in_w;
+                    size_t out_offset = size_t(i) * wei_n * out_h * out_w;
+                    size_t in_offset  = size_t(i) * in_c * in_h * in_w;
                     CallGemmStridedBatched(
                         handle, gemm_desc, w, 0, x, in_offset, y, out_offset, nullptr, false);
                     if(handle.IsProfilingEnabled())
@@ -1769,7 +1908,7 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
                 float t1     = 0;
                 for(int i = 0; i < in_n; i++)
                 {
-                    size_t in_offset = i * in_c * in_h * in_w;
+                    size_t in_offset = size_t(i) * in_c * in_h * in_w;
                     Im2ColGPU(handle,
                               xDesc.GetElementSize(),
                               x,
@@ -1792,7 +1931,7 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
                     if(handle.IsProfilingEnabled())
                         t1 += handle.GetKernelTime();
 
-                    size_t out_offset = i * wei_n * out_h * out_w;
+                    size_t out_offset = size_t(i) * wei_n * out_h * out_w;
                     CallGemmStridedBatched(handle,
                                            gemm_desc,
                                            w,
@@ -1830,6 +1969,68 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
     {
         miopen::checkNumericsOutput(handle, yDesc, y);
     }
+#endif
+}
+
+void ConvolutionDescriptor::PrepareForwardWeights(Handle& handle,
+                                                  const TensorDescriptor& xDesc,
+                                                  const TensorDescriptor& wDesc,
+                                                  ConstData_t w,
+                                                  const TensorDescriptor& yDesc,
+                                                  miopenConvFwdAlgorithm_t algo,
+                                                  std::uint64_t version,
+                                                  Data_t workSpace,
+                                                  size_t workSpaceSize) const
+{
+    MIOPEN_LOG_I2("algo = " << algo << ", version = " << version);
+    if(w == nullptr)
+    {
+        MIOPEN_THROW(miopenStatusBadParm);
+    }
+
+    auto& cache = handle.GetFilterTransformCache();
+    const ProblemDescription problem(xDesc, wDesc, yDesc, *this, 1);
+    const auto* entry = cache.Find(w, algo, problem);
+    if(entry != nullptr && entry->version == version)
+        return;
+
+#if MIOPEN_BACKEND_CPU
+    (void)workSpace;
+    (void)workSpaceSize;
+    if(algo != miopenConvolutionFwdAlgoWinograd ||
+       !cpu::IsWinogradApplicable(*this, xDesc, wDesc, yDesc))
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "Only Winograd filters are transformed ahead of time on the CPU");
+    }
+
+    const auto size = cpu::GetWinogradFilterSize(wDesc, yDesc);
+    auto transformed = handle.Create(size);
+    cpu::TransformWinogradFilters(handle, wDesc, w, yDesc, transformed.get());
+    cache.Insert(w, algo, problem, version, std::move(transformed), size);
+#else
+    // The Winograd kernels transform their filters themselves, and GEMM and direct
+    // convolutions have none to transform
+    if(algo != miopenConvolutionFwdAlgoFFT || mode != miopenConvolution)
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented, "Only FFT filters are transformed ahead of time");
+    }
+
+    const size_t workspace_fft = ForwardGetWorkSpaceSizeFFT(wDesc, xDesc, yDesc);
+    if(workspace_fft == 0)
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented, "FFT does not apply to this convolution");
+    }
+    if(workSpace == nullptr || workSpaceSize < workspace_fft)
+    {
+        MIOPEN_THROW(miopenStatusBadParm, "The FFT filters need the FFT workspace");
+    }
+
+    const auto size  = ForwardGetFFTFilterSize(xDesc, yDesc);
+    auto transformed = handle.Create(size);
+    TransformFwdFFTFilters(handle, xDesc, wDesc, w, yDesc, workSpace, transformed.get());
+    cache.Insert(w, algo, problem, version, std::move(transformed), size);
+#endif
 }
 
 // FindBackwardDataAlgorithm()
@@ -1859,6 +2060,21 @@ void ConvolutionDescriptor::FindConvBwdDataAlgorithm(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "requestAlgoCount cannot be < 1");
 
     *returnedAlgoCount = 0;
+#if MIOPEN_BACKEND_CPU
+    (void)handle;
+    (void)dyDesc;
+    (void)wDesc;
+    (void)dxDesc;
+    (void)workSpace;
+    (void)workSpaceSize;
+    (void)exhaustiveSearch;
+    // The host convolution is the only algorithm of the CPU backend.
+    perfResults[0].bwd_data_algo = miopenConvolutionBwdDataAlgoDirect;
+    perfResults[0].time          = 0;
+    perfResults[0].memory        = 0;
+    *returnedAlgoCount           = 1;
+    return;
+#else
 
     // create a dummy buffer for use as output for the kernel calls
     // because kernels are called purely for timing purposes
@@ -2601,6 +2817,7 @@ void ConvolutionDescriptor::FindConvBwdDataAlgorithm(Handle& handle,
         perfResults[i].time   = perf_db[i].time;
         perfResults[i].memory = perf_db[i].workspace;
     }
+#endif
 }
 
 // BackwardDataAlgorithm()
@@ -2642,6 +2859,11 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    (void)workSpace;
+    cpu::ConvolutionBackwardData(handle, *this, dyDesc, dy, wDesc, w, dxDesc, dx);
+    return;
+#else
 
     if(miopen::CheckNumericsEnabled() != 0)
     {
@@ -2903,8 +3125,8 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
                 float t1     = 0;
                 for(int i = 0; i < in_n; i++)
                 {
-                    int out_offset   = i * wei_n * out_h * out_w;
-                    size_t in_offset = i * in_c * in_h * in_w;
+                    size_t out_offset = size_t(i) * wei_n * out_h * out_w;
+                    size_t in_offset  = size_t(i) * in_c * in_h * in_w;
 
                     // dx = transpose(w) * dy
                     CallGemm(handle,
@@ -3010,12 +3232,12 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
         float t1     = 0;
         for(int i = 0; i < in_n; i++)
         {
-            int in_offset = i * in_c * in_h * in_w;
+            size_t in_offset = size_t(i) * in_c * in_h * in_w;
             if(wei_h != 1 || wei_w != 1 || v != 1 || u != 1 || pad_h != 0 || pad_w != 0)
             {
                 MIOPEN_LOG_FUNCTION("transpose, non 1x1");
 
-                size_t out_offset = i * wei_n * out_h * out_w;
+                size_t out_offset = size_t(i) * wei_n * out_h * out_w;
                 Im2ColGPU(handle,
                           dyDesc.GetElementSize(),
                           dy,
@@ -3054,7 +3276,7 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
             {
                 MIOPEN_LOG_FUNCTION("transpose, 1x1");
 
-                int out_offset = i * wei_n * out_h * out_w;
+                size_t out_offset = size_t(i) * wei_n * out_h * out_w;
                 gg.RunGemm(handle, w, dy, dx, 0, out_offset, in_offset);
                 if(handle.IsProfilingEnabled())
                 {
@@ -3197,8 +3419,8 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
                 float time_0 = 0;
                 for(int i = 0; i < in_n; i++)
                 {
-                    size_t out_offset = i * wei_n * out_h * out_w;
-                    size_t in_offset  = i * in_c * in_h * in_w;
+                    size_t out_offset = size_t(i) * wei_n * out_h * out_w;
+                    size_t in_offset  = size_t(i) * in_c * in_h * in_w;
                     CallGemmStridedBatched(
                         handle, gemm_desc, w, 0, dy, out_offset, dx, in_offset, nullptr, false);
 
@@ -3226,8 +3448,8 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
                 float t1     = 0;
                 for(int i = 0; i < in_n; i++)
                 {
-                    size_t in_offset  = i * in_c * in_h * in_w;
-                    size_t out_offset = i * wei_n * out_h * out_w;
+                    size_t in_offset  = size_t(i) * in_c * in_h * in_w;
+                    size_t out_offset = size_t(i) * wei_n * out_h * out_w;
 
                     CallGemmStridedBatched(handle,
                                            gemm_desc,
@@ -3289,6 +3511,7 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
     {
         miopen::checkNumericsOutput(handle, dxDesc, dx);
     }
+#endif
 }
 
 template <typename T>
@@ -3388,6 +3611,21 @@ void ConvolutionDescriptor::FindConvBwdWeightsAlgorithm(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "requestAlgoCount cannot be < 1");
 
     *returnedAlgoCount = 0;
+#if MIOPEN_BACKEND_CPU
+    (void)handle;
+    (void)dyDesc;
+    (void)xDesc;
+    (void)dwDesc;
+    (void)workSpace;
+    (void)workSpaceSize;
+    (void)exhaustiveSearch;
+    // The host convolution is the only algorithm of the CPU backend.
+    perfResults[0].bwd_weights_algo = miopenConvolutionBwdWeightsAlgoDirect;
+    perfResults[0].time             = 0;
+    perfResults[0].memory           = 0;
+    *returnedAlgoCount              = 1;
+    return;
+#else
 
     // create a dummy buffer for use as output for the kernel calls
     // because kernels are called purely for timing purposes
@@ -3902,6 +4140,7 @@ void ConvolutionDescriptor::FindConvBwdWeightsAlgorithm(Handle& handle,
         perfResults[i].time   = perf_db[i].time;
         perfResults[i].memory = perf_db[i].workspace;
     }
+#endif
 }
 
 // BackwardWeightsAlgorithm()
@@ -3944,6 +4183,11 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    (void)workSpace;
+    cpu::ConvolutionBackwardWeights(handle, *this, dyDesc, dy, xDesc, x, dwDesc, dw);
+    return;
+#else
 
     if(miopen::CheckNumericsEnabled() != 0)
     {
@@ -3998,8 +4242,8 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
 
                 for(int i = 0; i < in_n; i++)
                 {
-                    int out_offset = i * wei_n * out_h * out_w;
-                    int in_offset  = i * in_c * in_h * in_w;
+                    size_t out_offset = size_t(i) * wei_n * out_h * out_w;
+                    size_t in_offset  = size_t(i) * in_c * in_h * in_w;
                     Im2ColGPU(handle,
                               xDesc.GetElementSize(),
                               x,
@@ -4199,12 +4443,12 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
         float t1     = 0;
         for(int i = 0; i < in_n; i++)
         {
-            int in_offset = i * in_c * in_h * in_w;
+            size_t in_offset = size_t(i) * in_c * in_h * in_w;
             if(wei_h != 1 || wei_w != 1 || v != 1 || u != 1 || pad_h != 0 || pad_w != 0)
             {
                 MIOPEN_LOG_FUNCTION("transpose, non 1x1");
 
-                int out_offset = i * wei_n * out_h * out_w;
+                size_t out_offset = size_t(i) * wei_n * out_h * out_w;
                 Im2ColGPU(handle,
                           dyDesc.GetElementSize(),
                           dy,
@@ -4244,7 +4488,7 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
             {
                 MIOPEN_LOG_FUNCTION("transpose, 1x1");
 
-                int out_offset = i * wei_n * out_h * out_w;
+                size_t out_offset = size_t(i) * wei_n * out_h * out_w;
                 gg.RunGemm(handle, dy, x, dw, out_offset, in_offset, 0);
 
                 if(handle.IsProfilingEnabled())
@@ -4294,7 +4538,7 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
             {
                 if(wei_h != 1 || wei_w != 1 || v != 1 || u != 1 || pad_h != 0 || pad_w != 0)
                 {
-                    size_t in_offset = i * in_c * in_h * in_w;
+                    size_t in_offset = size_t(i) * in_c * in_h * in_w;
                     Im2ColGPU(handle,
                               xDesc.GetElementSize(),
                               x,
@@ -4318,7 +4562,7 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
                         t1 += handle.GetKernelTime();
                 }
 
-                size_t out_offset = i * wei_n * out_h * out_w;
+                size_t out_offset = size_t(i) * wei_n * out_h * out_w;
                 if(wei_h != 1 || wei_w != 1 || v != 1 || u != 1 || pad_h != 0 || pad_w != 0)
                 {
                     CallGemmStridedBatched(handle,
@@ -4343,7 +4587,7 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
                 }
                 else
                 {
-                    size_t in_offset = i * in_c * in_h * in_w;
+                    size_t in_offset = size_t(i) * in_c * in_h * in_w;
                     CallGemmStridedBatched(handle,
                                            gemm_desc,
                                            dy,
@@ -4417,6 +4661,7 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
     {
         miopen::checkNumericsOutput(handle, dwDesc, dw);
     }
+#endif
 }
 
 void ConvolutionBackwardBias(Handle& handle,
@@ -4440,6 +4685,10 @@ void ConvolutionBackwardBias(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::ConvolutionBackwardBias(handle, dyDesc, dy, dbDesc, db);
+    return;
+#else
     if(miopen::CheckNumericsEnabled() != 0)
     {
         miopen::checkNumericsInput(handle, dyDesc, dy);
@@ -4493,6 +4742,7 @@ void ConvolutionBackwardBias(Handle& handle,
     {
         miopen::checkNumericsOutput(handle, dbDesc, db);
     }
+#endif
 }
 
 } // namespace miopen
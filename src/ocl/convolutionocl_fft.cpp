@@ -26,6 +26,8 @@
 #include <miopen/convolution.hpp>
 #include <miopen/convolution_fft.hpp>
 #include <miopen/env.hpp>
+#include <miopen/problem_description.hpp>
+#include <miopen/tensor_ops.hpp>
 #include <miopen/util.hpp>
 
 namespace miopen {
@@ -117,6 +119,26 @@ static std::string make_config_prefix(int in_h, int in_w, int in_n, int in_c, in
     return config_prefix;
 }
 
+// The forward filter spectra the cgemm kernel reads, as a float2 offset into the workspace and a
+// float2 count. MIOpenConvFFT_fwd_we writes them there for 7x7 images, MIOpenConvFFT_transpose_we
+// for the others. workSpaceSize is the size the kernels were built for, which sets CFF_HALFW.
+static void GetFFTFilterSpectra(int in_h,
+                                int in_w,
+                                int in_n,
+                                int in_c,
+                                int out_c,
+                                size_t workSpaceSize,
+                                size_t& offset,
+                                size_t& count)
+{
+    const size_t N       = FFTConvParams::TileSize(in_h, in_w);
+    const size_t Padding = FFTConvParams::TransposePadding;
+    const size_t halfw   = workSpaceSize / (2 * 2 * sizeof(float));
+
+    offset = halfw + N * (in_n * in_c + Padding);
+    count  = N * (in_c * out_c + Padding);
+}
+
 static int FindFFTKernel(Handle& handle,
                          const TensorDescriptor& xDesc,
                          const TensorDescriptor& wDesc,
@@ -388,7 +410,8 @@ static float ExecuteFFTKernel(Handle& handle,
                               Data_t workSpace,
                               size_t workSpaceSize,
                               bool timed,
-                              bool fwd)
+                              bool fwd,
+                              ConstData_t spectra)
 {
 
     (void)wDesc; // suppress warning
@@ -416,6 +439,21 @@ static float ExecuteFFTKernel(Handle& handle,
                 continue;
         }
 
+        // Filters transformed ahead replace the filter kernels
+        if(spectra != nullptr && (ik == 1 || ik == 3))
+        {
+            if(ik == 1)
+            {
+                size_t offset, count;
+                GetFFTFilterSpectra(in_h, in_w, in_n, in_c, out_c, workSpaceSize, offset, count);
+                const TensorDescriptor spectraDesc(miopenFloat, {2 * count});
+                CopyTensor(handle, spectraDesc, spectra, spectraDesc, workSpace, 0, 2 * offset);
+                if(timed)
+                    time_fft += handle.GetKernelTime();
+            }
+            continue;
+        }
+
         std::string network_config = config_prefix + std::to_string(ik);
 
         auto k = handle.GetKernel("miopenConvolutionFwdAlgoFFT", network_config);
@@ -469,9 +507,72 @@ float ConvolutionDescriptor::ExecuteFwdFFTKernel(Handle& handle,
                                                  size_t workSpaceSize,
                                                  bool timed) const
 {
+    const auto& cache                        = handle.GetFilterTransformCache();
+    const FilterTransformCache::Entry* entry = nullptr;
+    if(!cache.Empty())
+        entry = cache.Find(w,
+                           miopenConvolutionFwdAlgoFFT,
+                           ProblemDescription(xDesc, wDesc, yDesc, *this, 1));
+    return ExecuteFFTKernel(handle,
+                            xDesc,
+                            x,
+                            wDesc,
+                            w,
+                            yDesc,
+                            y,
+                            workSpace,
+                            workSpaceSize,
+                            timed,
+                            true,
+                            entry == nullptr ? nullptr : entry->data.get());
+}
+
+size_t ConvolutionDescriptor::ForwardGetFFTFilterSize(const TensorDescriptor& xDesc,
+                                                      const TensorDescriptor& yDesc) const
+{
+    int in_n, in_c, in_h, in_w;
+    std::tie(in_n, in_c, in_h, in_w) = miopen::tien<4>(xDesc.GetLengths());
+    int out_c;
+    std::tie(std::ignore, out_c, std::ignore, std::ignore) = miopen::tien<4>(yDesc.GetLengths());
+
+    size_t offset, count;
+    GetFFTFilterSpectra(in_h, in_w, in_n, in_c, out_c, 0, offset, count);
+    return count * 2 * sizeof(float);
+}
+
+void ConvolutionDescriptor::TransformFwdFFTFilters(Handle& handle,
+                                                   const TensorDescriptor& xDesc,
+                                                   const TensorDescriptor& wDesc,
+                                                   ConstData_t w,
+                                                   const TensorDescriptor& yDesc,
+                                                   Data_t workSpace,
+                                                   Data_t spectra) const
+{
+    int in_n, in_c, in_h, in_w;
+    std::tie(in_n, in_c, in_h, in_w) = miopen::tien<4>(xDesc.GetLengths());
+    int out_c;
+    std::tie(std::ignore, out_c, std::ignore, std::ignore) = miopen::tien<4>(yDesc.GetLengths());
+
+    // The kernels write at the CFF_HALFW they were built with, from the exact FFT workspace size
+    const size_t workspace_fft      = ForwardGetWorkSpaceSizeFFT(wDesc, xDesc, yDesc);
+    const std::string config_prefix = make_config_prefix(in_h, in_w, in_n, in_c, out_c);
+    if(!handle.HasKernel("miopenConvolutionFwdAlgoFFT", config_prefix + "1"))
+    {
+        std::vector<KernelInvoke> kernels;
+        std::string kcache_key;
+        if(FindFwdFFTKernel(handle, xDesc, wDesc, yDesc, workspace_fft, kernels, kcache_key) != 0)
+            MIOPEN_THROW(miopenStatusNotImplemented, "FFT is not applicable to this convolution");
+    }
+
+    handle.GetKernel("miopenConvolutionFwdAlgoFFT", config_prefix + "1")(w, workSpace);
+    // 7x7 images have no transposes
+    if(in_h != 7 || in_w != 7)
+        handle.GetKernel("miopenConvolutionFwdAlgoFFT", config_prefix + "3")(workSpace);
 
-    return ExecuteFFTKernel(
-        handle, xDesc, x, wDesc, w, yDesc, y, workSpace, workSpaceSize, timed, true);
+    size_t offset, count;
+    GetFFTFilterSpectra(in_h, in_w, in_n, in_c, out_c, workspace_fft, offset, count);
+    const TensorDescriptor spectraDesc(miopenFloat, {2 * count});
+    CopyTensor(handle, spectraDesc, workSpace, spectraDesc, spectra, 2 * offset, 0);
 }
 
 float ConvolutionDescriptor::ExecuteBwdFFTKernel(Handle& handle,
@@ -486,8 +587,18 @@ float ConvolutionDescriptor::ExecuteBwdFFTKernel(Handle& handle,
                                                  bool timed) const
 {
 
-    return ExecuteFFTKernel(
-        handle, dyDesc, dy, wDesc, w, dxDesc, dx, workSpace, workSpaceSize, timed, false);
+    return ExecuteFFTKernel(handle,
+                            dyDesc,
+                            dy,
+                            wDesc,
+                            w,
+                            dxDesc,
+                            dx,
+                            workSpace,
+                            workSpaceSize,
+                            timed,
+                            false,
+                            nullptr);
 }
 
 } // namespace miopen
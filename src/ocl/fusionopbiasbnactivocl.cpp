@@ -253,7 +253,7 @@ BatchNormInferenceFusionOpDescriptor::GetGlobalWGSz(Handle& /*handle*/,
 
 // BN Bwd Training start
 void BatchNormBwdTrainFusionOpDescriptor::calcBNParams(Handle& handle,
-                                                       std::vector<size_t> in_lens,
+                                                       const TensorDims& in_lens,
                                                        int& variant,
                                                        size_t& in_cstride,
                                                        size_t& in_nstride,
@@ -450,7 +450,7 @@ std::vector<size_t> BatchNormBwdTrainFusionOpDescriptor::GetGlobalWGSz(Handle& h
 /// BATCH NORMALIZATION training forward start ================
 
 void BatchNormFwdTrainFusionOpDescriptor::calcBNParams(Handle& handle,
-                                                       std::vector<size_t> in_lens,
+                                                       const TensorDims& in_lens,
                                                        int& variant,
                                                        size_t& in_cstride,
                                                        size_t& in_nstride,
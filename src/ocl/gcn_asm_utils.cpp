@@ -286,7 +286,7 @@ static void AmdgcnAssembleQuiet(std::string& source, const std::string& params)
 static bool GcnAssemblerHasBug34765Impl()
 {
     auto p = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
-    miopen::WriteFile(miopen::GetKernelSrc("bugzilla_34765_detect"), p);
+    miopen::WriteFile(miopen::GetKernelSrcView("bugzilla_34765_detect"), p);
     auto src = p.string();
     try
     {
@@ -309,7 +309,7 @@ bool GcnAssemblerHasBug34765()
 static bool GcnAssemblerSupportsOption(const std::string& option)
 {
     auto p = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
-    miopen::WriteFile(miopen::GetKernelSrc("dummy_kernel"), p);
+    miopen::WriteFile(miopen::GetKernelSrcView("dummy_kernel"), p);
     auto src = p.string();
     try
     {
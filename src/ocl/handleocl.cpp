@@ -37,6 +37,7 @@
 #if MIOPEN_USE_MIOPENGEMM
 #include <miopen/gemm_geometry.hpp>
 #endif
+#include <iostream>
 #include <string>
 
 #ifndef _WIN32
@@ -263,9 +264,15 @@ struct HandleImpl
     ContextPtr context;
     AqPtr queue;
     Allocator allocator{};
+    std::shared_ptr<AllocatorPool> pool;
     KernelCache cache;
     bool enable_profiling  = false;
     float profiling_result = 0.0;
+    bool enable_timings    = IsKernelTimingsEnabledByEnv();
+    KernelTimings timings;
+    std::shared_ptr<CommandGraphRecorder> recorder;
+    // Last, so the transformed filters are freed before the rest of the handle
+    FilterTransformCache transforms;
 
     ContextPtr create_context()
     {
@@ -335,14 +342,18 @@ struct HandleImpl
     void ResetProfilingResult() { profiling_result = 0.0; }
     void AccumProfilingResult(float curr_res) { profiling_result += curr_res; }
 
-    void SetProfilingResult(cl_event& e)
+    void SetProfilingResult(cl_event& e, const KernelTimingKey& key)
     {
-        if(this->enable_profiling)
+        if(this->enable_profiling || this->enable_timings)
         {
             size_t st, end;
             clGetEventProfilingInfo(e, CL_PROFILING_COMMAND_START, sizeof(size_t), &st, nullptr);
             clGetEventProfilingInfo(e, CL_PROFILING_COMMAND_END, sizeof(size_t), &end, nullptr);
-            profiling_result = ((end - st) * 1e-6);
+            const float time = ((end - st) * 1e-6);
+            if(this->enable_profiling)
+                profiling_result = time;
+            if(this->enable_timings)
+                timings.Record(key, time);
         }
     }
 };
@@ -432,7 +443,11 @@ Handle::Handle() : impl(new HandleImpl())
 }
 
 Handle::Handle(Handle&&) noexcept = default;
-Handle::~Handle()                 = default;
+Handle::~Handle()
+{
+    if(impl != nullptr && IsKernelTimingsEnabledByEnv() && !impl->timings.Empty())
+        std::cerr << impl->timings;
+}
 
 void Handle::SetStream(miopenAcceleratorQueue_t streamID) const
 {
@@ -460,6 +475,36 @@ void Handle::SetAllocator(miopenAllocatorFunction allocator,
 
     this->impl->allocator.context =
         allocatorContext == nullptr ? this->impl->context.get() : allocatorContext;
+
+    if(this->impl->pool != nullptr)
+    {
+        this->impl->pool = std::make_shared<AllocatorPool>(
+            this->impl->allocator, this->impl->pool->GetStats().max_cached);
+    }
+}
+
+void Handle::EnableMemoryPool(std::size_t max_cached_bytes)
+{
+    if(this->impl->pool != nullptr)
+        this->impl->pool->SetMaxCached(max_cached_bytes);
+    else
+        this->impl->pool = std::make_shared<AllocatorPool>(this->impl->allocator, max_cached_bytes);
+}
+
+// Buffers still in use keep the pool alive, it is released with the last of them.
+void Handle::DisableMemoryPool() { this->impl->pool = nullptr; }
+
+void Handle::TrimMemoryPool()
+{
+    if(this->impl->pool != nullptr)
+        this->impl->pool->Trim();
+}
+
+AllocatorPoolStats Handle::GetMemoryPoolStats() const
+{
+    if(this->impl->pool == nullptr)
+        return {};
+    return this->impl->pool->GetStats();
 }
 
 void Handle::EnableProfiling(bool enable) { this->impl->enable_profiling = enable; }
@@ -469,6 +514,38 @@ void Handle::AccumKernelTime(float curr_time) { this->impl->AccumProfilingResult
 
 float Handle::GetKernelTime() const { return this->impl->profiling_result; }
 
+void Handle::EnableKernelTimings(bool enable) { this->impl->enable_timings = enable; }
+bool Handle::IsKernelTimingsEnabled() const { return this->impl->enable_timings; }
+const KernelTimings& Handle::GetKernelTimings() const { return this->impl->timings; }
+void Handle::ResetKernelTimings() { this->impl->timings.Clear(); }
+
+FilterTransformCache& Handle::GetFilterTransformCache() { return this->impl->transforms; }
+
+void Handle::BeginCapture()
+{
+    if(this->impl->recorder != nullptr)
+        MIOPEN_THROW("Command capture is already in progress");
+    this->impl->recorder = std::make_shared<CommandGraphRecorder>();
+}
+
+void Handle::BindCaptureBuffer(std::size_t slot, ConstData_t buffer)
+{
+    if(this->impl->recorder == nullptr)
+        MIOPEN_THROW("No command capture in progress");
+    this->impl->recorder->BindBuffer(slot, buffer);
+}
+
+bool Handle::IsCapturing() const { return this->impl->recorder != nullptr; }
+
+CommandGraph Handle::EndCapture()
+{
+    if(this->impl->recorder == nullptr)
+        MIOPEN_THROW("No command capture in progress");
+    auto graph           = this->impl->recorder->Finish();
+    this->impl->recorder = nullptr;
+    return graph;
+}
+
 KernelInvoke Handle::AddKernel(const std::string& algorithm,
                                const std::string& network_config,
                                const std::string& program_name,
@@ -481,7 +558,7 @@ KernelInvoke Handle::AddKernel(const std::string& algorithm,
 
     auto obj = this->impl->cache.AddKernel(
         *this, algorithm, network_config, program_name, kernel_name, vld, vgd, params, cache_index);
-    return this->Run(obj);
+    return this->Run(obj, algorithm, network_config);
 }
 
 bool Handle::HasKernel(const std::string& algorithm, const std::string& network_config) const
@@ -501,19 +578,30 @@ const std::vector<Kernel>& Handle::GetKernelsImpl(const std::string& algorithm,
     return this->impl->cache.GetKernels(algorithm, network_config);
 }
 
-KernelInvoke Handle::Run(Kernel k)
+KernelInvoke Handle::Run(Kernel k) { return this->Run(k, "", ""); }
+
+KernelInvoke
+Handle::Run(Kernel k, const std::string& algorithm, const std::string& network_config)
 {
     auto q = this->GetStream();
-    if(this->impl->enable_profiling || MIOPEN_GPU_SYNC)
+    if(this->impl->enable_profiling || this->impl->enable_timings || MIOPEN_GPU_SYNC)
     {
-        return k.Invoke(q,
-                        std::bind(&HandleImpl::SetProfilingResult,
-                                  std::ref(*this->impl),
-                                  std::placeholders::_1));
+        KernelTimingKey key;
+        if(this->impl->enable_timings)
+            key = KernelTimingKey{algorithm, network_config, k.GetName()};
+        auto invoke = k.Invoke(q,
+                               std::bind(&HandleImpl::SetProfilingResult,
+                                         std::ref(*this->impl),
+                                         std::placeholders::_1,
+                                         std::move(key)));
+        invoke.recorder = this->impl->recorder;
+        return invoke;
     }
     else
     {
-        return k.Invoke(q);
+        auto invoke     = k.Invoke(q);
+        invoke.recorder = this->impl->recorder;
+        return invoke;
     }
 }
 
@@ -575,10 +663,18 @@ std::size_t Handle::GetMaxComputeUnits()
     return miopen::GetDeviceInfo<CL_DEVICE_MAX_COMPUTE_UNITS>(miopen::GetDevice(this->GetStream()));
 }
 
+std::size_t Handle::GetMaxClockFrequency()
+{
+    return miopen::GetDeviceInfo<CL_DEVICE_MAX_CLOCK_FREQUENCY>(
+        miopen::GetDevice(this->GetStream()));
+}
+
 Allocator::ManageDataPtr Handle::Create(std::size_t sz)
 {
     MIOPEN_HANDLE_LOCK
     this->Finish();
+    if(this->impl->pool != nullptr)
+        return this->impl->pool->GetAllocator()(sz);
     return this->impl->allocator(sz);
 }
 
@@ -611,6 +707,8 @@ void Handle::ReadTo(void* data, const Allocator::ManageDataPtr& ddata, std::size
 void Handle::Copy(ConstData_t src, Data_t dest, std::size_t size)
 {
     MIOPEN_HANDLE_LOCK
+    if(this->IsCapturing())
+        MIOPEN_THROW(miopenStatusNotImplemented, "Buffer copies cannot be captured");
     this->Finish();
     auto status =
         clEnqueueCopyBuffer(this->GetStream(), src, dest, 0, 0, size, 0, nullptr, nullptr);
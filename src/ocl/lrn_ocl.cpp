@@ -23,6 +23,7 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
 #include <miopen/lrn.hpp>
 #include <miopen/mlo_internal.hpp>
 #include <miopen/float_equal.hpp>
@@ -41,6 +42,10 @@ miopenStatus_t LRNDescriptor::Forward(Handle& handle,
                                       Data_t workSpace) const
 {
 
+#if MIOPEN_BACKEND_CPU
+    cpu::LRNForward(handle, *this, xDesc, x, yDesc, y, do_backward, workSpace);
+    return miopenStatusSuccess;
+#else
     miopenStatus_t status = miopenStatusSuccess;
     mlo_construct_norm construct_params(1); // forward
 
@@ -173,6 +178,7 @@ miopenStatus_t LRNDescriptor::Forward(Handle& handle,
         });
     }
     return (status);
+#endif
 }
 
 miopenStatus_t LRNDescriptor::Backward(Handle& handle,
@@ -188,6 +194,10 @@ miopenStatus_t LRNDescriptor::Backward(Handle& handle,
                                        Data_t dx,
                                        ConstData_t workSpace) const
 {
+#if MIOPEN_BACKEND_CPU
+    cpu::LRNBackward(handle, *this, yDesc, y, dyDesc, dy, xDesc, x, dxDesc, dx, workSpace);
+    return miopenStatusSuccess;
+#else
     miopenStatus_t status = miopenStatusSuccess;
     mlo_construct_norm construct_params(0); // backward
 
@@ -328,5 +338,6 @@ miopenStatus_t LRNDescriptor::Backward(Handle& handle,
         });
     }
     return (status);
+#endif
 }
 } // namespace miopen
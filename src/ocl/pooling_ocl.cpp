@@ -23,6 +23,7 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/mlo_internal.hpp>
 #include <miopen/pooling.hpp>
@@ -53,6 +54,10 @@ miopenStatus_t PoolingDescriptor::Forward(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::PoolingForward(handle, *this, xDesc, x, yDesc, y, do_backward, workSpace);
+    return miopenStatusSuccess;
+#else
     if(miopen::CheckNumericsEnabled() != 0)
     {
         miopen::checkNumericsInput(handle, xDesc, x);
@@ -145,6 +150,7 @@ miopenStatus_t PoolingDescriptor::Forward(Handle& handle,
     }
 
     return miopenStatusSuccess;
+#endif
 }
 
 miopenStatus_t PoolingDescriptor::Backward(Handle& handle,
@@ -166,6 +172,12 @@ miopenStatus_t PoolingDescriptor::Backward(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    (void)yDesc;
+    (void)xDesc;
+    cpu::PoolingBackward(handle, *this, dyDesc, dy, dxDesc, dx, workSpace);
+    return miopenStatusSuccess;
+#else
     if(miopen::CheckNumericsEnabled() != 0)
     {
         // miopen::checkNumericsInput(handle, yDesc, y); // not actually used?
@@ -304,5 +316,6 @@ miopenStatus_t PoolingDescriptor::Backward(Handle& handle,
     }
 
     return (status);
+#endif
 }
 } // namespace miopen
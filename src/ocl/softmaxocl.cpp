@@ -23,6 +23,7 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <miopen/cpu_ops.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/softmax.hpp>
 #include <miopen/float_equal.hpp>
@@ -58,6 +59,10 @@ miopenStatus_t SoftmaxForward(
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::SoftmaxForward(handle, yDesc, y);
+    return miopenStatusSuccess;
+#else
     int n, c, h, w;
     std::tie(n, c, h, w) = tien<4>(yDesc.GetLengths());
     // using workgroup size of 256 by default
@@ -159,6 +164,7 @@ miopenStatus_t SoftmaxForward(
         miopen::checkNumericsOutput(handle, yDesc, y);
     }
     return miopenStatusSuccess;
+#endif
 }
 
 miopenStatus_t SoftmaxBackward(Handle& handle,
@@ -178,6 +184,10 @@ miopenStatus_t SoftmaxBackward(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_BACKEND_CPU
+    cpu::SoftmaxBackward(handle, yDesc, y, dxDesc, dx);
+    return miopenStatusSuccess;
+#else
     if(miopen::CheckNumericsEnabled() != 0)
     {
         miopen::checkNumericsInput(handle, yDesc, y);
@@ -275,6 +285,7 @@ miopenStatus_t SoftmaxBackward(Handle& handle,
     }
 
     return miopenStatusSuccess;
+#endif
 }
 
 } // namespace miopen
@@ -25,6 +25,7 @@
  *******************************************************************************/
 #include <cassert>
 #include <algorithm>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/tensor.hpp>
 #include <miopen/tensor_ops.hpp>
@@ -81,8 +82,8 @@ TensorDescriptor GetFlattenedTensorDescriptor(const TensorDescriptor& desc)
 
 // Free Tensor Functions
 static void CreateBitmapAndGrid(unsigned int& bitmap,
-                                std::vector<std::size_t>& a_lens,
-                                std::vector<std::size_t>& c_lens,
+                                const TensorDims& a_lens,
+                                const TensorDims& c_lens,
                                 int& num_wg,
                                 int& work,
                                 int d)
@@ -1249,6 +1250,23 @@ void OpTensor(Handle& handle,
         }
     }
 
+#if MIOPEN_BACKEND_CPU
+    cpu::OpTensor(handle,
+                  tensorOp,
+                  alpha0,
+                  aTensorDesc,
+                  ATensor,
+                  alpha1,
+                  bTensorDesc,
+                  BTensor,
+                  beta,
+                  cTensorDesc,
+                  CTensor,
+                  Aoffset,
+                  Boffset,
+                  Coffset);
+    return;
+#else
     auto bsize = blens.size();
     if(bsize == 3)
     {
@@ -1301,8 +1319,10 @@ void OpTensor(Handle& handle,
                       Boffset,
                       Coffset);
     }
+#endif
 }
 
+#if !MIOPEN_BACKEND_CPU
 static std::string parms_half_or_float(const miopenDataType_t t)
 {
     std::string s{};
@@ -1349,7 +1369,7 @@ struct two_exp_ceiling_t
     }
 };
 
-static std::vector<std::size_t> get_worker_sizes(const std::vector<std::size_t>& data_sizes)
+static std::vector<std::size_t> get_worker_sizes(const TensorDims& data_sizes)
 {
     const std::size_t dim = data_sizes.size();
 
@@ -1376,6 +1396,7 @@ static std::vector<std::size_t> get_worker_sizes(const std::vector<std::size_t>&
 
     return worker_sizes;
 }
+#endif
 
 void SetTensor(
     Handle& handle, const TensorDescriptor& yDesc, Data_t y, const void* alpha, const int offset)
@@ -1385,6 +1406,10 @@ void SetTensor(
         MIOPEN_THROW(miopenStatusBadParm);
     }
 
+#if MIOPEN_BACKEND_CPU
+    cpu::SetTensor(handle, yDesc, y, alpha, offset);
+    return;
+#else
     const TensorDescriptor yDesc_flat = GetFlattenedTensorDescriptor(yDesc);
 
 #ifndef NDEBUG
@@ -1531,6 +1556,7 @@ void SetTensor(
     }
     default: assert(false);
     }
+#endif
 }
 
 void ScaleTensor(
@@ -1541,6 +1567,10 @@ void ScaleTensor(
         MIOPEN_THROW(miopenStatusBadParm);
     }
 
+#if MIOPEN_BACKEND_CPU
+    cpu::ScaleTensor(handle, yDesc, y, alpha, offset);
+    return;
+#else
     const TensorDescriptor yDesc_flat = GetFlattenedTensorDescriptor(yDesc);
 
 #ifndef NDEBUG
@@ -1564,7 +1594,7 @@ void ScaleTensor(
 
     std::string kernel_name = "SubTensorOpWithScalar" + std::to_string(yDim_flat) + "d";
 
-    const std::vector<std::size_t>& lens = yDesc_flat.GetLengths();
+    const TensorDims& lens = yDesc_flat.GetLengths();
 
     std::string network_config = "scale " + std::to_string(yDesc_flat.GetType());
     for(auto& len : lens)
@@ -1693,6 +1723,7 @@ void ScaleTensor(
     }
     default: assert(false);
     }
+#endif
 }
 
 void CopyTensor(Handle& handle,
@@ -1700,8 +1731,8 @@ void CopyTensor(Handle& handle,
                 ConstData_t src,
                 const TensorDescriptor& dstDesc,
                 Data_t dst,
-                int srcOffset,
-                int dstOffset)
+                std::size_t srcOffset,
+                std::size_t dstOffset)
 {
     if(src == nullptr || dst == nullptr)
     {
@@ -1718,6 +1749,10 @@ void CopyTensor(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "Tensor dimension lengths do not match.");
     }
 
+#if MIOPEN_BACKEND_CPU
+    cpu::CopyTensor(handle, srcDesc, src, dstDesc, dst, srcOffset, dstOffset);
+    return;
+#else
     auto flat_descriptors = GetConsistentFlattenedTensorDescriptors(srcDesc, dstDesc);
     const TensorDescriptor& srcDesc_flat = std::get<0>(flat_descriptors);
     const TensorDescriptor& dstDesc_flat = std::get<1>(flat_descriptors);
@@ -1744,7 +1779,7 @@ void CopyTensor(Handle& handle,
     {
         std::string kernel_name = "SubTensorOpWithSubTensor" + std::to_string(srcDim_flat) + "d";
 
-        const std::vector<std::size_t>& lens = srcDesc_flat.GetLengths();
+        const TensorDims& lens = srcDesc_flat.GetLengths();
 
         std::string network_config = "copy " + std::to_string(srcDesc_flat.GetType());
         for(auto& len : lens)
@@ -1795,11 +1830,11 @@ void CopyTensor(Handle& handle,
         case 1:
         {
             kernel(src,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetLengths()[0]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]));
 
             break;
@@ -1807,13 +1842,13 @@ void CopyTensor(Handle& handle,
         case 2:
         {
             kernel(src,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetLengths()[0]),
                    int(srcDesc_flat.GetLengths()[1]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]));
 
@@ -1822,7 +1857,7 @@ void CopyTensor(Handle& handle,
         case 3:
         {
             kernel(src,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetStrides()[2]),
@@ -1830,7 +1865,7 @@ void CopyTensor(Handle& handle,
                    int(srcDesc_flat.GetLengths()[1]),
                    int(srcDesc_flat.GetLengths()[2]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]),
                    int(dstDesc_flat.GetStrides()[2]));
@@ -1840,7 +1875,7 @@ void CopyTensor(Handle& handle,
         case 4:
         {
             kernel(src,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetStrides()[2]),
@@ -1850,7 +1885,7 @@ void CopyTensor(Handle& handle,
                    int(srcDesc_flat.GetLengths()[2]),
                    int(srcDesc_flat.GetLengths()[3]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]),
                    int(dstDesc_flat.GetStrides()[2]),
@@ -1861,7 +1896,7 @@ void CopyTensor(Handle& handle,
         case 5:
         {
             kernel(src,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetStrides()[2]),
@@ -1873,7 +1908,7 @@ void CopyTensor(Handle& handle,
                    int(srcDesc_flat.GetLengths()[3]),
                    int(srcDesc_flat.GetLengths()[4]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]),
                    int(dstDesc_flat.GetStrides()[2]),
@@ -1889,6 +1924,7 @@ void CopyTensor(Handle& handle,
     {
         handle.Copy(src, dst, srcDesc_flat.GetElementSize() * GetTypeSize(srcDesc_flat.GetType()));
     }
+#endif
 }
 
 void CastTensor(Handle& handle,
@@ -1897,8 +1933,8 @@ void CastTensor(Handle& handle,
                 ConstData_t src,
                 const TensorDescriptor& dstDesc,
                 Data_t dst,
-                int srcOffset,
-                int dstOffset)
+                std::size_t srcOffset,
+                std::size_t dstOffset)
 {
     if(src == nullptr || dst == nullptr)
     {
@@ -1910,6 +1946,10 @@ void CastTensor(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "Tensor dimension lengths do not match.");
     }
 
+#if MIOPEN_BACKEND_CPU
+    cpu::CastTensor(handle, alpha, srcDesc, src, dstDesc, dst, srcOffset, dstOffset);
+    return;
+#else
     auto flat_descriptors = GetConsistentFlattenedTensorDescriptors(srcDesc, dstDesc);
     const TensorDescriptor& srcDesc_flat = std::get<0>(flat_descriptors);
     const TensorDescriptor& dstDesc_flat = std::get<1>(flat_descriptors);
@@ -1941,7 +1981,7 @@ void CastTensor(Handle& handle,
     {
         std::string kernel_name = "SubTensorOpWithCastTensor" + std::to_string(srcDim_flat) + "d";
 
-        const std::vector<std::size_t>& lens = srcDesc_flat.GetLengths();
+        const TensorDims& lens = srcDesc_flat.GetLengths();
 
         std::string network_config = "cast " + std::to_string(dstDesc_flat.GetType());
         for(auto& len : lens)
@@ -2011,11 +2051,11 @@ void CastTensor(Handle& handle,
         {
             kernel(src,
                    miopen_alpha,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetLengths()[0]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]));
 
             break;
@@ -2024,13 +2064,13 @@ void CastTensor(Handle& handle,
         {
             kernel(src,
                    miopen_alpha,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetLengths()[0]),
                    int(srcDesc_flat.GetLengths()[1]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]));
 
@@ -2040,7 +2080,7 @@ void CastTensor(Handle& handle,
         {
             kernel(src,
                    miopen_alpha,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetStrides()[2]),
@@ -2048,7 +2088,7 @@ void CastTensor(Handle& handle,
                    int(srcDesc_flat.GetLengths()[1]),
                    int(srcDesc_flat.GetLengths()[2]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]),
                    int(dstDesc_flat.GetStrides()[2]));
@@ -2059,7 +2099,7 @@ void CastTensor(Handle& handle,
         {
             kernel(src,
                    miopen_alpha,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetStrides()[2]),
@@ -2069,7 +2109,7 @@ void CastTensor(Handle& handle,
                    int(srcDesc_flat.GetLengths()[2]),
                    int(srcDesc_flat.GetLengths()[3]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]),
                    int(dstDesc_flat.GetStrides()[2]),
@@ -2081,7 +2121,7 @@ void CastTensor(Handle& handle,
         {
             kernel(src,
                    miopen_alpha,
-                   srcOffset,
+                   long(srcOffset),
                    int(srcDesc_flat.GetStrides()[0]),
                    int(srcDesc_flat.GetStrides()[1]),
                    int(srcDesc_flat.GetStrides()[2]),
@@ -2093,7 +2133,7 @@ void CastTensor(Handle& handle,
                    int(srcDesc_flat.GetLengths()[3]),
                    int(srcDesc_flat.GetLengths()[4]),
                    dst,
-                   dstOffset,
+                   long(dstOffset),
                    int(dstDesc_flat.GetStrides()[0]),
                    int(dstDesc_flat.GetStrides()[1]),
                    int(dstDesc_flat.GetStrides()[2]),
@@ -2105,6 +2145,7 @@ void CastTensor(Handle& handle,
         default: assert(false);
         }
     }
+#endif
 }
 
 void TransformTensor(Handle& handle,
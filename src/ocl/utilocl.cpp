@@ -24,6 +24,7 @@
  *
  *******************************************************************************/
 #include <cmath>
+#include <miopen/cpu_ops.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/util.hpp>
 #include <miopen/logger.hpp>
@@ -35,9 +36,9 @@
 namespace miopen {
 
 float Im2ColGPU(Handle& handle,
-                const int data_size,
+                const std::size_t data_size,
                 ConstData_t im,
-                const int im_offset,
+                const std::size_t im_offset,
                 const int c,
                 const int h,
                 const int w,
@@ -53,6 +54,49 @@ float Im2ColGPU(Handle& handle,
                 const int dilation_w,
                 Data_t col,
                 miopenDataType_t type)
+{
+    return Im2ColBatchedGPU(handle,
+                            data_size,
+                            im,
+                            im_offset,
+                            1,
+                            c,
+                            h,
+                            w,
+                            wei_h,
+                            wei_w,
+                            out_h,
+                            out_w,
+                            pad_h,
+                            pad_w,
+                            stride_h,
+                            stride_w,
+                            dilation_h,
+                            dilation_w,
+                            col,
+                            type);
+}
+
+float Im2ColBatchedGPU(Handle& handle,
+                       const std::size_t data_size,
+                       ConstData_t im,
+                       const std::size_t im_offset,
+                       const int n,
+                       const int c,
+                       const int h,
+                       const int w,
+                       const int wei_h,
+                       const int wei_w,
+                       const int out_h,
+                       const int out_w,
+                       const int pad_h,
+                       const int pad_w,
+                       const int stride_h,
+                       const int stride_w,
+                       const int dilation_h,
+                       const int dilation_w,
+                       Data_t col,
+                       miopenDataType_t type)
 {
     std::string program_name = "MIOpenUtilKernels.cl";
     std::string kernel_name  = "Im2Col";
@@ -62,17 +106,17 @@ float Im2ColGPU(Handle& handle,
                                  std::to_string(wei_w) + "p" + std::to_string(pad_h) + "q" +
                                  std::to_string(pad_w) + "u" + std::to_string(stride_h) + "v" +
                                  std::to_string(stride_w) + "l" + std::to_string(dilation_h) + "j" +
-                                 std::to_string(dilation_w) + "t" + std::to_string(type);
+                                 std::to_string(dilation_w) + "t" + std::to_string(type) + "n" +
+                                 std::to_string(n);
 
     auto&& kernels = handle.GetKernels("miopenIm2Col", network_config);
 
     if(!kernels.empty())
     {
-        int data_size_off = data_size - im_offset;
-        auto kernel       = kernels.front();
-        kernel(data_size_off,
+        auto kernel = kernels.front();
+        kernel(long(data_size - im_offset),
                im,
-               im_offset,
+               long(im_offset),
                h,
                w,
                wei_h,
@@ -121,7 +165,6 @@ float Im2ColGPU(Handle& handle,
         if(extreme_case > MAX_LOCAL_MEM)
         {
             params += " -DEXTREME_LARGE";
-            params += " -DNUM_CH_TOTAL=" + std::to_string(c);
         }
         else
         {
@@ -149,9 +192,8 @@ float Im2ColGPU(Handle& handle,
             }
         }
 
-        int data_size_off = data_size - im_offset;
-
         params += " -DNUM_CH_PER_WG=" + std::to_string(num_ch_per_wg);
+        params += " -DNUM_CH_TOTAL=" + std::to_string(c);
         params += " -DNUM_IM_BLKS_X=" + std::to_string(num_blks_x);
         params += " -DNUM_IM_BLKS=" + std::to_string(num_blks);
         params += " -DLOCAL_MEM_SIZE=" + std::to_string(local_mem_sz);
@@ -169,13 +211,13 @@ float Im2ColGPU(Handle& handle,
 
         const std::vector<size_t> vld{256, 1, 1};
         size_t global_threads = 256 * std::max(1, (c / num_ch_per_wg)) * num_blks;
-        const std::vector<size_t> vgd{global_threads, 1, 1};
+        const std::vector<size_t> vgd{global_threads, static_cast<size_t>(n), 1};
 
         handle.AddKernel(
             "miopenIm2Col", network_config, program_name, kernel_name, vld, vgd, params)(
-            data_size_off,
+            long(data_size - im_offset),
             im,
-            im_offset,
+            long(im_offset),
             h,
             w,
             wei_h,
@@ -210,7 +252,7 @@ float Col2ImGPU(Handle& handle,
                 const int h,
                 const int w,
                 Data_t im,
-                int im_offset,
+                std::size_t im_offset,
                 miopenDataType_t type)
 {
     std::string program_name = "MIOpenUtilKernels2.cl";
@@ -242,7 +284,7 @@ float Col2ImGPU(Handle& handle,
                h,
                w,
                im,
-               im_offset);
+               long(im_offset));
     }
     else
     {
@@ -257,21 +299,22 @@ float Col2ImGPU(Handle& handle,
         const std::vector<size_t> vgd{global_threads, 1, 1};
 
         handle.AddKernel(
-            "miopenCol2Im", network_config, program_name, kernel_name, vld, vgd, params)(col,
-                                                                                         col_h,
-                                                                                         col_w,
-                                                                                         wei_h,
-                                                                                         wei_w,
-                                                                                         pad_h,
-                                                                                         pad_w,
-                                                                                         stride_h,
-                                                                                         stride_w,
-                                                                                         dilation_h,
-                                                                                         dilation_w,
-                                                                                         h,
-                                                                                         w,
-                                                                                         im,
-                                                                                         im_offset);
+            "miopenCol2Im", network_config, program_name, kernel_name, vld, vgd, params)(
+            col,
+            col_h,
+            col_w,
+            wei_h,
+            wei_w,
+            pad_h,
+            pad_w,
+            stride_h,
+            stride_w,
+            dilation_h,
+            dilation_w,
+            h,
+            w,
+            im,
+            long(im_offset));
     }
     return handle.GetKernelTime();
 }
@@ -291,7 +334,23 @@ float transpose_NCHW2CNHW(Handle& handle,
                           int w_stride,
                           miopenDataType_t type)
 {
-
+#if MIOPEN_BACKEND_CPU
+    cpu::TransposeNCHW2CNHW(handle,
+                            n,
+                            c,
+                            h_in,
+                            w_in,
+                            h_out,
+                            w_out,
+                            in,
+                            out,
+                            in_offset,
+                            out_offset,
+                            h_stride,
+                            w_stride,
+                            type);
+    return handle.GetKernelTime();
+#else
     std::string program_name = "MIOpenUtilKernels4.cl";
 
     std::string network_config = "n" + std::to_string(n) + "c" + std::to_string(c) + "h" +
@@ -399,6 +458,7 @@ float transpose_NCHW2CNHW(Handle& handle,
     }
 
     return handle.GetKernelTime();
+#endif
 }
 
 float transpose_CNHW2NCHW(Handle& handle,
@@ -416,7 +476,23 @@ float transpose_CNHW2NCHW(Handle& handle,
                           int w_stride,
                           miopenDataType_t type)
 {
-
+#if MIOPEN_BACKEND_CPU
+    cpu::TransposeCNHW2NCHW(handle,
+                            n,
+                            c,
+                            h_out,
+                            w_out,
+                            h_in,
+                            w_in,
+                            in,
+                            out,
+                            in_offset,
+                            out_offset,
+                            h_stride,
+                            w_stride,
+                            type);
+    return handle.GetKernelTime();
+#else
     std::string program_name = "MIOpenUtilKernels4.cl";
 
     std::string network_config = "n" + std::to_string(n) + "c" + std::to_string(c) + "h" +
@@ -524,6 +600,58 @@ float transpose_CNHW2NCHW(Handle& handle,
     }
 
     return handle.GetKernelTime();
+#endif
+}
+
+float CopyRowsGPU(Handle& handle,
+                  ConstData_t src,
+                  Data_t dst,
+                  ConstData_t rows,
+                  const int n_rows,
+                  const int width,
+                  const int slices,
+                  const int slice_rows,
+                  const bool scatter,
+                  miopenDataType_t type)
+{
+#if MIOPEN_BACKEND_CPU
+    cpu::CopyRows(handle, src, dst, rows, n_rows, width, slices, slice_rows, scatter, type);
+    return handle.GetKernelTime();
+#else
+    std::string program_name = "MIOpenUtilKernels5.cl";
+    std::string kernel_name  = "CopyRows";
+
+    std::string network_config = "t" + std::to_string(type);
+
+    auto&& kernels = handle.GetKernels("miopenCopyRows", network_config);
+
+    if(!kernels.empty())
+    {
+        auto kernel = kernels.front();
+        kernel(src, dst, rows, n_rows, width, slices, slice_rows, int(scatter));
+    }
+    else
+    {
+        std::string params;
+        if(type == miopenFloat)
+            params += "-DMIOPEN_USE_FP16=0 -DMIOPEN_USE_FP32=1";
+        else
+            params += "-DMIOPEN_USE_FP16=1 -DMIOPEN_USE_FP32=0";
+
+        // The kernel loops over the elements, so the grid is capped at the threads the device
+        // keeps active
+        const std::size_t total = std::size_t(slices) * n_rows * width;
+        const std::vector<size_t> vld{WG_SIZE, 1, 1};
+        const std::size_t global_threads =
+            std::min<std::size_t>((total + WG_SIZE - 1) / WG_SIZE * WG_SIZE, MAX_ACTIVE_THREADS);
+        const std::vector<size_t> vgd{global_threads, 1, 1};
+
+        handle.AddKernel(
+            "miopenCopyRows", network_config, program_name, kernel_name, vld, vgd, params)(
+            src, dst, rows, n_rows, width, slices, slice_rows, int(scatter));
+    }
+    return handle.GetKernelTime();
+#endif
 }
 
 } // namespace miopen
@@ -87,6 +87,17 @@ void OCLKernelInvoke::run() const
     }
 }
 
+void OCLKernelInvoke::Record(std::vector<OpKernelArg> args) const
+{
+    auto launcher     = *this;
+    launcher.recorder = nullptr;
+    recorder->Record(GetName(),
+                     {local_work_dim.begin(), local_work_dim.begin() + work_dim},
+                     {global_work_dim.begin(), global_work_dim.begin() + work_dim},
+                     std::move(args),
+                     [launcher](std::vector<OpKernelArg>& replay_args) { launcher(replay_args); });
+}
+
 std::string OCLKernelInvoke::GetName() const
 {
     std::array<char, 200> buffer{};
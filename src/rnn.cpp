@@ -27,6 +27,8 @@
 #include <miopen/rnn.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/env.hpp>
+#include <miopen/make_unique.hpp>
+#include <miopen/util.hpp>
 
 // MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_AMD_ROCM_PRECOMPILED_BINARIES)
 // MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_AMD_ASM_KERNELS_PERF_FILTERING)
@@ -275,6 +277,33 @@ std::vector<int> RNNDescriptor::pTensorLengthsCalculation(const TensorDescriptor
     return tdim;
 }
 
+RNNWeightLayout RNNDescriptor::WeightLayout(const TensorDescriptor& xDesc) const
+{
+    return RNNWeightLayout(isRNNskip() ? 0 : xDesc.GetLengths()[1],
+                           hsize,
+                           dirMode == miopenRNNbidirection ? 2 : 1,
+                           nLayers,
+                           nHiddenTensorsPerLayer,
+                           biasMode == miopenRNNwithBias);
+}
+
+TensorDescriptor RNNDescriptor::PackedParamDescriptor(const TensorDescriptor& xDesc,
+                                                      const std::vector<int>& pDims,
+                                                      size_t& poffset) const
+{
+    const auto layout = WeightLayout(xDesc);
+    const auto* block = layout.Find(poffset);
+    if(block == nullptr || block->columns != static_cast<std::size_t>(pDims[1]))
+    {
+        MIOPEN_THROW(miopenStatusInternalError, "Parameter is not a weight matrix");
+    }
+    poffset = RNNWeightLayout::Packed(*block, poffset);
+
+    // Column i of the parameter is row i of the transposed block
+    std::vector<int> pstride{1, static_cast<int>(block->rows)};
+    return miopen::TensorDescriptor(dataType, pDims.data(), pstride.data(), 2);
+}
+
 RNNDescriptor::RNNDescriptor()
 {
     nLayers                = 1;
@@ -353,6 +382,35 @@ RNNDescriptor::RNNDescriptor(int hsz,
     }
 }
 
+RNNPlanShape RNNDescriptor::PlanShape(RNNPlanShape::Pass pass,
+                                      miopenDataType_t dtype,
+                                      std::vector<int> batches,
+                                      int in_h,
+                                      int hy_d,
+                                      int hy_n,
+                                      int hy_h,
+                                      int out_h) const
+{
+    RNNPlanShape shape{};
+    shape.pass            = pass;
+    shape.rnn_mode        = rnnMode;
+    shape.input_mode      = inputMode;
+    shape.dir_mode        = dirMode;
+    shape.bias_mode       = biasMode;
+    shape.n_layers        = nLayers;
+    shape.hidden_tensors  = nHiddenTensorsPerLayer;
+    shape.workspace_scale = workspaceScale;
+    shape.weight_layout   = weightLayout;
+    shape.data_type       = dtype;
+    shape.batches         = std::move(batches);
+    shape.in_h            = in_h;
+    shape.hy_d            = hy_d;
+    shape.hy_n            = hy_n;
+    shape.hy_h            = hy_h;
+    shape.out_h           = out_h;
+    return shape;
+}
+
 size_t RNNDescriptor::GetWorkspaceSize(Handle& /* handle */,
                                        const int seqLength,
                                        c_array_view<const miopenTensorDescriptor_t> xDesc) const
@@ -546,6 +604,12 @@ void RNNDescriptor::GetLayerParam(Handle& handle,
 #endif
 
     // Copy over data to previously allocated param tensor
+    if(weightLayout == miopenRNNWeightsPacked)
+    {
+        auto paramSrc = PackedParamDescriptor(xDesc, pDims, poffset);
+        miopen::CopyTensor(handle, paramSrc, w, paramDesc, param, poffset, 0);
+        return;
+    }
     miopen::CopyTensor(handle, paramDesc, w, paramDesc, param, poffset, 0);
 }
 
@@ -639,6 +703,11 @@ void RNNDescriptor::SetLayerParam(Handle& handle,
             paramDesc.GetElementSize());
 #endif
 
+    if(weightLayout == miopenRNNWeightsPacked)
+    {
+        paramSrc = PackedParamDescriptor(xDesc, intLens, poffset);
+    }
+
     // 4. Copy over data to previously allocated param tensor
     miopen::CopyTensor(handle, paramDesc, param, paramSrc, w, 0, poffset);
 }
@@ -711,13 +780,18 @@ void RNNDescriptor::GetLayerParamOffset(const int layer,
     // Get the dimensions of the parameter matrix
     auto pDims = pTensorLengthsCalculation(xDesc, layer, paramID);
     paramDesc  = miopen::TensorDescriptor(dataType, pDims.data(), 2);
+
+    // Calculate the location of the matrix via paramID, bidirection setting, and params
+    auto poffset = paramsOffsetCalculation(xDesc, layer, paramID);
+    if(weightLayout == miopenRNNWeightsPacked)
+    {
+        paramDesc = PackedParamDescriptor(xDesc, pDims, poffset);
+    }
     if(paramOffset == nullptr)
     {
         return;
     }
-
-    // Calculate the location of the matrix via paramID, bidirection setting, and params
-    *paramOffset = paramsOffsetCalculation(xDesc, layer, paramID);
+    *paramOffset = poffset;
 
 #if(MIO_RNN_DEBUG == 1)
     fprintf(stderr,
@@ -764,6 +838,298 @@ void RNNDescriptor::GetLayerBiasOffset(const int layer,
 #endif
 }
 
+void RNNDescriptor::PackWeights(Handle& handle,
+                                const TensorDescriptor& xDesc,
+                                const TensorDescriptor& wDesc,
+                                ConstData_t src,
+                                Data_t dst,
+                                const bool pack) const
+{
+    if(xDesc.GetType() != dataType || wDesc.GetType() != dataType)
+    {
+        MIOPEN_THROW(miopenStatusBadParm, "Data type mismatch.");
+    }
+    if(src == dst)
+    {
+        MIOPEN_THROW(miopenStatusBadParm, "RNN weights cannot be repacked in place");
+    }
+
+    const auto layout = WeightLayout(xDesc);
+    if(wDesc.GetElementSize() < layout.size)
+    {
+        MIOPEN_THROW(miopenStatusBadParm, "Parameter tensor is too small");
+    }
+
+    // One strided copy per block: row major in the canonical layout, column major when packed
+    for(const auto& block : layout.blocks)
+    {
+        std::vector<int> lens{static_cast<int>(block.rows), static_cast<int>(block.columns)};
+        std::vector<int> rowMajor{static_cast<int>(block.columns), 1};
+        std::vector<int> colMajor{1, static_cast<int>(block.rows)};
+        auto canonicalDesc = miopen::TensorDescriptor(dataType, lens.data(), rowMajor.data(), 2);
+        auto packedDesc    = miopen::TensorDescriptor(dataType, lens.data(), colMajor.data(), 2);
+        miopen::CopyTensor(handle,
+                           pack ? canonicalDesc : packedDesc,
+                           src,
+                           pack ? packedDesc : canonicalDesc,
+                           dst,
+                           block.offset,
+                           block.offset);
+    }
+
+    if(layout.size > layout.bias_offset)
+    {
+        auto bdim     = static_cast<int>(layout.size - layout.bias_offset);
+        auto biasDesc = miopen::TensorDescriptor(dataType, &bdim, 1);
+        miopen::CopyTensor(
+            handle, biasDesc, src, biasDesc, dst, layout.bias_offset, layout.bias_offset);
+    }
+}
+
+namespace {
+
+// Descriptors of the time steps of a packed batch
+struct PackedSteps
+{
+    std::vector<TensorDescriptor> descs;
+    std::vector<miopenTensorDescriptor_t> handles;
+
+    PackedSteps(const RNNSequencePacking& packing, const TensorDescriptor& step)
+    {
+        for(int batch : packing.batches)
+            descs.push_back(
+                TensorDescriptor(step.GetType(), {std::size_t(batch), step.GetLengths()[1]}));
+        for(auto& desc : descs)
+            handles.push_back(&desc);
+    }
+
+    c_array_view<const miopenTensorDescriptor_t> View() const
+    {
+        return {handles.data(), handles.size()};
+    }
+};
+
+// Sections of the RNNForwardInferenceUnsorted workspace, in bytes. Sections start at 4 KiB
+// boundaries, above the base address alignment OpenCL requires of sub-buffers.
+struct UnsortedWorkspace
+{
+    std::size_t rnn   = 0;
+    std::size_t x     = 0;
+    std::size_t y     = 0;
+    std::size_t hx    = 0;
+    std::size_t cx    = 0;
+    std::size_t hy    = 0;
+    std::size_t cy    = 0;
+    std::size_t total = 0;
+
+    UnsortedWorkspace(Handle& handle,
+                      const RNNDescriptor& rnn_desc,
+                      const RNNSequencePacking& packing,
+                      const PackedSteps& x_steps)
+    {
+        const std::size_t bi     = rnn_desc.dirMode == miopenRNNbidirection ? 2 : 1;
+        const std::size_t rows   = packing.PackedRows();
+        const std::size_t in_h   = x_steps.descs[0].GetLengths()[1];
+        const std::size_t hidden = rnn_desc.hsize * rnn_desc.typeSize;
+        const std::size_t states = rnn_desc.nLayers * bi * packing.BatchSize() * hidden;
+
+        const std::size_t rnn_bytes =
+            rnn_desc.GetWorkspaceSize(handle, packing.SeqLen(), x_steps.View());
+        for(auto section : {std::make_pair(&rnn, rnn_bytes),
+                            std::make_pair(&x, rows * in_h * rnn_desc.typeSize),
+                            std::make_pair(&y, rows * bi * hidden),
+                            std::make_pair(&hx, states),
+                            std::make_pair(&cx, states),
+                            std::make_pair(&hy, states),
+                            std::make_pair(&cy, states)})
+        {
+            *section.first = total;
+            total += (section.second + 4095) / 4096 * 4096;
+        }
+    }
+};
+
+// The rows of runs on the device, the index of the copies between the padded and the packed
+// layout. Each copy is one kernel however many runs the packing has.
+struct PackingRows
+{
+    Allocator::ManageDataPtr rows;
+    int n_rows;
+
+    PackingRows(Handle& handle, const std::vector<RNNSequencePacking::Run>& runs)
+    {
+        const auto padded = RNNSequencePacking::PaddedRows(runs);
+        rows              = handle.Write(padded);
+        n_rows            = static_cast<int>(padded.size());
+    }
+
+    // State rows cover one layer slice of slice_rows rows and repeat for every slice
+    void Copy(Handle& handle,
+              miopenDataType_t type,
+              bool pack,
+              std::size_t width,
+              std::size_t slices,
+              std::size_t slice_rows,
+              ConstData_t src,
+              Data_t dst) const
+    {
+        CopyRowsGPU(handle,
+                    src,
+                    dst,
+                    rows.get(),
+                    n_rows,
+                    static_cast<int>(width),
+                    static_cast<int>(slices),
+                    static_cast<int>(slice_rows),
+                    !pack,
+                    type);
+    }
+};
+
+RNNSequencePacking CheckedPacking(int seqLen,
+                                  c_array_view<const miopenTensorDescriptor_t> xDesc,
+                                  c_array_view<const miopenTensorDescriptor_t> yDesc,
+                                  const std::vector<int>& lengths)
+{
+    RNNSequencePacking packing(lengths);
+    if(packing.SeqLen() > seqLen)
+        MIOPEN_THROW(miopenStatusBadParm, "A sequence is longer than the time steps given");
+    for(int t = 0; t < seqLen; t++)
+    {
+        if(xDesc[t].GetLengths()[0] != lengths.size() ||
+           (yDesc.data != nullptr && yDesc[t].GetLengths()[0] != lengths.size()))
+            MIOPEN_THROW(miopenStatusBadParm,
+                         "Every time step of a padded batch must hold all sequences");
+    }
+    return packing;
+}
+
+} // namespace
+
+size_t RNNDescriptor::GetUnsortedWorkspaceSize(Handle& handle,
+                                               const int seqLen,
+                                               c_array_view<const miopenTensorDescriptor_t> xDesc,
+                                               const std::vector<int>& lengths) const
+{
+    const auto packing = CheckedPacking(seqLen, xDesc, {nullptr, 0}, lengths);
+    return UnsortedWorkspace(handle, *this, packing, PackedSteps(packing, xDesc[0])).total;
+}
+
+void RNNDescriptor::RNNForwardInferenceUnsorted(Handle& handle,
+                                                const int seqLen,
+                                                c_array_view<const miopenTensorDescriptor_t> xDesc,
+                                                const std::vector<int>& lengths,
+                                                ConstData_t x,
+                                                const TensorDescriptor& hxDesc,
+                                                ConstData_t hx,
+                                                const TensorDescriptor& cxDesc,
+                                                ConstData_t cx,
+                                                const TensorDescriptor& wDesc,
+                                                ConstData_t w,
+                                                c_array_view<const miopenTensorDescriptor_t> yDesc,
+                                                Data_t y,
+                                                const TensorDescriptor& hyDesc,
+                                                Data_t hy,
+                                                const TensorDescriptor& cyDesc,
+                                                Data_t cy,
+                                                Data_t workSpace,
+                                                size_t workSpaceSize) const
+{
+    if(x == nullptr || y == nullptr)
+    {
+        MIOPEN_THROW(miopenStatusBadParm);
+    }
+    const auto packing = CheckedPacking(seqLen, xDesc, yDesc, lengths);
+    const PackedSteps x_steps(packing, xDesc[0]);
+    const PackedSteps y_steps(packing, yDesc[0]);
+    const UnsortedWorkspace layout(handle, *this, packing, x_steps);
+    if(workSpaceSize < layout.total)
+    {
+        MIOPEN_THROW("Workspace is required");
+    }
+
+    const auto type  = xDesc[0].GetType();
+    const auto batch = std::size_t(packing.BatchSize());
+    const auto in_h  = xDesc[0].GetLengths()[1];
+    const auto out_h = yDesc[0].GetLengths()[1];
+    const auto hy_d  = hxDesc.GetLengths()[0];
+    const auto hy_h  = hxDesc.GetLengths()[2];
+    auto scratch     = [&](std::size_t offset, std::size_t bytes) {
+        return handle.CreateSubBuffer(workSpace, offset, bytes);
+    };
+
+    // Sequences go through packed copies unless the padded layout already starts with the
+    // packed one, states only when the samples need reordering
+    const auto rnn_ws = scratch(layout.rnn, layout.x - layout.rnn);
+    const auto x_ws   = scratch(layout.x, layout.y - layout.x);
+    const auto y_ws   = scratch(layout.y, layout.hx - layout.y);
+    std::unique_ptr<PackingRows> sequence_rows;
+    std::unique_ptr<PackingRows> state_rows;
+    if(!packing.IsPacked())
+    {
+        sequence_rows = make_unique<PackingRows>(handle, packing.sequence_runs);
+        sequence_rows->Copy(handle, type, true, in_h, 1, 0, x, x_ws.get());
+    }
+    if(!packing.IsSorted())
+        state_rows = make_unique<PackingRows>(handle, packing.state_runs);
+    ConstData_t packed_x = packing.IsPacked() ? x : x_ws.get();
+    Data_t packed_y      = packing.IsPacked() ? y : y_ws.get();
+
+    std::vector<shared<Data_t>> state_ws;
+    auto pack_state = [&](ConstData_t state, std::size_t offset) -> ConstData_t {
+        if(state == nullptr || packing.IsSorted())
+            return state;
+        state_ws.push_back(scratch(offset, layout.hy - layout.hx));
+        state_rows->Copy(handle, type, true, hy_h, hy_d, batch, state, state_ws.back().get());
+        return state_ws.back().get();
+    };
+    auto packed_state = [&](Data_t state, std::size_t offset) -> Data_t {
+        if(state == nullptr || packing.IsSorted())
+            return state;
+        state_ws.push_back(scratch(offset, layout.hy - layout.hx));
+        return state_ws.back().get();
+    };
+    ConstData_t packed_hx = pack_state(hx, layout.hx);
+    ConstData_t packed_cx = pack_state(cx, layout.cx);
+    Data_t packed_hy      = packed_state(hy, layout.hy);
+    Data_t packed_cy      = packed_state(cy, layout.cy);
+
+    RNNForwardInference(handle,
+                        packing.SeqLen(),
+                        x_steps.View(),
+                        packed_x,
+                        hxDesc,
+                        packed_hx,
+                        cxDesc,
+                        packed_cx,
+                        wDesc,
+                        w,
+                        y_steps.View(),
+                        packed_y,
+                        hyDesc,
+                        packed_hy,
+                        cyDesc,
+                        packed_cy,
+                        rnn_ws.get(),
+                        layout.x - layout.rnn);
+
+    // Zero the padding of y, then scatter the packed rows
+    const std::size_t rows    = packing.IsPacked() ? packing.PackedRows() : 0;
+    const std::size_t padding = seqLen * batch - rows;
+    if(padding > 0)
+    {
+        const TensorDescriptor padding_desc(type, {padding, out_h});
+        const float zero = 0;
+        SetTensor(handle, padding_desc, y, &zero, rows * out_h);
+    }
+    if(!packing.IsPacked())
+        sequence_rows->Copy(handle, type, false, out_h, 1, 0, packed_y, y);
+    if(hy != packed_hy)
+        state_rows->Copy(handle, type, false, hy_h, hy_d, batch, packed_hy, hy);
+    if(cy != packed_cy)
+        state_rows->Copy(handle, type, false, hy_h, hy_d, batch, packed_cy, cy);
+}
+
 std::ostream& operator<<(std::ostream& stream, const RNNDescriptor& r)
 {
     stream << r.hsize << ", ";
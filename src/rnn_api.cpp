@@ -336,6 +336,62 @@ extern "C" miopenStatus_t miopenSetRNNLayerBias(miopenHandle_t handle,
     });
 }
 
+extern "C" miopenStatus_t miopenSetRNNWeightLayout(miopenRNNDescriptor_t rnnDesc,
+                                                   miopenRNNWeightLayout_t layout)
+{
+    MIOPEN_LOG_FUNCTION(rnnDesc, layout);
+    return miopen::try_([&] {
+        if(layout != miopenRNNWeightsCanonical && layout != miopenRNNWeightsPacked)
+        {
+            MIOPEN_THROW(miopenStatusBadParm, "Unknown RNN weight layout");
+        }
+        miopen::deref(rnnDesc).weightLayout = layout;
+    });
+}
+
+extern "C" miopenStatus_t miopenGetRNNWeightLayout(miopenRNNDescriptor_t rnnDesc,
+                                                   miopenRNNWeightLayout_t* layout)
+{
+    MIOPEN_LOG_FUNCTION(rnnDesc, layout);
+    return miopen::try_([&] { miopen::deref(layout) = miopen::deref(rnnDesc).weightLayout; });
+}
+
+extern "C" miopenStatus_t miopenRNNPackWeights(miopenHandle_t handle,
+                                               miopenRNNDescriptor_t rnnDesc,
+                                               miopenTensorDescriptor_t xDesc,
+                                               miopenTensorDescriptor_t wDesc,
+                                               const void* w,
+                                               void* packedW)
+{
+    MIOPEN_LOG_FUNCTION(rnnDesc, xDesc, wDesc, w, packedW);
+    return miopen::try_([&] {
+        miopen::deref(rnnDesc).PackWeights(miopen::deref(handle),
+                                           miopen::deref(xDesc),
+                                           miopen::deref(wDesc),
+                                           DataCast(w),
+                                           DataCast(packedW),
+                                           true);
+    });
+}
+
+extern "C" miopenStatus_t miopenRNNUnpackWeights(miopenHandle_t handle,
+                                                 miopenRNNDescriptor_t rnnDesc,
+                                                 miopenTensorDescriptor_t xDesc,
+                                                 miopenTensorDescriptor_t wDesc,
+                                                 const void* packedW,
+                                                 void* w)
+{
+    MIOPEN_LOG_FUNCTION(rnnDesc, xDesc, wDesc, packedW, w);
+    return miopen::try_([&] {
+        miopen::deref(rnnDesc).PackWeights(miopen::deref(handle),
+                                           miopen::deref(xDesc),
+                                           miopen::deref(wDesc),
+                                           DataCast(packedW),
+                                           DataCast(w),
+                                           false);
+    });
+}
+
 extern "C" miopenStatus_t miopenRNNForwardTraining(miopenHandle_t handle,
                                                    const miopenRNNDescriptor_t rnnDesc,
                                                    const int sequenceLen,
@@ -609,3 +665,101 @@ extern "C" miopenStatus_t miopenRNNForwardInference(miopenHandle_t handle,
                                                    workSpaceNumBytes);
     });
 }
+
+// Lengths of the sequences of an unsorted batch, one per sample of the first time step
+static std::vector<int> UnsortedLengths(const int sequenceLen,
+                                        const miopenTensorDescriptor_t* xDesc,
+                                        const int* seqLengths)
+{
+    if(sequenceLen <= 0)
+        MIOPEN_THROW(miopenStatusBadParm, "The sequence length must be positive");
+    if(xDesc == nullptr || seqLengths == nullptr)
+        MIOPEN_THROW(miopenStatusBadParm, "xDesc and seqLengths must not be null");
+    return {seqLengths, seqLengths + miopen::deref(xDesc[0]).GetLengths()[0]};
+}
+
+extern "C" miopenStatus_t miopenGetRNNUnsortedWorkspaceSize(miopenHandle_t handle,
+                                                            const miopenRNNDescriptor_t rnnDesc,
+                                                            const int sequenceLen,
+                                                            const miopenTensorDescriptor_t* xDesc,
+                                                            const int* seqLengths,
+                                                            size_t* numBytes)
+{
+    MIOPEN_LOG_FUNCTION(rnnDesc, sequenceLen, xDesc, seqLengths, numBytes);
+    return miopen::try_([&] {
+        const auto lengths = UnsortedLengths(sequenceLen, xDesc, seqLengths);
+        miopen::c_array_view<const miopenTensorDescriptor_t> xDescArray{xDesc, size_t(sequenceLen)};
+        miopen::deref(numBytes) = miopen::deref(rnnDesc).GetUnsortedWorkspaceSize(
+            miopen::deref(handle), sequenceLen, xDescArray, lengths);
+    });
+}
+
+extern "C" miopenStatus_t
+miopenRNNForwardInferenceUnsorted(miopenHandle_t handle,
+                                  miopenRNNDescriptor_t rnnDesc,
+                                  const int sequenceLen,
+                                  const miopenTensorDescriptor_t* xDesc,
+                                  const int* seqLengths,
+                                  const void* x,
+                                  const miopenTensorDescriptor_t hxDesc,
+                                  const void* hx,
+                                  const miopenTensorDescriptor_t cxDesc,
+                                  const void* cx,
+                                  const miopenTensorDescriptor_t wDesc,
+                                  const void* w,
+                                  const miopenTensorDescriptor_t* yDesc,
+                                  void* y,
+                                  const miopenTensorDescriptor_t hyDesc,
+                                  void* hy,
+                                  const miopenTensorDescriptor_t cyDesc,
+                                  void* cy,
+                                  void* workSpace,
+                                  size_t workSpaceNumBytes)
+{
+
+    MIOPEN_LOG_FUNCTION(rnnDesc,
+                        sequenceLen,
+                        xDesc,
+                        seqLengths,
+                        x,
+                        hxDesc,
+                        hx,
+                        cxDesc,
+                        cx,
+                        wDesc,
+                        w,
+                        yDesc,
+                        y,
+                        hyDesc,
+                        hy,
+                        cyDesc,
+                        cy,
+                        workSpace,
+                        workSpaceNumBytes);
+    return miopen::try_([&] {
+        const auto lengths = UnsortedLengths(sequenceLen, xDesc, seqLengths);
+        if(yDesc == nullptr)
+            MIOPEN_THROW(miopenStatusBadParm, "yDesc must not be null");
+        miopen::c_array_view<const miopenTensorDescriptor_t> xDescArray{xDesc, size_t(sequenceLen)};
+        miopen::c_array_view<const miopenTensorDescriptor_t> yDescArray{yDesc, size_t(sequenceLen)};
+        miopen::deref(rnnDesc).RNNForwardInferenceUnsorted(miopen::deref(handle),
+                                                           sequenceLen,
+                                                           xDescArray,
+                                                           lengths,
+                                                           DataCast(x),
+                                                           miopen::deref(hxDesc),
+                                                           DataCast(hx),
+                                                           miopen::deref(cxDesc),
+                                                           DataCast(cx),
+                                                           miopen::deref(wDesc),
+                                                           DataCast(w),
+                                                           yDescArray,
+                                                           DataCast(y),
+                                                           miopen::deref(hyDesc),
+                                                           DataCast(hy),
+                                                           miopen::deref(cyDesc),
+                                                           DataCast(cy),
+                                                           DataCast(workSpace),
+                                                           workSpaceNumBytes);
+    });
+}
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn_packing.hpp>
+#include <miopen/errors.hpp>
+
+#include <numeric>
+
+namespace miopen {
+
+namespace {
+
+// Appends a row mapping, extending the last run when both sides continue it
+void AddRow(std::vector<RNNSequencePacking::Run>& runs, std::size_t packed, std::size_t padded)
+{
+    if(!runs.empty())
+    {
+        auto& last = runs.back();
+        if(last.packed + last.rows == packed && last.padded + last.rows == padded)
+        {
+            last.rows++;
+            return;
+        }
+    }
+    runs.push_back({packed, padded, 1});
+}
+
+} // namespace
+
+RNNSequencePacking::RNNSequencePacking(std::vector<int> sequence_lengths)
+    : lengths(std::move(sequence_lengths))
+{
+    if(lengths.empty())
+        MIOPEN_THROW(miopenStatusBadParm, "The batch of sequences is empty");
+    if(std::any_of(lengths.begin(), lengths.end(), [](int n) { return n < 1; }))
+        MIOPEN_THROW(miopenStatusBadParm, "Sequence lengths must be positive");
+
+    // Stable, so equal lengths keep the caller's order and sorted batches map to themselves
+    order.resize(lengths.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+        order.begin(), order.end(), [&](int a, int b) { return lengths[a] > lengths[b]; });
+
+    batches.resize(lengths[order.front()]);
+    for(std::size_t t = 0; t < batches.size(); t++)
+        batches[t] = std::count_if(
+            lengths.begin(), lengths.end(), [&](int n) { return n > static_cast<int>(t); });
+
+    const std::size_t batch = lengths.size();
+    std::size_t row         = 0;
+    for(std::size_t t = 0; t < batches.size(); t++)
+        for(int slot = 0; slot < batches[t]; slot++)
+            AddRow(sequence_runs, row++, t * batch + order[slot]);
+
+    for(std::size_t slot = 0; slot < batch; slot++)
+        AddRow(state_runs, slot, order[slot]);
+}
+
+std::size_t RNNSequencePacking::PackedRows() const
+{
+    return std::accumulate(batches.begin(), batches.end(), std::size_t{0});
+}
+
+std::vector<int> RNNSequencePacking::PaddedRows(const std::vector<Run>& runs)
+{
+    std::vector<int> rows;
+    for(const auto& r : runs)
+    {
+        rows.resize(std::max(rows.size(), r.packed + r.rows));
+        std::iota(rows.begin() + r.packed, rows.begin() + r.packed + r.rows, int(r.padded));
+    }
+    return rows;
+}
+
+} // namespace miopen
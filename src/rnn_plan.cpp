@@ -0,0 +1,3689 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn_plan.hpp>
+#include <miopen/errors.hpp>
+#include <miopen/logger.hpp>
+#include <miopen/rnn_offsets.hpp>
+#include <miopen/rnn_schedule.hpp>
+#include <miopen/rnn_weights.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace miopen {
+
+void RNNPlan::Buffers::Input(Buffer b, ConstData_t p) { inputs[b] = p; }
+
+void RNNPlan::Buffers::Output(Buffer b, Data_t p)
+{
+    inputs[b]  = p;
+    outputs[b] = p;
+}
+
+ConstData_t RNNPlan::Buffers::Read(Buffer b) const
+{
+    if(inputs[b] == nullptr)
+        MIOPEN_THROW(miopenStatusInternalError, "RNN plan reads an unbound buffer");
+    return inputs[b];
+}
+
+std::bitset<RNNPlan::buffer_count> RNNPlan::Buffers::Bound() const
+{
+    std::bitset<buffer_count> bound;
+    for(std::size_t b = 0; b < buffer_count; b++)
+        bound.set(b, inputs[b] != nullptr);
+    return bound;
+}
+
+Data_t RNNPlan::Buffers::Write(Buffer b) const
+{
+    if(outputs[b] == nullptr)
+        MIOPEN_THROW(miopenStatusInternalError, "RNN plan writes an unbound or read-only buffer");
+    return outputs[b];
+}
+
+void RNNPlan::Set(const TensorDescriptor& cDesc, Buffer c, float value)
+{
+    Op op{};
+    op.kind = set;
+    op.c    = {c, 0, cDesc};
+    op.beta = value;
+    ops.push_back(std::move(op));
+}
+
+void RNNPlan::Gemm(const GemmDescriptor& gemm_desc,
+                   Buffer a,
+                   std::size_t a_offset,
+                   Buffer b,
+                   std::size_t b_offset,
+                   Buffer c,
+                   std::size_t c_offset)
+{
+    Op op{};
+    op.kind      = gemm;
+    op.a         = {a, a_offset, {}};
+    op.b         = {b, b_offset, {}};
+    op.c         = {c, c_offset, {}};
+    op.gemm_desc = gemm_desc;
+    ops.push_back(std::move(op));
+}
+
+void RNNPlan::Tensor(miopenTensorOp_t tensor_op,
+                     float alpha0,
+                     const TensorDescriptor& aDesc,
+                     Buffer a,
+                     float alpha1,
+                     const TensorDescriptor& bDesc,
+                     Buffer b,
+                     float beta,
+                     const TensorDescriptor& cDesc,
+                     Buffer c,
+                     std::size_t a_offset,
+                     std::size_t b_offset,
+                     std::size_t c_offset)
+{
+    Op op{};
+    op.kind      = RNNPlan::tensor_op;
+    op.a         = {a, a_offset, aDesc};
+    op.b         = {b, b_offset, bDesc};
+    op.c         = {c, c_offset, cDesc};
+    op.tensor_op = tensor_op;
+    op.alpha0    = alpha0;
+    op.alpha1    = alpha1;
+    op.beta      = beta;
+    ops.push_back(std::move(op));
+}
+
+void RNNPlan::Copy(const TensorDescriptor& aDesc,
+                   Buffer a,
+                   const TensorDescriptor& cDesc,
+                   Buffer c,
+                   std::size_t a_offset,
+                   std::size_t c_offset)
+{
+    Op op{};
+    op.kind = copy;
+    op.a    = {a, a_offset, aDesc};
+    op.c    = {c, c_offset, cDesc};
+    ops.push_back(std::move(op));
+}
+
+void RNNPlan::ActivationForward(const ActivationDescriptor& activ_desc,
+                                float alpha,
+                                const TensorDescriptor& aDesc,
+                                Buffer a,
+                                float beta,
+                                const TensorDescriptor& cDesc,
+                                Buffer c,
+                                std::size_t a_offset,
+                                std::size_t c_offset)
+{
+    Op op{};
+    op.kind       = activation_forward;
+    op.a          = {a, a_offset, aDesc};
+    op.c          = {c, c_offset, cDesc};
+    op.activ_desc = activ_desc;
+    op.alpha0     = alpha;
+    op.beta       = beta;
+    ops.push_back(std::move(op));
+}
+
+void RNNPlan::ActivationBackward(const ActivationDescriptor& activ_desc,
+                                 float alpha,
+                                 const TensorDescriptor& aDesc,
+                                 Buffer a,
+                                 const TensorDescriptor& bDesc,
+                                 Buffer b,
+                                 const TensorDescriptor& cDesc,
+                                 Buffer c,
+                                 float beta,
+                                 const TensorDescriptor& dDesc,
+                                 Buffer d,
+                                 std::size_t a_offset,
+                                 std::size_t b_offset,
+                                 std::size_t c_offset,
+                                 std::size_t d_offset)
+{
+    Op op{};
+    op.kind       = activation_backward;
+    op.a          = {a, a_offset, aDesc};
+    op.b          = {b, b_offset, bDesc};
+    op.c          = {c, c_offset, cDesc};
+    op.d          = {d, d_offset, dDesc};
+    op.activ_desc = activ_desc;
+    op.alpha0     = alpha;
+    op.beta       = beta;
+    ops.push_back(std::move(op));
+}
+
+namespace {
+
+// Emits the operations of one pass into the plan. The members carry the names and types the
+// RNN calls used for their sizes and strides before the operations were planned.
+struct RNNPlanBuilder : RNNPlan
+{
+    explicit RNNPlanBuilder(const RNNPlanShape& shape_);
+
+    void EmitForwardInference();
+    void EmitForwardTraining();
+    void EmitBackwardData();
+    void EmitBackwardWeights();
+
+    const RNNPlanShape& shape;
+    miopenRNNMode_t rnnMode;
+    miopenRNNInputMode_t inputMode;
+    miopenRNNDirectionMode_t dirMode;
+    miopenRNNBiasMode_t biasMode;
+    std::size_t nLayers;
+    std::size_t nHiddenTensorsPerLayer;
+    std::size_t workspaceScale;
+
+    int seqLen;
+    std::vector<int> in_n;
+    int in_h;
+    int hy_d;
+    int hy_n;
+    int hy_h;
+    int out_h;
+    int batch_n;
+    int bi;
+    int in_stride;
+    int hy_stride;
+    int out_stride;
+    int wei_stride;
+    int uni_stride;
+    int bi_stride;
+};
+
+RNNPlanBuilder::RNNPlanBuilder(const RNNPlanShape& shape_)
+    : shape(shape_),
+      rnnMode(shape_.rnn_mode),
+      inputMode(shape_.input_mode),
+      dirMode(shape_.dir_mode),
+      biasMode(shape_.bias_mode),
+      nLayers(shape_.n_layers),
+      nHiddenTensorsPerLayer(shape_.hidden_tensors),
+      workspaceScale(shape_.workspace_scale),
+      seqLen(shape_.SeqLen()),
+      in_n(shape_.batches),
+      in_h(shape_.in_h),
+      hy_d(shape_.hy_d),
+      hy_n(shape_.hy_n),
+      hy_h(shape_.hy_h),
+      out_h(shape_.out_h)
+{
+    batch_n    = std::accumulate(in_n.begin(), in_n.end(), 0);
+    bi         = dirMode != 0u ? 2 : 1;
+    in_stride  = in_h;
+    hy_stride  = hy_h * bi * workspaceScale;
+    out_stride = out_h;
+    wei_stride = hy_h * bi * nHiddenTensorsPerLayer;
+    uni_stride = hy_h;
+    bi_stride  = hy_h * bi;
+
+    if(inputMode == miopenRNNskip)
+    {
+        in_h = 0;
+    }
+}
+
+void RNNPlanBuilder::EmitForwardInference()
+{
+    const RNNOffsets rnn_offsets(in_h, hy_h, bi, nLayers, batch_n, hy_n, hy_stride, wei_stride);
+    size_t offset;
+    float alpha0, alpha1, beta_t;
+    float alpha = 1, beta = 0;
+
+    std::vector<std::size_t> sp_size(3, 1), sp_stride(3, 1), w_size(3, 1), w_stride(3, 1),
+        x_size(3, 1), x_stride(3, 1), y_size(3, 1), y_stride(3, 1), hx_size(3, 1), hx_stride(3, 1);
+    miopen::TensorDescriptor sp_desc, w_desc, x_desc, y_desc, hx_desc;
+
+    sp_size[2]   = shape.workspace_elements;
+    sp_stride[0] = sp_size[2];
+    sp_stride[1] = sp_size[2];
+    sp_desc      = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+    Set(sp_desc, workSpace, beta);
+    sp_stride[0] = batch_n * hy_stride;
+    sp_stride[1] = hy_stride;
+    sp_size[2]   = 1;
+    w_stride[0]  = wei_stride;
+    w_stride[1]  = wei_stride;
+    x_stride[0]  = batch_n * in_stride;
+    x_stride[1]  = in_stride;
+    y_stride[0]  = batch_n * out_stride;
+    y_stride[1]  = out_stride;
+    if(shape.Given(hy) || (rnnMode == miopenLSTM && shape.Given(cy)))
+    {
+        hx_size[2]   = hy_d * hy_n * hy_h;
+        hx_stride[0] = hx_size[2];
+        hx_stride[1] = hx_size[2];
+        hx_desc      = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+        if(shape.Given(hy))
+        {
+            Set(hx_desc, hy, beta);
+        }
+        if(rnnMode == miopenLSTM && shape.Given(cy))
+        {
+            Set(hx_desc, cy, beta);
+        }
+    }
+    hx_stride[0] = in_n.at(0) * uni_stride;
+    hx_stride[1] = uni_stride;
+
+    size_t wei_shift, prelayer_shift;
+    int wei_len    = 0;
+    size_t hid_off = 0;
+
+    switch(rnnMode)
+    {
+    case miopenRNNRELU:
+    case miopenRNNTANH:
+        wei_len = hy_h;
+        hid_off = 0;
+        break;
+    case miopenLSTM:
+        wei_len = hy_h * 4;
+        hid_off = bi * hy_h * 5;
+        break;
+    case miopenGRU:
+        wei_len = hy_h * 3;
+        hid_off = bi * hy_h * 3;
+        break;
+    }
+
+    ActivationDescriptor tanhDesc, sigDesc, activDesc;
+    sigDesc  = {miopenActivationLOGISTIC, 1, 0, 1};
+    tanhDesc = {miopenActivationTANH, 1, 1, 1};
+    if(rnnMode == miopenRNNRELU)
+    {
+        activDesc = {miopenActivationRELU, 1, 0, 1};
+    }
+    else if(rnnMode == miopenRNNTANH)
+    {
+        activDesc = {miopenActivationTANH, 1, 1, 1};
+    }
+
+    for(int li = 0; li < nLayers; li++)
+    {
+        size_t hid_shift           = rnn_offsets.Hidden(li);
+        size_t hx_shift            = rnn_offsets.HiddenState(li);
+        size_t wei_shift_bias_temp = rnn_offsets.Bias(li);
+
+        // from input
+        if(li == 0)
+        {
+            if(inputMode == miopenRNNskip)
+            {
+                x_size[1]  = batch_n;
+                x_size[2]  = hy_h;
+                sp_size[1] = batch_n;
+                sp_size[2] = hy_h;
+                x_desc     = miopen::TensorDescriptor(miopenFloat, x_size, x_stride);
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                for(int gi = 0; gi < nHiddenTensorsPerLayer * bi; gi++)
+                {
+                    Copy(x_desc, x, sp_desc, workSpace, 0, gi * hy_h);
+                }
+            }
+            else
+            {
+                miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                  false,
+                                                                  true,
+                                                                  batch_n,
+                                                                  wei_len * bi,
+                                                                  in_h,
+                                                                  in_stride,
+                                                                  in_stride,
+                                                                  hy_stride,
+                                                                  1, // batch count
+                                                                  0, // Stride A
+                                                                  0, // Stride B
+                                                                  0, // Stride C
+                                                                  1, // alpha
+                                                                  1, // beta
+                                                                  shape.data_type};
+
+                Gemm(gemm_desc, x, 0, w, 0, workSpace, hid_shift);
+            }
+        }
+        else
+        {
+            wei_shift      = rnn_offsets.InputWeights(li);
+            prelayer_shift = rnn_offsets.Hidden(li - 1) + hid_off;
+
+            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                              false,
+                                                              true,
+                                                              batch_n,
+                                                              wei_len * bi,
+                                                              hy_h * bi,
+                                                              hy_stride,
+                                                              bi_stride,
+                                                              hy_stride,
+                                                              1, // batch count
+                                                              0, // Stride A
+                                                              0, // Stride B
+                                                              0, // Stride C
+                                                              1, // alpha
+                                                              1, // beta
+                                                              shape.data_type};
+            Gemm(gemm_desc, workSpace, prelayer_shift, w, wei_shift, workSpace, hid_shift);
+        }
+
+        if(biasMode != 0u)
+        {
+            alpha0 = 1;
+            alpha1 = 1;
+            beta_t = 0;
+
+            w_size[1]  = 1;
+            w_size[2]  = wei_stride;
+            sp_size[1] = batch_n;
+            sp_size[2] = wei_stride;
+            w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            Tensor(miopenTensorOpAdd,
+                   alpha0,
+                   sp_desc,
+                   workSpace,
+                   alpha1,
+                   w_desc,
+                   w,
+                   beta_t,
+                   sp_desc,
+                   workSpace,
+                   hid_shift,
+                   wei_shift_bias_temp,
+                   hid_shift);
+        }
+
+        if(rnnMode == miopenGRU)
+        {
+            sp_size[1] = batch_n;
+            sp_size[2] = hy_h;
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            alpha0 = 0;
+            alpha1 = 0;
+            beta_t = 0;
+            for(int bs = 0; bs < bi; bs++)
+            {
+                Copy(sp_desc,
+                     workSpace,
+                     sp_desc,
+                     workSpace,
+                     hid_shift + bs * wei_len + 2 * hy_h,
+                     hid_shift + hid_off + bs * hy_h);
+
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       workSpace,
+                       alpha1,
+                       sp_desc,
+                       workSpace,
+                       beta_t,
+                       sp_desc,
+                       workSpace,
+                       hid_shift + bs * wei_len + 2 * hy_h,
+                       hid_shift + bs * wei_len + 2 * hy_h,
+                       hid_shift + bs * wei_len + 2 * hy_h);
+            }
+        }
+
+        if(biasMode != 0u)
+        {
+            wei_shift_bias_temp += wei_stride;
+
+            alpha0 = 1;
+            alpha1 = 1;
+            beta_t = 0;
+
+            if(shape.Given(hx))
+            {
+                sp_size[1] = batch_n;
+                sp_size[2] = wei_stride;
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       workSpace,
+                       alpha1,
+                       w_desc,
+                       w,
+                       beta_t,
+                       sp_desc,
+                       workSpace,
+                       hid_shift,
+                       wei_shift_bias_temp,
+                       hid_shift);
+            }
+            else
+            {
+                sp_size[1] = batch_n - in_n.at(0);
+                sp_size[2] = wei_len;
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+                w_size[1]  = 1;
+                w_size[2]  = wei_len;
+                w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       workSpace,
+                       alpha1,
+                       w_desc,
+                       w,
+                       beta_t,
+                       sp_desc,
+                       workSpace,
+                       rnn_offsets.Hidden(li, in_n.at(0)),
+                       wei_shift_bias_temp,
+                       rnn_offsets.Hidden(li, in_n.at(0)));
+
+                if(dirMode != 0u)
+                {
+                    if(in_n.at(0) == in_n.at(seqLen - 1))
+                    {
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               w_desc,
+                               w,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               hid_shift + wei_len,
+                               wei_shift_bias_temp + wei_len,
+                               hid_shift + wei_len);
+                    }
+                    else
+                    {
+                        int cur_batch = 0;
+                        for(int ti = 0; ti < seqLen; ti++)
+                        {
+                            if(ti != (seqLen - 1))
+                            {
+                                offset = rnn_offsets.Hidden(li, cur_batch);
+
+                                sp_size[1] = in_n.at(ti + 1);
+                                sp_size[2] = wei_len;
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpAdd,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       w_desc,
+                                       w,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + wei_len,
+                                       wei_shift_bias_temp + wei_len,
+                                       offset + wei_len);
+                            }
+                            cur_batch += in_n.at(ti);
+                        }
+                    }
+                }
+            }
+        }
+
+        // from hidden state
+        int bacc   = 0;
+        int baccbi = batch_n;
+        for(int ti = 0; ti < seqLen; ti++)
+        {
+            baccbi -= in_n.at(seqLen - 1 - ti);
+            wei_shift            = rnn_offsets.HiddenWeights(li);
+            size_t pretime_shift = 0;
+            int use_time         = 0;
+
+            for(int ri = 0; ri < bi; ri++)
+            {
+                int cur_time  = ri == 0 ? ti : seqLen - 1 - ti;
+                int cur_batch = ri == 0 ? bacc : baccbi;
+                offset        = rnn_offsets.Hidden(li, cur_batch);
+                if(ti > 0)
+                {
+                    pretime_shift = ri == 0
+                                        ? rnn_offsets.Hidden(li, bacc - in_n.at(ti - 1))
+                                        : rnn_offsets.Hidden(li, baccbi + in_n.at(seqLen - 1 - ti));
+                    use_time = ri == 0 ? ti : seqLen - ti;
+                }
+
+                if(in_n.at(cur_time) > 0)
+                {
+                    if(ti == 0)
+                    {
+                        if(shape.Given(hx))
+                        {
+                            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                              false,
+                                                                              true,
+                                                                              in_n.at(cur_time),
+                                                                              wei_len,
+                                                                              hy_h,
+                                                                              uni_stride,
+                                                                              uni_stride,
+                                                                              hy_stride,
+                                                                              1, // batch count
+                                                                              0, // Stride A
+                                                                              0, // Stride B
+                                                                              0, // Stride C
+                                                                              1, // alpha
+                                                                              1, // beta
+                                                                              shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 hx,
+                                 hx_shift + ri * hy_n * hy_h,
+                                 w,
+                                 wei_shift + ri * wei_len * uni_stride,
+                                 workSpace,
+                                 offset + ri * wei_len);
+                        }
+                    }
+                    else
+                    {
+                        if(ri == 1 && shape.Given(hx) && in_n.at(cur_time) > in_n.at(use_time))
+                        {
+                            miopen::GemmDescriptor gemm_desc =
+                                GemmDescriptor{false,
+                                               false,
+                                               true,
+                                               (in_n.at(cur_time) - in_n.at(use_time)),
+                                               wei_len,
+                                               hy_h,
+                                               uni_stride,
+                                               uni_stride,
+                                               hy_stride,
+                                               1, // batch count
+                                               0, // Stride A
+                                               0, // Stride B
+                                               0, // Stride C
+                                               1, // alpha
+                                               1, // beta
+                                               shape.data_type};
+                            Gemm(gemm_desc,
+                                 hx,
+                                 hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                 w,
+                                 wei_shift + ri * wei_len * uni_stride,
+                                 workSpace,
+                                 offset + ri * wei_len + in_n.at(use_time) * hy_stride);
+                        }
+
+                        if(in_n.at(use_time) > 0)
+                        {
+                            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                              false,
+                                                                              true,
+                                                                              in_n.at(use_time),
+                                                                              wei_len,
+                                                                              hy_h,
+                                                                              hy_stride,
+                                                                              uni_stride,
+                                                                              hy_stride,
+                                                                              1, // batch count
+                                                                              0, // Stride A
+                                                                              0, // Stride B
+                                                                              0, // Stride C
+                                                                              1, // alpha
+                                                                              1, // beta
+                                                                              shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 workSpace,
+                                 pretime_shift + hid_off + ri * hy_h,
+                                 w,
+                                 wei_shift + ri * wei_len * uni_stride,
+                                 workSpace,
+                                 offset + ri * wei_len);
+                        }
+                    }
+
+                    // update hidden status
+                    sp_size[1] = in_n.at(cur_time);
+                    if(rnnMode == miopenRNNRELU || rnnMode == miopenRNNTANH)
+                    {
+                        sp_size[2] = hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(activDesc,
+                                          alpha,
+                                          sp_desc,
+                                          workSpace,
+                                          beta,
+                                          sp_desc,
+                                          workSpace,
+                                          offset + ri * wei_len,
+                                          offset + ri * wei_len);
+                    }
+                    else if(rnnMode == miopenLSTM)
+                    {
+                        // active gate i, f, o
+                        sp_size[2] = hy_h * 3;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(sigDesc,
+                                          alpha,
+                                          sp_desc,
+                                          workSpace,
+                                          beta,
+                                          sp_desc,
+                                          workSpace,
+                                          offset + ri * wei_len,
+                                          offset + ri * wei_len);
+
+                        // active gate c
+                        sp_size[2] = hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(tanhDesc,
+                                          alpha,
+                                          sp_desc,
+                                          workSpace,
+                                          beta,
+                                          sp_desc,
+                                          workSpace,
+                                          offset + 3 * hy_h + ri * wei_len,
+                                          offset + 3 * hy_h + ri * wei_len);
+
+                        // update cell state
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 1;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + ri * wei_len,
+                               offset + 3 * hy_h + ri * wei_len,
+                               offset + bi * wei_len + ri * hy_h);
+
+                        if(ti == 0)
+                        {
+                            if(shape.Given(cx))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       cx,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + hy_h + ri * wei_len,
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + bi * wei_len + ri * hy_h);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(cx) && in_n.at(cur_time) > in_n.at(use_time))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       cx,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + hy_h + ri * wei_len + in_n.at(use_time) * hy_stride,
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                       offset + bi * wei_len + ri * hy_h +
+                                           in_n.at(use_time) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            if(in_n.at(use_time) > 0)
+                            {
+                                if(in_n.at(use_time) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(use_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + hy_h + ri * wei_len,
+                                       pretime_shift + bi * wei_len + ri * hy_h,
+                                       offset + bi * wei_len + ri * hy_h);
+
+                                if(in_n.at(use_time) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(cur_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+                            }
+                        }
+
+                        // active cell state
+                        ActivationForward(tanhDesc,
+                                          alpha,
+                                          sp_desc,
+                                          workSpace,
+                                          beta,
+                                          sp_desc,
+                                          workSpace,
+                                          offset + bi * wei_len + ri * hy_h,
+                                          offset + hid_off + ri * hy_h);
+
+                        // update hidden state
+                        beta_t = 0;
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + hid_off + ri * hy_h,
+                               offset + hid_off + ri * hy_h);
+                    }
+                    else if(rnnMode == miopenGRU)
+                    {
+                        // active z, r gate
+                        sp_size[2] = 2 * hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(sigDesc,
+                                          alpha,
+                                          sp_desc,
+                                          workSpace,
+                                          beta,
+                                          sp_desc,
+                                          workSpace,
+                                          offset + ri * wei_len,
+                                          offset + ri * wei_len);
+
+                        // calculate c gate
+                        sp_size[2] = hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + hy_h + ri * wei_len,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + hid_off + ri * hy_h,
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        // active c gate
+                        ActivationForward(tanhDesc,
+                                          alpha,
+                                          sp_desc,
+                                          workSpace,
+                                          beta,
+                                          sp_desc,
+                                          workSpace,
+                                          offset + 2 * hy_h + ri * wei_len,
+                                          offset + 2 * hy_h + ri * wei_len);
+
+                        // calculate hidden state
+                        alpha0 = -1;
+                        alpha1 = 1;
+                        beta_t = 0;
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + ri * wei_len,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + hid_off + ri * hy_h);
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + hid_off + ri * hy_h,
+                               offset + hid_off + ri * hy_h);
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 1;
+                        if(ti == 0)
+                        {
+                            if(shape.Given(hx))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       hx,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + ri * wei_len,
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + hid_off + ri * hy_h);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(hx) && in_n.at(cur_time) > in_n.at(use_time))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       hx,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + ri * wei_len + in_n.at(use_time) * hy_stride,
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                       offset + hid_off + ri * hy_h +
+                                           in_n.at(use_time) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            if(in_n.at(use_time) > 0)
+                            {
+                                if(in_n.at(use_time) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(use_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + ri * wei_len,
+                                       pretime_shift + hid_off + ri * hy_h,
+                                       offset + hid_off + ri * hy_h);
+                            }
+                        }
+                    }
+                }
+            }
+
+            bacc += in_n.at(ti);
+        }
+
+        // update hy, cy
+        if(shape.Given(hy) || (rnnMode == miopenLSTM && shape.Given(cy)))
+        {
+            hx_size[2] = hy_h;
+            sp_size[2] = hy_h;
+
+            bacc   = batch_n;
+            baccbi = 0;
+            for(int ti = seqLen - 1; ti >= 0; ti--)
+            {
+                bacc -= in_n.at(ti);
+                for(int ri = 0; ri < bi; ri++)
+                {
+                    int cur_time  = ri == 0 ? ti : seqLen - 1 - ti;
+                    int cur_batch = ri == 0 ? bacc : baccbi;
+                    int use_batch = 0;
+
+                    if(ti < seqLen - 1)
+                    {
+                        int use_time = ri == 0 ? ti + 1 : seqLen - 2 - ti;
+                        use_batch    = in_n.at(use_time);
+                    }
+
+                    if(in_n.at(cur_time) > use_batch)
+                    {
+                        offset = rnn_offsets.Hidden(li, cur_batch);
+
+                        sp_size[1] = in_n.at(cur_time) - use_batch;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        hx_size[1] = sp_size[1];
+                        hx_desc    = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+
+                        if(shape.Given(hy))
+                        {
+                            Copy(sp_desc,
+                                 workSpace,
+                                 hx_desc,
+                                 hy,
+                                 offset + hid_off + ri * hy_h + use_batch * hy_stride,
+                                 hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                        }
+
+                        if(rnnMode == miopenLSTM && shape.Given(cy))
+                        {
+                            Copy(sp_desc,
+                                 workSpace,
+                                 hx_desc,
+                                 cy,
+                                 offset + bi * wei_len + ri * hy_h + use_batch * hy_stride,
+                                 hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                        }
+                    }
+                }
+                baccbi += in_n.at(seqLen - 1 - ti);
+            }
+        }
+    }
+
+    // output
+    prelayer_shift = rnn_offsets.Hidden(nLayers - 1) + hid_off;
+
+    sp_size[1] = batch_n;
+    sp_size[2] = hy_h * bi;
+    y_size[1]  = batch_n;
+    y_size[2]  = out_h;
+    y_desc     = miopen::TensorDescriptor(miopenFloat, y_size, y_stride);
+    sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+    Copy(sp_desc, workSpace, y_desc, y, prelayer_shift, 0);
+
+}
+
+void RNNPlanBuilder::EmitForwardTraining()
+{
+    const RNNOffsets rnn_offsets(in_h, hy_h, bi, nLayers, batch_n, hy_n, hy_stride, wei_stride);
+    size_t offset;
+    float alpha0, alpha1, beta_t;
+    float alpha = 1, beta = 0;
+
+    std::vector<std::size_t> sp_size(3, 1), sp_stride(3, 1), w_size(3, 1), w_stride(3, 1),
+        x_size(3, 1), x_stride(3, 1), y_size(3, 1), y_stride(3, 1), hx_size(3, 1), hx_stride(3, 1);
+    miopen::TensorDescriptor sp_desc, w_desc, x_desc, y_desc, hx_desc;
+
+    sp_size[2]   = shape.reserve_elements;
+    sp_stride[0] = sp_size[2];
+    sp_stride[1] = sp_size[2];
+    sp_desc      = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+    Set(sp_desc, reserveSpace, beta);
+    sp_stride[0] = batch_n * hy_stride;
+    sp_stride[1] = hy_stride;
+    sp_size[2]   = 1;
+    w_stride[0]  = wei_stride;
+    w_stride[1]  = wei_stride;
+    x_stride[0]  = batch_n * in_stride;
+    x_stride[1]  = in_stride;
+    y_stride[0]  = batch_n * out_stride;
+    y_stride[1]  = out_stride;
+    if(shape.Given(hy) || (rnnMode == miopenLSTM && shape.Given(cy)))
+    {
+        hx_size[2]   = hy_d * hy_n * hy_h;
+        hx_stride[0] = hx_size[2];
+        hx_stride[1] = hx_size[2];
+        hx_desc      = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+        if(shape.Given(hy))
+        {
+            Set(hx_desc, hy, beta);
+        }
+        if(rnnMode == miopenLSTM && shape.Given(cy))
+        {
+            Set(hx_desc, cy, beta);
+        }
+    }
+    hx_stride[0] = in_n.at(0) * uni_stride;
+    hx_stride[1] = uni_stride;
+
+    size_t wei_shift, prelayer_shift;
+    int wei_len    = 0;
+    size_t hid_off = 0;
+
+    switch(rnnMode)
+    {
+    case miopenRNNRELU:
+    case miopenRNNTANH:
+        wei_len = hy_h;
+        hid_off = rnn_offsets.Hidden(nLayers);
+        break;
+    case miopenLSTM:
+        wei_len = hy_h * 4;
+        hid_off = bi * hy_h * 5;
+        break;
+    case miopenGRU:
+        wei_len = hy_h * 3;
+        hid_off = bi * hy_h * 3;
+        break;
+    }
+
+    ActivationDescriptor tanhDesc, sigDesc, activDesc;
+    sigDesc  = {miopenActivationLOGISTIC, 1, 0, 1};
+    tanhDesc = {miopenActivationTANH, 1, 1, 1};
+    if(rnnMode == miopenRNNRELU)
+    {
+        activDesc = {miopenActivationRELU, 1, 0, 1};
+    }
+    else if(rnnMode == miopenRNNTANH)
+    {
+        activDesc = {miopenActivationTANH, 1, 1, 1};
+    }
+
+    for(int li = 0; li < nLayers; li++)
+    {
+        size_t hid_shift           = rnn_offsets.Hidden(li);
+        size_t hx_shift            = rnn_offsets.HiddenState(li);
+        size_t wei_shift_bias_temp = rnn_offsets.Bias(li);
+
+        // from input
+        if(li == 0)
+        {
+            if(inputMode == miopenRNNskip)
+            {
+                x_size[1]  = batch_n;
+                x_size[2]  = hy_h;
+                sp_size[1] = batch_n;
+                sp_size[2] = hy_h;
+                x_desc     = miopen::TensorDescriptor(miopenFloat, x_size, x_stride);
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                for(int gi = 0; gi < nHiddenTensorsPerLayer * bi; gi++)
+                {
+                    Copy(x_desc, x, sp_desc, reserveSpace, 0, gi * hy_h);
+                }
+            }
+            else
+            {
+                miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                  false,
+                                                                  true,
+                                                                  batch_n,
+                                                                  wei_len * bi,
+                                                                  in_h,
+                                                                  in_stride,
+                                                                  in_stride,
+                                                                  hy_stride,
+                                                                  1, // batch count
+                                                                  0, // Stride A
+                                                                  0, // Stride B
+                                                                  0, // Stride C
+                                                                  1, // alpha
+                                                                  1, // beta
+                                                                  shape.data_type};
+
+                Gemm(gemm_desc, x, 0, w, 0, reserveSpace, hid_shift);
+            }
+        }
+        else
+        {
+            wei_shift      = rnn_offsets.InputWeights(li);
+            prelayer_shift = rnn_offsets.Hidden(li - 1) + hid_off;
+
+            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                              false,
+                                                              true,
+                                                              batch_n,
+                                                              wei_len * bi,
+                                                              hy_h * bi,
+                                                              hy_stride,
+                                                              bi_stride,
+                                                              hy_stride,
+                                                              1, // batch count
+                                                              0, // Stride A
+                                                              0, // Stride B
+                                                              0, // Stride C
+                                                              1, // alpha
+                                                              1, // beta
+                                                              shape.data_type};
+
+            Gemm(gemm_desc, reserveSpace, prelayer_shift, w, wei_shift, reserveSpace, hid_shift);
+        }
+
+        if(biasMode != 0u)
+        {
+            alpha0 = 1;
+            alpha1 = 1;
+            beta_t = 0;
+
+            w_size[1]  = 1;
+            w_size[2]  = wei_stride;
+            sp_size[1] = batch_n;
+            sp_size[2] = wei_stride;
+            w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            Tensor(miopenTensorOpAdd,
+                   alpha0,
+                   sp_desc,
+                   reserveSpace,
+                   alpha1,
+                   w_desc,
+                   w,
+                   beta_t,
+                   sp_desc,
+                   reserveSpace,
+                   hid_shift,
+                   wei_shift_bias_temp,
+                   hid_shift);
+        }
+
+        if(rnnMode == miopenGRU)
+        {
+            sp_size[1] = batch_n;
+            sp_size[2] = hy_h;
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            alpha0 = 0;
+            alpha1 = 0;
+            beta_t = 0;
+            for(int bs = 0; bs < bi; bs++)
+            {
+                Copy(sp_desc,
+                     reserveSpace,
+                     sp_desc,
+                     reserveSpace,
+                     hid_shift + bs * wei_len + 2 * hy_h,
+                     hid_shift + hid_off + bs * hy_h);
+
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       reserveSpace,
+                       alpha1,
+                       sp_desc,
+                       reserveSpace,
+                       beta_t,
+                       sp_desc,
+                       reserveSpace,
+                       hid_shift + bs * wei_len + 2 * hy_h,
+                       hid_shift + bs * wei_len + 2 * hy_h,
+                       hid_shift + bs * wei_len + 2 * hy_h);
+            }
+        }
+
+        if(biasMode != 0u)
+        {
+            wei_shift_bias_temp += wei_stride;
+
+            alpha0 = 1;
+            alpha1 = 1;
+            beta_t = 0;
+
+            if(shape.Given(hx))
+            {
+                sp_size[1] = batch_n;
+                sp_size[2] = wei_stride;
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       reserveSpace,
+                       alpha1,
+                       w_desc,
+                       w,
+                       beta_t,
+                       sp_desc,
+                       reserveSpace,
+                       hid_shift,
+                       wei_shift_bias_temp,
+                       hid_shift);
+            }
+            else
+            {
+                sp_size[1] = batch_n - in_n.at(0);
+                sp_size[2] = wei_len;
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+                w_size[1]  = 1;
+                w_size[2]  = wei_len;
+                w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       reserveSpace,
+                       alpha1,
+                       w_desc,
+                       w,
+                       beta_t,
+                       sp_desc,
+                       reserveSpace,
+                       rnn_offsets.Hidden(li, in_n.at(0)),
+                       wei_shift_bias_temp,
+                       rnn_offsets.Hidden(li, in_n.at(0)));
+
+                if(dirMode != 0u)
+                {
+                    if(in_n.at(0) == in_n.at(seqLen - 1))
+                    {
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               w_desc,
+                               w,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               hid_shift + wei_len,
+                               wei_shift_bias_temp + wei_len,
+                               hid_shift + wei_len);
+                    }
+                    else
+                    {
+                        int cur_batch = 0;
+                        for(int ti = 0; ti < seqLen; ti++)
+                        {
+                            if(ti != (seqLen - 1))
+                            {
+                                offset = rnn_offsets.Hidden(li, cur_batch);
+
+                                sp_size[1] = in_n.at(ti + 1);
+                                sp_size[2] = wei_len;
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpAdd,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       w_desc,
+                                       w,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + wei_len,
+                                       wei_shift_bias_temp + wei_len,
+                                       offset + wei_len);
+                            }
+                            cur_batch += in_n.at(ti);
+                        }
+                    }
+                }
+            }
+        }
+
+        // from hidden state
+        int bacc   = 0;
+        int baccbi = batch_n;
+        for(int ti = 0; ti < seqLen; ti++)
+        {
+            baccbi -= in_n.at(seqLen - 1 - ti);
+            wei_shift            = rnn_offsets.HiddenWeights(li);
+            size_t pretime_shift = 0;
+            int use_time         = 0;
+
+            for(int ri = 0; ri < bi; ri++)
+            {
+                int cur_time  = ri == 0 ? ti : seqLen - 1 - ti;
+                int cur_batch = ri == 0 ? bacc : baccbi;
+                offset        = rnn_offsets.Hidden(li, cur_batch);
+                if(ti > 0)
+                {
+                    pretime_shift = ri == 0
+                                        ? rnn_offsets.Hidden(li, bacc - in_n.at(ti - 1))
+                                        : rnn_offsets.Hidden(li, baccbi + in_n.at(seqLen - 1 - ti));
+                    use_time = ri == 0 ? ti : seqLen - ti;
+                }
+
+                if(in_n.at(cur_time) > 0)
+                {
+                    if(ti == 0)
+                    {
+                        if(shape.Given(hx))
+                        {
+                            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                              false,
+                                                                              true,
+                                                                              in_n.at(cur_time),
+                                                                              wei_len,
+                                                                              hy_h,
+                                                                              uni_stride,
+                                                                              uni_stride,
+                                                                              hy_stride,
+                                                                              1, // batch count
+                                                                              0, // Stride A
+                                                                              0, // Stride B
+                                                                              0, // Stride C
+                                                                              1, // alpha
+                                                                              1, // beta
+                                                                              shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 hx,
+                                 hx_shift + ri * hy_n * hy_h,
+                                 w,
+                                 wei_shift + ri * wei_len * uni_stride,
+                                 reserveSpace,
+                                 offset + ri * wei_len);
+                        }
+                    }
+                    else
+                    {
+                        if(ri == 1 && shape.Given(hx) && in_n.at(cur_time) > in_n.at(use_time))
+                        {
+                            miopen::GemmDescriptor gemm_desc =
+                                GemmDescriptor{false,
+                                               false,
+                                               true,
+                                               (in_n.at(cur_time) - in_n.at(use_time)),
+                                               wei_len,
+                                               hy_h,
+                                               uni_stride,
+                                               uni_stride,
+                                               hy_stride,
+                                               1, // batch count
+                                               0, // Stride A
+                                               0, // Stride B
+                                               0, // Stride C
+                                               1, // alpha
+                                               1, // beta
+                                               shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 hx,
+                                 hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                 w,
+                                 wei_shift + ri * wei_len * uni_stride,
+                                 reserveSpace,
+                                 offset + ri * wei_len + in_n.at(use_time) * hy_stride);
+                        }
+
+                        if(in_n.at(use_time) > 0)
+                        {
+                            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                              false,
+                                                                              true,
+                                                                              in_n.at(use_time),
+                                                                              wei_len,
+                                                                              hy_h,
+                                                                              hy_stride,
+                                                                              uni_stride,
+                                                                              hy_stride,
+                                                                              1, // batch count
+                                                                              0, // Stride A
+                                                                              0, // Stride B
+                                                                              0, // Stride C
+                                                                              1, // alpha
+                                                                              1, // beta
+                                                                              shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 reserveSpace,
+                                 pretime_shift + hid_off + ri * hy_h,
+                                 w,
+                                 wei_shift + ri * wei_len * uni_stride,
+                                 reserveSpace,
+                                 offset + ri * wei_len);
+                        }
+                    }
+
+                    // update hidden status
+                    sp_size[1] = in_n.at(cur_time);
+                    if(rnnMode == miopenRNNRELU || rnnMode == miopenRNNTANH)
+                    {
+                        sp_size[2] = hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(activDesc,
+                                          alpha,
+                                          sp_desc,
+                                          reserveSpace,
+                                          beta,
+                                          sp_desc,
+                                          reserveSpace,
+                                          offset + ri * wei_len,
+                                          offset + ri * wei_len + rnn_offsets.Hidden(nLayers));
+                    }
+                    else if(rnnMode == miopenLSTM)
+                    {
+                        // active gate i, f, o
+                        sp_size[2] = hy_h * 3;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(sigDesc,
+                                          alpha,
+                                          sp_desc,
+                                          reserveSpace,
+                                          beta,
+                                          sp_desc,
+                                          reserveSpace,
+                                          offset + ri * wei_len,
+                                          offset + ri * wei_len + rnn_offsets.Hidden(nLayers));
+
+                        // active gate c
+                        sp_size[2] = hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(tanhDesc,
+                                          alpha,
+                                          sp_desc,
+                                          reserveSpace,
+                                          beta,
+                                          sp_desc,
+                                          reserveSpace,
+                                          offset + 3 * hy_h + ri * wei_len,
+                                          offset + 3 * hy_h + ri * wei_len +
+                                              rnn_offsets.Hidden(nLayers));
+
+                        // update cell state
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 1;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + 3 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + bi * wei_len + ri * hy_h);
+
+                        if(ti == 0)
+                        {
+                            if(shape.Given(cx))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       cx,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + bi * wei_len + ri * hy_h);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(cx) && in_n.at(cur_time) > in_n.at(use_time))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       cx,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + hy_h + ri * wei_len +
+                                           in_n.at(use_time) * hy_stride +
+                                           rnn_offsets.Hidden(nLayers),
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                       offset + bi * wei_len + ri * hy_h +
+                                           in_n.at(use_time) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            if(in_n.at(use_time) > 0)
+                            {
+                                if(in_n.at(use_time) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(use_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       reserveSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                       pretime_shift + bi * wei_len + ri * hy_h,
+                                       offset + bi * wei_len + ri * hy_h);
+
+                                if(in_n.at(use_time) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(cur_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+                            }
+                        }
+
+                        // active cell state
+                        ActivationForward(tanhDesc,
+                                          alpha,
+                                          sp_desc,
+                                          reserveSpace,
+                                          beta,
+                                          sp_desc,
+                                          reserveSpace,
+                                          offset + bi * wei_len + ri * hy_h,
+                                          offset + bi * wei_len + ri * hy_h +
+                                              rnn_offsets.Hidden(nLayers));
+
+                        // update hidden state
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + 2 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + bi * wei_len + ri * hy_h + rnn_offsets.Hidden(nLayers),
+                               offset + hid_off + ri * hy_h);
+                    }
+                    else if(rnnMode == miopenGRU)
+                    {
+                        // active z, r gate
+                        sp_size[2] = 2 * hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationForward(sigDesc,
+                                          alpha,
+                                          sp_desc,
+                                          reserveSpace,
+                                          beta,
+                                          sp_desc,
+                                          reserveSpace,
+                                          offset + ri * wei_len,
+                                          offset + ri * wei_len + rnn_offsets.Hidden(nLayers));
+
+                        // calculate c gate
+                        sp_size[2] = hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        Copy(sp_desc,
+                             reserveSpace,
+                             sp_desc,
+                             reserveSpace,
+                             offset + 2 * hy_h + ri * wei_len,
+                             offset + hid_off + ri * hy_h + rnn_offsets.Hidden(nLayers));
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + hid_off + ri * hy_h,
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        // active c gate
+                        ActivationForward(tanhDesc,
+                                          alpha,
+                                          sp_desc,
+                                          reserveSpace,
+                                          beta,
+                                          sp_desc,
+                                          reserveSpace,
+                                          offset + 2 * hy_h + ri * wei_len,
+                                          offset + 2 * hy_h + ri * wei_len +
+                                              rnn_offsets.Hidden(nLayers));
+
+                        // calculate hidden state
+                        alpha0 = -1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + 2 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + hid_off + ri * hy_h);
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + 2 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + hid_off + ri * hy_h,
+                               offset + hid_off + ri * hy_h);
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 1;
+
+                        if(ti == 0)
+                        {
+                            if(shape.Given(hx))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       hx,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + hid_off + ri * hy_h);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(hx) && in_n.at(cur_time) > in_n.at(use_time))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       hx,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + ri * wei_len + in_n.at(use_time) * hy_stride +
+                                           rnn_offsets.Hidden(nLayers),
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                       offset + hid_off + ri * hy_h +
+                                           in_n.at(use_time) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            if(in_n.at(use_time) > 0)
+                            {
+                                if(in_n.at(use_time) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(use_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       reserveSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                       pretime_shift + hid_off + ri * hy_h,
+                                       offset + hid_off + ri * hy_h);
+                            }
+                        }
+                    }
+                }
+            }
+
+            bacc += in_n.at(ti);
+        }
+
+        // update hy, cy
+        if(shape.Given(hy) || (rnnMode == miopenLSTM && shape.Given(cy)))
+        {
+            hx_size[2] = hy_h;
+            sp_size[2] = hy_h;
+
+            bacc   = batch_n;
+            baccbi = 0;
+            for(int ti = seqLen - 1; ti >= 0; ti--)
+            {
+                bacc -= in_n.at(ti);
+                for(int ri = 0; ri < bi; ri++)
+                {
+                    int cur_time  = ri == 0 ? ti : seqLen - 1 - ti;
+                    int cur_batch = ri == 0 ? bacc : baccbi;
+                    int use_batch = 0;
+
+                    if(ti < seqLen - 1)
+                    {
+                        int use_time = ri == 0 ? ti + 1 : seqLen - 2 - ti;
+                        use_batch    = in_n.at(use_time);
+                    }
+
+                    if(in_n.at(cur_time) > use_batch)
+                    {
+                        offset = rnn_offsets.Hidden(li, cur_batch);
+
+                        sp_size[1] = in_n.at(cur_time) - use_batch;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        hx_size[1] = sp_size[1];
+                        hx_desc    = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+
+                        if(shape.Given(hy))
+                        {
+                            Copy(sp_desc,
+                                 reserveSpace,
+                                 hx_desc,
+                                 hy,
+                                 offset + hid_off + ri * hy_h + use_batch * hy_stride,
+                                 hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                        }
+
+                        if(rnnMode == miopenLSTM && shape.Given(cy))
+                        {
+                            Copy(sp_desc,
+                                 reserveSpace,
+                                 hx_desc,
+                                 cy,
+                                 offset + bi * wei_len + ri * hy_h + use_batch * hy_stride,
+                                 hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                        }
+                    }
+                }
+                baccbi += in_n.at(seqLen - 1 - ti);
+            }
+        }
+    }
+
+    // output
+    prelayer_shift = rnn_offsets.Hidden(nLayers - 1) + hid_off;
+
+    sp_size[1] = batch_n;
+    sp_size[2] = hy_h * bi;
+    y_size[1]  = batch_n;
+    y_size[2]  = out_h;
+    y_desc     = miopen::TensorDescriptor(miopenFloat, y_size, y_stride);
+    sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+    Copy(sp_desc, reserveSpace, y_desc, y, prelayer_shift, 0);
+
+}
+
+void RNNPlanBuilder::EmitBackwardData()
+{
+    const RNNOffsets rnn_offsets(in_h, hy_h, bi, nLayers, batch_n, hy_n, hy_stride, wei_stride);
+    size_t offset;
+    float alpha0, alpha1, beta_t;
+    float alpha = 1, beta = 0;
+
+    std::vector<std::size_t> sp_size(3, 1), sp_stride(3, 1), x_size(3, 1), x_stride(3, 1),
+        y_size(3, 1), y_stride(3, 1), hx_size(3, 1), hx_stride(3, 1);
+    miopen::TensorDescriptor sp_desc, x_desc, y_desc, hx_desc;
+
+    sp_size[2]   = shape.workspace_elements;
+    sp_stride[0] = sp_size[2];
+    sp_stride[1] = sp_size[2];
+    sp_desc      = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+    Set(sp_desc, workSpace, beta);
+    sp_stride[0] = batch_n * hy_stride;
+    sp_stride[1] = hy_stride;
+    sp_size[2]   = 1;
+    x_stride[0]  = batch_n * in_stride;
+    x_stride[1]  = in_stride;
+    y_stride[0]  = batch_n * out_stride;
+    y_stride[1]  = out_stride;
+    if(shape.Given(dhx) || (rnnMode == miopenLSTM && shape.Given(dcx)))
+    {
+        hx_size[2]   = hy_d * hy_n * hy_h;
+        hx_stride[0] = hx_size[2];
+        hx_stride[1] = hx_size[2];
+        hx_desc      = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+        if(shape.Given(dhx))
+        {
+            Set(hx_desc, dhx, beta);
+        }
+        if(rnnMode == miopenLSTM && shape.Given(dcx))
+        {
+            Set(hx_desc, dcx, beta);
+        }
+    }
+    hx_stride[0] = in_n.at(0) * uni_stride;
+    hx_stride[1] = uni_stride;
+
+    size_t prelayer_shift, pretime_shift;
+    int cur_time, cur_batch;
+    int wei_len    = 0;
+    int wei_len_t  = 0;
+    int dhd_off    = 0;
+    int use_time   = 0;
+    int pre_batch  = 0;
+    int use_time2  = 0;
+    int pre_batch2 = 0;
+
+    switch(rnnMode)
+    {
+    case miopenRNNRELU:
+    case miopenRNNTANH:
+        wei_len   = hy_h;
+        wei_len_t = hy_h;
+        dhd_off   = 0;
+        break;
+    case miopenLSTM:
+        wei_len   = hy_h * 4;
+        wei_len_t = hy_h * 4;
+        dhd_off   = bi * hy_h * 5;
+        break;
+    case miopenGRU:
+        wei_len   = hy_h * 3;
+        wei_len_t = hy_h * 2;
+        dhd_off   = bi * hy_h * 3;
+        break;
+    }
+
+    ActivationDescriptor tanhDesc, sigDesc, activDesc;
+    sigDesc  = {miopenActivationLOGISTIC, 1, 0, 1};
+    tanhDesc = {miopenActivationTANH, 1, 1, 1};
+    if(rnnMode == miopenRNNRELU)
+    {
+        activDesc = {miopenActivationRELU, 1, 0, 1};
+    }
+    else if(rnnMode == miopenRNNTANH)
+    {
+        activDesc = {miopenActivationTANH, 1, 1, 1};
+    }
+
+    for(int li = nLayers - 1; li >= 0; li--)
+    {
+        size_t wei_shift     = rnn_offsets.InputWeights(li + 1);
+        size_t hid_shift     = rnn_offsets.Hidden(li);
+        size_t hx_shift      = rnn_offsets.HiddenState(li);
+        size_t weitime_shift = rnn_offsets.HiddenWeights(li);
+
+        // feedback from output
+        if(li == nLayers - 1)
+        {
+            y_size[1]  = batch_n;
+            y_size[2]  = out_h;
+            sp_size[1] = batch_n;
+            sp_size[2] = hy_h * bi;
+            y_desc     = miopen::TensorDescriptor(miopenFloat, y_size, y_stride);
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            Copy(y_desc, dy, sp_desc, workSpace, 0, hid_shift + dhd_off); // start timing
+        }
+        else
+        {
+            prelayer_shift                   = rnn_offsets.Hidden(li + 1);
+            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                              false,
+                                                              false,
+                                                              batch_n,
+                                                              hy_h * bi,
+                                                              wei_len * bi,
+                                                              hy_stride,
+                                                              bi_stride,
+                                                              hy_stride,
+                                                              1, // batch count
+                                                              0, // Stride A
+                                                              0, // Stride B
+                                                              0, // Stride C
+                                                              1, // alpha
+                                                              1, // beta
+                                                              shape.data_type};
+
+            Gemm(gemm_desc,
+                 workSpace,
+                 prelayer_shift,
+                 w,
+                 wei_shift,
+                 workSpace,
+                 hid_shift + dhd_off);
+        }
+
+        // from hidden state
+        int bacc   = batch_n;
+        int baccbi = 0;
+        for(int ti = seqLen - 1; ti >= 0; ti--)
+        {
+            bacc -= in_n.at(ti);
+
+            // from post state
+            for(int ri = 0; ri < bi; ri++)
+            {
+                cur_time  = ri == 0 ? ti : seqLen - 1 - ti;
+                cur_batch = ri == 0 ? bacc : baccbi;
+                offset    = rnn_offsets.Hidden(li, cur_batch);
+                if(ti < seqLen - 1)
+                {
+                    use_time  = ri == 0 ? ti + 1 : seqLen - 1 - ti;
+                    pre_batch = ri == 0 ? bacc + in_n.at(ti) : baccbi - in_n.at(seqLen - 2 - ti);
+                }
+                if(ti > 0)
+                {
+                    use_time2 = ri == 0 ? ti : seqLen - ti;
+                    pre_batch2 =
+                        ri == 0 ? bacc - in_n.at(ti - 1) : baccbi + in_n.at(seqLen - 1 - ti);
+                }
+
+                if(in_n.at(cur_time) > 0)
+                {
+                    if(ti == seqLen - 1)
+                    {
+                        if(shape.Given(dhy))
+                        {
+                            alpha0 = 1;
+                            alpha1 = 1;
+                            beta_t = 0;
+
+                            hx_size[1] = in_n.at(cur_time);
+                            hx_size[2] = hy_h;
+                            sp_size[1] = in_n.at(cur_time);
+                            sp_size[2] = hy_h;
+                            hx_desc    = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+                            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                            Tensor(miopenTensorOpAdd,
+                                   alpha0,
+                                   hx_desc,
+                                   dhy,
+                                   alpha1,
+                                   sp_desc,
+                                   workSpace,
+                                   beta_t,
+                                   sp_desc,
+                                   workSpace,
+                                   hx_shift + ri * hy_n * hy_h,
+                                   offset + dhd_off + ri * hy_h,
+                                   offset + dhd_off + ri * hy_h);
+                        }
+                    }
+                    else
+                    {
+                        if(ri == 0 && shape.Given(dhy) && in_n.at(cur_time) > in_n.at(use_time))
+                        {
+                            alpha0 = 1;
+                            alpha1 = 1;
+                            beta_t = 0;
+
+                            hx_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                            hx_size[2] = hy_h;
+                            sp_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                            sp_size[2] = hy_h;
+                            hx_desc    = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+                            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                            Tensor(miopenTensorOpAdd,
+                                   alpha0,
+                                   hx_desc,
+                                   dhy,
+                                   alpha1,
+                                   sp_desc,
+                                   workSpace,
+                                   beta_t,
+                                   sp_desc,
+                                   workSpace,
+                                   hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                   offset + dhd_off + ri * hy_h + in_n.at(use_time) * hy_stride,
+                                   offset + dhd_off + ri * hy_h + in_n.at(use_time) * hy_stride);
+                        }
+
+                        pretime_shift = rnn_offsets.Hidden(li, pre_batch) + ri * wei_len;
+
+                        if(in_n.at(use_time) > 0)
+                        {
+                            if(rnnMode == miopenGRU)
+                            {
+                                sp_size[1] = in_n.at(use_time);
+                                sp_size[2] = hy_h;
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+
+                                alpha0 = 1;
+                                alpha1 = 1;
+                                beta_t = 1;
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       reserveSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       pretime_shift - ri * 2 * hy_h + dhd_off,
+                                       pretime_shift + rnn_offsets.Hidden(nLayers),
+                                       offset + dhd_off + ri * hy_h);
+
+                                Copy(sp_desc,
+                                     workSpace,
+                                     sp_desc,
+                                     workSpace,
+                                     pretime_shift + 2 * hy_h,
+                                     offset + ri * wei_len + 2 * hy_h);
+
+                                Copy(sp_desc,
+                                     reserveSpace,
+                                     sp_desc,
+                                     workSpace,
+                                     pretime_shift - ri * 2 * hy_h + dhd_off +
+                                         rnn_offsets.Hidden(nLayers),
+                                     pretime_shift + 2 * hy_h);
+                            }
+                            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                              false,
+                                                                              false,
+                                                                              in_n.at(use_time),
+                                                                              hy_h,
+                                                                              wei_len,
+                                                                              hy_stride,
+                                                                              uni_stride,
+                                                                              hy_stride,
+                                                                              1, // batch count
+                                                                              0, // Stride A
+                                                                              0, // Stride B
+                                                                              0, // Stride C
+                                                                              1, // alpha
+                                                                              1, // beta
+                                                                              shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 workSpace,
+                                 pretime_shift,
+                                 w,
+                                 weitime_shift + ri * wei_len * uni_stride,
+                                 workSpace,
+                                 offset + dhd_off + ri * hy_h);
+
+                            if(rnnMode == miopenGRU)
+                            {
+                                Copy(sp_desc,
+                                     workSpace,
+                                     sp_desc,
+                                     workSpace,
+                                     offset + ri * wei_len + 2 * hy_h,
+                                     pretime_shift + 2 * hy_h);
+                            }
+                        }
+                    }
+
+                    // update hidden status
+                    sp_size[1] = in_n.at(cur_time);
+                    sp_size[2] = hy_h;
+                    sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                    if(rnnMode == miopenRNNRELU || rnnMode == miopenRNNTANH)
+                    {
+                        // activation
+                        ActivationBackward(activDesc,
+                                           alpha,
+                                           sp_desc,
+                                           reserveSpace,
+                                           sp_desc,
+                                           workSpace,
+                                           sp_desc,
+                                           reserveSpace,
+                                           beta,
+                                           sp_desc,
+                                           workSpace,
+                                           offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                           offset + ri * wei_len,
+                                           offset + ri * wei_len,
+                                           offset + ri * wei_len);
+                    }
+                    else if(rnnMode == miopenLSTM)
+                    {
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        // update cell state
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + dhd_off + ri * hy_h,
+                               offset + 2 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + bi * wei_len + ri * hy_h);
+
+                        ActivationBackward(tanhDesc,
+                                           alpha,
+                                           sp_desc,
+                                           reserveSpace,
+                                           sp_desc,
+                                           workSpace,
+                                           sp_desc,
+                                           reserveSpace,
+                                           beta,
+                                           sp_desc,
+                                           workSpace,
+                                           offset + bi * wei_len + ri * hy_h +
+                                               rnn_offsets.Hidden(nLayers),
+                                           offset + bi * wei_len + ri * hy_h,
+                                           offset + bi * wei_len + ri * hy_h,
+                                           offset + bi * wei_len + ri * hy_h);
+
+                        if(ti == seqLen - 1)
+                        {
+                            if(shape.Given(dcy))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpAdd,
+                                       alpha0,
+                                       hx_desc,
+                                       dcy,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + bi * wei_len + ri * hy_h,
+                                       offset + bi * wei_len + ri * hy_h);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 0 && shape.Given(dcy) && in_n.at(cur_time) > in_n.at(use_time))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                hx_size[2] = hy_h;
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time);
+                                sp_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+                                sp_desc = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpAdd,
+                                       alpha0,
+                                       hx_desc,
+                                       dcy,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                       offset + bi * wei_len + ri * hy_h +
+                                           in_n.at(use_time) * hy_stride,
+                                       offset + bi * wei_len + ri * hy_h +
+                                           in_n.at(use_time) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            pretime_shift = rnn_offsets.Hidden(li, pre_batch);
+                            alpha0        = 1;
+                            alpha1        = 1;
+                            beta_t        = 1;
+
+                            if(in_n.at(cur_time) != in_n.at(use_time))
+                            {
+                                sp_size[1] = in_n.at(use_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            Tensor(miopenTensorOpMul,
+                                   alpha0,
+                                   sp_desc,
+                                   workSpace,
+                                   alpha1,
+                                   sp_desc,
+                                   reserveSpace,
+                                   beta_t,
+                                   sp_desc,
+                                   workSpace,
+                                   pretime_shift + bi * wei_len + ri * hy_h,
+                                   pretime_shift + hy_h + ri * wei_len +
+                                       rnn_offsets.Hidden(nLayers),
+                                   offset + bi * wei_len + ri * hy_h);
+
+                            if(in_n.at(cur_time) != in_n.at(use_time))
+                            {
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+                        }
+
+                        // update forget gate
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        if(ti == 0)
+                        {
+                            if(shape.Given(cx))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       cx,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + bi * wei_len + ri * hy_h,
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + hy_h + ri * wei_len);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(cx) && in_n.at(cur_time) > in_n.at(use_time2))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time2);
+                                hx_size[2] = hy_h;
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time2);
+                                sp_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+                                sp_desc = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       hx_desc,
+                                       cx,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + bi * wei_len + ri * hy_h +
+                                           in_n.at(use_time2) * hy_stride,
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time2) * hy_h,
+                                       offset + hy_h + ri * wei_len +
+                                           in_n.at(use_time2) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            if(in_n.at(use_time2) > 0)
+                            {
+                                pretime_shift = rnn_offsets.Hidden(li, pre_batch2);
+
+                                if(in_n.at(cur_time) != in_n.at(use_time2))
+                                {
+                                    sp_size[1] = in_n.at(use_time2);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       reserveSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       offset + bi * wei_len + ri * hy_h,
+                                       pretime_shift + bi * wei_len + ri * hy_h,
+                                       offset + hy_h + ri * wei_len);
+
+                                if(in_n.at(cur_time) != in_n.at(use_time2))
+                                {
+                                    sp_size[1] = in_n.at(cur_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+                            }
+                        }
+
+                        // update input gate
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + bi * wei_len + ri * hy_h,
+                               offset + 3 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + ri * wei_len);
+
+                        // update output gate
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + dhd_off + ri * hy_h,
+                               offset + bi * wei_len + ri * hy_h + rnn_offsets.Hidden(nLayers),
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        // update c gate
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + bi * wei_len + ri * hy_h,
+                               offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + 3 * hy_h + ri * wei_len);
+
+                        ActivationBackward(tanhDesc,
+                                           alpha,
+                                           sp_desc,
+                                           reserveSpace,
+                                           sp_desc,
+                                           workSpace,
+                                           sp_desc,
+                                           reserveSpace,
+                                           beta,
+                                           sp_desc,
+                                           workSpace,
+                                           offset + 3 * hy_h + ri * wei_len +
+                                               rnn_offsets.Hidden(nLayers),
+                                           offset + 3 * hy_h + ri * wei_len,
+                                           offset + 3 * hy_h + ri * wei_len,
+                                           offset + 3 * hy_h + ri * wei_len);
+
+                        sp_size[2] = 3 * hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                        ActivationBackward(sigDesc,
+                                           alpha,
+                                           sp_desc,
+                                           reserveSpace,
+                                           sp_desc,
+                                           workSpace,
+                                           sp_desc,
+                                           reserveSpace,
+                                           beta,
+                                           sp_desc,
+                                           workSpace,
+                                           offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                           offset + ri * wei_len,
+                                           offset + ri * wei_len,
+                                           offset + ri * wei_len);
+                    }
+                    else if(rnnMode == miopenGRU)
+                    {
+                        // c gate
+                        alpha0 = 1;
+                        alpha1 = -1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + dhd_off + ri * hy_h,
+                               offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        alpha0 = 1;
+                        alpha1 = 1;
+                        beta_t = 0;
+
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + dhd_off + ri * hy_h,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + 2 * hy_h + ri * wei_len);
+
+                        ActivationBackward(tanhDesc,
+                                           alpha,
+                                           sp_desc,
+                                           reserveSpace,
+                                           sp_desc,
+                                           workSpace,
+                                           sp_desc,
+                                           reserveSpace,
+                                           beta,
+                                           sp_desc,
+                                           workSpace,
+                                           offset + 2 * hy_h + ri * wei_len +
+                                               rnn_offsets.Hidden(nLayers),
+                                           offset + 2 * hy_h + ri * wei_len,
+                                           offset + 2 * hy_h + ri * wei_len,
+                                           offset + 2 * hy_h + ri * wei_len);
+
+                        // r gate
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + dhd_off + ri * hy_h + rnn_offsets.Hidden(nLayers),
+                               offset + hy_h + ri * wei_len);
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               sp_desc,
+                               reserveSpace,
+                               beta_t,
+                               sp_desc,
+                               reserveSpace,
+                               offset + 2 * hy_h + ri * wei_len,
+                               offset + hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + dhd_off + ri * hy_h + rnn_offsets.Hidden(nLayers));
+
+                        // z gate
+                        if(ti == 0)
+                        {
+                            if(shape.Given(hx))
+                            {
+                                hx_size[1] = in_n.at(cur_time);
+                                hx_size[2] = hy_h;
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       hx_desc,
+                                       hx,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       hx_shift + ri * hy_n * hy_h,
+                                       offset + dhd_off + ri * hy_h,
+                                       offset + ri * wei_len);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(hx) && in_n.at(cur_time) > in_n.at(use_time2))
+                            {
+                                hx_size[1] = in_n.at(cur_time) - in_n.at(use_time2);
+                                hx_size[2] = hy_h;
+                                sp_size[1] = in_n.at(cur_time) - in_n.at(use_time2);
+                                hx_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, hx_size, hx_stride);
+                                sp_desc = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       hx_desc,
+                                       hx,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       hx_shift + ri * hy_n * hy_h + in_n.at(use_time2) * hy_h,
+                                       offset + dhd_off + ri * hy_h +
+                                           in_n.at(use_time2) * hy_stride,
+                                       offset + ri * wei_len + in_n.at(use_time2) * hy_stride);
+
+                                sp_size[1] = in_n.at(cur_time);
+                                sp_desc    = miopen::TensorDescriptor(
+                                    miopenFloat, sp_size, sp_stride);
+                            }
+
+                            if(in_n.at(use_time2) > 0)
+                            {
+                                if(in_n.at(use_time2) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(use_time2);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       reserveSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       workSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       workSpace,
+                                       hid_shift + pre_batch2 * hy_stride + dhd_off + ri * hy_h,
+                                       offset + dhd_off + ri * hy_h,
+                                       offset + ri * wei_len);
+
+                                if(in_n.at(use_time2) != in_n.at(cur_time))
+                                {
+                                    sp_size[1] = in_n.at(cur_time);
+                                    sp_desc    = miopen::TensorDescriptor(
+                                        miopenFloat, sp_size, sp_stride);
+                                }
+                            }
+                        }
+
+                        alpha0 = -1;
+                        alpha1 = 1;
+                        beta_t = 1;
+
+                        Tensor(miopenTensorOpMul,
+                               alpha0,
+                               sp_desc,
+                               reserveSpace,
+                               alpha1,
+                               sp_desc,
+                               workSpace,
+                               beta_t,
+                               sp_desc,
+                               workSpace,
+                               offset + 2 * hy_h + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                               offset + dhd_off + ri * hy_h,
+                               offset + ri * wei_len);
+
+                        sp_size[2] = 2 * hy_h;
+                        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+                        ActivationBackward(sigDesc,
+                                           alpha,
+                                           sp_desc,
+                                           reserveSpace,
+                                           sp_desc,
+                                           workSpace,
+                                           sp_desc,
+                                           reserveSpace,
+                                           beta,
+                                           sp_desc,
+                                           workSpace,
+                                           offset + ri * wei_len + rnn_offsets.Hidden(nLayers),
+                                           offset + ri * wei_len,
+                                           offset + ri * wei_len,
+                                           offset + ri * wei_len);
+                    }
+                }
+            }
+
+            baccbi += in_n.at(seqLen - 1 - ti);
+        }
+
+        // dcx, dhx
+        if(shape.Given(dhx) || (rnnMode == miopenLSTM && shape.Given(dcx)))
+        {
+            hx_size[2] = hy_h;
+            sp_size[2] = hy_h;
+
+            bacc   = 0;
+            baccbi = batch_n;
+            for(int ti = 0; ti < seqLen; ti++)
+            {
+                baccbi -= in_n.at(seqLen - 1 - ti);
+                for(int ri = 0; ri < bi; ri++)
+                {
+                    cur_time      = ri == 0 ? ti : seqLen - 1 - ti;
+                    cur_batch     = ri == 0 ? bacc : baccbi;
+                    use_time      = 0;
+                    int use_batch = 0;
+
+                    if(ti > 0)
+                    {
+                        use_time  = ri == 0 ? ti - 1 : seqLen - ti;
+                        use_batch = in_n.at(use_time);
+                    }
+
+                    if(in_n.at(cur_time) > use_batch)
+                    {
+                        pretime_shift = rnn_offsets.Hidden(li, cur_batch);
+
+                        if(rnnMode == miopenLSTM || rnnMode == miopenGRU)
+                        {
+                            sp_size[1] = in_n.at(cur_time) - use_batch;
+                            hx_size[1] = in_n.at(cur_time) - use_batch;
+                            hx_desc    = miopen::TensorDescriptor(miopenFloat, hx_size, hx_stride);
+                            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+                        }
+
+                        if(shape.Given(dhx))
+                        {
+                            if(rnnMode == miopenGRU)
+                            {
+                                alpha0 = 1;
+                                alpha1 = 1;
+                                beta_t = 0;
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       reserveSpace,
+                                       beta_t,
+                                       sp_desc,
+                                       reserveSpace,
+                                       pretime_shift + 2 * hy_h + ri * wei_len +
+                                           use_batch * hy_stride,
+                                       pretime_shift + hy_h + ri * wei_len + use_batch * hy_stride +
+                                           rnn_offsets.Hidden(nLayers),
+                                       pretime_shift + dhd_off + ri * hy_h + use_batch * hy_stride +
+                                           rnn_offsets.Hidden(nLayers));
+                                miopen::GemmDescriptor gemm_desc =
+                                    GemmDescriptor{false,
+                                                   false,
+                                                   false,
+                                                   (in_n.at(cur_time) - use_batch),
+                                                   hy_h,
+                                                   hy_h,
+                                                   hy_stride,
+                                                   uni_stride,
+                                                   uni_stride,
+                                                   1, // batch count
+                                                   0, // Stride A
+                                                   0, // Stride B
+                                                   0, // Stride C
+                                                   1, // alpha
+                                                   0, // beta
+                                                   shape.data_type};
+
+                                Gemm(gemm_desc,
+                                     reserveSpace,
+                                     pretime_shift + dhd_off + ri * hy_h + use_batch * hy_stride +
+                                         rnn_offsets.Hidden(nLayers),
+                                     w,
+                                     weitime_shift + 2 * hy_h * uni_stride +
+                                         ri * wei_len * uni_stride,
+                                     dhx,
+                                     hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+
+                                beta_t = 1;
+
+                                Tensor(miopenTensorOpMul,
+                                       alpha0,
+                                       sp_desc,
+                                       workSpace,
+                                       alpha1,
+                                       sp_desc,
+                                       reserveSpace,
+                                       beta_t,
+                                       hx_desc,
+                                       dhx,
+                                       pretime_shift + dhd_off + ri * hy_h + use_batch * hy_stride,
+                                       pretime_shift + ri * wei_len + use_batch * hy_stride +
+                                           rnn_offsets.Hidden(nLayers),
+                                       hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                            }
+
+                            miopen::GemmDescriptor gemm_desc =
+                                GemmDescriptor{false,
+                                               false,
+                                               false,
+                                               (in_n.at(cur_time) - use_batch),
+                                               hy_h,
+                                               wei_len_t,
+                                               hy_stride,
+                                               uni_stride,
+                                               uni_stride,
+                                               1, // batch count
+                                               0, // Stride A
+                                               0, // Stride B
+                                               0, // Stride C
+                                               1, // alpha
+                                               1, // beta
+                                               shape.data_type};
+
+                            Gemm(gemm_desc,
+                                 workSpace,
+                                 pretime_shift + ri * wei_len + use_batch * hy_stride,
+                                 w,
+                                 weitime_shift + ri * wei_len * uni_stride,
+                                 dhx,
+                                 hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                        }
+
+                        if(rnnMode == miopenLSTM && shape.Given(dcx))
+                        {
+                            alpha0 = 1;
+                            alpha1 = 1;
+                            beta_t = 1;
+
+                            Tensor(miopenTensorOpMul,
+                                   alpha0,
+                                   sp_desc,
+                                   workSpace,
+                                   alpha1,
+                                   sp_desc,
+                                   reserveSpace,
+                                   beta_t,
+                                   hx_desc,
+                                   dcx,
+                                   pretime_shift + bi * wei_len + ri * hy_h + use_batch * hy_stride,
+                                   pretime_shift + hy_h + ri * wei_len + use_batch * hy_stride +
+                                       rnn_offsets.Hidden(nLayers),
+                                   hx_shift + ri * hy_n * hy_h + use_batch * hy_h);
+                        }
+                    }
+                }
+                bacc += in_n.at(ti);
+            }
+        }
+    }
+
+    // dinput
+    if(inputMode == miopenRNNskip)
+    {
+        sp_size[1] = batch_n;
+        sp_size[2] = hy_h;
+        x_size[1]  = batch_n;
+        x_size[2]  = hy_h;
+        x_desc     = miopen::TensorDescriptor(miopenFloat, x_size, x_stride);
+        sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+        alpha0 = 1;
+        alpha1 = 1;
+        beta_t = 0;
+
+        for(int gi = 0; gi < nHiddenTensorsPerLayer * bi; gi++)
+        {
+            Tensor(miopenTensorOpAdd,
+                   alpha0,
+                   sp_desc,
+                   workSpace,
+                   alpha1,
+                   x_desc,
+                   dx,
+                   beta_t,
+                   x_desc,
+                   dx,
+                   gi * hy_h,
+                   0,
+                   0);
+        }
+    }
+    else
+    {
+        miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                          false,
+                                                          false,
+                                                          batch_n,
+                                                          in_h,
+                                                          wei_len * bi,
+                                                          hy_stride,
+                                                          in_stride,
+                                                          in_stride,
+                                                          1, // batch count
+                                                          0, // Stride A
+                                                          0, // Stride B
+                                                          0, // Stride C
+                                                          1, // alpha
+                                                          0, // beta
+                                                          shape.data_type};
+        Gemm(gemm_desc, workSpace, 0, w, 0, dx, 0);
+    }
+}
+
+void RNNPlanBuilder::EmitBackwardWeights()
+{
+    const RNNOffsets rnn_offsets(in_h, hy_h, bi, nLayers, batch_n, hy_n, hy_stride, wei_stride);
+
+    float alpha0, alpha1, beta_t = 0;
+
+    std::vector<std::size_t> sp_size(3, 1), sp_stride(3, 1), w_size(3, 1), w_stride(3, 1);
+    miopen::TensorDescriptor sp_desc, w_desc;
+
+    sp_stride[0] = batch_n * hy_stride;
+    sp_stride[1] = hy_stride;
+    w_size[2]    = shape.dw_elements;
+    w_stride[0]  = w_size[2];
+    w_stride[1]  = w_size[2];
+    w_desc       = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+    Set(w_desc, dw, beta_t);
+    w_stride[0] = wei_stride;
+    w_stride[1] = wei_stride;
+    w_size[2]   = 1;
+
+    int wei_len    = 0;
+    size_t hid_off = 0;
+    int use_time   = 0;
+    int pre_batch  = 0;
+
+    switch(rnnMode)
+    {
+    case miopenRNNRELU:
+    case miopenRNNTANH:
+        wei_len = hy_h;
+        hid_off = rnn_offsets.Hidden(nLayers);
+        break;
+    case miopenLSTM:
+        wei_len = hy_h * 4;
+        hid_off = bi * hy_h * 5;
+        break;
+    case miopenGRU:
+        wei_len = hy_h * 3;
+        hid_off = bi * hy_h * 3;
+        break;
+    }
+
+    for(int li = 0; li < nLayers; li++)
+    {
+        size_t hid_shift = rnn_offsets.Hidden(li);
+        size_t wei_shift = rnn_offsets.InputWeights(li);
+
+        // between layers
+        if(li == 0)
+        {
+            if(inputMode == miopenRNNlinear)
+            {
+                miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                  true,
+                                                                  false,
+                                                                  wei_len * bi,
+                                                                  in_h,
+                                                                  batch_n,
+                                                                  hy_stride,
+                                                                  in_stride,
+                                                                  in_stride,
+                                                                  1, // batch count
+                                                                  0, // Stride A
+                                                                  0, // Stride B
+                                                                  0, // Stride C
+                                                                  1, // alpha
+                                                                  1, // beta
+                                                                  shape.data_type};
+
+                Gemm(gemm_desc, workSpace, 0, x, 0, dw, 0);
+            }
+        }
+        else
+        {
+            size_t prelayer_shift            = rnn_offsets.Hidden(li - 1) + hid_off;
+            miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                              true,
+                                                              false,
+                                                              wei_len * bi,
+                                                              hy_h * bi,
+                                                              batch_n,
+                                                              hy_stride,
+                                                              hy_stride,
+                                                              bi_stride,
+                                                              1, // batch count
+                                                              0, // Stride A
+                                                              0, // Stride B
+                                                              0, // Stride C
+                                                              1, // alpha
+                                                              1, // beta
+                                                              shape.data_type};
+
+            Gemm(gemm_desc, workSpace, hid_shift, reserveSpace, prelayer_shift, dw, wei_shift);
+        }
+
+        if(biasMode != 0u)
+        {
+            wei_shift = rnn_offsets.Bias(li);
+
+            sp_size[1] = 1;
+            sp_size[2] = wei_stride;
+            w_size[1]  = 1;
+            w_size[2]  = wei_stride;
+            w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            alpha0 = 1;
+            alpha1 = 0;
+            beta_t = 1;
+
+            for(int bs = 0; bs < batch_n; bs++)
+            {
+                Tensor(miopenTensorOpAdd,
+                       alpha0,
+                       sp_desc,
+                       workSpace,
+                       alpha1,
+                       sp_desc,
+                       workSpace,
+                       beta_t,
+                       w_desc,
+                       dw,
+                       hid_shift + bs * hy_stride,
+                       hid_shift + bs * hy_stride,
+                       wei_shift);
+            }
+        }
+
+        // between time
+        // Calculate feedback for c gate in GRU
+        if(rnnMode == miopenGRU)
+        {
+            sp_size[1] = batch_n;
+            sp_size[2] = hy_h;
+            sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+            for(int ri = 0; ri < bi; ri++)
+            {
+                Copy(sp_desc,
+                     reserveSpace,
+                     sp_desc,
+                     workSpace,
+                     hid_shift + hid_off + ri * hy_h + rnn_offsets.Hidden(nLayers),
+                     hid_shift + 2 * hy_h + ri * wei_len);
+            }
+        }
+
+        if(biasMode != 0u)
+        {
+            wei_shift = rnn_offsets.Bias(li) + wei_stride;
+
+            alpha0 = 1;
+            alpha1 = 1;
+            beta_t = 0;
+
+            if(shape.Given(hx))
+            {
+                if(rnnMode == miopenGRU)
+                {
+                    sp_size[1] = 1;
+                    sp_size[2] = wei_stride;
+                    w_size[1]  = 1;
+                    w_size[2]  = wei_stride;
+                    w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+                    sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                    for(int bs = 0; bs < batch_n; bs++)
+                    {
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               w_desc,
+                               dw,
+                               beta_t,
+                               w_desc,
+                               dw,
+                               hid_shift + bs * hy_stride,
+                               wei_shift,
+                               wei_shift);
+                    }
+                }
+                else
+                {
+                    Copy(w_desc, dw, w_desc, dw, wei_shift - wei_stride, wei_shift);
+                }
+            }
+            else
+            {
+                sp_size[1] = 1;
+                sp_size[2] = wei_len;
+                w_size[1]  = 1;
+                w_size[2]  = wei_len;
+                w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+                sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                for(int bs = 0; bs < batch_n; bs++)
+                {
+                    if(!(!shape.Given(hx) && bs < in_n.at(0)))
+                    {
+                        Tensor(miopenTensorOpAdd,
+                               alpha0,
+                               sp_desc,
+                               workSpace,
+                               alpha1,
+                               w_desc,
+                               dw,
+                               beta_t,
+                               w_desc,
+                               dw,
+                               hid_shift + bs * hy_stride,
+                               wei_shift,
+                               wei_shift);
+                    }
+                }
+
+                if(dirMode != 0u)
+                {
+                    sp_size[1] = 1;
+                    sp_size[2] = wei_len;
+                    w_size[1]  = 1;
+                    w_size[2]  = wei_len;
+                    w_desc     = miopen::TensorDescriptor(miopenFloat, w_size, w_stride);
+                    sp_desc    = miopen::TensorDescriptor(miopenFloat, sp_size, sp_stride);
+
+                    int cur_batch = 0;
+                    for(int ti = 0; ti < seqLen - 1; ti++)
+                    {
+                        for(int bs = 0; bs < in_n.at(ti + 1); bs++)
+                        {
+                            Tensor(miopenTensorOpAdd,
+                                   alpha0,
+                                   sp_desc,
+                                   workSpace,
+                                   alpha1,
+                                   w_desc,
+                                   dw,
+                                   beta_t,
+                                   w_desc,
+                                   dw,
+                                   hid_shift + (cur_batch + bs) * hy_stride + wei_len,
+                                   wei_shift + wei_len,
+                                   wei_shift + wei_len);
+                        }
+                        cur_batch += in_n.at(ti);
+                    }
+                }
+            }
+        }
+
+        size_t pretime_shift, hx_shift;
+        int cur_time;
+        bool comb_check = true;
+        if(seqLen > 2)
+        {
+            if(in_n.at(0) != in_n.at(seqLen - 2))
+            {
+                comb_check = false;
+            }
+        }
+
+        if(comb_check)
+        {
+            hx_shift  = rnn_offsets.HiddenState(li);
+            wei_shift = rnn_offsets.HiddenWeights(li);
+
+            for(int ri = 0; ri < bi; ri++)
+            {
+                hid_shift = ri == 0 ? rnn_offsets.Hidden(li)
+                                    : rnn_offsets.Hidden(li, in_n.at(0) * (seqLen - 1));
+                cur_time = ri == 0 ? 0 : seqLen - 1;
+
+                if(in_n.at(cur_time) > 0 && shape.Given(hx))
+                {
+                    miopen::GemmDescriptor gemm_desc = GemmDescriptor{false,
+                                                                      true,
+                                                                      false,
+                                                                      wei_len,
+                                                                      hy_h,
+                                                                      in_n.at(cur_time),
+                                                                      hy_stride,
+                                                                      uni_stride,
+                                                                      uni_stride,
+                                                                      1, // batch count
+                                                                      0, // Stride A
+                                                                      0, // Stride B
+                                                                      0, // Stride C
+                                                                      1, // alpha
+                                                                      1, // beta
+                                                                      shape.data_type};
+
+                    Gemm(gemm_desc,
+                         workSpace,
+                         hid_shift + ri * wei_len,
+                         hx,
+                         hx_shift + ri * hy_n * hy_h,
+                         dw,
+                         wei_shift + ri * wei_len * uni_stride);
+                }
+
+                if(seqLen > 1)
+                {
+                    if(ri == 1 && shape.Given(hx) && in_n.at(0) > in_n.at(seqLen - 1))
+                    {
+                        miopen::GemmDescriptor gemm_desc =
+                            GemmDescriptor{false,
+                                           true,
+                                           false,
+                                           wei_len,
+                                           hy_h,
+                                           (in_n.at(0) - in_n.at(seqLen - 1)),
+                                           hy_stride,
+                                           uni_stride,
+                                           uni_stride,
+                                           1, // batch count
+                                           0, // Stride A
+                                           0, // Stride B
+                                           0, // Stride C
+                                           1, // alpha
+                                           1, // beta
+                                           shape.data_type};
+
+                        Gemm(gemm_desc,
+                             workSpace,
+                             hid_shift +
+                                 ri * wei_len - (in_n.at(0) - in_n.at(seqLen - 1)) * hy_stride,
+                             hx,
+                             hx_shift + ri * hy_n * hy_h + in_n.at(seqLen - 1) * hy_h,
+                             dw,
+                             wei_shift + ri * wei_len * uni_stride);
+                    }
+
+                    hid_shift     = ri == 0 ? rnn_offsets.Hidden(li, in_n.at(0))
+                                            : rnn_offsets.Hidden(li);
+                    pretime_shift = ri == 0 ? rnn_offsets.Hidden(li) + hid_off
+                                            : rnn_offsets.Hidden(li, in_n.at(0)) + hid_off;
+
+                    miopen::GemmDescriptor gemm_desc =
+                        GemmDescriptor{false,
+                                       true,
+                                       false,
+                                       wei_len,
+                                       hy_h,
+                                       in_n.at(0) * (seqLen - 2) + in_n.at(seqLen - 1),
+                                       hy_stride,
+                                       hy_stride,
+                                       uni_stride,
+                                       1, // batch count
+                                       0, // Stride A
+                                       0, // Stride B
+                                       0, // Stride C
+                                       1, // alpha
+                                       1, // beta
+                                       shape.data_type};
+
+                    Gemm(gemm_desc,
+                         workSpace,
+                         hid_shift + ri * wei_len,
+                         reserveSpace,
+                         pretime_shift + ri * hy_h,
+                         dw,
+                         wei_shift + ri * wei_len * uni_stride);
+                }
+            }
+        }
+        else
+        {
+            int bacc   = 0;
+            int baccbi = batch_n;
+            for(int ti = 0; ti < seqLen; ti++)
+            {
+                baccbi -= in_n.at(seqLen - 1 - ti);
+
+                hx_shift  = rnn_offsets.HiddenState(li);
+                wei_shift = rnn_offsets.HiddenWeights(li);
+
+                for(int ri = 0; ri < bi; ri++)
+                {
+                    hid_shift = ri == 0 ? rnn_offsets.Hidden(li, bacc)
+                                        : rnn_offsets.Hidden(li, baccbi);
+                    cur_time = ri == 0 ? ti : seqLen - 1 - ti;
+                    if(ti > 0)
+                    {
+                        pre_batch =
+                            ri == 0 ? bacc - in_n.at(ti - 1) : baccbi + in_n.at(seqLen - 1 - ti);
+                        use_time = ri == 0 ? ti : seqLen - ti;
+                    }
+
+                    if(in_n.at(cur_time) > 0)
+                    {
+                        if(ti == 0)
+                        {
+                            if(shape.Given(hx))
+                            {
+                                miopen::GemmDescriptor gemm_desc =
+                                    GemmDescriptor{false,
+                                                   true,
+                                                   false,
+                                                   wei_len,
+                                                   hy_h,
+                                                   in_n.at(cur_time),
+                                                   hy_stride,
+                                                   uni_stride,
+                                                   uni_stride,
+                                                   1, // batch count
+                                                   0, // Stride A
+                                                   0, // Stride B
+                                                   0, // Stride C
+                                                   1, // alpha
+                                                   1, // beta
+                                                   shape.data_type};
+
+                                Gemm(gemm_desc,
+                                     workSpace,
+                                     hid_shift + ri * wei_len,
+                                     hx,
+                                     hx_shift + ri * hy_n * hy_h,
+                                     dw,
+                                     wei_shift + ri * wei_len * uni_stride);
+                            }
+                        }
+                        else
+                        {
+                            if(ri == 1 && shape.Given(hx) && in_n.at(cur_time) > in_n.at(use_time))
+                            {
+                                miopen::GemmDescriptor gemm_desc =
+                                    GemmDescriptor{false,
+                                                   true,
+                                                   false,
+                                                   wei_len,
+                                                   hy_h,
+                                                   (in_n.at(cur_time) - in_n.at(use_time)),
+                                                   hy_stride,
+                                                   uni_stride,
+                                                   uni_stride,
+                                                   1, // batch count
+                                                   0, // Stride A
+                                                   0, // Stride B
+                                                   0, // Stride C
+                                                   1, // alpha
+                                                   1, // beta
+                                                   shape.data_type};
+
+                                Gemm(gemm_desc,
+                                     workSpace,
+                                     hid_shift + ri * wei_len + in_n.at(use_time) * hy_stride,
+                                     hx,
+                                     hx_shift + ri * hy_n * hy_h + in_n.at(use_time) * hy_h,
+                                     dw,
+                                     wei_shift + ri * wei_len * uni_stride);
+                            }
+
+                            pretime_shift = rnn_offsets.Hidden(li, pre_batch) + hid_off;
+
+                            if(in_n.at(use_time) > 0)
+                            {
+                                miopen::GemmDescriptor gemm_desc =
+                                    GemmDescriptor{false,
+                                                   true,
+                                                   false,
+                                                   wei_len,
+                                                   hy_h,
+                                                   in_n.at(use_time),
+                                                   hy_stride,
+                                                   hy_stride,
+                                                   uni_stride,
+                                                   1, // batch count
+                                                   0, // Stride A
+                                                   0, // Stride B
+                                                   0, // Stride C
+                                                   1, // alpha
+                                                   1, // beta
+                                                   shape.data_type};
+
+                                Gemm(gemm_desc,
+                                     workSpace,
+                                     hid_shift + ri * wei_len,
+                                     reserveSpace,
+                                     pretime_shift + ri * hy_h,
+                                     dw,
+                                     wei_shift + ri * wei_len * uni_stride);
+                            }
+                        }
+                    }
+                }
+
+                bacc += in_n.at(ti);
+            }
+        }
+    }
+}
+
+// Points a GEMM matrix at the transposed copy of its weights in the packed layout
+void PackWeightMatrix(const RNNWeightLayout& layout, RNNPlan::Operand& o, bool& trans, int& ld)
+{
+    const auto* block = layout.Find(o.offset);
+    if(block == nullptr || static_cast<std::size_t>(ld) != block->columns)
+        MIOPEN_THROW(miopenStatusInternalError, "RNN GEMM does not match the weight layout");
+    o.offset = RNNWeightLayout::Packed(*block, o.offset);
+    ld       = block->rows;
+    trans    = !trans;
+}
+
+// Rewrites the operations of a plan built for canonical weights to read w and write dw in the
+// packed layout. A GEMM reading weights flips the transpose of that matrix, a GEMM writing
+// weight gradients computes the transposed product. Every other operation only touches biases
+// or the whole buffer, which are the same in both layouts.
+void PackWeights(const RNNPlanShape& shape, std::vector<RNNPlan::Op>& ops)
+{
+    const RNNWeightLayout layout(shape.input_mode == miopenRNNskip ? 0 : shape.in_h,
+                                 shape.hy_h,
+                                 shape.dir_mode != 0u ? 2 : 1,
+                                 shape.n_layers,
+                                 shape.hidden_tensors,
+                                 shape.bias_mode != 0u);
+    const auto weights = [](const RNNPlan::Operand& o) {
+        return o.buffer == RNNPlan::w || o.buffer == RNNPlan::dw;
+    };
+
+    for(auto& op : ops)
+    {
+        if(op.kind != RNNPlan::gemm)
+        {
+            for(const auto* o : {&op.a, &op.b, &op.c, &op.d})
+            {
+                if(op.kind != RNNPlan::set && weights(*o) && layout.Find(o->offset) != nullptr)
+                    MIOPEN_THROW(miopenStatusInternalError,
+                                 "RNN operation does not match the weight layout");
+            }
+            continue;
+        }
+
+        auto& g = op.gemm_desc;
+        if(!weights(op.a) && !weights(op.b) && !weights(op.c))
+            continue;
+        if(g.isColMajor || g.batch_count != 1)
+            MIOPEN_THROW(miopenStatusInternalError, "RNN GEMM does not match the weight layout");
+
+        if(weights(op.c))
+        {
+            // C^T = op(B)^T * op(A)^T
+            const bool transA = g.transA;
+            std::swap(op.a, op.b);
+            std::swap(g.m, g.n);
+            std::swap(g.lda, g.ldb);
+            std::swap(g.strideA, g.strideB);
+            g.transA = !g.transB;
+            g.transB = !transA;
+            bool trans = false;
+            PackWeightMatrix(layout, op.c, trans, g.ldc);
+        }
+        if(weights(op.a))
+            PackWeightMatrix(layout, op.a, g.transA, g.lda);
+        if(weights(op.b))
+            PackWeightMatrix(layout, op.b, g.transB, g.ldb);
+    }
+}
+
+} // namespace
+
+RNNPlan RNNPlan::Build(const RNNPlanShape& shape)
+{
+    RNNPlanBuilder builder(shape);
+    switch(shape.pass)
+    {
+    case RNNPlanShape::forward_inference: builder.EmitForwardInference(); break;
+    case RNNPlanShape::forward_training: builder.EmitForwardTraining(); break;
+    case RNNPlanShape::backward_data: builder.EmitBackwardData(); break;
+    case RNNPlanShape::backward_weights: builder.EmitBackwardWeights(); break;
+    }
+
+    RNNPlan plan;
+    plan.ops = std::move(builder.ops);
+    if(shape.weight_layout == miopenRNNWeightsPacked)
+        PackWeights(shape, plan.ops);
+    return plan;
+}
+
+bool operator==(const RNNPlanShape& a, const RNNPlanShape& b)
+{
+    return a.pass == b.pass && a.rnn_mode == b.rnn_mode && a.input_mode == b.input_mode &&
+           a.dir_mode == b.dir_mode && a.bias_mode == b.bias_mode && a.n_layers == b.n_layers &&
+           a.hidden_tensors == b.hidden_tensors && a.workspace_scale == b.workspace_scale &&
+           a.weight_layout == b.weight_layout && a.data_type == b.data_type && a.in_h == b.in_h &&
+           a.hy_d == b.hy_d && a.hy_n == b.hy_n && a.hy_h == b.hy_h && a.out_h == b.out_h &&
+           a.workspace_elements == b.workspace_elements &&
+           a.reserve_elements == b.reserve_elements && a.dw_elements == b.dw_elements &&
+           a.given == b.given && a.batches == b.batches;
+}
+
+std::shared_ptr<const RNNPlan> RNNPlanCache::Get(const RNNPlanShape& shape)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(
+        plans.begin(), plans.end(), [&](const auto& entry) { return entry.first == shape; });
+    if(it != plans.end())
+    {
+        std::rotate(plans.begin(), it, it + 1);
+        return plans.front().second;
+    }
+
+    auto plan         = std::make_shared<RNNPlan>(RNNPlan::Build(shape));
+    const auto queues = RNNQueueCount();
+    if(queues > 1)
+        plan->schedule =
+            std::make_shared<const RNNSchedule>(RNNSchedule::Build(*plan, shape, queues));
+    MIOPEN_LOG_I2("RNN plan for " << shape.SeqLen() << " time steps: " << plan->ops.size()
+                                  << " operations over " << queues << " queues");
+    if(plans.size() == capacity)
+        plans.pop_back();
+    plans.emplace(plans.begin(), shape, plan);
+    return plan;
+}
+
+std::size_t RNNPlanCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return plans.size();
+}
+
+} // namespace miopen
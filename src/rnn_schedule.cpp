@@ -0,0 +1,495 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn_schedule.hpp>
+#include <miopen/env.hpp>
+#include <miopen/errors.hpp>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <queue>
+#include <tuple>
+
+namespace miopen {
+
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_RNN_QUEUES)
+
+namespace {
+
+// Elements start + r * stride + [0, width) of a buffer, for r in [0, rows)
+struct Footprint
+{
+    RNNPlan::Buffer buffer;
+    std::size_t start;
+    std::size_t rows;
+    std::size_t stride;
+    std::size_t width;
+    bool write;
+
+    std::size_t End() const { return start + (rows - 1) * stride + width; }
+};
+
+Footprint TensorFootprint(const RNNPlan::Operand& o, bool write)
+{
+    const auto& lens    = o.desc.GetLengths();
+    const auto& strides = o.desc.GetStrides();
+    const std::size_t n = lens.size();
+
+    // Rows along the second innermost dimension if every outer one is 1, else one long row
+    std::size_t inner = 1;
+    std::size_t span  = 1;
+    for(std::size_t d = 0; d < n; d++)
+    {
+        span += (lens[d] - 1) * strides[d];
+        if(d + 1 == n)
+            inner += (lens[d] - 1) * strides[d];
+    }
+    const bool stacked =
+        n > 1 && std::all_of(lens.begin(), lens.end() - 2, [](std::size_t l) { return l == 1; });
+    if(stacked && lens[n - 2] > 1)
+        return {o.buffer, o.offset, lens[n - 2], strides[n - 2], inner, write};
+    return {o.buffer, o.offset, 1, span, span, write};
+}
+
+Footprint MatrixFootprint(const RNNPlan::Operand& o,
+                          int rows,
+                          int columns,
+                          int ld,
+                          int batch_count,
+                          long long int batch_stride,
+                          bool write)
+{
+    if(batch_count > 1)
+    {
+        const std::size_t span = (batch_count - 1) * batch_stride + (rows - 1) * ld + columns;
+        return {o.buffer, o.offset, 1, span, span, write};
+    }
+    return {o.buffer, o.offset, std::size_t(rows), std::size_t(ld), std::size_t(columns), write};
+}
+
+std::vector<Footprint> Accesses(const RNNPlan::Op& op)
+{
+    switch(op.kind)
+    {
+    case RNNPlan::set: return {TensorFootprint(op.c, true)};
+    case RNNPlan::gemm:
+    {
+        // Stored rows and columns of each matrix
+        const auto& g    = op.gemm_desc;
+        const bool row_a = g.transA == g.isColMajor;
+        const bool row_b = g.transB == g.isColMajor;
+        const bool row_c = !g.isColMajor;
+        return {MatrixFootprint(op.a,
+                                row_a ? g.m : g.k,
+                                row_a ? g.k : g.m,
+                                g.lda,
+                                g.batch_count,
+                                g.strideA,
+                                false),
+                MatrixFootprint(op.b,
+                                row_b ? g.k : g.n,
+                                row_b ? g.n : g.k,
+                                g.ldb,
+                                g.batch_count,
+                                g.strideB,
+                                false),
+                MatrixFootprint(op.c,
+                                row_c ? g.m : g.n,
+                                row_c ? g.n : g.m,
+                                g.ldc,
+                                g.batch_count,
+                                g.strideC,
+                                true)};
+    }
+    case RNNPlan::tensor_op:
+        return {TensorFootprint(op.a, false),
+                TensorFootprint(op.b, false),
+                TensorFootprint(op.c, true)};
+    case RNNPlan::copy:
+    case RNNPlan::activation_forward:
+        return {TensorFootprint(op.a, false), TensorFootprint(op.c, true)};
+    case RNNPlan::activation_backward:
+        return {TensorFootprint(op.a, false),
+                TensorFootprint(op.b, false),
+                TensorFootprint(op.c, false),
+                TensorFootprint(op.d, true)};
+    }
+    MIOPEN_THROW(miopenStatusInternalError, "Unknown RNN plan operation");
+}
+
+bool Overlap(const Footprint& f, const Footprint& g)
+{
+    if(f.buffer != g.buffer || f.End() <= g.start || g.End() <= f.start)
+        return false;
+
+    // Rows of one pitch only meet where both their rows and their columns do
+    const std::size_t pitch = f.rows > 1 ? f.stride : g.stride;
+    auto fits               = [&](const Footprint& p) {
+        return (p.rows == 1 || p.stride == pitch) && p.start % pitch + p.width <= pitch;
+    };
+    if(!fits(f) || !fits(g))
+        return true;
+    const std::size_t fc = f.start % pitch;
+    const std::size_t gc = g.start % pitch;
+    const std::size_t fr = f.start / pitch;
+    const std::size_t gr = g.start / pitch;
+    return fc < gc + g.width && gc < fc + f.width && fr < gr + g.rows && gr < fr + f.rows;
+}
+
+bool Conflict(const Footprint& f, const std::vector<Footprint>& b)
+{
+    return std::any_of(b.begin(), b.end(), [&](const Footprint& g) {
+        return (f.write || g.write) && Overlap(f, g);
+    });
+}
+
+bool IsSequence(RNNPlan::Buffer b)
+{
+    return b == RNNPlan::x || b == RNNPlan::y || b == RNNPlan::dx || b == RNNPlan::dy ||
+           b == RNNPlan::workSpace || b == RNNPlan::reserveSpace;
+}
+
+// The operands an operation uses
+template <class Op>
+auto Operands(Op& op)
+{
+    std::vector<decltype(&op.a)> result;
+    for(auto* o : {&op.a, &op.b, &op.c, &op.d})
+    {
+        if(o->buffer != RNNPlan::buffer_count)
+            result.push_back(o);
+    }
+    return result;
+}
+
+// Rows of the operation's output that can run as separate operations, 0 if none
+std::size_t SplitRows(const RNNPlan::Op& op)
+{
+    if(op.kind == RNNPlan::gemm)
+    {
+        const auto& g = op.gemm_desc;
+        return g.isColMajor || g.batch_count != 1 ? 0 : g.m;
+    }
+    const auto& out     = op.kind == RNNPlan::activation_backward ? op.d.desc : op.c.desc;
+    const std::size_t n = out.GetLengths().size();
+    if(n < 2)
+        return 0;
+    const std::size_t rows = out.GetLengths()[n - 2];
+    for(const auto* o : Operands(op))
+    {
+        const auto& lens = o->desc.GetLengths();
+        if(lens.size() != n || (lens[n - 2] != rows && lens[n - 2] != 1) ||
+           !std::all_of(lens.begin(), lens.end() - 2, [](std::size_t l) { return l == 1; }))
+            return 0;
+    }
+    return rows;
+}
+
+// Rows [first, first + count) of an operation whose output has `rows` rows
+RNNPlan::Op
+SliceRows(const RNNPlan::Op& op, std::size_t rows, std::size_t first, std::size_t count)
+{
+    auto slice = op;
+    if(op.kind == RNNPlan::gemm)
+    {
+        auto& g = slice.gemm_desc;
+        g.m     = count;
+        slice.a.offset += first * (g.transA ? 1 : g.lda);
+        slice.c.offset += first * g.ldc;
+        return slice;
+    }
+    for(auto* o : Operands(slice))
+    {
+        std::vector<std::size_t> lens(o->desc.GetLengths().begin(), o->desc.GetLengths().end());
+        std::vector<std::size_t> strides(o->desc.GetStrides().begin(), o->desc.GetStrides().end());
+        const std::size_t d = lens.size() - 2;
+        if(lens[d] != rows)
+            continue;
+        lens[d] = count;
+        o->offset += first * strides[d];
+        o->desc = TensorDescriptor(o->desc.GetType(), lens, strides);
+    }
+    return slice;
+}
+
+} // namespace
+
+RNNPlan SplitTimeSteps(const RNNPlan& plan, const RNNPlanShape& shape)
+{
+    // First row of every time step, and the end of the last
+    std::vector<std::size_t> step_rows(1, 0);
+    for(int batch : shape.batches)
+        step_rows.push_back(step_rows.back() + batch);
+    const std::size_t batch_n = step_rows.back();
+
+    RNNPlan split;
+    for(const auto& op : plan.ops)
+    {
+        const auto& out         = op.kind == RNNPlan::activation_backward ? op.d : op.c;
+        const std::size_t rows  = SplitRows(op);
+        const std::size_t pitch = op.kind == RNNPlan::gemm
+                                      ? op.gemm_desc.ldc
+                                      : out.desc.GetStrides()[out.desc.GetStrides().size() - 2];
+        // Sequence buffers hold blocks of batch_n rows, one block per layer
+        const std::size_t first = rows > 1 ? (out.offset / pitch) % batch_n : 0;
+        if(rows < 2 || !IsSequence(out.buffer) || first + rows > batch_n)
+        {
+            split.ops.push_back(op);
+            continue;
+        }
+        for(std::size_t t = 0; t + 1 < step_rows.size(); t++)
+        {
+            const std::size_t begin = std::max(first, step_rows[t]);
+            const std::size_t end   = std::min(first + rows, step_rows[t + 1]);
+            if(begin < end)
+                split.ops.push_back(SliceRows(op, rows, begin - first, end - begin));
+        }
+    }
+    return split;
+}
+
+std::vector<std::vector<std::size_t>> RNNPlanDependencies(const RNNPlan& plan)
+{
+    std::vector<std::vector<Footprint>> accesses;
+    accesses.reserve(plan.ops.size());
+    std::array<std::size_t, RNNPlan::buffer_count> extent{};
+    for(const auto& op : plan.ops)
+    {
+        accesses.push_back(Accesses(op));
+        for(const auto& f : accesses.back())
+            extent[f.buffer] = std::max(extent[f.buffer], f.End());
+    }
+
+    // Every buffer is cut into at most `bins` equal ranges, each listing in order the
+    // operations that touch it, so an operation is only compared to those sharing a range.
+    const std::size_t bins = 4096;
+    std::array<std::size_t, RNNPlan::buffer_count> bin_size{};
+    std::array<std::vector<std::vector<std::size_t>>, RNNPlan::buffer_count> users;
+    for(std::size_t b = 0; b < RNNPlan::buffer_count; b++)
+    {
+        bin_size[b] = std::max<std::size_t>((extent[b] + bins - 1) / bins, 1);
+        users[b].resize((extent[b] + bin_size[b] - 1) / bin_size[b]);
+    }
+
+    // The last operation writing exactly a region. Whatever conflicts with a later access of
+    // that region before it also conflicts with it, so the edge to it implies the others:
+    // accumulations into one region, like the bias gradient, form a chain instead of a clique.
+    using region = std::tuple<RNNPlan::Buffer, std::size_t, std::size_t, std::size_t, std::size_t>;
+    std::map<region, std::size_t> last_writer;
+
+    std::vector<std::vector<std::size_t>> dependencies(plan.ops.size());
+    std::vector<std::size_t> added(plan.ops.size(), plan.ops.size());
+    for(std::size_t j = 0; j < plan.ops.size(); j++)
+    {
+        added[j] = j;
+        for(const auto& f : accesses[j])
+        {
+            const auto key  = region{f.buffer, f.start, f.rows, f.stride, f.width};
+            const auto last = last_writer.find(key);
+            std::size_t first = 0;
+            if(last != last_writer.end())
+            {
+                first = last->second;
+                if(added[first] != j)
+                {
+                    added[first] = j;
+                    dependencies[j].push_back(first);
+                }
+            }
+            for(std::size_t k = f.start / bin_size[f.buffer]; k * bin_size[f.buffer] < f.End();
+                k++)
+            {
+                auto& bin = users[f.buffer][k];
+                for(auto i = std::lower_bound(bin.begin(), bin.end(), first); i != bin.end(); ++i)
+                {
+                    if(added[*i] != j && Conflict(f, accesses[*i]))
+                    {
+                        added[*i] = j;
+                        dependencies[j].push_back(*i);
+                    }
+                }
+                if(bin.empty() || bin.back() != j)
+                    bin.push_back(j);
+            }
+        }
+        for(const auto& f : accesses[j])
+        {
+            if(f.write)
+                last_writer[region{f.buffer, f.start, f.rows, f.stride, f.width}] = j;
+        }
+        std::sort(dependencies[j].begin(), dependencies[j].end());
+    }
+    return dependencies;
+}
+
+double RNNSchedule::Cost(const RNNPlan::Op& op)
+{
+    // Elements a kernel launch is worth
+    const double launch = 4096;
+    if(op.kind == RNNPlan::gemm)
+    {
+        const auto& g = op.gemm_desc;
+        return launch + 2.0 * g.m * g.n * g.k * g.batch_count;
+    }
+    const auto& out = op.kind == RNNPlan::activation_backward ? op.d.desc : op.c.desc;
+    return launch + out.GetElementSize();
+}
+
+RNNSchedule RNNSchedule::Build(const RNNPlan& plan, const RNNPlanShape& shape, std::size_t queues)
+{
+    if(queues == 0)
+        MIOPEN_THROW(miopenStatusBadParm, "An RNN schedule needs at least one queue");
+
+    RNNSchedule schedule;
+    schedule.plan         = SplitTimeSteps(plan, shape);
+    schedule.dependencies = RNNPlanDependencies(schedule.plan);
+    schedule.queue_count  = queues;
+
+    const auto& deps    = schedule.dependencies;
+    const std::size_t n = deps.size();
+    std::vector<double> cost(n);
+    std::vector<std::size_t> pending(n);
+    std::vector<std::vector<std::size_t>> successors(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        cost[i]    = Cost(schedule.plan.ops[i]);
+        pending[i] = deps[i].size();
+        for(auto d : deps[i])
+            successors[d].push_back(i);
+    }
+
+    // Longest chain of costs from every operation to the end, dependencies precede their users
+    std::vector<double> rank(n);
+    for(std::size_t i = n; i-- > 0;)
+    {
+        rank[i] = cost[i];
+        for(auto s : successors[i])
+            rank[i] = std::max(rank[i], cost[i] + rank[s]);
+    }
+
+    auto lower = [&](std::size_t a, std::size_t b) {
+        return rank[a] < rank[b] || (rank[a] == rank[b] && a > b);
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(lower)> ready(lower);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        if(pending[i] == 0)
+            ready.push(i);
+    }
+
+    // A wait on another queue costs about a launch
+    const double wait = 4096;
+    std::vector<double> finish(n), queue_free(queues, 0);
+    std::vector<std::size_t> queue_of(n), position(n);
+    std::vector<std::vector<std::size_t>> queue_ops(queues);
+    // waited[q][p]: how many operations of queue p queue q already waits for
+    std::vector<std::vector<std::size_t>> waited(queues, std::vector<std::size_t>(queues, 0));
+    while(!ready.empty())
+    {
+        const std::size_t i = ready.top();
+        ready.pop();
+
+        // The queue where it starts first, the queue of its latest dependency on a tie
+        auto start_on = [&](std::size_t q) {
+            double start = queue_free[q];
+            for(auto d : deps[i])
+                start = std::max(start, finish[d] + (queue_of[d] == q ? 0 : wait));
+            return start;
+        };
+        std::size_t best = 0;
+        double latest    = -1;
+        for(auto d : deps[i])
+        {
+            if(finish[d] > latest)
+            {
+                latest = finish[d];
+                best   = queue_of[d];
+            }
+        }
+        double best_start = start_on(best);
+        for(std::size_t q = 0; q < queues; q++)
+        {
+            const double start = start_on(q);
+            if(start < best_start)
+            {
+                best       = q;
+                best_start = start;
+            }
+        }
+
+        // Queues run in order, so the last dependency on each other queue covers the rest
+        Step step{i, best, {}};
+        std::vector<std::size_t> last(queues, 0);
+        for(auto d : deps[i])
+            last[queue_of[d]] = std::max(last[queue_of[d]], position[d] + 1);
+        for(std::size_t p = 0; p < queues; p++)
+        {
+            if(p == best || last[p] <= waited[best][p])
+                continue;
+            step.waits.push_back(queue_ops[p][last[p] - 1]);
+            waited[best][p] = last[p];
+        }
+
+        finish[i]         = best_start + cost[i];
+        queue_free[best]  = finish[i];
+        queue_of[i]       = best;
+        position[i]       = queue_ops[best].size();
+        schedule.makespan = std::max(schedule.makespan, finish[i]);
+        queue_ops[best].push_back(i);
+        schedule.steps.push_back(std::move(step));
+
+        for(auto s : successors[i])
+        {
+            if(--pending[s] == 0)
+                ready.push(s);
+        }
+    }
+    return schedule;
+}
+
+void RNNSchedule::Dispatch(RNNScheduleExecutor& executor) const
+{
+    for(const auto& step : steps)
+    {
+        for(auto op : step.waits)
+            executor.Wait(step.queue, op);
+        executor.Enqueue(step.queue, step.op);
+    }
+}
+
+std::size_t RNNQueueCount()
+{
+#if MIOPEN_BACKEND_HIP
+    return 1;
+#else
+    const int queues = miopen::Value(MIOPEN_RNN_QUEUES{});
+    if(queues > 0)
+        return queues;
+    return MIOPEN_BACKEND_CPU ? 4 : 1;
+#endif
+}
+
+} // namespace miopen
@@ -0,0 +1,62 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn_weights.hpp>
+#include <miopen/rnn_offsets.hpp>
+
+namespace miopen {
+
+RNNWeightLayout::RNNWeightLayout(std::size_t in_h,
+                                 std::size_t hy_h,
+                                 std::size_t bi,
+                                 std::size_t n_layers,
+                                 std::size_t gates,
+                                 bool bias)
+{
+    const std::size_t wei_stride = bi * gates * hy_h;
+    const RNNOffsets offsets(in_h, hy_h, bi, n_layers, 0, 0, 0, wei_stride);
+    for(std::size_t li = 0; li < n_layers; li++)
+    {
+        const std::size_t input = li == 0 ? in_h : bi * hy_h;
+        if(input > 0)
+            blocks.push_back({offsets.InputWeights(li), wei_stride, input});
+        blocks.push_back({offsets.HiddenWeights(li), wei_stride, hy_h});
+    }
+    bias_offset = offsets.Bias(0);
+    size        = bias ? offsets.Bias(n_layers) : bias_offset;
+}
+
+const RNNWeightLayout::Block* RNNWeightLayout::Find(std::size_t offset) const
+{
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), offset, [](auto o, const Block& b) {
+        return o < b.offset;
+    });
+    if(it == blocks.begin())
+        return nullptr;
+    --it;
+    return offset < it->offset + it->rows * it->columns ? &*it : nullptr;
+}
+
+} // namespace miopen
@@ -163,13 +163,14 @@ ConvSolution ConvOclBwdWrW1x1::GetSolution(const ConvolutionContext& params) con
         int in_height         = (n_passes > 1) ? params.in_height : params.out_height;
         int in_stride         = (n_passes > 1) ? params.in_stride : params.out_stride;
         int in_channel_stride = (n_passes > 1) ? in_stride * in_height : params.out_channel_stride;
-        int in_batch_stride =
-            (n_passes > 1) ? in_channel_stride * params.n_outputs : params.out_batch_stride;
-        int out_batch_stride   = params.in_batch_stride;
-        int out_channel_stride = params.in_channel_stride;
-        int out_stride         = params.in_stride;
-        int wei_batch_stride =
-            params.n_inputs * params.n_outputs * params.kernel_size0 * params.kernel_size1;
+        std::size_t in_batch_stride = (n_passes > 1)
+                                          ? std::size_t(in_channel_stride) * params.n_outputs
+                                          : params.out_batch_stride;
+        std::size_t out_batch_stride = params.in_batch_stride;
+        int out_channel_stride       = params.in_channel_stride;
+        int out_stride               = params.in_stride;
+        std::size_t wei_batch_stride = std::size_t(params.n_inputs) * params.n_outputs *
+                                       params.kernel_size0 * params.kernel_size1;
         int wei_channel_stride     = params.n_outputs * params.kernel_size0 * params.kernel_size1;
         int max_loads_per_readunit = (out_channel_stride / read_unit) * params.batch_sz;
 
@@ -246,11 +247,11 @@ ConvSolution ConvOclBwdWrW1x1::GetSolution(const ConvolutionContext& params) con
                                                             : (out_pad_width % 2 == 0) ? 2 : 1;
         int n_grp0_size0 = 256;
         // real input strides
-        int in0_stride         = params.out_stride;
-        int in0_channel_stride = params.out_channel_stride;
-        int in0_batch_stride   = params.out_batch_stride;
-        int kernel0_stride0    = params.kernel_stride0;
-        int kernel0_stride1    = params.kernel_stride1;
+        int in0_stride               = params.out_stride;
+        int in0_channel_stride       = params.out_channel_stride;
+        std::size_t in0_batch_stride = params.out_batch_stride;
+        int kernel0_stride0          = params.kernel_stride0;
+        int kernel0_stride1          = params.kernel_stride1;
 
         const auto comp_options =
             std::string(" -DMLO_GRP_SZ0=") + std::to_string(n_grp_size0) +
@@ -31,6 +31,7 @@
 #include <miopen/handle.hpp>
 #include <miopen/legacy_exhaustive_search.hpp>
 #include <miopen/mlo_utils.hpp>
+#include <miopen/philox.hpp>
 #include <miopen/solver.hpp>
 
 #include <half.hpp>
@@ -282,11 +283,7 @@ ConvOclDirectFwdLegacyExhaustiveSearch::SearchImpl(const ConvolutionContext& par
     // allocate tem input/output buffers
     size_t bot_sz = params.bot_sz / sizeof(Tgpu);
     std::vector<Tgpu> bot_sys_buf(bot_sz);
-
-    for(int i = 0; i < bot_sz; i++)
-    {
-        bot_sys_buf[i] = static_cast<Tgpu>(rand() * (1.0 / RAND_MAX));
-    }
+    fill_uniform(bot_sys_buf.data(), bot_sz, 0.0, 1.0, random_stream{0, 0});
 
     auto bot_ocl_buf = profile_h.Write(bot_sys_buf);
 
@@ -296,17 +293,11 @@ ConvOclDirectFwdLegacyExhaustiveSearch::SearchImpl(const ConvolutionContext& par
     auto top_ocl_buf = profile_h.Write(top_sys_buf);
 
     std::vector<Tgpu> random_top_sys_buf(top_sz);
-    for(int i = 0; i < top_sz; i++)
-    {
-        random_top_sys_buf[i] = static_cast<Tgpu>(rand() * (1.0 / RAND_MAX));
-    }
+    fill_uniform(random_top_sys_buf.data(), top_sz, 0.0, 1.0, random_stream{0, 1});
 
     size_t weights_sz = params.weights_sz / sizeof(Tgpu);
     std::vector<Tgpu> wei_sys_buf(weights_sz);
-    for(int i = 0; i < weights_sz; i++)
-    {
-        wei_sys_buf[i] = static_cast<Tgpu>((rand() * (1.0 / RAND_MAX) - 0.5) * 0.001);
-    }
+    fill_uniform(wei_sys_buf.data(), weights_sz, -0.0005, 0.0005, random_stream{0, 2});
 
     auto wei_ocl_buf = profile_h.Write(wei_sys_buf);
 
@@ -317,10 +308,7 @@ ConvOclDirectFwdLegacyExhaustiveSearch::SearchImpl(const ConvolutionContext& par
     {
         size_t bias_sz = params.bias_sz / sizeof(Tgpu);
         bias_sys_buf   = std::vector<Tgpu>(bias_sz);
-        for(int i = 0; i < bias_sz; i++)
-        {
-            bias_sys_buf[i] = static_cast<Tgpu>(rand() * (1.0 / RAND_MAX));
-        }
+        fill_uniform(bias_sys_buf.data(), bias_sz, 0.0, 1.0, random_stream{0, 3});
 
         bias_ocl_buf = profile_h.Write(bias_sys_buf);
     }
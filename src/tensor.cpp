@@ -33,12 +33,13 @@
 
 namespace miopen {
 
-TensorDescriptor::TensorDescriptor() : packed(true) {}
+TensorDescriptor::TensorDescriptor() : packed(true) { this->CalculateCachedValues(); }
 
 TensorDescriptor::TensorDescriptor(miopenDataType_t t, std::initializer_list<std::size_t> plens)
     : lens(plens), packed(true), type(t)
 {
     this->CalculateStrides();
+    this->CalculateCachedValues();
 }
 
 TensorDescriptor::TensorDescriptor(miopenDataType_t t,
@@ -46,6 +47,7 @@ TensorDescriptor::TensorDescriptor(miopenDataType_t t,
                                    std::initializer_list<std::size_t> pstrides)
     : lens(plens), strides(pstrides), type(t)
 {
+    this->CalculateCachedValues();
     packed = (this->GetElementSize() == this->GetElementSpace());
 }
 
@@ -55,6 +57,7 @@ TensorDescriptor::TensorDescriptor(miopenDataType_t t, const int* plens, int siz
     if(!std::all_of(plens, plens + size, [](int x) { return x >= 0; }))
         MIOPEN_THROW("Invalid length. Length must be greater than 0.");
     this->CalculateStrides();
+    this->CalculateCachedValues();
 }
 TensorDescriptor::TensorDescriptor(miopenDataType_t t,
                                    const int* plens,
@@ -66,14 +69,18 @@ TensorDescriptor::TensorDescriptor(miopenDataType_t t,
         MIOPEN_THROW("Invalid length. Length must be greater than 0.");
     if(!std::all_of(pstrides, pstrides + size, [](int x) { return x >= 0; }))
         MIOPEN_THROW("Invalid strides. Strides must be greater than 0.");
+    this->CalculateCachedValues();
     packed = (this->GetElementSize() == this->GetElementSpace());
 }
 
 TensorDescriptor::TensorDescriptor(miopenDataType_t t,
                                    std::vector<std::size_t> lens_in,
                                    std::vector<std::size_t> strides_in)
-    : lens(std::move(lens_in)), strides(std::move(strides_in)), type(t)
+    : lens(lens_in.begin(), lens_in.end()),
+      strides(strides_in.begin(), strides_in.end()),
+      type(t)
 {
+    this->CalculateCachedValues();
     packed = (this->GetElementSize() == this->GetElementSpace());
 }
 
@@ -88,19 +95,30 @@ void TensorDescriptor::CalculateStrides()
         lens.rbegin(), lens.rend() - 1, strides.rbegin() + 1, std::multiplies<std::size_t>());
 }
 
-const std::vector<std::size_t>& TensorDescriptor::GetLengths() const { return lens; }
-const std::vector<std::size_t>& TensorDescriptor::GetStrides() const { return strides; }
-int TensorDescriptor::GetSize() const
+void TensorDescriptor::CalculateCachedValues()
 {
     assert(lens.size() == strides.size());
-    return lens.size();
+    element_size  = 1;
+    element_space = 1;
+    hash          = static_cast<std::size_t>(type);
+    auto combine  = [&](std::size_t x) { hash ^= x + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    for(std::size_t i = 0; i < lens.size(); i++)
+    {
+        element_size *= lens[i];
+        element_space += (lens[i] - 1) * strides[i];
+        combine(lens[i]);
+        combine(strides[i]);
+    }
 }
-std::size_t TensorDescriptor::GetElementSize() const
+
+const TensorDims& TensorDescriptor::GetLengths() const { return lens; }
+const TensorDims& TensorDescriptor::GetStrides() const { return strides; }
+int TensorDescriptor::GetSize() const
 {
     assert(lens.size() == strides.size());
-    return std::accumulate(
-        lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+    return lens.size();
 }
+std::size_t TensorDescriptor::GetElementSize() const { return element_size; }
 miopenDataType_t TensorDescriptor::GetType() const { return this->type; }
 
 std::size_t TensorDescriptor::GetIndex(std::initializer_list<int> l) const
@@ -109,18 +127,7 @@ std::size_t TensorDescriptor::GetIndex(std::initializer_list<int> l) const
     return std::inner_product(l.begin(), l.end(), strides.begin(), std::size_t{0});
 }
 
-std::size_t TensorDescriptor::GetElementSpace() const
-{
-    std::vector<std::size_t> maxIndices(lens.size());
-    std::transform(lens.begin(),
-                   lens.end(),
-                   std::vector<std::size_t>(lens.size(), 1).begin(),
-                   maxIndices.begin(),
-                   std::minus<std::size_t>());
-    return std::inner_product(
-               maxIndices.begin(), maxIndices.end(), strides.begin(), std::size_t{0}) +
-           1;
-}
+std::size_t TensorDescriptor::GetElementSpace() const { return element_space; }
 
 std::size_t TensorDescriptor::GetNumBytes() const
 {
@@ -132,15 +139,18 @@ std::size_t TensorDescriptor::GetNumBytes() const
     case miopenInt32:
     case miopenFloat: typesize = 4; break;
     }
-    return typesize * this->GetElementSpace();
+    return typesize * element_space;
 }
 
+std::size_t TensorDescriptor::GetHash() const { return hash; }
+
 bool TensorDescriptor::IsPacked() const { return this->packed; }
 
 bool TensorDescriptor::operator==(const TensorDescriptor& rhs) const
 {
     assert(this->lens.size() == rhs.strides.size());
-    return this->type == rhs.type && this->lens == rhs.lens && this->strides == rhs.strides;
+    return this->hash == rhs.hash && this->type == rhs.type && this->lens == rhs.lens &&
+           this->strides == rhs.strides;
 }
 
 bool TensorDescriptor::operator!=(const TensorDescriptor& rhs) const { return !(*this == rhs); }
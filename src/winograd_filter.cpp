@@ -0,0 +1,207 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/errors.hpp>
+#include <miopen/winograd_filter.hpp>
+
+#include <vector>
+
+namespace miopen {
+
+namespace {
+
+struct WinogradMatrices
+{
+    const float* bt; // alpha x alpha
+    const float* g;  // alpha x 3
+    const float* at; // tile x alpha
+};
+
+// clang-format off
+const float bt_2[] = {1,  0, -1,  0,
+                      0,  1,  1,  0,
+                      0, -1,  1,  0,
+                      0,  1,  0, -1};
+const float g_2[]  = {1,    0,   0,
+                      0.5,  0.5, 0.5,
+                      0.5, -0.5, 0.5,
+                      0,    0,   1};
+const float at_2[] = {1, 1,  1,  0,
+                      0, 1, -1, -1};
+
+const float bt_4[] = {4,  0, -5,  0, 1, 0,
+                      0, -4, -4,  1, 1, 0,
+                      0,  4, -4, -1, 1, 0,
+                      0, -2, -1,  2, 1, 0,
+                      0,  2, -1, -2, 1, 0,
+                      0,  4,  0, -5, 0, 1};
+const float g_4[]  = { 1.f / 4,   0,        0,
+                      -1.f / 6,  -1.f / 6, -1.f / 6,
+                      -1.f / 6,   1.f / 6, -1.f / 6,
+                       1.f / 24,  1.f / 12, 1.f / 6,
+                       1.f / 24, -1.f / 12, 1.f / 6,
+                       0,         0,        1};
+const float at_4[] = {1, 1,  1, 1,  1, 0,
+                      0, 1, -1, 2, -2, 0,
+                      0, 1,  1, 4,  4, 0,
+                      0, 1, -1, 8, -8, 1};
+// clang-format on
+
+const WinogradMatrices& GetWinogradMatrices(int tile)
+{
+    static const WinogradMatrices f2{bt_2, g_2, at_2};
+    static const WinogradMatrices f4{bt_4, g_4, at_4};
+    if(tile == 2)
+        return f2;
+    if(tile == 4)
+        return f4;
+    MIOPEN_THROW(miopenStatusBadParm, "Winograd tile must be 2 or 4");
+}
+
+// out = l in l^T, l is rows x n and in n x n
+void Sandwich(const float* l, int rows, int n, const float* in, float* out)
+{
+    double tmp[6 * 6];
+    for(int i = 0; i < rows; i++)
+        for(int j = 0; j < n; j++)
+        {
+            double sum = 0;
+            for(int p = 0; p < n; p++)
+                sum += double(l[i * n + p]) * in[p * n + j];
+            tmp[i * n + j] = sum;
+        }
+    for(int i = 0; i < rows; i++)
+        for(int j = 0; j < rows; j++)
+        {
+            double sum = 0;
+            for(int p = 0; p < n; p++)
+                sum += tmp[i * n + p] * l[j * n + p];
+            out[i * rows + j] = static_cast<float>(sum);
+        }
+}
+
+} // namespace
+
+void WinogradFilterTransform(int tile, const float* g, float* u)
+{
+    Sandwich(GetWinogradMatrices(tile).g, GetWinogradAlpha(tile), 3, g, u);
+}
+
+void WinogradInputTransform(int tile, const float* d, float* v)
+{
+    const int alpha = GetWinogradAlpha(tile);
+    Sandwich(GetWinogradMatrices(tile).bt, alpha, alpha, d, v);
+}
+
+void WinogradOutputTransform(int tile, const float* m, float* y)
+{
+    Sandwich(GetWinogradMatrices(tile).at, tile, GetWinogradAlpha(tile), m, y);
+}
+
+void WinogradFilterTransform(int tile, std::size_t k, std::size_t c, const float* w, float* u)
+{
+    const std::size_t alpha = GetWinogradAlpha(tile);
+    float transformed[6 * 6];
+    for(std::size_t i = 0; i < k * c; i++)
+    {
+        WinogradFilterTransform(tile, w + i * 9, transformed);
+        for(std::size_t e = 0; e < alpha * alpha; e++)
+            u[e * k * c + i] = transformed[e];
+    }
+}
+
+void WinogradForward(int tile,
+                     std::size_t c,
+                     std::size_t h,
+                     std::size_t w,
+                     std::size_t k,
+                     int pad_h,
+                     int pad_w,
+                     const float* x,
+                     const float* u,
+                     float* y)
+{
+    const int alpha           = GetWinogradAlpha(tile);
+    const std::size_t elems   = alpha * alpha;
+    const std::size_t out_h   = h + 2 * pad_h - 2;
+    const std::size_t out_w   = w + 2 * pad_w - 2;
+    const std::size_t tiles_h = (out_h + tile - 1) / tile;
+    const std::size_t tiles_w = (out_w + tile - 1) / tile;
+    const std::size_t tiles   = tiles_h * tiles_w;
+
+    // Input tiles [element][c][tile]
+    std::vector<float> v(elems * c * tiles);
+    float d[6 * 6];
+    float transformed[6 * 6];
+    for(std::size_t ci = 0; ci < c; ci++)
+        for(std::size_t t = 0; t < tiles; t++)
+        {
+            const long y0 = long(t / tiles_w) * tile - pad_h;
+            const long x0 = long(t % tiles_w) * tile - pad_w;
+            for(int i = 0; i < alpha; i++)
+                for(int j = 0; j < alpha; j++)
+                {
+                    const long yi = y0 + i;
+                    const long xj = x0 + j;
+                    d[i * alpha + j] = yi < 0 || yi >= long(h) || xj < 0 || xj >= long(w)
+                                           ? 0
+                                           : x[(ci * h + yi) * w + xj];
+                }
+            WinogradInputTransform(tile, d, transformed);
+            for(std::size_t e = 0; e < elems; e++)
+                v[(e * c + ci) * tiles + t] = transformed[e];
+        }
+
+    // A k x c by c x tiles product for every element
+    std::vector<float> m(elems * k * tiles);
+    for(std::size_t e = 0; e < elems; e++)
+        for(std::size_t ki = 0; ki < k; ki++)
+        {
+            float* row = &m[(e * k + ki) * tiles];
+            for(std::size_t ci = 0; ci < c; ci++)
+            {
+                const float uv  = u[(e * k + ki) * c + ci];
+                const float* vr = &v[(e * c + ci) * tiles];
+                for(std::size_t t = 0; t < tiles; t++)
+                    row[t] += uv * vr[t];
+            }
+        }
+
+    float outputs[4 * 4];
+    for(std::size_t ki = 0; ki < k; ki++)
+        for(std::size_t t = 0; t < tiles; t++)
+        {
+            for(std::size_t e = 0; e < elems; e++)
+                transformed[e] = m[(e * k + ki) * tiles + t];
+            WinogradOutputTransform(tile, transformed, outputs);
+            const std::size_t y0 = t / tiles_w * tile;
+            const std::size_t x0 = t % tiles_w * tile;
+            for(std::size_t i = 0; i < std::size_t(tile) && y0 + i < out_h; i++)
+                for(std::size_t j = 0; j < std::size_t(tile) && x0 + j < out_w; j++)
+                    y[(ki * out_h + y0 + i) * out_w + x0 + j] = outputs[i * tile + j];
+        }
+}
+
+} // namespace miopen
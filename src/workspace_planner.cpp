@@ -0,0 +1,249 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/workspace_planner.hpp>
+#include <miopen/errors.hpp>
+#include <miopen/logger.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace miopen {
+
+std::vector<PerfField> RankWithinWorkspace(std::vector<PerfField> perf,
+                                           std::size_t workspace_limit)
+{
+    perf.erase(std::remove_if(perf.begin(),
+                              perf.end(),
+                              [&](const PerfField& p) { return p.workspace > workspace_limit; }),
+               perf.end());
+    std::stable_sort(perf.begin(), perf.end(), [](const PerfField& a, const PerfField& b) {
+        return a.time < b.time || (a.time == b.time && a.workspace < b.workspace);
+    });
+
+    // Every kept result needs less workspace than all faster ones
+    std::vector<PerfField> ranked;
+    for(auto&& p : perf)
+    {
+        if(ranked.empty() || p.workspace < ranked.back().workspace)
+            ranked.push_back(std::move(p));
+    }
+    return ranked;
+}
+
+static bool Overlap(const WorkspaceLayer& a, const WorkspaceLayer& b)
+{
+    return a.first_step <= b.last_step && b.first_step <= a.last_step;
+}
+
+std::vector<std::size_t> AssignWorkspaceOffsets(const std::vector<WorkspaceLayer>& layers,
+                                                const std::vector<std::size_t>& sizes,
+                                                std::size_t alignment,
+                                                std::size_t& workspace_size)
+{
+    assert(layers.size() == sizes.size());
+    alignment = std::max<std::size_t>(alignment, 1);
+
+    // Largest first, then by schedule; each layer takes the lowest aligned gap left
+    // by the already placed layers it is live together with.
+    std::vector<std::size_t> order(layers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return sizes[a] > sizes[b] ||
+               (sizes[a] == sizes[b] && layers[a].first_step < layers[b].first_step);
+    });
+
+    std::vector<std::size_t> offsets(layers.size(), 0);
+    std::vector<std::size_t> placed;
+    std::vector<std::pair<std::size_t, std::size_t>> busy;
+    workspace_size = 0;
+    for(const auto i : order)
+    {
+        if(sizes[i] == 0)
+            continue;
+
+        busy.clear();
+        for(const auto j : placed)
+        {
+            if(Overlap(layers[i], layers[j]))
+                busy.emplace_back(offsets[j], offsets[j] + sizes[j]);
+        }
+        std::sort(busy.begin(), busy.end());
+
+        std::size_t offset = 0;
+        for(const auto& range : busy)
+        {
+            if(offset + sizes[i] <= range.first)
+                break;
+            if(range.second > offset)
+                offset = (range.second + alignment - 1) / alignment * alignment;
+        }
+
+        offsets[i]     = offset;
+        workspace_size = std::max(workspace_size, offset + sizes[i]);
+        placed.push_back(i);
+    }
+    return offsets;
+}
+
+namespace {
+
+struct PlanState
+{
+    const std::vector<WorkspaceLayer>& layers;
+    const std::vector<std::vector<PerfField>>& ranked;
+    std::size_t alignment;
+    std::vector<std::size_t> choice;
+
+    std::size_t WorkspaceSize() const
+    {
+        std::size_t size = 0;
+        AssignWorkspaceOffsets(layers, Sizes(), alignment, size);
+        return size;
+    }
+
+    std::vector<std::size_t> Sizes() const
+    {
+        std::vector<std::size_t> sizes(layers.size());
+        for(std::size_t i = 0; i < layers.size(); i++)
+            sizes[i] = Chosen(i).workspace;
+        return sizes;
+    }
+
+    const PerfField& Chosen(std::size_t i) const { return ranked[i][choice[i]]; }
+
+    std::size_t WorkspaceSizeWith(std::size_t layer, std::size_t candidate)
+    {
+        const auto old  = choice[layer];
+        choice[layer]   = candidate;
+        const auto size = WorkspaceSize();
+        choice[layer]   = old;
+        return size;
+    }
+};
+
+} // namespace
+
+WorkspacePlan PlanWorkspace(const std::vector<WorkspaceLayer>& layers,
+                            std::size_t budget,
+                            std::size_t alignment)
+{
+    std::vector<std::vector<PerfField>> ranked;
+    for(std::size_t i = 0; i < layers.size(); i++)
+    {
+        ranked.push_back(RankWithinWorkspace(layers[i].perf, budget));
+        if(ranked.back().empty())
+            MIOPEN_THROW(miopenStatusBadParm,
+                         "Layer " + std::to_string(i) + " has no algorithm within the budget");
+    }
+
+    PlanState state{layers, ranked, alignment, std::vector<std::size_t>(layers.size(), 0)};
+
+    // Start from the fastest algorithms and give up time for workspace where a byte of the
+    // shared workspace is cheapest, until it fits into the budget.
+    for(auto size = state.WorkspaceSize(); size > budget; size = state.WorkspaceSize())
+    {
+        std::size_t best_layer     = layers.size();
+        std::size_t best_candidate = 0;
+        double best_rate           = 0;
+        for(std::size_t i = 0; i < layers.size(); i++)
+        {
+            for(auto j = state.choice[i] + 1; j < ranked[i].size(); j++)
+            {
+                const auto saved = size - std::min(size, state.WorkspaceSizeWith(i, j));
+                if(saved == 0)
+                    continue;
+                const double cost = std::max(ranked[i][j].time - state.Chosen(i).time, 1e-6f);
+                const double rate = saved / cost;
+                if(rate > best_rate)
+                {
+                    best_layer     = i;
+                    best_candidate = j;
+                    best_rate      = rate;
+                }
+            }
+        }
+
+        // No single change shrinks the buffer yet: shrink the layer that holds its top
+        // end at the smallest cost, which lowers the top eventually.
+        if(best_layer == layers.size())
+        {
+            std::size_t top = 0;
+            const auto offsets = AssignWorkspaceOffsets(layers, state.Sizes(), alignment, top);
+            float best_cost    = 0;
+            for(std::size_t i = 0; i < layers.size(); i++)
+            {
+                if(offsets[i] + state.Chosen(i).workspace != top ||
+                   state.choice[i] + 1 == ranked[i].size())
+                    continue;
+                const float cost = ranked[i][state.choice[i] + 1].time - state.Chosen(i).time;
+                if(best_layer == layers.size() || cost < best_cost)
+                {
+                    best_layer     = i;
+                    best_candidate = state.choice[i] + 1;
+                    best_cost      = cost;
+                }
+            }
+        }
+
+        if(best_layer == layers.size())
+            MIOPEN_THROW(miopenStatusBadParm,
+                         "Workspace of " + std::to_string(size) + " bytes exceeds the budget of " +
+                             std::to_string(budget) + " bytes");
+        state.choice[best_layer] = best_candidate;
+    }
+
+    // Take back what the greedy steps gave up but still fits
+    for(bool changed = true; changed;)
+    {
+        changed = false;
+        for(std::size_t i = 0; i < layers.size(); i++)
+        {
+            for(std::size_t j = 0; j < state.choice[i]; j++)
+            {
+                if(state.WorkspaceSizeWith(i, j) <= budget)
+                {
+                    state.choice[i] = j;
+                    changed         = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    WorkspacePlan plan;
+    plan.offsets = AssignWorkspaceOffsets(layers, state.Sizes(), alignment, plan.workspace_size);
+    for(std::size_t i = 0; i < layers.size(); i++)
+    {
+        plan.algorithms.push_back(state.Chosen(i));
+        plan.time += state.Chosen(i).time;
+        MIOPEN_LOG_I2("Layer " << i << ": " << state.Chosen(i).name << ", offset "
+                               << plan.offsets[i]);
+    }
+    return plan;
+}
+
+} // namespace miopen
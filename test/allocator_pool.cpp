@@ -0,0 +1,199 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/allocator_pool.hpp>
+#include "test.hpp"
+
+#include <cstdlib>
+#include <set>
+
+// Host allocator which counts the calls it receives.
+struct host_memory
+{
+    std::size_t allocations   = 0;
+    std::size_t deallocations = 0;
+    bool fail                 = false;
+    std::set<void*> live;
+
+    static void* allocate(void* ctx, std::size_t n)
+    {
+        auto self = static_cast<host_memory*>(ctx);
+        if(self->fail)
+            return nullptr;
+        self->allocations++;
+        auto mem = std::malloc(n == 0 ? 1 : n);
+        self->live.insert(mem);
+        return mem;
+    }
+
+    static void deallocate(void* ctx, void* mem)
+    {
+        auto self = static_cast<host_memory*>(ctx);
+        self->deallocations++;
+        CHECK(self->live.erase(mem) == 1);
+        std::free(mem);
+    }
+
+    miopen::Allocator get() { return miopen::Allocator{&allocate, &deallocate, this}; }
+};
+
+void check_size_classes()
+{
+    using miopen::AllocatorPool;
+    CHECK(AllocatorPool::SizeClass(1) == 256);
+    CHECK(AllocatorPool::SizeClass(256) == 256);
+    CHECK(AllocatorPool::SizeClass(257) == 320);
+    CHECK(AllocatorPool::SizeClass(1024) == 1024);
+    CHECK(AllocatorPool::SizeClass(1025) == 1280);
+    CHECK(AllocatorPool::SizeClass(1536) == 1536);
+    CHECK(AllocatorPool::SizeClass(1537) == 1792);
+    for(std::size_t n = 1; n < (1 << 20); n = n * 3 + 1)
+    {
+        auto c = AllocatorPool::SizeClass(n);
+        CHECK(c >= n);
+        CHECK(n <= 256 || c <= n + n / 4);
+    }
+}
+
+void check_reuse()
+{
+    host_memory host;
+    {
+        auto pool = std::make_shared<miopen::AllocatorPool>(host.get(), 1 << 20);
+        auto alloc = pool->GetAllocator();
+        void* first = nullptr;
+        {
+            auto a = alloc(1000);
+            first  = a.get();
+        }
+        CHECK(host.allocations == 1);
+        CHECK(host.deallocations == 0);
+        {
+            // Same size class is served from the cache
+            auto b = alloc(1010);
+            CHECK(b.get() == first);
+            auto c = alloc(1000);
+            CHECK(c.get() != first);
+        }
+        auto stats = pool->GetStats();
+        CHECK(host.allocations == 2);
+        CHECK(stats.hits == 1);
+        CHECK(stats.misses == 2);
+        CHECK(stats.bytes_in_use == 0);
+        CHECK(stats.bytes_cached == 2 * miopen::AllocatorPool::SizeClass(1000));
+        CHECK(stats.peak_bytes == 2 * miopen::AllocatorPool::SizeClass(1000));
+
+        pool->Trim();
+        CHECK(host.deallocations == 2);
+        CHECK(pool->GetStats().bytes_cached == 0);
+    }
+    CHECK(host.live.empty());
+}
+
+void check_limit()
+{
+    host_memory host;
+    auto pool  = std::make_shared<miopen::AllocatorPool>(host.get(), 4096);
+    auto alloc = pool->GetAllocator();
+    {
+        auto a = alloc(4096);
+        auto b = alloc(4096);
+        auto c = alloc(1024);
+        a      = nullptr;
+        b      = nullptr;
+        c      = nullptr;
+    }
+    // Only the first 4K buffer fits in the cache
+    auto stats = pool->GetStats();
+    CHECK(stats.bytes_cached == 4096);
+    CHECK(stats.releases == 2);
+    CHECK(host.live.size() == 1);
+
+    pool->SetMaxCached(0);
+    CHECK(host.live.empty());
+    {
+        auto a = alloc(4096);
+    }
+    CHECK(host.live.empty());
+}
+
+void check_lifetime()
+{
+    host_memory host;
+    {
+        miopen::Allocator::ManageDataPtr p = nullptr;
+        {
+            auto pool = std::make_shared<miopen::AllocatorPool>(host.get(), 1 << 20);
+            p         = pool->GetAllocator()(100);
+        }
+        // The buffer keeps the pool alive
+        CHECK(host.live.size() == 1);
+    }
+    // and the pool releases its cache when the last buffer goes away.
+    CHECK(host.live.empty());
+}
+
+void check_out_of_memory()
+{
+    host_memory host;
+    auto pool  = std::make_shared<miopen::AllocatorPool>(host.get(), 1 << 20);
+    auto alloc = pool->GetAllocator();
+    {
+        auto a = alloc(1 << 16);
+    }
+    CHECK(pool->GetStats().bytes_cached == (1 << 16));
+
+    // Trims the cache and retries before giving up
+    host.fail = true;
+    CHECK(throws([&] { auto b = alloc(1 << 12); }));
+    CHECK(pool->GetStats().bytes_cached == 0);
+    CHECK(host.live.empty());
+    host.fail = false;
+    auto c    = alloc(1 << 12);
+    CHECK(c != nullptr);
+}
+
+void check_zero_size()
+{
+    host_memory host;
+    auto pool  = std::make_shared<miopen::AllocatorPool>(host.get(), 1 << 20);
+    auto alloc = pool->GetAllocator();
+    {
+        auto a = alloc(0);
+    }
+    CHECK(host.live.empty());
+    CHECK(pool->GetStats().bytes_cached == 0);
+}
+
+int main()
+{
+    check_size_classes();
+    check_reuse();
+    check_limit();
+    check_lifetime();
+    check_out_of_memory();
+    check_zero_size();
+}
@@ -36,6 +36,7 @@
 #include <miopen/tensor.hpp>
 #include <utility>
 
+#include "bn_host.hpp"
 #include "driver.hpp"
 #include "get_handle.hpp"
 #include "tensor_holder.hpp"
@@ -46,8 +47,6 @@
 #include <cfloat>
 #include <iomanip>
 
-// Run CPU emulations in hierarchical reduction mode.
-//#define MIO_HEIRARCH_SEL 0
 #define MIO_BN_TEST_EXPAVGFACTOR 0.1
 #define MIO_BN_TEST_EPSILON 1e-5
 #define MIO_BN_USE_MIX_PREC 1
@@ -115,80 +114,18 @@ struct verify_forward_train_3d_bn_per_activation
 
         auto saveMean   = tensor<U>{1, channels, depth, height, width};
         auto saveInvVar = tensor<U>{1, channels, depth, height, width};
-        const auto n    = double(n_batch);
-
-        par_for(channels, 1, [&](int cidx) {
-            double mean_accum     = 0.;
-            double variance_accum = 0.;
-            double elemStd        = 0.;
-            double elemInvVar     = 0.;
-            double inhat          = 0.;
-            double newRunMean     = 0.;
-            double adjust         = 0.;
-
-            // process the batch per channel
-            for(int didx = 0; didx < depth; ++didx)
-            { // via depths
-                for(int row = 0; row < height; row++)
-                { // via rows
-                    for(int column = 0; column < width; column++)
-                    { // via columns
-
-                        mean_accum = 0.;
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            // #1 calculate the mean :: iterating through the stack of images in the
-                            // mini_batch
-                            mean_accum += input(bidx, cidx, didx, row, column);
-                        }
-                        mean_accum /= n;
-
-                        elemStd = variance_accum = 0.;
-                        // #2 calculate the variances :: sigma^2 = (1/batch_mean) * sum( (x_i -
-                        // batch_mean)^2 )
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            elemStd =
-                                (input(bidx, cidx, didx, row, column) -
-                                 mean_accum); // (x_i - mean) //this is reused but needs recalc
-                            variance_accum += elemStd * elemStd; // sum{ (x_i - mean)^2 }
-                        }                                        // end for(n)
-                        variance_accum /= n;                     // (1/N)*sum{ (x_i - mean)^2 }
-
-                        // #3 add epsilon for numeric stability, sqr_root, and invert
-                        elemInvVar = 1.0 / double(sqrt(variance_accum + epsilon));
-
-                        // #4 apply the normalization :: x_hat = (x_i - mean) / sqrt(variance_accum
-                        // -
-                        // epsilon)
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            elemStd =
-                                (input(bidx, cidx, didx, row, column) - mean_accum); // (x_i - mean)
-                            inhat = elemStd * elemInvVar;
-                            // #5 Gamma and Beta adjust :: y_i = gamma*x_hat + beta
-                            out(bidx, cidx, didx, row, column) =
-                                scale(0, cidx, didx, row, column) * inhat +
-                                shift(0, cidx, didx, row, column);
-                        } // end for(n_batch)
-
-                        newRunMean = runMean(0, cidx, didx, row, column) * (1.0 - expAvgFactor);
-                        runMean(0, cidx, didx, row, column) =
-                            mean_accum * expAvgFactor + newRunMean; // newMean*factor + tmp
-
-                        // var(n+1) = p * var(n-1) + (1 - p)*(b/b-1)*var(n)
-                        adjust = (n_batch == 1) ? variance_accum : (n / (n - 1.0)) * variance_accum;
-                        runVar(0, cidx, didx, row, column) =
-                            (1 - expAvgFactor) * runVar(0, cidx, didx, row, column) +
-                            expAvgFactor * adjust;
-
-                        saveMean(0, cidx, didx, row, column)   = mean_accum;
-                        saveInvVar(0, cidx, didx, row, column) = elemInvVar;
-
-                    } // for (column)
-                }     // for (row)
-            }
-        });
+
+        bn_host_fwd_train(make_bn_host_problem(input.desc.GetLengths(), false),
+                          input.data.data(),
+                          out.data.data(),
+                          scale.data.data(),
+                          shift.data.data(),
+                          epsilon,
+                          expAvgFactor,
+                          saveMean.data.data(),
+                          saveInvVar.data.data(),
+                          runMean.data.data(),
+                          runVar.data.data());
 
 #if(MIO_BN_TIME_EVERYTHING == 1)
         auto t_end = std::chrono::high_resolution_clock::now();
@@ -347,65 +284,12 @@ struct verify_forward_infer_3d_bn_per_activation_recalc
         auto out = tensor<T>{n_batch, channels, depth, height, width};
         std::fill(out.begin(), out.end(), 0);
 
-        const auto n = double(n_batch);
-
-        par_for(channels, 1, [&](int cidx) {
-
-            double elemStd        = 0.;
-            double elemInvVar     = 0.;
-            double mean_accum     = 0.;
-            double variance_accum = 0.;
-            double inhat          = 0.;
-
-            // process the batch per channel
-            for(int didx = 0; didx < depth; ++didx)
-            { // via depths
-                for(int row = 0; row < height; row++)
-                { // via rows
-                    for(int column = 0; column < width; column++)
-                    { // via columns
-                        mean_accum = 0.;
-
-                        // #1 calculate the mean
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            // iterating through the stack of images in the mini_batch
-                            mean_accum += input(bidx, cidx, didx, row, column);
-                        }
-                        mean_accum /= n;
-
-                        elemStd        = 0.;
-                        variance_accum = 0.;
-                        // #2 calculate the variances
-                        // sigma^2 = (1/batch_mean) * sum( (x_i - batch_mean)^2 )
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            elemStd =
-                                input(bidx, cidx, didx, row, column) - mean_accum; // (x_i - mean)
-                            variance_accum += elemStd * elemStd; // sum{ (x_i - mean)^2 }
-                        }                                        // end for(n)
-                        variance_accum /= n;                     // (1/N)*sum{ (x_i - mean)^2 }
-
-                        // #3 add epsilon for numeric stability, sqr_root, and invert
-                        elemInvVar = 1.0 / double(sqrt(variance_accum + epsilon));
-
-                        // #4 apply the normalization
-                        // x_hat = (x_i - mean) / sqrt(variance_accum - epsilon)
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            // per (x-dims) channel load a block of data into LDS
-                            elemStd =
-                                input(bidx, cidx, didx, row, column) - mean_accum; // (x_i - mean)
-                            inhat = elemStd * elemInvVar;
-                            // #5 Gamma and Beta adjust // y_i = gamma*x_hat + beta
-                            out(bidx, cidx, didx, row, column) =
-                                scale(0, cidx, didx, row, column) * inhat +
-                                shift(0, cidx, didx, row, column);
-                        } // end for(n_batchs)
-                    }     // for (column)
-                }         // for (row)
-            }             // for (depth)
-        });
+        bn_host_fwd_infer(make_bn_host_problem(input.desc.GetLengths(), false),
+                          input.data.data(),
+                          out.data.data(),
+                          scale.data.data(),
+                          shift.data.data(),
+                          epsilon);
 
 #if(MIO_BN_TIME_EVERYTHING == 1)
         auto t_end = std::chrono::high_resolution_clock::now();
@@ -497,36 +381,14 @@ struct verify_forward_infer_3d_bn_per_activation_use_est
         auto out = tensor<T>{n_batch, channels, depth, height, width};
         std::fill(out.begin(), out.end(), 0);
 
-        par_for(channels, 1, [&](int cidx) {
-            double elemStd    = 0.;
-            double mean       = 0.;
-            double variance   = 0.;
-            double inhat      = 0.;
-            double elemInvVar = 0.;
-
-            // process the batch per channel
-            for(int didx = 0; didx < depth; ++didx)
-            {
-                for(int row = 0; row < height; row++)
-                { // via rows
-                    for(int column = 0; column < width; column++)
-                    { // via columns
-                        mean       = estMean(0, cidx, didx, row, column);
-                        variance   = estVar(0, cidx, didx, row, column);
-                        elemInvVar = 1.0 / double(sqrt(variance + epsilon));
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        {                                                          // via mini_batch
-                            elemStd = input(bidx, cidx, didx, row, column) - mean; // (x_i - mean)
-                            inhat   = elemStd * elemInvVar;
-                            // #5 Gamma and Beta adjust :: y_i = gamma*x_hat + beta
-                            out(bidx, cidx, didx, row, column) =
-                                scale(0, cidx, didx, row, column) * inhat +
-                                shift(0, cidx, didx, row, column);
-                        } // end for(n_batchs)
-                    }     // for (column)
-                }         // for (row)
-            }             // for (depth)
-        });
+        bn_host_fwd_infer(make_bn_host_problem(input.desc.GetLengths(), false),
+                          input.data.data(),
+                          out.data.data(),
+                          scale.data.data(),
+                          shift.data.data(),
+                          epsilon,
+                          estMean.data.data(),
+                          estVar.data.data());
 
 #if(MIO_BN_TIME_EVERYTHING == 1)
         auto t_end = std::chrono::high_resolution_clock::now();
@@ -626,63 +488,15 @@ struct verify_backward_3d_bn_per_activation_use_saved
         auto dshift = tensor<U>{1, channels, depth, height, width};
         std::fill(dshift.begin(), dshift.end(), 0);
 
-        const unsigned int in_cstride = depth * height * width;
-        const unsigned int in_dstride = height * width;
-        const auto n                  = double(n_batch);
-
-        par_for(channels, 1, [&](int cidx) {
-            double elemStd = 0.;
-            unsigned int xhat_index;
-            double mean       = 0.;
-            double elemInvVar = 0.;
-            double dyelem     = 0.;
-            double dxhat      = 0.;
-            double dxhathat   = 0.;
-            double tmp1       = 0.;
-            std::vector<double> xhat(n_batch * in_cstride);
-
-            // process the batch per channel
-            for(int didx = 0; didx < depth; ++didx)
-            { // via depth
-                for(int row = 0; row < height; row++)
-                { // via rows
-                    for(int column = 0; column < width; column++)
-                    { // via columns
-                        dxhat    = 0.;
-                        dxhathat = 0.;
-
-                        mean       = savedMean(0, cidx, didx, row, column);   // HxW elements
-                        elemInvVar = savedInvVar(0, cidx, didx, row, column); // HxW elements
-
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            xhat_index =
-                                in_cstride * bidx + in_dstride * didx + width * row + column;
-                            // per (x-dims) channel load a block of data into LDS
-                            elemStd = x_input(bidx, cidx, didx, row, column) - mean; // (x_i - mean)
-                            xhat[xhat_index] = elemStd * elemInvVar;
-                            dyelem           = dy_input(bidx, cidx, didx, row, column);
-                            dshift(0, cidx, didx, row, column) += dyelem;
-                            dscale(0, cidx, didx, row, column) += xhat[xhat_index] * dyelem;
-                            tmp1 = scale(0, cidx, didx, row, column) * dyelem;
-                            dxhat += tmp1;
-                            dxhathat += tmp1 * xhat[xhat_index];
-
-                        } // end for(n_batchs)
-
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            xhat_index =
-                                in_cstride * bidx + in_dstride * didx + width * row + column;
-                            tmp1        = xhat[xhat_index] * dxhathat + dxhat;
-                            double tmp2 = n_batch * dxhat - tmp1;
-                            double tmp3 = elemInvVar / (double(n));
-                            dx_out(bidx, cidx, didx, row, column) = tmp3 * tmp2;
-                        } // end for(n_batchs)
-                    }     // for (column)
-                }         // for (row)
-            }             // for (depth)
-        });
+        bn_host_bwd(make_bn_host_problem(x_input.desc.GetLengths(), false),
+                    x_input.data.data(),
+                    dy_input.data.data(),
+                    dx_out.data.data(),
+                    scale.data.data(),
+                    dscale.data.data(),
+                    dshift.data.data(),
+                    savedMean.data.data(),
+                    savedInvVar.data.data());
 
 #if(MIO_BN_TIME_EVERYTHING == 1)
         auto t_end = std::chrono::high_resolution_clock::now();
@@ -807,85 +621,14 @@ struct verify_backward_3d_bn_per_activation_recalc
         auto dshift = tensor<U>{1, channels, depth, height, width};
         std::fill(dshift.begin(), dshift.end(), 0);
 
-        const unsigned int in_cstride = depth * height * width;
-        const unsigned int in_dstride = height * width;
-        const auto n                  = double(n_batch);
-
-        par_for(channels, 1, [&](int cidx) {
-
-            double elemStd = 0.;
-            unsigned int xhat_index;
-            double mean       = 0.;
-            double elemInvVar = 0.;
-            double dyelem     = 0.;
-            double variance   = 0.;
-            double dxhat      = 0.;
-            double dxhathat   = 0.;
-            double tmp1       = 0.;
-            std::vector<double> xhat(n_batch * in_cstride);
-
-            // process the batch per channel
-            for(int didx = 0; didx < depth; ++didx)
-            { // via depth
-                for(int row = 0; row < height; row++)
-                { // via rows
-                    for(int column = 0; column < width; column++)
-                    { // via columns
-                        mean = 0.;
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            // #1 calculate the mean
-                            mean += x_input(bidx, cidx, didx, row, column);
-                        }
-                        mean /= n;
-
-                        elemStd  = 0.;
-                        variance = 0.;
-                        // #2 calculate the variances
-                        // sigma^2 = (1/batch_mean) * sum( (x_i - batch_mean)^2 )
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            // per (x-dims) channel load a block of data into LDS
-                            elemStd = x_input(bidx, cidx, didx, row, column) - mean; // (x_i - mean)
-                            variance += elemStd * elemStd; // sum{ (x_i - mean)^2 }
-                        }                                  // end for(n)
-                        variance /= n;                     // (1/N)*sum{ (x_i - mean)^2 }
-
-                        // #3 add epsilon for numeric stability, sqr_root, and invert
-                        elemInvVar = 1.0 / double(sqrt(variance + epsilon));
-
-                        dxhat    = 0.;
-                        dxhathat = 0.;
-
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            xhat_index =
-                                in_cstride * bidx + in_dstride * didx + width * row + column;
-                            // per (x-dims) channel load a block of data into LDS
-                            elemStd = x_input(bidx, cidx, didx, row, column) - mean; // (x_i - mean)
-                            xhat[xhat_index] = elemStd * elemInvVar;
-                            dyelem           = dy_input(bidx, cidx, didx, row, column);
-                            dshift(0, cidx, didx, row, column) += dyelem;
-                            dscale(0, cidx, didx, row, column) += xhat[xhat_index] * dyelem;
-                            tmp1 = scale(0, cidx, didx, row, column) * dyelem;
-                            dxhat += tmp1;
-                            dxhathat += tmp1 * xhat[xhat_index];
-
-                        } // end for(n_batchs)
-
-                        for(int bidx = 0; bidx < n_batch; bidx++)
-                        { // via mini_batch
-                            xhat_index =
-                                in_cstride * bidx + in_dstride * didx + width * row + column;
-                            tmp1        = xhat[xhat_index] * dxhathat + dxhat;
-                            double tmp2 = n_batch * dxhat - tmp1;
-                            double tmp3 = elemInvVar / double(n);
-                            dx_out(bidx, cidx, didx, row, column) = tmp3 * tmp2;
-                        } // end for(n_batchs)
-                    }     // for (column)
-                }         // for (row)
-            }             // for (depth)
-        });
+        bn_host_bwd(make_bn_host_problem(x_input.desc.GetLengths(), false),
+                    x_input.data.data(),
+                    dy_input.data.data(),
+                    dx_out.data.data(),
+                    scale.data.data(),
+                    dscale.data.data(),
+                    dshift.data.data(),
+                    epsilon);
 #if(MIO_BN_TIME_EVERYTHING == 1)
         auto t_end = std::chrono::high_resolution_clock::now();
 
@@ -0,0 +1,362 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "bn_host.hpp"
+#include "test.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// The serial multi-pass loops the shared implementation replaced: the mean,
+// then the variance around it, then the outputs, one statistic at a time.
+
+struct naive_stats
+{
+    std::vector<double> mean;
+    std::vector<double> variance;
+};
+
+naive_stats naive_batch_stats(const bn_host_problem& p, const std::vector<double>& x)
+{
+    naive_stats s{std::vector<double>(p.stat_size()), std::vector<double>(p.stat_size())};
+    ford(p.n, p.c, p.inner)([&](std::size_t b, std::size_t ch, std::size_t i) {
+        s.mean[p.stat(ch, i)] += x[p.offset(b, ch) + i];
+    });
+    for(auto& m : s.mean)
+        m /= double(p.count());
+    ford(p.n, p.c, p.inner)([&](std::size_t b, std::size_t ch, std::size_t i) {
+        const double d = x[p.offset(b, ch) + i] - s.mean[p.stat(ch, i)];
+        s.variance[p.stat(ch, i)] += d * d;
+    });
+    for(auto& v : s.variance)
+        v /= double(p.count());
+    return s;
+}
+
+std::vector<double> naive_normalize(const bn_host_problem& p,
+                                    const std::vector<double>& x,
+                                    const std::vector<double>& scale,
+                                    const std::vector<double>& bias,
+                                    const std::vector<double>& mean,
+                                    const std::vector<double>& variance,
+                                    double epsilon)
+{
+    std::vector<double> y(x.size());
+    ford(p.n, p.c, p.inner)([&](std::size_t b, std::size_t ch, std::size_t i) {
+        const std::size_t j   = p.stat(ch, i);
+        const std::size_t idx = p.offset(b, ch) + i;
+        y[idx] = scale[j] * ((x[idx] - mean[j]) / std::sqrt(variance[j] + epsilon)) + bias[j];
+    });
+    return y;
+}
+
+struct naive_grads
+{
+    std::vector<double> dx;
+    std::vector<double> dscale;
+    std::vector<double> dbias;
+};
+
+naive_grads naive_bwd(const bn_host_problem& p,
+                      const std::vector<double>& x,
+                      const std::vector<double>& dy,
+                      const std::vector<double>& scale,
+                      const std::vector<double>& mean,
+                      const std::vector<double>& inv_std)
+{
+    naive_grads g{std::vector<double>(x.size()),
+                  std::vector<double>(p.stat_size()),
+                  std::vector<double>(p.stat_size())};
+    ford(p.n, p.c, p.inner)([&](std::size_t b, std::size_t ch, std::size_t i) {
+        const std::size_t j   = p.stat(ch, i);
+        const std::size_t idx = p.offset(b, ch) + i;
+        g.dbias[j] += dy[idx];
+        g.dscale[j] += (x[idx] - mean[j]) * inv_std[j] * dy[idx];
+    });
+    const double n = double(p.count());
+    ford(p.n, p.c, p.inner)([&](std::size_t b, std::size_t ch, std::size_t i) {
+        const std::size_t j   = p.stat(ch, i);
+        const std::size_t idx = p.offset(b, ch) + i;
+        const double xhat     = (x[idx] - mean[j]) * inv_std[j];
+        if(p.spatial)
+        {
+            g.dx[idx] = scale[j] * inv_std[j] / n *
+                        (n * dy[idx] - g.dbias[j] - xhat * g.dscale[j]);
+        }
+        else
+        {
+            const double dxhat    = scale[j] * g.dbias[j];
+            const double dxhathat = scale[j] * g.dscale[j];
+            g.dx[idx]             = inv_std[j] / n * (n * dxhat - (xhat * dxhathat + dxhat));
+        }
+    });
+    return g;
+}
+
+std::vector<double> generate(std::size_t n, double offset)
+{
+    std::vector<double> result(n);
+    for(auto& v : result)
+        v = offset + double(std::rand()) / RAND_MAX - 0.5;
+    return result;
+}
+
+void check_close(const std::vector<double>& result, const std::vector<double>& ref, double tol)
+{
+    CHECK(result.size() == ref.size());
+    for(std::size_t i = 0; i < result.size(); i++)
+        CHECK(std::abs(result[i] - ref[i]) <= tol * (1.0 + std::abs(ref[i])));
+}
+
+void check_case(bn_host_problem p)
+{
+    const double epsilon = 1e-5;
+    const double factor  = 0.1;
+    const auto x         = generate(p.n * p.c * p.inner, 0.0);
+    const auto dy        = generate(x.size(), 0.0);
+    const auto scale     = generate(p.stat_size(), 1.0);
+    const auto bias      = generate(p.stat_size(), 0.0);
+    const auto ref       = naive_batch_stats(p, x);
+
+    // Forward training against the reference statistics and outputs
+    std::vector<double> y(x.size());
+    std::vector<double> save_mean(p.stat_size());
+    std::vector<double> save_inv(p.stat_size());
+    auto run_mean     = generate(p.stat_size(), 0.0);
+    auto run_var      = generate(p.stat_size(), 1.0);
+    auto ref_run_mean = run_mean;
+    auto ref_run_var  = run_var;
+    bn_host_fwd_train(p,
+                      x.data(),
+                      y.data(),
+                      scale.data(),
+                      bias.data(),
+                      epsilon,
+                      factor,
+                      save_mean.data(),
+                      save_inv.data(),
+                      run_mean.data(),
+                      run_var.data());
+    const double count  = double(p.count());
+    const double adjust = p.count() == 1 ? 1.0 : count / (count - 1.0);
+    std::vector<double> ref_inv(p.stat_size());
+    for(std::size_t j = 0; j < p.stat_size(); j++)
+    {
+        ref_inv[j]      = 1.0 / std::sqrt(ref.variance[j] + epsilon);
+        ref_run_mean[j] = ref.mean[j] * factor + ref_run_mean[j] * (1 - factor);
+        ref_run_var[j]  = (1 - factor) * ref_run_var[j] + factor * adjust * ref.variance[j];
+    }
+    check_close(y, naive_normalize(p, x, scale, bias, ref.mean, ref.variance, epsilon), 1e-12);
+    check_close(save_mean, ref.mean, 1e-12);
+    check_close(save_inv, ref_inv, 1e-12);
+    check_close(run_mean, ref_run_mean, 1e-12);
+    check_close(run_var, ref_run_var, 1e-12);
+
+    // Inference, with estimated statistics and recomputing them
+    bn_host_fwd_infer(p,
+                      x.data(),
+                      y.data(),
+                      scale.data(),
+                      bias.data(),
+                      epsilon,
+                      run_mean.data(),
+                      run_var.data());
+    check_close(y, naive_normalize(p, x, scale, bias, run_mean, run_var, epsilon), 1e-12);
+    bn_host_fwd_infer(p, x.data(), y.data(), scale.data(), bias.data(), epsilon);
+    check_close(y, naive_normalize(p, x, scale, bias, ref.mean, ref.variance, epsilon), 1e-12);
+
+    // Backward, with saved statistics and recomputing them
+    const auto grads = naive_bwd(p, x, dy, scale, ref.mean, ref_inv);
+    std::vector<double> dx(x.size());
+    std::vector<double> dscale(p.stat_size());
+    std::vector<double> dbias(p.stat_size());
+    bn_host_bwd(p,
+                x.data(),
+                dy.data(),
+                dx.data(),
+                scale.data(),
+                dscale.data(),
+                dbias.data(),
+                save_mean.data(),
+                save_inv.data());
+    check_close(dx, grads.dx, 1e-10);
+    check_close(dscale, grads.dscale, 1e-10);
+    check_close(dbias, grads.dbias, 1e-10);
+    std::fill(dx.begin(), dx.end(), 0);
+    bn_host_bwd(
+        p, x.data(), dy.data(), dx.data(), scale.data(), dscale.data(), dbias.data(), epsilon);
+    check_close(dx, grads.dx, 1e-10);
+    check_close(dscale, grads.dscale, 1e-10);
+    check_close(dbias, grads.dbias, 1e-10);
+}
+
+// Values offset by 1e8 with an exactly known spread. A one-pass sum of squares
+// would cancel to noise here; the blocked moments have to keep every digit.
+void check_conditioning()
+{
+    for(bool spatial : {true, false})
+    {
+        bn_host_problem p;
+        p.n       = 64;
+        p.c       = 3;
+        p.inner   = spatial ? 5000 : 7;
+        p.spatial = spatial;
+        std::vector<double> x(p.n * p.c * p.inner);
+        for(std::size_t i = 0; i < x.size(); i++)
+            x[i] = 1e8 + ((i / (spatial ? 1 : p.c * p.inner)) % 2 == 0 ? -1.0 : 1.0);
+        std::vector<double> mean;
+        std::vector<double> variance;
+        bn_host_batch_stats(p, x.data(), mean, variance);
+        for(std::size_t j = 0; j < p.stat_size(); j++)
+        {
+            CHECK(std::abs(mean[j] - 1e8) <= 1e-7);
+            CHECK(std::abs(variance[j] - 1.0) <= 1e-8);
+        }
+    }
+}
+
+// Storage types other than double go through the same code path.
+void check_mixed_types()
+{
+    bn_host_problem p;
+    p.n           = 4;
+    p.c           = 3;
+    p.inner       = 33;
+    const auto xd = generate(p.n * p.c * p.inner, 0.0);
+    std::vector<float> x(xd.begin(), xd.end());
+    std::vector<float> y(x.size());
+    std::vector<float> scale(p.c, 2.0f);
+    std::vector<float> bias(p.c, 1.0f);
+    std::vector<float> mean(p.c);
+    std::vector<float> inv(p.c);
+    float* none = nullptr;
+    bn_host_fwd_train(p,
+                      x.data(),
+                      y.data(),
+                      scale.data(),
+                      bias.data(),
+                      1e-5,
+                      0.1,
+                      mean.data(),
+                      inv.data(),
+                      none,
+                      none);
+    const auto ref = naive_batch_stats(p, std::vector<double>(x.begin(), x.end()));
+    for(std::size_t j = 0; j < p.c; j++)
+        CHECK(std::abs(mean[j] - ref.mean[j]) <= 1e-6);
+}
+
+template <class F>
+double time_ms(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+void benchmark()
+{
+    // A 3-d spatial batch as bn_3d_spatial_test generates them
+    bn_host_problem p;
+    p.n                  = 8;
+    p.c                  = 32;
+    p.inner              = 16 * 32 * 32;
+    const auto x         = generate(p.n * p.c * p.inner, 0.0);
+    const auto dy        = generate(x.size(), 0.0);
+    const auto scale     = generate(p.c, 1.0);
+    const auto bias      = generate(p.c, 0.0);
+    const double epsilon = 1e-5;
+
+    naive_stats ref;
+    std::vector<double> ref_y;
+    const double naive_fwd = time_ms([&] {
+        ref   = naive_batch_stats(p, x);
+        ref_y = naive_normalize(p, x, scale, bias, ref.mean, ref.variance, epsilon);
+    });
+    std::vector<double> y(x.size());
+    const double host_fwd = time_ms(
+        [&] { bn_host_fwd_infer(p, x.data(), y.data(), scale.data(), bias.data(), epsilon); });
+    check_close(y, ref_y, 1e-12);
+    std::cout << "spatial fwd 8x32x16x32x32: naive " << naive_fwd << " ms, bn_host " << host_fwd
+              << " ms" << std::endl;
+
+    std::vector<double> inv(p.c);
+    for(std::size_t j = 0; j < p.c; j++)
+        inv[j] = 1.0 / std::sqrt(ref.variance[j] + epsilon);
+    naive_grads grads;
+    const double naive_bwd_ms =
+        time_ms([&] { grads = naive_bwd(p, x, dy, scale, ref.mean, inv); });
+    std::vector<double> dx(x.size());
+    std::vector<double> dscale(p.c);
+    std::vector<double> dbias(p.c);
+    const double host_bwd = time_ms([&] {
+        bn_host_bwd(p,
+                    x.data(),
+                    dy.data(),
+                    dx.data(),
+                    scale.data(),
+                    dscale.data(),
+                    dbias.data(),
+                    epsilon);
+    });
+    check_close(dx, grads.dx, 1e-10);
+    std::cout << "spatial bwd: naive " << naive_bwd_ms << " ms, bn_host " << host_bwd << " ms"
+              << std::endl;
+}
+
+int main()
+{
+    // n, c, inner: odd sizes exercise the vector tails, large inner the
+    // block split.
+    const std::vector<std::array<std::size_t, 3>> shapes = {{{1, 1, 1}},
+                                                            {{2, 3, 1}},
+                                                            {{1, 4, 9}},
+                                                            {{5, 3, 7}},
+                                                            {{4, 8, 64}},
+                                                            {{3, 2, 5003}},
+                                                            {{2, 5, 9000}},
+                                                            {{16, 6, 4 * 5 * 6}}};
+    for(const auto& s : shapes)
+    {
+        for(bool spatial : {true, false})
+        {
+            bn_host_problem p;
+            p.n       = s[0];
+            p.c       = s[1];
+            p.inner   = s[2];
+            p.spatial = spatial;
+            check_case(p);
+        }
+    }
+    check_conditioning();
+    check_mixed_types();
+    benchmark();
+}
@@ -0,0 +1,448 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_BN_HOST_HPP
+#define GUARD_BN_HOST_HPP
+
+#include "ford.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+// Host reference batch normalization shared by the tests and the driver. Work
+// is split over channels with par_for, and every channel reads its input once
+// for the statistics: spatial mode reduces cache-sized blocks with a corrected
+// two-pass sum and merges the blocks pairwise (Chan et al.), per-activation
+// mode runs Welford's update across the batch for a whole row of positions at
+// a time. All arithmetic is done in double whatever the storage types are.
+
+// A packed NCDHW tensor seen as n images of c channels holding `inner` (D*H*W)
+// elements each. Spatial mode keeps one statistic per channel, per-activation
+// mode one per (channel, position).
+struct bn_host_problem
+{
+    std::size_t n     = 1;
+    std::size_t c     = 1;
+    std::size_t inner = 1;
+    bool spatial      = true;
+
+    std::size_t stat_size() const { return spatial ? c : c * inner; }
+    // Samples reduced into each statistic.
+    std::size_t count() const { return spatial ? n * inner : n; }
+    std::size_t offset(std::size_t b, std::size_t ch) const { return (b * c + ch) * inner; }
+    std::size_t stat(std::size_t ch, std::size_t i) const { return spatial ? ch : ch * inner + i; }
+};
+
+template <class Lengths>
+bn_host_problem make_bn_host_problem(const Lengths& lens, bool spatial)
+{
+    bn_host_problem p;
+    p.n       = lens[0];
+    p.c       = lens[1];
+    p.inner   = std::accumulate(
+        lens.begin() + 2, lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+    p.spatial = spatial;
+    return p;
+}
+
+// Sample count, mean and sum of squared deviations from the mean.
+struct bn_host_moments
+{
+    double count = 0;
+    double mean  = 0;
+    double m2    = 0;
+
+    bn_host_moments& operator+=(const bn_host_moments& rhs)
+    {
+        const double total = count + rhs.count;
+        if(total == 0)
+            return *this;
+        const double delta = rhs.mean - mean;
+        mean += delta * (rhs.count / total);
+        m2 += rhs.m2 + delta * delta * (count * rhs.count / total);
+        count = total;
+        return *this;
+    }
+
+    double variance() const { return count > 0 ? m2 / count : 0; }
+};
+
+static constexpr std::size_t bn_host_block = 4096;
+static constexpr std::size_t bn_host_lanes = 8;
+
+// Moments of a contiguous, cache-resident block. The independent lanes let the
+// compiler vectorize both sums; the second pass subtracts the residual sum of
+// deviations so the block mean's rounding error does not leak into m2.
+template <class T>
+bn_host_moments bn_host_block_moments(const T* x, std::size_t len)
+{
+    bn_host_moments r;
+    if(len == 0)
+        return r;
+    const std::size_t body = len - len % bn_host_lanes;
+
+    double sum[bn_host_lanes] = {};
+    for(std::size_t i = 0; i < body; i += bn_host_lanes)
+        for(std::size_t l = 0; l < bn_host_lanes; l++)
+            sum[l] += static_cast<double>(x[i + l]);
+    double total = 0;
+    for(std::size_t i = body; i < len; i++)
+        total += static_cast<double>(x[i]);
+    for(double s : sum)
+        total += s;
+
+    r.count = static_cast<double>(len);
+    r.mean  = total / r.count;
+
+    double dev[bn_host_lanes] = {};
+    double sq[bn_host_lanes]  = {};
+    for(std::size_t i = 0; i < body; i += bn_host_lanes)
+    {
+        for(std::size_t l = 0; l < bn_host_lanes; l++)
+        {
+            const double d = static_cast<double>(x[i + l]) - r.mean;
+            dev[l] += d;
+            sq[l] += d * d;
+        }
+    }
+    double dev_total = 0;
+    double sq_total  = 0;
+    for(std::size_t i = body; i < len; i++)
+    {
+        const double d = static_cast<double>(x[i]) - r.mean;
+        dev_total += d;
+        sq_total += d * d;
+    }
+    for(std::size_t l = 0; l < bn_host_lanes; l++)
+    {
+        dev_total += dev[l];
+        sq_total += sq[l];
+    }
+    r.m2 = std::max(0.0, sq_total - dev_total * dev_total / r.count);
+    return r;
+}
+
+// Merges partial moments as a balanced tree, so the rounding error grows with
+// the log of the number of blocks rather than linearly.
+inline bn_host_moments bn_host_pairwise(std::vector<bn_host_moments> parts)
+{
+    if(parts.empty())
+        return {};
+    for(std::size_t width = 1; width < parts.size(); width *= 2)
+        for(std::size_t i = 0; i + width < parts.size(); i += 2 * width)
+            parts[i] += parts[i + width];
+    return parts.front();
+}
+
+// Batch mean and biased (1/count) variance of every statistic.
+template <class X>
+void bn_host_batch_stats(const bn_host_problem& p,
+                         const X* x,
+                         std::vector<double>& mean,
+                         std::vector<double>& variance)
+{
+    mean.assign(p.stat_size(), 0);
+    variance.assign(p.stat_size(), 0);
+    par_for(p.c, 1, [&](std::size_t ch) {
+        if(p.spatial)
+        {
+            std::vector<bn_host_moments> parts;
+            parts.reserve(p.n * ((p.inner + bn_host_block - 1) / bn_host_block));
+            for(std::size_t b = 0; b < p.n; b++)
+            {
+                const X* run = x + p.offset(b, ch);
+                for(std::size_t i = 0; i < p.inner; i += bn_host_block)
+                    parts.push_back(
+                        bn_host_block_moments(run + i, std::min(bn_host_block, p.inner - i)));
+            }
+            const auto m = bn_host_pairwise(std::move(parts));
+            mean[ch]     = m.mean;
+            variance[ch] = m.variance();
+        }
+        else
+        {
+            // Welford across the batch; every position of the row shares the
+            // same sample count, so the update vectorizes along the row.
+            double* mu = mean.data() + ch * p.inner;
+            double* m2 = variance.data() + ch * p.inner;
+            for(std::size_t b = 0; b < p.n; b++)
+            {
+                const X* run     = x + p.offset(b, ch);
+                const double inv = 1.0 / static_cast<double>(b + 1);
+                for(std::size_t i = 0; i < p.inner; i++)
+                {
+                    const double v = static_cast<double>(run[i]);
+                    const double d = v - mu[i];
+                    mu[i] += d * inv;
+                    m2[i] += d * (v - mu[i]);
+                }
+            }
+            const double inv_n = 1.0 / static_cast<double>(p.n);
+            for(std::size_t i = 0; i < p.inner; i++)
+                m2[i] *= inv_n;
+        }
+    });
+}
+
+inline std::vector<double> bn_host_inv_std(const std::vector<double>& variance, double epsilon)
+{
+    std::vector<double> r(variance.size());
+    std::transform(variance.begin(), variance.end(), r.begin(), [&](double v) {
+        return 1.0 / std::sqrt(v + epsilon);
+    });
+    return r;
+}
+
+// y = scale * (x - mean) * inv_std + bias
+template <class X, class Y, class S>
+void bn_host_normalize(const bn_host_problem& p,
+                       const X* x,
+                       Y* y,
+                       const S* scale,
+                       const S* bias,
+                       const std::vector<double>& mean,
+                       const std::vector<double>& inv_std)
+{
+    par_for(p.c, 1, [&](std::size_t ch) {
+        for(std::size_t b = 0; b < p.n; b++)
+        {
+            const X* xr = x + p.offset(b, ch);
+            Y* yr       = y + p.offset(b, ch);
+            for(std::size_t i = 0; i < p.inner; i++)
+            {
+                const std::size_t j = p.stat(ch, i);
+                const double xhat   = (static_cast<double>(xr[i]) - mean[j]) * inv_std[j];
+                yr[i] = static_cast<Y>(static_cast<double>(scale[j]) * xhat +
+                                       static_cast<double>(bias[j]));
+            }
+        }
+    });
+}
+
+// Forward training. Any of the saved or running statistics may be null to skip
+// it. The running variance uses the unbiased count / (count - 1) estimate.
+template <class X, class Y, class S, class M>
+void bn_host_fwd_train(const bn_host_problem& p,
+                       const X* x,
+                       Y* y,
+                       const S* scale,
+                       const S* bias,
+                       double epsilon,
+                       double exp_avg_factor,
+                       M* save_mean,
+                       M* save_inv_var,
+                       M* run_mean,
+                       M* run_var)
+{
+    std::vector<double> mean;
+    std::vector<double> variance;
+    bn_host_batch_stats(p, x, mean, variance);
+    const auto inv_std = bn_host_inv_std(variance, epsilon);
+    bn_host_normalize(p, x, y, scale, bias, mean, inv_std);
+
+    const double count  = static_cast<double>(p.count());
+    const double adjust = p.count() == 1 ? 1.0 : count / (count - 1.0);
+    for(std::size_t j = 0; j < p.stat_size(); j++)
+    {
+        if(save_mean != nullptr)
+            save_mean[j] = static_cast<M>(mean[j]);
+        if(save_inv_var != nullptr)
+            save_inv_var[j] = static_cast<M>(inv_std[j]);
+        if(run_mean != nullptr)
+            run_mean[j] = static_cast<M>(mean[j] * exp_avg_factor +
+                                         static_cast<double>(run_mean[j]) * (1 - exp_avg_factor));
+        if(run_var != nullptr)
+            run_var[j] = static_cast<M>((1 - exp_avg_factor) * static_cast<double>(run_var[j]) +
+                                        exp_avg_factor * adjust * variance[j]);
+    }
+}
+
+// Forward inference with the estimated statistics.
+template <class X, class Y, class S, class M>
+void bn_host_fwd_infer(const bn_host_problem& p,
+                       const X* x,
+                       Y* y,
+                       const S* scale,
+                       const S* bias,
+                       double epsilon,
+                       const M* est_mean,
+                       const M* est_var)
+{
+    const std::vector<double> mean(est_mean, est_mean + p.stat_size());
+    const std::vector<double> variance(est_var, est_var + p.stat_size());
+    bn_host_normalize(p, x, y, scale, bias, mean, bn_host_inv_std(variance, epsilon));
+}
+
+// Forward inference recomputing the batch statistics.
+template <class X, class Y, class S>
+void bn_host_fwd_infer(
+    const bn_host_problem& p, const X* x, Y* y, const S* scale, const S* bias, double epsilon)
+{
+    std::vector<double> mean;
+    std::vector<double> variance;
+    bn_host_batch_stats(p, x, mean, variance);
+    bn_host_normalize(p, x, y, scale, bias, mean, bn_host_inv_std(variance, epsilon));
+}
+
+// Backward pass producing dx, dscale and dbias from the batch mean and inverse
+// standard deviation. The per-activation dx follows MIOpenBatchNormBwdPerAct.cl
+// term for term.
+template <class X, class DY, class DX, class S, class M>
+void bn_host_bwd(const bn_host_problem& p,
+                 const X* x,
+                 const DY* dy,
+                 DX* dx,
+                 const S* scale,
+                 M* dscale,
+                 M* dbias,
+                 const std::vector<double>& mean,
+                 const std::vector<double>& inv_std)
+{
+    const double count = static_cast<double>(p.count());
+    par_for(p.c, 1, [&](std::size_t ch) {
+        const std::size_t stats = p.spatial ? 1 : p.inner;
+        const std::size_t first = p.stat(ch, 0);
+        std::vector<double> sum_dy(stats, 0);
+        std::vector<double> sum_dy_xhat(stats, 0);
+        for(std::size_t b = 0; b < p.n; b++)
+        {
+            const X* xr   = x + p.offset(b, ch);
+            const DY* dyr = dy + p.offset(b, ch);
+            if(p.spatial)
+            {
+                double s1[bn_host_lanes] = {};
+                double s2[bn_host_lanes] = {};
+                const std::size_t body   = p.inner - p.inner % bn_host_lanes;
+                for(std::size_t i = 0; i < body; i += bn_host_lanes)
+                {
+                    for(std::size_t l = 0; l < bn_host_lanes; l++)
+                    {
+                        const double g = static_cast<double>(dyr[i + l]);
+                        s1[l] += g;
+                        s2[l] += (static_cast<double>(xr[i + l]) - mean[first]) * g;
+                    }
+                }
+                for(std::size_t i = body; i < p.inner; i++)
+                {
+                    const double g = static_cast<double>(dyr[i]);
+                    s1[0] += g;
+                    s2[0] += (static_cast<double>(xr[i]) - mean[first]) * g;
+                }
+                for(std::size_t l = 0; l < bn_host_lanes; l++)
+                {
+                    sum_dy[0] += s1[l];
+                    sum_dy_xhat[0] += s2[l] * inv_std[first];
+                }
+            }
+            else
+            {
+                for(std::size_t i = 0; i < p.inner; i++)
+                {
+                    const double g = static_cast<double>(dyr[i]);
+                    sum_dy[i] += g;
+                    sum_dy_xhat[i] += (static_cast<double>(xr[i]) - mean[first + i]) *
+                                      inv_std[first + i] * g;
+                }
+            }
+        }
+        for(std::size_t s = 0; s < stats; s++)
+        {
+            dbias[first + s]  = static_cast<M>(sum_dy[s]);
+            dscale[first + s] = static_cast<M>(sum_dy_xhat[s]);
+        }
+
+        for(std::size_t b = 0; b < p.n; b++)
+        {
+            const X* xr   = x + p.offset(b, ch);
+            const DY* dyr = dy + p.offset(b, ch);
+            DX* dxr       = dx + p.offset(b, ch);
+            for(std::size_t i = 0; i < p.inner; i++)
+            {
+                const std::size_t s = p.spatial ? 0 : i;
+                const std::size_t j = first + s;
+                const double gamma  = static_cast<double>(scale[j]);
+                const double xhat   = (static_cast<double>(xr[i]) - mean[j]) * inv_std[j];
+                double r            = 0;
+                if(p.spatial)
+                {
+                    r = gamma * inv_std[j] / count *
+                        (count * static_cast<double>(dyr[i]) - sum_dy[s] - xhat * sum_dy_xhat[s]);
+                }
+                else
+                {
+                    const double dxhat    = gamma * sum_dy[s];
+                    const double dxhathat = gamma * sum_dy_xhat[s];
+                    r = inv_std[j] / count * (count * dxhat - (xhat * dxhathat + dxhat));
+                }
+                dxr[i] = static_cast<DX>(r);
+            }
+        }
+    });
+}
+
+// Backward pass with the statistics saved by forward training.
+template <class X, class DY, class DX, class S, class M>
+void bn_host_bwd(const bn_host_problem& p,
+                 const X* x,
+                 const DY* dy,
+                 DX* dx,
+                 const S* scale,
+                 M* dscale,
+                 M* dbias,
+                 const M* saved_mean,
+                 const M* saved_inv_var)
+{
+    bn_host_bwd(p,
+                x,
+                dy,
+                dx,
+                scale,
+                dscale,
+                dbias,
+                std::vector<double>(saved_mean, saved_mean + p.stat_size()),
+                std::vector<double>(saved_inv_var, saved_inv_var + p.stat_size()));
+}
+
+// Backward pass recomputing the batch statistics.
+template <class X, class DY, class DX, class S, class M>
+void bn_host_bwd(const bn_host_problem& p,
+                 const X* x,
+                 const DY* dy,
+                 DX* dx,
+                 const S* scale,
+                 M* dscale,
+                 M* dbias,
+                 double epsilon)
+{
+    std::vector<double> mean;
+    std::vector<double> variance;
+    bn_host_batch_stats(p, x, mean, variance);
+    bn_host_bwd(p, x, dy, dx, scale, dscale, dbias, mean, bn_host_inv_std(variance, epsilon));
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/command_graph.hpp>
+#include <miopen/errors.hpp>
+#include "test.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+template <class T>
+T arg_value(const OpKernelArg& arg)
+{
+    T result;
+    EXPECT(arg.size() == sizeof(T));
+    std::memcpy(&result, arg.buffer.data(), sizeof(T));
+    return result;
+}
+
+// Stands in for a backend: remembers every launch and runs a host version of the kernel.
+struct mock_sink
+{
+    struct launch
+    {
+        std::string name;
+        std::vector<OpKernelArg> args;
+    };
+    std::vector<launch> launches;
+
+    // y[i] = alpha * x[i]
+    miopen::CommandLaunch scale(const std::string& name)
+    {
+        return [this, name](std::vector<OpKernelArg>& args) {
+            launches.push_back({name, args});
+            auto x     = arg_value<const float*>(args[0]);
+            auto y     = arg_value<float*>(args[1]);
+            auto n     = arg_value<int>(args[2]);
+            auto alpha = arg_value<float>(args[3]);
+            for(int i = 0; i < n; i++)
+                y[i] = alpha * x[i];
+        };
+    }
+
+    void scale(miopen::CommandGraphRecorder& recorder,
+               const float* x,
+               float* y,
+               int n,
+               float alpha,
+               const std::string& name)
+    {
+        std::vector<OpKernelArg> args{x, y, n, alpha};
+        auto launch = scale(name);
+        launch(args);
+        recorder.Record(name, {64, 1, 1}, {static_cast<std::size_t>(n), 1, 1}, args, launch);
+    }
+};
+
+void check_replay()
+{
+    const int n = 8;
+    std::vector<float> x(n, 1.0f), tmp(n), y(n);
+    mock_sink sink;
+
+    miopen::CommandGraphRecorder recorder;
+    recorder.BindBuffer(0, x.data());
+    recorder.BindBuffer(1, tmp.data());
+    recorder.BindBuffer(2, y.data());
+    sink.scale(recorder, x.data(), tmp.data(), n, 2.0f, "first");
+    sink.scale(recorder, tmp.data(), y.data(), n, 3.0f, "second");
+    auto graph = recorder.Finish();
+    CHECK(y == std::vector<float>(n, 6.0f));
+
+    EXPECT(graph.GetNodes().size() == 2);
+    CHECK(graph.GetNumBufferSlots() == 3);
+    CHECK(graph.GetNodes()[0].name == "first");
+    CHECK(graph.GetNodes()[1].global_dims == std::vector<std::size_t>{n, 1, 1});
+    CHECK(graph.GetNodes()[0].buffer_args.size() == 2);
+
+    std::vector<float> x2(n, 5.0f), tmp2(n), y2(n);
+    sink.launches.clear();
+    graph.Replay({x2.data(), tmp2.data(), y2.data()});
+
+    EXPECT(sink.launches.size() == 2);
+    CHECK(sink.launches[0].name == "first");
+    CHECK(sink.launches[1].name == "second");
+    CHECK(arg_value<const float*>(sink.launches[0].args[0]) == x2.data());
+    CHECK(arg_value<float*>(sink.launches[1].args[1]) == y2.data());
+    // Scalars are replayed as recorded.
+    CHECK(arg_value<int>(sink.launches[1].args[2]) == n);
+    CHECK(arg_value<float>(sink.launches[1].args[3]) == 3.0f);
+
+    CHECK(y2 == std::vector<float>(n, 30.0f));
+    // The buffers used while recording are left alone.
+    CHECK(y == std::vector<float>(n, 6.0f));
+
+    // Replaying again reuses the same graph.
+    std::fill(x2.begin(), x2.end(), 1.0f);
+    graph.Replay({x2.data(), tmp2.data(), y2.data()});
+    CHECK(y2 == std::vector<float>(n, 6.0f));
+}
+
+void check_unbound_buffers()
+{
+    const int n = 4;
+    std::vector<float> x(n, 1.0f), y(n), scratch(n);
+    mock_sink sink;
+
+    miopen::CommandGraphRecorder recorder;
+    recorder.BindBuffer(1, y.data());
+    // The scratch buffer is not bound, so every replay writes to it again.
+    sink.scale(recorder, x.data(), scratch.data(), n, 2.0f, "a");
+    sink.scale(recorder, scratch.data(), y.data(), n, 2.0f, "b");
+    auto graph = recorder.Finish();
+    CHECK(graph.GetNumBufferSlots() == 2);
+
+    std::vector<float> y2(n);
+    sink.launches.clear();
+    // Slot 0 is never used, so it may be left empty.
+    graph.Replay({nullptr, y2.data()});
+    CHECK(arg_value<float*>(sink.launches[0].args[1]) == scratch.data());
+    CHECK(y2 == std::vector<float>(n, 4.0f));
+}
+
+void check_errors()
+{
+    std::vector<float> x(4), y(4);
+    mock_sink sink;
+
+    miopen::CommandGraphRecorder recorder;
+    CHECK(throws([&] { recorder.BindBuffer(0, nullptr); }));
+    recorder.BindBuffer(0, x.data());
+    recorder.BindBuffer(0, x.data());
+    CHECK(throws([&] { recorder.BindBuffer(1, x.data()); }));
+    recorder.BindBuffer(1, y.data());
+    sink.scale(recorder, x.data(), y.data(), 4, 1.0f, "copy");
+    auto graph = recorder.Finish();
+
+    CHECK(throws([&] { graph.Replay({x.data()}); }));
+    CHECK(throws([&] { graph.Replay({x.data(), nullptr}); }));
+    CHECK(sink.launches.size() == 1);
+
+    // Finish leaves the recorder empty and ready for another capture.
+    CHECK(recorder.Finish().Empty());
+    recorder.BindBuffer(1, x.data());
+}
+
+int main()
+{
+    check_replay();
+    check_unbound_buffers();
+    check_errors();
+}
@@ -31,9 +31,11 @@
 #include <memory>
 #include <miopen/convolution.hpp>
 #include <miopen/miopen.h>
+#include <miopen/philox.hpp>
 #include <miopen/tensor.hpp>
 #include <utility>
 
+#include <miopen/conv_host.hpp>
 #include "driver.hpp"
 #include "get_handle.hpp"
 #include "tensor_holder.hpp"
@@ -70,23 +72,48 @@ static bool is_direct_bwd_wrw_supported(miopen::Handle& handle,
 }
 #endif
 
-struct scalar_gen_random_float
+// The random bits of element (n, c, h, w) of the tensor generated from stream of seed.
+// They come from Philox keyed by the element index, so tensors are generated in
+// parallel and independently of the generation order.
+inline std::uint32_t random_elem_bits(std::uint32_t seed,
+                                      std::uint32_t stream,
+                                      std::size_t n,
+                                      std::size_t c,
+                                      std::size_t h,
+                                      std::size_t w)
 {
-    double min_val = 0;
-    double max_val = 1;
+    return miopen::philox4x32::generate({{static_cast<std::uint32_t>(n),
+                                          static_cast<std::uint32_t>(c),
+                                          static_cast<std::uint32_t>(h),
+                                          static_cast<std::uint32_t>(w)}},
+                                        {{seed, stream}})[0];
+}
+
+struct tensor_elem_gen_random_float
+{
+    double min_val       = 0;
+    double max_val       = 1;
+    std::uint32_t seed   = 0;
+    std::uint32_t stream = 0;
 
-    double operator()() const
+    double operator()(std::size_t n, std::size_t c, std::size_t h, std::size_t w) const
     {
-        return min_val + (max_val - min_val) * double(std::rand()) / RAND_MAX;
+        return min_val + (max_val - min_val) * random_elem_bits(seed, stream, n, c, h, w) *
+                             (1.0 / 4294967296.0);
     }
 };
 
-struct scalar_gen_random_integer
+struct tensor_elem_gen_random_integer
 {
     unsigned long min_val = 1;
     unsigned long max_val = 16;
+    std::uint32_t seed    = 0;
+    std::uint32_t stream  = 0;
 
-    double operator()() const { return min_val + std::rand() % (max_val - min_val + 1); }
+    double operator()(std::size_t n, std::size_t c, std::size_t h, std::size_t w) const
+    {
+        return min_val + random_elem_bits(seed, stream, n, c, h, w) % (max_val - min_val + 1);
+    }
 };
 
 struct tensor_elem_gen_one
@@ -106,6 +133,40 @@ tensor<T> get_output_tensor(const miopen::ConvolutionDescriptor& filter,
     return tensor<T>{filter.GetForwardOutputTensor(input.desc, weights.desc)};
 }
 
+template <class T>
+std::vector<double> pack_host(const tensor<T>& t)
+{
+    return miopen::conv_host_pack(t.data.data(), t.desc.GetLengths(), t.desc.GetStrides());
+}
+
+template <class T>
+void unpack_host(const std::vector<double>& data, tensor<T>& t)
+{
+    miopen::conv_host_unpack(data, t.data.data(), t.desc.GetLengths(), t.desc.GetStrides());
+}
+
+template <class T>
+miopen::conv_host_problem get_host_problem(const miopen::ConvolutionDescriptor& filter,
+                                           const tensor<T>& input,
+                                           const tensor<T>& weights,
+                                           const tensor<T>& out)
+{
+    const int groups = (filter.mode == miopenGroupConv || filter.mode == miopenDepthwise)
+                           ? filter.group_count
+                           : 1;
+    return miopen::make_conv_host_problem(input.desc.GetLengths(),
+                                          weights.desc.GetLengths(),
+                                          out.desc.GetLengths(),
+                                          filter.pad_h,
+                                          filter.pad_w,
+                                          filter.u,
+                                          filter.v,
+                                          filter.dilation_h,
+                                          filter.dilation_w,
+                                          groups,
+                                          filter.mode == miopenTranspose);
+}
+
 template <class T>
 struct conv_base
 {
@@ -150,88 +211,15 @@ struct verify_forward_conv : conv_base<T>
 
     tensor<T> cpu() const
     {
-        auto rout = get_output_tensor(filter, input, weights);
-
-        if(filter.mode == miopenTranspose)
-        {
-            std::fill(rout.begin(), rout.end(), 0);
-
-            int out_h, out_w;
-            std::tie(std::ignore, std::ignore, out_h, out_w) =
-                miopen::tien<4>(rout.desc.GetLengths());
-
-            int wei_c, wei_h, wei_w;
-            std::tie(std::ignore, wei_c, wei_h, wei_w) = miopen::tien<4>(weights.desc.GetLengths());
-
-            int in_n, in_c, in_h, in_w;
-            std::tie(in_n, in_c, in_h, in_w) = miopen::tien<4>(input.desc.GetLengths());
-
-            par_ford(in_n, wei_c)([&](int o, int k) {
-                ford(in_c, in_h, in_w, wei_h, wei_w)([&](int w, int i, int j, int x, int y) {
-                    const int start_x = i * filter.u - filter.pad_h;
-                    const int start_y = j * filter.v - filter.pad_w;
-                    const int out_x   = start_x + x * filter.dilation_h;
-                    const int out_y   = start_y + y * filter.dilation_w;
-                    if(out_x >= 0 && out_x < out_h && out_y >= 0 && out_y < out_w)
-                    {
-                        rout(o, k, out_x, out_y) += input(o, w, i, j) * weights(w, k, x, y);
-                    }
-                });
-            });
-        }
-        else if(filter.mode == miopenGroupConv || filter.mode == miopenDepthwise)
-        {
-            int in_h, in_w;
-            std::tie(std::ignore, std::ignore, in_h, in_w) =
-                miopen::tien<4>(input.desc.GetLengths());
-
-            int wei_n, wei_c, wei_h, wei_w;
-            std::tie(wei_n, wei_c, wei_h, wei_w) = miopen::tien<4>(weights.desc.GetLengths());
-
-            rout.par_for_each([&](int o, int w, int i, int j) {
-                const int start_x  = i * filter.u - filter.pad_h;
-                const int start_y  = j * filter.v - filter.pad_w;
-                const int group_id = w / (wei_n / filter.group_count);
-
-                double acc = bias;
-                ford(wei_c, wei_h, wei_w)([&](int k, int x, int y) {
-                    const int in_x  = start_x + x;
-                    const int in_y  = start_y + y;
-                    const int in_ch = group_id * wei_c + k;
-                    if(in_x >= 0 && in_x < in_h && in_y >= 0 && in_y < in_w)
-                    {
-                        acc += input(o, in_ch, in_x, in_y) * weights(w, k, x, y);
-                    }
-                });
-                rout(o, w, i, j) = acc;
-            });
-        }
-        else
-        {
-            int in_h, in_w;
-            std::tie(std::ignore, std::ignore, in_h, in_w) =
-                miopen::tien<4>(input.desc.GetLengths());
-
-            int wei_c, wei_h, wei_w;
-            std::tie(std::ignore, wei_c, wei_h, wei_w) = miopen::tien<4>(weights.desc.GetLengths());
-
-            rout.par_for_each([&](int o, int w, int i, int j) {
-                const int start_x = i * filter.u - filter.pad_h;
-                const int start_y = j * filter.v - filter.pad_w;
-
-                double acc = bias;
-                ford(wei_c, wei_h, wei_w)([&](int k, int x, int y) {
-                    const int in_x = start_x + x * filter.dilation_h;
-                    const int in_y = start_y + y * filter.dilation_w;
-                    if(in_x >= 0 && in_x < in_h && in_y >= 0 && in_y < in_w)
-                    {
-                        acc += double(input(o, k, in_x, in_y)) * double(weights(w, k, x, y));
-                    }
-                });
-                rout(o, w, i, j) = acc;
-            });
-        }
-
+        auto rout     = get_output_tensor(filter, input, weights);
+        const auto p  = get_host_problem(filter, input, weights, rout);
+        const auto ch = bias != 0 ? rout.desc.GetLengths()[1] : 0;
+        unpack_host(miopen::conv_host_forward(p,
+                                              filter.mode == miopenTranspose,
+                                              pack_host(input),
+                                              pack_host(weights),
+                                              std::vector<double>(ch, bias)),
+                    rout);
         return rout;
     }
 
@@ -321,93 +309,11 @@ struct verify_backward_conv : conv_base<T>
 
     tensor<T> cpu() const
     {
-        auto rinput = input;
-        std::fill(rinput.begin(), rinput.end(), 0);
-
-        if(filter.mode == miopenTranspose)
-        {
-            int out_h, out_w;
-            std::tie(std::ignore, std::ignore, out_h, out_w) =
-                miopen::tien<4>(out.desc.GetLengths());
-
-            int wei_c, wei_h, wei_w;
-            std::tie(std::ignore, wei_c, wei_h, wei_w) = miopen::tien<4>(weights.desc.GetLengths());
-
-            rinput.par_for_each([&](int o, int w, int i, int j) {
-                const int start_x = i * filter.u - filter.pad_h;
-                const int start_y = j * filter.v - filter.pad_w;
-
-                double acc = 0.0;
-                ford(wei_c, wei_h, wei_w)([&](int k, int x, int y) {
-                    const int in_x = start_x + x * filter.dilation_h;
-                    const int in_y = start_y + y * filter.dilation_w;
-                    if(in_x >= 0 && in_x < out_h && in_y >= 0 && in_y < out_w)
-                    {
-                        acc += out(o, k, in_x, in_y) * weights(w, k, x, y);
-                    }
-                });
-                rinput(o, w, i, j) = acc;
-            });
-        }
-        else if(filter.mode == miopenGroupConv || filter.mode == miopenDepthwise)
-        {
-            int in_c, in_h, in_w;
-            std::tie(std::ignore, in_c, in_h, in_w) = miopen::tien<4>(rinput.desc.GetLengths());
-
-            int wei_c, wei_h, wei_w;
-            std::tie(std::ignore, wei_c, wei_h, wei_w) = miopen::tien<4>(weights.desc.GetLengths());
-
-            int out_n, out_c, out_h, out_w;
-            std::tie(out_n, out_c, out_h, out_w) = miopen::tien<4>(out.desc.GetLengths());
-
-            par_ford(out_n, in_c)([&](int o, int k) {
-                const int group_id = k / wei_c;
-                ford(out_c / filter.group_count, out_h, out_w, wei_h, wei_w)(
-                    [&](int w, int i, int j, int x, int y) {
-                        const int start_x = i * filter.u - filter.pad_h;
-                        const int start_y = j * filter.v - filter.pad_w;
-                        const int in_x    = start_x + x;
-                        const int in_y    = start_y + y;
-                        const int out_ch  = group_id * (out_c / filter.group_count) + w;
-                        const int wei_ch  = k % wei_c;
-                        if(in_x >= 0 && in_x < in_h && in_y >= 0 && in_y < in_w)
-                        {
-                            rinput(o, k, in_x, in_y) +=
-                                out(o, out_ch, i, j) * weights(out_ch, wei_ch, x, y);
-                        }
-                    });
-            });
-        }
-        else
-        {
-            int in_n, in_c, in_h, in_w;
-            std::tie(in_n, in_c, in_h, in_w) = miopen::tien<4>(rinput.desc.GetLengths());
-
-            int wei_n, wei_h, wei_w;
-            std::tie(wei_n, std::ignore, wei_h, wei_w) = miopen::tien<4>(weights.desc.GetLengths());
-
-            int out_h, out_w;
-            std::tie(std::ignore, std::ignore, out_h, out_w) =
-                miopen::tien<4>(out.desc.GetLengths());
-
-            par_ford(in_n, in_c, in_h, in_w)([&](int n, int c, int hi, int wi) {
-                double acc = 0;
-                ford(wei_n, wei_h, wei_w)([&](int k, int y, int x) {
-                    int h_ = filter.pad_h + hi - y * filter.dilation_h;
-                    int w_ = filter.pad_w + wi - x * filter.dilation_w;
-
-                    int ho = h_ / filter.u;
-                    int wo = w_ / filter.v;
-
-                    if(((ho * filter.u == h_) and (wo * filter.v == w_)) and
-                       ((ho >= 0 and ho < out_h) and (wo >= 0 and wo < out_w)))
-                    {
-                        acc += double(out(n, k, ho, wo)) * double(weights(k, c, y, x));
-                    }
-                });
-                rinput(n, c, hi, wi) = acc;
-            });
-        }
+        auto rinput  = input;
+        const auto p = get_host_problem(filter, input, weights, out);
+        unpack_host(miopen::conv_host_backward_data(
+                        p, filter.mode == miopenTranspose, pack_host(out), pack_host(weights)),
+                    rinput);
         return rinput;
     }
 
@@ -498,41 +404,10 @@ struct verify_backward_weights_conv : conv_base<T>
     tensor<T> cpu() const
     {
         auto rweights = weights;
-        std::fill(rweights.begin(), rweights.end(), 0);
-
-        int in_h, in_w;
-        std::tie(std::ignore, std::ignore, in_h, in_w) = miopen::tien<4>(
-            filter.mode == miopenTranspose ? out.desc.GetLengths() : input.desc.GetLengths());
-
-        int wei_c, wei_h, wei_w;
-        std::tie(std::ignore, wei_c, wei_h, wei_w) = miopen::tien<4>(rweights.desc.GetLengths());
-
-        int out_n, out_c, out_h, out_w;
-        std::tie(out_n, out_c, out_h, out_w) = miopen::tien<4>(
-            filter.mode == miopenTranspose ? input.desc.GetLengths() : out.desc.GetLengths());
-
-        int groups = 1;
-        if(filter.mode == miopenGroupConv || filter.mode == miopenDepthwise)
-            groups = filter.group_count;
-
-        par_ford(out_c, wei_c, wei_h, wei_w)([&](int w, int k, int x, int y) {
-            double acc         = 0.0;
-            const int group_id = w / (out_c / groups);
-            const int in_ch    = group_id * wei_c + k;
-            ford(out_n, out_h, out_w)([&](int o, int i, int j) {
-                const int start_x = i * filter.u - filter.pad_h;
-                const int start_y = j * filter.v - filter.pad_w;
-                const int in_x    = start_x + x * filter.dilation_h;
-                const int in_y    = start_y + y * filter.dilation_w;
-                if(in_x >= 0 && in_x < in_h && in_y >= 0 && in_y < in_w)
-                {
-                    acc += (filter.mode == miopenTranspose
-                                ? double(out(o, k, in_x, in_y)) * double(input(o, w, i, j))
-                                : double(input(o, in_ch, in_x, in_y)) * double(out(o, w, i, j)));
-                }
-            });
-            rweights(w, k, x, y) = acc;
-        });
+        const auto p  = get_host_problem(filter, input, weights, out);
+        unpack_host(miopen::conv_host_backward_weights(
+                        p, filter.mode == miopenTranspose, pack_host(input), pack_host(out)),
+                    rweights);
         return rweights;
     }
 
@@ -740,19 +615,27 @@ struct conv_driver : test_driver
             {
                 auto output = get_output_tensor(filter, input, weights);
 
-                auto gen_positive_value = [=](auto, auto, auto, auto) {
-                    return gen_float ? scalar_gen_random_float{0, 1}()
-                                     : scalar_gen_random_integer{
-                                           1, miopen_type<T>{} == miopenHalf ? 4 : 16}();
+                const unsigned long max_int = miopen_type<T>{} == miopenHalf ? 4 : 16;
+
+                const std::uint32_t seed = this->seed;
+
+                auto gen_positive_value = [=](std::uint32_t stream) {
+                    return [=](auto n, auto c, auto h, auto w) {
+                        return gen_float ? tensor_elem_gen_random_float{0, 1, seed, stream}(
+                                               n, c, h, w)
+                                         : tensor_elem_gen_random_integer{1, max_int, seed, stream}(
+                                               n, c, h, w);
+                    };
                 };
 
-                auto gen_sign_value = [=](auto n, auto c, auto h, auto w) {
-                    return gen_float
-                               ? scalar_gen_random_float{-1, 1}()
-                               : scalar_gen_random_integer{1,
-                                                           miopen_type<T>{} == miopenHalf ? 4
-                                                                                          : 16}() *
-                                     tensor_elem_gen_checkboard_sign{}(n, c, h, w);
+                auto gen_sign_value = [=](std::uint32_t stream) {
+                    return [=](auto n, auto c, auto h, auto w) {
+                        return gen_float
+                                   ? tensor_elem_gen_random_float{-1, 1, seed, stream}(n, c, h, w)
+                                   : tensor_elem_gen_random_integer{1, max_int, seed, stream}(
+                                         n, c, h, w) *
+                                         tensor_elem_gen_checkboard_sign{}(n, c, h, w);
+                    };
                 };
 
                 bool skip_forward          = false;
@@ -781,9 +664,9 @@ struct conv_driver : test_driver
                     return;
                 }
 
-                input.generate(gen_positive_value);
-                output.generate(gen_positive_value);
-                weights.generate(gen_sign_value);
+                input.generate(gen_positive_value(1));
+                output.generate(gen_positive_value(2));
+                weights.generate(gen_sign_value(3));
 
                 if(do_forward && !skip_forward)
                 {
@@ -797,7 +680,7 @@ struct conv_driver : test_driver
 
                 if(do_backward_weights && !skip_backward_weights)
                 {
-                    output.generate(gen_sign_value);
+                    output.generate(gen_sign_value(4));
 
                     verify(
                         verify_backward_weights_conv<T>{input, weights, output, filter, 0, search});
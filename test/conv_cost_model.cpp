@@ -0,0 +1,288 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "test.hpp"
+#include <miopen/conv_cost_model.hpp>
+#include <miopen/perf_field.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using miopen::ConvAlgoClass;
+using miopen::ConvCostModel;
+using miopen::ProblemDescription;
+
+const std::vector<std::string>& algorithms()
+{
+    static const std::vector<std::string> names = {"miopenConvolutionFwdAlgoGEMM",
+                                                   "miopenConvolutionFwdAlgoDirect",
+                                                   "miopenConvolutionFwdAlgoWinograd",
+                                                   "miopenConvolutionFwdAlgoFFT"};
+    return names;
+}
+
+ProblemDescription parse(const std::string& key)
+{
+    ProblemDescription problem;
+    CHECK(miopen::ParseConvProblemKey(key, problem));
+    return problem;
+}
+
+std::string serialize(const ProblemDescription& problem)
+{
+    std::ostringstream ss;
+    problem.Serialize(ss);
+    return ss.str();
+}
+
+void check_keys()
+{
+    for(const std::string key : {"576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F",
+                                 "64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP16-B",
+                                 "32-28-28-5x3-48-14-26-2-2x1-2x1-2x2-1-NCHW-FP32-W",
+                                 "16-7-7-3x3-8-9-9-4-0x0-1x1-1x1-0-NCHW-FP32-F_mT",
+                                 "32-14-14-3x3-32-14-14-8-1x1-1x1-1x1-0-NCHW-FP32-F_g32",
+                                 "32-14-14-3x3-64-14-14-8-1x1-1x1-1x1-0-NCHW-FP32-W_mTg2"})
+        EXPECT(serialize(parse(key)) == key);
+
+    const auto p = parse("32-28-28-5x3-48-14-26-2-2x1-2x1-2x2-1-NCHW-FP16-W_g4");
+    EXPECT(p.n_inputs == 32 && p.in_height == 28 && p.in_width == 28);
+    EXPECT(p.kernel_size1 == 5 && p.kernel_size0 == 3);
+    EXPECT(p.n_outputs == 48 && p.out_height == 14 && p.out_width == 26 && p.batch_sz == 2);
+    EXPECT(p.pad1 == 2 && p.pad0 == 1 && p.kernel_stride1 == 2 && p.kernel_stride0 == 1);
+    EXPECT(p.kernel_dilation0 == 2 && p.kernel_dilation1 == 2 && p.bias == 1);
+    EXPECT(p.float_size == 16 && p.direction.IsBackwardWrW());
+    EXPECT(p.group_counts == 4 && p.mode.val == miopenGroupConv);
+
+    ProblemDescription unused;
+    for(const std::string key : {"",
+                                 "576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32",
+                                 "576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-X",
+                                 "576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-INT8-F",
+                                 "576-4-4-1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F",
+                                 "576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F_g",
+                                 "576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F_q2"})
+        EXPECT(!miopen::ParseConvProblemKey(key, unused));
+}
+
+void check_classes()
+{
+    const ConvAlgoClass expected[] = {
+        ConvAlgoClass::gemm, ConvAlgoClass::direct, ConvAlgoClass::winograd, ConvAlgoClass::fft};
+    for(std::size_t i = 0; i < algorithms().size(); i++)
+    {
+        ConvAlgoClass algo;
+        EXPECT(miopen::GetConvAlgoClass(algorithms()[i], algo) && algo == expected[i]);
+    }
+    ConvAlgoClass algo;
+    EXPECT(miopen::GetConvAlgoClass("miopenConvolutionBwdWeightsAlgoDirect", algo) &&
+           algo == ConvAlgoClass::direct);
+    EXPECT(!miopen::GetConvAlgoClass("miopenConvolutionFwdAlgoImplicitGEMM2", algo));
+    EXPECT(!miopen::GetConvAlgoClass("GEMM", algo));
+
+    const ConvCostModel model;
+    EXPECT(model.Estimate(parse("576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F"), "GEMM") < 0);
+}
+
+void check_costs()
+{
+    const ConvCostModel model;
+
+    // Winograd does fewer multiplies than a direct or GEMM 3x3 convolution
+    const auto conv3x3 = parse("64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP32-F");
+    const auto direct  = miopen::GetConvCost(conv3x3, ConvAlgoClass::direct);
+    const auto gemm    = miopen::GetConvCost(conv3x3, ConvAlgoClass::gemm);
+    const auto wino    = miopen::GetConvCost(conv3x3, ConvAlgoClass::winograd);
+    EXPECT(std::abs(direct.flops - 2.0 * 16 * 64 * 64 * 9 * 56 * 56) < 1);
+    EXPECT(gemm.flops == direct.flops && wino.flops < direct.flops);
+    EXPECT(gemm.bytes > direct.bytes && gemm.kernels == 2);
+    EXPECT(model.Roofline(conv3x3, ConvAlgoClass::winograd) <
+           model.Roofline(conv3x3, ConvAlgoClass::direct));
+
+    // A 1x1 GEMM needs no im2col
+    const auto conv1x1 = parse("576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F");
+    const auto unit    = miopen::GetConvCost(conv1x1, ConvAlgoClass::gemm);
+    EXPECT(unit.kernels == 1 &&
+           unit.bytes == miopen::GetConvCost(conv1x1, ConvAlgoClass::direct).bytes);
+
+    // Half precision doubles the peak and halves the traffic
+    const auto half = parse("64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP16-F");
+    EXPECT(model.Roofline(half, ConvAlgoClass::direct) <
+           model.Roofline(conv3x3, ConvAlgoClass::direct));
+
+    // Groups divide the work
+    const auto grouped = parse("64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP32-F_g4");
+    EXPECT(std::abs(miopen::GetConvCost(grouped, ConvAlgoClass::direct).flops * 4 -
+                    direct.flops) < 1);
+
+    // Launches dominate tiny problems: a 7 kernel FFT never wins one
+    const auto tiny = parse("4-7-7-3x3-4-7-7-1-1x1-1x1-1x1-0-NCHW-FP32-F");
+    EXPECT(model.Estimate(tiny, "miopenConvolutionFwdAlgoFFT") >
+           model.Estimate(tiny, "miopenConvolutionFwdAlgoDirect"));
+    for(const auto& algorithm : algorithms())
+        EXPECT(model.Estimate(conv3x3, algorithm) > 0);
+}
+
+const std::vector<std::string>& keys()
+{
+    static const std::vector<std::string> k = {
+        "64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP32-F",
+        "576-4-4-1x1-192-4-4-8-0x0-1x1-1x1-0-NCHW-FP32-F",
+        "32-28-28-5x5-48-28-28-2-2x2-1x1-1x1-0-NCHW-FP16-B",
+        "128-14-14-3x3-256-7-7-32-1x1-2x2-1x1-0-NCHW-FP32-W"};
+    return k;
+}
+
+void check_calibrate()
+{
+    miopen::ConvCostDevice device;
+    device.compute_units = 36;
+    device.clock_mhz     = 1000;
+    device.bandwidth     = 256;
+    device.launch_time   = 0.01;
+
+    const double actual[] = {0.8, 0.25, 0.5, 0.125};
+    ConvCostModel truth(device);
+    std::vector<miopen::ConvCostSample> samples;
+    for(const auto& key : keys())
+        for(std::size_t i = 0; i < algorithms().size(); i++)
+        {
+            const auto problem = parse(key);
+            ConvAlgoClass algo;
+            CHECK(miopen::GetConvAlgoClass(algorithms()[i], algo));
+            const double time = truth.Roofline(problem, algo) / actual[i] +
+                                miopen::GetConvCost(problem, algo).kernels * device.launch_time;
+            samples.push_back({problem, algorithms()[i], float(time)});
+        }
+    // Neither an unknown family nor a time under the launch overhead is a sample
+    samples.push_back({parse(keys()[0]), "miopenConvolutionFwdAlgoImplicitGEMM2", 1.0f});
+    samples.push_back({parse(keys()[0]), "miopenConvolutionFwdAlgoDirect", 0.001f});
+
+    ConvCostModel model(device);
+    EXPECT(model.Calibrate(samples) == keys().size() * algorithms().size());
+    for(std::size_t i = 0; i < algorithms().size(); i++)
+    {
+        const auto algo = static_cast<ConvAlgoClass>(i);
+        EXPECT(std::abs(model.Efficiency(algo) - actual[i]) < 1e-4);
+    }
+    // The calibrated model predicts the times it was fitted to
+    for(std::size_t j = 0; j < keys().size() * algorithms().size(); j++)
+        EXPECT(std::abs(model.Estimate(samples[j].problem, samples[j].algorithm) /
+                            samples[j].time -
+                        1) < 1e-4);
+
+    // The find-db holds the same times
+    std::ostringstream find_db;
+    for(std::size_t j = 0; j < keys().size(); j++)
+    {
+        find_db << keys()[j] << '=';
+        for(std::size_t i = 0; i < algorithms().size(); i++)
+        {
+            const auto& sample = samples[j * algorithms().size() + i];
+            find_db << (i == 0 ? "" : ";") << sample.algorithm << ':';
+            miopen::FindDbData{"ConvSolver", sample.time, 0, "<unused>"}.Serialize(find_db);
+        }
+        find_db << '\n';
+    }
+    find_db << "not-a-key=miopenConvolutionFwdAlgoGEMM:GEMM,1,0,<unused>\n";
+
+    std::istringstream in(find_db.str());
+    ConvCostModel from_db(device);
+    EXPECT(from_db.CalibrateFromFindDb(in) == keys().size() * algorithms().size());
+    for(std::size_t i = 0; i < algorithms().size(); i++)
+    {
+        const auto algo = static_cast<ConvAlgoClass>(i);
+        EXPECT(std::abs(from_db.Efficiency(algo) - actual[i]) < 1e-4);
+    }
+}
+
+void check_candidates()
+{
+    const ConvCostModel model;
+    const auto problem = parse("64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP32-F");
+
+    std::vector<std::pair<double, std::string>> predicted;
+    for(const auto& algorithm : algorithms())
+        predicted.emplace_back(model.Estimate(problem, algorithm), algorithm);
+    std::sort(predicted.begin(), predicted.end());
+    const double spread = predicted.back().first / predicted.front().first;
+    CHECK(spread > 1.5);
+
+    const std::string unknown = "miopenConvolutionFwdAlgoImplicitGEMM2";
+    auto run = [&](double factor, const std::vector<std::string>& succeeding) {
+        std::vector<std::string> ran;
+        std::vector<miopen::ConvFindCandidate> candidates;
+        for(const auto& algorithm : std::vector<std::string>{unknown, algorithms()[0],
+                                                             algorithms()[1], algorithms()[2],
+                                                             algorithms()[3]})
+            candidates.push_back({algorithm, [&ran, algorithm] { ran.push_back(algorithm); }});
+        const auto skipped = miopen::RunConvFindCandidates(
+            model, problem, factor, candidates, [&](const std::string& algorithm) {
+                return std::find(succeeding.begin(), succeeding.end(), algorithm) !=
+                       succeeding.end();
+            });
+        // Every candidate either ran or was skipped, once
+        EXPECT(ran.size() + skipped.size() == candidates.size());
+        return std::make_pair(ran, skipped);
+    };
+
+    // Without a factor everything runs in the given order
+    const auto all = run(0, algorithms());
+    EXPECT(all.second.empty() && all.first.size() == 5 && all.first.front() == unknown &&
+           all.first[1] == algorithms()[0] && all.first.back() == algorithms()[3]);
+
+    // A huge factor prunes nothing, but orders by prediction with unknown families last
+    const auto ordered = run(1e9, algorithms());
+    EXPECT(ordered.second.empty() && ordered.first.back() == unknown);
+    for(std::size_t i = 0; i < predicted.size(); i++)
+        EXPECT(ordered.first[i] == predicted[i].second);
+
+    // The predicted slowest is skipped once the fastest succeeded, the unknown never is
+    const auto pruned = run(spread * 0.99, algorithms());
+    EXPECT(pruned.second == std::vector<std::string>{predicted.back().second});
+    EXPECT(pruned.first.back() == unknown);
+
+    // Nothing is pruned against a prediction that found no solution
+    const auto inapplicable = run(1.0, {predicted[1].second});
+    EXPECT(inapplicable.first.size() >= 2 && inapplicable.first[0] == predicted[0].second &&
+           inapplicable.first[1] == predicted[1].second);
+    for(const auto& algorithm : inapplicable.second)
+        EXPECT(model.Estimate(problem, algorithm) > predicted[1].first);
+
+    // Nothing applicable: everything runs
+    EXPECT(run(1.0, {}).second.empty());
+}
+
+int main()
+{
+    check_keys();
+    check_classes();
+    check_costs();
+    check_calibrate();
+    check_candidates();
+}
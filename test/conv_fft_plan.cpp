@@ -0,0 +1,414 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "test.hpp"
+#include <miopen/convolution_fft.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+using miopen::FFTConvKernel;
+using miopen::FFTConvPlan;
+using miopen::FFTConvShape;
+
+using spectrum_t = std::complex<float>;
+
+// Half spectrum of a real length_h x length_w tile by a separable DFT
+void dft(const std::vector<double>& tile, int length_h, int length_w, spectrum_t* spectrum)
+{
+    const int half = length_w / 2 + 1;
+    std::vector<std::complex<double>> rows(std::size_t(length_h) * half);
+    for(int y = 0; y < length_h; y++)
+        for(int v = 0; v < half; v++)
+            for(int x = 0; x < length_w; x++)
+                rows[y * half + v] += tile[y * length_w + x] *
+                                      std::polar(1.0, -2 * M_PI * double(v) * x / length_w);
+    for(int u = 0; u < length_h; u++)
+        for(int v = 0; v < half; v++)
+        {
+            std::complex<double> sum;
+            for(int y = 0; y < length_h; y++)
+                sum += rows[y * half + v] * std::polar(1.0, -2 * M_PI * double(u) * y / length_h);
+            spectrum[u * half + v] = spectrum_t(sum);
+        }
+}
+
+// The real tile of a half spectrum
+std::vector<double> idft(const spectrum_t* spectrum, int length_h, int length_w)
+{
+    const int half = length_w / 2 + 1;
+    std::vector<std::complex<double>> full(std::size_t(length_h) * length_w);
+    for(int u = 0; u < length_h; u++)
+        for(int v = 0; v < length_w; v++)
+            full[u * length_w + v] =
+                v < half ? std::complex<double>(spectrum[u * half + v])
+                         : std::conj(std::complex<double>(
+                               spectrum[((length_h - u) % length_h) * half + length_w - v]));
+
+    std::vector<std::complex<double>> columns(full.size());
+    for(int y = 0; y < length_h; y++)
+        for(int v = 0; v < length_w; v++)
+            for(int u = 0; u < length_h; u++)
+                columns[y * length_w + v] +=
+                    full[u * length_w + v] * std::polar(1.0, 2 * M_PI * double(u) * y / length_h);
+    std::vector<double> tile(full.size());
+    for(int y = 0; y < length_h; y++)
+        for(int x = 0; x < length_w; x++)
+        {
+            std::complex<double> sum;
+            for(int v = 0; v < length_w; v++)
+                sum += columns[y * length_w + v] *
+                       std::polar(1.0, 2 * M_PI * double(v) * x / length_w);
+            tile[y * length_w + x] = sum.real() / (double(length_h) * length_w);
+        }
+    return tile;
+}
+
+struct conv_data
+{
+    FFTConvShape shape;
+    std::vector<float> x;
+    std::vector<float> w;
+
+    explicit conv_data(const FFTConvShape& s) : shape(s)
+    {
+        std::mt19937 gen(shape.n * 131 + shape.c * 17 + shape.h);
+        std::uniform_real_distribution<float> dist(-1, 1);
+        x.resize(std::size_t(s.n) * s.c * s.h * s.w);
+        w.resize(std::size_t(s.k) * s.c * s.r * s.s);
+        for(auto& v : x)
+            v = dist(gen);
+        for(auto& v : w)
+            v = dist(gen);
+    }
+
+    float in(int n, int c, int y, int x_) const
+    {
+        if(y < 0 || y >= shape.h || x_ < 0 || x_ >= shape.w)
+            return 0;
+        return x[((std::size_t(n) * shape.c + c) * shape.h + y) * shape.w + x_];
+    }
+
+    float wei(int k, int c, int y, int x_) const
+    {
+        return w[((std::size_t(k) * shape.c + c) * shape.r + y) * shape.s + x_];
+    }
+
+    std::size_t out(int n, int k, int y, int x_) const
+    {
+        return ((std::size_t(n) * shape.k + k) * shape.OutH() + y) * shape.OutW() + x_;
+    }
+
+    std::vector<double> direct() const
+    {
+        std::vector<double> y(std::size_t(shape.n) * shape.k * shape.OutH() * shape.OutW());
+        for(int n = 0; n < shape.n; n++)
+            for(int k = 0; k < shape.k; k++)
+                for(int oy = 0; oy < shape.OutH(); oy++)
+                    for(int ox = 0; ox < shape.OutW(); ox++)
+                    {
+                        double sum = 0;
+                        for(int c = 0; c < shape.c; c++)
+                            for(int i = 0; i < shape.r; i++)
+                                for(int j = 0; j < shape.s; j++)
+                                    sum += double(in(n, c, oy + i - shape.pad_h,
+                                                     ox + j - shape.pad_w)) *
+                                           wei(k, c, i, j);
+                        y[out(n, k, oy, ox)] = sum;
+                    }
+        return y;
+    }
+
+    // Runs the steps of a plan on a host workspace
+    std::vector<double> fft(const FFTConvPlan& plan) const
+    {
+        const auto& p              = plan;
+        const std::size_t spectrum = p.Spectrum();
+        const std::size_t tiles    = p.Tiles();
+        std::vector<spectrum_t> workspace(p.Workspace() / sizeof(spectrum_t));
+        auto input = [&](int n, int c, std::size_t t) {
+            return &workspace[p.input.offset / sizeof(spectrum_t) +
+                              ((std::size_t(n) * p.channel_batch + c) * tiles + t) * spectrum];
+        };
+        auto filter = [&](int k, int c) {
+            return &workspace[p.filter.offset / sizeof(spectrum_t) +
+                              (std::size_t(k) * p.channel_batch + c) * spectrum];
+        };
+        auto output = [&](int n, int k, std::size_t t) {
+            return &workspace[p.output.offset / sizeof(spectrum_t) +
+                              ((std::size_t(n) * shape.k + k) * tiles + t) * spectrum];
+        };
+
+        std::vector<double> y(std::size_t(shape.n) * shape.k * shape.OutH() * shape.OutW());
+        std::vector<double> tile(std::size_t(p.length_h) * p.length_w);
+        for(const auto& step : p.steps)
+        {
+            switch(step.kernel)
+            {
+            case FFTConvKernel::forward_filter:
+                for(int k = 0; k < shape.k; k++)
+                    for(int c = 0; c < step.channels; c++)
+                    {
+                        std::fill(tile.begin(), tile.end(), 0);
+                        for(int i = 0; i < shape.r; i++)
+                            for(int j = 0; j < shape.s; j++)
+                                tile[i * p.length_w + j] = wei(k, step.channel_begin + c, i, j);
+                        dft(tile, p.length_h, p.length_w, filter(k, c));
+                    }
+                break;
+            case FFTConvKernel::forward_input:
+                for(int n = 0; n < step.images; n++)
+                    for(int c = 0; c < step.channels; c++)
+                        for(std::size_t t = 0; t < tiles; t++)
+                        {
+                            const int y0 = int(t / p.tiles_w) * p.tile_h - shape.pad_h;
+                            const int x0 = int(t % p.tiles_w) * p.tile_w - shape.pad_w;
+                            for(int i = 0; i < p.length_h; i++)
+                                for(int j = 0; j < p.length_w; j++)
+                                    tile[i * p.length_w + j] = in(step.image_begin + n,
+                                                                  step.channel_begin + c,
+                                                                  y0 + i,
+                                                                  x0 + j);
+                            dft(tile, p.length_h, p.length_w, input(n, c, t));
+                        }
+                break;
+            case FFTConvKernel::multiply:
+                for(int n = 0; n < step.images; n++)
+                    for(int k = 0; k < shape.k; k++)
+                        for(std::size_t t = 0; t < tiles; t++)
+                        {
+                            auto* o = output(n, k, t);
+                            if(!step.accumulate)
+                                std::fill(o, o + spectrum, spectrum_t{});
+                            for(int c = 0; c < step.channels; c++)
+                                for(std::size_t f = 0; f < spectrum; f++)
+                                    o[f] += input(n, c, t)[f] * std::conj(filter(k, c)[f]);
+                        }
+                break;
+            case FFTConvKernel::inverse_output:
+                for(int n = 0; n < step.images; n++)
+                    for(int k = 0; k < shape.k; k++)
+                        for(std::size_t t = 0; t < tiles; t++)
+                        {
+                            const auto result = idft(output(n, k, t), p.length_h, p.length_w);
+                            const int y0      = int(t / p.tiles_w) * p.tile_h;
+                            const int x0      = int(t % p.tiles_w) * p.tile_w;
+                            for(int i = 0; i < p.tile_h && y0 + i < shape.OutH(); i++)
+                                for(int j = 0; j < p.tile_w && x0 + j < shape.OutW(); j++)
+                                    y[out(step.image_begin + n, k, y0 + i, x0 + j)] =
+                                        result[i * p.length_w + j];
+                        }
+                break;
+            }
+        }
+        return y;
+    }
+};
+
+// The invariants of a plan, independent of the data
+void check_plan(const FFTConvPlan& p, std::size_t workspace_limit)
+{
+    const auto& s = p.shape;
+    CHECK(p.length_h >= s.r && p.length_w >= s.s);
+    CHECK(p.tile_h == p.length_h - s.r + 1 && p.tile_w == p.length_w - s.s + 1);
+    CHECK(p.tile_h * p.tiles_h >= s.OutH() && p.tile_h * (p.tiles_h - 1) < s.OutH());
+    CHECK(p.tile_w * p.tiles_w >= s.OutW() && p.tile_w * (p.tiles_w - 1) < s.OutW());
+    CHECK(p.image_batch >= 1 && p.image_batch <= s.n);
+    CHECK(p.channel_batch >= 1 && p.channel_batch <= s.c);
+    CHECK(p.image_batch == 1 || p.channel_batch == s.c);
+
+    const std::size_t spectrum_size = p.Spectrum() * sizeof(spectrum_t);
+    CHECK(p.input.offset == 0);
+    CHECK(p.input.size == std::size_t(p.image_batch) * p.channel_batch * p.Tiles() * spectrum_size);
+    CHECK(p.filter.offset == p.input.size);
+    CHECK(p.filter.size == std::size_t(s.k) * p.channel_batch * spectrum_size);
+    CHECK(p.output.offset == p.filter.offset + p.filter.size);
+    CHECK(p.output.size == std::size_t(p.image_batch) * s.k * p.Tiles() * spectrum_size);
+    CHECK(p.Workspace() <= workspace_limit);
+
+    // Every image and channel pair is transformed and multiplied once, after its filters and
+    // before the image is transformed back
+    std::vector<int> transformed(std::size_t(s.n) * s.c);
+    std::vector<int> multiplied(std::size_t(s.n) * s.c);
+    std::vector<int> inverted(s.n);
+    std::vector<int> filters(s.c);
+    for(const auto& step : p.steps)
+    {
+        if(step.kernel == FFTConvKernel::forward_filter)
+        {
+            CHECK(step.channels <= p.channel_batch);
+            for(int c = step.channel_begin; c < step.channel_begin + step.channels; c++)
+                filters[c]++;
+            continue;
+        }
+        CHECK(step.images >= 1 && step.images <= p.image_batch);
+        if(step.kernel == FFTConvKernel::inverse_output)
+        {
+            for(int n = step.image_begin; n < step.image_begin + step.images; n++)
+            {
+                CHECK(inverted[n]++ == 0);
+                for(int c = 0; c < s.c; c++)
+                    CHECK(multiplied[n * s.c + c] == 1);
+            }
+            continue;
+        }
+        CHECK(step.channels >= 1 && step.channels <= p.channel_batch);
+        CHECK(step.kernel != FFTConvKernel::multiply ||
+              step.accumulate == (step.channel_begin != 0));
+        for(int n = step.image_begin; n < step.image_begin + step.images; n++)
+            for(int c = step.channel_begin; c < step.channel_begin + step.channels; c++)
+            {
+                CHECK(filters[c] > 0);
+                if(step.kernel == FFTConvKernel::forward_input)
+                    CHECK(transformed[n * s.c + c]++ == 0);
+                else
+                    CHECK(transformed[n * s.c + c] == 1 && multiplied[n * s.c + c]++ == 0);
+            }
+    }
+    for(int n = 0; n < s.n; n++)
+        CHECK(inverted[n] == 1);
+    if(p.channel_batch == s.c)
+        CHECK(std::all_of(filters.begin(), filters.end(), [](int f) { return f == 1; }));
+}
+
+void check_fft(const FFTConvPlan& plan, std::size_t workspace_limit)
+{
+    check_plan(plan, workspace_limit);
+    const conv_data data(plan.shape);
+    const auto expected = data.direct();
+    const auto actual   = data.fft(plan);
+    double error        = 0;
+    for(std::size_t i = 0; i < expected.size(); i++)
+        error = std::max(error, std::abs(expected[i] - actual[i]));
+    CHECK(error < 1e-3);
+}
+
+bool smooth(int length)
+{
+    for(int factor : {2, 3, 5})
+        while(length % factor == 0)
+            length /= factor;
+    return length == 1;
+}
+
+std::size_t spectrum_size(int length_h, int length_w)
+{
+    return std::size_t(length_h) * (length_w / 2 + 1) * sizeof(spectrum_t);
+}
+
+int main()
+{
+    const std::size_t unlimited = std::size_t(1) << 40;
+    const FFTConvShape shapes[] = {{2, 3, 7, 7, 4, 3, 3, 1, 1},
+                                   {3, 2, 9, 11, 2, 5, 3, 2, 0},
+                                   {1, 4, 6, 5, 3, 1, 1, 0, 0},
+                                   {2, 2, 5, 8, 3, 4, 2, 0, 1},
+                                   {1, 1, 3, 3, 2, 3, 3, 0, 0}};
+    for(const auto& shape : shapes)
+    {
+        // The planner's choice, which fits everything in one batch
+        FFTConvPlan plan;
+        CHECK(miopen::PlanFFTConv(shape, unlimited, plan));
+        CHECK(plan.image_batch == shape.n && plan.channel_batch == shape.c);
+        check_fft(plan, unlimited);
+
+        // It has the fewest flops among the lengths it searches
+        for(int length_h = shape.r; length_h <= shape.h + 2 * shape.pad_h; length_h++)
+            for(int length_w = shape.s; length_w <= shape.w + 2 * shape.pad_w; length_w++)
+            {
+                FFTConvPlan other;
+                CHECK(miopen::PlanFFTConv(shape, unlimited, length_h, length_w, other));
+                if(smooth(length_h) && smooth(length_w))
+                    CHECK(plan.flops <= other.flops);
+            }
+
+        // Every tiling, down to single output tiles
+        for(int length_h = shape.r; length_h <= shape.r + 4; length_h++)
+            for(int length_w = shape.s; length_w <= shape.s + 4; length_w += 2)
+            {
+                CHECK(miopen::PlanFFTConv(shape, unlimited, length_h, length_w, plan));
+                CHECK(plan.length_h == length_h && plan.length_w == length_w);
+                check_fft(plan, unlimited);
+            }
+
+        // Budgets for every image batch, then for every channel batch of one image
+        const int length_h       = shape.r + 2;
+        const int length_w       = shape.s + 1;
+        CHECK(miopen::PlanFFTConv(shape, unlimited, length_h, length_w, plan));
+        const std::size_t tiles  = plan.Tiles();
+        const std::size_t size   = spectrum_size(length_h, length_w);
+        const std::size_t n      = shape.n;
+        const std::size_t c      = shape.c;
+        const std::size_t k      = shape.k;
+        for(std::size_t images = 1; images <= n; images++)
+        {
+            const std::size_t limit = (k * c + images * (c + k) * tiles) * size + size - 1;
+            CHECK(miopen::PlanFFTConv(shape, limit, length_h, length_w, plan));
+            CHECK(plan.image_batch == int(images) && plan.channel_batch == shape.c);
+            check_fft(plan, limit);
+        }
+        for(std::size_t channels = 1; channels < c; channels++)
+        {
+            const std::size_t limit = (k * tiles + channels * (tiles + k)) * size;
+            CHECK(miopen::PlanFFTConv(shape, limit, length_h, length_w, plan));
+            CHECK(plan.image_batch == 1 && plan.channel_batch == int(channels));
+            check_fft(plan, limit);
+        }
+
+        // Too small for a single channel of a single image
+        const std::size_t too_small = (k * tiles + tiles + k) * size - 1;
+        CHECK(!miopen::PlanFFTConv(shape, too_small, length_h, length_w, plan));
+        // Shorter than the filter
+        CHECK(!miopen::PlanFFTConv(shape, unlimited, shape.r - 1, shape.s, plan));
+        CHECK(!miopen::PlanFFTConv(shape, unlimited, shape.r, shape.s - 1, plan));
+    }
+
+    // A search under a budget only returns plans within it
+    for(std::size_t limit : {std::size_t(4096), std::size_t(16384), std::size_t(1) << 20})
+    {
+        FFTConvPlan plan;
+        if(miopen::PlanFFTConv(shapes[0], limit, plan))
+            check_fft(plan, limit);
+    }
+
+    // Large images are tiled, with short smooth transforms
+    {
+        const FFTConvShape shape{8, 64, 224, 224, 64, 3, 3, 1, 1};
+        FFTConvPlan plan;
+        CHECK(miopen::PlanFFTConv(shape, std::size_t(256) << 20, plan));
+        check_plan(plan, std::size_t(256) << 20);
+        CHECK(plan.length_h <= 128 && plan.length_w <= 128 && plan.Tiles() > 1);
+        CHECK(smooth(plan.length_h) && smooth(plan.length_w));
+    }
+
+    // No convolution
+    FFTConvPlan plan;
+    CHECK(!miopen::PlanFFTConv({1, 1, 2, 2, 1, 3, 3, 0, 0}, unlimited, plan));
+    CHECK(!miopen::PlanFFTConv({0, 1, 4, 4, 1, 3, 3, 0, 0}, unlimited, plan));
+    CHECK(!miopen::PlanFFTConv({1, 1, 4, 4, 1, 3, 3, -1, 0}, unlimited, plan));
+}
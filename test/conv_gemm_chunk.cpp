@@ -0,0 +1,238 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/conv_gemm_chunk.hpp>
+#include "test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+struct conv_case
+{
+    int n, c, h, w;
+    int k, wei_h, wei_w;
+    int pad_h, pad_w, u, v, dilation_h, dilation_w;
+
+    int out_h() const { return (h + 2 * pad_h - dilation_h * (wei_h - 1) - 1) / u + 1; }
+    int out_w() const { return (w + 2 * pad_w - dilation_w * (wei_w - 1) - 1) / v + 1; }
+
+    miopen::ConvGemmChunkPlan plan(std::size_t workspace_size) const
+    {
+        return miopen::PlanConvGemmChunks(
+            n, c, h, w, k, wei_h, wei_w, out_h(), out_w(), sizeof(float), workspace_size);
+    }
+};
+
+std::vector<float> generate(std::size_t n)
+{
+    std::vector<float> v(n);
+    for(auto& x : v)
+        x = float(std::rand()) / RAND_MAX * 2.0f - 1.0f;
+    return v;
+}
+
+// Im2Col of one image, one col row per (channel, filter y, filter x)
+void host_im2col(const conv_case& p, const float* im, float* col)
+{
+    const int out_h = p.out_h();
+    const int out_w = p.out_w();
+    for(int ch = 0; ch < p.c; ch++)
+        for(int y = 0; y < p.wei_h; y++)
+            for(int x = 0; x < p.wei_w; x++)
+            {
+                const int row = (ch * p.wei_h + y) * p.wei_w + x;
+                for(int j = 0; j < out_h; j++)
+                    for(int i = 0; i < out_w; i++)
+                    {
+                        const int ih = j * p.u - p.pad_h + y * p.dilation_h;
+                        const int iw = i * p.v - p.pad_w + x * p.dilation_w;
+                        const bool inside = ih >= 0 && ih < p.h && iw >= 0 && iw < p.w;
+                        col[(row * out_h + j) * out_w + i] =
+                            inside ? im[(ch * p.h + ih) * p.w + iw] : 0.0f;
+                    }
+            }
+}
+
+std::vector<float>
+direct_conv(const conv_case& p, const std::vector<float>& x, const std::vector<float>& w)
+{
+    const int out_h = p.out_h();
+    const int out_w = p.out_w();
+    std::vector<float> y(std::size_t(p.n) * p.k * out_h * out_w);
+    for(int b = 0; b < p.n; b++)
+        for(int o = 0; o < p.k; o++)
+            for(int j = 0; j < out_h; j++)
+                for(int i = 0; i < out_w; i++)
+                {
+                    double acc = 0;
+                    for(int ch = 0; ch < p.c; ch++)
+                        for(int y = 0; y < p.wei_h; y++)
+                            for(int xx = 0; xx < p.wei_w; xx++)
+                            {
+                                const int ih = j * p.u - p.pad_h + y * p.dilation_h;
+                                const int iw = i * p.v - p.pad_w + xx * p.dilation_w;
+                                if(ih < 0 || ih >= p.h || iw < 0 || iw >= p.w)
+                                    continue;
+                                acc += double(x[((b * p.c + ch) * p.h + ih) * p.w + iw]) *
+                                       w[((o * p.c + ch) * p.wei_h + y) * p.wei_w + xx];
+                            }
+                    y[((b * p.k + o) * out_h + j) * out_w + i] = float(acc);
+                }
+    return y;
+}
+
+// Runs the chunks the way ConvolutionForward does: a batched Im2Col of every chunk into the
+// workspace, then one strided-batched GEMM y[i] = w * col[i] per chunk.
+std::vector<float> chunked_conv(const conv_case& p,
+                                const miopen::ConvGemmChunkPlan& chunks,
+                                const std::vector<float>& x,
+                                const std::vector<float>& w)
+{
+    const int m = p.k;
+    const int n = p.out_h() * p.out_w();
+    const int k = p.c * p.wei_h * p.wei_w;
+
+    std::vector<float> workspace(chunks.WorkSpaceSize(sizeof(float)) / sizeof(float));
+    std::vector<float> y(std::size_t(p.n) * m * n);
+    for(int i = 0; i < chunks.Count(); i++)
+    {
+        // Fill with garbage to catch anything read but not written by this chunk
+        std::fill(workspace.begin(), workspace.end(), 1e30f);
+        for(int b = 0; b < chunks.Images(i); b++)
+            host_im2col(p,
+                        x.data() + chunks.InOffset(i) + b * chunks.in_size,
+                        workspace.data() + b * chunks.col_size);
+
+        for(int b = 0; b < chunks.Images(i); b++)
+        {
+            const float* a_mat = w.data() + b * chunks.StrideA();
+            const float* b_mat = workspace.data() + b * chunks.StrideB();
+            float* c_mat       = y.data() + chunks.OutOffset(i) + b * chunks.StrideC();
+            for(int row = 0; row < m; row++)
+                for(int col = 0; col < n; col++)
+                {
+                    double acc = 0;
+                    for(int l = 0; l < k; l++)
+                        acc += double(a_mat[row * k + l]) * b_mat[l * n + col];
+                    c_mat[row * n + col] = float(acc);
+                }
+        }
+    }
+    return y;
+}
+
+void check_plan(const conv_case& p)
+{
+    const std::size_t col_bytes = p.plan(0).col_size * sizeof(float);
+
+    // Never less than one image, even without enough workspace
+    CHECK(p.plan(0).chunk_n == 1);
+    CHECK(p.plan(col_bytes - 1).chunk_n == 1);
+    CHECK(p.plan(col_bytes).chunk_n == 1);
+    // As many images as fit, but no more than the batch
+    CHECK(p.plan(2 * col_bytes + 1).chunk_n == std::min(2, p.n));
+    CHECK(p.plan(100 * col_bytes).chunk_n == std::min(100, p.n));
+
+    for(std::size_t images = 1; images <= std::size_t(p.n) + 1; images++)
+    {
+        const auto chunks = p.plan(images * col_bytes);
+        CHECK(chunks.WorkSpaceSize(sizeof(float)) <= images * col_bytes);
+
+        // The chunks cover every image exactly once, in order
+        int covered = 0;
+        for(int i = 0; i < chunks.Count(); i++)
+        {
+            CHECK(chunks.Images(i) > 0);
+            CHECK(chunks.Images(i) <= chunks.chunk_n);
+            CHECK(chunks.InOffset(i) == covered * chunks.in_size);
+            CHECK(chunks.OutOffset(i) == covered * chunks.out_size);
+            covered += chunks.Images(i);
+        }
+        CHECK(covered == p.n);
+    }
+}
+
+void check_conv(const conv_case& p)
+{
+    const auto x   = generate(std::size_t(p.n) * p.c * p.h * p.w);
+    const auto w   = generate(std::size_t(p.k) * p.c * p.wei_h * p.wei_w);
+    const auto ref = direct_conv(p, x, w);
+
+    const std::size_t col_bytes = p.plan(0).col_size * sizeof(float);
+    for(std::size_t images : {1, 2, 3, 100})
+    {
+        const auto y = chunked_conv(p, p.plan(images * col_bytes), x, w);
+        CHECK(y.size() == ref.size());
+        for(std::size_t i = 0; i < y.size(); i++)
+            CHECK(std::abs(y[i] - ref[i]) <= 1e-5f * (1.0f + std::abs(ref[i])));
+    }
+}
+
+// A batch of 1536 64x256x256 images has 6G elements, the offsets and strides of the later
+// chunks do not fit 32 bits
+void check_large_offsets()
+{
+    const conv_case p{1536, 64, 256, 256, 32, 3, 3, 1, 1, 1, 1, 1, 1};
+    const std::size_t in_size  = std::size_t(64) * 256 * 256;
+    const std::size_t col_size = std::size_t(64) * 3 * 3 * 256 * 256;
+    const std::size_t out_size = std::size_t(32) * 256 * 256;
+
+    // The whole batch in one chunk, its strided GEMM spans 58G elements of workspace
+    const auto whole = p.plan(std::size_t(1) << 40);
+    CHECK(whole.chunk_n == p.n);
+    CHECK(whole.Count() == 1);
+    CHECK(whole.StrideB() * (whole.chunk_n - 1) == (long long)(col_size * (p.n - 1)));
+    CHECK(whole.WorkSpaceSize(sizeof(float)) == col_size * p.n * sizeof(float));
+
+    const auto chunks = p.plan(3 * col_size * sizeof(float));
+    CHECK(chunks.chunk_n == 3);
+    const int last = chunks.Count() - 1;
+    CHECK(last == 511);
+    CHECK(chunks.Images(last) == 3);
+    CHECK(chunks.InOffset(last) == in_size * 1533);
+    CHECK(chunks.OutOffset(last) == out_size * 1533);
+    CHECK(chunks.InOffset(last) > std::numeric_limits<unsigned>::max());
+    CHECK(chunks.OutOffset(last) > std::size_t(std::numeric_limits<int>::max()));
+}
+
+int main()
+{
+    check_large_offsets();
+
+    // n, c, h, w, k, wei_h, wei_w, pad_h, pad_w, u, v, dilation_h, dilation_w
+    const std::vector<conv_case> cases = {{1, 3, 7, 7, 4, 3, 3, 1, 1, 1, 1, 1, 1},
+                                          {5, 2, 9, 6, 3, 3, 3, 0, 0, 1, 1, 1, 1},
+                                          {7, 3, 11, 10, 2, 5, 3, 2, 1, 2, 1, 1, 1},
+                                          {4, 1, 12, 12, 5, 3, 3, 2, 2, 1, 2, 2, 2},
+                                          {6, 4, 8, 8, 3, 1, 1, 0, 0, 2, 2, 1, 1}};
+    for(const auto& p : cases)
+    {
+        check_plan(p);
+        check_conv(p);
+    }
+}
@@ -0,0 +1,321 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "ford.hpp"
+#include "test.hpp"
+#include <miopen/conv_host.hpp>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// The nested loop references the engine replaced, generalized to groups and
+// dilation. All buffers are packed NCHW.
+
+std::vector<double> naive_fwd(const miopen::conv_host_problem& p,
+                              const std::vector<double>& in,
+                              const std::vector<double>& wei)
+{
+    std::vector<double> out(p.out_size());
+    const std::size_t cg = p.group_c();
+    const std::size_t kg = p.group_k();
+    ford(p.n, p.k, p.out_h, p.out_w)(
+        [&](std::size_t b, std::size_t kk, std::size_t i, std::size_t j) {
+            const std::size_t g = kk / kg;
+            double acc          = 0.0;
+            ford(cg, p.y, p.x)([&](std::size_t ch, std::size_t ky, std::size_t kx) {
+                const long in_h = long(i) * p.stride_h - p.pad_h + long(ky) * p.dilation_h;
+                const long in_w = long(j) * p.stride_w - p.pad_w + long(kx) * p.dilation_w;
+                if(in_h >= 0 && in_h < long(p.h) && in_w >= 0 && in_w < long(p.w))
+                {
+                    acc += in[((b * p.c + g * cg + ch) * p.h + in_h) * p.w + in_w] *
+                           wei[((kk * cg + ch) * p.y + ky) * p.x + kx];
+                }
+            });
+            out[((b * p.k + kk) * p.out_h + i) * p.out_w + j] = acc;
+        });
+    return out;
+}
+
+std::vector<double> naive_bwd_data(const miopen::conv_host_problem& p,
+                                   const std::vector<double>& dout,
+                                   const std::vector<double>& wei)
+{
+    std::vector<double> din(p.in_size());
+    const std::size_t cg = p.group_c();
+    const std::size_t kg = p.group_k();
+    ford(p.n, p.c, p.h, p.w)([&](std::size_t b, std::size_t ch, std::size_t hi, std::size_t wi) {
+        const std::size_t g = ch / cg;
+        double acc          = 0.0;
+        ford(kg, p.y, p.x)([&](std::size_t kk, std::size_t ky, std::size_t kx) {
+            const long h_ = p.pad_h + long(hi) - long(ky) * p.dilation_h;
+            const long w_ = p.pad_w + long(wi) - long(kx) * p.dilation_w;
+            const long ho = h_ / p.stride_h;
+            const long wo = w_ / p.stride_w;
+            if(ho * p.stride_h == h_ && wo * p.stride_w == w_ && ho >= 0 && ho < long(p.out_h) &&
+               wo >= 0 && wo < long(p.out_w))
+            {
+                acc += dout[((b * p.k + g * kg + kk) * p.out_h + ho) * p.out_w + wo] *
+                       wei[(((g * kg + kk) * cg + ch % cg) * p.y + ky) * p.x + kx];
+            }
+        });
+        din[((b * p.c + ch) * p.h + hi) * p.w + wi] = acc;
+    });
+    return din;
+}
+
+std::vector<double> naive_bwd_weights(const miopen::conv_host_problem& p,
+                                      const std::vector<double>& in,
+                                      const std::vector<double>& dout)
+{
+    std::vector<double> dwei(p.wei_size());
+    const std::size_t cg = p.group_c();
+    const std::size_t kg = p.group_k();
+    ford(p.k, cg, p.y, p.x)([&](std::size_t kk, std::size_t ch, std::size_t ky, std::size_t kx) {
+        const std::size_t g = kk / kg;
+        double acc          = 0.0;
+        ford(p.n, p.out_h, p.out_w)([&](std::size_t b, std::size_t i, std::size_t j) {
+            const long in_h = long(i) * p.stride_h - p.pad_h + long(ky) * p.dilation_h;
+            const long in_w = long(j) * p.stride_w - p.pad_w + long(kx) * p.dilation_w;
+            if(in_h >= 0 && in_h < long(p.h) && in_w >= 0 && in_w < long(p.w))
+            {
+                acc += in[((b * p.c + g * cg + ch) * p.h + in_h) * p.w + in_w] *
+                       dout[((b * p.k + kk) * p.out_h + i) * p.out_w + j];
+            }
+        });
+        dwei[((kk * cg + ch) * p.y + ky) * p.x + kx] = acc;
+    });
+    return dwei;
+}
+
+// Transposed forward as test/conv.cpp computes it: x is [n][k][out_h][out_w],
+// w is [k][c][y][x] and the result is [n][c][h][w].
+std::vector<double> naive_transposed_fwd(const miopen::conv_host_problem& p,
+                                         const std::vector<double>& x,
+                                         const std::vector<double>& wei)
+{
+    std::vector<double> y(p.in_size());
+    ford(p.n, p.c)([&](std::size_t b, std::size_t ch) {
+        ford(p.k, p.out_h, p.out_w, p.y, p.x)(
+            [&](std::size_t kk, std::size_t i, std::size_t j, std::size_t ky, std::size_t kx) {
+                const long out_h = long(i) * p.stride_h - p.pad_h + long(ky) * p.dilation_h;
+                const long out_w = long(j) * p.stride_w - p.pad_w + long(kx) * p.dilation_w;
+                if(out_h >= 0 && out_h < long(p.h) && out_w >= 0 && out_w < long(p.w))
+                {
+                    y[((b * p.c + ch) * p.h + out_h) * p.w + out_w] +=
+                        x[((b * p.k + kk) * p.out_h + i) * p.out_w + j] *
+                        wei[((kk * p.c + ch) * p.y + ky) * p.x + kx];
+                }
+            });
+    });
+    return y;
+}
+
+struct conv_case
+{
+    std::array<std::size_t, 4> in;
+    std::array<std::size_t, 3> wei;
+    int pad;
+    int stride;
+    int dilation;
+    int groups;
+};
+
+miopen::conv_host_problem make_problem(const conv_case& cc)
+{
+    const std::size_t eff_y = (cc.wei[1] - 1) * cc.dilation + 1;
+    const std::size_t eff_x = (cc.wei[2] - 1) * cc.dilation + 1;
+    const std::array<std::size_t, 4> wei{
+        {cc.wei[0], cc.in[1] / cc.groups, cc.wei[1], cc.wei[2]}};
+    const std::array<std::size_t, 4> out{{cc.in[0],
+                                          cc.wei[0],
+                                          (cc.in[2] + 2 * cc.pad - eff_y) / cc.stride + 1,
+                                          (cc.in[3] + 2 * cc.pad - eff_x) / cc.stride + 1}};
+    return miopen::make_conv_host_problem(cc.in,
+                                          wei,
+                                          out,
+                                          cc.pad,
+                                          cc.pad,
+                                          cc.stride,
+                                          cc.stride,
+                                          cc.dilation,
+                                          cc.dilation,
+                                          cc.groups,
+                                          false);
+}
+
+std::vector<double> generate(std::size_t n, bool integer)
+{
+    std::vector<double> result(n);
+    for(auto& v : result)
+        v = integer ? double(std::rand() % 9) - 4.0 : double(std::rand()) / RAND_MAX - 0.5;
+    return result;
+}
+
+// Integer valued data makes every product and partial sum exact, so the
+// engine has to match the loops bit for bit; real valued data only differs
+// by rounding where the summation order does.
+void check_equal(const std::vector<double>& result, const std::vector<double>& ref, bool exact)
+{
+    CHECK(result.size() == ref.size());
+    if(exact)
+    {
+        CHECK(result == ref);
+        return;
+    }
+    for(std::size_t i = 0; i < result.size(); i++)
+        CHECK(std::abs(result[i] - ref[i]) <= 1e-12 * (1.0 + std::abs(ref[i])));
+}
+
+void check_case(const conv_case& cc, bool integer)
+{
+    const auto p    = make_problem(cc);
+    const auto in   = generate(p.in_size(), integer);
+    const auto wei  = generate(p.wei_size(), integer);
+    const auto dout = generate(p.out_size(), integer);
+
+    check_equal(miopen::conv_host_fwd(p, in, wei), naive_fwd(p, in, wei), integer);
+    check_equal(miopen::conv_host_bwd_data(p, dout, wei), naive_bwd_data(p, dout, wei), integer);
+    check_equal(
+        miopen::conv_host_bwd_weights(p, in, dout), naive_bwd_weights(p, in, dout), integer);
+
+    // A transposed convolution reuses the same problem with the roles swapped
+    if(cc.groups == 1)
+    {
+        check_equal(miopen::conv_host_forward(p, true, dout, wei),
+                    naive_transposed_fwd(p, dout, wei),
+                    integer);
+        check_equal(
+            miopen::conv_host_backward_data(p, true, in, wei), naive_fwd(p, in, wei), integer);
+        check_equal(miopen::conv_host_backward_weights(p, true, dout, in),
+                    naive_bwd_weights(p, in, dout),
+                    integer);
+    }
+}
+
+void check_bias()
+{
+    const auto p = make_problem({{{2, 4, 7, 5}}, {{6, 3, 3}}, 1, 1, 1, 2});
+    const auto in  = generate(p.in_size(), true);
+    const auto wei = generate(p.wei_size(), true);
+    std::vector<double> bias(p.k);
+    for(std::size_t i = 0; i < bias.size(); i++)
+        bias[i] = double(i) + 0.5;
+
+    auto ref = naive_fwd(p, in, wei);
+    for(std::size_t i = 0; i < ref.size(); i++)
+        ref[i] += bias[i / p.out_pixels() % p.k];
+    CHECK(miopen::conv_host_fwd(p, in, wei, bias) == ref);
+}
+
+void check_strided_io()
+{
+    // A padded [2][3][4][5] tensor with an extra element per row and channel
+    const std::array<std::size_t, 4> lens{{2, 3, 4, 5}};
+    const std::array<std::size_t, 4> strides{{3 * 25, 25, 6, 1}};
+    std::vector<float> data(2 * strides[0], -1.0f);
+    for(std::size_t i = 0; i < data.size(); i++)
+        data[i] = float(i);
+
+    const auto packed = miopen::conv_host_pack(data.data(), lens, strides);
+    CHECK(packed.size() == 2 * 3 * 4 * 5);
+    CHECK(packed[5] == 6.0);
+    CHECK(packed[20] == 25.0);
+    CHECK(packed[60] == 75.0);
+
+    std::vector<float> out(data.size(), -1.0f);
+    miopen::conv_host_unpack(packed, out.data(), lens, strides);
+    for(std::size_t i = 0; i < out.size(); i++)
+    {
+        const std::size_t r = i % strides[1];
+        CHECK(out[i] == ((r < 4 * strides[2] && r % strides[2] < 5) ? data[i] : -1.0f));
+    }
+}
+
+template <class F>
+double time_ms(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+void benchmark()
+{
+    const auto p    = make_problem({{{2, 64, 28, 28}}, {{64, 3, 3}}, 1, 1, 1, 1});
+    const auto in   = generate(p.in_size(), false);
+    const auto wei  = generate(p.wei_size(), false);
+    const auto dout = generate(p.out_size(), false);
+
+    std::vector<double> a;
+    std::vector<double> b;
+    const double naive_ms  = time_ms([&] { a = naive_fwd(p, in, wei); });
+    const double engine_ms = time_ms([&] { b = miopen::conv_host_fwd(p, in, wei); });
+    check_equal(a, b, false);
+    std::cout << "fwd 2x64x28x28 * 64x64x3x3: naive " << naive_ms << " ms, engine " << engine_ms
+              << " ms" << std::endl;
+
+    const double naive_wrw  = time_ms([&] { a = naive_bwd_weights(p, in, dout); });
+    const double engine_wrw = time_ms([&] { b = miopen::conv_host_bwd_weights(p, in, dout); });
+    check_equal(a, b, false);
+    std::cout << "wrw: naive " << naive_wrw << " ms, engine " << engine_wrw << " ms" << std::endl;
+
+    const double naive_bwd  = time_ms([&] { a = naive_bwd_data(p, dout, wei); });
+    const double engine_bwd = time_ms([&] { b = miopen::conv_host_bwd_data(p, dout, wei); });
+    check_equal(a, b, false);
+    std::cout << "bwd data: naive " << naive_bwd << " ms, engine " << engine_bwd << " ms"
+              << std::endl;
+}
+
+int main()
+{
+    const std::vector<conv_case> cases = {
+        // n, c, h, w; k, y, x; pad, stride, dilation, groups
+        {{{1, 1, 5, 5}}, {{1, 3, 3}}, 0, 1, 1, 1},
+        {{{2, 3, 9, 7}}, {{4, 3, 3}}, 1, 1, 1, 1},
+        {{{2, 3, 9, 7}}, {{5, 3, 2}}, 2, 2, 1, 1},
+        {{{1, 8, 17, 19}}, {{6, 5, 5}}, 2, 1, 1, 1},
+        {{{2, 4, 11, 11}}, {{3, 3, 3}}, 1, 2, 2, 1},
+        {{{1, 2, 16, 16}}, {{2, 3, 3}}, 3, 1, 3, 1},
+        {{{2, 8, 9, 9}}, {{8, 3, 3}}, 1, 1, 1, 4},
+        {{{2, 6, 10, 8}}, {{12, 3, 3}}, 1, 2, 2, 3},
+        {{{3, 5, 8, 8}}, {{5, 3, 3}}, 1, 1, 1, 5},
+        {{{2, 4, 13, 9}}, {{8, 3, 3}}, 2, 2, 2, 4},
+        {{{1, 16, 40, 40}}, {{9, 1, 1}}, 0, 1, 1, 1},
+        {{{1, 3, 23, 23}}, {{4, 7, 7}}, 3, 4, 1, 1},
+    };
+    for(const auto& cc : cases)
+    {
+        check_case(cc, true);
+        check_case(cc, false);
+    }
+    check_bias();
+    check_strided_io();
+    benchmark();
+}
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "test.hpp"
+#include "get_handle.hpp"
+#include <miopen/config.h>
+#include <miopen/convolution.hpp>
+#include <miopen/miopen.h>
+#include <miopen/tensor.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Forward convolutions of one problem, with and without the weights transformed ahead of time
+struct prepare_weights_test
+{
+    miopen::Handle& handle;
+    miopen::ConvolutionDescriptor filter;
+    miopenConvFwdAlgorithm_t algo;
+    miopen::TensorDescriptor xDesc;
+    miopen::TensorDescriptor wDesc;
+    miopen::TensorDescriptor yDesc;
+    miopen::Allocator::ManageDataPtr x;
+    miopen::Allocator::ManageDataPtr w;
+    miopen::Allocator::ManageDataPtr y;
+    miopen::Allocator::ManageDataPtr workspace;
+    std::size_t workspace_size = 0;
+
+    prepare_weights_test(miopenConvFwdAlgorithm_t palgo,
+                         std::vector<std::size_t> x_lens,
+                         std::vector<std::size_t> w_lens,
+                         int pad)
+        : handle(get_handle()),
+          filter(pad, pad),
+          algo(palgo),
+          xDesc(miopenFloat, x_lens),
+          wDesc(miopenFloat, w_lens),
+          yDesc(filter.GetForwardOutputTensor(xDesc, wDesc))
+    {
+        std::mt19937 gen(x_lens[2]);
+        x = handle.Write(random(xDesc.GetElementSize(), gen));
+        w = handle.Write(random(wDesc.GetElementSize(), gen));
+        y = handle.Write(std::vector<float>(yDesc.GetElementSize()));
+
+        // Larger than needed, as a workspace shared between layers is
+        workspace_size = 2 * filter.ForwardGetWorkSpaceSize(handle, wDesc, xDesc, yDesc) + 4096;
+        workspace      = handle.Write(std::vector<char>(workspace_size));
+    }
+
+    static std::vector<float> random(std::size_t n, std::mt19937& gen)
+    {
+        std::uniform_real_distribution<float> dist(-1, 1);
+        std::vector<float> v(n);
+        for(auto& e : v)
+            e = dist(gen);
+        return v;
+    }
+
+    void find()
+    {
+        int count = 0;
+        std::vector<miopenConvAlgoPerf_t> perf(4);
+        filter.FindConvFwdAlgorithm(handle,
+                                    xDesc,
+                                    x.get(),
+                                    wDesc,
+                                    w.get(),
+                                    yDesc,
+                                    y.get(),
+                                    perf.size(),
+                                    &count,
+                                    perf.data(),
+                                    workspace.get(),
+                                    workspace_size,
+                                    false);
+    }
+
+    std::vector<float> forward()
+    {
+        const float alpha = 1;
+        const float beta  = 0;
+        filter.ConvolutionForward(handle,
+                                  &alpha,
+                                  xDesc,
+                                  x.get(),
+                                  wDesc,
+                                  w.get(),
+                                  algo,
+                                  &beta,
+                                  yDesc,
+                                  y.get(),
+                                  workspace.get(),
+                                  workspace_size);
+        return handle.Read<float>(y, yDesc.GetElementSize());
+    }
+
+    miopenStatus_t prepare(miopenConvFwdAlgorithm_t a, std::uint64_t version, std::size_t size)
+    {
+        return miopenConvolutionForwardPrepareWeights(
+            &handle, &xDesc, &wDesc, w.get(), &filter, &yDesc, a, version, workspace.get(), size);
+    }
+
+    miopenStatus_t release() { return miopenConvolutionForwardReleaseWeights(&handle, w.get()); }
+
+    std::size_t cached() const { return handle.GetFilterTransformCache().Size(); }
+};
+
+void check_equal(const std::vector<float>& result, const std::vector<float>& expected)
+{
+    CHECK(result.size() == expected.size());
+    for(std::size_t i = 0; i < result.size(); i++)
+        CHECK(std::fabs(result[i] - expected[i]) <= 1e-4f * (1 + std::fabs(expected[i])));
+}
+
+void run(miopenConvFwdAlgorithm_t algo,
+         std::vector<std::size_t> x_lens,
+         std::vector<std::size_t> w_lens,
+         int pad)
+{
+    prepare_weights_test t{algo, x_lens, w_lens, pad};
+    t.find();
+    const auto uncached = t.forward();
+
+    EXPECT(t.prepare(algo, 1, t.workspace_size) == miopenStatusSuccess);
+    EXPECT(t.cached() == 1);
+    check_equal(t.forward(), uncached);
+
+    // The same version is not transformed again, a new one replaces the cached filters
+    EXPECT(t.prepare(algo, 1, t.workspace_size) == miopenStatusSuccess);
+    EXPECT(t.cached() == 1);
+    std::mt19937 gen(w_lens[0]);
+    const auto weights = prepare_weights_test::random(t.wDesc.GetElementSize(), gen);
+    t.handle.WriteTo(weights.data(), t.w, t.wDesc.GetNumBytes());
+    EXPECT(t.prepare(algo, 2, t.workspace_size) == miopenStatusSuccess);
+    EXPECT(t.cached() == 1);
+    const auto prepared = t.forward();
+
+    EXPECT(t.release() == miopenStatusSuccess);
+    EXPECT(t.cached() == 0);
+    check_equal(prepared, t.forward());
+    EXPECT(t.release() == miopenStatusSuccess);
+
+#if MIOPEN_BACKEND_CPU
+    EXPECT(t.prepare(miopenConvolutionFwdAlgoFFT, 1, t.workspace_size) ==
+           miopenStatusNotImplemented);
+#else
+    // The Winograd kernels transform their filters themselves
+    EXPECT(t.prepare(miopenConvolutionFwdAlgoWinograd, 1, t.workspace_size) ==
+           miopenStatusNotImplemented);
+    EXPECT(t.prepare(algo, 1, 0) == miopenStatusBadParm);
+#endif
+    EXPECT(t.cached() == 0);
+}
+
+int main()
+{
+#if MIOPEN_BACKEND_CPU
+    run(miopenConvolutionFwdAlgoWinograd, {2, 3, 9, 11}, {4, 3, 3, 3}, 1);
+    run(miopenConvolutionFwdAlgoWinograd, {1, 2, 3, 3}, {3, 2, 3, 3}, 0);
+#else
+    // The filter spectra are transposed for 14x14 images and are not for 7x7 ones
+    run(miopenConvolutionFwdAlgoFFT, {4, 4, 14, 14}, {4, 4, 5, 5}, 2);
+    run(miopenConvolutionFwdAlgoFFT, {4, 4, 7, 7}, {8, 4, 5, 5}, 2);
+#endif
+}
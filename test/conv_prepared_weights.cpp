@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/config.h>
+#include <miopen/convolution.hpp>
+#include <miopen/filter_transform_cache.hpp>
+#include "get_handle.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Forward convolutions read the filters prepared ahead of time in place of transforming them.
+// They must give the same output as unprepared ones: FFT spectra on GPUs, Winograd filters on
+// the CPU backend.
+#if MIOPEN_BACKEND_CPU
+const miopenConvFwdAlgorithm_t prepared_algo = miopenConvolutionFwdAlgoWinograd;
+const int filter_size                        = 3;
+#else
+const miopenConvFwdAlgorithm_t prepared_algo = miopenConvolutionFwdAlgoFFT;
+const int filter_size                        = 5;
+#endif
+
+std::vector<float> random_vector(std::size_t n, std::mt19937& gen)
+{
+    std::uniform_real_distribution<float> dist(-1, 1);
+    std::vector<float> v(n);
+    for(auto& x : v)
+        x = dist(gen);
+    return v;
+}
+
+void test_prepared(std::size_t n, std::size_t c, std::size_t hw, std::size_t k, std::mt19937& gen)
+{
+    auto&& handle = get_handle();
+    const int pad = filter_size / 2;
+    const miopen::ConvolutionDescriptor conv(pad, pad);
+    const miopen::TensorDescriptor xDesc(miopenFloat, {n, c, hw, hw});
+    const miopen::TensorDescriptor wDesc(
+        miopenFloat, {k, c, std::size_t(filter_size), std::size_t(filter_size)});
+    const auto yDesc = conv.GetForwardOutputTensor(xDesc, wDesc);
+
+    const std::size_t ws_size = conv.ForwardGetWorkSpaceSize(handle, wDesc, xDesc, yDesc);
+    auto ws                   = handle.Create(std::max<std::size_t>(ws_size, 1));
+    auto x                    = handle.Write(random_vector(xDesc.GetElementSize(), gen));
+    auto w                    = handle.Write(random_vector(wDesc.GetElementSize(), gen));
+    auto y                    = handle.Create<float>(yDesc.GetElementSize());
+    const float alpha = 1, beta = 0;
+
+    auto forward = [&] {
+        conv.ConvolutionForward(handle,
+                                &alpha,
+                                xDesc,
+                                x.get(),
+                                wDesc,
+                                w.get(),
+                                prepared_algo,
+                                &beta,
+                                yDesc,
+                                y.get(),
+                                ws.get(),
+                                ws_size);
+        return handle.Read<float>(y, yDesc.GetElementSize());
+    };
+    auto prepare = [&](std::uint64_t version) {
+        conv.PrepareForwardWeights(
+            handle, xDesc, wDesc, w.get(), yDesc, prepared_algo, version, ws.get(), ws_size);
+    };
+    auto& cache = handle.GetFilterTransformCache();
+
+    // Preparing first also builds the kernels the unprepared convolution runs
+    prepare(1);
+    EXPECT(cache.Size() == 1);
+    const auto prepared = forward();
+    EXPECT(cache.Erase(w.get()) == 1);
+    EXPECT(cache.Empty());
+    const auto unprepared = forward();
+    EXPECT(prepared == unprepared);
+
+    // New weights in the same buffer are only read once prepared with a new version
+    prepare(1);
+    const auto w2 = random_vector(wDesc.GetElementSize(), gen);
+    handle.WriteTo(w2.data(), w, w2.size() * sizeof(float));
+    prepare(1);
+    EXPECT(forward() == unprepared);
+    prepare(2);
+    EXPECT(cache.Size() == 1);
+    const auto prepared2 = forward();
+    cache.Erase(w.get());
+    const auto unprepared2 = forward();
+    EXPECT(prepared2 == unprepared2);
+    EXPECT(unprepared2 != unprepared);
+}
+
+int main()
+{
+    std::mt19937 gen(5);
+    // Each image size the FFT supports, 7x7 without the transpose kernels
+    test_prepared(4, 4, 7, 4, gen);
+    test_prepared(2, 8, 14, 8, gen);
+    test_prepared(1, 16, 27, 16, gen);
+    test_prepared(4, 4, 28, 8, gen);
+}
@@ -113,10 +113,44 @@ struct test_deallocator2 : allocator_fixture
     }
 };
 
+struct test_memory_pool : allocator_fixture
+{
+    void run()
+    {
+        static int allocations = 0;
+        h.SetAllocator(
+            +[](void* ctx, std::size_t n) -> void* {
+                CHECK(n >= size);
+                allocations++;
+                return reinterpret_cast<miopen::Allocator::ManageDataPtr*>(ctx)->get();
+            },
+            +[](void* ctx, void* data) {
+                auto b = reinterpret_cast<miopen::Allocator::ManageDataPtr*>(ctx);
+                CHECK(data == b->get());
+            },
+            &buffer);
+        h.EnableMemoryPool(1024);
+        {
+            miopen::Allocator::ManageDataPtr p = h.Create(size);
+            CHECK(p.get() == buffer.get());
+        }
+        {
+            miopen::Allocator::ManageDataPtr p = h.Create(size);
+            CHECK(p.get() == buffer.get());
+        }
+        CHECK(allocations == 1);
+        CHECK(h.GetMemoryPoolStats().hits == 1);
+        h.TrimMemoryPool();
+        CHECK(h.GetMemoryPoolStats().bytes_cached == 0);
+        h.DisableMemoryPool();
+    }
+};
+
 int main()
 {
     run_test<test_allocator>();
     run_test<test_null_allocator>();
     run_test<test_deallocator>();
     run_test<test_deallocator2>();
+    run_test<test_memory_pool>();
 }
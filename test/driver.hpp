@@ -149,6 +149,7 @@ struct test_driver
     bool no_validate      = false;
     int repeat            = 1;
     bool rethrow          = false;
+    std::uint32_t seed    = 0;
 
     argument& get_argument(const std::string& s)
     {
@@ -171,6 +172,7 @@ struct test_driver
           "Disable cpu validation, so only gpu version is ran");
         v(repeat, {"--repeat"}, "Repeat the tests");
         v(rethrow, {"--rethrow"}, "Rethrow any exceptions found during verify");
+        v(seed, {"--seed"}, "Seed of the generated test data");
     }
 
     struct per_arg
@@ -470,7 +472,8 @@ struct test_driver
 
         using value_type = miopen::range_value<decltype(out_gpu)>;
         double threshold = std::numeric_limits<value_type>::epsilon() * tolerance;
-        auto error       = miopen::rms_range(out_cpu, out_gpu);
+        auto stats       = miopen::compare_range(out_cpu, out_gpu);
+        auto error       = stats.rms;
         if(not(error <= threshold) or verbose)
         {
             std::cout << (error <= threshold ? "error: " : "FAILED: ") << error << std::endl;
@@ -480,35 +483,31 @@ struct test_driver
                 fail(-1);
             }
 
-            auto mxdiff = miopen::max_diff(out_cpu, out_gpu);
-            std::cout << "Max diff: " << mxdiff << std::endl;
-            //            auto max_idx = miopen::mismatch_diff(out_cpu, out_gpu, mxdiff);
-            //            std::cout << "Max diff at " << max_idx << ": " << out_cpu[max_idx] << " !=
-            //            " << out_gpu[max_idx] << std::endl;
+            std::cout << "Max diff: " << stats.max_diff << std::endl;
 
-            if(miopen::range_zero(out_cpu))
+            if(stats.zero1)
                 std::cout << "Cpu data is all zeros" << std::endl;
-            if(miopen::range_zero(out_gpu))
+            if(stats.zero2)
                 std::cout << "Gpu data is all zeros" << std::endl;
 
-            auto idx = miopen::mismatch_idx(out_cpu, out_gpu, miopen::float_equal);
-            if(idx < miopen::range_distance(out_cpu))
+            auto idx = stats.mismatch_idx;
+            if(idx < stats.n)
             {
                 std::cout << "Mismatch at " << idx << ": " << out_cpu[idx] << " != " << out_gpu[idx]
                           << std::endl;
             }
 
-            auto cpu_nan_idx = find_idx(out_cpu, miopen::not_finite);
-            if(cpu_nan_idx >= 0)
-                std::cout << "Non finite number found in cpu at " << cpu_nan_idx << ": "
-                          << out_cpu[cpu_nan_idx] << std::endl;
+            if(stats.nonfinite_idx1 >= 0)
+                std::cout << "Non finite number found in cpu at " << stats.nonfinite_idx1 << ": "
+                          << out_cpu[stats.nonfinite_idx1] << " (" << stats.nan_count1
+                          << " nan, " << stats.inf_count1 << " inf)" << std::endl;
 
-            auto gpu_nan_idx = find_idx(out_gpu, miopen::not_finite);
-            if(gpu_nan_idx >= 0)
-                std::cout << "Non finite number found in gpu at " << gpu_nan_idx << ": "
-                          << out_gpu[gpu_nan_idx] << std::endl;
+            if(stats.nonfinite_idx2 >= 0)
+                std::cout << "Non finite number found in gpu at " << stats.nonfinite_idx2 << ": "
+                          << out_gpu[stats.nonfinite_idx2] << " (" << stats.nan_count2
+                          << " nan, " << stats.inf_count2 << " inf)" << std::endl;
         }
-        else if(miopen::range_zero(out_cpu) and miopen::range_zero(out_gpu))
+        else if(stats.zero1 and stats.zero2)
         {
             std::cout << "Warning: Both CPU and GPU data is all zero" << std::endl;
             show_command();
@@ -636,20 +635,21 @@ struct test_driver
     {
         return verify_impl(
             [&](auto&& cpu, auto&& gpu) {
-                if(miopen::range_zero(cpu))
+                auto stats = miopen::compare_range(cpu, gpu);
+                if(stats.zero1)
                 {
                     std::cout << "Cpu data is all zeros" << std::endl;
                     v.fail(-1, xs...);
                 }
 
-                if(miopen::range_zero(gpu))
+                if(stats.zero2)
                 {
                     std::cout << "Gpu data is all zeros" << std::endl;
                     v.fail(-1, xs...);
                 }
 
-                auto idx = miopen::mismatch_idx(cpu, gpu, miopen::float_equal);
-                if(idx < miopen::range_distance(cpu))
+                auto idx = stats.mismatch_idx;
+                if(idx < stats.n)
                 {
                     std::cout << "FAILED" << std::endl;
                     std::cout << "Mismatch at " << idx << ": " << cpu[idx] << " != " << gpu[idx]
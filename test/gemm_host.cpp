@@ -0,0 +1,181 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "test.hpp"
+#include <miopen/gemm_host.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// The triple loop ADNN_mm_cpu and RNN_mm_cpu used to run, accumulating in T
+template <class T>
+void naive_gemm(bool trans_a,
+                bool trans_b,
+                std::size_t m,
+                std::size_t n,
+                std::size_t k,
+                double alpha,
+                const T* a,
+                std::size_t lda,
+                const T* b,
+                std::size_t ldb,
+                double beta,
+                T* c,
+                std::size_t ldc)
+{
+    for(std::size_t i = 0; i < m; i++)
+    {
+        for(std::size_t j = 0; j < n; j++)
+        {
+            T acc = 0;
+            for(std::size_t p = 0; p < k; p++)
+                acc += (trans_a ? a[p * lda + i] : a[i * lda + p]) *
+                       (trans_b ? b[j * ldb + p] : b[p * ldb + j]);
+            c[i * ldc + j] = T(beta) * c[i * ldc + j] + T(alpha) * acc;
+        }
+    }
+}
+
+template <class T>
+std::vector<T> generate(std::size_t n)
+{
+    std::vector<T> result(n);
+    for(auto& x : result)
+        x = T(std::rand() % 7) - T(3);
+    return result;
+}
+
+// Integer data keeps every partial sum exact, so both must agree exactly
+template <class T>
+void check_variant(bool trans_a, bool trans_b, std::size_t m, std::size_t n, std::size_t k)
+{
+    const std::size_t pad = 3;
+    const std::size_t lda = (trans_a ? m : k) + pad;
+    const std::size_t ldb = (trans_b ? k : n) + pad;
+    const std::size_t ldc = n + pad;
+    const auto a          = generate<T>((trans_a ? k : m) * lda);
+    const auto b          = generate<T>((trans_b ? n : k) * ldb);
+    const auto c          = generate<T>(m * ldc);
+
+    for(double alpha : {1.0, -2.0})
+    {
+        for(double beta : {0.0, 1.0, 0.5})
+        {
+            auto result = c;
+            auto ref    = c;
+            miopen::host_gemm(trans_a,
+                              trans_b,
+                              m,
+                              n,
+                              k,
+                              alpha,
+                              a.data(),
+                              lda,
+                              b.data(),
+                              ldb,
+                              beta,
+                              result.data(),
+                              ldc);
+            naive_gemm(trans_a,
+                       trans_b,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       a.data(),
+                       lda,
+                       b.data(),
+                       ldb,
+                       beta,
+                       ref.data(),
+                       ldc);
+            CHECK(result == ref);
+        }
+    }
+}
+
+void check_beta_zero_ignores_c()
+{
+    const std::vector<float> a = {1, 2, 3, 4};
+    const std::vector<float> b = {1, 0, 0, 1};
+    std::vector<float> c(4, std::numeric_limits<float>::quiet_NaN());
+    miopen::host_gemm(false, false, 2, 2, 2, 1.0, a.data(), 2, b.data(), 2, 0.0, c.data(), 2);
+    CHECK(c == a);
+}
+
+template <class F>
+double gflops(std::size_t m, std::size_t n, std::size_t k, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const double s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 2.0 * m * n * k / s * 1e-9;
+}
+
+void benchmark(bool trans_a, bool trans_b, std::size_t m, std::size_t n, std::size_t k)
+{
+    const auto a = generate<float>(m * k);
+    const auto b = generate<float>(k * n);
+    std::vector<float> c(m * n);
+    const std::size_t lda = trans_a ? m : k;
+    const std::size_t ldb = trans_b ? k : n;
+
+    const double naive = gflops(m, n, k, [&] {
+        naive_gemm(trans_a, trans_b, m, n, k, 1.0, a.data(), lda, b.data(), ldb, 0.0, c.data(), n);
+    });
+    const double blocked = gflops(m, n, k, [&] {
+        miopen::host_gemm(
+            trans_a, trans_b, m, n, k, 1.0, a.data(), lda, b.data(), ldb, 0.0, c.data(), n);
+    });
+    std::cout << (trans_a ? 'T' : 'N') << (trans_b ? 'T' : 'N') << " " << m << "x" << n << "x"
+              << k << ": triple loop " << naive << " GFLOPS, host_gemm " << blocked
+              << " GFLOPS" << std::endl;
+}
+
+int main()
+{
+    for(bool trans_a : {false, true})
+    {
+        for(bool trans_b : {false, true})
+        {
+            check_variant<float>(trans_a, trans_b, 1, 1, 1);
+            check_variant<float>(trans_a, trans_b, 7, 5, 3);
+            check_variant<double>(trans_a, trans_b, 37, 530, 129);
+            check_variant<float>(trans_a, trans_b, 70, 33, 300);
+        }
+    }
+    check_beta_zero_ignores_c();
+
+    benchmark(false, false, 256, 256, 256);
+    // Shapes of the LSTM references: batch x 4*hidden x hidden, and the
+    // transposed weight-gradient product
+    benchmark(false, true, 64, 2048, 512);
+    benchmark(true, false, 512, 2048, 64);
+}
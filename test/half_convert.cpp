@@ -0,0 +1,195 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/half_convert.hpp>
+#include "test.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+std::uint32_t bits(float x)
+{
+    std::uint32_t f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+float from_bits(std::uint32_t f)
+{
+    float x;
+    std::memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+bool is_nan_half(std::uint16_t h) { return (h & 0x7c00u) == 0x7c00u && (h & 0x3ffu) != 0; }
+
+// The value of a finite half straight from its definition
+double half_value(std::uint16_t h)
+{
+    const int e    = (h >> 10) & 0x1f;
+    const int m    = h & 0x3ff;
+    const double v = e == 0 ? std::ldexp(m, -24) : std::ldexp(m + 1024, e - 25);
+    return (h & 0x8000u) != 0 ? -v : v;
+}
+
+std::vector<std::uint16_t> all_halves()
+{
+    std::vector<std::uint16_t> result(1 << 16);
+    for(std::size_t i = 0; i < result.size(); i++)
+        result[i] = static_cast<std::uint16_t>(i);
+    return result;
+}
+
+// Bulk conversions take the F16C path where the CPU has it, so comparing them
+// with the scalar functions checks both implementations against each other.
+void check_bulk(const std::vector<float>& in)
+{
+    std::vector<std::uint16_t> h(in.size());
+    miopen::float_to_half(in.data(), h.data(), in.size());
+    std::vector<float> back(in.size());
+    miopen::half_to_float(h.data(), back.data(), h.size());
+    for(std::size_t i = 0; i < in.size(); i++)
+    {
+        CHECK(h[i] == miopen::float_to_half_bits(in[i]));
+        CHECK(bits(back[i]) == bits(miopen::half_bits_to_float(h[i])));
+    }
+}
+
+void check_half_to_float()
+{
+    const auto halves = all_halves();
+    std::vector<float> f(halves.size());
+    miopen::half_to_float(halves.data(), f.data(), halves.size());
+    for(auto h : halves)
+    {
+        const float x = miopen::half_bits_to_float(h);
+        CHECK(bits(f[h]) == bits(x));
+        if(is_nan_half(h))
+        {
+            CHECK(std::isnan(x));
+            CHECK(std::signbit(x) == ((h & 0x8000u) != 0));
+            // Quiet, with the payload in the upper mantissa bits
+            CHECK((bits(x) & 0x7fffffu) == ((h & 0x3ffu) << 13 | 0x400000u));
+        }
+        else if((h & 0x7fffu) == 0x7c00u)
+        {
+            CHECK(std::isinf(x));
+            CHECK(std::signbit(x) == ((h & 0x8000u) != 0));
+        }
+        else
+        {
+            CHECK(x == half_value(h));
+            CHECK(std::signbit(x) == ((h & 0x8000u) != 0));
+        }
+    }
+}
+
+void check_float_to_half()
+{
+    std::vector<float> inputs;
+    for(auto h : all_halves())
+    {
+        const float x = miopen::half_bits_to_float(h);
+        inputs.push_back(x);
+        if(is_nan_half(h))
+        {
+            CHECK(miopen::float_to_half_bits(x) == (h | 0x200u));
+            continue;
+        }
+        CHECK(miopen::float_to_half_bits(x) == h);
+
+        // Between every pair of neighbouring finite halves of the same sign
+        const std::uint16_t next = h + 1;
+        if((h & 0x7fffu) >= 0x7bffu)
+            continue;
+        const double mid = (half_value(h) + half_value(next)) / 2;
+        const auto m     = static_cast<float>(mid);
+        CHECK(m == mid);
+        const float below = std::nextafter(m, miopen::half_bits_to_float(h));
+        const float above = std::nextafter(m, miopen::half_bits_to_float(next));
+        CHECK(miopen::float_to_half_bits(m) == ((h & 1) == 0 ? h : next));
+        CHECK(miopen::float_to_half_bits(below) == h);
+        CHECK(miopen::float_to_half_bits(above) == next);
+        inputs.insert(inputs.end(), {m, below, above});
+    }
+
+    // Overflow rounds to infinity from halfway past the largest half
+    CHECK(miopen::float_to_half_bits(65519.996f) == 0x7bffu);
+    CHECK(miopen::float_to_half_bits(65520.0f) == 0x7c00u);
+    CHECK(miopen::float_to_half_bits(-65520.0f) == 0xfc00u);
+    CHECK(miopen::float_to_half_bits(1e30f) == 0x7c00u);
+    // Underflow rounds to zero up to half the smallest denormal
+    CHECK(miopen::float_to_half_bits(std::ldexp(1.0f, -25)) == 0);
+    CHECK(miopen::float_to_half_bits(std::nextafter(std::ldexp(1.0f, -25), 1.0f)) == 1);
+    CHECK(miopen::float_to_half_bits(-1e-30f) == 0x8000u);
+    CHECK(miopen::float_to_half_bits(from_bits(0x7f800001u)) == 0x7e00u);
+    CHECK(miopen::float_to_half_bits(from_bits(0xffc00000u)) == 0xfe00u);
+
+    check_bulk(inputs);
+}
+
+// Every 251st float covers all exponents and many mantissas of each.
+void check_float_sweep()
+{
+    std::vector<float> inputs;
+    inputs.reserve((std::uint64_t{1} << 32) / 251 + 1);
+    for(std::uint64_t f = 0; f < (std::uint64_t{1} << 32); f += 251)
+        inputs.push_back(from_bits(static_cast<std::uint32_t>(f)));
+    check_bulk(inputs);
+}
+
+void check_half_type()
+{
+    const std::vector<float> in = {0.0f, 1.0f, -2.5f, 65504.0f, 1.0f / 3.0f, 1e-7f};
+    std::vector<half_float::half> h(in.size());
+    miopen::float_to_half(in.data(), h.data(), in.size());
+    std::vector<float> out(in.size());
+    miopen::half_to_float(h.data(), out.data(), h.size());
+    for(std::size_t i = 0; i < in.size(); i++)
+        CHECK(out[i] == miopen::half_bits_to_float(miopen::float_to_half_bits(in[i])));
+
+    // Widening to double goes through float in chunks
+    const auto halves = all_halves();
+    std::vector<double> wide(halves.size());
+    miopen::convert_buffer(
+        reinterpret_cast<const half_float::half*>(halves.data()), wide.data(), halves.size());
+    for(auto h : halves)
+    {
+        if(is_nan_half(h))
+            CHECK(std::isnan(wide[h]));
+        else
+            CHECK(wide[h] == static_cast<double>(miopen::half_bits_to_float(h)));
+    }
+}
+
+int main()
+{
+    check_half_to_float();
+    check_float_to_half();
+    check_float_sweep();
+    check_half_type();
+}
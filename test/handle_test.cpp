@@ -31,6 +31,27 @@ void test_multithreads()
     run2s(h, 4);
 }
 
+void test_capture()
+{
+    auto&& h            = get_handle();
+    const std::size_t n = 16;
+    std::vector<int> data_in(n, 1);
+    auto captured = h.Write(data_in);
+    auto replayed = h.Write(data_in);
+
+    h.BeginCapture();
+    h.BindCaptureBuffer(0, captured.get());
+    h.AddKernel("GEMM", "", Write2s(), "write", {n, 1, 1}, {n, 1, 1}, "")(captured.get());
+    auto graph = h.EndCapture();
+    CHECK(!h.IsCapturing());
+    CHECK(graph.GetNodes().size() == 1);
+
+    graph.Replay({replayed.get()});
+    graph.Replay({replayed.get()});
+    CHECK(h.Read<int>(captured, n) == std::vector<int>(n, 2));
+    CHECK(h.Read<int>(replayed, n) == std::vector<int>(n, 4));
+}
+
 std::string WriteError() { return "__kernel void write(__global int* data) { data[i] = 0; }\n"; }
 
 void test_errors()
@@ -64,6 +85,7 @@ void test_warnings()
 int main()
 {
     test_multithreads();
+    test_capture();
     test_errors();
 // Warnings currently dont work in opencl
 #if !MIOPEN_BACKEND_OPENCL
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/errors.hpp>
+#include <miopen/kernel.hpp>
+#include <miopen/kernel_table.hpp>
+#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+const unsigned char ALPHA[] = "alpha";
+const unsigned char BETA[]  = "beta";
+const unsigned char BETA2[] = "beta2";
+
+constexpr miopen::KernelTableEntry table[] = {
+    {"ALPHA", ALPHA, 5}, {"BETA", BETA, 4}, {"BETA2", BETA2, 5},
+};
+static_assert(miopen::IsKernelTableSorted(table), "");
+
+constexpr miopen::KernelTableEntry unsorted[] = {
+    {"BETA", BETA, 4}, {"ALPHA", ALPHA, 5},
+};
+static_assert(!miopen::IsKernelTableSorted(unsorted), "");
+
+constexpr miopen::KernelTableEntry duplicated[] = {
+    {"ALPHA", ALPHA, 5}, {"ALPHA", ALPHA, 5},
+};
+static_assert(!miopen::IsKernelTableSorted(duplicated), "");
+
+std::string find(const std::string& name)
+{
+    auto it = miopen::FindKernel(std::begin(table), std::end(table), name);
+    return it == nullptr ? "<none>" : it->GetSource().to_string();
+}
+
+void check_lookup()
+{
+    CHECK(miopen::KernelBaseName("kernels/MIOpenSoftmax.cl") == "MIOpenSoftmax");
+    CHECK(miopen::KernelBaseName("a\\b.c\\Name.s") == "Name");
+    CHECK(miopen::KernelBaseName("dummy_kernel") == "dummy_kernel");
+
+    CHECK(find("alpha") == "alpha");
+    CHECK(find("Beta.cl") == "beta");
+    CHECK(find("some/dir/BETA2.so") == "beta2");
+    CHECK(find("bet") == "<none>");
+    CHECK(find("beta22") == "<none>");
+    CHECK(find("") == "<none>");
+    CHECK(find("zeta") == "<none>");
+}
+
+void check_embedded_kernels()
+{
+    auto view = miopen::GetKernelSrcView("MIOpenSoftmax.cl");
+    CHECK(!view.empty());
+    CHECK(view == miopen::GetKernelSrc("MIOpenSoftmax.cl"));
+    // Every lookup returns the same embedded data.
+    CHECK(miopen::GetKernelSrcView("miopensoftmax").data() == view.data());
+    CHECK(throws([] { miopen::GetKernelSrcView("NoSuchKernel.cl"); }));
+}
+
+// Compares against the previous registry, a map holding a copy of every source keyed by the
+// upper case name, which returned the source by value.
+void bench_lookup()
+{
+    const std::size_t count = 128;
+    const std::size_t size  = 64 * 1024;
+
+    std::vector<std::string> names;
+    std::vector<std::string> sources;
+    for(std::size_t i = 0; i < count; i++)
+    {
+        names.push_back("KERNEL" + std::to_string(1000 + i));
+        sources.push_back(std::string(size, static_cast<char>('a' + i % 26)));
+    }
+
+    std::vector<miopen::KernelTableEntry> entries;
+    for(std::size_t i = 0; i < count; i++)
+        entries.push_back({names[i].c_str(),
+                           reinterpret_cast<const unsigned char*>(sources[i].data()),
+                           sources[i].size()});
+
+    std::map<std::string, std::string> copies;
+    std::size_t copied_bytes = 0;
+    for(std::size_t i = 0; i < count; i++)
+    {
+        copies.emplace(names[i], sources[i]);
+        copied_bytes += sources[i].size();
+    }
+
+    std::vector<std::string> queries;
+    for(std::size_t i = 0; i < count; i++)
+        queries.push_back("kernels/Kernel" + std::to_string(1000 + (i * 37) % count) + ".cl");
+
+    const int iterations = 20;
+    std::size_t checksum = 0;
+    using clock          = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for(int k = 0; k < iterations; k++)
+    {
+        for(const auto& q : queries)
+        {
+            auto key = miopen::KernelBaseName(q).to_string();
+            std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+            std::string src = copies.find(key)->second;
+            checksum += src.size();
+        }
+    }
+    auto map_time = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    start = clock::now();
+    for(int k = 0; k < iterations; k++)
+    {
+        for(const auto& q : queries)
+        {
+            auto it = miopen::FindKernel(entries.data(), entries.data() + entries.size(), q);
+            checksum += it->GetSource().size();
+        }
+    }
+    auto table_time = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    CHECK(checksum == 2 * iterations * count * size);
+
+    const double lookups = iterations * count;
+    std::cout << "kernel source lookup: map " << map_time / lookups << " ns, table "
+              << table_time / lookups << " ns" << std::endl;
+    std::cout << "kernel source heap copies: map " << copied_bytes << " bytes, table 0 bytes"
+              << std::endl;
+}
+
+int main()
+{
+    check_lookup();
+    check_embedded_kernels();
+    bench_lookup();
+}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/kernel_timings.hpp>
+#include "test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+
+bool close_to(float x, float y, float rel)
+{
+    return std::abs(x - y) <= rel * std::max(std::abs(x), std::abs(y));
+}
+
+// Quantiles are reported to within half a bucket.
+const float tolerance = 1.0f / miopen::KernelTimingHistogram::sub_buckets;
+
+void check_empty()
+{
+    miopen::KernelTimings timings;
+    CHECK(timings.Empty());
+    auto s = timings.Get({"a", "b", "c"});
+    CHECK(s.count == 0);
+    CHECK(s.p99 == 0.0f);
+    CHECK(timings.GetAll().empty());
+}
+
+void check_single_value()
+{
+    miopen::KernelTimingHistogram h;
+    h.Add(0.123f);
+    auto s = h.GetStats();
+    EXPECT(s.count == 1);
+    // Clamped to [min, max], so a single sample is reported exactly.
+    CHECK(s.min == 0.123f);
+    CHECK(s.p50 == 0.123f);
+    CHECK(s.p99 == 0.123f);
+    CHECK(s.max == 0.123f);
+}
+
+void check_quantiles()
+{
+    std::vector<float> samples;
+    for(int i = 1; i <= 1000; i++)
+        samples.push_back(i * 0.01f);
+    std::shuffle(samples.begin(), samples.end(), std::mt19937{42});
+
+    miopen::KernelTimingHistogram h;
+    for(auto x : samples)
+        h.Add(x);
+
+    auto s = h.GetStats();
+    EXPECT(s.count == 1000);
+    CHECK(s.min == 0.01f);
+    CHECK(s.max == 10.0f);
+    CHECK(close_to(s.p50, 5.0f, tolerance));
+    CHECK(close_to(s.p99, 9.9f, tolerance));
+    CHECK(close_to(static_cast<float>(s.total), 5005.0f, 1e-4f));
+    CHECK(h.Quantile(0.0) == s.min);
+    CHECK(h.Quantile(1.0) == s.max);
+}
+
+void check_wide_range()
+{
+    // Samples spanning many orders of magnitude, including zero.
+    miopen::KernelTimingHistogram h;
+    std::vector<float> samples = {0.0f, 1e-6f, 1e-4f, 0.5f, 1.0f, 3.0f, 1e3f, 1e5f};
+    for(auto x : samples)
+        h.Add(x);
+    h.Add(-1.0f); // clamped to zero
+    h.Add(std::nanf(""));
+    EXPECT(h.Count() == samples.size() + 1);
+    CHECK(h.Min() == 0.0f);
+    CHECK(h.Max() == 1e5f);
+    // Sorted: 0, 0, 1e-6, 1e-4, 0.5, 1, 3, 1e3, 1e5
+    CHECK(h.Quantile(0.2) == 0.0f);
+    CHECK(close_to(h.Quantile(0.3), 1e-6f, tolerance));
+    CHECK(close_to(h.Quantile(0.4), 1e-4f, tolerance));
+    CHECK(close_to(h.Quantile(0.5), 0.5f, tolerance));
+    CHECK(close_to(h.Quantile(0.85), 1e3f, tolerance));
+}
+
+void check_keys_and_dump()
+{
+    miopen::KernelTimings timings;
+    const miopen::KernelTimingKey conv{"miopenConvolutionFwdAlgoDirect", "cfg0", "MIOpenConvUni"};
+    const miopen::KernelTimingKey bn{"miopenBatchNormalizationForwardInference", "cfg1", "BNFwd"};
+    const miopen::KernelTimingKey conv2{"miopenConvolutionFwdAlgoDirect", "cfg1", "MIOpenConvUni"};
+    for(int i = 0; i < 10; i++)
+    {
+        timings.Record(conv, 2.0f);
+        timings.Record(bn, 0.25f);
+    }
+    timings.Record(conv2, 1.0f);
+
+    CHECK(!timings.Empty());
+    CHECK(timings.Get(conv).count == 10);
+    CHECK(timings.Get(conv2).count == 1);
+    CHECK(timings.Get(bn).p50 == 0.25f);
+
+    auto all = timings.GetAll();
+    EXPECT(all.size() == 3);
+    CHECK(all[0].first == conv);
+    CHECK(all[1].first == bn);
+    CHECK(all[2].first == conv2);
+
+    std::ostringstream ss;
+    ss << timings;
+    const auto dump = ss.str();
+    CHECK(dump.find("MIOpenConvUni") != std::string::npos);
+    CHECK(dump.find("BNFwd") != std::string::npos);
+    CHECK(dump.find("cfg1") != std::string::npos);
+    CHECK(dump.find("MIOpenConvUni") < dump.find("BNFwd"));
+
+    timings.Clear();
+    CHECK(timings.Empty());
+}
+
+int main()
+{
+    check_empty();
+    check_single_value();
+    check_quantiles();
+    check_wide_range();
+    check_keys_and_dump();
+}
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/philox.hpp>
+#include <half.hpp>
+#include "tensor_holder.hpp"
+#include "test.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Known answers of Philox4x32-10 from the Random123 distribution.
+void check_known_answers()
+{
+    using block = miopen::philox4x32::block;
+    CHECK((miopen::philox4x32::generate({{0, 0, 0, 0}}, {{0, 0}}) ==
+           block{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+    CHECK((miopen::philox4x32::generate({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+                                        {{0xffffffff, 0xffffffff}}) ==
+           block{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+    CHECK((miopen::philox4x32::generate({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                                        {{0xa4093822, 0x299f31d0}}) ==
+           block{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+}
+
+// A parallel fill gives every element the value it has on its own.
+void check_parallel_fill()
+{
+    const miopen::random_stream rs{42, 3};
+    const std::size_t n = 100003;
+
+    std::vector<float> u(n);
+    miopen::fill_uniform(u.data(), n, -2.0, 3.0, rs);
+    std::vector<float> g(n);
+    miopen::fill_normal(g.data(), n, 1.0, 0.5, rs);
+    std::vector<half_float::half> h(n);
+    miopen::fill_uniform(h.data(), n, 0.0, 1.0, rs);
+
+    for(std::size_t i = 0; i < n; i++)
+    {
+        CHECK(u[i] == static_cast<float>(rs.uniform(i, -2.0, 3.0)));
+        CHECK(u[i] >= -2.0f && u[i] <= 3.0f);
+        CHECK(g[i] == static_cast<float>(1.0 + 0.5 * rs.normal(i)));
+        CHECK(h[i] == static_cast<half_float::half>(rs.uniform(i)));
+    }
+}
+
+void check_distribution()
+{
+    const std::size_t n = 200000;
+    std::vector<double> u(n);
+    miopen::fill_uniform(u.data(), n, 0.0, 1.0, {7, 0});
+    std::vector<double> g(n);
+    miopen::fill_normal(g.data(), n, 0.0, 1.0, {7, 0});
+
+    double u_sum = 0, g_sum = 0, g_sq = 0;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        CHECK(u[i] >= 0.0 && u[i] < 1.0);
+        u_sum += u[i];
+        g_sum += g[i];
+        g_sq += g[i] * g[i];
+    }
+    CHECK(std::abs(u_sum / n - 0.5) < 0.01);
+    CHECK(std::abs(g_sum / n) < 0.01);
+    CHECK(std::abs(g_sq / n - 1.0) < 0.02);
+}
+
+// Seeds and streams select unrelated sequences.
+void check_streams()
+{
+    const miopen::random_stream a{1, 0};
+    const miopen::random_stream b{1, 1};
+    const miopen::random_stream c{2, 0};
+    int same = 0;
+    for(std::uint64_t i = 0; i < 1000; i++)
+    {
+        same += a.bits(i) == b.bits(i);
+        same += a.bits(i) == c.bits(i);
+        same += a.bits(i) == a.bits(i + (std::uint64_t{1} << 32));
+    }
+    CHECK(same == 0);
+}
+
+// tensor::generate runs a pure generator in parallel and a stateful one serially. Both must
+// fill the tensor exactly as a serial loop over the elements does.
+void check_tensor_generate()
+{
+    const miopen::random_stream rs{7, 1};
+    const auto pure = [&](std::size_t n, std::size_t c, std::size_t h, std::size_t w) {
+        return rs.uniform(((n * 3 + c) * 5 + h) * 7 + w);
+    };
+    tensor<float> t{2, 3, 5, 7};
+    t.generate(pure);
+    std::vector<float> serial;
+    ford(2, 3, 5, 7)([&](auto n, auto c, auto h, auto w) {
+        serial.push_back(static_cast<float>(pure(n, c, h, w)));
+    });
+    CHECK(t.data == serial);
+
+    std::size_t counter = 0;
+    t.generate([=](std::size_t, std::size_t, std::size_t, std::size_t) mutable {
+        return counter++;
+    });
+    std::size_t mismatched = 0;
+    for(std::size_t i = 0; i < t.data.size(); i++)
+        mismatched += t.data[i] != static_cast<float>(i);
+    CHECK(mismatched == 0);
+}
+
+int main()
+{
+    check_known_answers();
+    check_parallel_fill();
+    check_distribution();
+    check_streams();
+    check_tensor_generate();
+}
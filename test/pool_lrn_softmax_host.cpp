@@ -0,0 +1,474 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "test.hpp"
+#include "../driver/mloNormHost.hpp"
+#include "../driver/mloPoolingHost.hpp"
+#include "../driver/mloSoftmaxHost.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+// Straightforward references: every output point computes its own window
+// sums, with the channel and spatial loops in the order of the definitions.
+
+std::vector<float> generate(std::size_t n)
+{
+    std::vector<float> v(n);
+    for(auto& x : v)
+        x = float(std::rand()) / RAND_MAX * 2.0f - 1.0f;
+    return v;
+}
+
+void check_close(const std::vector<double>& result, const std::vector<double>& ref, double tol)
+{
+    CHECK(result.size() == ref.size());
+    for(std::size_t i = 0; i < result.size(); i++)
+        CHECK(std::abs(result[i] - ref[i]) <= tol * (1.0 + std::abs(ref[i])));
+}
+
+struct shape
+{
+    int n, c, h, w;
+    std::size_t size() const { return std::size_t(n) * c * h * w; }
+    std::size_t index(int b, int ch, int j, int i) const
+    {
+        return ((std::size_t(b) * c + ch) * h + j) * w + i;
+    }
+};
+
+struct pool_case
+{
+    shape in;
+    int win_h, win_w, pad_h, pad_w, u, v;
+    int out_h() const { return (in.h + 2 * pad_h - win_h) / u + 1; }
+    int out_w() const { return (in.w + 2 * pad_w - win_w) / v + 1; }
+    shape out() const { return {in.n, in.c, out_h(), out_w()}; }
+};
+
+void check_pooling(const pool_case& p, int method)
+{
+    const shape out = p.out();
+    const auto x    = generate(p.in.size());
+    const auto dy   = generate(out.size());
+
+    std::vector<double> ref(out.size());
+    std::vector<size_t> ref_mask(out.size(), 0);
+    std::vector<double> ref_dx(p.in.size(), 0.0);
+    for(int b = 0; b < out.n; b++)
+        for(int o = 0; o < out.c; o++)
+            for(int j = 0; j < out.h; j++)
+                for(int i = 0; i < out.w; i++)
+                {
+                    const int hs = std::max(j * p.u - p.pad_h, 0);
+                    const int ws = std::max(i * p.v - p.pad_w, 0);
+                    const int he = std::min(j * p.u - p.pad_h + p.win_h, p.in.h);
+                    const int we = std::min(i * p.v - p.pad_w + p.win_w, p.in.w);
+                    double res   = method == MLO_POOLING_OP_MAX ? -3.402823466e+38 : 0.0;
+                    size_t arg   = std::numeric_limits<size_t>::max();
+                    for(int h = hs; h < he; h++)
+                        for(int w = ws; w < we; w++)
+                        {
+                            const double val = x[p.in.index(b, o, h, w)];
+                            if(method == MLO_POOLING_OP_AVE)
+                                res += val;
+                            else if(val > res)
+                            {
+                                res = val;
+                                arg = p.in.index(b, o, h, w);
+                            }
+                        }
+                    const int area = std::max((he - hs) * (we - ws), 1);
+                    const auto idx = out.index(b, o, j, i);
+                    if(method == MLO_POOLING_OP_MAX)
+                    {
+                        ref[idx]      = res;
+                        ref_mask[idx] = arg;
+                        if(arg != std::numeric_limits<size_t>::max())
+                            ref_dx[arg] += dy[idx];
+                    }
+                    else
+                    {
+                        ref[idx] = res / area;
+                        for(int h = hs; h < he; h++)
+                            for(int w = ws; w < we; w++)
+                                ref_dx[p.in.index(b, o, h, w)] += double(dy[idx]) / area;
+                    }
+                }
+
+    std::vector<double> top(out.size());
+    std::vector<size_t> mask(out.size(), 0);
+    std::vector<uint8_t> mask_index(out.size());
+    CHECK(mloPoolingForwardRunHost<float, double>(method,
+                                                  p.pad_h,
+                                                  p.u,
+                                                  p.win_h,
+                                                  p.pad_w,
+                                                  p.v,
+                                                  p.win_w,
+                                                  out.n,
+                                                  out.c,
+                                                  p.in.h,
+                                                  p.in.w,
+                                                  p.in.w,
+                                                  p.in.h * p.in.w,
+                                                  p.in.c * p.in.h * p.in.w,
+                                                  out.h,
+                                                  out.w,
+                                                  out.w,
+                                                  out.h * out.w,
+                                                  out.c * out.h * out.w,
+                                                  x.data(),
+                                                  top.data(),
+                                                  mask.data(),
+                                                  mask_index.data()) == 0);
+    CHECK(top == ref);
+    if(method == MLO_POOLING_OP_MAX)
+        CHECK(mask == ref_mask);
+
+    // The fused check accepts the reference and rejects a perturbed output
+    std::vector<float> gpu_top(ref.begin(), ref.end());
+    for(auto& t : gpu_top)
+        t = (t == -FLT_MAX) ? 0.0f : t;
+    auto verify = [&] {
+        return mloPoolingForwardRunHostAndVerify<float, double>(method,
+                                                                p.pad_h,
+                                                                p.u,
+                                                                p.win_h,
+                                                                p.pad_w,
+                                                                p.v,
+                                                                p.win_w,
+                                                                out.n,
+                                                                out.c,
+                                                                p.in.h,
+                                                                p.in.w,
+                                                                p.in.w,
+                                                                p.in.h * p.in.w,
+                                                                p.in.c * p.in.h * p.in.w,
+                                                                out.h,
+                                                                out.w,
+                                                                out.w,
+                                                                out.h * out.w,
+                                                                out.c * out.h * out.w,
+                                                                x.data(),
+                                                                gpu_top.data(),
+                                                                true,
+                                                                mask.data(),
+                                                                mask_index.data(),
+                                                                1e-6);
+    };
+    CHECK(verify());
+    gpu_top[gpu_top.size() / 2] += 1.0f;
+    CHECK(!verify());
+
+    // Average pooling gathers, max pooling accumulates into a zeroed buffer
+    std::vector<double> dx(p.in.size(), 0.0);
+    mloPoolingBackwardRunHost<float, double>(method,
+                                             p.win_h,
+                                             p.pad_h,
+                                             p.u,
+                                             p.win_w,
+                                             p.pad_w,
+                                             p.v,
+                                             dx.data(),
+                                             dy.data(),
+                                             mask.data(),
+                                             p.in.c * p.in.h * p.in.w,
+                                             p.in.h * p.in.w,
+                                             p.in.w,
+                                             p.in.w,
+                                             p.in.h,
+                                             out.c,
+                                             out.n,
+                                             out.c * out.h * out.w,
+                                             out.h * out.w,
+                                             out.w,
+                                             out.w,
+                                             out.h);
+    check_close(dx, ref_dx, 1e-12);
+}
+
+struct lrn_result
+{
+    std::vector<double> scale;
+    std::vector<double> top;
+};
+
+lrn_result naive_lrn_fwd(const shape& s,
+                         const std::vector<float>& x,
+                         bool across,
+                         int local_area,
+                         double alpha,
+                         double beta,
+                         double K)
+{
+    const int pre_pad = (local_area - 1) / 2;
+    const int pad     = local_area - pre_pad - 1;
+    lrn_result r{std::vector<double>(s.size()), std::vector<double>(s.size())};
+    for(int b = 0; b < s.n; b++)
+        for(int c = 0; c < s.c; c++)
+            for(int j = 0; j < s.h; j++)
+                for(int i = 0; i < s.w; i++)
+                {
+                    double sum = 0;
+                    double aoa = 0;
+                    if(across)
+                    {
+                        for(int k = std::max(c - pre_pad, 0); k <= std::min(c + pad, s.c - 1); k++)
+                            sum += double(x[s.index(b, k, j, i)]) * x[s.index(b, k, j, i)];
+                        aoa = alpha / local_area;
+                    }
+                    else
+                    {
+                        for(int h = std::max(j - pad, 0); h < std::min(j - pad + local_area, s.h);
+                            h++)
+                            for(int w = std::max(i - pad, 0);
+                                w < std::min(i - pad + local_area, s.w);
+                                w++)
+                                sum += double(x[s.index(b, c, h, w)]) * x[s.index(b, c, h, w)];
+                        const int area = (std::min(j - pad + local_area, s.h + pad) - (j - pad)) *
+                                         (std::min(i - pad + local_area, s.w + pad) - (i - pad));
+                        aoa = alpha / area;
+                    }
+                    const auto idx = s.index(b, c, j, i);
+                    r.scale[idx]   = K + sum * aoa;
+                    r.top[idx]     = x[idx] * std::pow(r.scale[idx], -beta);
+                }
+    return r;
+}
+
+std::vector<double> naive_lrn_bwd(const shape& s,
+                                  const std::vector<float>& x,
+                                  const std::vector<float>& y,
+                                  const std::vector<float>& dy,
+                                  const std::vector<float>& scale,
+                                  bool across,
+                                  int local_area,
+                                  double alpha,
+                                  double beta)
+{
+    const int pre_pad = (local_area - 1) / 2;
+    const int pad     = local_area - pre_pad - 1;
+    auto ratio        = [&](std::size_t idx) { return double(dy[idx]) * y[idx] / scale[idx]; };
+    std::vector<double> dx(s.size());
+    for(int b = 0; b < s.n; b++)
+        for(int c = 0; c < s.c; c++)
+            for(int j = 0; j < s.h; j++)
+                for(int i = 0; i < s.w; i++)
+                {
+                    double sum  = 0;
+                    double coef = 0;
+                    if(across)
+                    {
+                        for(int k = std::max(c - pre_pad, 0); k <= std::min(c + pad, s.c - 1); k++)
+                            sum += ratio(s.index(b, k, j, i));
+                        coef = 2.0 * alpha * beta / local_area;
+                    }
+                    else
+                    {
+                        for(int h = std::max(j - pad, 0); h < std::min(j - pad + local_area, s.h);
+                            h++)
+                            for(int w = std::max(i - pad, 0);
+                                w < std::min(i - pad + local_area, s.w);
+                                w++)
+                                sum += ratio(s.index(b, c, h, w));
+                        const int area = (std::min(j - pad + local_area, s.h + pad) - (j - pad)) *
+                                         (std::min(i - pad + local_area, s.w + pad) - (i - pad));
+                        coef = 2.0 * alpha * beta / area;
+                    }
+                    const auto idx = s.index(b, c, j, i);
+                    dx[idx] = dy[idx] * std::pow(double(scale[idx]), -beta) - coef * x[idx] * sum;
+                }
+    return dx;
+}
+
+void check_lrn(const shape& s, bool across, int local_area)
+{
+    const double alpha = 0.001;
+    const double beta  = 0.75;
+    const double K     = 1.0;
+    const int pre_pad  = (local_area - 1) / 2;
+    const int pad      = local_area - pre_pad - 1;
+    const int region   = across ? MLO_LRN_ACROSS_CHANNELS : MLO_LRN_WITHIN_CHANNEL;
+    const int hw       = s.h * s.w;
+    const int chw      = s.c * hw;
+
+    // Large inputs make the scale differ visibly from K
+    auto x = generate(s.size());
+    for(auto& v : x)
+        v *= 20.0f;
+    const auto ref = naive_lrn_fwd(s, x, across, local_area, alpha, beta, K);
+
+    lrn_result r{std::vector<double>(s.size()), std::vector<double>(s.size())};
+    mloLRNForwardRunHost<float, double>(true,
+                                        region,
+                                        pad,
+                                        local_area,
+                                        alpha / local_area,
+                                        alpha,
+                                        beta,
+                                        K,
+                                        s.n,
+                                        s.c,
+                                        s.c,
+                                        s.h,
+                                        s.w,
+                                        s.w,
+                                        hw,
+                                        chw,
+                                        s.h,
+                                        s.w,
+                                        s.w,
+                                        hw,
+                                        chw,
+                                        s.w,
+                                        hw,
+                                        chw,
+                                        x.data(),
+                                        r.scale.data(),
+                                        r.top.data());
+    check_close(r.scale, ref.scale, 1e-12);
+    check_close(r.top, ref.top, 1e-12);
+
+    const std::vector<float> y(ref.top.begin(), ref.top.end());
+    const std::vector<float> scale(ref.scale.begin(), ref.scale.end());
+    const auto dy     = generate(s.size());
+    const auto ref_dx = naive_lrn_bwd(s, x, y, dy, scale, across, local_area, alpha, beta);
+
+    std::vector<double> dx(s.size());
+    mloLRNBackwardRunHost<float, double>(region,
+                                         pad,
+                                         local_area,
+                                         alpha / local_area,
+                                         alpha,
+                                         beta,
+                                         K,
+                                         s.n,
+                                         s.c,
+                                         s.c,
+                                         s.h,
+                                         s.w,
+                                         s.w,
+                                         hw,
+                                         chw,
+                                         s.w,
+                                         hw,
+                                         chw,
+                                         s.h,
+                                         s.w,
+                                         s.w,
+                                         hw,
+                                         chw,
+                                         s.w,
+                                         hw,
+                                         chw,
+                                         s.w,
+                                         hw,
+                                         chw,
+                                         y.data(),
+                                         dy.data(),
+                                         scale.data(),
+                                         x.data(),
+                                         dx.data());
+    check_close(dx, ref_dx, 1e-12);
+}
+
+void check_softmax(const shape& s)
+{
+    const auto x  = generate(s.size());
+    const auto dy = generate(s.size());
+    const int hw  = s.h * s.w;
+
+    std::vector<double> ref(x.begin(), x.end());
+    for(int b = 0; b < s.n; b++)
+        for(int p = 0; p < hw; p++)
+        {
+            double m = -DBL_MAX;
+            for(int c = 0; c < s.c; c++)
+                m = std::max(ref[(b * s.c + c) * hw + p], m);
+            double sum = 0;
+            for(int c = 0; c < s.c; c++)
+                sum += (ref[(b * s.c + c) * hw + p] = std::exp(ref[(b * s.c + c) * hw + p] - m));
+            for(int c = 0; c < s.c; c++)
+                ref[(b * s.c + c) * hw + p] /= sum;
+        }
+
+    std::vector<double> y(x.begin(), x.end());
+    std::vector<double> channel_max(std::size_t(s.n) * hw, -DBL_MAX);
+    mloSoftmaxForwardRunHost<double>(s.n, s.c, s.h, s.w, channel_max.data(), y.data());
+    CHECK(y == ref);
+
+    const std::vector<float> yf(ref.begin(), ref.end());
+    std::vector<double> ref_dx(dy.begin(), dy.end());
+    for(int b = 0; b < s.n; b++)
+        for(int p = 0; p < hw; p++)
+        {
+            double dot = 0;
+            for(int c = 0; c < s.c; c++)
+                dot += double(yf[(b * s.c + c) * hw + p]) * ref_dx[(b * s.c + c) * hw + p];
+            for(int c = 0; c < s.c; c++)
+                ref_dx[(b * s.c + c) * hw + p] =
+                    yf[(b * s.c + c) * hw + p] * (ref_dx[(b * s.c + c) * hw + p] - dot);
+        }
+
+    std::vector<double> dx(dy.begin(), dy.end());
+    std::vector<float> yf_mutable = yf;
+    std::vector<double> channel_dot(std::size_t(s.n) * hw, 0.0);
+    mloSoftmaxBackwardRunHost<float, double>(
+        s.n, s.c, s.h, s.w, channel_dot.data(), yf_mutable.data(), dx.data());
+    CHECK(dx == ref_dx);
+}
+
+int main()
+{
+    // n, c, h, w, window, pad, stride: odd sizes, windows hanging over the
+    // padding, and strides larger than the window.
+    const std::vector<pool_case> pools = {{{1, 1, 1, 1}, 1, 1, 0, 0, 1, 1},
+                                          {{2, 3, 7, 9}, 3, 3, 1, 1, 1, 1},
+                                          {{3, 2, 8, 8}, 2, 2, 0, 0, 2, 2},
+                                          {{2, 4, 11, 6}, 3, 2, 1, 0, 2, 1},
+                                          {{1, 5, 9, 9}, 2, 2, 1, 1, 3, 3},
+                                          {{4, 3, 16, 17}, 5, 4, 2, 2, 2, 3}};
+    for(const auto& p : pools)
+        for(int method : {MLO_POOLING_OP_MAX, MLO_POOLING_OP_AVE})
+            check_pooling(p, method);
+
+    const std::vector<shape> shapes = {
+        {1, 1, 1, 1}, {2, 3, 5, 4}, {3, 8, 7, 9}, {2, 16, 12, 13}, {1, 2, 17, 3}};
+    for(const auto& s : shapes)
+    {
+        for(int local_area : {1, 2, 3, 5, 7})
+        {
+            check_lrn(s, true, local_area);
+            check_lrn(s, false, local_area);
+        }
+        check_softmax(s);
+    }
+    check_softmax({2, 10, 23, 29});
+}
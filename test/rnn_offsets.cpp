@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn_offsets.hpp>
+#include "test.hpp"
+
+#include <cstdint>
+#include <limits>
+
+// The offsets as rnnocl.cpp used to compute them, but in 64 bits
+struct reference_offsets
+{
+    std::uint64_t in_h, hy_h, bi, n_layers, batch_n, hy_n, hy_stride, wei_stride;
+
+    std::uint64_t hid_shift(std::uint64_t li) const { return li * batch_n * hy_stride; }
+    std::uint64_t hx_shift(std::uint64_t li) const { return li * hy_n * (hy_h * bi); }
+    std::uint64_t input_wei_shift(std::uint64_t li) const
+    {
+        return (in_h + hy_h) * wei_stride + (li - 1) * (bi * hy_h + hy_h) * wei_stride;
+    }
+    std::uint64_t hidden_wei_shift(std::uint64_t li) const
+    {
+        return in_h * wei_stride + li * (bi * hy_h + hy_h) * wei_stride;
+    }
+    std::uint64_t bias_shift(std::uint64_t li) const
+    {
+        return (in_h + hy_h + (bi * hy_h + hy_h) * (n_layers - 1)) * wei_stride +
+               li * 2 * wei_stride;
+    }
+};
+
+void check_against_reference(const miopen::RNNOffsets& o)
+{
+    const reference_offsets r{
+        o.in_h, o.hy_h, o.bi, o.n_layers, o.batch_n, o.hy_n, o.hy_stride, o.wei_stride};
+
+    CHECK(o.InputWeights(0) == 0);
+    for(std::size_t li = 0; li < o.n_layers; li++)
+    {
+        CHECK(o.Hidden(li) == r.hid_shift(li));
+        CHECK(o.Hidden(li, 3) == r.hid_shift(li) + 3 * r.hy_stride);
+        CHECK(o.HiddenState(li) == r.hx_shift(li));
+        CHECK(o.HiddenWeights(li) == r.hidden_wei_shift(li));
+        CHECK(o.Bias(li) == r.bias_shift(li));
+        if(li > 0)
+            CHECK(o.InputWeights(li) == r.input_wei_shift(li));
+
+        // The hidden weights of a layer follow its input weights, the next layer follows them
+        const std::size_t in_rows = li == 0 ? o.in_h : o.bi * o.hy_h;
+        CHECK(o.HiddenWeights(li) == o.InputWeights(li) + in_rows * o.wei_stride);
+        const std::size_t end = o.HiddenWeights(li) + o.hy_h * o.wei_stride;
+        CHECK(end == (li + 1 < o.n_layers ? o.InputWeights(li + 1) : o.Bias(0)));
+    }
+    CHECK(o.Hidden(o.n_layers) == r.hid_shift(r.n_layers));
+}
+
+// Layouts that rnnocl.cpp builds for the RNN, LSTM and GRU modes
+void check_small()
+{
+    for(std::size_t bi : {1, 2})
+        for(std::size_t gates : {1, 3, 4})
+            for(std::size_t n_layers : {1, 2, 5})
+                for(std::size_t in_h : {0, 7, 32})
+                {
+                    const std::size_t hy_h = 16;
+                    const miopen::RNNOffsets o(in_h,
+                                               hy_h,
+                                               bi,
+                                               n_layers,
+                                               /* batch_n */ 37,
+                                               /* hy_n */ 8,
+                                               /* hy_stride */ hy_h * bi * gates * 2,
+                                               /* wei_stride */ hy_h * bi * gates);
+                    check_against_reference(o);
+                }
+}
+
+// A bidirectional 4 layer LSTM with 2048 hidden units, 1000 time steps of a batch of 64
+// has 64000 workspace rows of 20480 elements per layer, over 5G elements in all
+void check_large()
+{
+    const std::size_t hy_h = 2048;
+    const std::size_t bi   = 2;
+    const miopen::RNNOffsets o(hy_h, hy_h, bi, 4, 64000, 64, hy_h * bi * 5, hy_h * bi * 4);
+    check_against_reference(o);
+
+    const std::size_t int_max = std::numeric_limits<int>::max();
+    CHECK(o.Hidden(1) == std::size_t(64000) * 20480);
+    CHECK(o.Hidden(1) < int_max);
+    CHECK(o.Hidden(2) > int_max);
+    CHECK(o.Hidden(3, 63999) == (std::size_t(3) * 64000 + 63999) * 20480);
+    CHECK(o.Hidden(4) > std::numeric_limits<unsigned>::max());
+
+    // 4 layers of 2048 + 4096 input rows and 2048 hidden rows, each 16384 wide
+    CHECK(o.HiddenWeights(3) == (std::size_t(2048) + 3 * 6144) * 16384);
+    CHECK(o.Bias(0) == (std::size_t(2048) + 2048 + 6144 * 3) * 16384);
+    CHECK(o.Bias(3) == o.Bias(0) + 6 * 16384);
+}
+
+int main()
+{
+    check_small();
+    check_large();
+}
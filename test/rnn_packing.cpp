@@ -0,0 +1,311 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/miopen.h>
+#include <miopen/rnn_packing.hpp>
+#include <miopen/util.hpp>
+#include "get_handle.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using miopen::RNNSequencePacking;
+
+// Packed row of step t in slot j, straight from the definition
+std::size_t packed_row(const RNNSequencePacking& p, int t, int slot)
+{
+    return std::accumulate(p.batches.begin(), p.batches.begin() + t, std::size_t{0}) + slot;
+}
+
+void check_layout(const std::vector<int>& lengths)
+{
+    const RNNSequencePacking p(lengths);
+    const int batch = lengths.size();
+
+    // Longest first, ties in caller order, and each step holds a prefix of the slots
+    std::vector<int> sorted(batch);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    CHECK(std::is_permutation(p.order.begin(), p.order.end(), sorted.begin()));
+    for(int j = 1; j < batch; j++)
+    {
+        const int a = p.order[j - 1];
+        const int b = p.order[j];
+        CHECK(lengths[a] > lengths[b] || (lengths[a] == lengths[b] && a < b));
+    }
+    CHECK(p.SeqLen() == *std::max_element(lengths.begin(), lengths.end()));
+    CHECK(std::is_sorted(p.batches.rbegin(), p.batches.rend()));
+    CHECK(p.PackedRows() == std::size_t(std::accumulate(lengths.begin(), lengths.end(), 0)));
+    for(int t = 0; t < p.SeqLen(); t++)
+        for(int j = 0; j < batch; j++)
+            CHECK((j < p.batches[t]) == (t < lengths[p.order[j]]));
+
+    // Sequences, with distinct values per row and column
+    const std::size_t width = 3;
+    std::vector<float> padded(p.SeqLen() * batch * width);
+    std::iota(padded.begin(), padded.end(), 1.0f);
+    std::vector<float> packed(p.PackedRows() * width, -1);
+    p.Pack(padded.data(), packed.data(), width);
+    for(int t = 0; t < p.SeqLen(); t++)
+        for(int j = 0; j < p.batches[t]; j++)
+            CHECK(std::equal(packed.begin() + packed_row(p, t, j) * width,
+                             packed.begin() + (packed_row(p, t, j) + 1) * width,
+                             padded.begin() + (t * batch + p.order[j]) * width));
+
+    std::vector<float> unpacked(padded.size(), 0);
+    p.Unpack(packed.data(), unpacked.data(), width);
+    for(int t = 0; t < p.SeqLen(); t++)
+        for(int b = 0; b < batch; b++)
+            for(std::size_t k = 0; k < width; k++)
+            {
+                const std::size_t i = (t * batch + b) * width + k;
+                CHECK(unpacked[i] == (t < lengths[b] ? padded[i] : 0));
+            }
+
+    // Hidden states, two layer slices
+    const std::size_t slices = 2;
+    std::vector<float> states(slices * batch * width);
+    std::iota(states.begin(), states.end(), 1.0f);
+    std::vector<float> packed_states(states.size(), -1);
+    p.PackStates(states.data(), packed_states.data(), slices, width);
+    for(std::size_t s = 0; s < slices; s++)
+        for(int j = 0; j < batch; j++)
+            for(std::size_t k = 0; k < width; k++)
+                CHECK(packed_states[(s * batch + j) * width + k] ==
+                      states[(s * batch + p.order[j]) * width + k]);
+    std::vector<float> unpacked_states(states.size(), -1);
+    p.UnpackStates(packed_states.data(), unpacked_states.data(), slices, width);
+    CHECK(unpacked_states == states);
+
+    // Runs never overlap and cover every row once
+    std::vector<int> covered(p.PackedRows(), 0);
+    for(const auto& r : p.sequence_runs)
+        for(std::size_t i = 0; i < r.rows; i++)
+            covered.at(r.packed + i)++;
+    CHECK(std::all_of(covered.begin(), covered.end(), [](int n) { return n == 1; }));
+}
+
+// The device copies gather and scatter the rows of every run in one kernel each, and must
+// match the host copies
+void check_device_copies(const std::vector<int>& lengths)
+{
+    const RNNSequencePacking p(lengths);
+    const int batch          = lengths.size();
+    const std::size_t width  = 5;
+    const std::size_t slices = 3;
+    auto&& handle            = get_handle();
+
+    std::vector<float> padded(p.SeqLen() * batch * width);
+    std::iota(padded.begin(), padded.end(), 1.0f);
+    std::vector<float> packed(p.PackedRows() * width, -1);
+    p.Pack(padded.data(), packed.data(), width);
+    std::vector<float> unpacked(padded.size(), 0);
+    p.Unpack(packed.data(), unpacked.data(), width);
+
+    const auto rows     = RNNSequencePacking::PaddedRows(p.sequence_runs);
+    const auto rows_dev = handle.Write(rows);
+    const auto in_dev   = handle.Write(padded);
+    auto packed_dev     = handle.Write(std::vector<float>(packed.size(), -1));
+    auto unpacked_dev   = handle.Write(std::vector<float>(padded.size(), 0));
+    miopen::CopyRowsGPU(handle,
+                        in_dev.get(),
+                        packed_dev.get(),
+                        rows_dev.get(),
+                        rows.size(),
+                        width,
+                        1,
+                        0,
+                        false,
+                        miopenFloat);
+    CHECK(handle.Read<float>(packed_dev, packed.size()) == packed);
+    miopen::CopyRowsGPU(handle,
+                        packed_dev.get(),
+                        unpacked_dev.get(),
+                        rows_dev.get(),
+                        rows.size(),
+                        width,
+                        1,
+                        0,
+                        true,
+                        miopenFloat);
+    CHECK(handle.Read<float>(unpacked_dev, unpacked.size()) == unpacked);
+
+    std::vector<float> states(slices * batch * width);
+    std::iota(states.begin(), states.end(), 1.0f);
+    std::vector<float> packed_states(states.size(), -1);
+    p.PackStates(states.data(), packed_states.data(), slices, width);
+
+    const auto state_rows     = RNNSequencePacking::PaddedRows(p.state_runs);
+    const auto state_rows_dev = handle.Write(state_rows);
+    const auto states_dev     = handle.Write(states);
+    auto packed_states_dev    = handle.Write(std::vector<float>(states.size(), -1));
+    auto unpacked_states_dev  = handle.Write(std::vector<float>(states.size(), -1));
+    miopen::CopyRowsGPU(handle,
+                        states_dev.get(),
+                        packed_states_dev.get(),
+                        state_rows_dev.get(),
+                        state_rows.size(),
+                        width,
+                        slices,
+                        batch,
+                        false,
+                        miopenFloat);
+    CHECK(handle.Read<float>(packed_states_dev, states.size()) == packed_states);
+    miopen::CopyRowsGPU(handle,
+                        packed_states_dev.get(),
+                        unpacked_states_dev.get(),
+                        state_rows_dev.get(),
+                        state_rows.size(),
+                        width,
+                        slices,
+                        batch,
+                        true,
+                        miopenFloat);
+    CHECK(handle.Read<float>(unpacked_states_dev, states.size()) == states);
+}
+
+// The unsorted entry points reject a batch they cannot read before touching it
+void check_bad_parms()
+{
+    miopenHandle_t handle;
+    miopenRNNDescriptor_t rnn;
+    miopenTensorDescriptor_t x;
+    miopenCreate(&handle);
+    miopenCreateRNNDescriptor(&rnn);
+    miopenCreateTensorDescriptor(&x);
+    miopenSetRNNDescriptor(rnn,
+                           4,
+                           1,
+                           miopenRNNlinear,
+                           miopenRNNunidirection,
+                           miopenRNNRELU,
+                           miopenRNNNoBias,
+                           miopenRNNdefault,
+                           miopenFloat);
+    int lens[]    = {2, 3};
+    int strides[] = {3, 1};
+    miopenSetTensorDescriptor(x, miopenFloat, 2, lens, strides);
+    const miopenTensorDescriptor_t xs[] = {x, x};
+    const int lengths[]                 = {2, 1};
+    std::size_t size                    = 0;
+    CHECK(miopenGetRNNUnsortedWorkspaceSize(handle, rnn, 2, xs, lengths, &size) ==
+          miopenStatusSuccess);
+    for(int seq_len : {0, -1})
+        CHECK(miopenGetRNNUnsortedWorkspaceSize(handle, rnn, seq_len, &x, lengths, &size) ==
+              miopenStatusBadParm);
+    CHECK(miopenGetRNNUnsortedWorkspaceSize(handle, rnn, 1, nullptr, lengths, &size) ==
+          miopenStatusBadParm);
+    CHECK(miopenGetRNNUnsortedWorkspaceSize(handle, rnn, 1, &x, nullptr, &size) ==
+          miopenStatusBadParm);
+    CHECK(miopenRNNForwardInferenceUnsorted(handle,
+                                            rnn,
+                                            0,
+                                            &x,
+                                            lengths,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            0) == miopenStatusBadParm);
+    CHECK(miopenRNNForwardInferenceUnsorted(handle,
+                                            rnn,
+                                            1,
+                                            &x,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr,
+                                            0) == miopenStatusBadParm);
+    miopenDestroyTensorDescriptor(x);
+    miopenDestroyRNNDescriptor(rnn);
+    miopenDestroy(handle);
+}
+
+void check_runs()
+{
+    // Already sorted: the first two steps are one run, the states need no permutation
+    const RNNSequencePacking sorted({3, 3, 2, 1});
+    CHECK(sorted.batches == std::vector<int>{4, 3, 2});
+    CHECK(sorted.IsSorted());
+    CHECK(!sorted.IsPacked());
+    CHECK(sorted.sequence_runs.size() == 2);
+    CHECK(sorted.sequence_runs[0].rows == 7);
+    CHECK(sorted.sequence_runs[1].packed == 7 && sorted.sequence_runs[1].padded == 8);
+
+    // Equal lengths: the padded layout is the packed one
+    const RNNSequencePacking full({5, 5, 5});
+    CHECK(full.IsPacked());
+    CHECK(full.sequence_runs.size() == 1 && full.sequence_runs[0].rows == 15);
+
+    // Unsorted: slots follow the lengths, runs follow the samples that stay adjacent
+    const RNNSequencePacking unsorted({1, 4, 4, 2});
+    CHECK(unsorted.order == std::vector<int>{1, 2, 3, 0});
+    CHECK(unsorted.batches == std::vector<int>{4, 3, 2, 2});
+    CHECK(!unsorted.IsSorted());
+    CHECK(unsorted.state_runs.size() == 2);
+}
+
+int main()
+{
+    check_runs();
+    check_bad_parms();
+    CHECK(throws([] { RNNSequencePacking({}); }));
+    CHECK(throws([] { RNNSequencePacking({3, 0, 2}); }));
+
+    std::mt19937 gen(42);
+    for(int batch : {1, 2, 5, 16})
+        for(int max_len : {1, 3, 9})
+            for(int i = 0; i < 4; i++)
+            {
+                std::uniform_int_distribution<int> len(1, max_len);
+                std::vector<int> lengths(batch);
+                std::generate(lengths.begin(), lengths.end(), [&] { return len(gen); });
+                check_layout(lengths);
+                check_device_copies(lengths);
+            }
+}
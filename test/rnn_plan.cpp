@@ -0,0 +1,179 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "rnn_plan_host.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+bool close(double a, double b, double tolerance)
+{
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+bool all_close(const std::vector<double>& a, const std::vector<double>& b, double tolerance)
+{
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [&](double x, double y) {
+               return close(x, y, tolerance);
+           });
+}
+
+// Both forward plans produce the reference y, hy and cy
+void check_forward(const rnn_case& rc)
+{
+    std::mt19937 gen(rc.layers * 131 + rc.mode);
+    host_buffers ref = rc.buffers(gen);
+    rc.forward(ref);
+
+    const auto hx = rc.with_hx ? RNNPlan::hx : RNNPlan::x;
+    const auto cx = rc.with_hx ? RNNPlan::cx : RNNPlan::x;
+    for(auto pass : {RNNPlanShape::forward_inference, RNNPlanShape::forward_training})
+    {
+        const auto plan =
+            RNNPlan::Build(rc.shape(pass, {RNNPlan::x, hx, cx, RNNPlan::hy, RNNPlan::cy}));
+        CHECK(!plan.ops.empty());
+
+        host_buffers mem = ref;
+        std::fill(mem[RNNPlan::y].begin(), mem[RNNPlan::y].end(), 7.0);
+        std::fill(mem[RNNPlan::hy].begin(), mem[RNNPlan::hy].end(), 7.0);
+        std::fill(mem[RNNPlan::cy].begin(), mem[RNNPlan::cy].end(), 7.0);
+        host_executor exec{mem};
+        exec.run(plan);
+
+        CHECK(exec.in_bounds);
+        CHECK(all_close(mem[RNNPlan::y], ref[RNNPlan::y], 1e-9));
+        CHECK(all_close(mem[RNNPlan::hy], ref[RNNPlan::hy], 1e-9));
+        if(rc.mode == miopenLSTM)
+            CHECK(all_close(mem[RNNPlan::cy], ref[RNNPlan::cy], 1e-9));
+    }
+}
+
+// The backward plans produce the gradient of rnn_case::loss, checked by central differences
+void check_backward(const rnn_case& rc)
+{
+    std::mt19937 gen(rc.layers * 17 + rc.mode);
+    host_buffers mem = rc.buffers(gen);
+
+    host_executor exec{mem};
+    exec.run(RNNPlan::Build(rc.shape(
+        RNNPlanShape::forward_training,
+        {RNNPlan::x, RNNPlan::hx, RNNPlan::cx, RNNPlan::hy, RNNPlan::cy})));
+    exec.run(RNNPlan::Build(rc.shape(RNNPlanShape::backward_data,
+                                     {RNNPlan::dy,
+                                      RNNPlan::dhy,
+                                      RNNPlan::dcy,
+                                      RNNPlan::hx,
+                                      RNNPlan::cx,
+                                      RNNPlan::dhx,
+                                      RNNPlan::dcx})));
+    exec.run(RNNPlan::Build(
+        rc.shape(RNNPlanShape::backward_weights, {RNNPlan::x, RNNPlan::hx, RNNPlan::dy})));
+    CHECK(exec.in_bounds);
+
+    auto check_gradient = [&](RNNPlan::Buffer in, RNNPlan::Buffer grad) {
+        const double eps = 1e-5;
+        for(std::size_t i = 0; i < mem[in].size(); i++)
+        {
+            host_buffers plus = mem, minus = mem;
+            plus[in][i] += eps;
+            minus[in][i] -= eps;
+            const double numeric = (rc.loss(plus) - rc.loss(minus)) / (2 * eps);
+            if(!close(mem[grad][i], numeric, 1e-6))
+            {
+                std::cerr << "gradient " << in << "[" << i << "]: " << mem[grad][i] << " vs "
+                          << numeric << std::endl;
+                CHECK(false);
+                return;
+            }
+        }
+    };
+    if(!rc.skip)
+        check_gradient(RNNPlan::x, RNNPlan::dx);
+    check_gradient(RNNPlan::hx, RNNPlan::dhx);
+    if(rc.mode == miopenLSTM)
+        check_gradient(RNNPlan::cx, RNNPlan::dcx);
+    check_gradient(RNNPlan::w, RNNPlan::dw);
+}
+
+void check_cache()
+{
+    const rnn_case rc{miopenLSTM, true, false, true, 2, 4, 3, {3, 2, 2}, true};
+    const auto shape = rc.shape(RNNPlanShape::forward_inference, {RNNPlan::x, RNNPlan::hx});
+
+    miopen::RNNPlanCache cache;
+    const auto plan = cache.Get(shape);
+    CHECK(plan == cache.Get(shape));
+    CHECK(cache.Size() == 1);
+
+    // A different batch profile or a missing optional buffer is a different plan
+    auto other    = shape;
+    other.batches = {3, 3, 1};
+    CHECK(cache.Get(other) != plan);
+    auto no_hx = shape;
+    no_hx.given.reset(RNNPlan::hx);
+    CHECK(cache.Get(no_hx) != plan);
+    CHECK(cache.Size() == 3);
+    CHECK(cache.Get(shape) == plan);
+
+    // The least recently used plan goes first
+    for(int n = 1; n <= static_cast<int>(miopen::RNNPlanCache::capacity); n++)
+    {
+        other.batches = {n};
+        cache.Get(other);
+    }
+    CHECK(cache.Size() == miopen::RNNPlanCache::capacity);
+    CHECK(cache.Get(shape) != plan);
+}
+
+rnn_case with_batches(rnn_case rc, std::vector<int> batches)
+{
+    rc.batches = std::move(batches);
+    return rc;
+}
+
+int main()
+{
+    for(auto mode : {miopenRNNRELU, miopenRNNTANH, miopenLSTM, miopenGRU})
+        for(bool bidirectional : {false, true})
+            for(bool skip : {false, true})
+                for(int layers : {1, 2})
+                {
+                    // Skip mode needs in_h == hy_h
+                    const int in_h = skip ? 3 : 4;
+                    const rnn_case rc{mode, bidirectional, skip, true, layers, in_h, 3, {}, true};
+                    check_forward(with_batches(rc, {4, 3, 3, 1}));
+                    check_backward(with_batches(rc, {3, 2, 1}));
+
+                    // Without hx the first step has no hidden bias, so compare without biases
+                    auto no_hx    = with_batches(rc, {2, 2});
+                    no_hx.bias    = false;
+                    no_hx.with_hx = false;
+                    check_forward(no_hx);
+                }
+    check_cache();
+}
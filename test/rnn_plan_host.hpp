@@ -0,0 +1,366 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_TEST_RNN_PLAN_HOST_HPP
+#define GUARD_MIOPEN_TEST_RNN_PLAN_HOST_HPP
+
+#include <miopen/rnn_plan.hpp>
+#include <miopen/rnn_offsets.hpp>
+#include "test.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using miopen::RNNPlan;
+using miopen::RNNPlanShape;
+using miopen::TensorDescriptor;
+
+using host_buffers = std::array<std::vector<double>, RNNPlan::buffer_count>;
+
+// Replays a plan on host buffers. Every element an operation touches must lie inside its buffer.
+struct host_executor
+{
+    host_buffers& mem;
+    bool in_bounds = true;
+    double spill   = 0;
+
+    double& at(const RNNPlan::Operand& o, std::size_t i)
+    {
+        auto& buffer = mem[o.buffer];
+        if(o.offset + i >= buffer.size())
+        {
+            in_bounds = false;
+            return spill;
+        }
+        return buffer[o.offset + i];
+    }
+
+    using position = std::array<std::size_t, 3>;
+
+    // Calls f(position) for every element of a 3-d tensor
+    template <class F>
+    static void for_each(const TensorDescriptor& desc, F f)
+    {
+        const auto& lens = desc.GetLengths();
+        position pos{};
+        for(pos[0] = 0; pos[0] < lens[0]; pos[0]++)
+            for(pos[1] = 0; pos[1] < lens[1]; pos[1]++)
+                for(pos[2] = 0; pos[2] < lens[2]; pos[2]++)
+                    f(pos);
+    }
+
+    // Element of an operand at a position, broadcast over its unit lengths
+    double& at(const RNNPlan::Operand& o, const position& pos)
+    {
+        std::size_t i = 0;
+        for(std::size_t d = 0; d < pos.size(); d++)
+            i += (o.desc.GetLengths()[d] == 1 ? 0 : pos[d]) * o.desc.GetStrides()[d];
+        return at(o, i);
+    }
+
+    static double activ(const miopen::ActivationDescriptor& a, double x)
+    {
+        switch(a.GetMode())
+        {
+        case miopenActivationLOGISTIC: return 1 / (1 + std::exp(-x));
+        case miopenActivationTANH: return a.GetAlpha() * std::tanh(a.GetBeta() * x);
+        case miopenActivationRELU: return std::max(x, 0.0);
+        default: CHECK(false); return 0;
+        }
+    }
+
+    // Derivative from the activation output y and input x
+    static double activ_grad(const miopen::ActivationDescriptor& a, double y, double x)
+    {
+        switch(a.GetMode())
+        {
+        case miopenActivationLOGISTIC: return y * (1 - y);
+        case miopenActivationTANH:
+            return a.GetBeta() * (a.GetAlpha() - y * y / a.GetAlpha());
+        case miopenActivationRELU: return x > 0 ? 1 : 0;
+        default: CHECK(false); return 0;
+        }
+    }
+
+    void gemm(const RNNPlan::Op& op)
+    {
+        const auto& g = op.gemm_desc;
+        CHECK(!g.isColMajor && g.batch_count == 1);
+        for(int m = 0; m < g.m; m++)
+            for(int n = 0; n < g.n; n++)
+            {
+                double sum = 0;
+                for(int k = 0; k < g.k; k++)
+                    sum += at(op.a, g.transA ? k * g.lda + m : m * g.lda + k) *
+                           at(op.b, g.transB ? n * g.ldb + k : k * g.ldb + n);
+                double& c = at(op.c, m * g.ldc + n);
+                c         = g.alpha * sum + g.beta * c;
+            }
+    }
+
+    void run(const RNNPlan::Op& op)
+    {
+        switch(op.kind)
+        {
+        case RNNPlan::set:
+            for_each(op.c.desc, [&](auto pos) { at(op.c, pos) = op.beta; });
+            break;
+        case RNNPlan::gemm: gemm(op); break;
+        case RNNPlan::tensor_op:
+            CHECK(op.tensor_op == miopenTensorOpAdd || op.tensor_op == miopenTensorOpMul);
+            for_each(op.c.desc, [&](auto pos) {
+                const double a = op.alpha0 * at(op.a, pos);
+                const double b = op.alpha1 * at(op.b, pos);
+                const double r = op.tensor_op == miopenTensorOpAdd ? a + b : a * b;
+                at(op.c, pos)  = r + op.beta * at(op.c, pos);
+            });
+            break;
+        case RNNPlan::copy:
+            for_each(op.c.desc, [&](auto pos) { at(op.c, pos) = at(op.a, pos); });
+            break;
+        case RNNPlan::activation_forward:
+            for_each(op.c.desc, [&](auto pos) {
+                const double y = activ(op.activ_desc, at(op.a, pos));
+                at(op.c, pos)  = op.alpha0 * y + op.beta * at(op.c, pos);
+            });
+            break;
+        case RNNPlan::activation_backward:
+            // a = y, b = dy, c = x, d = dx
+            for_each(op.d.desc, [&](auto pos) {
+                const double dy = at(op.b, pos) *
+                                  activ_grad(op.activ_desc, at(op.a, pos), at(op.c, pos));
+                at(op.d, pos) = op.alpha0 * dy + op.beta * at(op.d, pos);
+            });
+            break;
+        }
+    }
+
+    void run(const RNNPlan& plan)
+    {
+        for(const auto& op : plan.ops)
+            run(op);
+    }
+};
+
+struct rnn_case
+{
+    miopenRNNMode_t mode;
+    bool bidirectional;
+    bool skip;
+    bool bias;
+    int layers;
+    int in_h;
+    int hy_h;
+    std::vector<int> batches;
+    bool with_hx;
+
+    int bi() const { return bidirectional ? 2 : 1; }
+    int gates() const { return mode == miopenLSTM ? 4 : mode == miopenGRU ? 3 : 1; }
+    int scale() const { return mode == miopenLSTM ? 6 : mode == miopenGRU ? 4 : 1; }
+    int wei_len() const { return gates() * hy_h; }
+    int batch_n() const { return std::accumulate(batches.begin(), batches.end(), 0); }
+    int input_width(int li) const { return li == 0 ? in_h : bi() * hy_h; }
+
+    miopen::RNNOffsets offsets() const
+    {
+        return {std::size_t(skip ? 0 : in_h),
+                std::size_t(hy_h),
+                std::size_t(bi()),
+                std::size_t(layers),
+                std::size_t(batch_n()),
+                std::size_t(batches[0]),
+                std::size_t(hy_h * bi() * scale()),
+                std::size_t(bi() * wei_len())};
+    }
+
+    std::size_t weights() const
+    {
+        const std::size_t in_w = skip ? 0 : in_h;
+        std::size_t n = gates() * hy_h * bi() * (in_w + hy_h + (layers - 1) * (bi() + 1) * hy_h);
+        return bias ? n + layers * 2 * gates() * hy_h * bi() : n;
+    }
+
+    std::size_t states() const { return layers * bi() * batches[0] * hy_h; }
+    std::size_t workspace() const { return scale() * layers * batch_n() * hy_h * bi(); }
+
+    // What RNNDescriptor::PlanShape and the RNN calls put together
+    RNNPlanShape shape(RNNPlanShape::Pass pass, std::initializer_list<RNNPlan::Buffer> given) const
+    {
+        RNNPlanShape s{};
+        s.pass               = pass;
+        s.rnn_mode           = mode;
+        s.input_mode         = skip ? miopenRNNskip : miopenRNNlinear;
+        s.dir_mode           = bidirectional ? miopenRNNbidirection : miopenRNNunidirection;
+        s.bias_mode          = bias ? miopenRNNwithBias : miopenRNNNoBias;
+        s.n_layers           = layers;
+        s.hidden_tensors     = gates();
+        s.workspace_scale    = scale();
+        s.data_type          = miopenFloat;
+        s.batches            = batches;
+        s.in_h               = in_h;
+        s.hy_d               = layers * bi();
+        s.hy_n               = batches[0];
+        s.hy_h               = hy_h;
+        s.out_h              = bi() * hy_h;
+        s.workspace_elements = workspace();
+        s.reserve_elements   = 2 * workspace();
+        s.dw_elements        = weights();
+        for(auto b : given)
+            s.given.set(b);
+        return s;
+    }
+
+    host_buffers buffers(std::mt19937& gen) const
+    {
+        std::uniform_real_distribution<double> dist(-0.5, 0.5);
+        auto random = [&](std::size_t n) {
+            std::vector<double> v(n);
+            std::generate(v.begin(), v.end(), [&] { return dist(gen); });
+            return v;
+        };
+        const std::size_t x_size = batch_n() * in_h;
+        const std::size_t y_size = batch_n() * bi() * hy_h;
+
+        host_buffers mem;
+        mem[RNNPlan::x]            = random(x_size);
+        mem[RNNPlan::hx]           = random(states());
+        mem[RNNPlan::cx]           = random(states());
+        mem[RNNPlan::w]            = random(weights());
+        mem[RNNPlan::dy]           = random(y_size);
+        mem[RNNPlan::dhy]          = random(states());
+        mem[RNNPlan::dcy]          = random(states());
+        mem[RNNPlan::y]            = std::vector<double>(y_size);
+        mem[RNNPlan::hy]           = std::vector<double>(states());
+        mem[RNNPlan::cy]           = std::vector<double>(states());
+        mem[RNNPlan::dx]           = std::vector<double>(x_size);
+        mem[RNNPlan::dhx]          = std::vector<double>(states());
+        mem[RNNPlan::dcx]          = std::vector<double>(states());
+        mem[RNNPlan::dw]           = std::vector<double>(weights());
+        mem[RNNPlan::workSpace]    = std::vector<double>(workspace());
+        mem[RNNPlan::reserveSpace] = std::vector<double>(2 * workspace());
+        return mem;
+    }
+
+    // Textbook recurrence over the MIOpen weight layout, one sequence at a time
+    void forward(host_buffers& mem) const
+    {
+        const auto o      = offsets();
+        const auto& w     = mem[RNNPlan::w];
+        const int wei_len = this->wei_len();
+        const std::size_t wei_stride = bi() * wei_len;
+        auto sigmoid      = [](double v) { return 1 / (1 + std::exp(-v)); };
+
+        std::vector<int> row0(batches.size(), 0);
+        std::partial_sum(batches.begin(), batches.end() - 1, row0.begin() + 1);
+
+        std::vector<double> in(mem[RNNPlan::x]), out;
+        for(int li = 0; li < layers; li++)
+        {
+            const int width = input_width(li);
+            out.assign(batch_n() * bi() * hy_h, 0);
+            for(int ri = 0; ri < bi(); ri++)
+                for(int b = 0; b < batches[0]; b++)
+                {
+                    const int len = std::count_if(
+                        batches.begin(), batches.end(), [&](int n) { return n > b; });
+                    const std::size_t state = ((li * bi() + ri) * batches[0] + b) * hy_h;
+                    std::vector<double> h(hy_h, 0), c(hy_h, 0);
+                    if(with_hx)
+                    {
+                        std::copy_n(mem[RNNPlan::hx].begin() + state, hy_h, h.begin());
+                        std::copy_n(mem[RNNPlan::cx].begin() + state, hy_h, c.begin());
+                    }
+                    for(int step = 0; step < len; step++)
+                    {
+                        const int t   = ri == 0 ? step : len - 1 - step;
+                        const int row = row0[t] + b;
+                        std::vector<double> gx(wei_len), gh(wei_len);
+                        for(int g = 0; g < wei_len; g++)
+                        {
+                            if(li == 0 && skip)
+                                gx[g] = in[row * width + g % hy_h];
+                            for(int k = 0; k < width && !(li == 0 && skip); k++)
+                                gx[g] += w[o.InputWeights(li) + (ri * wei_len + g) * width + k] *
+                                         in[row * width + k];
+                            for(int k = 0; k < hy_h; k++)
+                                gh[g] += w[o.HiddenWeights(li) + (ri * wei_len + g) * hy_h + k] *
+                                         h[k];
+                            if(bias)
+                            {
+                                gx[g] += w[o.Bias(li) + ri * wei_len + g];
+                                gh[g] += w[o.Bias(li) + wei_stride + ri * wei_len + g];
+                            }
+                        }
+                        for(int j = 0; j < hy_h; j++)
+                        {
+                            if(mode == miopenRNNTANH)
+                                h[j] = std::tanh(gx[j] + gh[j]);
+                            else if(mode == miopenRNNRELU)
+                                h[j] = std::max(gx[j] + gh[j], 0.0);
+                            else if(mode == miopenLSTM)
+                            {
+                                const double i = sigmoid(gx[j] + gh[j]);
+                                const double f = sigmoid(gx[hy_h + j] + gh[hy_h + j]);
+                                const double u = sigmoid(gx[2 * hy_h + j] + gh[2 * hy_h + j]);
+                                const double n = std::tanh(gx[3 * hy_h + j] + gh[3 * hy_h + j]);
+                                c[j]           = i * n + f * c[j];
+                                h[j]           = u * std::tanh(c[j]);
+                            }
+                            else
+                            {
+                                const double z = sigmoid(gx[j] + gh[j]);
+                                const double r = sigmoid(gx[hy_h + j] + gh[hy_h + j]);
+                                const double n =
+                                    std::tanh(gx[2 * hy_h + j] + r * gh[2 * hy_h + j]);
+                                h[j] = (1 - z) * n + z * h[j];
+                            }
+                            out[row * bi() * hy_h + ri * hy_h + j] = h[j];
+                        }
+                    }
+                    std::copy(h.begin(), h.end(), mem[RNNPlan::hy].begin() + state);
+                    std::copy(c.begin(), c.end(), mem[RNNPlan::cy].begin() + state);
+                }
+            in = out;
+        }
+        mem[RNNPlan::y] = out;
+    }
+
+    // The value whose gradient the backward passes compute for the given dy, dhy and dcy
+    double loss(host_buffers mem) const
+    {
+        forward(mem);
+        auto dot = [&](RNNPlan::Buffer a, RNNPlan::Buffer b) {
+            return std::inner_product(mem[a].begin(), mem[a].end(), mem[b].begin(), 0.0);
+        };
+        double l = dot(RNNPlan::y, RNNPlan::dy) + dot(RNNPlan::hy, RNNPlan::dhy);
+        return mode == miopenLSTM ? l + dot(RNNPlan::cy, RNNPlan::dcy) : l;
+    }
+};
+
+#endif // GUARD_MIOPEN_TEST_RNN_PLAN_HOST_HPP
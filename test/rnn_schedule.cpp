@@ -0,0 +1,211 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn_schedule.hpp>
+#include "rnn_plan_host.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+using miopen::RNNSchedule;
+
+// Simulated queues that run their commands in order, with the queues progressing in random
+// order relative to each other
+struct mock_queues : miopen::RNNScheduleExecutor
+{
+    struct command
+    {
+        bool wait;
+        std::size_t op;
+    };
+
+    std::vector<std::deque<command>> queues;
+
+    explicit mock_queues(std::size_t n) : queues(n) {}
+
+    void Enqueue(std::size_t queue, std::size_t op) override
+    {
+        queues.at(queue).push_back({false, op});
+    }
+
+    void Wait(std::size_t queue, std::size_t op) override
+    {
+        queues.at(queue).push_back({true, op});
+    }
+
+    // The order the operations complete in; stops early if every queue is blocked
+    std::vector<std::size_t> drain(std::mt19937& gen, std::size_t ops)
+    {
+        std::vector<bool> done(ops, false);
+        std::vector<std::size_t> order;
+        for(;;)
+        {
+            std::vector<std::size_t> runnable;
+            for(std::size_t q = 0; q < queues.size(); q++)
+            {
+                if(!queues[q].empty() && (!queues[q].front().wait || done[queues[q].front().op]))
+                    runnable.push_back(q);
+            }
+            if(runnable.empty())
+                return order;
+            auto& queue = queues[runnable[gen() % runnable.size()]];
+            const auto c = queue.front();
+            queue.pop_front();
+            if(!c.wait)
+            {
+                done[c.op] = true;
+                order.push_back(c.op);
+            }
+        }
+    }
+};
+
+rnn_case make_case(miopenRNNMode_t mode, bool bidirectional, int layers, std::vector<int> batches)
+{
+    return {mode, bidirectional, false, true, layers, 4, 3, std::move(batches), true};
+}
+
+// Scheduled on any number of queues, in any order the queues may complete it, the plan
+// computes what it computes in order
+void check_schedule(const rnn_case& rc, RNNPlanShape::Pass pass)
+{
+    const auto shape = rc.shape(pass,
+                                {RNNPlan::x,
+                                 RNNPlan::hx,
+                                 RNNPlan::cx,
+                                 RNNPlan::hy,
+                                 RNNPlan::cy,
+                                 RNNPlan::dy,
+                                 RNNPlan::dhy,
+                                 RNNPlan::dcy,
+                                 RNNPlan::dhx,
+                                 RNNPlan::dcx});
+    const auto plan = RNNPlan::Build(shape);
+
+    std::mt19937 gen(rc.layers * 7 + pass);
+    host_buffers input = rc.buffers(gen);
+    std::generate(input[RNNPlan::reserveSpace].begin(),
+                  input[RNNPlan::reserveSpace].end(),
+                  [&] { return std::uniform_real_distribution<double>(-0.5, 0.5)(gen); });
+    host_buffers expected = input;
+    host_executor{expected}.run(plan);
+
+    for(std::size_t queues : {1, 2, 4})
+    {
+        const auto schedule = RNNSchedule::Build(plan, shape, queues);
+        const auto& ops     = schedule.plan.ops;
+        CHECK(ops.size() >= plan.ops.size());
+        CHECK(schedule.steps.size() == ops.size());
+
+        // Every operation is issued once, after the operations it depends on
+        std::vector<std::size_t> issued(ops.size(), ops.size());
+        for(std::size_t s = 0; s < schedule.steps.size(); s++)
+        {
+            const auto& step = schedule.steps[s];
+            CHECK(step.queue < queues);
+            CHECK(issued[step.op] == ops.size());
+            issued[step.op] = s;
+            for(auto d : schedule.dependencies[step.op])
+                CHECK(issued[d] < s);
+        }
+
+        for(int trial = 0; trial < 3; trial++)
+        {
+            mock_queues mock(queues);
+            schedule.Dispatch(mock);
+            const auto order = mock.drain(gen, ops.size());
+            CHECK(order.size() == ops.size());
+
+            std::vector<bool> done(ops.size(), false);
+            host_buffers mem = input;
+            host_executor exec{mem};
+            for(auto op : order)
+            {
+                for(auto d : schedule.dependencies[op])
+                    CHECK(done[d]);
+                done[op] = true;
+                exec.run(ops[op]);
+            }
+            CHECK(exec.in_bounds);
+            CHECK(mem == expected);
+        }
+    }
+}
+
+// Layers overlap along the wavefront, and so do the two directions of a layer
+void check_wavefront()
+{
+    const auto deep = make_case(miopenRNNTANH, false, 3, std::vector<int>(8, 4));
+    const auto deep_shape =
+        deep.shape(RNNPlanShape::forward_inference, {RNNPlan::x, RNNPlan::hx, RNNPlan::hy});
+    const auto deep_plan = RNNPlan::Build(deep_shape);
+    const double serial  = RNNSchedule::Build(deep_plan, deep_shape, 1).makespan;
+    CHECK(RNNSchedule::Build(deep_plan, deep_shape, 3).makespan < 0.7 * serial);
+
+    const auto wide = make_case(miopenLSTM, true, 1, std::vector<int>(8, 4));
+    const auto wide_shape =
+        wide.shape(RNNPlanShape::forward_inference, {RNNPlan::x, RNNPlan::hx, RNNPlan::cx});
+    const auto wide_plan = RNNPlan::Build(wide_shape);
+    CHECK(RNNSchedule::Build(wide_plan, wide_shape, 2).makespan <
+          0.8 * RNNSchedule::Build(wide_plan, wide_shape, 1).makespan);
+
+    // Time steps of the input GEMM are separate operations
+    CHECK(miopen::SplitTimeSteps(deep_plan, deep_shape).ops.size() > deep_plan.ops.size());
+}
+
+// The cached plans carry the schedule their Run spreads over the queues
+void check_cache()
+{
+    const auto rc    = make_case(miopenGRU, true, 2, {3, 2, 2, 1});
+    const auto shape = rc.shape(RNNPlanShape::forward_training, {RNNPlan::x, RNNPlan::hy});
+    miopen::RNNPlanCache cache;
+    const auto plan   = cache.Get(shape);
+    const auto queues = miopen::RNNQueueCount();
+    CHECK(queues >= 1);
+    if(queues == 1)
+    {
+        CHECK(plan->schedule == nullptr);
+        return;
+    }
+    CHECK(plan->schedule != nullptr);
+    CHECK(plan->schedule->queue_count == queues);
+    CHECK(plan->schedule->steps.size() == plan->schedule->plan.ops.size());
+}
+
+int main()
+{
+    for(auto mode : {miopenRNNRELU, miopenRNNTANH, miopenLSTM, miopenGRU})
+        for(bool bidirectional : {false, true})
+            for(int layers : {1, 2})
+                for(auto pass : {RNNPlanShape::forward_inference,
+                                 RNNPlanShape::forward_training,
+                                 RNNPlanShape::backward_data,
+                                 RNNPlanShape::backward_weights})
+                    check_schedule(make_case(mode, bidirectional, layers, {3, 2, 2, 1}), pass);
+    check_wavefront();
+    check_cache();
+}
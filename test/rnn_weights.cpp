@@ -0,0 +1,223 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/rnn.hpp>
+#include <miopen/rnn_weights.hpp>
+#include "rnn_plan_host.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using miopen::RNNWeightLayout;
+
+RNNWeightLayout layout(const rnn_case& rc)
+{
+    return {std::size_t(rc.skip ? 0 : rc.in_h),
+            std::size_t(rc.hy_h),
+            std::size_t(rc.bi()),
+            std::size_t(rc.layers),
+            std::size_t(rc.gates()),
+            rc.bias};
+}
+
+miopen::RNNDescriptor descriptor(const rnn_case& rc, miopenRNNWeightLayout_t weight_layout)
+{
+    miopen::RNNDescriptor desc(rc.hy_h,
+                               rc.layers,
+                               rc.mode,
+                               rc.skip ? miopenRNNskip : miopenRNNlinear,
+                               rc.bidirectional ? miopenRNNbidirection : miopenRNNunidirection,
+                               rc.bias ? miopenRNNwithBias : miopenRNNNoBias,
+                               miopenRNNdefault,
+                               miopenFloat);
+    desc.weightLayout = weight_layout;
+    return desc;
+}
+
+// The blocks tile the weights of the canonical layout, and pack into a transpose of each
+void check_layout(const rnn_case& rc)
+{
+    const auto l = layout(rc);
+    const auto o = rc.offsets();
+    CHECK(l.size == rc.weights());
+    CHECK(l.bias_offset == o.Bias(0));
+
+    std::size_t end = 0;
+    for(const auto& b : l.blocks)
+    {
+        CHECK(b.offset == end);
+        CHECK(b.rows == std::size_t(rc.bi() * rc.wei_len()));
+        end = b.offset + b.rows * b.columns;
+    }
+    CHECK(end == l.bias_offset);
+    CHECK(l.blocks.size() == std::size_t(rc.skip ? 2 * rc.layers - 1 : 2 * rc.layers));
+    CHECK(l.Find(l.bias_offset) == nullptr);
+    CHECK(l.Find(l.size) == nullptr);
+
+    std::vector<float> canonical(l.size), packed(l.size, -1), unpacked(l.size, -1);
+    std::iota(canonical.begin(), canonical.end(), 0.0f);
+    l.Pack(canonical.data(), packed.data());
+    l.Unpack(packed.data(), unpacked.data());
+    CHECK(unpacked == canonical);
+
+    for(std::size_t i = 0; i < l.size; i++)
+    {
+        const auto* b = l.Find(i);
+        CHECK(b != nullptr || i >= l.bias_offset);
+        CHECK(packed[b == nullptr ? i : RNNWeightLayout::Packed(*b, i)] == canonical[i]);
+    }
+}
+
+// Every parameter matrix lies in one block, and its packed view reads the canonical matrix
+void check_params(const rnn_case& rc)
+{
+    const auto l = layout(rc);
+    auto canonical_desc = descriptor(rc, miopenRNNWeightsCanonical);
+    auto packed_desc    = descriptor(rc, miopenRNNWeightsPacked);
+    const auto x_desc =
+        TensorDescriptor(miopenFloat, {std::size_t(rc.batches[0]), std::size_t(rc.in_h)});
+    CHECK(canonical_desc.WeightLayout(x_desc).blocks.size() == l.blocks.size());
+
+    std::vector<float> canonical(l.size), packed(l.size);
+    std::iota(canonical.begin(), canonical.end(), 0.0f);
+    l.Pack(canonical.data(), packed.data());
+
+    for(int layer = 0; layer < rc.layers * rc.bi(); layer++)
+        for(int param = 0; param < 2 * rc.gates(); param++)
+        {
+            const bool input_layer = layer < rc.bi();
+            if(rc.skip && input_layer && param < rc.gates())
+            {
+                CHECK(throws([&] {
+                    TensorDescriptor desc;
+                    std::size_t offset = 0;
+                    packed_desc.GetLayerParamOffset(layer, x_desc, param, desc, &offset);
+                }));
+                continue;
+            }
+
+            const auto dims   = canonical_desc.pTensorLengthsCalculation(x_desc, layer, param);
+            const auto offset = canonical_desc.paramsOffsetCalculation(x_desc, layer, param);
+            const auto* b     = l.Find(offset);
+            CHECK(b != nullptr);
+            CHECK(b == l.Find(offset + dims[0] * dims[1] - 1));
+            CHECK(b->columns == std::size_t(dims[1]));
+
+            TensorDescriptor view;
+            std::size_t packed_offset = 0;
+            packed_desc.GetLayerParamOffset(layer, x_desc, param, view, &packed_offset);
+            CHECK(view.GetLengths() == TensorDescriptor(miopenFloat, dims).GetLengths());
+            for(int i = 0; i < dims[0]; i++)
+                for(int j = 0; j < dims[1]; j++)
+                    CHECK(packed[packed_offset + view.GetIndex(i, j)] ==
+                          canonical[offset + i * dims[1] + j]);
+        }
+}
+
+// The plans for packed weights compute exactly what the canonical plans compute, and produce
+// the weight gradients in the packed layout
+void check_plans(const rnn_case& rc)
+{
+    const auto l = layout(rc);
+    std::mt19937 gen(rc.layers * 29 + rc.mode);
+    host_buffers canonical = rc.buffers(gen);
+    host_buffers packed    = canonical;
+    l.Pack(canonical[RNNPlan::w].data(), packed[RNNPlan::w].data());
+
+    auto run = [&](RNNPlanShape::Pass pass, std::initializer_list<RNNPlan::Buffer> given) {
+        auto shape          = rc.shape(pass, given);
+        const auto expected = RNNPlan::Build(shape);
+        shape.weight_layout = miopenRNNWeightsPacked;
+        const auto plan     = RNNPlan::Build(shape);
+        CHECK(plan.ops.size() == expected.ops.size());
+
+        host_executor canonical_exec{canonical};
+        host_executor packed_exec{packed};
+        canonical_exec.run(expected);
+        packed_exec.run(plan);
+        CHECK(canonical_exec.in_bounds);
+        CHECK(packed_exec.in_bounds);
+    };
+    run(RNNPlanShape::forward_inference, {RNNPlan::x, RNNPlan::hx, RNNPlan::cx});
+    run(RNNPlanShape::forward_training,
+        {RNNPlan::x, RNNPlan::hx, RNNPlan::cx, RNNPlan::hy, RNNPlan::cy});
+    run(RNNPlanShape::backward_data,
+        {RNNPlan::dy,
+         RNNPlan::dhy,
+         RNNPlan::dcy,
+         RNNPlan::hx,
+         RNNPlan::cx,
+         RNNPlan::dhx,
+         RNNPlan::dcx});
+    run(RNNPlanShape::backward_weights, {RNNPlan::x, RNNPlan::hx, RNNPlan::dy});
+
+    std::vector<double> dw(l.size);
+    l.Unpack(packed[RNNPlan::dw].data(), dw.data());
+    CHECK(dw == canonical[RNNPlan::dw]);
+
+    // Every other buffer is bitwise the same
+    packed[RNNPlan::w]  = canonical[RNNPlan::w];
+    packed[RNNPlan::dw] = dw;
+    CHECK(packed == canonical);
+}
+
+void check_cache()
+{
+    const rnn_case rc{miopenGRU, false, false, true, 2, 4, 3, {3, 2}, true};
+    auto shape = rc.shape(RNNPlanShape::forward_inference, {RNNPlan::x, RNNPlan::hx});
+
+    miopen::RNNPlanCache cache;
+    const auto plan     = cache.Get(shape);
+    shape.weight_layout = miopenRNNWeightsPacked;
+    CHECK(!(shape == rc.shape(RNNPlanShape::forward_inference, {RNNPlan::x, RNNPlan::hx})));
+    CHECK(cache.Get(shape) != plan);
+    CHECK(cache.Size() == 2);
+}
+
+rnn_case with_batches(rnn_case rc, std::vector<int> batches)
+{
+    rc.batches = std::move(batches);
+    return rc;
+}
+
+int main()
+{
+    for(auto mode : {miopenRNNRELU, miopenRNNTANH, miopenLSTM, miopenGRU})
+        for(bool bidirectional : {false, true})
+            for(bool skip : {false, true})
+                for(bool bias : {false, true})
+                    for(int layers : {1, 3})
+                    {
+                        const int in_h = skip ? 3 : 5;
+                        const rnn_case rc{
+                            mode, bidirectional, skip, bias, layers, in_h, 3, {}, true};
+                        check_layout(with_batches(rc, {2, 2, 1}));
+                        check_params(with_batches(rc, {2, 2, 1}));
+                        check_plans(with_batches(rc, {3, 2, 2, 1}));
+                    }
+    check_cache();
+}
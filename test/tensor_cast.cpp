@@ -179,8 +179,8 @@ struct tensor_cast_driver : test_driver
         srcSuper = tensor<int>{srcSuperLens}.generate(tensor_elem_gen_integer{max_value});
         dstSuper = tensor<T>{dstSuperLens}.generate(tensor_elem_gen_integer{max_value});
 
-        std::vector<size_t> srcSuperStrides = srcSuper.desc.GetStrides();
-        std::vector<size_t> dstSuperStrides = dstSuper.desc.GetStrides();
+        const auto& srcSuperStrides = srcSuper.desc.GetStrides();
+        const auto& dstSuperStrides = dstSuper.desc.GetStrides();
         std::vector<int> src_super_strides(srcSuperStrides.begin() +
                                                (srcSuper.desc.GetSize() - castLens.size()),
                                            srcSuperStrides.end());
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/tensor.hpp>
+#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+// The descriptor as it used to be: heap allocated dims, everything recomputed on access.
+struct reference_descriptor
+{
+    std::vector<std::size_t> lens;
+    std::vector<std::size_t> strides;
+
+    std::size_t GetElementSize() const
+    {
+        return std::accumulate(
+            lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+    }
+
+    std::size_t GetElementSpace() const
+    {
+        std::vector<std::size_t> maxIndices(lens.size());
+        std::transform(lens.begin(),
+                       lens.end(),
+                       std::vector<std::size_t>(lens.size(), 1).begin(),
+                       maxIndices.begin(),
+                       std::minus<std::size_t>());
+        return std::inner_product(
+                   maxIndices.begin(), maxIndices.end(), strides.begin(), std::size_t{0}) +
+               1;
+    }
+};
+
+void check_descriptor(const miopen::TensorDescriptor& desc)
+{
+    const auto& lens    = desc.GetLengths();
+    const auto& strides = desc.GetStrides();
+    reference_descriptor ref{{lens.begin(), lens.end()}, {strides.begin(), strides.end()}};
+    CHECK(desc.GetElementSize() == ref.GetElementSize());
+    CHECK(desc.GetElementSpace() == ref.GetElementSpace());
+    CHECK(desc.GetNumBytes() == ref.GetElementSpace() * miopen::GetTypeSize(desc.GetType()));
+    CHECK(desc.IsPacked() == (ref.GetElementSize() == ref.GetElementSpace()));
+
+    miopen::TensorDescriptor copy(desc.GetType(), ref.lens, ref.strides);
+    CHECK(copy == desc);
+    CHECK(copy.GetHash() == desc.GetHash());
+}
+
+void check_cached_values()
+{
+    check_descriptor({});
+    check_descriptor({miopenFloat, {100}});
+    check_descriptor({miopenHalf, {16, 3, 224, 224}});
+    check_descriptor({miopenFloat, {16, 3, 224, 224}, {200000, 60000, 250, 1}});
+    check_descriptor({miopenFloat, {2, 3, 4, 5, 6}});
+    check_descriptor({miopenInt8, {2, 3, 4, 5, 6, 7, 8}}); // more dims than stored inline
+    CHECK(miopen::TensorDescriptor(miopenFloat, {2, 3, 4, 5, 6, 7, 8}).GetStrides().front() ==
+          3 * 4 * 5 * 6 * 7 * 8);
+    check_descriptor({miopenFloat, {4, 0, 3}});
+
+    miopen::TensorDescriptor a{miopenFloat, {8, 16, 32, 32}};
+    miopen::TensorDescriptor b{miopenHalf, {8, 16, 32, 32}};
+    miopen::TensorDescriptor c{miopenFloat, {8, 16, 32, 32}, {16 * 32 * 33, 32 * 33, 33, 1}};
+    CHECK(a != b);
+    CHECK(a != c);
+    CHECK(a.GetHash() != b.GetHash());
+    CHECK(a.GetHash() != c.GetHash());
+    CHECK(!c.IsPacked());
+
+    std::unordered_map<miopen::TensorDescriptor, int, miopen::TensorDescriptorHash> m;
+    m[a] = 1;
+    m[b] = 2;
+    m[c] = 3;
+    CHECK(m.at(miopen::TensorDescriptor{miopenFloat, {8, 16, 32, 32}}) == 1);
+    CHECK(m.size() == 3);
+}
+
+template <class F>
+double time_ns(F f, std::size_t n)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < n; i++)
+        f(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+// Not a pass/fail check: reports the cost of the calls made for every tensor argument of an
+// API call (construct, copy, size queries and comparison).
+void bench_descriptor_paths()
+{
+    const std::size_t n = 200000;
+    volatile std::size_t sink = 0;
+    const std::vector<std::size_t> lens    = {32, 64, 56, 56};
+    const std::vector<std::size_t> strides = {64 * 56 * 56, 56 * 56, 56, 1};
+
+    auto ref = time_ns(
+        [&](std::size_t i) {
+            reference_descriptor d{lens, strides};
+            d.lens[0]  = 32 + (i & 1);
+            auto other = d;
+            sink       = sink + d.GetElementSize() + d.GetElementSpace() + other.GetElementSpace() +
+                   (d.lens == other.lens ? 1 : 0);
+        },
+        n);
+
+    auto cur = time_ns(
+        [&](std::size_t i) {
+            miopen::TensorDescriptor d{miopenFloat, {32 + (i & 1), 64, 56, 56}, strides};
+            auto other = d;
+            sink = sink + d.GetElementSize() + d.GetElementSpace() + other.GetElementSpace() +
+                   (d == other ? 1 : 0);
+        },
+        n);
+
+    std::cout << "descriptor construct/copy/query: reference " << ref << " ns, TensorDescriptor "
+              << cur << " ns" << std::endl;
+}
+
+int main()
+{
+    check_cached_values();
+    bench_descriptor_paths();
+}
@@ -30,11 +30,13 @@
 #include "network_data.hpp"
 #include <miopen/tensor.hpp>
 #include <miopen/functional.hpp>
+#include <miopen/rank.hpp>
 #include <miopen/type_name.hpp>
 
 #include <half.hpp>
 #include <iomanip>
 #include <fstream>
+#include <tuple>
 
 template <class F>
 void visit_tensor_size(std::size_t n, F f)
@@ -150,17 +152,40 @@ struct tensor
         return std::move(*this);
     }
 
+    template <class G, class... Ts>
+    static auto const_call(miopen::rank<1>, const G& g, const std::tuple<Ts...>&)
+        -> decltype(g(std::declval<std::decay_t<Ts>>()...), std::true_type{});
+
+    template <class G, class Tuple>
+    static std::false_type const_call(miopen::rank<0>, const G&, const Tuple&);
+
+    // A generator that can be called through a const reference is taken to be a function of
+    // the element index and runs on the thread pool. Any other generator keeps state between
+    // calls, so it is called serially in iteration order. Either way every element gets the
+    // value of a serial fill.
     template <class G>
     void generate_impl(G g)
     {
-        auto iterator = data.begin();
-        auto assign   = [&](T x) {
-            assert(iterator < data.end());
-            *iterator = x;
-            ++iterator;
+        const auto& lens = desc.GetLengths();
+        auto assign      = [&](auto... xs) -> decltype(g(xs...), void()) {
+            const std::array<std::size_t, sizeof...(xs)> index = {
+                {static_cast<std::size_t>(xs)...}};
+            std::size_t i = 0;
+            for(std::size_t d = 0; d < index.size(); d++)
+                i = i * lens[d] + index[d];
+            assert(i < data.size());
+            data[i] = miopen::cast_to<T>()(g(xs...));
         };
-        this->for_each(
-            miopen::compose(miopen::compose(assign, miopen::cast_to<T>()), std::move(g)));
+        visit_tensor_size(lens.size(), [&](auto size) {
+            const auto dims = miopen::tien<size>(lens);
+            const bool pure = decltype(const_call(miopen::rank<1>{}, g, dims)){};
+            using par_loop = for_each_unpacked<ford_wrapper<par_ford_impl>, decltype(assign)>;
+            using loop     = for_each_unpacked<ford_wrapper<ford_impl>, decltype(assign)>;
+            if(pure)
+                miopen::unpack(par_loop{par_ford, assign}, dims);
+            else
+                miopen::unpack(loop{ford, assign}, dims);
+        });
     }
 
     template <class Loop, class F>
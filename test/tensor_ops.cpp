@@ -94,8 +94,8 @@ struct verify_tensor_ops
     static void tensor_for_loop(const tensor<T>& aten,
                                 const tensor<T>& bten,
                                 tensor<T>& cten,
-                                const std::vector<size_t>& a_dims,
-                                const std::vector<size_t>& b_dims,
+                                const miopen::TensorDims& a_dims,
+                                const miopen::TensorDims& b_dims,
                                 float palpha0,
                                 float palpha1,
                                 float pbeta,
@@ -310,7 +310,7 @@ struct tensor_ops_driver : test_driver
     {
         if(!isPacked)
         {
-            std::vector<size_t> superStrides = super_tensor.desc.GetStrides();
+            const auto& superStrides = super_tensor.desc.GetStrides();
             std::vector<int> strides(superStrides.begin() + (5 - lens.size()), superStrides.end());
             tensor<T> t = tensor<T>{lens, strides};
             t.data      = super_tensor.data;
@@ -126,7 +126,7 @@ struct tensor_set_driver : test_driver
 
         super = tensor<T>{superLens}.generate(tensor_elem_gen_integer{max_value});
 
-        std::vector<size_t> superStrides = super.desc.GetStrides();
+        const auto& superStrides = super.desc.GetStrides();
         std::vector<int> subStrides(superStrides.begin() + (super.desc.GetSize() - subLens.size()),
                                     superStrides.end());
 
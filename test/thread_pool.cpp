@@ -0,0 +1,225 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "ford.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// par_for as it was before the pool: fresh threads on every call, each given
+// an equal contiguous chunk.
+template <class F>
+void spawn_par_for(std::size_t threads, std::size_t n, std::size_t min_grain, F f)
+{
+    const std::size_t threadsize = std::min<std::size_t>(threads, n / min_grain);
+    if(threadsize <= 1)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+    std::vector<joinable_thread> workers;
+    const std::size_t grainsize = std::ceil(static_cast<double>(n) / threadsize);
+    for(std::size_t work = 0; work < n; work += grainsize)
+    {
+        workers.emplace_back([=] {
+            for(std::size_t i = work; i < std::min(n, work + grainsize); i++)
+                f(i);
+        });
+    }
+}
+
+// The shared pool has a single thread on a single core machine, so the
+// stealing paths are also exercised on a pool of their own.
+void check_pool(miopen::thread_pool& pool)
+{
+    for(std::size_t n : {1, 7, 100, 12345})
+    {
+        std::vector<std::atomic<int>> visits(n);
+        for(auto& v : visits)
+            v = 0;
+        pool.parallel_for(n, 1, [&](std::size_t i) { visits[i]++; });
+        for(auto& v : visits)
+            CHECK(v == 1);
+    }
+
+    std::atomic<std::size_t> sum{0};
+    pool.parallel_for(64, 1, [&](std::size_t i) {
+        pool.parallel_for(100, 1, [&](std::size_t j) { sum += i * 100 + j; });
+    });
+    CHECK(sum == 6400 * 6399 / 2);
+
+    CHECK(throws([&] {
+        pool.parallel_for(1000, 1, [&](std::size_t i) {
+            if(i % 100 == 3)
+                throw std::runtime_error("failed");
+        });
+    }));
+
+    sum = 0;
+    {
+        std::vector<joinable_thread> callers;
+        for(int t = 0; t < 4; t++)
+            callers.emplace_back(
+                [&] { pool.parallel_for(10000, 1, [&](std::size_t i) { sum += i; }); });
+    }
+    CHECK(sum == 4 * (10000 * 9999 / 2));
+}
+
+void check_coverage()
+{
+    for(std::size_t n : {0, 1, 7, 8, 9, 100, 1000, 12345})
+    {
+        for(std::size_t grain : {1, 8, 64})
+        {
+            std::vector<std::atomic<int>> visits(n);
+            for(auto& v : visits)
+                v = 0;
+            par_for(n, grain, [&](std::size_t i) { visits[i]++; });
+            for(auto& v : visits)
+                CHECK(v == 1);
+        }
+    }
+}
+
+void check_ford()
+{
+    std::vector<std::atomic<int>> visits(3 * 5 * 7);
+    for(auto& v : visits)
+        v = 0;
+    par_ford(3, 5, 7)([&](int i, int j, int k) { visits[(i * 5 + j) * 7 + k]++; });
+    for(auto& v : visits)
+        CHECK(v == 1);
+}
+
+void check_nested()
+{
+    std::atomic<std::size_t> sum{0};
+    par_for(64, 1, [&](std::size_t i) {
+        par_for(100, 1, [&](std::size_t j) { sum += i * 100 + j; });
+    });
+    CHECK(sum == 6400 * 6399 / 2);
+}
+
+void check_exception()
+{
+    std::atomic<int> calls{0};
+    CHECK(throws([&] {
+        par_for(1000, 1, [&](std::size_t i) {
+            calls++;
+            if(i == 500)
+                throw std::runtime_error("failed");
+        });
+    }));
+    CHECK(calls <= 1000);
+
+    // The pool must still be usable afterwards
+    std::atomic<int> after{0};
+    par_for(1000, 1, [&](std::size_t) { after++; });
+    CHECK(after == 1000);
+}
+
+void check_concurrent_callers()
+{
+    std::atomic<std::size_t> sum{0};
+    {
+        std::vector<joinable_thread> callers;
+        for(int t = 0; t < 4; t++)
+            callers.emplace_back([&] { par_for(10000, 1, [&](std::size_t i) { sum += i; }); });
+    }
+    CHECK(sum == 4 * (10000 * 9999 / 2));
+}
+
+template <class F>
+double time_ms(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Work proportional to the index, like a triangular loop nest
+double ragged_work(std::size_t i)
+{
+    double acc = 0;
+    for(std::size_t j = 0; j < i * 20; j++)
+        acc += std::sqrt(double(j));
+    return acc;
+}
+
+// Returns the time of many small loops, the way the host references call
+// par_ford, and of one loop with ragged iterations.
+template <class ParFor>
+std::pair<double, double> run_benchmark(ParFor pf, std::vector<double>& out)
+{
+    const double small_ms = time_ms([&] {
+        for(int r = 0; r < 2000; r++)
+            pf(64, [&](std::size_t i) { out[i] = double(i) * r; });
+    });
+    const double ragged_ms =
+        time_ms([&] { pf(out.size(), [&](std::size_t i) { out[i] = ragged_work(i); }); });
+    return {small_ms, ragged_ms};
+}
+
+void benchmark(std::size_t threads)
+{
+    miopen::thread_pool pool(threads);
+    std::vector<double> a(4096);
+    std::vector<double> b(4096);
+    const auto spawn_ms = run_benchmark(
+        [&](std::size_t n, auto f) { spawn_par_for(threads, n, 1, f); }, a);
+    const auto pool_ms = run_benchmark(
+        [&](std::size_t n, auto f) {
+            pool.parallel_for(n, std::max<std::size_t>(1, n / (16 * threads)), f);
+        },
+        b);
+    CHECK(a == b);
+    std::cout << "par_for on " << threads << " threads, small loops: spawning "
+              << spawn_ms.first << " ms, pool " << pool_ms.first << " ms; ragged loop: spawning "
+              << spawn_ms.second << " ms, pool " << pool_ms.second << " ms" << std::endl;
+}
+
+int main()
+{
+    {
+        miopen::thread_pool pool(4);
+        CHECK(pool.size() == 4);
+        check_pool(pool);
+    }
+    check_coverage();
+    check_ford();
+    check_nested();
+    check_exception();
+    check_concurrent_callers();
+    benchmark(std::max(std::thread::hardware_concurrency(), 1u));
+    benchmark(8);
+}
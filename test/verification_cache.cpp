@@ -0,0 +1,180 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "verification_cache.hpp"
+#include "test.hpp"
+#include <miopen/philox.hpp>
+#include <miopen/tmp_dir.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+const miopen::vcache_key key{"conv_fwd_fp32_2x3x8x8_4x3x3x3", 7, 42};
+
+std::vector<double> random_data(std::size_t n)
+{
+    std::vector<double> v(n);
+    miopen::fill_uniform(v.data(), n, -1.0, 1.0, {n, 0});
+    return v;
+}
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void write_file(const std::string& path, const std::string& contents)
+{
+    std::ofstream(path, std::ios::binary).write(contents.data(), contents.size());
+}
+
+void check_codec()
+{
+    const std::vector<std::vector<unsigned char>> inputs = {
+        {},
+        {1},
+        {1, 1, 1, 1, 2, 3, 3, 3, 4},
+        std::vector<unsigned char>(1000, 9),
+        std::vector<unsigned char>(129, 5),
+    };
+    auto check = [](const char* data, std::size_t n, std::size_t size) {
+        const auto encoded = miopen::vcache_detail::shuffle_rle_encode(data, n, size);
+        std::vector<char> decoded(n);
+        CHECK(miopen::vcache_detail::shuffle_rle_decode(
+            encoded.data(), encoded.size(), decoded.data(), n, size));
+        CHECK(std::equal(decoded.begin(), decoded.end(), data));
+        // Damaged streams are rejected rather than read out of bounds
+        if(!encoded.empty())
+        {
+            CHECK(!miopen::vcache_detail::shuffle_rle_decode(
+                encoded.data(), encoded.size() - 1, decoded.data(), n, size));
+            CHECK(!miopen::vcache_detail::shuffle_rle_decode(
+                encoded.data(), encoded.size(), decoded.data(), n + 1, size));
+        }
+    };
+    for(auto&& v : inputs)
+        check(reinterpret_cast<const char*>(v.data()), v.size(), 1);
+
+    const auto values = random_data(10007);
+    check(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double), 8);
+    std::vector<float> steps(4096);
+    for(std::size_t i = 0; i < steps.size(); i++)
+        steps[i] = static_cast<float>(i / 64);
+    check(reinterpret_cast<const char*>(steps.data()), steps.size() * sizeof(float), 4);
+}
+
+template <class Tfile>
+void check_round_trip(bool compress, const std::vector<double>& data)
+{
+    miopen::TmpDir dir("vcache");
+    const miopen::verification_cache cache(dir.path.string(), compress);
+    const std::vector<std::size_t> shape = {data.size() / 4, 4};
+
+    std::vector<double> result(data.size());
+    CHECK(!cache.load<Tfile>("fwd_out", key, result, shape));
+    cache.save<Tfile>("fwd_out", key, data, shape);
+    CHECK(cache.load<Tfile>("fwd_out", key, result, shape));
+    for(std::size_t i = 0; i < data.size(); i++)
+        CHECK(result[i] == static_cast<double>(static_cast<Tfile>(data[i])));
+
+    // Entries of other names, keys, shapes and types are not used
+    CHECK(!cache.load<Tfile>("bwd_dat", key, result, shape));
+    for(auto other : {miopen::vcache_key{key.problem + "x", key.seed, key.inputs},
+                      miopen::vcache_key{key.problem, key.seed + 1, key.inputs},
+                      miopen::vcache_key{key.problem, key.seed, key.inputs + 1}})
+    {
+        CHECK(!cache.load<Tfile>("fwd_out", other, result, shape));
+        // Even when the file is found under its name
+        write_file(cache.file_name("fwd_out", other), read_file(cache.file_name("fwd_out", key)));
+        CHECK(!cache.load<Tfile>("fwd_out", other, result, shape));
+    }
+    CHECK(!cache.load<Tfile>("fwd_out", key, result, {data.size() / 2, 2}));
+    CHECK(!cache.load<Tfile>("fwd_out", key, result));
+    if(!std::is_same<Tfile, double>{})
+        CHECK(!cache.load<double>("fwd_out", key, result, shape));
+
+    // Corrupted files are detected
+    const auto path     = cache.file_name("fwd_out", key);
+    const auto contents = read_file(path);
+    const std::size_t size = contents.size();
+    for(std::size_t pos : {std::size_t{0}, std::size_t{10}, size / 2, size - 1})
+    {
+        auto damaged = contents;
+        damaged[pos] ^= 0x10;
+        write_file(path, damaged);
+        CHECK(!cache.load<Tfile>("fwd_out", key, result, shape));
+    }
+    for(std::size_t size : {std::size_t{0}, std::size_t{16}, contents.size() - 1})
+    {
+        write_file(path, contents.substr(0, size));
+        CHECK(!cache.load<Tfile>("fwd_out", key, result, shape));
+    }
+    write_file(path, contents + "x");
+    CHECK(!cache.load<Tfile>("fwd_out", key, result, shape));
+    write_file(path, contents);
+    CHECK(cache.load<Tfile>("fwd_out", key, result, shape));
+}
+
+void check_compression()
+{
+    // Values on a coarse grid share most of their bytes
+    std::vector<double> data(1 << 14);
+    for(std::size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<double>(i % 7);
+    miopen::TmpDir dir("vcache");
+    const miopen::verification_cache plain(dir.path.string(), false);
+    const miopen::verification_cache packed(dir.path.string(), true);
+    plain.save<double>("plain", key, data);
+    packed.save<double>("packed", key, data);
+    CHECK(read_file(packed.file_name("packed", key)).size() * 4 <
+          read_file(plain.file_name("plain", key)).size());
+
+    std::vector<double> result(data.size());
+    CHECK(plain.load<double>("packed", key, result));
+    CHECK(result == data);
+}
+
+void check_hash()
+{
+    const std::vector<float> a = {1.0f, 2.0f, 3.0f};
+    auto b                     = a;
+    b[2]                       = 3.5f;
+    CHECK(miopen::vcache_hash{}.add(a).value == miopen::vcache_hash{}.add(a).value);
+    CHECK(miopen::vcache_hash{}.add(a).value != miopen::vcache_hash{}.add(b).value);
+    CHECK(miopen::vcache_hash{}.add(a).add(b).value != miopen::vcache_hash{}.add(b).add(a).value);
+}
+
+int main()
+{
+    check_codec();
+    check_round_trip<double>(false, random_data(1024));
+    check_round_trip<float>(false, random_data(1024));
+    check_round_trip<half_float::half>(true, random_data(1024));
+    check_round_trip<double>(true, std::vector<double>(1024, 0.25));
+    check_compression();
+    check_hash();
+}
@@ -0,0 +1,464 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_VERIFICATION_CACHE_HPP
+#define GUARD_VERIFICATION_CACHE_HPP
+
+#include <miopen/half_convert.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <half.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace miopen {
+
+// Cached host reference results. Every entry is one file holding a header, the
+// problem description, the shape and the payload. The file name is derived
+// from the key, and the header repeats the key so that stale entries, hash
+// collisions, truncated files and corrupted payloads are all detected on load
+// and recomputed instead of used.
+//
+// The key describes the problem and everything the reference depends on: the
+// data type and parameters of the operation, the seed of the generated data
+// and a checksum of the actual input buffers, so inputs read from files or
+// taken from the GPU are covered as well.
+
+// 64-bit checksum that consumes whole words where it can
+struct vcache_hash
+{
+    std::uint64_t value = 0xcbf29ce484222325ull;
+
+    vcache_hash& add_bytes(const void* data, std::size_t n)
+    {
+        const auto* p = static_cast<const unsigned char*>(data);
+        std::size_t i = 0;
+        for(; i + 8 <= n; i += 8)
+        {
+            std::uint64_t w;
+            std::memcpy(&w, p + i, sizeof(w));
+            mix(w);
+        }
+        for(; i < n; i++)
+            mix(p[i]);
+        mix(n);
+        return *this;
+    }
+
+    template <class T>
+    vcache_hash& add(const std::vector<T>& v)
+    {
+        return add_bytes(v.data(), v.size() * sizeof(T));
+    }
+
+    vcache_hash& add(const std::string& s) { return add_bytes(s.data(), s.size()); }
+
+    private:
+    void mix(std::uint64_t w)
+    {
+        value = (value ^ w) * 0x100000001b3ull;
+        value ^= value >> 32;
+    }
+};
+
+struct vcache_key
+{
+    // Operation, data type and parameters, for example "conv_fwd_fp16_1x3x32x32_..."
+    std::string problem;
+    std::uint64_t seed = 0;
+    // vcache_hash of the input buffers
+    std::uint64_t inputs = 0;
+};
+
+enum class vcache_type : std::uint32_t
+{
+    half_type   = 1,
+    float_type  = 2,
+    double_type = 3,
+};
+
+template <class T>
+struct vcache_type_of;
+template <>
+struct vcache_type_of<half_float::half>
+    : std::integral_constant<vcache_type, vcache_type::half_type>
+{
+};
+template <>
+struct vcache_type_of<float> : std::integral_constant<vcache_type, vcache_type::float_type>
+{
+};
+template <>
+struct vcache_type_of<double> : std::integral_constant<vcache_type, vcache_type::double_type>
+{
+};
+
+enum class vcache_codec : std::uint32_t
+{
+    none = 0,
+    // The bytes of every element are split into planes, so that the slowly
+    // varying sign and exponent bytes line up, and then run-length encoded.
+    shuffle_rle = 1,
+};
+
+struct vcache_header
+{
+    char magic[8];
+    std::uint32_t version;
+    vcache_type type;
+    vcache_codec codec;
+    std::uint32_t rank;
+    std::uint64_t seed;
+    std::uint64_t inputs;
+    std::uint64_t problem_size;
+    std::uint64_t raw_size;
+    std::uint64_t payload_size;
+    std::uint64_t checksum;
+};
+
+namespace vcache_detail {
+
+static constexpr char magic[8]          = {'M', 'I', 'O', 'P', 'E', 'N', 'V', 'C'};
+static constexpr std::uint32_t version  = 1;
+static constexpr std::size_t max_repeat = 130;
+static constexpr std::size_t max_copy   = 128;
+
+// The problem description is padded so that the payload of a mapped file is
+// aligned for every element type.
+inline std::size_t padded(std::size_t n) { return (n + 7) / 8 * 8; }
+
+inline std::vector<char> shuffle_rle_encode(const char* data, std::size_t n, std::size_t size)
+{
+    const std::size_t count = n / size;
+    std::vector<char> planes(n);
+    for(std::size_t i = 0; i < count; i++)
+        for(std::size_t b = 0; b < size; b++)
+            planes[b * count + i] = data[i * size + b];
+
+    // A control byte below 128 is followed by that many plus one literal bytes,
+    // from 128 on it repeats the next byte that many minus 125 times.
+    std::vector<char> result;
+    std::size_t i = 0;
+    while(i < n)
+    {
+        std::size_t run = 1;
+        while(i + run < n && run < max_repeat && planes[i + run] == planes[i])
+            run++;
+        if(run >= 3)
+        {
+            result.push_back(static_cast<char>(128 + run - 3));
+            result.push_back(planes[i]);
+            i += run;
+            continue;
+        }
+        std::size_t last = i;
+        while(last < n && last - i < max_copy &&
+              !(last + 2 < n && planes[last] == planes[last + 1] &&
+                planes[last] == planes[last + 2]))
+            last++;
+        result.push_back(static_cast<char>(last - i - 1));
+        result.insert(result.end(), planes.begin() + i, planes.begin() + last);
+        i = last;
+    }
+    return result;
+}
+
+inline bool
+shuffle_rle_decode(const char* data, std::size_t n, char* out, std::size_t raw, std::size_t size)
+{
+    std::vector<char> planes(raw);
+    std::size_t i = 0;
+    std::size_t o = 0;
+    while(i < n)
+    {
+        const auto ctrl = static_cast<unsigned char>(data[i++]);
+        if(ctrl >= 128)
+        {
+            const std::size_t run = ctrl - 125;
+            if(i >= n || o + run > raw)
+                return false;
+            std::fill(planes.begin() + o, planes.begin() + o + run, data[i++]);
+            o += run;
+        }
+        else
+        {
+            const std::size_t len = ctrl + 1;
+            if(i + len > n || o + len > raw)
+                return false;
+            std::copy(data + i, data + i + len, planes.begin() + o);
+            i += len;
+            o += len;
+        }
+    }
+    if(o != raw || raw % size != 0)
+        return false;
+
+    const std::size_t count = raw / size;
+    for(std::size_t e = 0; e < count; e++)
+        for(std::size_t b = 0; b < size; b++)
+            out[e * size + b] = planes[b * count + e];
+    return true;
+}
+
+} // namespace vcache_detail
+
+class verification_cache
+{
+    public:
+    verification_cache() = default;
+
+    verification_cache(std::string path, bool compress_)
+        : directory(std::move(path)), compress(compress_)
+    {
+    }
+
+    bool enabled() const { return !directory.empty(); }
+
+    std::string file_name(const std::string& name, const vcache_key& key) const
+    {
+        const auto h = vcache_hash{}.add(key.problem).add_bytes(&key.seed, 8).add_bytes(
+            &key.inputs, 8);
+        std::ostringstream ss;
+        ss << directory << "/" << name << "_" << std::hex << std::setw(16) << std::setfill('0')
+           << h.value << ".vcache";
+        return ss.str();
+    }
+
+    // Loads the entry into data, stored as Tfile. Returns false when there is
+    // no usable entry, reporting why an existing file is not used.
+    template <class Tfile, class T>
+    bool load(const std::string& name,
+              const vcache_key& key,
+              std::vector<T>& data,
+              std::vector<std::size_t> shape = {}) const
+    {
+        if(!enabled())
+            return false;
+        if(shape.empty())
+            shape = {data.size()};
+        assert(std::accumulate(shape.begin(),
+                               shape.end(),
+                               std::size_t{1},
+                               std::multiplies<std::size_t>()) == data.size());
+        const auto path = file_name(name, key);
+        if(!std::ifstream(path).good())
+            return false;
+
+        const char* error = nullptr;
+        try
+        {
+            namespace bip = boost::interprocess;
+            const bip::file_mapping file(path.c_str(), bip::read_only);
+            const bip::mapped_region region(file, bip::read_only);
+            error = read(static_cast<const char*>(region.get_address()),
+                         region.get_size(),
+                         key,
+                         shape,
+                         vcache_type_of<Tfile>{},
+                         [&](const char* payload) {
+                             convert_buffer(
+                                 reinterpret_cast<const Tfile*>(payload), data.data(), data.size());
+                         });
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << "Could not map verification cache entry " << path << ": " << ex.what()
+                      << std::endl;
+            return false;
+        }
+        if(error != nullptr)
+        {
+            std::cerr << "Ignoring verification cache entry " << path << ": " << error
+                      << std::endl;
+            return false;
+        }
+        std::cout << "Read verification data from " << path << std::endl;
+        return true;
+    }
+
+    template <class Tfile, class T>
+    void save(const std::string& name,
+              const vcache_key& key,
+              const std::vector<T>& data,
+              std::vector<std::size_t> shape = {}) const
+    {
+        if(!enabled())
+            return;
+        if(shape.empty())
+            shape = {data.size()};
+
+        std::vector<Tfile> converted(data.size());
+        convert_buffer(data.data(), converted.data(), data.size());
+        const auto* raw         = reinterpret_cast<const char*>(converted.data());
+        const std::size_t bytes = converted.size() * sizeof(Tfile);
+
+        vcache_header header{};
+        std::copy(std::begin(vcache_detail::magic), std::end(vcache_detail::magic), header.magic);
+        header.version      = vcache_detail::version;
+        header.type         = vcache_type_of<Tfile>{};
+        header.codec        = vcache_codec::none;
+        header.rank         = static_cast<std::uint32_t>(shape.size());
+        header.seed         = key.seed;
+        header.inputs       = key.inputs;
+        header.problem_size = key.problem.size();
+        header.raw_size     = bytes;
+
+        std::vector<char> encoded;
+        if(compress)
+        {
+            encoded = vcache_detail::shuffle_rle_encode(raw, bytes, sizeof(Tfile));
+            if(encoded.size() < bytes)
+            {
+                header.codec = vcache_codec::shuffle_rle;
+                raw          = encoded.data();
+            }
+        }
+        header.payload_size = header.codec == vcache_codec::none ? bytes : encoded.size();
+        header.checksum     = vcache_hash{}.add_bytes(raw, header.payload_size).value;
+
+        // Written next to the entry and renamed, so a concurrent reader never
+        // maps a partial file.
+        const auto path = file_name(name, key);
+        const auto temp = path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary);
+            std::vector<char> problem(vcache_detail::padded(key.problem.size()));
+            std::copy(key.problem.begin(), key.problem.end(), problem.begin());
+            std::vector<std::uint64_t> dims(shape.begin(), shape.end());
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(problem.data(), problem.size());
+            out.write(reinterpret_cast<const char*>(dims.data()), dims.size() * sizeof(dims[0]));
+            out.write(raw, header.payload_size);
+            if(!out)
+            {
+                std::cerr << "Could not write verification cache entry " << path << std::endl;
+                std::remove(temp.c_str());
+                return;
+            }
+        }
+        if(std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            std::cerr << "Could not write verification cache entry " << path << std::endl;
+            std::remove(temp.c_str());
+            return;
+        }
+        std::cout << "Wrote verification data to " << path << std::endl;
+    }
+
+    private:
+    template <class F>
+    const char* read(const char* file,
+                     std::size_t size,
+                     const vcache_key& key,
+                     const std::vector<std::size_t>& shape,
+                     vcache_type type,
+                     F store) const
+    {
+        vcache_header header;
+        if(size < sizeof(header))
+            return "truncated header";
+        std::memcpy(&header, file, sizeof(header));
+        if(!std::equal(
+               std::begin(vcache_detail::magic), std::end(vcache_detail::magic), header.magic))
+            return "not a verification cache file";
+        if(header.version != vcache_detail::version)
+            return "stale format version";
+
+        if(header.problem_size > size || header.rank > size / sizeof(std::uint64_t))
+            return "truncated file";
+        const std::size_t dims_offset = sizeof(header) + vcache_detail::padded(header.problem_size);
+        const std::size_t payload_offset = dims_offset + header.rank * sizeof(std::uint64_t);
+        if(payload_offset > size || size - payload_offset != header.payload_size)
+            return "truncated file";
+
+        const std::string problem(file + sizeof(header), header.problem_size);
+        std::vector<std::uint64_t> dims(header.rank);
+        std::memcpy(dims.data(), file + dims_offset, dims.size() * sizeof(dims[0]));
+        if(problem != key.problem || header.seed != key.seed || header.inputs != key.inputs)
+            return "stale entry for a different problem";
+        if(header.type != type || !std::equal(dims.begin(), dims.end(), shape.begin(), shape.end()))
+            return "stale entry with a different type or shape";
+
+        const std::size_t elements = std::accumulate(
+            shape.begin(), shape.end(), std::size_t{1}, std::multiplies<std::size_t>());
+        const char* payload = file + payload_offset;
+        if(vcache_hash{}.add_bytes(payload, header.payload_size).value != header.checksum)
+            return "checksum mismatch";
+        if(header.raw_size != elements * element_size(type))
+            return "corrupted header";
+
+        if(header.codec == vcache_codec::none)
+        {
+            if(header.payload_size != header.raw_size)
+                return "corrupted header";
+            store(payload);
+        }
+        else if(header.codec == vcache_codec::shuffle_rle)
+        {
+            std::vector<std::uint64_t> decoded((header.raw_size + 7) / 8);
+            if(!vcache_detail::shuffle_rle_decode(payload,
+                                                   header.payload_size,
+                                                   reinterpret_cast<char*>(decoded.data()),
+                                                   header.raw_size,
+                                                   element_size(type)))
+                return "corrupted payload";
+            store(reinterpret_cast<const char*>(decoded.data()));
+        }
+        else
+            return "unknown compression";
+        return nullptr;
+    }
+
+    static std::size_t element_size(vcache_type t)
+    {
+        switch(t)
+        {
+        case vcache_type::half_type: return 2;
+        case vcache_type::float_type: return 4;
+        case vcache_type::double_type: return 8;
+        }
+        return 1;
+    }
+
+    std::string directory;
+    bool compress = false;
+};
+
+} // namespace miopen
+
+#endif
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "verify.hpp"
+#include "test.hpp"
+#include <half.hpp>
+#include <miopen/philox.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// The formula of rms_range before it was computed by compare_range
+template <class R1, class R2>
+double serial_rms(R1&& r1, R2&& r2)
+{
+    std::size_t n            = miopen::range_distance(r1);
+    double square_difference = miopen::range_product(r1, r2, 0.0, miopen::sum, miopen::square_diff);
+    double mag1              = *std::max_element(r1.begin(), r1.end(), miopen::compare_mag);
+    double mag2              = *std::max_element(r2.begin(), r2.end(), miopen::compare_mag);
+    double mag =
+        std::max({std::fabs(mag1), std::fabs(mag2), std::numeric_limits<double>::min()});
+    return std::sqrt(square_difference) / (std::sqrt(n) * mag);
+}
+
+bool same_value(double x, double y) { return (std::isnan(x) and std::isnan(y)) or x == y; }
+
+template <class R>
+std::size_t count_if(const R& r, bool (*f)(double))
+{
+    return std::count_if(r.begin(), r.end(), [&](double x) { return f(x); });
+}
+
+template <class T>
+void check_stats(const std::vector<T>& a, const std::vector<T>& b, bool exact_rms)
+{
+    auto stats = miopen::compare_range(a, b);
+    auto rms   = serial_rms(a, b);
+    CHECK(stats.n == a.size());
+    if(exact_rms or not std::isfinite(rms))
+        CHECK(same_value(stats.rms, rms));
+    else
+        CHECK(std::fabs(stats.rms - rms) <= 1e-12 * rms);
+    CHECK(same_value(miopen::rms_range(a, b), stats.rms));
+    CHECK(same_value(stats.max_diff, miopen::max_diff(a, b)));
+    CHECK(stats.mismatch_idx == miopen::mismatch_idx(a, b, miopen::float_equal));
+    CHECK(stats.nonfinite_idx1 == miopen::find_idx(a, miopen::not_finite));
+    CHECK(stats.nonfinite_idx2 == miopen::find_idx(b, miopen::not_finite));
+    CHECK(stats.nan_count1 == count_if(a, [](double x) { return std::isnan(x); }));
+    CHECK(stats.nan_count2 == count_if(b, [](double x) { return std::isnan(x); }));
+    CHECK(stats.inf_count1 == count_if(a, [](double x) { return std::isinf(x); }));
+    CHECK(stats.inf_count2 == count_if(b, [](double x) { return std::isinf(x); }));
+    CHECK(stats.zero1 == miopen::range_zero(a));
+    CHECK(stats.zero2 == miopen::range_zero(b));
+}
+
+template <class T>
+void check_type(std::size_t n, bool exact_rms)
+{
+    std::vector<T> a(n);
+    std::vector<T> b(n);
+    miopen::fill_uniform(a.data(), n, -1.0, 1.0, {n, 0});
+    miopen::fill_uniform(b.data(), n, -1.0, 1.0, {n, 1});
+    check_stats(a, b, exact_rms);
+
+    // Differences of a few ulps somewhere in the middle
+    b = a;
+    check_stats(a, b, exact_rms);
+    for(std::size_t i = n / 3; i < n; i += n / 5 + 1)
+        b[i] = std::nextafter(float(b[i]), 2.0f);
+    check_stats(a, b, exact_rms);
+
+    std::fill(a.begin(), a.end(), T(0));
+    check_stats(a, b, exact_rms);
+    std::fill(b.begin(), b.end(), T(0));
+    check_stats(a, b, exact_rms);
+}
+
+template <class T>
+void check_nonfinite(std::size_t n, bool exact_rms)
+{
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    std::vector<T> a(n);
+    miopen::fill_uniform(a.data(), n, -1.0, 1.0, {n, 2});
+    std::vector<T> b = a;
+
+    b[n - 1] = inf;
+    check_stats(a, b, exact_rms);
+    // NaN differences in the middle and at the start of a chunk
+    b[n / 2] = nan;
+    a[n / 4] = -inf;
+    check_stats(a, b, exact_rms);
+    b[n - 1] = a[n - 1];
+    b[std::min(n - 1, miopen::compare_detail::chunk_size)] = nan;
+    check_stats(a, b, exact_rms);
+    // A leading NaN is the magnitude max_element finds
+    b[0] = nan;
+    check_stats(a, b, exact_rms);
+    a[0] = nan;
+    b[0] = 0;
+    check_stats(a, b, exact_rms);
+}
+
+void check_sizes()
+{
+    std::vector<float> a(10, 1.0f);
+    std::vector<float> b(7, 1.0f);
+    auto stats = miopen::compare_range(a, b);
+    CHECK(stats.n == 7);
+    CHECK(stats.rms == std::numeric_limits<float>::max());
+    CHECK(miopen::rms_range(a, b) == std::numeric_limits<float>::max());
+    CHECK(stats.mismatch_idx == 7);
+
+    std::vector<float> e;
+    CHECK(miopen::compare_range(e, e).mismatch_idx == 0);
+    CHECK(miopen::compare_range(e, e).zero1);
+}
+
+int main()
+{
+    // Short ranges are reduced in one chunk in the serial order
+    const std::size_t small = 1000;
+    // Long ranges cover several chunks and a partial one
+    const std::size_t large = 3 * miopen::compare_detail::chunk_size + 17;
+    check_type<float>(small, true);
+    check_type<double>(small, true);
+    check_type<half_float::half>(small, true);
+    check_type<float>(large, false);
+    check_type<double>(large, false);
+    check_type<half_float::half>(large, false);
+    check_nonfinite<float>(small, true);
+    check_nonfinite<double>(large, false);
+    check_nonfinite<half_float::half>(large, false);
+    check_sizes();
+}
@@ -30,9 +30,12 @@
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <miopen/float_equal.hpp>
 #include <miopen/returns.hpp>
+#include <miopen/thread_pool.hpp>
 #include <numeric>
+#include <vector>
 
 namespace miopen {
 
@@ -164,19 +167,168 @@ std::size_t mismatch_diff(R1&& r1, R2&& r2, T diff)
             float_equal, diff, std::bind(abs_diff, std::placeholders::_1, std::placeholders::_2)));
 }
 
+// Everything the verification of one output needs, gathered in a single pass
+// over both ranges
+struct compare_stats
+{
+    std::size_t n   = 0;
+    double rms      = 0.0;
+    double max_diff = 0.0;
+    // First index where the elements are not float_equal, n if there is none
+    std::size_t mismatch_idx = 0;
+    // First non finite element of each range, -1 if there is none
+    long nonfinite_idx1    = -1;
+    long nonfinite_idx2    = -1;
+    std::size_t nan_count1 = 0;
+    std::size_t nan_count2 = 0;
+    std::size_t inf_count1 = 0;
+    std::size_t inf_count2 = 0;
+    bool zero1             = true;
+    bool zero2             = true;
+};
+
+namespace compare_detail {
+
+// Ranges are split into chunks of a fixed size so the result does not depend
+// on the number of threads, and short ranges are reduced in the same order as
+// the serial algorithms above.
+static constexpr std::size_t chunk_size = 1 << 16;
+
+struct partial
+{
+    double square_difference = 0.0;
+    double mag1              = 0.0;
+    double mag2              = 0.0;
+    double max_diff          = 0.0;
+    bool diff_nan            = false;
+    std::size_t mismatch_idx = std::numeric_limits<std::size_t>::max();
+    long nonfinite_idx1      = -1;
+    long nonfinite_idx2      = -1;
+    std::size_t nan_count1   = 0;
+    std::size_t nan_count2   = 0;
+    std::size_t inf_count1   = 0;
+    std::size_t inf_count2   = 0;
+    bool zero1               = true;
+    bool zero2               = true;
+};
+
+template <class T>
+void count_nonfinite(T x, long i, long& idx, std::size_t& nan_count, std::size_t& inf_count)
+{
+    if(not_finite(x))
+    {
+        if(idx < 0)
+            idx = i;
+        // NaN is the only value that does not compare equal to itself
+        nan_count += x != x ? 1 : 0;
+        inf_count += x == x ? 1 : 0;
+    }
+}
+
+template <class Iterator1, class Iterator2>
+partial compare_chunk(Iterator1 first1, Iterator2 first2, std::size_t start, std::size_t last)
+{
+    using std::fabs;
+    partial p;
+    for(std::size_t i = start; i < last; i++)
+    {
+        auto x = first1[i];
+        auto y = first2[i];
+        auto d = abs_diff(x, y);
+
+        p.square_difference += square_diff(x, y);
+        // NaN never compares greater, so it is skipped here like in max_element
+        p.mag1 = fabs(x) > p.mag1 ? fabs(x) : p.mag1;
+        p.mag2 = fabs(y) > p.mag2 ? fabs(y) : p.mag2;
+        // Folded with max like max_diff, so a NaN difference restarts the fold
+        p.max_diff = max(p.max_diff, d);
+        p.diff_nan = p.diff_nan or d != d;
+        if(p.mismatch_idx == std::numeric_limits<std::size_t>::max() and not float_equal(x, y))
+            p.mismatch_idx = i;
+        count_nonfinite(x, long(i), p.nonfinite_idx1, p.nan_count1, p.inf_count1);
+        count_nonfinite(y, long(i), p.nonfinite_idx2, p.nan_count2, p.inf_count2);
+        p.zero1 = p.zero1 and float(x) == 0.0;
+        p.zero2 = p.zero2 and float(y) == 0.0;
+    }
+    return p;
+}
+
+inline void combine_idx(long& idx, long x)
+{
+    if(idx < 0)
+        idx = x;
+}
+
+} // namespace compare_detail
+
+// Compares the common prefix of two random access ranges on the thread pool.
+// Every statistic matches what the serial functions above compute, except
+// that the square difference of long ranges is summed in chunk order.
+template <class R1, class R2>
+compare_stats compare_range(R1&& r1, R2&& r2)
+{
+    const std::size_t n1 = range_distance(r1);
+    const std::size_t n2 = range_distance(r2);
+
+    compare_stats result;
+    result.n            = std::min(n1, n2);
+    result.mismatch_idx = result.n;
+    if(result.n == 0)
+        return result;
+
+    const std::size_t chunks = (result.n + compare_detail::chunk_size - 1) /
+                               compare_detail::chunk_size;
+    std::vector<compare_detail::partial> partials(chunks);
+    auto first1 = r1.begin();
+    auto first2 = r2.begin();
+    thread_pool::get().parallel_for(chunks, 1, [&](std::size_t c) {
+        const std::size_t start = c * compare_detail::chunk_size;
+        const std::size_t last  = std::min(start + compare_detail::chunk_size, result.n);
+        partials[c]             = compare_detail::compare_chunk(first1, first2, start, last);
+    });
+
+    double square_difference = 0.0;
+    double mag1              = 0.0;
+    double mag2              = 0.0;
+    for(auto&& p : partials)
+    {
+        square_difference += p.square_difference;
+        mag1            = std::max(mag1, p.mag1);
+        mag2            = std::max(mag2, p.mag2);
+        result.max_diff = p.diff_nan ? p.max_diff : max(result.max_diff, p.max_diff);
+        if(result.mismatch_idx == result.n)
+            result.mismatch_idx = std::min(p.mismatch_idx, result.n);
+        compare_detail::combine_idx(result.nonfinite_idx1, p.nonfinite_idx1);
+        compare_detail::combine_idx(result.nonfinite_idx2, p.nonfinite_idx2);
+        result.nan_count1 += p.nan_count1;
+        result.nan_count2 += p.nan_count2;
+        result.inf_count1 += p.inf_count1;
+        result.inf_count2 += p.inf_count2;
+        result.zero1 = result.zero1 and p.zero1;
+        result.zero2 = result.zero2 and p.zero2;
+    }
+
+    if(n1 != n2)
+    {
+        result.rms = std::numeric_limits<range_value<R1>>::max();
+        return result;
+    }
+    // max_element keeps a leading NaN as the largest magnitude
+    if(*first1 != *first1)
+        mag1 = *first1;
+    if(*first2 != *first2)
+        mag2 = *first2;
+    double mag = std::max({mag1, mag2, std::numeric_limits<double>::min()});
+    result.rms = std::sqrt(square_difference) / (std::sqrt(result.n) * mag);
+    return result;
+}
+
 template <class R1, class R2>
 double rms_range(R1&& r1, R2&& r2)
 {
     std::size_t n = range_distance(r1);
     if(n == range_distance(r2))
-    {
-        double square_difference = range_product(r1, r2, 0.0, sum_fn{}, square_diff);
-        double mag1              = *std::max_element(r1.begin(), r1.end(), compare_mag);
-        double mag2              = *std::max_element(r2.begin(), r2.end(), compare_mag);
-        double mag =
-            std::max({std::fabs(mag1), std::fabs(mag2), std::numeric_limits<double>::min()});
-        return std::sqrt(square_difference) / (std::sqrt(n) * mag);
-    }
+        return compare_range(r1, r2).rms;
     else
         return std::numeric_limits<range_value<R1>>::max();
 }
@@ -0,0 +1,226 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "test.hpp"
+#include <miopen/filter_transform_cache.hpp>
+#include <miopen/problem_description.hpp>
+#include <miopen/winograd_filter.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+std::vector<float> random_vector(std::size_t n, std::mt19937& gen)
+{
+    std::uniform_real_distribution<float> dist(-1, 1);
+    std::vector<float> v(n);
+    for(auto& x : v)
+        x = dist(gen);
+    return v;
+}
+
+bool close(float a, float b) { return std::fabs(a - b) <= 1e-4f * (1 + std::fabs(b)); }
+
+// Stride 1 correlation of x [c][h][w] with w [k][c][3][3] into [k][out_h][out_w]
+std::vector<float> direct(std::size_t c,
+                          std::size_t h,
+                          std::size_t w,
+                          std::size_t k,
+                          int pad_h,
+                          int pad_w,
+                          const std::vector<float>& x,
+                          const std::vector<float>& wei)
+{
+    const long out_h = long(h) + 2 * pad_h - 2;
+    const long out_w = long(w) + 2 * pad_w - 2;
+    std::vector<float> y(k * out_h * out_w);
+    for(std::size_t ki = 0; ki < k; ki++)
+        for(long i = 0; i < out_h; i++)
+            for(long j = 0; j < out_w; j++)
+            {
+                double sum = 0;
+                for(std::size_t ci = 0; ci < c; ci++)
+                    for(long a = 0; a < 3; a++)
+                        for(long b = 0; b < 3; b++)
+                        {
+                            const long yi = i + a - pad_h;
+                            const long xj = j + b - pad_w;
+                            if(yi >= 0 && yi < long(h) && xj >= 0 && xj < long(w))
+                                sum += double(wei[((ki * c + ci) * 3 + a) * 3 + b]) *
+                                       x[(ci * h + yi) * w + xj];
+                        }
+                y[(ki * out_h + i) * out_w + j] = float(sum);
+            }
+    return y;
+}
+
+void test_filter_transform()
+{
+    // The center tap of F(2, 3) goes through the middle column of G = (0, 1/2, -1/2, 0)
+    std::vector<float> g(9, 0);
+    g[4] = 1;
+    std::vector<float> u(16);
+    miopen::WinogradFilterTransform(2, g.data(), u.data());
+    const float column[] = {0, 0.5, -0.5, 0};
+    for(int i = 0; i < 4; i++)
+        for(int j = 0; j < 4; j++)
+            CHECK(close(u[i * 4 + j], column[i] * column[j]));
+
+    // A constant filter of F(4, 3) transforms to r r^T, r the row sums of G
+    std::fill(g.begin(), g.end(), 1);
+    u.resize(36);
+    miopen::WinogradFilterTransform(4, g.data(), u.data());
+    CHECK(close(u[0], 1.f / 16));
+    CHECK(close(u[35], 1));
+    CHECK(close(u[3 * 6 + 4], 7.f / 24 / 8));
+    CHECK(close(u[1 * 6 + 1], 1.f / 4));
+    CHECK(close(u[0 * 6 + 2], -1.f / 24));
+}
+
+void test_tile(int tile, std::mt19937& gen)
+{
+    const int alpha = miopen::GetWinogradAlpha(tile);
+    const auto g    = random_vector(9, gen);
+    const auto d    = random_vector(alpha * alpha, gen);
+    std::vector<float> u(alpha * alpha);
+    std::vector<float> v(alpha * alpha);
+    std::vector<float> y(tile * tile);
+    miopen::WinogradFilterTransform(tile, g.data(), u.data());
+    miopen::WinogradInputTransform(tile, d.data(), v.data());
+    for(int e = 0; e < alpha * alpha; e++)
+        u[e] *= v[e];
+    miopen::WinogradOutputTransform(tile, u.data(), y.data());
+
+    for(int i = 0; i < tile; i++)
+        for(int j = 0; j < tile; j++)
+        {
+            float sum = 0;
+            for(int a = 0; a < 3; a++)
+                for(int b = 0; b < 3; b++)
+                    sum += g[a * 3 + b] * d[(i + a) * alpha + j + b];
+            CHECK(close(y[i * tile + j], sum));
+        }
+}
+
+void test_forward(int tile,
+                  std::size_t c,
+                  std::size_t h,
+                  std::size_t w,
+                  std::size_t k,
+                  int pad_h,
+                  int pad_w,
+                  std::mt19937& gen)
+{
+    const auto x   = random_vector(c * h * w, gen);
+    const auto wei = random_vector(k * c * 9, gen);
+    std::vector<float> u(miopen::GetWinogradFilterSize(tile, k, c));
+    miopen::WinogradFilterTransform(tile, k, c, wei.data(), u.data());
+
+    const auto expected = direct(c, h, w, k, pad_h, pad_w, x, wei);
+    std::vector<float> y(expected.size(), -1);
+    miopen::WinogradForward(tile, c, h, w, k, pad_h, pad_w, x.data(), u.data(), y.data());
+    for(std::size_t i = 0; i < y.size(); i++)
+        CHECK(close(y[i], expected[i]));
+}
+
+std::size_t freed = 0;
+
+void* test_allocate(void*, std::size_t n) { return std::calloc(n, 1); }
+void test_deallocate(void*, void* p)
+{
+    freed++;
+    std::free(p);
+}
+
+miopen::ProblemDescription make_problem(int n_inputs)
+{
+    miopen::ProblemDescription problem;
+    problem.n_inputs = n_inputs;
+    problem.direction.Set(1);
+    return problem;
+}
+
+void test_cache()
+{
+    const miopen::Allocator allocator{test_allocate, test_deallocate, nullptr};
+    const auto weights0 = allocator(4);
+    const auto weights1 = allocator(4);
+    miopen::FilterTransformCache cache;
+    const auto fft      = miopenConvolutionFwdAlgoFFT;
+    const auto winograd = miopenConvolutionFwdAlgoWinograd;
+    const auto small    = make_problem(3);
+    const auto large    = make_problem(64);
+
+    CHECK(cache.Find(weights0.get(), fft, small) == nullptr);
+    cache.Insert(weights0.get(), fft, small, 1, allocator(16), 16);
+    cache.Insert(weights0.get(), winograd, small, 1, allocator(32), 32);
+    cache.Insert(weights0.get(), fft, large, 1, allocator(64), 64);
+    cache.Insert(weights1.get(), fft, small, 7, allocator(128), 128);
+    EXPECT(cache.Size() == 4);
+    EXPECT(cache.Bytes() == 240);
+
+    const auto* entry = cache.Find(weights0.get(), fft, small);
+    CHECK(entry != nullptr);
+    EXPECT(entry->version == 1);
+    EXPECT(entry->size == 16);
+    CHECK(cache.Find(weights1.get(), winograd, small) == nullptr);
+    CHECK(cache.Find(weights1.get(), fft, large) == nullptr);
+
+    // A new version replaces the entry and frees the old transform
+    cache.Insert(weights0.get(), fft, small, 2, allocator(24), 24);
+    EXPECT(freed == 1);
+    EXPECT(cache.Size() == 4);
+    EXPECT(cache.Find(weights0.get(), fft, small)->version == 2);
+    EXPECT(cache.Bytes() == 248);
+
+    EXPECT(cache.Erase(weights0.get()) == 3);
+    EXPECT(freed == 4);
+    EXPECT(cache.Erase(weights0.get()) == 0);
+    EXPECT(cache.Size() == 1);
+    EXPECT(cache.Find(weights1.get(), fft, small)->version == 7);
+
+    cache.Clear();
+    EXPECT(freed == 5);
+    EXPECT(cache.Bytes() == 0);
+}
+
+int main()
+{
+    std::mt19937 gen(11);
+    test_filter_transform();
+    for(int tile : {2, 4})
+    {
+        test_tile(tile, gen);
+        test_forward(tile, 1, 4, 4, 1, 0, 0, gen);
+        test_forward(tile, 3, 7, 5, 4, 1, 1, gen);
+        test_forward(tile, 5, 9, 11, 2, 1, 0, gen);
+        test_forward(tile, 2, 6, 13, 3, 0, 1, gen);
+    }
+    EXPECT(miopen::GetWinogradTile(4, 9) == 4);
+    EXPECT(miopen::GetWinogradTile(3, 9) == 2);
+    EXPECT(throws([] { miopen::WinogradFilterTransform(3, nullptr, nullptr); }));
+    test_cache();
+}
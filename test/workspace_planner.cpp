@@ -0,0 +1,251 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2018 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/db.hpp>
+#include <miopen/db_record.hpp>
+#include <miopen/temp_file.hpp>
+#include <miopen/workspace_planner.hpp>
+#include "test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Forward records of a find-db as MIOpen writes them: key=algorithm:solver,time,workspace,kcache
+const char* const find_db_records[] = {
+    "3-224-224-7x7-64-112-112-16-3x3-2x2-1x1-0-NCHW-FP32-F="
+    "miopenConvolutionFwdAlgoDirect:ConvOclDirectFwd,3.21,0,miopenConvolutionFwdAlgoDirect;"
+    "miopenConvolutionFwdAlgoGEMM:gemm,1.94,37933056,<unused>;"
+    "miopenConvolutionFwdAlgoFFT:fft,2.48,52690944,miopenConvolutionFwdAlgoFFT",
+    "64-56-56-3x3-64-56-56-16-1x1-1x1-1x1-0-NCHW-FP32-F="
+    "miopenConvolutionFwdAlgoDirect:ConvOclDirectFwd,2.70,0,miopenConvolutionFwdAlgoDirect;"
+    "miopenConvolutionFwdAlgoWinograd:ConvBinWinogradRxS,0.91,0,miopenConvolutionFwdAlgoWinograd;"
+    "miopenConvolutionFwdAlgoGEMM:gemm,1.35,7225344,<unused>;"
+    "miopenConvolutionFwdAlgoFFT:fft,1.02,29491200,miopenConvolutionFwdAlgoFFT",
+    "128-28-28-3x3-128-28-28-16-1x1-1x1-1x1-0-NCHW-FP32-F="
+    "miopenConvolutionFwdAlgoDirect:ConvOclDirectFwd,2.05,0,miopenConvolutionFwdAlgoDirect;"
+    "miopenConvolutionFwdAlgoGEMM:gemm,1.12,3612672,<unused>;"
+    "miopenConvolutionFwdAlgoFFT:fft,0.87,18874368,miopenConvolutionFwdAlgoFFT",
+    "256-14-14-3x3-256-14-14-16-1x1-1x1-1x1-0-NCHW-FP32-F="
+    "miopenConvolutionFwdAlgoDirect:ConvOclDirectFwd,1.76,0,miopenConvolutionFwdAlgoDirect;"
+    "miopenConvolutionFwdAlgoGEMM:gemm,0.98,1806336,<unused>;"
+    "miopenConvolutionFwdAlgoFFT:fft,1.31,9437184,miopenConvolutionFwdAlgoFFT"};
+
+// Reads the records back through miopen::Db, the way FindConvFwdAlgorithm collects them
+std::vector<std::vector<miopen::PerfField>> load_find_db()
+{
+    miopen::TempFile file{"miopen.tests.workspace_planner"};
+    {
+        std::ofstream out(file.Path());
+        for(const auto* record : find_db_records)
+            out << record << std::endl;
+    }
+
+    miopen::Db db{file.Path(), false};
+    std::vector<std::vector<miopen::PerfField>> layers;
+    for(const std::string record : find_db_records)
+    {
+        const auto found = db.FindRecord(record.substr(0, record.find('=')));
+        EXPECT(found);
+        std::vector<miopen::PerfField> perf;
+        for(const auto& pair : found->As<miopen::FindDbData>())
+            perf.push_back({pair.first, pair.second.time, pair.second.workspace});
+        layers.push_back(perf);
+    }
+    return layers;
+}
+
+std::vector<miopen::WorkspaceLayer>
+make_layers(const std::vector<std::vector<miopen::PerfField>>& perf, const std::vector<int>& steps)
+{
+    std::vector<miopen::WorkspaceLayer> layers;
+    for(std::size_t i = 0; i < perf.size(); i++)
+        layers.push_back({perf[i], steps[i], steps[i]});
+    return layers;
+}
+
+bool live_together(const miopen::WorkspaceLayer& a, const miopen::WorkspaceLayer& b)
+{
+    return a.first_step <= b.last_step && b.first_step <= a.last_step;
+}
+
+// The plan stays in the budget, and layers that are live together do not share memory
+void check_layout(const std::vector<miopen::WorkspaceLayer>& layers,
+                  const miopen::WorkspacePlan& plan,
+                  std::size_t budget)
+{
+    CHECK(plan.workspace_size <= budget);
+    float time = 0;
+    for(std::size_t i = 0; i < layers.size(); i++)
+    {
+        const auto end_i = plan.offsets[i] + plan.algorithms[i].workspace;
+        CHECK(plan.offsets[i] % 256 == 0);
+        CHECK(end_i <= plan.workspace_size);
+        time += plan.algorithms[i].time;
+        for(std::size_t j = 0; j < i; j++)
+        {
+            const auto end_j = plan.offsets[j] + plan.algorithms[j].workspace;
+            if(live_together(layers[i], layers[j]) && plan.algorithms[i].workspace > 0 &&
+               plan.algorithms[j].workspace > 0)
+                CHECK(end_i <= plan.offsets[j] || end_j <= plan.offsets[i]);
+        }
+    }
+    CHECK(std::abs(time - plan.time) < 1e-4f);
+}
+
+// Best total time over all algorithm combinations whose layout fits into the budget
+float brute_force(const std::vector<miopen::WorkspaceLayer>& layers, std::size_t budget)
+{
+    std::vector<std::size_t> choice(layers.size(), 0);
+    float best = -1;
+    for(;;)
+    {
+        std::vector<std::size_t> sizes;
+        float time = 0;
+        for(std::size_t i = 0; i < layers.size(); i++)
+        {
+            sizes.push_back(layers[i].perf[choice[i]].workspace);
+            time += layers[i].perf[choice[i]].time;
+        }
+        std::size_t size = 0;
+        miopen::AssignWorkspaceOffsets(layers, sizes, 256, size);
+        if(size <= budget && (best < 0 || time < best))
+            best = time;
+
+        std::size_t i = 0;
+        for(; i < layers.size() && ++choice[i] == layers[i].perf.size(); i++)
+            choice[i] = 0;
+        if(i == layers.size())
+            return best;
+    }
+}
+
+void check_ranking(const std::vector<std::vector<miopen::PerfField>>& perf)
+{
+    // Layer 1: Winograd is the fastest and needs no workspace, nothing else is worth it
+    auto ranked = miopen::RankWithinWorkspace(perf[1], 1 << 30);
+    CHECK(ranked.size() == 1);
+    CHECK(ranked[0].name == "miopenConvolutionFwdAlgoWinograd");
+
+    // Layer 2: FFT, then GEMM, then Direct as the limit shrinks
+    ranked = miopen::RankWithinWorkspace(perf[2], 1 << 30);
+    CHECK(ranked.size() == 3);
+    CHECK(ranked[0].name == "miopenConvolutionFwdAlgoFFT");
+    CHECK(ranked[1].name == "miopenConvolutionFwdAlgoGEMM");
+    CHECK(ranked[2].name == "miopenConvolutionFwdAlgoDirect");
+    ranked = miopen::RankWithinWorkspace(perf[2], 4 << 20);
+    CHECK(ranked.size() == 2);
+    CHECK(ranked[0].name == "miopenConvolutionFwdAlgoGEMM");
+    ranked = miopen::RankWithinWorkspace(perf[2], 0);
+    CHECK(ranked.size() == 1);
+    CHECK(ranked[0].name == "miopenConvolutionFwdAlgoDirect");
+}
+
+void check_sequential(const std::vector<std::vector<miopen::PerfField>>& perf)
+{
+    // One layer after another: every layer may use the whole buffer
+    const auto layers = make_layers(perf, {0, 1, 2, 3});
+    for(std::size_t budget : {0ul, 2ul << 20, 4ul << 20, 32ul << 20, 40ul << 20, 64ul << 20})
+    {
+        const auto plan = miopen::PlanWorkspace(layers, budget);
+        check_layout(layers, plan, budget);
+        CHECK(std::abs(plan.time - brute_force(layers, budget)) < 1e-4f);
+
+        std::size_t largest = 0;
+        for(const auto& algo : plan.algorithms)
+            largest = std::max(largest, algo.workspace);
+        CHECK(plan.workspace_size == largest);
+    }
+    const auto plan = miopen::PlanWorkspace(layers, 64ul << 20);
+    CHECK(plan.algorithms[0].name == "miopenConvolutionFwdAlgoGEMM");
+    CHECK(plan.algorithms[1].name == "miopenConvolutionFwdAlgoWinograd");
+    CHECK(plan.algorithms[2].name == "miopenConvolutionFwdAlgoFFT");
+    CHECK(plan.algorithms[3].name == "miopenConvolutionFwdAlgoGEMM");
+}
+
+void check_concurrent(const std::vector<std::vector<miopen::PerfField>>& perf)
+{
+    // Two streams: layers 0 and 2 run on one, 1 and 3 on the other, layer 2 is live longer
+    std::vector<miopen::WorkspaceLayer> layers = make_layers(perf, {0, 0, 1, 1});
+    layers[2].last_step                         = 2;
+    layers.push_back({perf[3], 2, 2});
+
+    for(std::size_t budget : {0ul, 4ul << 20, 19ul << 20, 24ul << 20, 48ul << 20, 128ul << 20})
+    {
+        const auto plan = miopen::PlanWorkspace(layers, budget);
+        check_layout(layers, plan, budget);
+        CHECK(plan.time >= brute_force(layers, budget) - 1e-4f);
+
+        // No layer could switch to a faster algorithm and still fit
+        for(std::size_t i = 0; i < layers.size(); i++)
+        {
+            for(const auto& faster : miopen::RankWithinWorkspace(layers[i].perf, budget))
+            {
+                if(faster.time >= plan.algorithms[i].time)
+                    break;
+                std::vector<std::size_t> sizes;
+                for(const auto& algo : plan.algorithms)
+                    sizes.push_back(algo.workspace);
+                sizes[i]         = faster.workspace;
+                std::size_t size = 0;
+                miopen::AssignWorkspaceOffsets(layers, sizes, 256, size);
+                CHECK(size > budget);
+            }
+        }
+    }
+
+    // Without any limit all layers take their fastest algorithm
+    const auto plan = miopen::PlanWorkspace(layers, 1ul << 30);
+    for(std::size_t i = 0; i < layers.size(); i++)
+        CHECK(plan.algorithms[i].name ==
+              miopen::RankWithinWorkspace(layers[i].perf, 1ul << 30).front().name);
+}
+
+void check_infeasible(const std::vector<std::vector<miopen::PerfField>>& perf)
+{
+    // Layer 0 has no algorithm without workspace if Direct is gone
+    auto layers = make_layers(perf, {0, 1, 2, 3});
+    auto& perf0 = layers[0].perf;
+    perf0.erase(std::remove_if(perf0.begin(),
+                               perf0.end(),
+                               [](const miopen::PerfField& p) {
+                                   return p.name == "miopenConvolutionFwdAlgoDirect";
+                               }),
+                perf0.end());
+    CHECK(perf0.size() == 2);
+    CHECK(throws([&] { miopen::PlanWorkspace(layers, 1 << 20); }));
+    CHECK(!throws([&] { miopen::PlanWorkspace(layers, 64 << 20); }));
+}
+
+int main()
+{
+    const auto perf = load_find_db();
+    check_ranking(perf);
+    check_sequential(perf);
+    check_concurrent(perf);
+    check_infeasible(perf);
+}